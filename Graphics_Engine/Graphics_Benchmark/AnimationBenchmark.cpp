@@ -0,0 +1,140 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "Animation.h"
+#include "HeadlessBackend.h"
+#include "JobSystem.h"
+
+namespace luke {
+    using namespace std;
+
+    int RunAnimationBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+
+        const SkinnedMeshData character = MakeTestCharacter();
+        const float sampleRate = 30.0f;
+        AnimationClip clips[2];
+        for (int run = 0; run < 2; run++) {
+            uint32_t frameCount = 0;
+            const vector<JointTransform> frames = MakeTestLocomotion(character, run != 0, sampleRate, frameCount);
+            ClipCompressionStats stats;
+            CompressClip(frames.data(), frameCount, character.skeleton.GetJointCount(), sampleRate, clips[run], &stats);
+            cout << (run ? "run" : "walk") << " clip: " << frameCount << " keys, " << stats.rawBytes / 1024.0
+                 << " KB -> " << stats.compressedBytes / 1024.0 << " KB, max error rotation "
+                 << stats.maxRotationError << ", translation " << stats.maxTranslationError * 1000.0f << " mm" << endl;
+        }
+        cout << "character: " << character.skeleton.GetJointCount() << " joints, " << character.vertices.size()
+             << " vertices, " << character.indices.size() / 3 << " triangles; budget " << options.animationBudgetMs
+             << " ms, threads " << jobSystem.GetThreadCount() + 1 << endl;
+
+        HeadlessBackend backend;
+        CrowdAnimator crowd;
+        crowd.Initialize(character, clips[0], clips[1]);
+        const GpuBufferHandle indexBuffer = backend.CreateBuffer(
+            GpuBufferType::Index, character.indices.data(), character.indices.size() * sizeof(uint16_t), false);
+        const uint32_t indexCount = uint32_t(character.indices.size());
+
+        // 캐릭터마다 동적 버텍스 버퍼와 (격자에 세운) 위치 상수 버퍼. 한 번 만든 것은 다음 측정에서도 씀
+        vector<GpuBufferHandle> vertexBuffers;
+        vector<GpuBufferHandle> constantBuffers;
+        auto reserveCharacters = [&](uint32_t count) {
+            while (vertexBuffers.size() < count) {
+                const uint32_t i = uint32_t(vertexBuffers.size());
+                const Matrix world = Matrix::CreateTranslation(float(i % 64), 0.0f, float(i / 64)).Transpose();
+                vertexBuffers.push_back(
+                    backend.CreateBuffer(GpuBufferType::Vertex, nullptr, crowd.GetVertexBytes(), true));
+                constantBuffers.push_back(backend.CreateBuffer(GpuBufferType::Constant, &world, sizeof(world), false));
+            }
+        };
+
+        struct Measurement {
+            uint32_t count = 0;
+            double poseMs = 0.0;
+            double skinMs = 0.0;
+            double submitMs = 0.0; // 업로드 + 그리기
+            double frameMs = 0.0;
+        };
+        auto measure = [&](uint32_t count) {
+            reserveCharacters(count);
+            crowd.SetCharacterCount(count);
+            Measurement result;
+            result.count = count;
+            for (uint32_t frame = 0; frame < options.warmupFrames + options.frames; frame++) {
+                const auto start = Clock::now();
+                crowd.Update(1.0f / 60.0f, jobSystem);
+                const auto animated = Clock::now();
+
+                backend.BeginFrame();
+                backend.SetIndexBuffer(indexBuffer);
+                for (uint32_t i = 0; i < count; i++) {
+                    backend.UpdateBuffer(vertexBuffers[i], crowd.GetVertices(i), crowd.GetVertexBytes());
+                    backend.SetVertexBuffer(vertexBuffers[i], sizeof(Vertex));
+                    backend.SetConstantBuffer(0, constantBuffers[i]);
+                    backend.DrawIndexed(indexCount, 0, 0);
+                }
+                backend.EndFrame();
+                const auto end = Clock::now();
+
+                if (frame < options.warmupFrames)
+                    continue;
+                result.poseMs += crowd.GetStats().poseMs;
+                result.skinMs += crowd.GetStats().skinMs;
+                result.submitMs += chrono::duration<double, milli>(end - animated).count();
+                result.frameMs += chrono::duration<double, milli>(end - start).count();
+            }
+            const double frames = max(options.frames, 1u);
+            result.poseMs /= frames;
+            result.skinMs /= frames;
+            result.submitMs /= frames;
+            result.frameMs /= frames;
+
+            char line[160];
+            snprintf(line, sizeof(line), "%8u characters: pose %7.3f ms, skin %7.3f ms, upload+draw %7.3f ms, frame %7.3f ms",
+                     count, result.poseMs, result.skinMs, result.submitMs, result.frameMs);
+            cout << line << endl;
+            return result;
+        };
+
+        Measurement best;
+        uint32_t over = 0; // 예산을 넘은 가장 작은 수
+        for (uint32_t count = 16; count <= (1u << 20); count *= 2) {
+            const Measurement measurement = measure(count);
+            if (measurement.frameMs > options.animationBudgetMs) {
+                over = count;
+                break;
+            }
+            best = measurement;
+        }
+        while (over > 0 && over - best.count > max(1u, best.count / 32)) {
+            const Measurement measurement = measure(best.count + (over - best.count) / 2);
+            if (measurement.frameMs > options.animationBudgetMs)
+                over = measurement.count;
+            else
+                best = measurement;
+        }
+
+        if (best.count == 0)
+            cout << "no character count fits in " << options.animationBudgetMs << " ms" << endl;
+        else
+            cout << "characters/frame within " << options.animationBudgetMs << " ms: " << best.count << " ("
+                 << double(best.count) * character.vertices.size() / (best.skinMs * 1000.0)
+                 << " M skinned vertices/s, " << best.frameMs << " ms)" << endl;
+
+        for (size_t i = 0; i < vertexBuffers.size(); i++) {
+            backend.DestroyBuffer(vertexBuffers[i]);
+            backend.DestroyBuffer(constantBuffers[i]);
+        }
+        backend.DestroyBuffer(indexBuffer);
+        if (backend.GetErrorCount() > 0) {
+            cerr << backend.GetErrorCount() << " backend error(s)." << endl;
+            return 2;
+        }
+        return 0;
+    }
+}
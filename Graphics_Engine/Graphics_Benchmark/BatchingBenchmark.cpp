@@ -0,0 +1,231 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "HeadlessBackend.h"
+#include "ShaderConstants.h"
+#include "StaticBatcher.h"
+
+namespace luke {
+    using namespace std;
+
+    int RunBatchingBenchmark(const BenchmarkOptions &options)
+    {
+        using Clock = chrono::high_resolution_clock;
+        constexpr uint32_t kMaterialCount = 4;
+        constexpr float kCellSize = 32.0f;
+
+        const MeshData meshes[] = {MeshGenerator::MakeTriangle(), MeshGenerator::MakeSquare(),
+                                   MeshGenerator::MakeCube()};
+        struct Placement {
+            uint32_t material;
+            uint32_t mesh;
+            Matrix world;
+        };
+        vector<Placement> placements(options.batchMeshes);
+        uint32_t random = 12345;
+        auto next = [&]() {
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            return float(random & 0xFFFFFF) / float(0x1000000);
+        };
+        for (Placement &placement : placements) {
+            placement.material = uint32_t(next() * kMaterialCount) % kMaterialCount;
+            placement.mesh = uint32_t(next() * 3.0f) % 3;
+            placement.world = Matrix::CreateScale(0.5f + next()) * Matrix::CreateRotationY(next() * DirectX::XM_2PI) *
+                              Matrix::CreateTranslation(next() * 256.0f - 128.0f, 0.5f, next() * 256.0f - 128.0f);
+        }
+        // per-mesh도 재질 순서로 정렬해서 재질 전환 횟수는 같게 비교
+        sort(placements.begin(), placements.end(), [](const Placement &a, const Placement &b) {
+            return a.material != b.material ? a.material < b.material : a.mesh < b.mesh;
+        });
+
+        const Matrix view = DirectX::XMMatrixLookAtLH(Vector3(0.0f, 120.0f, -200.0f), Vector3(0.0f, 0.0f, 0.0f),
+                                                      Vector3(0.0f, 1.0f, 0.0f));
+        const Matrix projection = DirectX::XMMatrixPerspectiveFovLH(
+            DirectX::XM_PIDIV4, float(options.width) / float(options.height), 1.0f, 1000.0f);
+        const FrameConstants frameConstants = MakeFrameConstants(view, projection);
+
+        const uint32_t frames = max(options.frames, 1u);
+        uint32_t materialBinds = 0;
+        // 프레임 평균 제출 시간 (BeginFrame ~ EndFrame)
+        auto measure = [&](HeadlessBackend &backend, const auto &draw) {
+            for (uint32_t frame = 0; frame < options.warmupFrames; frame++) {
+                backend.BeginFrame();
+                draw();
+                backend.EndFrame();
+            }
+            const auto start = Clock::now();
+            for (uint32_t frame = 0; frame < frames; frame++) {
+                materialBinds = 0;
+                backend.BeginFrame();
+                draw();
+                backend.EndFrame();
+            }
+            return chrono::duration<double, milli>(Clock::now() - start).count() / frames;
+        };
+
+        char line[240];
+        cout << "static batching: " << placements.size() << " meshes, " << kMaterialCount << " materials, "
+             << kCellSize << " m cells, " << options.warmupFrames << " warm-up + " << frames << " frames" << endl;
+        snprintf(line, sizeof(line), "%-14s %9s %11s %11s %11s %11s %11s", "", "buffers", "buffer MB", "binds/frame",
+                 "draws/frame", "submit ms", "setup ms");
+        cout << line << endl;
+        auto printRow = [&](const char *name, const HeadlessBackend &backend, double submitMs, double setupMs) {
+            const RenderStats &stats = backend.GetFrameStats();
+            snprintf(line, sizeof(line), "%-14s %9zu %11.2f %11llu %11llu %11.3f %11.2f", name, backend.GetBufferCount(),
+                     backend.GetBufferBytes() / (1024.0 * 1024.0),
+                     (unsigned long long)(stats.bufferBinds + materialBinds), (unsigned long long)stats.drawCalls,
+                     submitMs, setupMs);
+            cout << line << endl;
+        };
+
+        // per-mesh: 메쉬마다 버텍스/인덱스/물체 상수 버퍼 세 개
+        HeadlessBackend perMeshBackend;
+        const GpuBufferHandle perMeshFrameBuffer = perMeshBackend.CreateBuffer(
+            GpuBufferType::Constant, &frameConstants, sizeof(frameConstants), false);
+        struct MeshBuffers {
+            GpuBufferHandle vertexBuffer;
+            GpuBufferHandle indexBuffer;
+            GpuBufferHandle constantBuffer;
+            uint32_t indexCount;
+            uint32_t material;
+        };
+        vector<MeshBuffers> perMesh;
+        perMesh.reserve(placements.size());
+        auto start = Clock::now();
+        for (const Placement &placement : placements) {
+            const MeshData &mesh = meshes[placement.mesh];
+            const ObjectConstants constants = MakeObjectConstants(placement.world);
+            perMesh.push_back({perMeshBackend.CreateBuffer(GpuBufferType::Vertex, mesh.vertices.data(),
+                                                           mesh.vertices.size() * sizeof(Vertex), false),
+                               perMeshBackend.CreateBuffer(GpuBufferType::Index, mesh.indices.data(),
+                                                           mesh.indices.size() * sizeof(uint16_t), false),
+                               perMeshBackend.CreateBuffer(GpuBufferType::Constant, &constants, sizeof(constants), false),
+                               uint32_t(mesh.indices.size()), placement.material});
+        }
+        const double perMeshSetupMs = chrono::duration<double, milli>(Clock::now() - start).count();
+        auto drawPerMesh = [&]() {
+            perMeshBackend.SetConstantBuffer(kFrameConstantSlot, perMeshFrameBuffer);
+            uint32_t material = ~0u;
+            for (const MeshBuffers &buffers : perMesh) {
+                if (buffers.material != material) {
+                    material = buffers.material;
+                    materialBinds++;
+                }
+                perMeshBackend.SetConstantBuffer(kObjectConstantSlot, buffers.constantBuffer);
+                perMeshBackend.SetVertexBuffer(buffers.vertexBuffer, sizeof(Vertex));
+                perMeshBackend.SetIndexBuffer(buffers.indexBuffer);
+                perMeshBackend.DrawIndexed(buffers.indexCount, 0, 0);
+            }
+        };
+        printRow("per-mesh", perMeshBackend, measure(perMeshBackend, drawPerMesh), perMeshSetupMs);
+
+        // batched: 버텍스가 월드 공간이므로 model = 단위 행렬인 물체 상수 하나
+        HeadlessBackend batchedBackend;
+        StaticBatchSettings settings;
+        settings.cellSize = kCellSize;
+        StaticBatcher batcher(batchedBackend, settings);
+        const ObjectConstants identityConstants = MakeObjectConstants(Matrix::Identity);
+        const GpuBufferHandle frameBuffer = batchedBackend.CreateBuffer(
+            GpuBufferType::Constant, &frameConstants, sizeof(frameConstants), false);
+        const GpuBufferHandle constantBuffer = batchedBackend.CreateBuffer(
+            GpuBufferType::Constant, &identityConstants, sizeof(identityConstants), false);
+        vector<StaticMeshHandle> handles;
+        handles.reserve(placements.size());
+        start = Clock::now();
+        for (const Placement &placement : placements)
+            handles.push_back(batcher.Add(meshes[placement.mesh], placement.world, placement.material));
+        batcher.Build();
+        const double batchedSetupMs = chrono::duration<double, milli>(Clock::now() - start).count();
+        auto drawBatched = [&]() {
+            batchedBackend.SetConstantBuffer(kFrameConstantSlot, frameBuffer);
+            batchedBackend.SetConstantBuffer(kObjectConstantSlot, constantBuffer);
+            batcher.Draw([&](uint32_t) { materialBinds++; });
+        };
+        printRow("batched", batchedBackend, measure(batchedBackend, drawBatched), batchedSetupMs);
+
+        auto printBatcher = [&](const char *name, double ms) {
+            const StaticBatchStats &stats = batcher.GetStats();
+            snprintf(line, sizeof(line),
+                     "  %-12s %u meshes in %u batches on %u pages, %.1f%% of vertex space used, %u free ranges, "
+                     "%.2f MB uploaded in %.2f ms",
+                     name, stats.meshCount, stats.batchCount, stats.pageCount,
+                     stats.vertexCapacity ? 100.0 * stats.usedVertices / stats.vertexCapacity : 0.0,
+                     stats.freeRanges, stats.bytesUploaded / (1024.0 * 1024.0), ms);
+            cout << line << endl;
+        };
+        printBatcher("build", batcher.GetStats().buildMs);
+
+        // 서쪽 절반을 지우면 그 셀의 그룹이 통째로 빠져서 페이지마다 빈틈이 생김
+        for (size_t i = 0; i < placements.size(); i++) {
+            if (placements[i].world.Translation().x < 0.0f)
+                batcher.Remove(handles[i]);
+        }
+        batcher.Build();
+        printBatcher("remove half", batcher.GetStats().buildMs);
+        printRow("removed half", batchedBackend, measure(batchedBackend, drawBatched), batcher.GetStats().buildMs);
+        batcher.Compact();
+        printBatcher("compact", batcher.GetStats().compactMs);
+        cout << "  moved " << batcher.GetStats().movedBatches << " batches" << endl;
+        printRow("compacted", batchedBackend, measure(batchedBackend, drawBatched), batcher.GetStats().compactMs);
+
+        // 남은 메쉬를 두 방식으로 한 장씩 그려서 비교 (월드 변환을 CPU에서 미리 곱했으므로 아주 작은 차이는 허용)
+        auto renderImage = [&](HeadlessBackend &backend, const auto &draw) {
+            const RenderTargetHandle target = backend.CreateRenderTarget(options.width, options.height);
+            const float clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+            backend.BeginFrame();
+            backend.SetRenderTarget(target, clearColor);
+            draw();
+            backend.EndFrame();
+            vector<uint8_t> rgba;
+            backend.CopyToStaging(target);
+            backend.TryReadStaging(target, rgba);
+            backend.DestroyRenderTarget(target);
+            return rgba;
+        };
+        const vector<uint8_t> batchedImage = renderImage(batchedBackend, drawBatched);
+        const vector<uint8_t> perMeshImage = renderImage(perMeshBackend, [&]() {
+            perMeshBackend.SetConstantBuffer(kFrameConstantSlot, perMeshFrameBuffer);
+            uint32_t i = 0;
+            for (const MeshBuffers &buffers : perMesh) {
+                if (placements[i++].world.Translation().x < 0.0f)
+                    continue;
+                perMeshBackend.SetConstantBuffer(kObjectConstantSlot, buffers.constantBuffer);
+                perMeshBackend.SetVertexBuffer(buffers.vertexBuffer, sizeof(Vertex));
+                perMeshBackend.SetIndexBuffer(buffers.indexBuffer);
+                perMeshBackend.DrawIndexed(buffers.indexCount, 0, 0);
+            }
+        });
+        size_t differentPixels = 0, coveredPixels = 0;
+        for (size_t i = 0; i + 3 < min(batchedImage.size(), perMeshImage.size()); i += 4) {
+            differentPixels += memcmp(&batchedImage[i], &perMeshImage[i], 3) != 0 ? 1 : 0;
+            coveredPixels += (perMeshImage[i] | perMeshImage[i + 1] | perMeshImage[i + 2]) != 0 ? 1 : 0;
+        }
+        snprintf(line, sizeof(line), "image check %ux%u: %zu covered pixels, %zu differ (%.3f%%)", options.width,
+                 options.height, coveredPixels, differentPixels,
+                 100.0 * differentPixels / max<size_t>(perMeshImage.size() / 4, 1));
+        cout << line << endl;
+
+        for (const MeshBuffers &buffers : perMesh) {
+            perMeshBackend.DestroyBuffer(buffers.constantBuffer);
+            perMeshBackend.DestroyBuffer(buffers.indexBuffer);
+            perMeshBackend.DestroyBuffer(buffers.vertexBuffer);
+        }
+        perMeshBackend.DestroyBuffer(perMeshFrameBuffer);
+        batchedBackend.DestroyBuffer(constantBuffer);
+        batchedBackend.DestroyBuffer(frameBuffer);
+        const uint64_t errors = perMeshBackend.GetErrorCount() + batchedBackend.GetErrorCount();
+        if (errors > 0 || batchedImage.empty() || batchedImage.size() != perMeshImage.size()) {
+            cerr << errors << " backend error(s)." << endl;
+            return 2;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BenchmarkReport.h"
+#include "BenchmarkScene.h"
+#include "ClusteredLighting.h"
+#include "ImageWriter.h"
+
+namespace luke {
+
+    class JobSystem;
+
+    // Graphics_Benchmark의 명령줄 옵션 (기본값은 PrintUsage()와 같음)
+    // 모드마다 자기 모드의 값과 --frames, --warmup, --size 같은 공통 값만 읽습니다.
+    struct BenchmarkOptions {
+        std::vector<uint32_t> objectCounts = {1, 1000, 100000, 1000000};
+        std::vector<CameraPath> paths = {CameraPath::Static, CameraPath::Orbit, CameraPath::FlyThrough};
+        BenchmarkMesh mesh = BenchmarkMesh::Mixed;
+        uint32_t frames = 240;
+        uint32_t warmupFrames = 10;
+        bool frustumCulling = true;
+        bool occlusionCulling = false;
+        unsigned int threads = 0;
+        std::string outPath;
+        std::string baselinePath;
+        std::string tracePath;
+        double tolerance = 0.10;
+        bool objectCountsSet = false;
+        std::vector<uint32_t> viewCounts = {1};
+
+        // 오프스크린 모드
+        std::string offscreenDirectory;
+        uint32_t images = 16; // 장면마다 저장할 이미지 수 (카메라 경로를 나눔)
+        uint32_t width = 640;
+        uint32_t height = 360;
+        ImageFormat format = ImageFormat::Png;
+        uint32_t latency = 3;
+        unsigned int writers = 0; // 0이면 하드웨어 스레드 수 / 2
+        uint32_t queueCapacity = 8;
+        QueueFullPolicy queuePolicy = QueueFullPolicy::Wait;
+
+        // 크기 변경 모드
+        uint32_t resizeFrames = 0;
+
+        // 스트리밍 모드
+        uint32_t streamFrames = 0;
+        uint32_t streamBudgetMB = 64;
+        float ioLatencyMs = 2.0f;  // 셀 하나를 읽는 데 걸리는 (흉내 낸) 디스크 시간
+        uint32_t cellCubes = 1000; // 셀당 큐브 수
+        uint32_t gpuBudgetMB = 0;  // 0이면 GPU 메모리 예산 없음
+        std::string memoryStatsPath;
+
+        // 텍스처 모드
+        std::string textureDirectory;
+
+        // 애니메이션 모드
+        float animationBudgetMs = 0.0f;
+
+        // 파티클 모드
+        uint32_t particleCount = 0;
+
+        // 조명 모드
+        std::vector<uint32_t> lightCounts;
+
+        // 라이트맵 모드
+        std::string lightmapDirectory;
+        uint32_t lightmapSamples = 64;
+
+        // 정적 배칭 모드
+        uint32_t batchMeshes = 0;
+
+        // 스프라이트 모드
+        uint32_t spriteFps = 0;
+
+        // 명령 캡처/재생
+        std::string capturePath;
+        std::string replayPath;
+    };
+
+    // 모드마다 하나씩 (XxxBenchmark.cpp). Graphics_Benchmark의 main()이 옵션을 보고 하나를 골라 부릅니다.
+    // 반환값은 프로세스 종료 코드 (0: 성공, 1: 기준값보다 나빠짐, 2: 실패)
+
+    // options.objectCounts x options.paths x options.viewCounts 장면을 RunSceneBenchmark()로 돌려서
+    // JSON으로 출력하고, baseline이 비어 있지 않으면 비교합니다. --trace면 마지막 프레임들의 타임라인도 저장
+    int RunSceneBenchmarks(const BenchmarkOptions &options, const BenchmarkBaseline &baseline, JobSystem &jobSystem,
+                           AllocationProbe probe);
+
+    // 장면마다 options.images장을 그려서 저장하고 초당 이미지 수를 출력합니다.
+    // 렌더링은 OffscreenRenderer가 렌더 타겟을 돌려 쓰며 진행하고, 인코딩/파일 쓰기는 ImageWriter 스레드들이 맡습니다.
+    // waits/wait ms: 큐가 가득 차서 렌더링이 기다린 횟수와 시간 (0이 아니면 인코더가 병목)
+    int RunOffscreenBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem);
+
+    // 창을 끄는 동안처럼 매 프레임 WM_SIZE가 여러 번 오는 상황을 흉내 내서 세 가지 방식을 비교합니다.
+    //   immediate : 메시지마다 바로 다시 만듦
+    //   deferred  : 프레임 경계에서 마지막 크기로 한 번만 다시 만듦
+    //   pooled    : deferred + RenderTargetPool (크기 버킷이 같으면 다시 쓰고, 이전 버킷도 한동안 보관)
+    // 프레임마다 타겟을 지우는 비용까지 포함한 평균/최악 프레임 시간과 생성 횟수, 할당량(probe)을 출력합니다.
+    int RunResizeBenchmark(const BenchmarkOptions &options, AllocationProbe probe);
+
+    // 셀로 나눈 월드를 정해진 경로로 날아가면서 WorldStreamer로 셀을 읽고 내림 (60 FPS에 맞춰 진행)
+    // 올라와 있는 메모리(평균/최대)와 카메라 주변 셀이 비어 있던 프레임(스톨)을 출력합니다.
+    // gpuBudgetMB가 있으면 버퍼를 GpuMemoryTracker로 기록하고 hard 예산을 넘길 때 퇴출 콜백으로 셀을 내립니다.
+    int RunStreamingBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem);
+
+    // 합성 이미지로 밉 체인(box/Kaiser)을 만들고 BC1/BC3/BC7로 압축해서 압축 속도와 첫 밉의 PSNR을 출력하고,
+    // .ltex 파일로 저장한 뒤 매핑해서 다시 확인합니다.
+    int RunTextureBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem);
+
+    // 걷기/뛰기 클립을 섞는 캐릭터 수를 늘려 가며 포즈 + 스키닝 + 동적 버퍼 업로드 + 그리기가
+    // budgetMs 안에 들어오는 최대 캐릭터 수를 찾음 (2배씩 늘린 뒤 이분 탐색)
+    int RunAnimationBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem);
+
+    // 연기/불꽃/파편 이미터에 나눈 파티클을 정상 상태까지 돌린 뒤 프레임마다 시뮬레이션하고 인스턴스 버퍼에 써서
+    // 이미터마다 인스턴스 드로우 한 번으로 그립니다. 밀리초당 파티클 수를 출력합니다.
+    int RunParticleBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem);
+
+    // 빛 수마다 프레임별 분류 시간과 업로드 양을 재고, 한 장을 클러스터 조명으로 그려서 확인
+    int RunLightingBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem);
+
+    // 200x200 넓이에 흩어 놓은 빛 (5개 중 하나는 아래를 비추는 스포트라이트). 조명과 라이트맵 모드가 같이 씀
+    std::vector<Light> MakeBenchmarkLights(uint32_t count);
+
+    // 2x2 월드 셀(바닥 + 상자들)에 점광원/스포트라이트와 해를 두고 라이트맵을 점진적으로 구움
+    // 샘플 수를 두 배씩 늘리며 패스마다 시간, 광선 수, 코어당 초당 광선 수, 직전 결과와의 차이를 출력하고
+    // 마지막 결과를 BC7 .ltex(TexturePipeline)와 확인용 PNG로 저장합니다.
+    int RunLightmapBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem);
+
+    // 움직이지 않는 삼각형/사각형/상자 N개를 256x256 넓이에 흩어 놓고 두 가지 방식으로 그림
+    //   per-mesh: Mesh처럼 메쉬마다 버텍스/인덱스/상수 버퍼를 따로 두고 드로우마다 셋 다 바인딩
+    //   batched : StaticBatcher로 32x32 셀 x 재질 4개 그룹을 공유 버퍼에 합쳐서 그룹마다 드로우 한 번
+    // 버퍼 수, 프레임당 바인딩/드로우 수, 제출 CPU 시간을 비교하고, 서쪽 절반을 지운 뒤와 Compact() 뒤도 출력합니다.
+    // 마지막에 두 방식으로 --size 크기의 한 장씩 그려서 픽셀이 같은지 확인합니다.
+    int RunBatchingBenchmark(const BenchmarkOptions &options);
+
+    // 움직이는 마커(텍스처 4종 x 층 4개)와 마커 네 개 중 하나에 붙는 글자 라벨을 SpriteBatcher로 그리면서
+    // 한 프레임(추가 + 정렬 + 쓰기 + 그리기)이 1000 / fps ms 안에 들어오는 최대 스프라이트 수를 찾습니다.
+    // 찾은 수를 MakeSquare 메쉬 하나 + 상수 버퍼 하나로 스프라이트마다 그리는 방식과도 비교합니다.
+    int RunSpriteBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem);
+
+    // 장면 하나를 CommandRecorder로 감싼 백엔드에 그리고, 워밍업이 끝난 다음 프레임을 저장
+    int RunCaptureBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem);
+    // 저장한 프레임을 헤드리스 백엔드에서 반복 재생하며 명령마다 시간을 잼
+    int RunReplayBenchmark(const BenchmarkOptions &options);
+}
@@ -0,0 +1,262 @@
+#include "BenchmarkReport.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        struct Metric {
+            const char *name;
+            double BenchmarkResult::*value;
+            bool compared;  // 기준값 비교 대상인지
+            double slack;   // 아주 작은 값에서 측정 잡음으로 실패하지 않도록 더해주는 절대값
+        };
+
+        // 시간 지표는 잡음이 있으므로 p50/p99만 비교하고, 개수 지표는 모두 비교
+        const Metric kMetrics[] = {
+            {"frame_ms_mean", &BenchmarkResult::frameMsMean, false, 0.0},
+            {"frame_ms_p50", &BenchmarkResult::frameMsP50, true, 0.02},
+            {"frame_ms_p90", &BenchmarkResult::frameMsP90, false, 0.0},
+            {"frame_ms_p99", &BenchmarkResult::frameMsP99, true, 0.05},
+            {"frame_ms_max", &BenchmarkResult::frameMsMax, false, 0.0},
+            {"visible_objects", &BenchmarkResult::visibleObjects, false, 0.0},
+            {"draw_calls", &BenchmarkResult::drawCalls, true, 0.0},
+            {"buffer_binds", &BenchmarkResult::bufferBinds, true, 0.0},
+            {"buffer_updates", &BenchmarkResult::bufferUpdates, true, 0.0},
+            {"bytes_uploaded", &BenchmarkResult::bytesUploaded, true, 0.0},
+            {"allocations", &BenchmarkResult::allocations, true, 0.5},
+            {"allocated_bytes", &BenchmarkResult::allocatedBytes, false, 0.0},
+            {"setup_ms", &BenchmarkResult::setupMs, false, 0.0},
+        };
+
+        string Escape(const string &text)
+        {
+            string escaped;
+            for (char c : text) {
+                if (c == '"' || c == '\\')
+                    escaped += '\\';
+                escaped += c;
+            }
+            return escaped;
+        }
+
+        // WriteBenchmarkJson()이 만드는 정도의 JSON만 읽는 작은 파서
+        // 객체 안의 숫자는 "경로"(예: results.0.metrics.draw_calls)를 키로 모읍니다.
+        class JsonReader {
+        public:
+            explicit JsonReader(const string &text) : m_text(text) {}
+
+            bool Parse(map<string, double> &numbers, map<string, string> &strings)
+            {
+                m_numbers = &numbers;
+                m_strings = &strings;
+                if (!ParseValue(""))
+                    return false;
+                SkipSpace();
+                return m_pos == m_text.size();
+            }
+
+        private:
+            void SkipSpace()
+            {
+                while (m_pos < m_text.size() && isspace((unsigned char)m_text[m_pos]))
+                    m_pos++;
+            }
+
+            bool Consume(char c)
+            {
+                SkipSpace();
+                if (m_pos < m_text.size() && m_text[m_pos] == c) {
+                    m_pos++;
+                    return true;
+                }
+                return false;
+            }
+
+            bool ParseString(string &value)
+            {
+                if (!Consume('"'))
+                    return false;
+                while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+                    if (m_text[m_pos] == '\\' && m_pos + 1 < m_text.size())
+                        m_pos++;
+                    value += m_text[m_pos++];
+                }
+                return Consume('"');
+            }
+
+            bool ParseValue(const string &path)
+            {
+                SkipSpace();
+                if (m_pos >= m_text.size())
+                    return false;
+
+                const char c = m_text[m_pos];
+                if (c == '{') {
+                    m_pos++;
+                    if (Consume('}'))
+                        return true;
+                    do {
+                        string key;
+                        if (!ParseString(key) || !Consume(':') ||
+                            !ParseValue(path.empty() ? key : path + "." + key))
+                            return false;
+                    } while (Consume(','));
+                    return Consume('}');
+                }
+                if (c == '[') {
+                    m_pos++;
+                    if (Consume(']'))
+                        return true;
+                    int index = 0;
+                    do {
+                        if (!ParseValue(path + "." + to_string(index++)))
+                            return false;
+                    } while (Consume(','));
+                    return Consume(']');
+                }
+                if (c == '"') {
+                    string value;
+                    if (!ParseString(value))
+                        return false;
+                    (*m_strings)[path] = value;
+                    return true;
+                }
+                if (m_text.compare(m_pos, 4, "true") == 0 || m_text.compare(m_pos, 4, "null") == 0) {
+                    m_pos += 4;
+                    return true;
+                }
+                if (m_text.compare(m_pos, 5, "false") == 0) {
+                    m_pos += 5;
+                    return true;
+                }
+
+                const char *begin = m_text.c_str() + m_pos;
+                char *end = nullptr;
+                const double value = strtod(begin, &end);
+                if (end == begin)
+                    return false;
+                m_pos += end - begin;
+                (*m_numbers)[path] = value;
+                return true;
+            }
+
+            const string &m_text;
+            size_t m_pos = 0;
+            map<string, double> *m_numbers = nullptr;
+            map<string, string> *m_strings = nullptr;
+        };
+    }
+
+    void WriteBenchmarkJson(ostream &out, const BenchmarkEnvironment &environment,
+                            const vector<BenchmarkResult> &results)
+    {
+        out << setprecision(6) << fixed;
+        out << "{\n";
+        out << "  \"environment\": {\n";
+        out << "    \"platform\": \"" << Escape(environment.platform) << "\",\n";
+        out << "    \"compiler\": \"" << Escape(environment.compiler) << "\",\n";
+        out << "    \"configuration\": \"" << Escape(environment.configuration) << "\",\n";
+        out << "    \"threads\": " << environment.threadCount << "\n";
+        out << "  },\n";
+        out << "  \"results\": [\n";
+
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchmarkResult &result = results[i];
+            const BenchmarkConfig &config = result.config;
+            out << "    {\n";
+            out << "      \"name\": \"" << Escape(result.name) << "\",\n";
+            out << "      \"config\": {\n";
+            out << "        \"objects\": " << config.objectCount << ",\n";
+            out << "        \"mesh\": \"" << GetBenchmarkMeshName(config.mesh) << "\",\n";
+            out << "        \"camera_path\": \"" << GetCameraPathName(config.cameraPath) << "\",\n";
+            out << "        \"frames\": " << config.frames << ",\n";
+            out << "        \"warmup_frames\": " << config.warmupFrames << ",\n";
+            out << "        \"frustum_culling\": " << (config.frustumCulling ? "true" : "false") << ",\n";
+            out << "        \"occlusion_culling\": " << (config.occlusionCulling ? "true" : "false")
+                << "\n";
+            out << "      },\n";
+            out << "      \"metrics\": {\n";
+            for (const Metric &metric : kMetrics)
+                out << "        \"" << metric.name << "\": " << result.*metric.value << ",\n";
+            out << "        \"setup_bytes_uploaded\": " << result.setupBytesUploaded << ",\n";
+            out << "        \"backend_errors\": " << result.backendErrors << "\n";
+            out << "      }\n";
+            out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n";
+        out << "}\n";
+    }
+
+    bool LoadBenchmarkBaseline(const filesystem::path &path, BenchmarkBaseline &baseline)
+    {
+        ifstream file(path);
+        if (!file) {
+            cout << "Cannot open baseline " << path.string() << endl;
+            return false;
+        }
+        stringstream buffer;
+        buffer << file.rdbuf();
+        const string text = buffer.str();
+
+        map<string, double> numbers;
+        map<string, string> strings;
+        if (!JsonReader(text).Parse(numbers, strings)) {
+            cout << "Cannot parse baseline " << path.string() << endl;
+            return false;
+        }
+
+        // results.<i>.name 과 results.<i>.metrics.<metric> 을 짝지음
+        const string metricsKey = ".metrics.";
+        for (const auto &[key, name] : strings) {
+            if (key.rfind("results.", 0) != 0 || key.size() < 5 ||
+                key.compare(key.size() - 5, 5, ".name") != 0)
+                continue;
+
+            const string prefix = key.substr(0, key.size() - 5) + metricsKey;
+            auto &metrics = baseline[name];
+            for (auto it = numbers.lower_bound(prefix);
+                 it != numbers.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+                metrics[it->first.substr(prefix.size())] = it->second;
+        }
+        return true;
+    }
+
+    int CompareWithBaseline(const vector<BenchmarkResult> &results, const BenchmarkBaseline &baseline,
+                            double tolerance, ostream &report)
+    {
+        int regressions = 0;
+        for (const BenchmarkResult &result : results) {
+            auto scene = baseline.find(result.name);
+            if (scene == baseline.end()) {
+                report << "  " << result.name << ": no baseline" << endl;
+                continue;
+            }
+
+            for (const Metric &metric : kMetrics) {
+                if (!metric.compared)
+                    continue;
+                auto value = scene->second.find(metric.name);
+                if (value == scene->second.end())
+                    continue;
+
+                const double expected = value->second;
+                const double actual = result.*metric.value;
+                const double limit = expected * (1.0 + tolerance) + metric.slack;
+                if (actual > limit) {
+                    report << "  REGRESSION " << result.name << " " << metric.name << ": "
+                           << actual << " > " << expected << " (limit " << limit << ")" << endl;
+                    regressions++;
+                }
+            }
+        }
+        return regressions;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BenchmarkScene.h"
+
+namespace luke {
+
+    // 실행 환경 (결과를 비교할 때 참고용)
+    struct BenchmarkEnvironment {
+        std::string platform;
+        std::string compiler;
+        std::string configuration;
+        uint32_t threadCount = 0;
+    };
+
+    // 장면 이름 -> (지표 이름 -> 값)
+    using BenchmarkBaseline = std::map<std::string, std::map<std::string, double>>;
+
+    // 결과를 JSON으로 출력합니다. 지표 이름은 LoadBenchmarkBaseline()이 읽는 이름과 같습니다.
+    void WriteBenchmarkJson(std::ostream &out, const BenchmarkEnvironment &environment,
+                            const std::vector<BenchmarkResult> &results);
+
+    // WriteBenchmarkJson()으로 저장했던 파일을 읽습니다. 실패하면 false.
+    bool LoadBenchmarkBaseline(const std::filesystem::path &path, BenchmarkBaseline &baseline);
+
+    // 기준값보다 (1 + tolerance)배 넘게 나빠진 지표를 report에 출력하고 그 개수를 반환합니다.
+    // 모든 지표는 작을수록 좋은 값입니다. 기준값에 없는 장면은 건너뜁니다.
+    int CompareWithBaseline(const std::vector<BenchmarkResult> &results,
+                            const BenchmarkBaseline &baseline, double tolerance, std::ostream &report);
+}
@@ -0,0 +1,503 @@
+#include "BenchmarkScene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+namespace luke {
+    using namespace std;
+    using namespace DirectX;
+
+    namespace {
+        constexpr float kObjectSpacing = 1.0f;
+        constexpr float kObjectScale = 0.25f;
+        constexpr size_t kCullGrainSize = 4096;
+
+        AllocationSnapshot GetTrackedAllocations()
+        {
+            AllocationSnapshot snapshot;
+            for (uint32_t i = 0; i < uint32_t(MemoryCategory::Count); i++)
+                snapshot.count += MemoryTracker::GetAllocationCount(MemoryCategory(i));
+            return snapshot;
+        }
+
+        double Percentile(const vector<double> &sorted, double p)
+        {
+            if (sorted.empty())
+                return 0.0;
+            const size_t index = min(sorted.size() - 1, size_t(p * (sorted.size() - 1) + 0.5));
+            return sorted[index];
+        }
+    }
+
+    const char *GetBenchmarkMeshName(BenchmarkMesh mesh)
+    {
+        switch (mesh) {
+        case BenchmarkMesh::Triangle:
+            return "triangle";
+        case BenchmarkMesh::Square:
+            return "square";
+        case BenchmarkMesh::Cube:
+            return "cube";
+        case BenchmarkMesh::Mixed:
+            return "mixed";
+        default:
+            return "unknown";
+        }
+    }
+
+    const char *GetCameraPathName(CameraPath path)
+    {
+        switch (path) {
+        case CameraPath::Static:
+            return "static";
+        case CameraPath::Orbit:
+            return "orbit";
+        case CameraPath::FlyThrough:
+            return "flythrough";
+        default:
+            return "unknown";
+        }
+    }
+
+    string BenchmarkConfig::MakeName() const
+    {
+        string name = string(GetBenchmarkMeshName(mesh)) + "_" + GetCameraPathName(cameraPath) + "_" +
+                      to_string(objectCount);
+        if (!frustumCulling)
+            name += "_nofrustum";
+        if (occlusionCulling)
+            name += "_occlusion";
+        if (viewCount > 1)
+            name += "_views" + to_string(viewCount) + (independentViews ? "_independent" : "");
+        return name;
+    }
+
+    BenchmarkScene::BenchmarkScene(const BenchmarkConfig &config, RenderBackend &backend,
+                                   JobSystem &jobSystem)
+        : m_config(config), m_backend(backend), m_jobSystem(jobSystem), m_objectConstants(backend),
+          m_frameArena(256 * 1024)
+    {
+        m_meshes.resize(3);
+        m_meshes[0].data = MeshGenerator::MakeTriangle();
+        m_meshes[1].data = MeshGenerator::MakeSquare();
+        m_meshes[2].data = MeshGenerator::MakeCube();
+        m_squareMesh = 1;
+
+        for (MeshBuffers &mesh : m_meshes) {
+            const MeshData &data = mesh.data;
+            mesh.vertexBuffer = m_backend.CreateBuffer(
+                GpuBufferType::Vertex, data.vertices.data(), data.vertices.size() * sizeof(Vertex), false);
+            mesh.indexBuffer = m_backend.CreateBuffer(
+                GpuBufferType::Index, data.indices.data(), data.indices.size() * sizeof(uint16_t), false);
+            mesh.indexCount = uint32_t(data.indices.size());
+            BoundingBox::CreateFromPoints(mesh.localBounds, data.vertices.size(),
+                                          &data.vertices[0].position, sizeof(Vertex));
+        }
+
+        m_frameConstantBuffer = m_backend.CreateBuffer(GpuBufferType::Constant, nullptr,
+                                                       sizeof(FrameConstants), true);
+
+        CreateObjects();
+    }
+
+    BenchmarkScene::~BenchmarkScene()
+    {
+        for (MeshBuffers &mesh : m_meshes) {
+            m_backend.DestroyBuffer(mesh.vertexBuffer);
+            m_backend.DestroyBuffer(mesh.indexBuffer);
+        }
+        m_backend.DestroyBuffer(m_frameConstantBuffer);
+    }
+
+    void BenchmarkScene::CreateObjects()
+    {
+        // 정육면체 격자에 물체를 배치하고 위치/회전에 약간의 난수를 섞음 (시드 고정)
+        const uint32_t count = m_config.objectCount;
+        const uint32_t side = max(1u, uint32_t(ceil(cbrt(double(count)))));
+        m_extent = 0.5f * side * kObjectSpacing;
+
+        mt19937 random(1234);
+        uniform_real_distribution<float> jitter(-0.25f, 0.25f);
+        uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+
+        m_objects.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            const uint32_t x = i % side;
+            const uint32_t y = (i / side) % side;
+            const uint32_t z = i / (side * side);
+            const Vector3 position((x + 0.5f) * kObjectSpacing - m_extent + jitter(random),
+                                   (y + 0.5f) * kObjectSpacing - m_extent + jitter(random),
+                                   (z + 0.5f) * kObjectSpacing - m_extent + jitter(random));
+
+            Object &object = m_objects[i];
+            object.mesh = m_config.mesh == BenchmarkMesh::Mixed ? i % 3 : uint32_t(m_config.mesh);
+            object.world = Matrix::CreateScale(kObjectScale) * Matrix::CreateRotationY(angle(random)) *
+                           Matrix::CreateTranslation(position);
+        }
+
+        // 같은 메쉬끼리 모아서 버퍼 바인딩을 줄임
+        stable_sort(m_objects.begin(), m_objects.end(),
+                    [](const Object &a, const Object &b) { return a.mesh < b.mesh; });
+
+        m_worldBounds.resize(count);
+        for (uint32_t i = 0; i < count; i++)
+            m_meshes[m_objects[i].mesh].localBounds.Transform(m_worldBounds[i], m_objects[i].world);
+        m_visible.assign(count, 1);
+        m_viewMasks.assign(count, 0);
+        m_objectSlots.resize(count);
+        m_objectMeshes.resize(count);
+        m_objectData.resize(count);
+        for (uint32_t i = 0; i < count; i++) {
+            m_objectMeshes[i] = m_objects[i].mesh;
+            m_objectData[i] = MakeObjectConstants(m_objects[i].world);
+        }
+
+        // 오클루전 컬링용 벽: 장면을 가로지르는 사각형 4장
+        if (m_config.occlusionCulling) {
+            const float half = m_extent * 0.5f;
+            for (float z : {-half, half}) {
+                for (float x : {-half, half}) {
+                    m_occluders.push_back(Matrix::CreateScale(half * 0.9f, m_extent, 1.0f) *
+                                          Matrix::CreateTranslation(x, 0.0f, z));
+                    m_occluderData.push_back(MakeObjectConstants(m_occluders.back()));
+                }
+            }
+        }
+    }
+
+    void BenchmarkScene::GetCamera(float time, Matrix &view, Matrix &projection, float aspect) const
+    {
+        Vector3 eye, direction;
+        switch (m_config.cameraPath) {
+        case CameraPath::Static:
+            eye = Vector3(0.0f, 0.0f, -2.0f * m_extent - 1.0f);
+            direction = Vector3(0.0f, 0.0f, 1.0f);
+            break;
+        case CameraPath::Orbit: {
+            const float angle = time * 2.0f * XM_PI;
+            const float radius = 2.0f * m_extent + 1.0f;
+            eye = Vector3(radius * sin(angle), 0.25f * m_extent, -radius * cos(angle));
+            direction = -eye;
+            direction.Normalize();
+            break;
+        }
+        case CameraPath::FlyThrough:
+        default: {
+            // 장면 앞에서 출발해 가운데를 지나 뒤로 빠져나가면서 좌우로 둘러봄
+            const float z = (time * 2.0f - 1.0f) * (m_extent + 1.0f);
+            const float yaw = 0.5f * sin(time * 4.0f * XM_PI);
+            eye = Vector3(0.0f, 0.0f, z);
+            direction = Vector3(sin(yaw), 0.0f, cos(yaw));
+            break;
+        }
+        }
+
+        view = XMMatrixLookToLH(eye, direction, Vector3(0.0f, 1.0f, 0.0f));
+        projection = XMMatrixPerspectiveFovLH(XMConvertToRadians(70.0f), aspect, 0.01f,
+                                              4.0f * m_extent + 10.0f);
+    }
+
+    void BenchmarkScene::Cull(const Matrix &view, const Matrix &projection)
+    {
+        const size_t count = m_objects.size();
+        if (!m_config.frustumCulling) {
+            fill(m_visible.begin(), m_visible.end(), uint8_t(1));
+        }
+        else {
+            BoundingFrustum frustum(projection);
+            frustum.Transform(frustum, view.Invert());
+            m_jobSystem.ParallelFor(count, kCullGrainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++)
+                    m_visible[i] = frustum.Intersects(m_worldBounds[i]) ? 1 : 0;
+            });
+        }
+
+        if (m_config.occlusionCulling && !m_occluders.empty()) {
+            const MeshData &square = m_meshes[m_squareMesh].data;
+            m_occlusionCuller.BeginFrame(view, projection, &m_frameArena);
+            for (const Matrix &world : m_occluders)
+                m_occlusionCuller.RasterizeOccluder(square.vertices, square.indices, world);
+            m_occlusionCuller.EndOccluders();
+
+            // 절두체를 통과한 물체만 검사
+            m_candidateBounds.clear();
+            m_candidateIndices.clear();
+            for (uint32_t i = 0; i < count; i++) {
+                if (m_visible[i]) {
+                    m_candidateBounds.push_back(m_worldBounds[i]);
+                    m_candidateIndices.push_back(i);
+                }
+            }
+            m_occlusionCuller.TestBoxes(m_candidateBounds, m_candidateVisible, m_jobSystem);
+            for (size_t i = 0; i < m_candidateIndices.size(); i++)
+                m_visible[m_candidateIndices[i]] = m_candidateVisible[i];
+        }
+    }
+
+    void BenchmarkScene::RenderFrame(float time, RenderTargetHandle target)
+    {
+        // RenderBackend에는 뷰포트가 없으므로 여러 뷰는 렌더 타겟 없이 명령만 기록
+        if (m_config.viewCount > 1 && target.IsNull()) {
+            if (m_config.independentViews)
+                RenderViewsIndependently(time);
+            else
+                RenderViews(time);
+            return;
+        }
+
+        Matrix view, projection;
+        GetCamera(time, view, projection);
+
+        m_backend.BeginFrame();
+        if (!target.IsNull()) {
+            const float clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+            m_backend.SetRenderTarget(target, clearColor);
+        }
+        {
+            CpuProfileScope scope(m_profiler, "Cull");
+            Cull(view, projection);
+        }
+        CpuProfileScope recordScope(m_profiler, "Record");
+        GpuProfileScope drawScope(m_profiler, "Draw");
+
+        SetFrameConstants(view, projection);
+        UploadVisibleObjects();
+        DrawVisibleObjects();
+
+        if (!target.IsNull())
+            m_backend.SetRenderTarget({}, nullptr);
+        m_backend.EndFrame();
+        m_frameArena.Reset();
+    }
+
+    void BenchmarkScene::SetFrameConstants(const Matrix &view, const Matrix &projection)
+    {
+        const FrameConstants constants = MakeFrameConstants(view, projection);
+        m_backend.UpdateBuffer(m_frameConstantBuffer, &constants, sizeof(constants));
+        m_backend.SetConstantBuffer(kFrameConstantSlot, m_frameConstantBuffer);
+    }
+
+    void BenchmarkScene::UploadVisibleObjects()
+    {
+        uint32_t count = uint32_t(m_occluders.size());
+        for (size_t i = 0; i < m_objects.size(); i++) {
+            if (m_visible[i])
+                m_objectSlots[i] = count++;
+        }
+        if (!m_objectConstants.Begin(count))
+            return;
+        for (uint32_t i = 0; i < uint32_t(m_occluders.size()); i++)
+            m_objectConstants.Write(i, m_occluderData[i]);
+        m_jobSystem.ParallelFor(m_objects.size(), kCullGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (m_visible[i])
+                    m_objectConstants.Write(m_objectSlots[i], m_objectData[i]);
+            }
+        });
+        m_objectConstants.End();
+    }
+
+    void BenchmarkScene::DrawVisibleObjects()
+    {
+        uint32_t boundMesh = UINT32_MAX;
+        auto drawObject = [&](uint32_t meshIndex, uint32_t slot) {
+            const MeshBuffers &mesh = m_meshes[meshIndex];
+            if (meshIndex != boundMesh) {
+                m_backend.SetVertexBuffer(mesh.vertexBuffer, sizeof(Vertex));
+                m_backend.SetIndexBuffer(mesh.indexBuffer);
+                boundMesh = meshIndex;
+            }
+            m_objectConstants.Bind(slot);
+            m_backend.DrawIndexed(mesh.indexCount, 0, 0);
+        };
+
+        for (uint32_t i = 0; i < uint32_t(m_occluders.size()); i++)
+            drawObject(m_squareMesh, i);
+
+        m_visibleCount = 0;
+        for (size_t i = 0; i < m_objects.size(); i++) {
+            if (!m_visible[i])
+                continue;
+            drawObject(m_objects[i].mesh, m_objectSlots[i]);
+            m_visibleCount++;
+        }
+    }
+
+    void BenchmarkScene::GetViews(float time, RenderView *views) const
+    {
+        // 카메라 경로를 viewCount 등분한 위치에 감시 카메라를 하나씩 둠
+        const uint32_t viewCount = min(m_config.viewCount, kMaxViews);
+        LayoutViewGrid(viewCount, views);
+        for (uint32_t v = 0; v < viewCount; v++) {
+            const float viewTime = fmod(time + float(v) / viewCount, 1.0f);
+            const float aspect = (views[v].width * 16.0f) / (views[v].height * 9.0f);
+            GetCamera(viewTime, views[v].view, views[v].projection, aspect);
+        }
+    }
+
+    void BenchmarkScene::RenderViews(float time)
+    {
+        const uint32_t viewCount = min(m_config.viewCount, kMaxViews);
+        RenderView views[kMaxViews];
+        GetViews(time, views);
+
+        m_backend.BeginFrame();
+        {
+            // 물체 배열을 한 번만 훑어서 모든 뷰의 가시성을 비트로 남김
+            CpuProfileScope scope(m_profiler, "Cull");
+            m_multiViewCuller.Cull(span<const RenderView>(views, viewCount), m_worldBounds, m_viewMasks,
+                                   m_jobSystem, m_config.frustumCulling);
+        }
+        {
+            // 물체 상수는 한 뷰 이상에서 보이는 물체만 한 번 올리고 모든 뷰가 같이 씀
+            CpuProfileScope scope(m_profiler, "Transform");
+            for (size_t i = 0; i < m_objects.size(); i++)
+                m_visible[i] = m_viewMasks[i] ? 1 : 0;
+            UploadVisibleObjects();
+        }
+        {
+            CpuProfileScope scope(m_profiler, "Build");
+            m_multiViewCuller.BuildDrawLists(m_viewMasks, viewCount, m_jobSystem);
+        }
+
+        // 백엔드는 한 스레드에서만 받으므로 뷰 순서대로 제출 (D3D11의 ExecuteCommandList에 해당)
+        CpuProfileScope recordScope(m_profiler, "Submit");
+        GpuProfileScope drawScope(m_profiler, "Draw");
+
+        m_visibleCount = 0;
+        for (uint32_t v = 0; v < viewCount; v++) {
+            SetFrameConstants(views[v].view, views[v].projection);
+
+            uint32_t boundMesh = UINT32_MAX;
+            auto drawObject = [&](uint32_t meshIndex, uint32_t slot) {
+                const MeshBuffers &mesh = m_meshes[meshIndex];
+                if (meshIndex != boundMesh) {
+                    m_backend.SetVertexBuffer(mesh.vertexBuffer, sizeof(Vertex));
+                    m_backend.SetIndexBuffer(mesh.indexBuffer);
+                    boundMesh = meshIndex;
+                }
+                m_objectConstants.Bind(slot);
+                m_backend.DrawIndexed(mesh.indexCount, 0, 0);
+            };
+
+            for (uint32_t i = 0; i < uint32_t(m_occluders.size()); i++)
+                drawObject(m_squareMesh, i);
+            for (uint32_t i : m_multiViewCuller.GetDrawList(v))
+                drawObject(m_objectMeshes[i], m_objectSlots[i]);
+            m_visibleCount += uint32_t(m_multiViewCuller.GetDrawList(v).size());
+        }
+
+        m_backend.EndFrame();
+    }
+
+    void BenchmarkScene::RenderViewsIndependently(float time)
+    {
+        const uint32_t viewCount = min(m_config.viewCount, kMaxViews);
+        RenderView views[kMaxViews];
+        GetViews(time, views);
+
+        // 한 뷰짜리 RenderFrame()을 뷰 수만큼 반복하는 것과 같음 (오클루전 컬링 제외)
+        m_backend.BeginFrame();
+        uint32_t visibleCount = 0;
+        for (uint32_t v = 0; v < viewCount; v++) {
+            {
+                CpuProfileScope scope(m_profiler, "Cull");
+                if (m_config.frustumCulling) {
+                    BoundingFrustum frustum(views[v].projection);
+                    frustum.Transform(frustum, views[v].view.Invert());
+                    m_jobSystem.ParallelFor(m_objects.size(), kCullGrainSize, [&](size_t begin, size_t end) {
+                        for (size_t i = begin; i < end; i++)
+                            m_visible[i] = frustum.Intersects(m_worldBounds[i]) ? 1 : 0;
+                    });
+                }
+                else {
+                    fill(m_visible.begin(), m_visible.end(), uint8_t(1));
+                }
+            }
+
+            CpuProfileScope recordScope(m_profiler, "Record");
+            SetFrameConstants(views[v].view, views[v].projection);
+            UploadVisibleObjects();
+            DrawVisibleObjects();
+            visibleCount += m_visibleCount;
+        }
+        m_visibleCount = visibleCount;
+        m_backend.EndFrame();
+    }
+
+    BenchmarkResult RunSceneBenchmark(const BenchmarkConfig &config, RenderBackend &backend,
+                                      JobSystem &jobSystem, AllocationProbe probe, Profiler *profiler)
+    {
+        using Clock = chrono::high_resolution_clock;
+        if (!probe)
+            probe = GetTrackedAllocations;
+
+        BenchmarkResult result;
+        result.name = config.MakeName();
+        result.config = config;
+
+        // 장면 생성(메쉬 업로드)도 한 프레임으로 기록
+        const auto setupTime = Clock::now();
+        backend.BeginFrame();
+        BenchmarkScene scene(config, backend, jobSystem);
+        backend.EndFrame();
+        result.setupMs = chrono::duration<double, milli>(Clock::now() - setupTime).count();
+        result.setupBytesUploaded = backend.GetFrameStats().bytesUploaded;
+
+        const uint32_t frames = max(1u, config.frames);
+        for (uint32_t i = 0; i < config.warmupFrames; i++)
+            scene.RenderFrame(float(i % frames) / frames);
+
+        vector<double> frameMs;
+        frameMs.reserve(frames);
+        RenderStats total;
+        uint64_t visibleObjects = 0;
+        scene.SetProfiler(profiler);
+        const AllocationSnapshot allocationStart = probe();
+
+        for (uint32_t i = 0; i < frames; i++) {
+            const auto start = Clock::now();
+            if (profiler)
+                profiler->BeginFrame();
+            scene.RenderFrame(float(i) / frames);
+            if (profiler)
+                profiler->EndFrame();
+            frameMs.push_back(chrono::duration<double, milli>(Clock::now() - start).count());
+
+            const RenderStats &stats = backend.GetFrameStats();
+            total.drawCalls += stats.drawCalls;
+            total.bufferBinds += stats.bufferBinds;
+            total.bufferUpdates += stats.bufferUpdates;
+            total.bytesUploaded += stats.bytesUploaded;
+            visibleObjects += scene.GetVisibleCount();
+        }
+
+        const AllocationSnapshot allocationEnd = probe();
+
+        double sum = 0.0;
+        for (double ms : frameMs)
+            sum += ms;
+        sort(frameMs.begin(), frameMs.end());
+
+        result.frameMsMean = sum / frames;
+        result.frameMsP50 = Percentile(frameMs, 0.50);
+        result.frameMsP90 = Percentile(frameMs, 0.90);
+        result.frameMsP99 = Percentile(frameMs, 0.99);
+        result.frameMsMax = frameMs.back();
+
+        result.visibleObjects = double(visibleObjects) / frames;
+        result.drawCalls = double(total.drawCalls) / frames;
+        result.bufferBinds = double(total.bufferBinds) / frames;
+        result.bufferUpdates = double(total.bufferUpdates) / frames;
+        result.bytesUploaded = double(total.bytesUploaded) / frames;
+        // frameMs는 미리 reserve해서 측정 구간 안에서는 할당하지 않음
+        result.allocations = double(allocationEnd.count - allocationStart.count) / frames;
+        result.allocatedBytes = double(allocationEnd.bytes - allocationStart.bytes) / frames;
+
+        result.backendErrors = backend.GetErrorCount();
+
+        return result;
+    }
+}
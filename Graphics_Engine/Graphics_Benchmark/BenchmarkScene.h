@@ -0,0 +1,169 @@
+#pragma once
+
+#include <directxtk/SimpleMath.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+#include "Memory.h"
+#include "MeshGenerator.h"
+#include "MultiView.h"
+#include "OcclusionCuller.h"
+#include "Profiler.h"
+#include "RenderBackend.h"
+#include "ShaderConstants.h"
+
+namespace luke {
+
+    using DirectX::BoundingBox;
+    using DirectX::SimpleMath::Matrix;
+    using DirectX::SimpleMath::Vector3;
+
+    enum class BenchmarkMesh : uint32_t { Triangle, Square, Cube, Mixed };
+    enum class CameraPath : uint32_t { Static, Orbit, FlyThrough };
+
+    const char *GetBenchmarkMeshName(BenchmarkMesh mesh);
+    const char *GetCameraPathName(CameraPath path);
+
+    struct BenchmarkConfig {
+        uint32_t objectCount = 1000;
+        BenchmarkMesh mesh = BenchmarkMesh::Mixed;
+        CameraPath cameraPath = CameraPath::Orbit;
+        uint32_t warmupFrames = 10;
+        uint32_t frames = 240; // 카메라 경로 한 바퀴를 몇 프레임으로 나눌지
+        bool frustumCulling = true;
+        bool occlusionCulling = false;
+
+        // 1보다 크면 카메라 경로 위에 고르게 놓은 viewCount개 카메라로 화면을 나눠 그립니다. (최대 kMaxViews)
+        // independentViews == false: 합친 절두체로 한 번 컬링하고 물체별 변환을 공유, 뷰별 목록은 병렬로 만듦
+        // independentViews == true : 뷰마다 장면 전체를 따로 그림 (비교용)
+        // 여러 뷰에서는 오클루전 컬링을 하지 않습니다. (뷰마다 깊이 버퍼가 필요)
+        uint32_t viewCount = 1;
+        bool independentViews = false;
+
+        // 결과와 기준값(baseline)을 짝지을 때 쓰는 이름. 예: "mixed_orbit_1000", "mixed_orbit_1000_views4"
+        std::string MakeName() const;
+    };
+
+    // 프로세스 전체의 할당 횟수/바이트 (벤치마크 실행 파일이 operator new를 바꿔서 제공)
+    struct AllocationSnapshot {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+    };
+    using AllocationProbe = AllocationSnapshot (*)();
+
+    struct BenchmarkResult {
+        std::string name;
+        BenchmarkConfig config;
+
+        // CPU 프레임 시간 (ms)
+        double frameMsMean = 0.0;
+        double frameMsP50 = 0.0;
+        double frameMsP90 = 0.0;
+        double frameMsP99 = 0.0;
+        double frameMsMax = 0.0;
+
+        // 프레임당 평균
+        double visibleObjects = 0.0;
+        double drawCalls = 0.0;
+        double bufferBinds = 0.0;
+        double bufferUpdates = 0.0;
+        double bytesUploaded = 0.0;
+        double allocations = 0.0;
+        double allocatedBytes = 0.0;
+
+        double setupMs = 0.0;
+        uint64_t setupBytesUploaded = 0;
+        uint64_t backendErrors = 0;
+    };
+
+    // Application의 장면을 창 없이 재현한 벤치마크 장면
+    // 같은 MeshGenerator 메쉬를 공유하는 물체 objectCount개를 격자에 흩어놓고,
+    // 카메라 경로를 따라가며 컬링 -> 상수 버퍼 업데이트 -> 드로우를 RenderBackend에 기록합니다.
+    // 프레임 상수는 뷰마다 한 번, 보이는 물체의 상수는 ObjectConstantBuffer에 Map 한 번으로 올리고 범위로 바인딩합니다.
+    // 물체는 메쉬 종류별로 정렬돼 있어서 버텍스/인덱스 버퍼는 메쉬가 바뀔 때만 바인딩합니다.
+    class BenchmarkScene {
+    public:
+        BenchmarkScene(const BenchmarkConfig &config, RenderBackend &backend, JobSystem &jobSystem);
+        ~BenchmarkScene();
+
+        BenchmarkScene(const BenchmarkScene &) = delete;
+        BenchmarkScene &operator=(const BenchmarkScene &) = delete;
+
+        // time: 카메라 경로 위치 [0, 1)
+        // target이 있으면 바인딩하고 지운 뒤 그 위에 그립니다. (오프스크린 렌더링)
+        void RenderFrame(float time, RenderTargetHandle target = {});
+
+        // 컬링/기록 CPU 스코프와 드로우 GPU 스코프를 profiler에 남김 (BeginFrame/EndFrame은 호출하는 쪽에서)
+        void SetProfiler(Profiler *profiler) { m_profiler = profiler; }
+
+        uint32_t GetVisibleCount() const { return m_visibleCount; } // 여러 뷰면 뷰별 드로우 합
+        const MultiViewStats &GetMultiViewStats() const { return m_multiViewCuller.GetStats(); }
+        const OcclusionCuller &GetOcclusionCuller() const { return m_occlusionCuller; }
+
+    private:
+        struct MeshBuffers {
+            MeshData data;
+            GpuBufferHandle vertexBuffer;
+            GpuBufferHandle indexBuffer;
+            uint32_t indexCount = 0;
+            BoundingBox localBounds;
+        };
+
+        struct Object {
+            uint32_t mesh; // m_meshes 인덱스
+            Matrix world;
+        };
+
+        void CreateObjects();
+        void GetCamera(float time, Matrix &view, Matrix &projection, float aspect = 16.0f / 9.0f) const;
+        void Cull(const Matrix &view, const Matrix &projection);
+        void RenderViews(float time);
+        void RenderViewsIndependently(float time);
+        void GetViews(float time, RenderView *views) const;
+        void SetFrameConstants(const Matrix &view, const Matrix &projection);
+        // 벽과 m_visible인 물체의 상수를 올리고 m_objectSlots를 채움 (벽은 0번부터)
+        void UploadVisibleObjects();
+        void DrawVisibleObjects();
+
+        BenchmarkConfig m_config;
+        RenderBackend &m_backend;
+        JobSystem &m_jobSystem;
+        Profiler *m_profiler = nullptr;
+
+        std::vector<MeshBuffers> m_meshes;
+        std::vector<Object> m_objects;          // 메쉬 순서로 정렬
+        std::vector<BoundingBox> m_worldBounds; // m_objects와 같은 순서
+        std::vector<Matrix> m_occluders;        // 사각형 메쉬로 그리는 벽
+        uint32_t m_squareMesh = 0;
+        float m_extent = 1.0f; // 장면 반지름
+
+        GpuBufferHandle m_frameConstantBuffer;
+        ObjectConstantBuffer m_objectConstants;
+        std::vector<uint32_t> m_objectSlots;         // m_objects -> 이번 프레임의 물체 상수 번호
+        std::vector<ObjectConstants> m_objectData;   // 물체가 움직이지 않으므로 한 번만 만듦 (m_objects 순서)
+        std::vector<ObjectConstants> m_occluderData; // m_occluders 순서
+        std::vector<uint8_t> m_visible;
+        uint32_t m_visibleCount = 0;
+
+        // 오클루전 컬링 임시 데이터 (프레임마다 재사용해서 할당을 만들지 않음)
+        OcclusionCuller m_occlusionCuller;
+        LinearArena m_frameArena;
+        std::vector<BoundingBox> m_candidateBounds;
+        std::vector<uint32_t> m_candidateIndices;
+        std::vector<uint8_t> m_candidateVisible;
+
+        // 여러 뷰
+        MultiViewCuller m_multiViewCuller;
+        std::vector<ViewMask> m_viewMasks;
+        std::vector<uint32_t> m_objectMeshes; // m_objects[i].mesh만 모은 배열 (제출할 때 Object 전체를 읽지 않도록)
+    };
+
+    // 워밍업 후 config.frames 프레임을 돌려서 통계를 냅니다.
+    // probe가 없으면 MemoryTracker에 기록되는 할당만 셉니다.
+    // profiler가 있으면 측정하는 프레임마다 BeginFrame()/EndFrame()으로 타임라인을 기록합니다.
+    BenchmarkResult RunSceneBenchmark(const BenchmarkConfig &config, RenderBackend &backend,
+                                      JobSystem &jobSystem, AllocationProbe probe = nullptr,
+                                      Profiler *profiler = nullptr);
+}
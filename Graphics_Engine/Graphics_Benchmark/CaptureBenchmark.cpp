@@ -0,0 +1,138 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "BenchmarkScene.h"
+#include "CommandCapture.h"
+#include "HeadlessBackend.h"
+#include "JobSystem.h"
+
+namespace luke {
+    using namespace std;
+
+    int RunCaptureBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem)
+    {
+        BenchmarkConfig config;
+        config.objectCount = options.objectCountsSet ? options.objectCounts[0] : 1000;
+        config.mesh = options.mesh;
+        config.cameraPath = options.paths[0];
+        config.frames = options.frames;
+        config.frustumCulling = options.frustumCulling;
+        config.occlusionCulling = options.occlusionCulling;
+        config.viewCount = options.viewCounts[0];
+
+        HeadlessBackend backend;
+        CommandRecorder recorder(backend);
+        {
+            recorder.BeginFrame();
+            BenchmarkScene scene(config, recorder, jobSystem);
+            recorder.EndFrame();
+            for (uint32_t i = 0; i < options.warmupFrames; i++)
+                scene.RenderFrame(float(i) / max(config.frames, 1u));
+            recorder.RequestCapture();
+            scene.RenderFrame(float(options.warmupFrames) / max(config.frames, 1u));
+        }
+
+        const CommandCapture &capture = recorder.GetCapture();
+        if (!recorder.HasCapture() || !SaveCommandCapture(options.capturePath, capture))
+            return 2;
+        cout << config.MakeName() << ": " << capture.frameCommands.size() << " commands, "
+             << capture.bufferCount << " buffers (" << capture.setupCommands.size() << " from before the frame), "
+             << "resources " << capture.setupData.size() / 1024.0 << " KB, updates "
+             << capture.frameData.size() / 1024.0 << " KB, file " << capture.GetFileSize() / 1024.0 << " KB -> "
+             << options.capturePath << endl;
+        return backend.GetErrorCount() > 0 ? 2 : 0;
+    }
+
+    int RunReplayBenchmark(const BenchmarkOptions &options)
+    {
+        using Clock = chrono::high_resolution_clock;
+
+        CommandCapture capture;
+        if (!LoadCommandCapture(options.replayPath, capture))
+            return 2;
+
+        HeadlessBackend backend;
+        CommandReplayer replayer;
+        if (!replayer.Prepare(capture, backend))
+            return 2;
+
+        for (uint32_t i = 0; i < options.warmupFrames; i++)
+            replayer.ReplayFrame();
+
+        // 프레임 전체 시간과 명령별 시간은 따로 잼 (명령마다 시계를 읽는 비용이 프레임 시간에 섞이지 않도록)
+        const uint32_t loops = max(options.frames, 1u);
+        vector<double> frameMs;
+        frameMs.reserve(loops);
+        for (uint32_t i = 0; i < loops; i++) {
+            const auto start = Clock::now();
+            replayer.ReplayFrame();
+            frameMs.push_back(chrono::duration<double, milli>(Clock::now() - start).count());
+        }
+        vector<uint64_t> commandNs(capture.frameCommands.size(), 0);
+        for (uint32_t i = 0; i < loops; i++)
+            replayer.ReplayFrame(commandNs.data());
+        replayer.Release();
+
+        double sum = 0.0;
+        for (double ms : frameMs)
+            sum += ms;
+        sort(frameMs.begin(), frameMs.end());
+        cout << options.replayPath << ": " << capture.frameCommands.size() << " commands, " << capture.bufferCount
+             << " buffers, " << loops << " loops" << endl;
+        cout << "frame mean " << sum / loops << " ms, p50 " << frameMs[loops / 2] << " ms, p99 "
+             << frameMs[size_t(0.99 * (loops - 1))] << " ms" << endl;
+
+        // 명령 종류별 합
+        struct CommandTotal {
+            uint64_t count = 0;
+            uint64_t ns = 0;
+        };
+        CommandTotal totals[size_t(CaptureCommand::Count)];
+        uint64_t totalNs = 0;
+        for (size_t i = 0; i < capture.frameCommands.size(); i++) {
+            CommandTotal &total = totals[size_t(capture.frameCommands[i].command)];
+            total.count++;
+            total.ns += commandNs[i];
+            totalNs += commandNs[i];
+        }
+        char line[160];
+        snprintf(line, sizeof(line), "%-20s %8s %12s %10s %7s", "command", "count", "us/frame", "ns/cmd", "share");
+        cout << line << endl;
+        for (size_t c = 0; c < size_t(CaptureCommand::Count); c++) {
+            const CommandTotal &total = totals[c];
+            if (total.count == 0)
+                continue;
+            snprintf(line, sizeof(line), "%-20s %8llu %12.2f %10.1f %6.1f%%", GetCaptureCommandName(CaptureCommand(c)),
+                     (unsigned long long)total.count, total.ns / 1000.0 / loops,
+                     double(total.ns) / loops / total.count, totalNs > 0 ? 100.0 * total.ns / totalNs : 0.0);
+            cout << line << endl;
+        }
+
+        // 가장 느린 명령들 (회귀를 찾을 때 어느 드로우/업데이트인지 보기 위해)
+        vector<uint32_t> order(capture.frameCommands.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = uint32_t(i);
+        const size_t top = min<size_t>(10, order.size());
+        partial_sort(order.begin(), order.begin() + top, order.end(),
+                     [&](uint32_t a, uint32_t b) { return commandNs[a] > commandNs[b]; });
+        cout << "slowest commands:" << endl;
+        for (size_t i = 0; i < top; i++) {
+            const CaptureRecord &record = capture.frameCommands[order[i]];
+            snprintf(line, sizeof(line), "  #%-8u %-20s a=%u b=%u c=%d  %.1f ns", order[i],
+                     GetCaptureCommandName(record.command), record.a, record.b, record.c,
+                     double(commandNs[order[i]]) / loops);
+            cout << line << endl;
+        }
+
+        if (backend.GetErrorCount() > 0) {
+            cerr << backend.GetErrorCount() << " backend error(s)." << endl;
+            return 2;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,211 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <vector>
+
+#include "ClusteredLighting.h"
+#include "HeadlessBackend.h"
+#include "JobSystem.h"
+#include "ShaderConstants.h"
+
+namespace luke {
+    using namespace std;
+
+    vector<Light> MakeBenchmarkLights(uint32_t count)
+    {
+        vector<Light> lights(count);
+        uint32_t random = 12345;
+        auto next = [&]() {
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            return float(random & 0xFFFFFF) / float(0x1000000);
+        };
+        for (uint32_t i = 0; i < count; i++) {
+            const Vector3 position(next() * 200.0f - 100.0f, 0.5f + next() * 8.0f, next() * 200.0f - 100.0f);
+            const Vector3 color(0.2f + next(), 0.2f + next(), 0.2f + next());
+            const float radius = 3.0f + next() * 7.0f;
+            lights[i] = (i % 5 == 4) ? Light::Spot(position, Vector3(0.0f, -1.0f, 0.0f), radius * 1.5f, 0.7f, 0.4f,
+                                                   color * 2.0f)
+                                     : Light::Point(position, radius, color);
+        }
+        return lights;
+    }
+
+    int RunLightingBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+
+        const float aspect = float(options.width) / float(options.height);
+        const Matrix projection = DirectX::XMMatrixPerspectiveFovLH(DirectX::XM_PIDIV4, aspect, 0.1f, 200.0f);
+        const Vector3 ambient(0.05f, 0.05f, 0.06f);
+        LightClusterGrid grid;
+        grid.Configure(projection);
+
+        auto viewAt = [](uint32_t frame) {
+            const float angle = float(frame) * 0.01f;
+            const Vector3 eye(cosf(angle) * 60.0f, 25.0f, sinf(angle) * 60.0f);
+            return Matrix(DirectX::XMMatrixLookAtLH(eye, Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f)));
+        };
+
+        cout << "lights: clusters " << grid.GetClusterCount() << " (16x9x24), threads " << jobSystem.GetThreadCount() + 1
+             << ", " << options.warmupFrames << " warm-up + " << options.frames << " frames" << endl;
+        char line[240];
+        snprintf(line, sizeof(line), "%8s %10s %10s %9s %10s %9s %9s %10s", "lights", "bin ms", "p99 ms", "visible",
+                 "indices", "avg/clst", "max/clst", "upload KB");
+        cout << line << endl;
+
+        HeadlessBackend backend;
+        for (uint32_t lightCount : options.lightCounts) {
+            const vector<Light> lights = MakeBenchmarkLights(lightCount);
+
+            // 빛/클러스터는 크기가 정해져 있고, 빛 번호 버퍼는 모자라면 1.5배로 다시 만듦
+            const GpuBufferHandle constantBuffer =
+                backend.CreateBuffer(GpuBufferType::Constant, nullptr, sizeof(ClusterConstants), true);
+            const GpuBufferHandle lightBuffer = backend.CreateBuffer(
+                GpuBufferType::Structured, nullptr, max<size_t>(lights.size(), 1) * sizeof(Light), true);
+            const GpuBufferHandle clusterBuffer = backend.CreateBuffer(
+                GpuBufferType::Structured, nullptr, grid.GetClusterCount() * sizeof(LightCluster), true);
+            GpuBufferHandle indexBuffer;
+            size_t indexCapacity = 0;
+
+            auto upload = [&]() {
+                ClusterConstants constants = grid.GetConstants(float(options.width), float(options.height), ambient);
+                constants.lightCount = lightCount;
+                backend.UpdateBuffer(constantBuffer, &constants, sizeof(constants));
+
+                const vector<uint32_t> &indices = grid.GetLightIndices();
+                if (indices.size() > indexCapacity || indexBuffer.IsNull()) {
+                    if (!indexBuffer.IsNull())
+                        backend.DestroyBuffer(indexBuffer);
+                    indexCapacity = max<size_t>(indices.size() + indices.size() / 2, 1024);
+                    indexBuffer =
+                        backend.CreateBuffer(GpuBufferType::Structured, nullptr, indexCapacity * sizeof(uint32_t), true);
+                }
+                const pair<GpuBufferHandle, span<const std::byte>> uploads[] = {
+                    {lightBuffer, as_bytes(span(lights))},
+                    {clusterBuffer, as_bytes(span(grid.GetClusters()))},
+                    {indexBuffer, as_bytes(span(indices))}};
+                for (const auto &[buffer, bytes] : uploads) {
+                    if (void *mapped = backend.MapBuffer(buffer)) {
+                        if (!bytes.empty())
+                            memcpy(mapped, bytes.data(), bytes.size());
+                        backend.UnmapBuffer(buffer, bytes.size());
+                    }
+                }
+                backend.SetConstantBuffer(1, constantBuffer);
+                backend.SetShaderBuffer(0, lightBuffer);
+                backend.SetShaderBuffer(1, clusterBuffer);
+                backend.SetShaderBuffer(2, indexBuffer);
+            };
+
+            for (uint32_t frame = 0; frame < options.warmupFrames; frame++) {
+                backend.BeginFrame();
+                grid.Bin(lights, viewAt(frame), jobSystem);
+                upload();
+                backend.EndFrame();
+            }
+
+            const uint32_t frames = max(options.frames, 1u);
+            vector<double> binMs;
+            double visible = 0.0, indexCount = 0.0, occupied = 0.0, uploadBytes = 0.0;
+            uint32_t maxClusterLights = 0;
+            for (uint32_t frame = 0; frame < frames; frame++) {
+                backend.BeginFrame();
+                grid.Bin(lights, viewAt(options.warmupFrames + frame), jobSystem);
+                upload();
+                backend.EndFrame();
+
+                const LightBinningStats &stats = grid.GetStats();
+                binMs.push_back(stats.binMs);
+                visible += stats.visibleLights;
+                indexCount += stats.indexCount;
+                occupied += stats.occupiedClusters;
+                maxClusterLights = max(maxClusterLights, stats.maxClusterLights);
+                uploadBytes += double(backend.GetFrameStats().bytesUploaded);
+            }
+
+            double mean = 0.0;
+            for (double ms : binMs)
+                mean += ms;
+            mean /= frames;
+            sort(binMs.begin(), binMs.end());
+            const double p99 = binMs[min(binMs.size() - 1, size_t(binMs.size() * 0.99))];
+            snprintf(line, sizeof(line), "%8u %10.3f %10.3f %9.0f %10.0f %9.2f %9u %10.1f", lightCount, mean, p99,
+                     visible / frames, indexCount / frames, occupied > 0.0 ? indexCount / occupied : 0.0,
+                     maxClusterLights, uploadBytes / frames / 1024.0);
+            cout << line << endl;
+
+            // 바닥과 상자들을 마지막 시점에서 클러스터 조명으로 한 장 그림
+            const MeshData cube = MeshGenerator::MakeCube();
+            const GpuBufferHandle vertexBuffer = backend.CreateBuffer(
+                GpuBufferType::Vertex, cube.vertices.data(), cube.vertices.size() * sizeof(Vertex), false);
+            const GpuBufferHandle cubeIndexBuffer = backend.CreateBuffer(
+                GpuBufferType::Index, cube.indices.data(), cube.indices.size() * sizeof(uint16_t), false);
+            const Matrix view = viewAt(options.warmupFrames + frames - 1);
+            const FrameConstants frameConstants = MakeFrameConstants(view, projection);
+            const GpuBufferHandle frameBuffer =
+                backend.CreateBuffer(GpuBufferType::Constant, &frameConstants, sizeof(frameConstants), false);
+            ObjectConstantBuffer objectConstants(backend);
+            const RenderTargetHandle target = backend.CreateRenderTarget(options.width, options.height);
+
+            const auto start = Clock::now();
+            backend.BeginFrame();
+            const float clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+            backend.SetRenderTarget(target, clearColor);
+            upload();
+            backend.SetVertexBuffer(vertexBuffer, sizeof(Vertex));
+            backend.SetIndexBuffer(cubeIndexBuffer);
+            backend.SetConstantBuffer(kFrameConstantSlot, frameBuffer);
+            objectConstants.Begin(65);
+            for (uint32_t i = 0; i < 65; i++) {
+                // 0: 바닥, 나머지: 8x8 격자의 상자
+                const uint32_t box = i - 1;
+                const Matrix world = i == 0 ? Matrix::CreateScale(200.0f, 0.1f, 200.0f) *
+                                                  Matrix::CreateTranslation(0.0f, -0.05f, 0.0f)
+                                            : Matrix::CreateScale(3.0f) *
+                                                  Matrix::CreateTranslation(float(box % 8) * 20.0f - 70.0f, 1.5f,
+                                                                            float(box / 8) * 20.0f - 70.0f);
+                objectConstants.Write(i, world);
+            }
+            objectConstants.End();
+            for (uint32_t i = 0; i < 65; i++) {
+                objectConstants.Bind(i);
+                backend.DrawIndexed(uint32_t(cube.indices.size()), 0, 0);
+            }
+            backend.EndFrame();
+            const double litMs = chrono::duration<double, milli>(Clock::now() - start).count();
+
+            vector<uint8_t> rgba;
+            backend.CopyToStaging(target);
+            backend.TryReadStaging(target, rgba);
+            uint64_t litPixels = 0;
+            for (size_t i = 0; i + 3 < rgba.size(); i += 4)
+                litPixels += (rgba[i] | rgba[i + 1] | rgba[i + 2]) > 32 ? 1 : 0;
+            snprintf(line, sizeof(line), "%8s software lit frame %ux%u: %.1f ms, %.1f%% pixels lit", "",
+                     options.width, options.height, litMs, 100.0 * litPixels / max<size_t>(rgba.size() / 4, 1));
+            cout << line << endl;
+
+            backend.DestroyRenderTarget(target);
+            backend.DestroyBuffer(frameBuffer);
+            backend.DestroyBuffer(cubeIndexBuffer);
+            backend.DestroyBuffer(vertexBuffer);
+            backend.DestroyBuffer(indexBuffer);
+            backend.DestroyBuffer(clusterBuffer);
+            backend.DestroyBuffer(lightBuffer);
+            backend.DestroyBuffer(constantBuffer);
+        }
+
+        if (backend.GetErrorCount() > 0) {
+            cerr << backend.GetErrorCount() << " backend error(s)." << endl;
+            return 2;
+        }
+        return 0;
+    }
+}
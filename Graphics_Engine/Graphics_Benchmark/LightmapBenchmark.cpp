@@ -0,0 +1,123 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+#include "LightmapBaker.h"
+#include "TexturePipeline.h"
+
+namespace luke {
+    using namespace std;
+
+    int RunLightmapBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem)
+    {
+        error_code error;
+        filesystem::create_directories(options.lightmapDirectory, error);
+        if (error) {
+            cerr << "Cannot create " << options.lightmapDirectory << ": " << error.message() << endl;
+            return 2;
+        }
+
+        constexpr float kCellSize = 16.0f;
+        LightmapBaker baker;
+        for (uint32_t cell = 0; cell < 4; cell++) {
+            const Vector3 center((float(cell % 2) - 0.5f) * kCellSize, 0.0f, (float(cell / 2) - 0.5f) * kCellSize);
+            baker.AddMesh(MeshGenerator::MakeWorldCell(center, kCellSize, 120, cell + 1), Matrix::Identity);
+        }
+        const vector<Light> lights = MakeBenchmarkLights(400);
+        for (const Light &light : lights) {
+            // MakeBenchmarkLights는 200x200에 흩어 놓으므로 32x32 안의 것만 씀
+            if (fabsf(light.position.x) < kCellSize && fabsf(light.position.z) < kCellSize)
+                baker.AddLight(light);
+        }
+
+        LightmapSettings settings;
+        settings.width = options.width;
+        settings.height = options.height;
+        settings.sunColor = Vector3(1.0f, 0.9f, 0.75f);
+        if (!baker.Prepare(settings))
+            return 2;
+
+        const LightmapStats &stats = baker.GetStats();
+        char line[240];
+        snprintf(line, sizeof(line),
+                 "lightmap %ux%u: %u meshes, %u triangles, %u charts, %.2f texels/unit (%u packing attempts), "
+                 "%u texels in %u tiles, prepare %.1f ms",
+                 baker.GetWidth(), baker.GetHeight(), stats.meshCount, stats.triangleCount, stats.chartCount,
+                 stats.texelsPerUnit, stats.packAttempts, stats.coveredTexels, stats.tileCount, stats.chartMs);
+        cout << line << endl;
+        snprintf(line, sizeof(line), "BVH: %u nodes (4-wide), %u packets, depth %u, build %.2f ms", stats.bvh.nodeCount,
+                 stats.bvh.packetCount, stats.bvh.maxDepth, stats.bvh.buildMs);
+        cout << line << endl;
+        cout << "threads " << jobSystem.GetThreadCount() + 1 << ", " << options.lightmapSamples
+             << " samples per texel" << endl;
+        snprintf(line, sizeof(line), "%8s %10s %12s %12s %14s %10s", "spp", "pass ms", "rays", "Mrays/s",
+                 "rays/s/core", "delta");
+        cout << line << endl;
+
+        // 1, 1, 2, 4, ... 샘플씩 더해서 합이 두 배가 되게
+        vector<uint8_t> previous, current;
+        uint32_t done = 0;
+        while (done < options.lightmapSamples) {
+            const uint32_t samples = min(max(done, 1u), options.lightmapSamples - done);
+            const uint64_t raysBefore = stats.rays;
+            const double msBefore = stats.bakeMs;
+            baker.BakePass(samples, jobSystem);
+            done += samples;
+
+            baker.Resolve(current);
+            // 직전 결과와의 평균 차이 (8비트 단위, 덮인 텍셀만). 줄어들면 수렴 중
+            double delta = 0.0;
+            uint64_t compared = 0;
+            for (size_t i = 0; i < current.size() && previous.size() == current.size(); i += 4) {
+                if (current[i + 3] == 0)
+                    continue;
+                delta += abs(int(current[i]) - int(previous[i])) + abs(int(current[i + 1]) - int(previous[i + 1])) +
+                         abs(int(current[i + 2]) - int(previous[i + 2]));
+                compared += 3;
+            }
+            const double passMs = stats.bakeMs - msBefore;
+            const uint64_t passRays = stats.rays - raysBefore;
+            snprintf(line, sizeof(line), "%8u %10.1f %12llu %12.2f %14.0f %10.3f", done, passMs,
+                     (unsigned long long)passRays, passMs > 0.0 ? passRays / (passMs * 1000.0) : 0.0,
+                     passMs > 0.0 ? passRays / (passMs * 0.001) / stats.threadCount : 0.0,
+                     compared > 0 ? delta / compared : 0.0);
+            cout << line << endl;
+            swap(previous, current);
+        }
+        snprintf(line, sizeof(line), "total: %.1f ms, %llu rays, %.0f rays/s/core", stats.bakeMs,
+                 (unsigned long long)stats.rays, stats.GetRaysPerSecondPerCore());
+        cout << line << endl;
+
+        // 선형 보간과 밉에서 차트가 번지지 않도록 밉은 하나만
+        TextureImportSettings importSettings;
+        importSettings.format = TextureFormat::BC7;
+        importSettings.maxMips = 1;
+        TextureAsset asset;
+        TextureImportStats importStats;
+        baker.Export(importSettings, asset, jobSystem, &importStats);
+        const filesystem::path texturePath = filesystem::path(options.lightmapDirectory) / "lightmap.ltex";
+        MappedTextureFile file;
+        if (!WriteTextureFile(texturePath, asset) || !file.Open(texturePath) || file.GetMipCount() != 1) {
+            cerr << "Cannot write " << texturePath.string() << endl;
+            return 2;
+        }
+
+        vector<uint8_t> png;
+        ImageEncodeScratch scratch;
+        EncodePng(baker.GetWidth(), baker.GetHeight(), previous.data(), png, scratch);
+        const filesystem::path imagePath = filesystem::path(options.lightmapDirectory) / "lightmap.png";
+        ofstream(imagePath, ios::binary).write(reinterpret_cast<const char *>(png.data()), streamsize(png.size()));
+        cout << "wrote " << texturePath.string() << " (BC7, " << file.GetFileSize() / 1024 << " KB, encode "
+             << importStats.encodeMs << " ms) and " << imagePath.string() << endl;
+        return 0;
+    }
+}
@@ -0,0 +1,113 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "BenchmarkScene.h"
+#include "HeadlessBackend.h"
+#include "ImageWriter.h"
+#include "JobSystem.h"
+#include "OffscreenRenderer.h"
+
+namespace luke {
+    using namespace std;
+
+    int RunOffscreenBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+
+        error_code error;
+        filesystem::create_directories(options.offscreenDirectory, error);
+        if (error) {
+            cerr << "Cannot create " << options.offscreenDirectory << endl;
+            return 2;
+        }
+
+        HeadlessBackend backend;
+        ImageWriter writer(options.format, options.writers, options.queueCapacity, options.queuePolicy);
+
+        cout << "scene                              images  render ms  total ms  images/s     MB  stalls"
+                "  waits  wait ms  dropped"
+             << endl;
+
+        uint64_t totalImages = 0;
+        double totalSeconds = 0.0;
+        for (uint32_t objectCount : options.objectCounts) {
+            for (CameraPath path : options.paths) {
+                BenchmarkConfig config;
+                config.objectCount = objectCount;
+                config.mesh = options.mesh;
+                config.cameraPath = path;
+                config.frustumCulling = options.frustumCulling;
+                config.occlusionCulling = options.occlusionCulling;
+                const string name = config.MakeName();
+
+                backend.BeginFrame();
+                BenchmarkScene scene(config, backend, jobSystem);
+                backend.EndFrame();
+
+                const ImageWriterStats before = writer.GetStats();
+                const auto start = Clock::now();
+
+                OffscreenRenderer renderer(backend, writer, options.width, options.height,
+                                           options.latency);
+                for (uint32_t i = 0; i < options.images; i++) {
+                    char index[16];
+                    snprintf(index, sizeof(index), "_%04u", i);
+                    const RenderTargetHandle target = renderer.BeginFrame(
+                        filesystem::path(options.offscreenDirectory) / (name + index));
+                    scene.RenderFrame(float(i) / options.images, target);
+                    renderer.EndFrame();
+                }
+                renderer.Flush();
+                const double renderMs = chrono::duration<double, milli>(Clock::now() - start).count();
+
+                writer.WaitIdle();
+                const double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+                const ImageWriterStats after = writer.GetStats();
+                const uint64_t images = after.written - before.written;
+                const double megabytes = double(after.bytesOut - before.bytesOut) / (1024.0 * 1024.0);
+                char line[200];
+                snprintf(line, sizeof(line), "%-34s %6llu %10.1f %9.1f %9.1f %6.1f %7llu %6llu %8.1f %8llu",
+                         name.c_str(), (unsigned long long)images, renderMs, seconds * 1000.0,
+                         images / seconds, megabytes,
+                         (unsigned long long)renderer.GetStats().readbackStalls,
+                         (unsigned long long)(after.producerWaits - before.producerWaits),
+                         after.producerWaitMs - before.producerWaitMs,
+                         (unsigned long long)(after.dropped - before.dropped));
+                cout << line << endl;
+
+                totalImages += images;
+                totalSeconds += seconds;
+            }
+        }
+
+        const ImageWriterStats stats = writer.GetStats();
+        cout << "total " << totalImages << " images, " << (totalSeconds > 0.0 ? totalImages / totalSeconds : 0.0)
+             << " images/s (" << options.width << "x" << options.height << ", "
+             << GetImageFormatName(options.format) << ", latency " << options.latency << ", "
+             << writer.GetThreadCount() << " encoders)" << endl;
+        if (stats.written > 0) {
+            const double pixels = double(stats.bytesIn) / 4.0;
+            cout << "encode " << stats.encodeMs / stats.written << " ms/image ("
+                 << pixels / (stats.encodeMs * 1000.0) << " MPixels/s per thread), write "
+                 << stats.writeMs / stats.written << " ms/image, ratio "
+                 << double(stats.bytesOut) / double(max<uint64_t>(stats.bytesIn, 1)) << endl;
+        }
+        cout << "queue high water " << stats.queueHighWater << "/" << stats.queueCapacity << ", buffers "
+             << stats.buffersAllocated << " allocated, " << stats.buffersReused << " reused" << endl;
+
+        if (stats.failed > 0 || backend.GetErrorCount() > 0) {
+            cerr << stats.failed << " image(s) failed, " << backend.GetErrorCount()
+                 << " backend error(s)." << endl;
+            return 2;
+        }
+        return 0;
+    }
+}
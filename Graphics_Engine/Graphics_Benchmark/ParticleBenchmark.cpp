@@ -0,0 +1,125 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include "HeadlessBackend.h"
+#include "JobSystem.h"
+#include "ParticleSystem.h"
+
+namespace luke {
+    using namespace std;
+
+    int RunParticleBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+
+        // 종류마다 4개씩, 격자에 세운 이미터 12개
+        constexpr uint32_t kEmittersPerKind = 4;
+        const uint32_t perEmitter = max(1u, options.particleCount / (3 * kEmittersPerKind));
+        ParticleSystem particles;
+        for (uint32_t i = 0; i < kEmittersPerKind; i++) {
+            const Vector3 position(float(i) * 4.0f, 0.0f, 0.0f);
+            EmitterSettings kinds[] = {EmitterSettings::Smoke(perEmitter), EmitterSettings::Sparks(perEmitter),
+                                       EmitterSettings::Debris(perEmitter)};
+            for (uint32_t kind = 0; kind < 3; kind++) {
+                kinds[kind].position = position + Vector3(0.0f, 0.0f, float(kind) * 4.0f);
+                particles.AddEmitter(kinds[kind], i * 3 + kind + 1);
+            }
+        }
+
+        HeadlessBackend backend;
+        const MeshData quad = MeshGenerator::MakeSquare();
+        const GpuBufferHandle vertexBuffer = backend.CreateBuffer(
+            GpuBufferType::Vertex, quad.vertices.data(), quad.vertices.size() * sizeof(Vertex), false);
+        const GpuBufferHandle indexBuffer = backend.CreateBuffer(
+            GpuBufferType::Index, quad.indices.data(), quad.indices.size() * sizeof(uint16_t), false);
+        const Matrix viewProjection =
+            (Matrix::CreateLookAt(Vector3(6.0f, 6.0f, -20.0f), Vector3(6.0f, 2.0f, 4.0f), Vector3::UnitY) *
+             Matrix::CreatePerspectiveFieldOfView(1.0f, 16.0f / 9.0f, 0.1f, 100.0f))
+                .Transpose();
+        const GpuBufferHandle constantBuffer =
+            backend.CreateBuffer(GpuBufferType::Constant, &viewProjection, sizeof(viewProjection), false);
+        vector<GpuBufferHandle> instanceBuffers;
+        for (uint32_t e = 0; e < particles.GetEmitterCount(); e++)
+            instanceBuffers.push_back(backend.CreateBuffer(
+                GpuBufferType::Vertex, nullptr, size_t(particles.GetCapacity(e)) * sizeof(ParticleInstance), true));
+
+        const float dt = 1.0f / 60.0f;
+        auto renderFrame = [&]() {
+            backend.BeginFrame();
+            backend.SetVertexBuffer(vertexBuffer, sizeof(Vertex));
+            backend.SetIndexBuffer(indexBuffer);
+            backend.SetConstantBuffer(0, constantBuffer);
+            for (uint32_t e = 0; e < particles.GetEmitterCount(); e++) {
+                const uint32_t count = particles.GetParticleCount(e);
+                if (count == 0)
+                    continue;
+                ParticleInstance *instances = static_cast<ParticleInstance *>(backend.MapBuffer(instanceBuffers[e]));
+                if (!instances)
+                    continue;
+                particles.WriteInstances(e, instances, jobSystem);
+                backend.UnmapBuffer(instanceBuffers[e], count * sizeof(ParticleInstance));
+                backend.SetInstanceBuffer(instanceBuffers[e], sizeof(ParticleInstance));
+                backend.DrawIndexedInstanced(uint32_t(quad.indices.size()), count, 0);
+            }
+            backend.EndFrame();
+        };
+
+        // 가장 긴 수명(연기 5초)이 지나야 생성과 제거가 맞아서 파티클 수가 일정해짐
+        const uint32_t prewarmFrames = max(options.warmupFrames, uint32_t(5.5f / dt));
+        for (uint32_t frame = 0; frame < prewarmFrames; frame++) {
+            particles.Update(dt, jobSystem);
+            renderFrame();
+        }
+
+        const uint32_t frames = max(options.frames, 1u);
+        double simulateMs = 0.0, writeMs = 0.0, submitMs = 0.0;
+        uint64_t simulated = 0, spawned = 0, killed = 0;
+        for (uint32_t frame = 0; frame < frames; frame++) {
+            particles.Update(dt, jobSystem);
+            const auto start = Clock::now();
+            renderFrame();
+            submitMs += chrono::duration<double, milli>(Clock::now() - start).count();
+
+            const ParticleStats &stats = particles.GetStats();
+            simulateMs += stats.simulateMs;
+            writeMs += stats.writeMs;
+            simulated += stats.simulated;
+            spawned += stats.spawned;
+            killed += stats.killed;
+        }
+
+        const RenderStats &renderStats = backend.GetFrameStats();
+        cout << "particles: " << particles.GetParticleCount() << " alive in " << particles.GetEmitterCount()
+             << " emitters (capacity " << uint64_t(perEmitter) * particles.GetEmitterCount() << "), threads "
+             << jobSystem.GetThreadCount() + 1 << ", " << prewarmFrames << " prewarm + " << frames << " frames" << endl;
+        char line[200];
+        snprintf(line, sizeof(line),
+                 "simulate %7.3f ms, write instances %7.3f ms, map+write+draw %7.3f ms; spawned %.0f, killed %.0f "
+                 "per frame",
+                 simulateMs / frames, writeMs / frames, submitMs / frames, double(spawned) / frames,
+                 double(killed) / frames);
+        cout << line << endl;
+        snprintf(line, sizeof(line), "%llu draws, %llu instances, %.2f MB uploaded per frame",
+                 (unsigned long long)renderStats.drawCalls, (unsigned long long)renderStats.instanceCount,
+                 renderStats.bytesUploaded / (1024.0 * 1024.0));
+        cout << line << endl;
+        cout << "particles/ms: simulate " << (simulateMs > 0.0 ? simulated / simulateMs : 0.0) << ", simulate + write "
+             << (simulateMs + writeMs > 0.0 ? simulated / (simulateMs + writeMs) : 0.0) << endl;
+
+        for (GpuBufferHandle buffer : instanceBuffers)
+            backend.DestroyBuffer(buffer);
+        backend.DestroyBuffer(constantBuffer);
+        backend.DestroyBuffer(indexBuffer);
+        backend.DestroyBuffer(vertexBuffer);
+        if (backend.GetErrorCount() > 0) {
+            cerr << backend.GetErrorCount() << " backend error(s)." << endl;
+            return 2;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,116 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "HeadlessBackend.h"
+#include "RenderTargetPool.h"
+
+namespace luke {
+    using namespace std;
+
+    int RunResizeBenchmark(const BenchmarkOptions &options, AllocationProbe probe)
+    {
+        using Clock = chrono::high_resolution_clock;
+        constexpr uint32_t kEventsPerFrame = 4;
+
+        // 처음 크기에서 절반까지 줄였다가 되돌아오는 드래그
+        auto GetSize = [&](uint32_t frame, uint32_t event, uint32_t &width, uint32_t &height) {
+            const float t = (frame + float(event + 1) / kEventsPerFrame) / float(options.resizeFrames);
+            const float scale = 0.75f + 0.25f * cos(t * 6.2831853f);
+            width = max(1u, uint32_t(options.width * scale));
+            height = max(1u, uint32_t(options.height * scale));
+        };
+
+        cout << "strategy      frames  avg ms  worst ms  creates  destroys  reused      MB" << endl;
+        const float clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        for (const char *strategy : {"immediate", "deferred", "pooled"}) {
+            const bool immediate = strcmp(strategy, "immediate") == 0;
+            const bool pooled = strcmp(strategy, "pooled") == 0;
+
+            HeadlessBackend backend;
+            uint64_t creates = 0;
+            uint64_t destroys = 0;
+            RenderTargetPool<RenderTargetHandle> pool;
+            pool.Initialize(
+                [&](const RenderTargetDesc &desc, RenderTargetHandle &target) {
+                    target = backend.CreateRenderTarget(desc.width, desc.height);
+                    return !target.IsNull();
+                },
+                [&](RenderTargetHandle &target) { backend.DestroyRenderTarget(target); });
+
+            RenderTargetDesc desc;
+            desc.width = options.width;
+            desc.height = options.height;
+            RenderTargetHandle target;
+            auto Recreate = [&](uint32_t width, uint32_t height) {
+                if (width == desc.width && height == desc.height && !target.IsNull())
+                    return;
+                if (pooled) {
+                    if (!target.IsNull())
+                        pool.Release(desc, target);
+                    desc.width = width;
+                    desc.height = height;
+                    pool.Acquire(desc, target);
+                    return;
+                }
+                if (!target.IsNull()) {
+                    backend.DestroyRenderTarget(target);
+                    destroys++;
+                }
+                desc.width = width;
+                desc.height = height;
+                target = backend.CreateRenderTarget(width, height);
+                creates++;
+            };
+            Recreate(options.width, options.height);
+
+            const AllocationSnapshot before = probe ? probe() : AllocationSnapshot();
+            double totalMs = 0.0;
+            double worstMs = 0.0;
+            for (uint32_t frame = 0; frame < options.resizeFrames; frame++) {
+                const auto start = Clock::now();
+                pool.BeginFrame(frame);
+                uint32_t width = desc.width, height = desc.height;
+                for (uint32_t event = 0; event < kEventsPerFrame; event++) {
+                    GetSize(frame, event, width, height);
+                    if (immediate)
+                        Recreate(width, height);
+                }
+                Recreate(width, height);
+
+                backend.BeginFrame();
+                backend.SetRenderTarget(target, clearColor);
+                backend.SetRenderTarget({}, clearColor);
+                backend.EndFrame();
+
+                const double ms = chrono::duration<double, milli>(Clock::now() - start).count();
+                totalMs += ms;
+                worstMs = max(worstMs, ms);
+            }
+            const AllocationSnapshot after = probe ? probe() : AllocationSnapshot();
+
+            if (pooled) {
+                creates = pool.GetStats().created;
+                destroys = pool.GetStats().destroyed;
+            }
+            char line[160];
+            snprintf(line, sizeof(line), "%-12s %7u %7.3f %9.3f %8llu %9llu %7llu %7.1f", strategy,
+                     options.resizeFrames, totalMs / max(options.resizeFrames, 1u), worstMs,
+                     (unsigned long long)creates, (unsigned long long)destroys,
+                     (unsigned long long)pool.GetStats().reused,
+                     double(after.bytes - before.bytes) / (1024.0 * 1024.0));
+            cout << line << endl;
+
+            if (backend.GetErrorCount() > 0) {
+                cerr << backend.GetErrorCount() << " backend error(s)." << endl;
+                return 2;
+            }
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,125 @@
+#include "BenchmarkOptions.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "HeadlessBackend.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        BenchmarkEnvironment GetEnvironment(const JobSystem &jobSystem)
+        {
+            BenchmarkEnvironment environment;
+#if defined(_WIN32)
+            environment.platform = "windows";
+#elif defined(__linux__)
+            environment.platform = "linux";
+#else
+            environment.platform = "unknown";
+#endif
+#if defined(_MSC_VER)
+            environment.compiler = "msvc " + to_string(_MSC_VER);
+#elif defined(__clang__)
+            environment.compiler = "clang " + to_string(__clang_major__) + "." + to_string(__clang_minor__);
+#elif defined(__GNUC__)
+            environment.compiler = "gcc " + to_string(__GNUC__) + "." + to_string(__GNUC_MINOR__);
+#endif
+#ifdef NDEBUG
+            environment.configuration = "release";
+#else
+            environment.configuration = "debug";
+#endif
+            environment.threadCount = uint32_t(jobSystem.GetThreadCount() + 1); // 호출 스레드 포함
+            return environment;
+        }
+    }
+
+    int RunSceneBenchmarks(const BenchmarkOptions &options, const BenchmarkBaseline &baseline, JobSystem &jobSystem,
+                           AllocationProbe probe)
+    {
+        HeadlessBackend backend;
+
+        // 프로파일러는 스코프 기록 비용이 있으므로 --trace일 때만 사용
+        Profiler profiler;
+        profiler.SetGpuTimestamps(&backend);
+        Profiler *traceProfiler = options.tracePath.empty() ? nullptr : &profiler;
+
+        vector<BenchmarkResult> results;
+        for (uint32_t objectCount : options.objectCounts) {
+            for (CameraPath path : options.paths) {
+                double singleViewMs = 0.0;
+                for (uint32_t viewCount : options.viewCounts) {
+                    for (bool independent : {false, true}) {
+                        if (independent && viewCount == 1)
+                            continue;
+
+                        BenchmarkConfig config;
+                        config.objectCount = objectCount;
+                        config.mesh = options.mesh;
+                        config.cameraPath = path;
+                        config.frames = options.frames;
+                        config.warmupFrames = options.warmupFrames;
+                        config.frustumCulling = options.frustumCulling;
+                        config.occlusionCulling = options.occlusionCulling;
+                        config.viewCount = viewCount;
+                        config.independentViews = independent;
+
+                        const BenchmarkResult result =
+                            RunSceneBenchmark(config, backend, jobSystem, probe, traceProfiler);
+                        cerr << result.name << ": p50 " << result.frameMsP50 << " ms, p99 " << result.frameMsP99
+                             << " ms, draws " << result.drawCalls << ", uploaded " << result.bytesUploaded
+                             << " B, allocs " << result.allocations;
+                        // 한 뷰 결과가 있으면 뷰 하나를 더할 때마다 늘어나는 시간
+                        if (viewCount == 1)
+                            singleViewMs = result.frameMsMean;
+                        else if (singleViewMs > 0.0)
+                            cerr << ", +" << (result.frameMsMean - singleViewMs) / (viewCount - 1)
+                                 << " ms per added view";
+                        cerr << endl;
+                        results.push_back(result);
+                    }
+                }
+            }
+        }
+
+        if (traceProfiler) {
+            if (!profiler.ExportTrace(options.tracePath))
+                return 2;
+            if (const ProfileFrame *frame = profiler.GetLatestFrame())
+                cerr << "Trace: " << profiler.GetFrameCount() << " frames to " << options.tracePath
+                     << " (last frame CPU " << frame->cpuMs << " ms, GPU " << frame->gpuMs << " ms)" << endl;
+        }
+
+        const BenchmarkEnvironment environment = GetEnvironment(jobSystem);
+        if (options.outPath.empty()) {
+            WriteBenchmarkJson(cout, environment, results);
+        }
+        else {
+            ofstream file(options.outPath);
+            if (!file) {
+                cerr << "Cannot write " << options.outPath << endl;
+                return 2;
+            }
+            WriteBenchmarkJson(file, environment, results);
+        }
+
+        if (!options.baselinePath.empty()) {
+            cerr << "Comparing with " << options.baselinePath << " (tolerance " << options.tolerance * 100.0
+                 << "%)" << endl;
+            const int regressions = CompareWithBaseline(results, baseline, options.tolerance, cerr);
+            if (regressions > 0) {
+                cerr << regressions << " regression(s)." << endl;
+                return 1;
+            }
+            cerr << "No regressions." << endl;
+        }
+
+        return 0;
+    }
+}
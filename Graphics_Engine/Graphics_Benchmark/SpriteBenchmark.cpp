@@ -0,0 +1,222 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "GlyphAtlas.h"
+#include "HeadlessBackend.h"
+#include "JobSystem.h"
+#include "ShaderConstants.h"
+#include "SpriteBatcher.h"
+
+namespace luke {
+    using namespace std;
+
+    int RunSpriteBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+        constexpr uint16_t kAtlasTexture = 0;
+        constexpr uint16_t kMarkerTextures = 4; // 1 ~ 4
+        constexpr uint16_t kLabelLayer = 4;
+
+        const double budgetMs = 1000.0 / options.spriteFps;
+        const float width = float(options.width);
+        const float height = float(options.height);
+        cout << "sprites: " << options.width << "x" << options.height << ", budget " << budgetMs << " ms ("
+             << options.spriteFps << " FPS), threads " << jobSystem.GetThreadCount() + 1 << endl;
+
+        HeadlessBackend backend;
+        SpriteBatcher batcher(backend);
+        GlyphAtlas atlas(256, 256, 16.0f,
+                         [](uint32_t codepoint, GlyphBitmap &bitmap) { return MakeTestGlyph(codepoint, 12, bitmap); },
+                         kAtlasTexture);
+
+        // 마커마다 고정된 궤도와 라벨 (라벨 문자열은 한 번만 만듦)
+        struct Marker {
+            Vector2 center;
+            float radius;
+            float speed;
+            float phase;
+        };
+        vector<Marker> markers;
+        vector<string> labels;
+        uint32_t random = 12345;
+        auto next = [&]() {
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            return float(random & 0xFFFFFF) / float(0x1000000);
+        };
+        auto reserveMarkers = [&](uint32_t count) {
+            while (markers.size() < count) {
+                markers.push_back({Vector2(next() * width, next() * height), 4.0f + next() * 32.0f,
+                                   0.5f + next() * 2.0f, next() * DirectX::XM_2PI});
+                labels.push_back("#" + to_string(markers.size() - 1));
+            }
+        };
+
+        uint32_t textureBinds = 0;
+        auto buildFrame = [&](uint32_t count, float time) {
+            batcher.Begin();
+            for (uint32_t i = 0; i < count; i++) {
+                const Marker &marker = markers[i];
+                const float angle = marker.phase + time * marker.speed;
+                Sprite sprite;
+                sprite.position = marker.center + Vector2(cosf(angle), sinf(angle)) * marker.radius;
+                sprite.size = Vector2(12.0f, 12.0f);
+                sprite.rotation = angle;
+                sprite.color = 0xFF000000u | (i * 2654435761u >> 8);
+                sprite.texture = uint16_t(1 + i % kMarkerTextures);
+                sprite.layer = uint16_t((i / kMarkerTextures) % 4);
+                batcher.Add(sprite);
+                if (i % 4 == 0)
+                    batcher.AddText(atlas, labels[i], sprite.position + Vector2(8.0f, -8.0f), 0xFFFFFFFFu,
+                                    kLabelLayer);
+            }
+        };
+
+        struct Measurement {
+            uint32_t markers = 0;
+            uint32_t sprites = 0;
+            uint32_t batches = 0;
+            double addMs = 0.0;
+            double sortMs = 0.0;
+            double writeMs = 0.0;
+            double drawMs = 0.0;
+            double frameMs = 0.0;
+        };
+        auto measure = [&](uint32_t count) {
+            reserveMarkers(count);
+            Measurement result;
+            result.markers = count;
+            for (uint32_t frame = 0; frame < options.warmupFrames + options.frames; frame++) {
+                const auto start = Clock::now();
+                backend.BeginFrame();
+                buildFrame(count, frame / 60.0f);
+                const auto added = Clock::now();
+                batcher.End(jobSystem);
+                const auto ended = Clock::now();
+                textureBinds = 0;
+                batcher.Draw([&](uint16_t) { textureBinds++; });
+                backend.EndFrame();
+                const auto end = Clock::now();
+
+                if (frame < options.warmupFrames)
+                    continue;
+                result.addMs += chrono::duration<double, milli>(added - start).count();
+                result.sortMs += batcher.GetStats().sortMs;
+                result.writeMs += batcher.GetStats().writeMs;
+                result.drawMs += chrono::duration<double, milli>(end - ended).count();
+                result.frameMs += chrono::duration<double, milli>(end - start).count();
+            }
+            const double frames = max(options.frames, 1u);
+            result.sprites = batcher.GetSpriteCount();
+            result.batches = batcher.GetStats().batchCount;
+            result.addMs /= frames;
+            result.sortMs /= frames;
+            result.writeMs /= frames;
+            result.drawMs /= frames;
+            result.frameMs /= frames;
+
+            char line[200];
+            snprintf(line, sizeof(line),
+                     "%9u sprites: add %7.3f ms, sort %7.3f ms (%u passes), write %7.3f ms, draw %6.3f ms, "
+                     "frame %7.3f ms, %u draws",
+                     result.sprites, result.addMs, result.sortMs, batcher.GetStats().sortPasses, result.writeMs,
+                     result.drawMs, result.frameMs, result.batches);
+            cout << line << endl;
+            return result;
+        };
+
+        Measurement best;
+        uint32_t over = 0; // 예산을 넘은 가장 작은 마커 수
+        for (uint32_t count = 1024; count <= (1u << 22); count *= 2) {
+            const Measurement measurement = measure(count);
+            if (measurement.frameMs > budgetMs) {
+                over = count;
+                break;
+            }
+            best = measurement;
+        }
+        while (over > 0 && over - best.markers > max(1u, best.markers / 32)) {
+            const Measurement measurement = measure(best.markers + (over - best.markers) / 2);
+            if (measurement.frameMs > budgetMs)
+                over = measurement.markers;
+            else
+                best = measurement;
+        }
+        if (best.markers == 0) {
+            cout << "no sprite count fits in " << budgetMs << " ms" << endl;
+            return 0;
+        }
+
+        // 찾은 수로 한 번 더 그려서 백엔드 통계를 얻음
+        measure(best.markers);
+        const RenderStats batchedStats = backend.GetFrameStats();
+        const GlyphAtlasStats &atlasStats = atlas.GetStats();
+        cout << "sprites/frame at " << options.spriteFps << " FPS: " << best.sprites << " (" << best.markers
+             << " markers + " << best.sprites - best.markers << " glyphs, " << best.frameMs << " ms)" << endl;
+        char line[200];
+        snprintf(line, sizeof(line),
+                 "  batched:    %llu draws, %u texture binds, %llu Map calls, %.2f MB uploaded per frame",
+                 (unsigned long long)batchedStats.drawCalls, textureBinds,
+                 (unsigned long long)batchedStats.bufferUpdates, batchedStats.bytesUploaded / (1024.0 * 1024.0));
+        cout << line << endl;
+
+        // 스프라이트마다 상수 버퍼를 올리고 MakeSquare를 그리는 방식 (위치/크기/회전/색/UV = 상수 48바이트)
+        {
+            HeadlessBackend naiveBackend;
+            const MeshData quad = MeshGenerator::MakeSquare();
+            const GpuBufferHandle vertexBuffer = naiveBackend.CreateBuffer(
+                GpuBufferType::Vertex, quad.vertices.data(), quad.vertices.size() * sizeof(Vertex), false);
+            const GpuBufferHandle indexBuffer = naiveBackend.CreateBuffer(
+                GpuBufferType::Index, quad.indices.data(), quad.indices.size() * sizeof(uint16_t), false);
+            const GpuBufferHandle constantBuffer =
+                naiveBackend.CreateBuffer(GpuBufferType::Constant, nullptr, sizeof(SpriteInstance) + 8, true);
+
+            vector<SpriteInstance> instances(best.sprites);
+            double naiveMs = 0.0;
+            for (uint32_t frame = 0; frame < options.warmupFrames + options.frames; frame++) {
+                const auto start = Clock::now();
+                naiveBackend.BeginFrame();
+                naiveBackend.SetVertexBuffer(vertexBuffer, sizeof(Vertex));
+                naiveBackend.SetIndexBuffer(indexBuffer);
+                for (const SpriteInstance &instance : instances) {
+                    naiveBackend.UpdateBuffer(constantBuffer, &instance, sizeof(instance));
+                    naiveBackend.SetConstantBuffer(0, constantBuffer);
+                    naiveBackend.DrawIndexed(uint32_t(quad.indices.size()), 0, 0);
+                }
+                naiveBackend.EndFrame();
+                if (frame >= options.warmupFrames)
+                    naiveMs += chrono::duration<double, milli>(Clock::now() - start).count();
+            }
+            const RenderStats &naiveStats = naiveBackend.GetFrameStats();
+            snprintf(line, sizeof(line),
+                     "  per-sprite: %llu draws, %llu Map calls, %.2f MB uploaded, %.3f ms submit (no sort/text)",
+                     (unsigned long long)naiveStats.drawCalls, (unsigned long long)naiveStats.bufferUpdates,
+                     naiveStats.bytesUploaded / (1024.0 * 1024.0), naiveMs / max(options.frames, 1u));
+            cout << line << endl;
+
+            naiveBackend.DestroyBuffer(constantBuffer);
+            naiveBackend.DestroyBuffer(indexBuffer);
+            naiveBackend.DestroyBuffer(vertexBuffer);
+            if (naiveBackend.GetErrorCount() > 0) {
+                cerr << naiveBackend.GetErrorCount() << " backend error(s)." << endl;
+                return 2;
+            }
+        }
+
+        cout << "glyph atlas: " << atlasStats.glyphCount << " glyphs, " << atlasStats.usedHeight << "/"
+             << atlas.GetHeight() << " rows used, " << atlasStats.failed << " failed" << endl;
+        if (backend.GetErrorCount() > 0) {
+            cerr << backend.GetErrorCount() << " backend error(s)." << endl;
+            return 2;
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,179 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "GpuMemory.h"
+#include "HeadlessBackend.h"
+#include "JobSystem.h"
+#include "WorldStreamer.h"
+
+namespace luke {
+    using namespace std;
+
+    int RunStreamingBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+
+        WorldStreamingSettings settings;
+        settings.memoryBudget = uint64_t(options.streamBudgetMB) << 20;
+        const float extent = 0.5f * settings.cellSize * settings.gridWidth;
+
+        // 셀별 저장소: Load()는 작업 스레드에서 mesh를, Upload()/Unload()는 메인 스레드에서 버퍼를 다룸
+        struct CellContent {
+            MeshData mesh;
+            GpuBufferHandle vertexBuffer;
+            GpuBufferHandle indexBuffer;
+            uint32_t indexCount = 0;
+        };
+        GpuMemoryTracker memory; // 백엔드의 버퍼보다 오래 살아야 함
+        HeadlessBackend backend;
+        WorldStreamer streamer;
+        vector<CellContent> cells(size_t(settings.gridWidth) * settings.gridDepth);
+        uint64_t uploadedBytes = 0;
+
+        // GPU 메모리 기록. 예산을 넘으면 먼 셀부터 내려서 자리를 만듦 (헤드리스는 바로 해제되므로 같은 할당에 반영됨)
+        const bool trackMemory = options.gpuBudgetMB > 0 || !options.memoryStatsPath.empty();
+        if (trackMemory) {
+            memory.SetTotalBudget({uint64_t(options.gpuBudgetMB) << 20, true});
+            memory.AddEvictionCallback(
+                [&](GpuMemoryCategory, uint64_t bytesNeeded) { return streamer.Evict(bytesNeeded); });
+            backend.SetMemoryTracker(&memory);
+        }
+
+        streamer.Initialize(
+            settings, jobSystem,
+            [&](uint32_t cell) -> uint64_t {
+                if (options.ioLatencyMs > 0.0f)
+                    this_thread::sleep_for(chrono::duration<float, milli>(options.ioLatencyMs));
+                CellContent &content = cells[cell];
+                content.mesh = MeshGenerator::MakeWorldCell(streamer.GetCellCenter(cell), settings.cellSize,
+                                                            options.cellCubes, cell);
+                return content.mesh.vertices.size() * sizeof(Vertex) +
+                       content.mesh.indices.size() * sizeof(uint16_t);
+            },
+            [&](uint32_t cell) -> uint64_t {
+                GpuMemoryOwnerScope ownerScope("WorldStreamer");
+                CellContent &content = cells[cell];
+                const size_t vertexBytes = content.mesh.vertices.size() * sizeof(Vertex);
+                const size_t indexBytes = content.mesh.indices.size() * sizeof(uint16_t);
+                content.vertexBuffer =
+                    backend.CreateBuffer(GpuBufferType::Vertex, content.mesh.vertices.data(), vertexBytes, false);
+                content.indexBuffer =
+                    backend.CreateBuffer(GpuBufferType::Index, content.mesh.indices.data(), indexBytes, false);
+                if (content.vertexBuffer.IsNull() || content.indexBuffer.IsNull())
+                    return 0; // 예산 초과. Unload()가 남은 버퍼를 지움
+                content.indexCount = uint32_t(content.mesh.indices.size());
+                content.mesh = MeshData(); // GPU로 올렸으므로 CPU 사본은 버림
+                uploadedBytes += vertexBytes + indexBytes;
+                return vertexBytes + indexBytes;
+            },
+            [&](uint32_t cell) {
+                CellContent &content = cells[cell];
+                if (!content.vertexBuffer.IsNull())
+                    backend.DestroyBuffer(content.vertexBuffer);
+                if (!content.indexBuffer.IsNull())
+                    backend.DestroyBuffer(content.indexBuffer);
+                content = CellContent();
+            });
+
+        // 월드 안쪽을 8자로 날아가는 경로. 한 바퀴에 streamFrames 프레임
+        auto GetEye = [&](uint32_t frame) {
+            const float t = 6.2831853f * float(frame) / float(options.streamFrames);
+            return Vector3(0.8f * extent * sin(t), 2.0f, 0.8f * extent * sin(2.0f * t));
+        };
+
+        struct ViewConstants {
+            float viewProjection[16];
+        } constants = {};
+        const GpuBufferHandle constantBuffer = [&] {
+            GpuMemoryOwnerScope ownerScope("StreamingView");
+            return backend.CreateBuffer(GpuBufferType::Constant, &constants, sizeof(constants), true);
+        }();
+
+        vector<double> frameMs;
+        frameMs.reserve(options.streamFrames);
+        double updateMsTotal = 0.0;
+        double updateMsWorst = 0.0;
+        double residentMbTotal = 0.0;
+        uint32_t worstMissing = 0;
+        // 읽기가 실제 시간에 맞춰 끝나도록 60 FPS로 맞춰서 돌림 (빨리 끝난 프레임은 기다림)
+        const auto frameInterval = chrono::duration_cast<Clock::duration>(chrono::duration<double>(1.0 / 60.0));
+        auto nextFrame = Clock::now();
+        for (uint32_t frame = 0; frame < options.streamFrames; frame++) {
+            this_thread::sleep_until(nextFrame);
+            nextFrame += frameInterval;
+            const auto start = Clock::now();
+            const Vector3 eye = GetEye(frame);
+            const Vector3 direction = GetEye(frame + 1) - eye;
+
+            streamer.Update(eye, direction);
+            const double updateMs = chrono::duration<double, milli>(Clock::now() - start).count();
+
+            backend.BeginFrame();
+            backend.SetConstantBuffer(0, constantBuffer);
+            backend.UpdateBuffer(constantBuffer, &constants, sizeof(constants));
+            for (uint32_t cell : streamer.GetResidentCells()) {
+                const CellContent &content = cells[cell];
+                backend.SetVertexBuffer(content.vertexBuffer, sizeof(Vertex));
+                backend.SetIndexBuffer(content.indexBuffer);
+                backend.DrawIndexed(content.indexCount, 0, 0);
+            }
+            backend.EndFrame();
+
+            const WorldStreamingStats &stats = streamer.GetStats();
+            frameMs.push_back(chrono::duration<double, milli>(Clock::now() - start).count());
+            updateMsTotal += updateMs;
+            updateMsWorst = max(updateMsWorst, updateMs);
+            residentMbTotal += double(stats.residentBytes) / (1024.0 * 1024.0);
+            worstMissing = max(worstMissing, stats.missingRequiredCells);
+            if (!options.memoryStatsPath.empty() && frame % 60 == 0)
+                memory.ExportStats(options.memoryStatsPath);
+        }
+        if (!options.memoryStatsPath.empty())
+            memory.ExportStats(options.memoryStatsPath);
+        const GpuMemoryStats memoryStats = memory.GetStats();
+
+        const WorldStreamingStats stats = streamer.GetStats();
+        const double cellBytes = stats.uploads > 0 ? double(uploadedBytes) / stats.uploads : 0.0;
+        streamer.Shutdown();
+        backend.DestroyBuffer(constantBuffer);
+
+        sort(frameMs.begin(), frameMs.end());
+        const uint32_t frames = max(options.streamFrames, 1u);
+        auto Percentile = [&](double p) { return frameMs.empty() ? 0.0 : frameMs[size_t(p * (frameMs.size() - 1))]; };
+
+        cout << "cells " << settings.gridWidth << "x" << settings.gridDepth << " (" << options.cellCubes
+             << " cubes each), budget " << options.streamBudgetMB << " MB, io latency " << options.ioLatencyMs
+             << " ms, loaders " << jobSystem.GetThreadCount() << endl;
+        cout << "frames " << options.streamFrames << ": p50 " << Percentile(0.5) << " ms, p99 "
+             << Percentile(0.99) << " ms, update avg " << updateMsTotal / frames << " ms, worst "
+             << updateMsWorst << " ms" << endl;
+        cout << "resident avg " << residentMbTotal / frames << " MB, peak "
+             << double(stats.peakResidentBytes) / (1024.0 * 1024.0) << " MB (whole world ~"
+             << cellBytes * settings.gridWidth * settings.gridDepth / (1024.0 * 1024.0) << " MB)" << endl;
+        cout << "loads " << stats.loads << ", uploads " << stats.uploads << ", unloads " << stats.unloads
+             << ", evictions " << stats.evictions << ", cancelled " << stats.cancelledLoads
+             << ", budget-limited frames " << stats.budgetLimitedFrames << endl;
+        cout << "stall frames " << stats.stallFrames << " (" << 100.0 * stats.stallFrames / frames
+             << "%), worst missing cells " << worstMissing << endl;
+        if (trackMemory) {
+            cout << "gpu memory peak " << double(memoryStats.peakBytes) / (1024.0 * 1024.0) << " MB (budget "
+                 << options.gpuBudgetMB << " MB), eviction requests " << memoryStats.evictionRequests << " ("
+                 << double(memoryStats.evictedBytes) / (1024.0 * 1024.0) << " MB), failed allocations "
+                 << memoryStats.failedAllocations << ", failed uploads " << stats.failedLoads << endl;
+            if (!options.memoryStatsPath.empty())
+                cout << "memory stats written to " << options.memoryStatsPath << endl;
+        }
+
+        if (backend.GetErrorCount() > 0) {
+            cerr << backend.GetErrorCount() << " backend error(s)." << endl;
+            return 2;
+        }
+        return 0;
+    }
+}
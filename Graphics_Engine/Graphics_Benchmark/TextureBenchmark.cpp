@@ -0,0 +1,110 @@
+#include "BenchmarkOptions.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+#include "TexturePipeline.h"
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        // 부드러운 그라디언트, 가는 선, 체크 무늬, 반투명 원이 섞인 이미지 (밉/블록 압축이 어려워하는 것들)
+        vector<uint8_t> MakeTestImage(uint32_t width, uint32_t height)
+        {
+            vector<uint8_t> rgba(size_t(width) * height * 4);
+            for (uint32_t y = 0; y < height; y++) {
+                for (uint32_t x = 0; x < width; x++) {
+                    const float u = float(x) / width, v = float(y) / height;
+                    uint8_t *p = &rgba[(size_t(y) * width + x) * 4];
+                    float r = u, g = v, b = 0.5f + 0.5f * sin(12.0f * (u + v));
+                    if (((x / 8) + (y / 8)) % 2 == 0 && u > 0.5f)
+                        r = g = b = 0.9f;
+                    if (x % 64 == 0 || y % 64 == 0)
+                        r = g = b = 0.05f;
+                    const float dx = u - 0.3f, dy = v - 0.35f;
+                    const float circle = dx * dx + dy * dy < 0.04f ? 1.0f : 0.0f;
+                    p[0] = uint8_t(255.0f * (circle > 0.0f ? 1.0f : r));
+                    p[1] = uint8_t(255.0f * (circle > 0.0f ? 0.3f : g));
+                    p[2] = uint8_t(255.0f * (circle > 0.0f ? 0.1f : b));
+                    p[3] = uint8_t(255.0f * (circle > 0.0f ? 0.5f : 0.25f + 0.75f * u));
+                }
+            }
+            return rgba;
+        }
+    }
+
+    int RunTextureBenchmark(const BenchmarkOptions &options, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+
+        error_code error;
+        filesystem::create_directories(options.textureDirectory, error);
+        if (error) {
+            cerr << "Cannot create " << options.textureDirectory << ": " << error.message() << endl;
+            return 2;
+        }
+
+        const uint32_t width = options.width, height = options.height;
+        const vector<uint8_t> image = MakeTestImage(width, height);
+        cout << "texture " << width << "x" << height << ", threads " << jobSystem.GetThreadCount() + 1 << endl;
+
+        // 밉 체인만 (가장 빠른 3번)
+        for (MipFilter filter : {MipFilter::Box, MipFilter::Kaiser}) {
+            vector<vector<uint8_t>> levels;
+            double bestMs = 1e30;
+            for (int run = 0; run < 3; run++) {
+                const auto start = Clock::now();
+                GenerateMipChain(width, height, image.data(), filter, true, 0, levels, jobSystem);
+                bestMs = min(bestMs, chrono::duration<double, milli>(Clock::now() - start).count());
+            }
+            cout << "mips " << GetMipFilterName(filter) << ": " << levels.size() << " levels, " << bestMs << " ms ("
+                 << double(width) * height / (bestMs * 1000.0) << " MPixels/s)" << endl;
+        }
+
+        int result = 0;
+        for (TextureFormat format : {TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC7}) {
+            TextureImportSettings settings;
+            settings.format = format;
+            TextureAsset asset;
+            TextureImportStats stats;
+            ImportTexture(width, height, image.data(), settings, asset, jobSystem, &stats);
+
+            // BC1은 알파를 저장하지 않으므로 RGB만 비교
+            vector<uint8_t> decoded;
+            DecompressTexture(format, width, height, asset.mips[0].data.data(), decoded);
+            const bool alpha = format != TextureFormat::BC1;
+            const double psnr = ComputePsnr(width, height, image.data(), decoded.data(), alpha);
+
+            const filesystem::path path =
+                filesystem::path(options.textureDirectory) / (string("test_") + GetTextureFormatName(format) + ".ltex");
+            if (!WriteTextureFile(path, asset)) {
+                result = 2;
+                continue;
+            }
+            // 매핑한 밉이 메모리의 결과와 같은지 확인
+            MappedTextureFile file;
+            bool verified = file.Open(path) && file.GetMipCount() == asset.mips.size();
+            for (uint32_t mip = 0; verified && mip < file.GetMipCount(); mip++)
+                verified = file.GetMip(mip).size == asset.mips[mip].data.size() &&
+                           memcmp(file.GetMipData(mip), asset.mips[mip].data.data(), asset.mips[mip].data.size()) == 0;
+            if (!verified) {
+                cerr << "Mapped file does not match: " << path.string() << endl;
+                result = 2;
+            }
+
+            cout << GetTextureFormatName(format) << ": encode " << stats.encodeMs << " ms ("
+                 << double(stats.encodedPixels) / (stats.encodeMs * 1000.0) << " MPixels/s, " << asset.mips.size()
+                 << " mips), PSNR " << psnr << " dB (" << (alpha ? "rgba" : "rgb") << "), file "
+                 << double(file.GetFileSize()) / 1024.0 << " KB" << endl;
+        }
+        return result;
+    }
+}
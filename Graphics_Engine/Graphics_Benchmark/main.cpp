@@ -0,0 +1,435 @@
+// Graphics_Benchmark.cpp : 창 없이 HeadlessBackend로 장면을 돌려서 CPU 비용을 재는 벤치마크
+//
+// 사용 예:
+//   Graphics_Benchmark --out result.json
+//   Graphics_Benchmark --objects 1000,100000 --paths orbit --baseline baseline.json --tolerance 0.1
+// 기준값보다 tolerance 넘게 나빠진 지표가 있으면 종료 코드 1을 반환합니다.
+// --trace를 주면 마지막 프레임들의 CPU/GPU 타임라인을 Chrome trace JSON으로 저장합니다.
+// --views 1,2,4,8: 뷰 수마다 공유 컬링(한 번 컬링 + 변환 공유)과 뷰별 독립 렌더링을 모두 돌려서
+//                  뷰 하나를 더할 때의 비용을 비교합니다.
+//
+// 오프스크린 모드: 장면마다 이미지를 소프트웨어 래스터라이저로 그려서 파일로 저장하고 초당 이미지 수를 출력
+//   Graphics_Benchmark --offscreen images --objects 1000 --images 32 --size 640x360 --format png
+// 인코딩은 ImageWriter 스레드들이 병렬로 하고, 큐가 가득 차서 렌더링이 기다린 시간(역압)도 출력합니다.
+//
+// 크기 변경 모드: 창을 끄는 것처럼 렌더 타겟 크기를 프레임마다 바꾸면서 다시 만드는 방식별 비용을 비교
+//   Graphics_Benchmark --resize 240 --size 1600x900
+//
+// 스트리밍 모드: 셀로 나눈 월드를 정해진 경로로 날아가면서 WorldStreamer로 셀을 읽고 내림
+//   Graphics_Benchmark --stream 1200 --budget 64 --io-latency 2
+// 셀 읽기가 실제 시간에 끝나도록 프레임은 60 FPS로 맞춰서 돌립니다. (1200 프레임 = 20초)
+// 올라와 있는 메모리(평균/최대)와 카메라 주변 셀이 비어 있던 프레임(스톨)을 출력합니다.
+// --gpu-budget을 주면 헤드리스 백엔드의 버퍼를 GpuMemoryTracker로 기록하고 그 크기를 hard 예산으로 걸어서,
+// 넘칠 때 WorldStreamer::Evict()를 부르는 퇴출 콜백으로 셀을 내립니다. --memory-stats는 1초마다 통계 파일을 씀
+//   Graphics_Benchmark --stream 1200 --budget 64 --gpu-budget 24 --memory-stats gpu_memory.prom
+//
+// 텍스처 모드: --size 크기의 합성 이미지로 밉 체인(box/Kaiser)을 만들고 BC1/BC3/BC7로 압축해서
+// 압축 속도(MPixels/s)와 첫 밉의 PSNR을 출력하고, .ltex 파일로 저장한 뒤 매핑해서 다시 확인합니다.
+//   Graphics_Benchmark --texture textures --size 2048x2048
+//
+// 애니메이션 모드: 걷기/뛰기 클립을 섞는 스키닝 캐릭터 수를 늘려 가며 한 프레임(포즈 + 스키닝 + 동적 버퍼
+// 업로드 + 그리기)이 예산 안에 들어오는 최대 캐릭터 수를 찾습니다.
+//   Graphics_Benchmark --animation 4 --frames 60
+//
+// 파티클 모드: 연기/불꽃/파편 이미터에 나눈 N개의 파티클을 정상 상태까지 돌린 뒤 프레임마다 시뮬레이션하고
+// Map한 인스턴스 버퍼에 써서 이미터마다 인스턴스 드로우 한 번으로 그립니다. 밀리초당 파티클 수를 출력합니다.
+//   Graphics_Benchmark --particles 300000 --frames 240
+//
+// 조명 모드: 점광원/스포트라이트 N개를 흩어 놓고 카메라를 돌리면서 매 프레임 클러스터(16x9x24)에 분류하고
+// 빛/클러스터/빛 번호 버퍼를 올립니다. 분류 시간(평균/p99)과 클러스터당 빛 수를 출력하고,
+// 마지막에 --size 크기로 한 장을 소프트웨어 래스터라이저의 클러스터 조명 경로로 그립니다.
+//   Graphics_Benchmark --lights 1000,10000 --frames 240
+//
+// 라이트맵 모드: 월드 셀 네 개와 빛들로 된 정적 장면의 라이트맵을 CPU 경로 추적으로 점진적으로 굽고,
+// 패스마다 코어당 초당 광선 수를 출력한 뒤 BC7 .ltex와 PNG로 저장합니다. (--size가 아틀라스 크기)
+//   Graphics_Benchmark --lightmap lightmaps --size 1024x1024 --samples 64
+//
+// 정적 배칭 모드: 움직이지 않는 메쉬 N개를 메쉬마다 버퍼를 따로 두고 그릴 때와 StaticBatcher로 (셀, 재질)마다
+// 공유 버퍼에 합쳐서 그릴 때의 버퍼 수, 프레임당 바인딩 수, 제출 CPU 시간을 비교합니다.
+// 절반을 지운 뒤 Compact()로 빈틈을 없애는 결과와, 두 방식으로 그린 이미지가 같은지도 출력합니다.
+//   Graphics_Benchmark --batching 100000 --frames 120
+//
+// 스프라이트 모드: 움직이는 2D 마커와 글자 라벨을 SpriteBatcher로 모아서 (층, 텍스처) 기수 정렬 후 스트림 버퍼 하나에
+// 쓰고 텍스처마다 인스턴스 드로우 한 번으로 그립니다. 주어진 FPS의 한 프레임에 들어가는 최대 스프라이트 수를 찾고,
+// 같은 수를 스프라이트마다 상수 버퍼 + 드로우로 그릴 때의 드로우/Map 수와 비교합니다.
+//   Graphics_Benchmark --sprites 60 --size 1920x1080
+//
+// 명령 캡처/재생: 장면의 한 프레임을 명령 스트림(.lcap)으로 저장하고, 저장한 프레임을 헤드리스 백엔드에서
+// 반복 재생하며 명령마다 시간을 잽니다. 창 모드에서 저장한 캡처도 같은 방법으로 재생할 수 있습니다.
+//   Graphics_Benchmark --capture frame.lcap --objects 100000 --paths orbit
+//   Graphics_Benchmark --replay frame.lcap --frames 500
+//
+// 여기서는 옵션만 읽고 모드를 고릅니다. 모드마다 코드는 이 디렉토리의 XxxBenchmark.cpp에 있습니다. (BenchmarkOptions.h)
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "BenchmarkOptions.h"
+#include "JobSystem.h"
+
+using namespace std;
+using namespace luke;
+
+#pragma region 할당 횟수 측정
+// 프로세스 전체의 operator new를 바꿔서 할당 횟수/바이트를 셉니다.
+namespace {
+    atomic<uint64_t> g_allocationCount{0};
+    atomic<uint64_t> g_allocatedBytes{0};
+
+    AllocationSnapshot GetProcessAllocations()
+    {
+        return {g_allocationCount.load(), g_allocatedBytes.load()};
+    }
+
+    void *CountedAllocate(size_t size)
+    {
+        g_allocationCount.fetch_add(1, memory_order_relaxed);
+        g_allocatedBytes.fetch_add(size, memory_order_relaxed);
+        if (void *p = malloc(size ? size : 1))
+            return p;
+        throw bad_alloc();
+    }
+
+    void *CountedAllocateAligned(size_t size, align_val_t alignment)
+    {
+        g_allocationCount.fetch_add(1, memory_order_relaxed);
+        g_allocatedBytes.fetch_add(size, memory_order_relaxed);
+#ifdef _WIN32
+        if (void *p = _aligned_malloc(size ? size : 1, size_t(alignment)))
+            return p;
+#else
+        const size_t align = size_t(alignment);
+        if (void *p = aligned_alloc(align, (max<size_t>(size, 1) + align - 1) / align * align))
+            return p;
+#endif
+        throw bad_alloc();
+    }
+
+    void FreeAligned(void *p)
+    {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+}
+
+void *operator new(size_t size) { return CountedAllocate(size); }
+void *operator new[](size_t size) { return CountedAllocate(size); }
+void *operator new(size_t size, align_val_t alignment) { return CountedAllocateAligned(size, alignment); }
+void *operator new[](size_t size, align_val_t alignment)
+{
+    return CountedAllocateAligned(size, alignment);
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+void operator delete(void *p, align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void *p, align_val_t) noexcept { FreeAligned(p); }
+void operator delete(void *p, size_t, align_val_t) noexcept { FreeAligned(p); }
+void operator delete[](void *p, size_t, align_val_t) noexcept { FreeAligned(p); }
+#pragma endregion
+
+namespace {
+    void PrintUsage()
+    {
+        cout << "Graphics_Benchmark [options]\n"
+                "  --objects N[,N...]   object counts (default 1,1000,100000,1000000)\n"
+                "  --paths P[,P...]     static, orbit, flythrough (default all)\n"
+                "  --mesh M             triangle, square, cube, mixed (default mixed)\n"
+                "  --frames N           measured frames per scene (default 240)\n"
+                "  --warmup N           warm-up frames per scene (default 10)\n"
+                "  --no-frustum         disable frustum culling\n"
+                "  --occlusion          add occluder walls and enable occlusion culling\n"
+                "  --threads N          job system worker threads (default hardware - 1)\n"
+                "  --out FILE           write JSON results to FILE (default stdout)\n"
+                "  --baseline FILE      compare against a previous JSON result\n"
+                "  --tolerance X        allowed relative regression (default 0.10)\n"
+                "  --trace FILE         write a CPU/GPU timeline of the last frames (Chrome trace JSON)\n"
+                "  --views N[,N...]     cameras per frame, 1-8 (default 1); N > 1 runs shared and independent\n"
+                "offscreen mode:\n"
+                "  --offscreen DIR      render images into DIR and report images per second\n"
+                "  --images N           images per scene (default 16)\n"
+                "  --size WxH           image size (default 640x360)\n"
+                "  --format F           png, qoi, raw (default png)\n"
+                "  --latency N          render targets in flight before readback (default 3)\n"
+                "  --writers N          image encoder threads (default hardware / 2)\n"
+                "  --queue N            images queued for the encoders (default 8)\n"
+                "  --drop               drop images when the queue is full instead of waiting\n"
+                "resize mode:\n"
+                "  --resize N           resize the render target every frame for N frames (uses --size)\n"
+                "streaming mode:\n"
+                "  --stream N           fly through a streamed 32x32-cell world for N frames\n"
+                "  --budget MB          resident memory budget (default 64)\n"
+                "  --io-latency MS      simulated read time per cell (default 2)\n"
+                "  --cell-cubes N       cubes per cell (default 1000, max 2700)\n"
+                "  --gpu-budget MB      hard GPU memory budget; evicts cells through the tracker callback\n"
+                "  --memory-stats FILE  write GPU memory counters (Prometheus text format) every second\n"
+                "texture mode:\n"
+                "  --texture DIR        build mips, encode BC1/BC3/BC7 and write .ltex files into DIR (uses --size)\n"
+                "animation mode:\n"
+                "  --animation MS       find how many skinned characters fit in MS per frame (uses --frames, --warmup)\n"
+                "particle mode:\n"
+                "  --particles N        simulate and draw N particles in smoke/spark/debris emitters (uses --frames)\n"
+                "lighting mode:\n"
+                "  --lights N[,N...]    bin N point/spot lights into clusters every frame (uses --frames, --size)\n"
+                "lightmap mode:\n"
+                "  --lightmap DIR       path-trace a lightmap of a test scene into DIR (uses --size as the atlas size)\n"
+                "  --samples N          samples per texel (default 64)\n"
+                "static batching mode:\n"
+                "  --batching N         compare N per-mesh buffers with shared static batches (uses --frames, --size)\n"
+                "sprite mode:\n"
+                "  --sprites FPS        find how many batched sprites and glyphs fit in a frame at FPS (uses --frames, --warmup, --size)\n"
+                "command capture:\n"
+                "  --capture FILE       record one frame of the first --objects/--paths/--views scene after warm-up\n"
+                "  --replay FILE        replay a captured frame --frames times and report per-command timing\n";
+    }
+
+    vector<string> Split(const string &text)
+    {
+        vector<string> items;
+        stringstream stream(text);
+        string item;
+        while (getline(stream, item, ','))
+            if (!item.empty())
+                items.push_back(item);
+        return items;
+    }
+
+    bool ParsePath(const string &name, CameraPath &path)
+    {
+        for (CameraPath candidate : {CameraPath::Static, CameraPath::Orbit, CameraPath::FlyThrough}) {
+            if (name == GetCameraPathName(candidate)) {
+                path = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ParseMesh(const string &name, BenchmarkMesh &mesh)
+    {
+        for (BenchmarkMesh candidate : {BenchmarkMesh::Triangle, BenchmarkMesh::Square,
+                                        BenchmarkMesh::Cube, BenchmarkMesh::Mixed}) {
+            if (name == GetBenchmarkMeshName(candidate)) {
+                mesh = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ParseImageFormat(const string &name, ImageFormat &format)
+    {
+        for (ImageFormat candidate : {ImageFormat::Png, ImageFormat::Qoi, ImageFormat::Raw}) {
+            if (name == GetImageFormatName(candidate)) {
+                format = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool ParseOptions(int argc, char *argv[], BenchmarkOptions &options)
+    {
+        for (int i = 1; i < argc; i++) {
+            const string arg = argv[i];
+            auto next = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+
+            if (arg == "--help" || arg == "-h") {
+                return false;
+            }
+            else if (arg == "--no-frustum") {
+                options.frustumCulling = false;
+            }
+            else if (arg == "--occlusion") {
+                options.occlusionCulling = true;
+            }
+            else if (arg == "--drop") {
+                options.queuePolicy = QueueFullPolicy::Drop;
+            }
+            else if (const char *value = next()) {
+                if (arg == "--objects") {
+                    options.objectCountsSet = true;
+                    options.objectCounts.clear();
+                    for (const string &item : Split(value))
+                        options.objectCounts.push_back(uint32_t(stoul(item)));
+                }
+                else if (arg == "--views") {
+                    options.viewCounts.clear();
+                    for (const string &item : Split(value))
+                        options.viewCounts.push_back(clamp(uint32_t(stoul(item)), 1u, kMaxViews));
+                }
+                else if (arg == "--paths") {
+                    options.paths.clear();
+                    for (const string &item : Split(value)) {
+                        CameraPath path;
+                        if (!ParsePath(item, path)) {
+                            cout << "Unknown camera path: " << item << endl;
+                            return false;
+                        }
+                        options.paths.push_back(path);
+                    }
+                }
+                else if (arg == "--mesh") {
+                    if (!ParseMesh(value, options.mesh)) {
+                        cout << "Unknown mesh: " << value << endl;
+                        return false;
+                    }
+                }
+                else if (arg == "--frames")
+                    options.frames = uint32_t(stoul(value));
+                else if (arg == "--warmup")
+                    options.warmupFrames = uint32_t(stoul(value));
+                else if (arg == "--threads")
+                    options.threads = unsigned(stoul(value));
+                else if (arg == "--out")
+                    options.outPath = value;
+                else if (arg == "--baseline")
+                    options.baselinePath = value;
+                else if (arg == "--tolerance")
+                    options.tolerance = stod(value);
+                else if (arg == "--trace")
+                    options.tracePath = value;
+                else if (arg == "--offscreen")
+                    options.offscreenDirectory = value;
+                else if (arg == "--images")
+                    options.images = max(1u, uint32_t(stoul(value)));
+                else if (arg == "--size") {
+                    const string size = value;
+                    const size_t x = size.find('x');
+                    if (x == string::npos) {
+                        cout << "Invalid size: " << size << endl;
+                        return false;
+                    }
+                    options.width = uint32_t(stoul(size.substr(0, x)));
+                    options.height = uint32_t(stoul(size.substr(x + 1)));
+                    if (options.width == 0 || options.height == 0) {
+                        cout << "Invalid size: " << size << endl;
+                        return false;
+                    }
+                }
+                else if (arg == "--format") {
+                    if (!ParseImageFormat(value, options.format)) {
+                        cout << "Unknown image format: " << value << endl;
+                        return false;
+                    }
+                }
+                else if (arg == "--resize")
+                    options.resizeFrames = uint32_t(stoul(value));
+                else if (arg == "--stream")
+                    options.streamFrames = uint32_t(stoul(value));
+                else if (arg == "--budget")
+                    options.streamBudgetMB = uint32_t(stoul(value));
+                else if (arg == "--io-latency")
+                    options.ioLatencyMs = stof(value);
+                else if (arg == "--cell-cubes")
+                    options.cellCubes = uint32_t(stoul(value));
+                else if (arg == "--gpu-budget")
+                    options.gpuBudgetMB = uint32_t(stoul(value));
+                else if (arg == "--memory-stats")
+                    options.memoryStatsPath = value;
+                else if (arg == "--texture")
+                    options.textureDirectory = value;
+                else if (arg == "--animation")
+                    options.animationBudgetMs = stof(value);
+                else if (arg == "--particles")
+                    options.particleCount = uint32_t(stoul(value));
+                else if (arg == "--lights") {
+                    options.lightCounts.clear();
+                    for (const string &item : Split(value))
+                        options.lightCounts.push_back(uint32_t(stoul(item)));
+                }
+                else if (arg == "--lightmap")
+                    options.lightmapDirectory = value;
+                else if (arg == "--samples")
+                    options.lightmapSamples = max(1u, uint32_t(stoul(value)));
+                else if (arg == "--batching")
+                    options.batchMeshes = uint32_t(stoul(value));
+                else if (arg == "--sprites")
+                    options.spriteFps = uint32_t(stoul(value));
+                else if (arg == "--capture")
+                    options.capturePath = value;
+                else if (arg == "--replay")
+                    options.replayPath = value;
+                else if (arg == "--latency")
+                    options.latency = uint32_t(stoul(value));
+                else if (arg == "--writers")
+                    options.writers = unsigned(stoul(value));
+                else if (arg == "--queue")
+                    options.queueCapacity = max(1u, uint32_t(stoul(value)));
+                else {
+                    cout << "Unknown option: " << arg << endl;
+                    return false;
+                }
+            }
+            else {
+                cout << "Missing value for " << arg << endl;
+                return false;
+            }
+        }
+        return !options.objectCounts.empty() && !options.paths.empty();
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    BenchmarkOptions options;
+    try {
+        if (!ParseOptions(argc, argv, options)) {
+            PrintUsage();
+            return 2;
+        }
+    }
+    catch (const exception &) {
+        cout << "Invalid number in arguments." << endl;
+        PrintUsage();
+        return 2;
+    }
+
+    // 기준값을 먼저 읽어서 파일이 잘못됐으면 오래 돌리기 전에 실패
+    BenchmarkBaseline baseline;
+    if (!options.baselinePath.empty() && !LoadBenchmarkBaseline(options.baselinePath, baseline))
+        return 2;
+
+    if (options.resizeFrames > 0)
+        return RunResizeBenchmark(options, GetProcessAllocations);
+    if (!options.replayPath.empty())
+        return RunReplayBenchmark(options);
+
+    JobSystem jobSystem(options.threads);
+    if (options.streamFrames > 0)
+        return RunStreamingBenchmark(options, jobSystem);
+    if (!options.textureDirectory.empty())
+        return RunTextureBenchmark(options, jobSystem);
+    if (options.animationBudgetMs > 0.0f)
+        return RunAnimationBenchmark(options, jobSystem);
+    if (options.particleCount > 0)
+        return RunParticleBenchmark(options, jobSystem);
+    if (!options.lightCounts.empty())
+        return RunLightingBenchmark(options, jobSystem);
+    if (!options.lightmapDirectory.empty())
+        return RunLightmapBenchmark(options, jobSystem);
+    if (options.batchMeshes > 0)
+        return RunBatchingBenchmark(options);
+    if (options.spriteFps > 0)
+        return RunSpriteBenchmark(options, jobSystem);
+    if (!options.capturePath.empty())
+        return RunCaptureBenchmark(options, jobSystem);
+    if (!options.offscreenDirectory.empty()) {
+        // 소프트웨어 래스터화는 물체가 많으면 느리므로 기본 개수를 줄임
+        if (!options.objectCountsSet)
+            options.objectCounts = {1, 1000, 10000};
+        return RunOffscreenBenchmark(options, jobSystem);
+    }
+
+    return RunSceneBenchmarks(options, baseline, jobSystem, GetProcessAllocations);
+}
@@ -0,0 +1,578 @@
+#include "Animation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace luke {
+
+    using namespace std;
+    using namespace DirectX;
+
+    namespace {
+        constexpr float kRotationScale = 32767.0f;
+
+        // SoaTransform 하나의 키 안에서 성분별 위치 (관절 4개씩)
+        constexpr uint32_t kRotationKeys = 0;
+        constexpr uint32_t kTranslationKeys = 16;
+        constexpr uint32_t kScaleKeys = 28;
+
+        uint16_t QuantizeSigned(float value)
+        {
+            return uint16_t(int16_t(lroundf(clamp(value, -1.0f, 1.0f) * kRotationScale)));
+        }
+
+        float DequantizeSigned(uint16_t key) { return float(int16_t(key)) / kRotationScale; }
+
+        uint16_t QuantizeRange(float value, float minimum, float step)
+        {
+            if (step <= 0.0f)
+                return 0;
+            return uint16_t(clamp(lroundf((value - minimum) / step), 0l, 65535l));
+        }
+
+        void GetRange(float minimum, float maximum, float &outMin, float &outStep)
+        {
+            outMin = minimum;
+            outStep = maximum > minimum ? (maximum - minimum) / 65535.0f : 0.0f;
+        }
+
+        XMVECTOR LoadSigned(const uint16_t *keys)
+        {
+            return XMVectorScale(XMVectorSet(float(int16_t(keys[0])), float(int16_t(keys[1])),
+                                             float(int16_t(keys[2])), float(int16_t(keys[3]))),
+                                 1.0f / kRotationScale);
+        }
+
+        XMVECTOR LoadRange(const uint16_t *keys, XMVECTOR minimum, XMVECTOR step)
+        {
+            return XMVectorMultiplyAdd(
+                XMVectorSet(float(keys[0]), float(keys[1]), float(keys[2]), float(keys[3])), step, minimum);
+        }
+
+        void DecodeGroup(const AnimationClip &clip, const uint16_t *keys, SoaTransform &out)
+        {
+            for (uint32_t c = 0; c < 4; c++)
+                out.rotation[c] = LoadSigned(keys + kRotationKeys + c * 4);
+
+            const float minimum[3] = {clip.translationMin.x, clip.translationMin.y, clip.translationMin.z};
+            const float step[3] = {clip.translationStep.x, clip.translationStep.y, clip.translationStep.z};
+            for (uint32_t c = 0; c < 3; c++)
+                out.translation[c] = LoadRange(keys + kTranslationKeys + c * 4, XMVectorReplicate(minimum[c]),
+                                               XMVectorReplicate(step[c]));
+            out.scale = LoadRange(keys + kScaleKeys, XMVectorReplicate(clip.scaleMin),
+                                  XMVectorReplicate(clip.scaleStep));
+        }
+
+        // 관절 4개의 nlerp. b를 a와 같은 반구로 뒤집는 것까지 레인마다 분기 없이 처리
+        void NlerpSoa(const XMVECTOR a[4], const XMVECTOR b[4], XMVECTOR t, XMVECTOR out[4])
+        {
+            XMVECTOR dot = XMVectorMultiply(a[0], b[0]);
+            for (uint32_t c = 1; c < 4; c++)
+                dot = XMVectorMultiplyAdd(a[c], b[c], dot);
+            const XMVECTOR sign =
+                XMVectorSelect(XMVectorSplatOne(), XMVectorReplicate(-1.0f), XMVectorLess(dot, XMVectorZero()));
+
+            XMVECTOR result[4];
+            XMVECTOR lengthSq = XMVectorZero();
+            for (uint32_t c = 0; c < 4; c++) {
+                result[c] = XMVectorMultiplyAdd(XMVectorSubtract(XMVectorMultiply(b[c], sign), a[c]), t, a[c]);
+                lengthSq = XMVectorMultiplyAdd(result[c], result[c], lengthSq);
+            }
+            const XMVECTOR inverseLength = XMVectorReciprocalSqrt(lengthSq);
+            for (uint32_t c = 0; c < 4; c++)
+                out[c] = XMVectorMultiply(result[c], inverseLength);
+        }
+
+        void InterpolateSoa(const SoaTransform &a, const SoaTransform &b, XMVECTOR t, SoaTransform &out)
+        {
+            NlerpSoa(a.rotation, b.rotation, t, out.rotation);
+            for (uint32_t c = 0; c < 3; c++)
+                out.translation[c] =
+                    XMVectorMultiplyAdd(XMVectorSubtract(b.translation[c], a.translation[c]), t, a.translation[c]);
+            out.scale = XMVectorMultiplyAdd(XMVectorSubtract(b.scale, a.scale), t, a.scale);
+        }
+
+        float Smoothstep(float edge0, float edge1, float x)
+        {
+            const float t = clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+            return t * t * (3.0f - 2.0f * t);
+        }
+    }
+
+    void Pose::SetJoints(const JointTransform *joints, uint32_t jointCount)
+    {
+        Resize(jointCount);
+        for (uint32_t g = 0; g < groups.size(); g++) {
+            JointTransform lanes[4];
+            for (uint32_t l = 0; l < 4 && g * 4 + l < jointCount; l++)
+                lanes[l] = joints[g * 4 + l];
+
+            SoaTransform &group = groups[g];
+            group.rotation[0] = XMVectorSet(lanes[0].rotation.x, lanes[1].rotation.x, lanes[2].rotation.x,
+                                            lanes[3].rotation.x);
+            group.rotation[1] = XMVectorSet(lanes[0].rotation.y, lanes[1].rotation.y, lanes[2].rotation.y,
+                                            lanes[3].rotation.y);
+            group.rotation[2] = XMVectorSet(lanes[0].rotation.z, lanes[1].rotation.z, lanes[2].rotation.z,
+                                            lanes[3].rotation.z);
+            group.rotation[3] = XMVectorSet(lanes[0].rotation.w, lanes[1].rotation.w, lanes[2].rotation.w,
+                                            lanes[3].rotation.w);
+            group.translation[0] = XMVectorSet(lanes[0].translation.x, lanes[1].translation.x,
+                                               lanes[2].translation.x, lanes[3].translation.x);
+            group.translation[1] = XMVectorSet(lanes[0].translation.y, lanes[1].translation.y,
+                                               lanes[2].translation.y, lanes[3].translation.y);
+            group.translation[2] = XMVectorSet(lanes[0].translation.z, lanes[1].translation.z,
+                                               lanes[2].translation.z, lanes[3].translation.z);
+            group.scale = XMVectorSet(lanes[0].scale, lanes[1].scale, lanes[2].scale, lanes[3].scale);
+        }
+    }
+
+    JointTransform Pose::GetJoint(uint32_t joint) const
+    {
+        const SoaTransform &group = groups[joint / 4];
+        const uint32_t lane = joint % 4;
+        auto get = [lane](XMVECTOR v) {
+            XMFLOAT4A lanes;
+            XMStoreFloat4A(&lanes, v);
+            return (&lanes.x)[lane];
+        };
+
+        JointTransform result;
+        result.rotation = Quaternion(get(group.rotation[0]), get(group.rotation[1]), get(group.rotation[2]),
+                                     get(group.rotation[3]));
+        result.translation = Vector3(get(group.translation[0]), get(group.translation[1]), get(group.translation[2]));
+        result.scale = get(group.scale);
+        return result;
+    }
+
+#pragma region 압축 클립
+    void CompressClip(const JointTransform *frames, uint32_t frameCount, uint32_t jointCount, float sampleRate,
+                      AnimationClip &clip, ClipCompressionStats *stats)
+    {
+        clip = AnimationClip();
+        clip.jointCount = jointCount;
+        clip.frameCount = frameCount;
+        clip.sampleRate = sampleRate;
+        const uint32_t groupCount = (jointCount + 3) / 4;
+        const size_t keyCount = size_t(frameCount) * jointCount;
+        if (keyCount == 0)
+            return;
+
+        Vector3 translationMin = frames[0].translation;
+        Vector3 translationMax = frames[0].translation;
+        float scaleMin = frames[0].scale;
+        float scaleMax = frames[0].scale;
+        for (size_t i = 0; i < keyCount; i++) {
+            const Vector3 &t = frames[i].translation;
+            translationMin = Vector3(min(translationMin.x, t.x), min(translationMin.y, t.y), min(translationMin.z, t.z));
+            translationMax = Vector3(max(translationMax.x, t.x), max(translationMax.y, t.y), max(translationMax.z, t.z));
+            scaleMin = min(scaleMin, frames[i].scale);
+            scaleMax = max(scaleMax, frames[i].scale);
+        }
+        GetRange(translationMin.x, translationMax.x, clip.translationMin.x, clip.translationStep.x);
+        GetRange(translationMin.y, translationMax.y, clip.translationMin.y, clip.translationStep.y);
+        GetRange(translationMin.z, translationMax.z, clip.translationMin.z, clip.translationStep.z);
+        GetRange(scaleMin, scaleMax, clip.scaleMin, clip.scaleStep);
+
+        // 이웃한 키끼리 같은 반구에 있어야 nlerp가 최단 경로로 보간함
+        vector<Quaternion> rotations(keyCount);
+        for (uint32_t joint = 0; joint < jointCount; joint++) {
+            for (uint32_t frame = 0; frame < frameCount; frame++) {
+                Quaternion q = frames[size_t(frame) * jointCount + joint].rotation;
+                q.Normalize();
+                if (frame > 0) {
+                    const Quaternion &previous = rotations[size_t(frame - 1) * jointCount + joint];
+                    if (q.x * previous.x + q.y * previous.y + q.z * previous.z + q.w * previous.w < 0.0f)
+                        q = Quaternion(-q.x, -q.y, -q.z, -q.w);
+                }
+                rotations[size_t(frame) * jointCount + joint] = q;
+            }
+        }
+
+        float maxRotationError = 0.0f;
+        float maxTranslationError = 0.0f;
+        clip.keys.assign(size_t(frameCount) * groupCount * AnimationClip::kKeysPerGroup, 0);
+        for (uint32_t frame = 0; frame < frameCount; frame++) {
+            for (uint32_t g = 0; g < groupCount; g++) {
+                uint16_t *keys =
+                    clip.keys.data() + (size_t(frame) * groupCount + g) * AnimationClip::kKeysPerGroup;
+                for (uint32_t lane = 0; lane < 4; lane++) {
+                    const uint32_t joint = g * 4 + lane;
+                    if (joint >= jointCount) {
+                        keys[kRotationKeys + 12 + lane] = QuantizeSigned(1.0f); // 남는 레인은 단위 회전
+                        continue;
+                    }
+                    const size_t index = size_t(frame) * jointCount + joint;
+                    const Quaternion &q = rotations[index];
+                    const Vector3 &t = frames[index].translation;
+                    const float rotation[4] = {q.x, q.y, q.z, q.w};
+                    const float translation[3] = {t.x, t.y, t.z};
+                    const float minimum[3] = {clip.translationMin.x, clip.translationMin.y, clip.translationMin.z};
+                    const float step[3] = {clip.translationStep.x, clip.translationStep.y, clip.translationStep.z};
+
+                    for (uint32_t c = 0; c < 4; c++) {
+                        const uint16_t key = QuantizeSigned(rotation[c]);
+                        keys[kRotationKeys + c * 4 + lane] = key;
+                        maxRotationError = max(maxRotationError, fabsf(DequantizeSigned(key) - rotation[c]));
+                    }
+                    for (uint32_t c = 0; c < 3; c++) {
+                        const uint16_t key = QuantizeRange(translation[c], minimum[c], step[c]);
+                        keys[kTranslationKeys + c * 4 + lane] = key;
+                        maxTranslationError =
+                            max(maxTranslationError, fabsf(minimum[c] + key * step[c] - translation[c]));
+                    }
+                    keys[kScaleKeys + lane] = QuantizeRange(frames[index].scale, clip.scaleMin, clip.scaleStep);
+                }
+            }
+        }
+
+        if (stats) {
+            stats->rawBytes = keyCount * sizeof(JointTransform);
+            stats->compressedBytes = clip.GetSizeBytes();
+            stats->maxRotationError = maxRotationError;
+            stats->maxTranslationError = maxTranslationError;
+        }
+    }
+
+    void SampleClip(const AnimationClip &clip, float time, Pose &out)
+    {
+        const uint32_t groupCount = (clip.jointCount + 3) / 4;
+        out.groups.resize(groupCount);
+        if (clip.frameCount == 0)
+            return;
+
+        float frame = fmodf(time * clip.sampleRate, float(clip.frameCount));
+        if (frame < 0.0f)
+            frame += float(clip.frameCount);
+        const uint32_t frame0 = min(uint32_t(frame), clip.frameCount - 1);
+        const uint32_t frame1 = frame0 + 1 < clip.frameCount ? frame0 + 1 : 0;
+        const XMVECTOR t = XMVectorReplicate(frame - float(frame0));
+
+        const size_t frameKeys = size_t(groupCount) * AnimationClip::kKeysPerGroup;
+        const uint16_t *keys0 = clip.keys.data() + frame0 * frameKeys;
+        const uint16_t *keys1 = clip.keys.data() + frame1 * frameKeys;
+        for (uint32_t g = 0; g < groupCount; g++) {
+            SoaTransform a, b;
+            DecodeGroup(clip, keys0 + g * AnimationClip::kKeysPerGroup, a);
+            DecodeGroup(clip, keys1 + g * AnimationClip::kKeysPerGroup, b);
+            InterpolateSoa(a, b, t, out.groups[g]);
+        }
+    }
+#pragma endregion
+
+    void BlendPoses(const Pose &a, const Pose &b, float weight, Pose &out)
+    {
+        const size_t groupCount = min(a.groups.size(), b.groups.size());
+        out.groups.resize(groupCount);
+        const XMVECTOR t = XMVectorReplicate(weight);
+        for (size_t g = 0; g < groupCount; g++)
+            InterpolateSoa(a.groups[g], b.groups[g], t, out.groups[g]);
+    }
+
+    void ComputeSkinningMatrices(const Skeleton &skeleton, const Pose &pose, XMMATRIX *modelSpace,
+                                 XMMATRIX *skinning)
+    {
+        const uint32_t jointCount = skeleton.GetJointCount();
+        const XMVECTOR one = XMVectorSplatOne();
+        const XMVECTOR two = XMVectorReplicate(2.0f);
+
+        for (uint32_t g = 0; g < skeleton.GetGroupCount(); g++) {
+            const SoaTransform &transform = pose.groups[g];
+            const XMVECTOR x = transform.rotation[0];
+            const XMVECTOR y = transform.rotation[1];
+            const XMVECTOR z = transform.rotation[2];
+            const XMVECTOR w = transform.rotation[3];
+            const XMVECTOR xx = XMVectorMultiply(x, x), yy = XMVectorMultiply(y, y), zz = XMVectorMultiply(z, z);
+            const XMVECTOR xy = XMVectorMultiply(x, y), xz = XMVectorMultiply(x, z), yz = XMVectorMultiply(y, z);
+            const XMVECTOR wx = XMVectorMultiply(w, x), wy = XMVectorMultiply(w, y), wz = XMVectorMultiply(w, z);
+            const XMVECTOR s = transform.scale;
+            const XMVECTOR s2 = XMVectorMultiply(s, two);
+
+            // 관절 4개의 회전 x 스케일 행렬을 성분별로 계산 (XMMatrixRotationQuaternion과 같은 행 벡터 규약)
+            const XMVECTOR m00 = XMVectorMultiply(XMVectorNegativeMultiplySubtract(two, XMVectorAdd(yy, zz), one), s);
+            const XMVECTOR m01 = XMVectorMultiply(XMVectorAdd(xy, wz), s2);
+            const XMVECTOR m02 = XMVectorMultiply(XMVectorSubtract(xz, wy), s2);
+            const XMVECTOR m10 = XMVectorMultiply(XMVectorSubtract(xy, wz), s2);
+            const XMVECTOR m11 = XMVectorMultiply(XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, zz), one), s);
+            const XMVECTOR m12 = XMVectorMultiply(XMVectorAdd(yz, wx), s2);
+            const XMVECTOR m20 = XMVectorMultiply(XMVectorAdd(xz, wy), s2);
+            const XMVECTOR m21 = XMVectorMultiply(XMVectorSubtract(yz, wx), s2);
+            const XMVECTOR m22 = XMVectorMultiply(XMVectorNegativeMultiplySubtract(two, XMVectorAdd(xx, yy), one), s);
+
+            // 전치해서 관절별 행으로 바꿈: rows0.r[lane]이 관절 lane의 첫 행
+            const XMMATRIX rows0 = XMMatrixTranspose(XMMATRIX(m00, m01, m02, XMVectorZero()));
+            const XMMATRIX rows1 = XMMatrixTranspose(XMMATRIX(m10, m11, m12, XMVectorZero()));
+            const XMMATRIX rows2 = XMMatrixTranspose(XMMATRIX(m20, m21, m22, XMVectorZero()));
+            const XMMATRIX rows3 = XMMatrixTranspose(
+                XMMATRIX(transform.translation[0], transform.translation[1], transform.translation[2], one));
+
+            for (uint32_t lane = 0; lane < 4; lane++) {
+                const uint32_t joint = g * 4 + lane;
+                if (joint >= jointCount)
+                    break;
+                const XMMATRIX local(rows0.r[lane], rows1.r[lane], rows2.r[lane], rows3.r[lane]);
+                const int parent = skeleton.parents[joint];
+                modelSpace[joint] = parent < 0 ? local : XMMatrixMultiply(local, modelSpace[parent]);
+                skinning[joint] = XMMatrixMultiply(skeleton.inverseBind[joint], modelSpace[joint]);
+            }
+        }
+    }
+
+#pragma region 스키닝
+    void SkinVertices(const SkinnedVertex *vertices, size_t count, const XMMATRIX *skinning, Vertex *out)
+    {
+        constexpr float kWeightScale = 1.0f / 255.0f;
+
+        for (size_t i = 0; i < count; i++) {
+            const SkinnedVertex &vertex = vertices[i];
+
+            // 영향이 1~4개로 섞여 있으므로 가중치 0도 분기 없이 같이 더함 (joints는 0이라 유효한 행렬)
+            const XMMATRIX &m0 = skinning[vertex.joints[0]];
+            const XMVECTOR w0 = XMVectorReplicate(vertex.weights[0] * kWeightScale);
+            XMVECTOR r0 = XMVectorMultiply(m0.r[0], w0);
+            XMVECTOR r1 = XMVectorMultiply(m0.r[1], w0);
+            XMVECTOR r2 = XMVectorMultiply(m0.r[2], w0);
+            XMVECTOR r3 = XMVectorMultiply(m0.r[3], w0);
+            for (uint32_t k = 1; k < 4; k++) {
+                const XMMATRIX &m = skinning[vertex.joints[k]];
+                const XMVECTOR weight = XMVectorReplicate(vertex.weights[k] * kWeightScale);
+                r0 = XMVectorMultiplyAdd(m.r[0], weight, r0);
+                r1 = XMVectorMultiplyAdd(m.r[1], weight, r1);
+                r2 = XMVectorMultiplyAdd(m.r[2], weight, r2);
+                r3 = XMVectorMultiplyAdd(m.r[3], weight, r3);
+            }
+            const XMMATRIX blended(r0, r1, r2, r3);
+
+            const XMVECTOR position = XMVector3Transform(XMLoadFloat3(&vertex.position), blended);
+            const XMVECTOR normal = XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&vertex.normal), blended));
+            XMStoreFloat3(&out[i].position, position);
+            XMStoreFloat3(&out[i].normal, normal);
+        }
+    }
+
+    SkinnedMeshData MakeTestCharacter(uint32_t ringSegments, uint32_t ringsPerBone)
+    {
+        ringSegments = max(ringSegments, 3u);
+        ringsPerBone = max(ringsPerBone, 2u);
+
+        // radius는 부모 관절에서 이 관절까지 이어지는 원통의 반지름
+        struct JointDesc {
+            int16_t parent;
+            Vector3 offset;
+            float radius;
+        };
+        const JointDesc joints[] = {
+            {-1, {0.0f, 1.0f, 0.0f}, 0.0f},       // 0 골반
+            {0, {0.0f, 0.15f, 0.0f}, 0.11f},      // 1 척추
+            {1, {0.0f, 0.15f, 0.0f}, 0.12f},      // 2
+            {2, {0.0f, 0.15f, 0.0f}, 0.13f},      // 3 가슴
+            {3, {0.0f, 0.12f, 0.0f}, 0.05f},      // 4 목
+            {4, {0.0f, 0.18f, 0.0f}, 0.09f},      // 5 머리 끝
+            {0, {-0.1f, -0.05f, 0.0f}, 0.08f},    // 6 왼 엉덩이
+            {6, {0.0f, -0.42f, 0.0f}, 0.065f},    // 7 왼 무릎
+            {7, {0.0f, -0.42f, 0.0f}, 0.05f},     // 8 왼 발목
+            {0, {0.1f, -0.05f, 0.0f}, 0.08f},     // 9 오른 엉덩이
+            {9, {0.0f, -0.42f, 0.0f}, 0.065f},    // 10
+            {10, {0.0f, -0.42f, 0.0f}, 0.05f},    // 11
+            {3, {-0.2f, 0.05f, 0.0f}, 0.06f},     // 12 왼 어깨
+            {12, {0.0f, -0.28f, 0.0f}, 0.045f},   // 13 왼 팔꿈치
+            {13, {0.0f, -0.26f, 0.0f}, 0.04f},    // 14 왼 손목
+            {3, {0.2f, 0.05f, 0.0f}, 0.06f},      // 15 오른 어깨
+            {15, {0.0f, -0.28f, 0.0f}, 0.045f},   // 16
+            {16, {0.0f, -0.26f, 0.0f}, 0.04f},    // 17
+        };
+        const uint32_t jointCount = uint32_t(size(joints));
+
+        SkinnedMeshData character;
+        character.skeleton.parents.resize(jointCount);
+        character.skeleton.inverseBind.resize(jointCount);
+        character.bindPose.resize(jointCount);
+        vector<Vector3> bindPositions(jointCount); // 모델 공간
+        for (uint32_t j = 0; j < jointCount; j++) {
+            const int parent = joints[j].parent;
+            character.skeleton.parents[j] = joints[j].parent;
+            character.bindPose[j].translation = joints[j].offset;
+            bindPositions[j] = parent < 0 ? joints[j].offset : bindPositions[parent] + joints[j].offset;
+            character.skeleton.inverseBind[j] = Matrix::CreateTranslation(-bindPositions[j]);
+        }
+
+        // 뼈(부모 -> 관절)마다 원통. 원통은 부모 관절을 따라 움직이고 양 끝은 이웃 관절과 반씩 섞음
+        for (uint32_t child = 1; child < jointCount; child++) {
+            const uint32_t owner = uint32_t(joints[child].parent);
+            const int ownerParent = joints[owner].parent;
+            const Vector3 start = bindPositions[owner];
+            const Vector3 end = bindPositions[child];
+            Vector3 axis = end - start;
+            axis.Normalize();
+            Vector3 u = axis.Cross(fabsf(axis.y) < 0.9f ? Vector3(0.0f, 1.0f, 0.0f) : Vector3(1.0f, 0.0f, 0.0f));
+            u.Normalize();
+            const Vector3 v = axis.Cross(u);
+
+            const uint16_t base = uint16_t(character.vertices.size());
+            for (uint32_t ring = 0; ring < ringsPerBone; ring++) {
+                const float t = float(ring) / float(ringsPerBone - 1);
+                const Vector3 center = Vector3::Lerp(start, end, t);
+
+                float childWeight = 0.5f * Smoothstep(0.6f, 1.0f, t);
+                float parentWeight = ownerParent >= 0 ? 0.5f * (1.0f - Smoothstep(0.0f, 0.4f, t)) : 0.0f;
+                const uint8_t childKey = uint8_t(lroundf(childWeight * 255.0f));
+                const uint8_t parentKey = uint8_t(lroundf(parentWeight * 255.0f));
+
+                for (uint32_t segment = 0; segment < ringSegments; segment++) {
+                    const float angle = 6.2831853f * float(segment) / float(ringSegments);
+                    SkinnedVertex vertex = {};
+                    vertex.normal = u * cosf(angle) + v * sinf(angle);
+                    vertex.position = center + vertex.normal * joints[child].radius;
+                    vertex.joints[0] = uint8_t(owner);
+                    vertex.joints[1] = uint8_t(child);
+                    vertex.joints[2] = uint8_t(ownerParent >= 0 ? ownerParent : 0);
+                    vertex.weights[1] = childKey;
+                    vertex.weights[2] = parentKey;
+                    vertex.weights[0] = uint8_t(255 - childKey - parentKey);
+                    character.vertices.push_back(vertex);
+                }
+            }
+
+            // 이웃한 고리 사이의 사각형 (바깥에서 봤을 때 시계 방향)
+            for (uint32_t ring = 0; ring + 1 < ringsPerBone; ring++) {
+                for (uint32_t segment = 0; segment < ringSegments; segment++) {
+                    const uint16_t a = uint16_t(base + ring * ringSegments + segment);
+                    const uint16_t b = uint16_t(base + ring * ringSegments + (segment + 1) % ringSegments);
+                    const uint16_t c = uint16_t(a + ringSegments);
+                    const uint16_t d = uint16_t(b + ringSegments);
+                    character.indices.insert(character.indices.end(), {a, b, c, b, d, c});
+                }
+            }
+        }
+        return character;
+    }
+
+    vector<JointTransform> MakeTestLocomotion(const SkinnedMeshData &character, bool run, float sampleRate,
+                                              uint32_t &frameCount)
+    {
+        // 한 주기의 길이와 진폭 (라디안)
+        const float cycle = run ? 0.7f : 1.1f;
+        const float hip = run ? 0.8f : 0.45f;
+        const float knee = run ? 1.3f : 0.6f;
+        const float arm = run ? 0.7f : 0.35f;
+        const float elbow = run ? 1.2f : 0.3f;
+        const float bob = run ? 0.06f : 0.03f;
+        const float twist = run ? 0.15f : 0.08f;
+        const float lean = run ? 0.25f : 0.05f;
+
+        const uint32_t jointCount = character.skeleton.GetJointCount();
+        frameCount = max(2u, uint32_t(lroundf(cycle * sampleRate)));
+        vector<JointTransform> frames(size_t(frameCount) * jointCount);
+        for (uint32_t frame = 0; frame < frameCount; frame++) {
+            const float phase = 6.2831853f * float(frame) / float(frameCount);
+            const float swing = sinf(phase);
+            JointTransform *pose = frames.data() + size_t(frame) * jointCount;
+            for (uint32_t j = 0; j < jointCount; j++)
+                pose[j] = character.bindPose[j];
+
+            // (yaw, pitch, roll) = (Y, X, Z축 회전)
+            pose[0].translation.y += bob * cosf(2.0f * phase);
+            pose[1].rotation = Quaternion::CreateFromYawPitchRoll(0.5f * twist * swing, lean, 0.0f);
+            pose[3].rotation = Quaternion::CreateFromYawPitchRoll(-twist * swing, 0.0f, 0.0f);
+            pose[6].rotation = Quaternion::CreateFromYawPitchRoll(0.0f, -hip * swing, 0.0f);
+            pose[9].rotation = Quaternion::CreateFromYawPitchRoll(0.0f, hip * swing, 0.0f);
+            pose[7].rotation = Quaternion::CreateFromYawPitchRoll(0.0f, knee * max(0.0f, sinf(phase + 1.2f)), 0.0f);
+            pose[10].rotation = Quaternion::CreateFromYawPitchRoll(0.0f, knee * max(0.0f, -sinf(phase + 1.2f)), 0.0f);
+            pose[12].rotation = Quaternion::CreateFromYawPitchRoll(0.0f, arm * swing, 0.0f);
+            pose[15].rotation = Quaternion::CreateFromYawPitchRoll(0.0f, -arm * swing, 0.0f);
+            pose[13].rotation = Quaternion::CreateFromYawPitchRoll(0.0f, -elbow * (0.8f + 0.2f * swing), 0.0f);
+            pose[16].rotation = Quaternion::CreateFromYawPitchRoll(0.0f, -elbow * (0.8f - 0.2f * swing), 0.0f);
+        }
+        return frames;
+    }
+#pragma endregion
+
+    void CrowdAnimator::Initialize(const SkinnedMeshData &character, const AnimationClip &walk,
+                                   const AnimationClip &run)
+    {
+        m_character = &character;
+        m_walk = &walk;
+        m_run = &run;
+        SetCharacterCount(0);
+    }
+
+    void CrowdAnimator::SetCharacterCount(uint32_t count, uint32_t seed)
+    {
+        // xorshift (MeshGenerator::MakeWorldCell과 같은 방식)
+        uint32_t state = seed * 2654435761u + 1u;
+        auto random = [&]() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return float(state & 0xFFFFFF) / float(0x1000000);
+        };
+
+        m_characters.resize(count);
+        for (Character &character : m_characters) {
+            character.phase = random();
+            character.runWeight = random();
+        }
+        m_palettes.resize(size_t(count) * m_character->skeleton.GetJointCount());
+        // 색은 바뀌지 않으므로 여기서 한 번만 채움 (SkinVertices()는 위치와 법선만 씀)
+        const Vertex skin = {Vector3(), Vector3(0.8f, 0.65f, 0.55f), Vector3(0.0f, 1.0f, 0.0f)};
+        m_vertices.resize(size_t(count) * m_character->vertices.size(), skin);
+    }
+
+    void CrowdAnimator::Update(float dt, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+
+        const uint32_t count = GetCharacterCount();
+        const uint32_t jointCount = m_character->skeleton.GetJointCount();
+        const float walkDuration = m_walk->GetDuration();
+        const float runDuration = m_run->GetDuration();
+        const auto start = Clock::now();
+
+        // 포즈: 캐릭터마다 두 클립을 같은 위상에서 샘플해서 섞음
+        jobSystem.ParallelFor(count, 16, [&](size_t begin, size_t end) {
+            Pose walk, run;
+            walk.Resize(jointCount);
+            run.Resize(jointCount);
+            vector<XMMATRIX> modelSpace(jointCount);
+            for (size_t i = begin; i < end; i++) {
+                Character &character = m_characters[i];
+                const float cycle = walkDuration + (runDuration - walkDuration) * character.runWeight;
+                character.phase += dt / cycle;
+                character.phase -= floorf(character.phase);
+
+                // 한쪽 클립만 쓰면 샘플 하나와 블렌딩을 건너뜀
+                if (character.runWeight <= 0.0f) {
+                    SampleClip(*m_walk, character.phase * walkDuration, walk);
+                }
+                else if (character.runWeight >= 1.0f) {
+                    SampleClip(*m_run, character.phase * runDuration, walk);
+                }
+                else {
+                    SampleClip(*m_walk, character.phase * walkDuration, walk);
+                    SampleClip(*m_run, character.phase * runDuration, run);
+                    BlendPoses(walk, run, character.runWeight, walk);
+                }
+                ComputeSkinningMatrices(m_character->skeleton, walk, modelSpace.data(),
+                                        m_palettes.data() + i * jointCount);
+            }
+        });
+        const auto posed = Clock::now();
+
+        // 스키닝: 캐릭터가 적어도 모든 스레드가 일하도록 버텍스를 kSkinChunk개씩 나눔
+        const size_t vertexCount = m_character->vertices.size();
+        const size_t chunksPerCharacter = (vertexCount + kSkinChunk - 1) / kSkinChunk;
+        jobSystem.ParallelFor(count * chunksPerCharacter, 4, [&](size_t begin, size_t end) {
+            for (size_t job = begin; job < end; job++) {
+                const size_t character = job / chunksPerCharacter;
+                const size_t first = (job % chunksPerCharacter) * kSkinChunk;
+                const size_t chunk = min(size_t(kSkinChunk), vertexCount - first);
+                SkinVertices(m_character->vertices.data() + first, chunk, m_palettes.data() + character * jointCount,
+                             m_vertices.data() + character * vertexCount + first);
+            }
+        });
+
+        m_stats.poseMs = chrono::duration<double, milli>(posed - start).count();
+        m_stats.skinMs = chrono::duration<double, milli>(Clock::now() - posed).count();
+        m_stats.skinnedVertices = uint64_t(count) * vertexCount;
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <directxtk/SimpleMath.h>
+#include <vector>
+
+#include "JobSystem.h"
+#include "MeshGenerator.h"
+
+namespace luke {
+
+    using DirectX::SimpleMath::Matrix;
+    using DirectX::SimpleMath::Quaternion;
+    using DirectX::SimpleMath::Vector3;
+
+    // SkinnedVertex::joints가 8비트
+    constexpr uint32_t kMaxJoints = 256;
+
+    // 관절 하나의 로컬 변환 (부모 관절 기준). 스케일은 균일 스케일만 지원
+    struct JointTransform {
+        Quaternion rotation;
+        Vector3 translation;
+        float scale = 1.0f;
+    };
+
+    // 관절 4개의 로컬 변환을 성분별로 모은 것 (SoA). XMVECTOR의 레인 하나가 관절 하나이므로
+    // 보간/블렌딩/행렬 변환을 관절 4개에 한 번에 합니다.
+    struct SoaTransform {
+        DirectX::XMVECTOR rotation[4]; // x, y, z, w
+        DirectX::XMVECTOR translation[3];
+        DirectX::XMVECTOR scale;
+    };
+
+    struct Skeleton {
+        std::vector<int16_t> parents;    // 부모는 항상 자식보다 앞에 있음. 루트는 -1
+        std::vector<Matrix> inverseBind; // 바인드 포즈의 모델 공간 -> 관절 공간
+
+        uint32_t GetJointCount() const { return uint32_t(parents.size()); }
+        uint32_t GetGroupCount() const { return (GetJointCount() + 3) / 4; } // SoaTransform 수
+    };
+
+    // 스켈레톤 하나의 포즈. 관절 수가 4의 배수가 아니면 마지막 그룹의 남는 레인은 단위 변환
+    struct Pose {
+        std::vector<SoaTransform> groups;
+
+        void Resize(uint32_t jointCount) { groups.resize((jointCount + 3) / 4); }
+        void SetJoints(const JointTransform *joints, uint32_t jointCount);
+        JointTransform GetJoint(uint32_t joint) const;
+    };
+
+#pragma region 압축 클립
+    // 일정한 간격으로 샘플한 키를 16비트로 양자화해서 키마다 관절 4개씩 SoA로 저장한 클립
+    //   회전: 성분마다 [-1, 1] -> int16
+    //   이동: 클립 전체의 범위 -> uint16 (translationMin + q * translationStep)
+    //   스케일: 클립 전체의 범위 -> uint16
+    // 관절 하나의 키가 16바이트(float이면 32바이트)이고, 샘플할 때 키 두 개를 읽어 바로 레인으로 풂니다.
+    // 반복 클립이므로 마지막 키 다음은 첫 키입니다.
+    struct AnimationClip {
+        static constexpr uint32_t kKeysPerGroup = 32; // 회전 16 + 이동 12 + 스케일 4
+
+        uint32_t jointCount = 0;
+        uint32_t frameCount = 0;
+        float sampleRate = 30.0f;
+        Vector3 translationMin;
+        Vector3 translationStep;
+        float scaleMin = 1.0f;
+        float scaleStep = 0.0f;
+        std::vector<uint16_t> keys; // [frame][group][kKeysPerGroup]
+
+        float GetDuration() const { return float(frameCount) / sampleRate; }
+        size_t GetSizeBytes() const { return keys.size() * sizeof(uint16_t); }
+    };
+
+    struct ClipCompressionStats {
+        size_t rawBytes = 0; // JointTransform 그대로 저장했을 때
+        size_t compressedBytes = 0;
+        float maxRotationError = 0.0f;    // 쿼터니언 성분의 최대 오차
+        float maxTranslationError = 0.0f; // 이동의 최대 오차 (단위 길이)
+    };
+
+    // frames는 프레임 우선 [frame * jointCount + joint]
+    void CompressClip(const JointTransform *frames, uint32_t frameCount, uint32_t jointCount, float sampleRate,
+                      AnimationClip &clip, ClipCompressionStats *stats = nullptr);
+
+    // time(초)의 포즈. 클립 길이로 감싸고, 이웃한 두 키를 관절 4개씩 nlerp (최단 경로)
+    void SampleClip(const AnimationClip &clip, float time, Pose &out);
+#pragma endregion
+
+    // out = lerp(a, b, weight). 회전은 b의 부호를 a 쪽 반구로 맞춘 뒤 nlerp. out은 a나 b와 같아도 됨
+    void BlendPoses(const Pose &a, const Pose &b, float weight, Pose &out);
+
+    // 로컬 포즈 -> 모델 공간 행렬 (modelSpace, 관절 수만큼) -> 스키닝 행렬 (inverseBind * 모델 공간)
+    void ComputeSkinningMatrices(const Skeleton &skeleton, const Pose &pose, DirectX::XMMATRIX *modelSpace,
+                                 DirectX::XMMATRIX *skinning);
+
+#pragma region 스키닝
+    // 관절 4개까지의 영향. weights의 합은 255
+    struct SkinnedVertex {
+        Vector3 position;
+        Vector3 normal;
+        uint8_t joints[4];
+        uint8_t weights[4];
+    };
+
+    // 선형 블렌드 스키닝: 관절 행렬을 가중치로 섞은 행렬로 위치와 법선을 변환합니다.
+    // out의 position과 normal만 쓰고 color는 그대로 둡니다.
+    void SkinVertices(const SkinnedVertex *vertices, size_t count, const DirectX::XMMATRIX *skinning, Vertex *out);
+
+    struct SkinnedMeshData {
+        Skeleton skeleton;
+        std::vector<JointTransform> bindPose; // 로컬 변환
+        std::vector<SkinnedVertex> vertices;
+        std::vector<uint16_t> indices;
+    };
+
+    // 관절 18개(골반, 척추, 머리, 팔다리)짜리 사람 모양. 뼈마다 ringsPerBone개의 고리로 된 원통을 이어 붙임
+    SkinnedMeshData MakeTestCharacter(uint32_t ringSegments = 16, uint32_t ringsPerBone = 8);
+    // MakeTestCharacter()의 걷기(run == false)/뛰기 한 주기를 sampleRate로 샘플한 프레임들
+    std::vector<JointTransform> MakeTestLocomotion(const SkinnedMeshData &character, bool run, float sampleRate,
+                                                   uint32_t &frameCount);
+#pragma endregion
+
+    struct CrowdStats {
+        double poseMs = 0.0; // 샘플 + 블렌딩 + 스키닝 행렬
+        double skinMs = 0.0;
+        uint64_t skinnedVertices = 0;
+    };
+
+    // 같은 캐릭터 여러 명을 걷기/뛰기 클립을 섞어서 움직입니다.
+    // 두 클립은 길이가 다르므로 정규화한 위상으로 맞춰서 샘플합니다. (발이 미끄러지지 않음)
+    // Update()는 캐릭터 단위로 포즈를 계산한 뒤, 스키닝을 (캐릭터 x kSkinChunk 버텍스) 단위로 나눠 작업 풀에서 처리합니다.
+    class CrowdAnimator {
+    public:
+        static constexpr uint32_t kSkinChunk = 512;
+
+        // character와 두 클립은 CrowdAnimator보다 오래 살아 있어야 합니다.
+        void Initialize(const SkinnedMeshData &character, const AnimationClip &walk, const AnimationClip &run);
+        // 캐릭터마다 위상과 걷기/뛰기 비율을 seed로 정함
+        void SetCharacterCount(uint32_t count, uint32_t seed = 1);
+        void SetSpeed(uint32_t character, float runWeight) { m_characters[character].runWeight = runWeight; }
+
+        void Update(float dt, JobSystem &jobSystem);
+
+        uint32_t GetCharacterCount() const { return uint32_t(m_characters.size()); }
+        const Vertex *GetVertices(uint32_t character) const
+        {
+            return m_vertices.data() + size_t(character) * m_character->vertices.size();
+        }
+        size_t GetVertexBytes() const { return m_character->vertices.size() * sizeof(Vertex); } // 캐릭터 하나
+        const CrowdStats &GetStats() const { return m_stats; }
+
+    private:
+        struct Character {
+            float phase = 0.0f;     // [0, 1)
+            float runWeight = 0.0f; // 0이면 걷기, 1이면 뛰기
+        };
+
+        const SkinnedMeshData *m_character = nullptr;
+        const AnimationClip *m_walk = nullptr;
+        const AnimationClip *m_run = nullptr;
+        std::vector<Character> m_characters;
+        std::vector<DirectX::XMMATRIX> m_palettes; // [캐릭터][관절]
+        std::vector<Vertex> m_vertices;            // [캐릭터][버텍스]
+        CrowdStats m_stats;
+    };
+}
@@ -1,6 +1,8 @@
 ﻿
 #include "Application.h"
 #include "MeshGenerator.h"
+#include <chrono>
+#include <cstdio>
 #include <tuple>
 #include <vector>
 
@@ -16,77 +18,752 @@ namespace luke
         if (!Graphics::Initialize(hwnd, width, height))
             return false;
         m_aspect = Graphics::GetAspectRatio();
+        GpuMemoryOwnerScope ownerScope("Scene");
 
 #pragma region Geometry 정의
         MeshData meshData = MeshGenerator::MakeCube();
-        m_mesh = std::make_shared<Mesh>();
+        Mesh mesh;
 #pragma endregion
 
 #pragma region 버텍스 버퍼 만들기
-        Graphics::CreateVertexBuffer(meshData.vertices, m_mesh->m_vertexBuffer);
+        Graphics::CreateVertexBuffer(meshData.vertices, mesh.m_vertexBuffer);
 #pragma endregion
 
 #pragma region 인덱스 버퍼 만들기
         m_indexCount = UINT(meshData.indices.size());
-        Graphics::CreateIndexBuffer(meshData.indices, m_mesh->m_indexBuffer);
+        mesh.m_indexCount = m_indexCount;
+        Graphics::CreateIndexBuffer(meshData.indices, mesh.m_indexBuffer);
 #pragma endregion
 
+        m_mesh = m_resources.m_meshes.Create(std::move(mesh));
+
 #pragma region ConstantBuffer 만들기
-        m_constantBufferData.model = Matrix();
-        m_constantBufferData.view = Matrix();
-        m_constantBufferData.projection = Matrix();
-        Graphics::CreateConstantBuffer(m_constantBufferData, m_mesh->m_constantBuffer);
+        // 물체 상수를 한 버퍼의 범위로 바인딩하려면 D3D11.1 컨텍스트와 ConstantBufferOffsetting이 필요
+        // 없으면 물체 상수는 CPU에 모아 두고 드로우마다 작은 버퍼에 Map해서 바인딩 (m_context1 == nullptr)
+        D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+        if (FAILED(m_context.As(&m_context1)) ||
+            FAILED(m_device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) ||
+            !options.ConstantBufferOffsetting) {
+            m_context1.Reset();
+            cout << "Constant buffer offsetting (Direct3D 11.1) is not supported. Updating object constants per draw."
+                 << endl;
+        }
+        Graphics::CreateConstantBuffer(m_frameConstantData, m_frameConstantBuffer);
+        if (m_context1) {
+            Graphics::CreateDynamicConstantBuffer(UINT(kMaxViews * kConstantBufferAlignment), m_passConstantBuffer);
+            if (!m_passConstantBuffer)
+                return false;
+        }
+        else {
+            for (uint32_t v = 0; v < kMaxViews; v++) {
+                Graphics::CreateDynamicConstantBuffer(UINT(kConstantBufferAlignment), m_passConstantBuffers[v]);
+                Graphics::CreateDynamicConstantBuffer(UINT(kConstantBufferAlignment), m_drawConstantBuffers[v]);
+                if (!m_passConstantBuffers[v] || !m_drawConstantBuffers[v])
+                    return false;
+            }
+        }
 #pragma endregion
 
 #pragma region 쉐이더 만들기
         vector<D3D11_INPUT_ELEMENT_DESC> inputElements = {
             {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
             {"COLOR", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 4 * 3, D3D11_INPUT_PER_VERTEX_DATA, 0},
+            {"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 4 * 6, D3D11_INPUT_PER_VERTEX_DATA, 0},
         };
 
-        Graphics::CreateVertexShaderAndInputLayout(L"../Shader_Source/ColorVertexShader.hlsl", inputElements,
-                                                  m_colorVertexShader, m_colorInputLayout);
+        // 클러스터 조명(CLUSTERED_LIGHTING) x 흑백(GRAYSCALE) x 와이어프레임(래스터라이저) 퍼뮤테이션을
+        // 시작할 때 모두 만들어 둠
+        vector<PipelineStateDesc> pipelineDescs;
+        for (int lighting = 0; lighting < 2; lighting++) {
+            for (int grayscale = 0; grayscale < 2; grayscale++) {
+                for (int wireframe = 0; wireframe < 2; wireframe++) {
+                    PipelineStateDesc desc = PipelineStateDesc::Default();
+                    desc.vertexShaderFile = L"../Shader_Source/ColorVertexShader.hlsl";
+                    desc.pixelShaderFile = L"../Shader_Source/ColorPixelShader.hlsl";
+                    desc.defines = {{"CLUSTERED_LIGHTING", lighting ? "1" : "0"},
+                                    {"GRAYSCALE", grayscale ? "1" : "0"}};
+                    desc.inputElements = inputElements;
+                    desc.rasterizer.FillMode =
+                        wireframe ? D3D11_FILL_MODE::D3D11_FILL_WIREFRAME : D3D11_FILL_MODE::D3D11_FILL_SOLID;
+                    pipelineDescs.push_back(desc);
+                }
+            }
+        }
+
+        const vector<PipelineHandle> pipelines = m_pipelineStates.Prewarm(pipelineDescs, m_jobSystem);
+        std::copy(pipelines.begin(), pipelines.end(), m_colorPipelines);
+        for (PipelineHandle pipeline : pipelines) {
+            if (pipeline.IsNull())
+                return false;
+        }
+#pragma endregion
+
+        ClusterConstants clusterConstants;
+        Graphics::CreateConstantBuffer(clusterConstants, m_clusterConstantBuffer);
+
+        CreateOcclusionScene();
+        InitCrowd();
+        if (!InitParticles())
+            return false;
 
-        Graphics::CreatePixelShader(L"../Shader_Source/ColorPixelShader.hlsl", m_colorPixelShader);
+#pragma region 여러 뷰 기록용 디퍼드 컨텍스트
+        for (uint32_t v = 0; v < kMaxViews; v++) {
+            if (FAILED(m_device->CreateDeferredContext(0, m_deferredContexts[v].GetAddressOf())) ||
+                (m_context1 && FAILED(m_deferredContexts[v].As(&m_deferredContexts1[v])))) {
+                cout << "CreateDeferredContext() failed." << endl;
+                return false;
+            }
+            Graphics::CreateConstantBuffer(m_frameConstantData, m_viewConstantBuffers[v]);
+        }
 #pragma endregion
 
         return true;
     }
 
+    void Application::CreateOcclusionScene()
+    {
+        // 물체들이 공유할 버텍스/인덱스 버퍼
+        m_occluderMeshData = MeshGenerator::MakeSquare();
+        MeshData cubeData = MeshGenerator::MakeCube();
+
+        Mesh wallMesh;
+        Graphics::CreateVertexBuffer(m_occluderMeshData.vertices, wallMesh.m_vertexBuffer);
+        Graphics::CreateIndexBuffer(m_occluderMeshData.indices, wallMesh.m_indexBuffer);
+        wallMesh.m_indexCount = UINT(m_occluderMeshData.indices.size());
+
+        Mesh cubeMesh;
+        Graphics::CreateVertexBuffer(cubeData.vertices, cubeMesh.m_vertexBuffer);
+        Graphics::CreateIndexBuffer(cubeData.indices, cubeMesh.m_indexBuffer);
+        cubeMesh.m_indexCount = UINT(cubeData.indices.size());
+
+        BoundingBox wallBounds, cubeBounds;
+        BoundingBox::CreateFromPoints(wallBounds, m_occluderMeshData.vertices.size(),
+                                      &m_occluderMeshData.vertices[0].position, sizeof(Vertex));
+        BoundingBox::CreateFromPoints(cubeBounds, cubeData.vertices.size(),
+                                      &cubeData.vertices[0].position, sizeof(Vertex));
+
+        const MeshHandle wall = m_resources.m_meshes.Create(std::move(wallMesh));
+        const MeshHandle cube = m_resources.m_meshes.Create(std::move(cubeMesh));
+
+        auto addObject = [&](MeshHandle mesh, const BoundingBox &localBounds,
+                             const Matrix &world, bool isOccluder) {
+            SceneObject object;
+            object.mesh = mesh;
+            object.world = world;
+            object.isOccluder = isOccluder;
+            localBounds.Transform(object.worldBounds, world);
+
+            m_sceneObjects.push_back(object);
+        };
+
+        m_sceneObjects.reserve(1 + 4 * 6 * 12);
+
+        // 카메라 앞을 가로막는 벽
+        addObject(wall, wallBounds,
+                  Matrix::CreateScale(4.0f, 2.0f, 1.0f) * Matrix::CreateTranslation(0.0f, 0.0f, 1.0f),
+                  true);
+
+        // 벽 뒤의 큐브들 (가장자리 열은 벽 밖으로 보임)
+        for (int z = 0; z < 4; z++) {
+            for (int y = 0; y < 6; y++) {
+                for (int x = 0; x < 12; x++) {
+                    const Vector3 position(-3.3f + 0.6f * x, -0.75f + 0.3f * y, 2.0f + 0.8f * z);
+                    addObject(cube, cubeBounds,
+                              Matrix::CreateScale(0.1f) * Matrix::CreateTranslation(position),
+                              false);
+                }
+            }
+        }
+
+        m_occludeeBounds.clear();
+        m_occludeeIndices.clear();
+        for (size_t i = 0; i < m_sceneObjects.size(); i++) {
+            if (!m_sceneObjects[i].isOccluder) {
+                m_occludeeBounds.push_back(m_sceneObjects[i].worldBounds);
+                m_occludeeIndices.push_back(i);
+            }
+        }
+        m_sceneVisible.assign(m_sceneObjects.size(), 1);
+
+        m_sceneObjectSlots.assign(m_sceneObjects.size(), 0);
+        m_sceneBounds.resize(m_sceneObjects.size());
+        for (size_t i = 0; i < m_sceneObjects.size(); i++)
+            m_sceneBounds[i] = m_sceneObjects[i].worldBounds;
+    }
+
+    void Application::UpdateOcclusionCulling(const Matrix &view, const Matrix &projection)
+    {
+        fill(m_sceneVisible.begin(), m_sceneVisible.end(), uint8_t(1));
+        if (!m_useOcclusionCulling)
+            return;
+
+        m_occlusionCuller.BeginFrame(view, projection, &m_frameArena);
+        for (const auto &object : m_sceneObjects) {
+            if (object.isOccluder)
+                m_occlusionCuller.RasterizeOccluder(m_occluderMeshData.vertices,
+                                                    m_occluderMeshData.indices, object.world);
+        }
+        m_occlusionCuller.EndOccluders();
+
+        m_occlusionCuller.TestBoxes(m_occludeeBounds, m_occludeeVisible, m_jobSystem);
+        for (size_t i = 0; i < m_occludeeIndices.size(); i++)
+            m_sceneVisible[m_occludeeIndices[i]] = m_occludeeVisible[i];
+    }
+
+    void Application::InitWorldStreaming()
+    {
+        // 장면 아래(y = -1)에 4 x 4 셀 32 x 32개. 카메라 이동 범위에 맞춰 반경을 줄임
+        WorldStreamingSettings settings;
+        settings.cellSize = 4.0f;
+        settings.loadRadius = 12.0f;
+        settings.unloadRadius = 16.0f;
+        settings.requiredRadius = 4.0f;
+        settings.memoryBudget = 32ull << 20;
+        m_streamedCells.clear();
+        m_streamedCells.resize(size_t(settings.gridWidth) * settings.gridDepth);
+
+        // GPU 메모리 예산이 모자라면 먼 셀부터 내림 (실제 버퍼는 GPU가 다 쓴 몇 프레임 뒤에 해제됨)
+        m_gpuMemory.AddEvictionCallback(
+            [this](GpuMemoryCategory, uint64_t bytesNeeded) { return m_worldStreamer.Evict(bytesNeeded); });
+
+        m_worldStreamer.Initialize(
+            settings, m_jobSystem,
+            [this](uint32_t cell) -> uint64_t {
+                // 작업 스레드: CPU 메쉬만 만듦
+                StreamedCell &streamed = m_streamedCells[cell];
+                const Vector3 center = m_worldStreamer.GetCellCenter(cell) + Vector3(0.0f, -1.0f, 0.0f);
+                streamed.meshData = MeshGenerator::MakeWorldCell(
+                    center, m_worldStreamer.GetCellSize(), 200, cell);
+                return streamed.meshData.vertices.size() * sizeof(Vertex) +
+                       streamed.meshData.indices.size() * sizeof(uint16_t);
+            },
+            [this](uint32_t cell) -> uint64_t {
+                GpuMemoryOwnerScope ownerScope("WorldStreamer");
+                StreamedCell &streamed = m_streamedCells[cell];
+                Mesh mesh;
+                Graphics::CreateVertexBuffer(streamed.meshData.vertices, mesh.m_vertexBuffer);
+                Graphics::CreateIndexBuffer(streamed.meshData.indices, mesh.m_indexBuffer);
+                if (!mesh.m_vertexBuffer || !mesh.m_indexBuffer)
+                    return 0;
+                mesh.m_indexCount = UINT(streamed.meshData.indices.size());
+
+                const uint64_t bytes = streamed.meshData.vertices.size() * sizeof(Vertex) +
+                                       streamed.meshData.indices.size() * sizeof(uint16_t);
+                streamed.mesh = m_resources.m_meshes.Create(std::move(mesh));
+                streamed.meshData = MeshData(); // GPU에 올렸으므로 CPU 사본은 버림
+                return bytes;
+            },
+            [this](uint32_t cell) {
+                // GPU가 아직 쓰고 있을 수 있으므로 몇 프레임 뒤에 삭제
+                StreamedCell &streamed = m_streamedCells[cell];
+                if (!streamed.mesh.IsNull())
+                    m_resources.m_meshes.Release(streamed.mesh, m_frameIndex);
+                streamed = StreamedCell();
+            });
+    }
+
+    void Application::InitCrowd()
+    {
+        m_characterData = MakeTestCharacter();
+        const uint32_t jointCount = m_characterData.skeleton.GetJointCount();
+        const float sampleRate = 30.0f;
+        uint32_t frameCount = 0;
+        vector<JointTransform> frames = MakeTestLocomotion(m_characterData, false, sampleRate, frameCount);
+        CompressClip(frames.data(), frameCount, jointCount, sampleRate, m_walkClip);
+        frames = MakeTestLocomotion(m_characterData, true, sampleRate, frameCount);
+        CompressClip(frames.data(), frameCount, jointCount, sampleRate, m_runClip);
+
+        m_crowd.Initialize(m_characterData, m_walkClip, m_runClip);
+        GpuMemoryOwnerScope ownerScope("Crowd");
+        Graphics::CreateIndexBuffer(m_characterData.indices, m_crowdIndexBuffer);
+    }
+
+    void Application::UpdateCrowd(float dt)
+    {
+        const uint32_t count = uint32_t(m_crowdCount);
+        if (m_crowd.GetCharacterCount() != count) {
+            m_crowd.SetCharacterCount(count);
+            GpuMemoryOwnerScope ownerScope("Crowd");
+            while (m_crowdMeshes.size() < count) {
+                Mesh mesh;
+                Graphics::CreateDynamicVertexBuffer(UINT(m_crowd.GetVertexBytes()), mesh.m_vertexBuffer);
+                mesh.m_indexBuffer = m_crowdIndexBuffer;
+                mesh.m_indexCount = UINT(m_characterData.indices.size());
+                m_crowdMeshes.push_back(m_resources.m_meshes.Create(std::move(mesh)));
+            }
+            while (m_crowdMeshes.size() > count) {
+                m_resources.m_meshes.Release(m_crowdMeshes.back(), m_frameIndex);
+                m_crowdMeshes.pop_back();
+            }
+        }
+        for (uint32_t i = 0; i < count; i++)
+            m_crowd.SetSpeed(i, m_crowdSpeed);
+
+        m_crowd.Update(dt, m_jobSystem);
+
+        const size_t vertexBytes = m_crowd.GetVertexBytes();
+        for (uint32_t i = 0; i < count; i++) {
+            const Mesh &mesh = *m_resources.m_meshes.Get(m_crowdMeshes[i]);
+            D3D11_MAPPED_SUBRESOURCE ms;
+            if (SUCCEEDED(m_context->Map(mesh.m_vertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &ms))) {
+                memcpy(ms.pData, m_crowd.GetVertices(i), vertexBytes);
+                m_context->Unmap(mesh.m_vertexBuffer.Get(), 0);
+            }
+            if (m_recordingCommands)
+                m_commandCapture.UpdateBuffer(GetCaptureBufferId(mesh.m_vertexBuffer.Get()), m_crowd.GetVertices(i),
+                                              vertexBytes);
+        }
+    }
+
+    bool Application::InitParticles()
+    {
+        // 모델 뒤쪽 바닥에 연기, 불꽃, 파편 이미터를 나란히 세움
+        GpuMemoryOwnerScope ownerScope("Particles");
+        const uint32_t perEmitter = 20000;
+        EmitterSettings emitters[] = {EmitterSettings::Smoke(perEmitter), EmitterSettings::Sparks(perEmitter),
+                                      EmitterSettings::Debris(perEmitter)};
+        for (uint32_t i = 0; i < 3; i++) {
+            emitters[i].position = Vector3(-1.5f + 1.5f * i, -1.0f, 2.0f);
+            m_particles.AddEmitter(emitters[i], i + 1);
+
+            ComPtr<ID3D11Buffer> instanceBuffer;
+            Graphics::CreateDynamicVertexBuffer(UINT(perEmitter * sizeof(ParticleInstance)), instanceBuffer);
+            m_particleInstanceBuffers.push_back(instanceBuffer);
+        }
+
+        const MeshData quad = MeshGenerator::MakeSquare();
+        Graphics::CreateVertexBuffer(quad.vertices, m_particleVertexBuffer);
+        Graphics::CreateIndexBuffer(quad.indices, m_particleIndexBuffer);
+        m_particleIndexCount = UINT(quad.indices.size());
+
+        // 슬롯 0: 사각형의 버텍스, 슬롯 1: ParticleInstance
+        PipelineStateDesc desc = PipelineStateDesc::Default();
+        desc.vertexShaderFile = L"../Shader_Source/ParticleVertexShader.hlsl";
+        desc.pixelShaderFile = L"../Shader_Source/ParticlePixelShader.hlsl";
+        desc.inputElements = {
+            {"POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+            {"COLOR", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 4 * 3, D3D11_INPUT_PER_VERTEX_DATA, 0},
+            {"INSTANCEPOS", 0, DXGI_FORMAT_R32G32B32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+            {"INSTANCESIZE", 0, DXGI_FORMAT_R32_FLOAT, 1, 4 * 3, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+            {"INSTANCECOLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 1, 4 * 4, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+        };
+        // 반투명: 깊이 테스트는 하지만 쓰지는 않고, 정렬 없이 알파 블렌딩
+        desc.depthStencil.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+        desc.blend.RenderTarget[0].BlendEnable = true;
+        desc.blend.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+        desc.blend.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+        m_particlePipeline = m_pipelineStates.GetOrCreate(desc);
+        return !m_particlePipeline.IsNull();
+    }
+
+    void Application::RenderParticles()
+    {
+        m_pipelineStates.Get(m_particlePipeline)->Bind(m_context.Get());
+        // b0의 프레임 상수는 Render()에서 바인딩한 그대로 (파티클 위치는 월드 공간이므로 물체 상수 없음)
+        m_context->IASetIndexBuffer(m_particleIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
+        if (m_recordingCommands) {
+            m_commandCapture.SetPipeline(m_particlePipeline.value);
+            m_commandCapture.SetIndexBuffer(GetCaptureBufferId(m_particleIndexBuffer.Get()));
+        }
+
+        for (uint32_t e = 0; e < m_particles.GetEmitterCount(); e++) {
+            const uint32_t count = m_particles.GetParticleCount(e);
+            if (count == 0)
+                continue;
+
+            // Map한 메모리는 쓰기 결합이라 읽기가 느리므로 캡처할 때는 따로 써 두고 복사
+            ID3D11Buffer *instanceBuffer = m_particleInstanceBuffers[e].Get();
+            const size_t bytes = count * sizeof(ParticleInstance);
+            D3D11_MAPPED_SUBRESOURCE ms;
+            if (FAILED(m_context->Map(instanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
+                continue;
+            if (m_recordingCommands) {
+                m_particleCaptureData.resize(count);
+                m_particles.WriteInstances(e, m_particleCaptureData.data(), m_jobSystem);
+                memcpy(ms.pData, m_particleCaptureData.data(), bytes);
+            }
+            else {
+                m_particles.WriteInstances(e, static_cast<ParticleInstance *>(ms.pData), m_jobSystem);
+            }
+            m_context->Unmap(instanceBuffer, 0);
+
+            ID3D11Buffer *buffers[2] = {m_particleVertexBuffer.Get(), instanceBuffer};
+            const UINT strides[2] = {sizeof(Vertex), sizeof(ParticleInstance)};
+            const UINT offsets[2] = {0, 0};
+            m_context->IASetVertexBuffers(0, 2, buffers, strides, offsets);
+            m_context->DrawIndexedInstanced(m_particleIndexCount, count, 0, 0, 0);
+
+            if (m_recordingCommands) {
+                const uint32_t id = GetCaptureBufferId(instanceBuffer);
+                m_commandCapture.UpdateBuffer(id, m_particleCaptureData.data(), bytes);
+                m_commandCapture.SetVertexBuffer(GetCaptureBufferId(m_particleVertexBuffer.Get()), sizeof(Vertex));
+                m_commandCapture.SetInstanceBuffer(id, sizeof(ParticleInstance));
+                m_commandCapture.DrawIndexedInstanced(m_particleIndexCount, count, 0);
+            }
+        }
+    }
+
+    void Application::UpdateLights(float dt, const Matrix &view, const Matrix &projection)
+    {
+        // 빛마다 정해진 중심 주위를 돔 (중심/반지름/속도/색은 번호로 만든 난수)
+        m_lightTime += dt;
+        m_lights.resize(size_t(m_lightCount));
+        for (uint32_t i = 0; i < uint32_t(m_lightCount); i++) {
+            uint32_t random = i * 747796405u + 2891336453u;
+            auto next = [&]() {
+                random ^= random << 13;
+                random ^= random >> 17;
+                random ^= random << 5;
+                return float(random & 0xFFFF) / 65535.0f;
+            };
+            const Vector3 center(next() * 8.0f - 4.0f, next() * 3.0f - 1.5f, next() * 6.0f - 0.5f);
+            const float orbit = 0.2f + next() * 0.6f;
+            const float angle = m_lightTime * (0.5f + next()) + next() * DirectX::XM_2PI;
+            const Vector3 color(0.3f + next(), 0.3f + next(), 0.3f + next());
+            const Vector3 position = center + Vector3(cosf(angle), 0.0f, sinf(angle)) * orbit;
+            m_lights[i] = Light::Point(position, 0.5f + next(), color);
+        }
+
+        m_lightGrid.Configure(projection);
+        m_lightGrid.Bin(m_lights, view, m_jobSystem);
+
+        ClusterConstants constants =
+            m_lightGrid.GetConstants(m_screenViewport.Width, m_screenViewport.Height, Vector3(0.05f));
+        constants.lightCount = uint32_t(m_lights.size());
+        Graphics::UpdateBuffer(constants, m_clusterConstantBuffer);
+
+        // 프레임마다 한 번씩 세 버퍼를 통째로 올림
+        const vector<LightCluster> &clusters = m_lightGrid.GetClusters();
+        const vector<uint32_t> &indices = m_lightGrid.GetLightIndices();
+        UploadLightBuffer(m_lightBuffer, m_lightView, m_lightCapacity, sizeof(Light), m_lights.data(),
+                          UINT(m_lights.size()));
+        UploadLightBuffer(m_clusterBuffer, m_clusterView, m_clusterCapacity, sizeof(LightCluster),
+                          clusters.data(), UINT(clusters.size()));
+        UploadLightBuffer(m_lightIndexBuffer, m_lightIndexView, m_lightIndexCapacity, sizeof(uint32_t),
+                          indices.data(), UINT(indices.size()));
+    }
+
+    void Application::UploadLightBuffer(ComPtr<ID3D11Buffer> &buffer, ComPtr<ID3D11ShaderResourceView> &view,
+                                        UINT &capacity, UINT stride, const void *data, UINT count)
+    {
+        if (count > capacity || !buffer) {
+            GpuMemoryOwnerScope ownerScope("ClusteredLighting");
+            const UINT newCapacity = (std::max)(count + count / 2, 64u);
+            if (!Graphics::CreateDynamicStructuredBuffer(stride, newCapacity, buffer, view)) {
+                capacity = 0;
+                return;
+            }
+            capacity = newCapacity;
+        }
+        if (count == 0)
+            return;
+
+        D3D11_MAPPED_SUBRESOURCE ms;
+        if (FAILED(m_context->Map(buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
+            return;
+        memcpy(ms.pData, data, size_t(stride) * count);
+        m_context->Unmap(buffer.Get(), 0);
+        if (m_recordingCommands)
+            m_commandCapture.UpdateBuffer(GetCaptureBufferId(buffer.Get()), data, size_t(stride) * count);
+    }
+
+    void Application::BindLights()
+    {
+        ID3D11ShaderResourceView *views[3] = {m_lightView.Get(), m_clusterView.Get(), m_lightIndexView.Get()};
+        m_context->PSSetConstantBuffers(1, 1, m_clusterConstantBuffer.GetAddressOf());
+        m_context->PSSetShaderResources(0, 3, views);
+        if (m_recordingCommands) {
+            m_commandCapture.SetConstantBuffer(1, GetCaptureBufferId(m_clusterConstantBuffer.Get()));
+            m_commandCapture.SetShaderBuffer(0, GetCaptureBufferId(m_lightBuffer.Get()));
+            m_commandCapture.SetShaderBuffer(1, GetCaptureBufferId(m_clusterBuffer.Get()));
+            m_commandCapture.SetShaderBuffer(2, GetCaptureBufferId(m_lightIndexBuffer.Get()));
+        }
+    }
+
+    void Application::UpdateViews(const Matrix &view, const Matrix &projection)
+    {
+        using namespace DirectX;
+
+        const uint32_t viewCount = uint32_t(m_viewCount);
+        LayoutViewGrid(viewCount, m_views);
+
+        // 0번 뷰는 메인 카메라 그대로 (투영만 칸의 비율에 맞춤)
+        const Vector3 center(0.0f, 0.0f, 3.0f);
+        for (uint32_t v = 0; v < viewCount; v++) {
+            RenderView &renderView = m_views[v];
+            const float aspect = m_aspect * renderView.width / renderView.height;
+            renderView.projection = m_usePerspectiveProjection
+                                        ? XMMatrixPerspectiveFovLH(XMConvertToRadians(m_projFovAngleY),
+                                                                   aspect, m_nearZ, m_farZ)
+                                        : XMMatrixOrthographicOffCenterLH(-aspect, aspect, -1.0f, 1.0f,
+                                                                          m_nearZ, m_farZ);
+            if (v == 0) {
+                renderView.view = view;
+                if (viewCount == 1)
+                    renderView.projection = projection;
+                continue;
+            }
+
+            const float angle = XM_2PI * float(v) / viewCount;
+            const Vector3 eye = center + Vector3(sinf(angle) * 5.0f, 1.5f, -cosf(angle) * 5.0f);
+            renderView.view = XMMatrixLookAtLH(eye, center, Vector3(0.0f, 1.0f, 0.0f));
+        }
+    }
+
     void Application::Update(float dt)
     {
         using namespace DirectX;
 
         // 모델의 변환
-        m_constantBufferData.model =
-            Matrix::CreateScale(m_modelScaling) * Matrix::CreateRotationY(m_modelRotation.y) *
-            Matrix::CreateRotationX(m_modelRotation.x) * Matrix::CreateRotationZ(m_modelRotation.z) *
-            Matrix::CreateTranslation(m_modelTranslation);
-        m_constantBufferData.model = m_constantBufferData.model.Transpose();
+        m_model = Matrix::CreateScale(m_modelScaling) * Matrix::CreateRotationY(m_modelRotation.y) *
+                  Matrix::CreateRotationX(m_modelRotation.x) * Matrix::CreateRotationZ(m_modelRotation.z) *
+                  Matrix::CreateTranslation(m_modelTranslation);
 
         // 시점 변환
-        // m_constantBufferData.view = XMMatrixLookAtLH(m_viewEye, m_viewFocus, m_viewUp);
-        m_constantBufferData.view = XMMatrixLookToLH(m_viewEyePos, m_viewEyeDir, m_viewUp);
-        m_constantBufferData.view = m_constantBufferData.view.Transpose();
+        // view = XMMatrixLookAtLH(m_viewEye, m_viewFocus, m_viewUp);
+        const Matrix view = XMMatrixLookToLH(m_viewEyePos, m_viewEyeDir, m_viewUp);
 
         // 프로젝션
         // m_aspect = AppBase::GetAspectRatio(); // <- GUI에서 조절
+        Matrix projection;
         if (m_usePerspectiveProjection) {
-            m_constantBufferData.projection = XMMatrixPerspectiveFovLH(
-                XMConvertToRadians(m_projFovAngleY), m_aspect, m_nearZ, m_farZ);
+            projection = XMMatrixPerspectiveFovLH(XMConvertToRadians(m_projFovAngleY), m_aspect, m_nearZ, m_farZ);
         }
         else {
-            m_constantBufferData.projection =
-                XMMatrixOrthographicOffCenterLH(-m_aspect, m_aspect, -1.0f, 1.0f, m_nearZ, m_farZ);
+            projection = XMMatrixOrthographicOffCenterLH(-m_aspect, m_aspect, -1.0f, 1.0f, m_nearZ, m_farZ);
+        }
+
+        // 모든 물체가 같이 쓰는 view/projection은 프레임에 한 번만 CPU에서 GPU로 복사
+        m_time += dt;
+        m_frameConstantData = MakeFrameConstants(view, projection, m_time, dt);
+        Graphics::UpdateBuffer(m_frameConstantData, m_frameConstantBuffer);
+
+        if (m_drawStreamedWorld) {
+            m_viewEyePos += m_viewEyeDir * (m_flySpeed * dt);
+            m_worldStreamer.Update(m_viewEyePos, m_viewEyeDir);
+        }
+
+        if (m_drawCrowd)
+            UpdateCrowd(dt);
+
+        if (m_drawParticles)
+            m_particles.Update(dt, m_jobSystem);
+
+        // 여러 뷰는 조명 없이 그리므로 Render()가 한 뷰 경로로 그릴 때만 빛을 분류
+        if (m_useClusteredLighting && !IsMultiViewFrame())
+            UpdateLights(dt, view, projection);
+
+        // 여러 뷰: 절두체 컬링만 하고 뷰별 프레임 상수는 Render()에서 기록
+        if (IsMultiViewFrame()) {
+            const uint32_t viewCount = uint32_t(m_viewCount);
+            UpdateViews(view, projection);
+            m_multiViewCuller.Cull(span<const RenderView>(m_views, viewCount), m_sceneBounds, m_viewMasks,
+                                   m_jobSystem);
+            m_multiViewCuller.BuildDrawLists(m_viewMasks, viewCount, m_jobSystem);
+        }
+        else if (m_drawOcclusionScene) {
+            UpdateOcclusionCulling(view, projection);
+        }
+
+        UploadObjectConstants();
+    }
+
+    bool Application::BeginObjectConstants(UINT count)
+    {
+        // 오프셋 바인딩이 없으면 CPU에만 모아 두고 BindObjectConstants()가 드로우마다 올림
+        if (!m_context1) {
+            m_objectConstantData.resize(size_t(count) * kConstantBufferAlignment);
+            m_objectConstants = m_objectConstantData.data();
+            m_objectReserved = count;
+            m_objectCount = 0;
+            return true;
+        }
+
+        if (count > m_objectCapacity || !m_objectConstantBuffer) {
+            const UINT capacity = (std::max)(count + count / 2, 256u);
+            GpuMemoryOwnerScope ownerScope("ObjectConstants");
+            Graphics::CreateDynamicConstantBuffer(UINT(capacity * kConstantBufferAlignment), m_objectConstantBuffer);
+            m_objectCapacity = m_objectConstantBuffer ? capacity : 0;
+            if (!m_objectConstantBuffer)
+                return false;
+        }
+
+        D3D11_MAPPED_SUBRESOURCE ms;
+        if (FAILED(m_context->Map(m_objectConstantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
+            return false;
+        m_objectConstants = static_cast<uint8_t *>(ms.pData);
+        m_objectReserved = count;
+        m_objectCount = 0;
+        // Map한 메모리는 쓰기 결합이라 읽기가 느리므로 캡처할 때는 따로 써 두고 복사
+        if (m_recordingCommands)
+            m_objectCaptureData.assign(size_t(count) * kConstantBufferAlignment, 0);
+        return true;
+    }
+
+    UINT Application::AddObjectConstants(const Matrix &world)
+    {
+        if (!m_objectConstants || m_objectCount >= m_objectReserved)
+            return 0;
+
+        const ObjectConstants constants = MakeObjectConstants(world);
+        const size_t offset = size_t(m_objectCount) * kConstantBufferAlignment;
+        memcpy(m_objectConstants + offset, &constants, sizeof(constants));
+        if (m_recordingCommands && m_context1)
+            memcpy(m_objectCaptureData.data() + offset, &constants, sizeof(constants));
+        return m_objectCount++;
+    }
+
+    void Application::EndObjectConstants()
+    {
+        if (!m_objectConstants)
+            return;
+        m_objectConstants = nullptr;
+        if (!m_context1)
+            return;
+        m_context->Unmap(m_objectConstantBuffer.Get(), 0);
+        if (m_recordingCommands)
+            m_commandCapture.UpdateBuffer(GetCaptureBufferId(m_objectConstantBuffer.Get()), m_objectCaptureData.data(),
+                                          size_t(m_objectCount) * kConstantBufferAlignment);
+    }
+
+    void Application::UploadObjectConstants()
+    {
+        // 이번 프레임에 그릴 물체의 world를 Map 한 번으로 모두 올림
+        // (여러 뷰는 어느 뷰에서 보일지 모르므로 장면 물체를 모두, 한 뷰는 보이는 물체만)
+        const bool allSceneObjects = IsMultiViewFrame();
+        UINT count = 2;
+        if (m_drawCrowd)
+            count += UINT(m_crowdCount);
+        if (m_drawOcclusionScene)
+            count += UINT(m_sceneObjects.size());
+        if (!BeginObjectConstants(count))
+            return;
+
+        m_modelObject = AddObjectConstants(m_model);
+        // 스트리밍 셀 메쉬는 월드 좌표로 만들어 두었으므로 모두 단위 행렬 하나를 같이 씀
+        m_identityObject = AddObjectConstants(Matrix());
+
+        // 장면 앞쪽 바닥에 8명씩 줄지어 카메라를 보고 섬
+        m_crowdFirstObject = m_objectCount;
+        if (m_drawCrowd) {
+            for (UINT i = 0; i < UINT(m_crowdCount); i++) {
+                const Vector3 position(-1.75f + 0.5f * (i % 8), -1.0f, 0.5f - 0.6f * (i / 8));
+                AddObjectConstants(Matrix::CreateScale(0.4f) * Matrix::CreateRotationY(DirectX::XM_PI) *
+                                   Matrix::CreateTranslation(position));
+            }
+        }
+
+        if (m_drawOcclusionScene) {
+            for (size_t i = 0; i < m_sceneObjects.size(); i++) {
+                if (allSceneObjects || m_sceneVisible[i])
+                    m_sceneObjectSlots[i] = AddObjectConstants(m_sceneObjects[i].world);
+            }
+        }
+        EndObjectConstants();
+    }
+
+    void Application::UploadPassConstants(const D3D11_VIEWPORT *viewports, UINT count)
+    {
+        uint8_t data[kMaxViews * kConstantBufferAlignment] = {};
+        for (UINT i = 0; i < count; i++) {
+            PassConstants pass;
+            pass.viewportX = viewports[i].TopLeftX;
+            pass.viewportY = viewports[i].TopLeftY;
+            pass.viewportWidth = viewports[i].Width;
+            pass.viewportHeight = viewports[i].Height;
+            pass.passIndex = i;
+            memcpy(data + i * kConstantBufferAlignment, &pass, sizeof(pass));
         }
-        m_constantBufferData.projection = m_constantBufferData.projection.Transpose();
 
-        // Constant를 CPU에서 GPU로 복사
-        Graphics::UpdateBuffer(m_constantBufferData, m_mesh->m_constantBuffer);
+        D3D11_MAPPED_SUBRESOURCE ms;
+        if (!m_context1) {
+            // 패스마다 버퍼 하나
+            for (UINT i = 0; i < count; i++) {
+                ID3D11Buffer *passBuffer = m_passConstantBuffers[i].Get();
+                if (FAILED(m_context->Map(passBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
+                    return;
+                memcpy(ms.pData, data + i * kConstantBufferAlignment, sizeof(PassConstants));
+                m_context->Unmap(passBuffer, 0);
+                if (m_recordingCommands)
+                    m_commandCapture.UpdateBuffer(GetCaptureBufferId(passBuffer), data + i * kConstantBufferAlignment,
+                                                  sizeof(PassConstants));
+            }
+            return;
+        }
+        if (FAILED(m_context->Map(m_passConstantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
+            return;
+        memcpy(ms.pData, data, count * kConstantBufferAlignment);
+        m_context->Unmap(m_passConstantBuffer.Get(), 0);
+        if (m_recordingCommands)
+            m_commandCapture.UpdateBuffer(GetCaptureBufferId(m_passConstantBuffer.Get()), data,
+                                          count * kConstantBufferAlignment);
+    }
+
+    void Application::BindFrameConstants(ID3D11DeviceContext *context, ID3D11DeviceContext1 *context1,
+                                         ID3D11Buffer *frameBuffer, UINT pass)
+    {
+        context->VSSetConstantBuffers(kFrameConstantSlot, 1, &frameBuffer);
+        if (m_recordingCommands)
+            m_commandCapture.SetConstantBuffer(kFrameConstantSlot, GetCaptureBufferId(frameBuffer));
+
+        if (!context1) {
+            ID3D11Buffer *passBuffer = m_passConstantBuffers[pass].Get();
+            context->PSSetConstantBuffers(kPassConstantSlot, 1, &passBuffer);
+            if (m_recordingCommands)
+                m_commandCapture.SetConstantBuffer(kPassConstantSlot, GetCaptureBufferId(passBuffer));
+            return;
+        }
+
+        // 범위는 상수(16바이트) 단위
+        const UINT firstConstant = UINT(pass * kConstantBufferAlignment / 16);
+        const UINT constantCount = UINT(kConstantBufferAlignment / 16);
+        ID3D11Buffer *passBuffer = m_passConstantBuffer.Get();
+        context1->PSSetConstantBuffers1(kPassConstantSlot, 1, &passBuffer, &firstConstant, &constantCount);
+        if (m_recordingCommands)
+            m_commandCapture.SetConstantBufferRange(kPassConstantSlot, GetCaptureBufferId(passBuffer),
+                                                    pass * kConstantBufferAlignment, kConstantBufferAlignment);
+    }
+
+    void Application::BindObjectConstants(ID3D11DeviceContext *context, ID3D11DeviceContext1 *context1,
+                                          ID3D11Buffer *drawBuffer, UINT object)
+    {
+        if (!context1) {
+            // 이 드로우의 물체 상수만 drawBuffer에 올려서 바인딩
+            const uint8_t *constants = m_objectConstantData.data() + size_t(object) * kConstantBufferAlignment;
+            D3D11_MAPPED_SUBRESOURCE ms;
+            if (FAILED(context->Map(drawBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
+                return;
+            memcpy(ms.pData, constants, sizeof(ObjectConstants));
+            context->Unmap(drawBuffer, 0);
+            context->VSSetConstantBuffers(kObjectConstantSlot, 1, &drawBuffer);
+            if (m_recordingCommands) {
+                m_commandCapture.UpdateBuffer(GetCaptureBufferId(drawBuffer), constants, sizeof(ObjectConstants));
+                m_commandCapture.SetConstantBuffer(kObjectConstantSlot, GetCaptureBufferId(drawBuffer));
+            }
+            return;
+        }
+
+        const UINT firstConstant = UINT(object * kConstantBufferAlignment / 16);
+        const UINT constantCount = UINT(kConstantBufferAlignment / 16);
+        ID3D11Buffer *objectBuffer = m_objectConstantBuffer.Get();
+        context1->VSSetConstantBuffers1(kObjectConstantSlot, 1, &objectBuffer, &firstConstant, &constantCount);
+        if (m_recordingCommands)
+            m_commandCapture.SetConstantBufferRange(kObjectConstantSlot, GetCaptureBufferId(objectBuffer),
+                                                    object * kConstantBufferAlignment, kConstantBufferAlignment);
+    }
+
+    void Application::OnResize()
+    {
+        // 투영 행렬은 Update()에서 m_aspect로 매 프레임 만들므로 값만 바꾸면 됨
+        m_aspect = Graphics::GetAspectRatio();
     }
 
     void Application::Render()
     {
+        if (IsMultiViewFrame()) {
+            RenderViews();
+            return;
+        }
 
         // IA: Input-Assembler stage
         // VS: Vertex Shader
@@ -94,16 +771,7 @@ namespace luke
         // RS: Rasterizer stage
         // OM: Output-Merger stage
         // Set the viewport
-        ZeroMemory(&m_screenViewport, sizeof(D3D11_VIEWPORT));
-        D3D11_VIEWPORT m_screenViewport =
-            {
-                0,                     // TopLeftX
-                0,                     // TopLeftY
-                float(m_screenWidth),  // Width
-                float(m_screenHeight), // Height
-                0.0f,                  // MinDepth
-                1.0f                   // MaxDepth, important for depth buffering
-            };
+        // 동적 해상도가 켜져 있으면 화면보다 작은 영역 (Graphics::BeginScaledFrame)
         m_context->RSSetViewports(1, &m_screenViewport);
 
         float clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
@@ -115,10 +783,18 @@ namespace luke
         // m_context->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), nullptr);
         m_context->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
 
-        m_context->OMSetDepthStencilState(m_depthStencilState.Get(), 0);
+        // 쉐이더, 입력 레이아웃, 래스터라이저/깊이/블렌드 상태를 한 번에 설정
+        const int permutation =
+            (m_useClusteredLighting ? 4 : 0) + (m_useGrayscale ? 2 : 0) + (m_useWireframe ? 1 : 0);
+        m_pipelineStates.Get(m_colorPipelines[permutation])->Bind(m_context.Get());
+        if (m_recordingCommands)
+            m_commandCapture.SetPipeline(m_colorPipelines[permutation].value);
+        if (m_useClusteredLighting)
+            BindLights();
 
-        // 어떤 쉐이더를 사용할지 설정
-        m_context->VSSetShader(m_colorVertexShader.Get(), 0, 0);
+        // 프레임/패스 상수는 한 번만 바인딩하고 물체마다 b2의 범위만 바꿈
+        UploadPassConstants(&m_screenViewport, 1);
+        BindFrameConstants(m_context.Get(), m_context1.Get(), m_frameConstantBuffer.Get(), 0);
 
         /* 경우에 따라서는 포인터의 배열을 넣어줄 수도 있습니다.
         ID3D11Buffer *pptr[1] = {
@@ -126,19 +802,288 @@ namespace luke
         };
         m_context->VSSetConstantBuffers(0, 1, pptr); */
 
-        m_context->VSSetConstantBuffers(0, 1, m_mesh->m_constantBuffer.GetAddressOf());
-        m_context->PSSetShader(m_colorPixelShader.Get(), 0, 0);
+        RenderMesh(*m_resources.m_meshes.Get(m_mesh), m_modelObject);
+
+        if (m_drawStreamedWorld) {
+            for (uint32_t cell : m_worldStreamer.GetResidentCells())
+                RenderMesh(*m_resources.m_meshes.Get(m_streamedCells[cell].mesh), m_identityObject);
+        }
+
+        if (m_drawCrowd) {
+            for (size_t i = 0; i < m_crowdMeshes.size(); i++)
+                RenderMesh(*m_resources.m_meshes.Get(m_crowdMeshes[i]), m_crowdFirstObject + UINT(i));
+        }
+
+        // 가려진 물체는 버텍스 쉐이더까지 가기 전에 건너뜀
+        if (m_drawOcclusionScene) {
+            for (size_t i = 0; i < m_sceneObjects.size(); i++) {
+                if (m_sceneVisible[i])
+                    RenderMesh(*m_resources.m_meshes.Get(m_sceneObjects[i].mesh), m_sceneObjectSlots[i]);
+            }
+        }
+
+        // 반투명이므로 불투명한 물체를 모두 그린 뒤에
+        if (m_drawParticles)
+            RenderParticles();
+    }
 
-        m_context->RSSetState(m_rasterizerSate.Get());
+    void Application::RenderMesh(const Mesh &mesh, UINT object)
+    {
+        BindObjectConstants(m_context.Get(), m_context1.Get(), m_drawConstantBuffers[0].Get(), object);
 
         // 버텍스/인덱스 버퍼 설정
         UINT stride = sizeof(Vertex);
         UINT offset = 0;
-        m_context->IASetInputLayout(m_colorInputLayout.Get());
-        m_context->IASetVertexBuffers(0, 1, m_mesh->m_vertexBuffer.GetAddressOf(), &stride, &offset);
-        m_context->IASetIndexBuffer(m_mesh->m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
-        m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        m_context->DrawIndexed(m_indexCount, 0, 0);
+        m_context->IASetVertexBuffers(0, 1, mesh.m_vertexBuffer.GetAddressOf(), &stride, &offset);
+        m_context->IASetIndexBuffer(mesh.m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
+        m_context->DrawIndexed(mesh.m_indexCount, 0, 0);
+
+        if (m_recordingCommands) {
+            m_commandCapture.SetVertexBuffer(GetCaptureBufferId(mesh.m_vertexBuffer.Get()), stride);
+            m_commandCapture.SetIndexBuffer(GetCaptureBufferId(mesh.m_indexBuffer.Get()));
+            m_commandCapture.DrawIndexed(mesh.m_indexCount, 0, 0);
+        }
+    }
+
+    void Application::RenderViews()
+    {
+        const uint32_t viewCount = uint32_t(m_viewCount);
+        const auto start = chrono::high_resolution_clock::now();
+
+        float clearColor[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        m_context->ClearRenderTargetView(m_renderTargetView.Get(), clearColor);
+        m_context->ClearDepthStencilView(m_depthStencilView.Get(),
+                                         D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+
+        // 뷰마다 프레임 상수는 RecordView()에서 올리고, 패스 상수(뷰포트)는 여기서 한 번에 올림
+        D3D11_VIEWPORT viewports[kMaxViews];
+        for (uint32_t v = 0; v < viewCount; v++) {
+            const RenderView &renderView = m_views[v];
+            viewports[v] = m_screenViewport;
+            viewports[v].TopLeftX += renderView.x * m_screenViewport.Width;
+            viewports[v].TopLeftY += renderView.y * m_screenViewport.Height;
+            viewports[v].Width *= renderView.width;
+            viewports[v].Height *= renderView.height;
+        }
+        UploadPassConstants(viewports, viewCount);
+
+        // 뷰마다 디퍼드 컨텍스트 하나씩 병렬로 기록 (클러스터는 메인 카메라 기준이므로 조명 없이)
+        const int permutation = (m_useGrayscale ? 2 : 0) + (m_useWireframe ? 1 : 0);
+        const PipelineState &pipeline = *m_pipelineStates.Get(m_colorPipelines[permutation]);
+        if (m_recordingCommands) {
+            // 명령 캡처는 한 스레드에서만 기록하므로 캡처하는 프레임은 뷰 순서대로
+            for (uint32_t v = 0; v < viewCount; v++) {
+                m_commandCapture.SetPipeline(m_colorPipelines[permutation].value);
+                RecordView(v, pipeline);
+            }
+        } else {
+            m_jobSystem.ParallelFor(viewCount, 1, [&](size_t begin, size_t end) {
+                for (size_t v = begin; v < end; v++)
+                    RecordView(uint32_t(v), pipeline);
+            });
+        }
+        m_recordMs = chrono::duration<float, milli>(chrono::high_resolution_clock::now() - start).count();
+
+        // 제출은 즉시 컨텍스트에서 뷰 순서대로
+        for (uint32_t v = 0; v < viewCount; v++) {
+            if (m_commandLists[v]) {
+                m_context->ExecuteCommandList(m_commandLists[v].Get(), FALSE);
+                m_commandLists[v].Reset();
+            }
+        }
+
+        // ExecuteCommandList(..., FALSE)는 상태를 기본값으로 되돌리므로 GUI가 그릴 타겟을 다시 설정
+        m_context->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+        m_context->RSSetViewports(1, &m_screenViewport);
+    }
+
+    void Application::RecordView(uint32_t viewIndex, const PipelineState &pipeline)
+    {
+        ID3D11DeviceContext *context = m_deferredContexts[viewIndex].Get();
+        ID3D11DeviceContext1 *context1 = m_deferredContexts1[viewIndex].Get();
+        ID3D11Buffer *drawBuffer = m_drawConstantBuffers[viewIndex].Get();
+        ID3D11Buffer *constantBuffer = m_viewConstantBuffers[viewIndex].Get();
+        const RenderView &renderView = m_views[viewIndex];
+
+        // 칸의 영역 (동적 해상도가 켜져 있으면 m_screenViewport가 축소된 영역)
+        D3D11_VIEWPORT viewport = m_screenViewport;
+        viewport.TopLeftX += renderView.x * m_screenViewport.Width;
+        viewport.TopLeftY += renderView.y * m_screenViewport.Height;
+        viewport.Width *= renderView.width;
+        viewport.Height *= renderView.height;
+
+        context->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), m_depthStencilView.Get());
+        context->RSSetViewports(1, &viewport);
+        pipeline.Bind(context);
+
+        // 이 뷰의 카메라는 뷰마다 한 번만 올림
+        // 디퍼드 컨텍스트의 WRITE_DISCARD는 컨텍스트마다 따로 버퍼 이름을 바꾸므로 다른 뷰와 겹치지 않음
+        // (캡처 중이면 RenderViews()가 이 함수를 메인 스레드에서 차례로 부름)
+        const FrameConstants constants =
+            MakeFrameConstants(renderView.view, renderView.projection, m_frameConstantData.time,
+                               m_frameConstantData.deltaTime);
+        D3D11_MAPPED_SUBRESOURCE ms;
+        if (FAILED(context->Map(constantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &ms)))
+            return;
+        memcpy(ms.pData, &constants, sizeof(constants));
+        context->Unmap(constantBuffer, 0);
+        if (m_recordingCommands)
+            m_commandCapture.UpdateBuffer(GetCaptureBufferId(constantBuffer), &constants, sizeof(constants));
+        BindFrameConstants(context, context1, constantBuffer, viewIndex);
+
+        const Mesh *boundMesh = nullptr;
+        auto draw = [&](const Mesh &mesh, UINT object) {
+            // 물체 상수는 Update()에서 모든 뷰가 같이 쓰도록 올려 두었으므로 범위만 바꿈
+            BindObjectConstants(context, context1, drawBuffer, object);
+
+            // 같은 버텍스/인덱스 버퍼를 쓰는 물체가 이어지면 다시 설정하지 않음
+            if (!boundMesh || boundMesh->m_vertexBuffer != mesh.m_vertexBuffer) {
+                UINT stride = sizeof(Vertex);
+                UINT offset = 0;
+                context->IASetVertexBuffers(0, 1, mesh.m_vertexBuffer.GetAddressOf(), &stride, &offset);
+                context->IASetIndexBuffer(mesh.m_indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0);
+                if (m_recordingCommands) {
+                    m_commandCapture.SetVertexBuffer(GetCaptureBufferId(mesh.m_vertexBuffer.Get()), stride);
+                    m_commandCapture.SetIndexBuffer(GetCaptureBufferId(mesh.m_indexBuffer.Get()));
+                }
+            }
+            boundMesh = &mesh;
+            context->DrawIndexed(mesh.m_indexCount, 0, 0);
+            if (m_recordingCommands)
+                m_commandCapture.DrawIndexed(mesh.m_indexCount, 0, 0);
+        };
+
+        draw(*m_resources.m_meshes.Get(m_mesh), m_modelObject);
+        for (uint32_t i : m_multiViewCuller.GetDrawList(viewIndex))
+            draw(*m_resources.m_meshes.Get(m_sceneObjects[i].mesh), m_sceneObjectSlots[i]);
+
+        context->FinishCommandList(FALSE, m_commandLists[viewIndex].ReleaseAndGetAddressOf());
+    }
+
+    bool Application::RenderImageBatch(const std::filesystem::path &directory, uint32_t count,
+                                       ImageFormat format)
+    {
+        if (!IsOffscreen())
+        {
+            cout << "RenderImageBatch() needs an offscreen Initialize()." << endl;
+            return false;
+        }
+
+        error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
+        {
+            cout << "Cannot create " << directory.string() << endl;
+            return false;
+        }
+
+        const OffscreenStats before = GetOffscreenStats();
+        const float startRotation = m_modelRotation.y;
+        const auto start = chrono::high_resolution_clock::now();
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            m_modelRotation.y = startRotation + DirectX::XM_2PI * i / count;
+            char name[32];
+            snprintf(name, sizeof(name), "frame_%04u", i);
+            SetOffscreenOutput(directory / name, format);
+            Run();
+        }
+        FlushOffscreen();
+
+        const double seconds =
+            chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        const OffscreenStats &stats = GetOffscreenStats();
+        cout << stats.framesWritten - before.framesWritten << " images in " << seconds * 1000.0
+             << " ms (" << (seconds > 0.0 ? count / seconds : 0.0) << " images/s), readback stalls "
+             << stats.readbackStalls - before.readbackStalls << endl;
+
+        m_modelRotation.y = startRotation;
+        SetOffscreenOutput({}, format);
+        return m_imageWriter->GetStats().failed == 0;
+    }
+
+    void Application::UpdateStreamingGUI()
+    {
+        if (!ImGui::CollapsingHeader("World Streaming"))
+            return;
+
+        if (ImGui::Checkbox("m_drawStreamedWorld", &m_drawStreamedWorld)) {
+            if (m_drawStreamedWorld && m_worldStreamer.GetCellCount() == 0)
+                InitWorldStreaming();
+        }
+        if (!m_drawStreamedWorld || m_worldStreamer.GetCellCount() == 0)
+            return;
+
+        ImGui::SliderFloat("m_flySpeed", &m_flySpeed, 0.0f, 20.0f);
+        ImGui::DragFloat3("Eye (world)", &m_viewEyePos.x, 0.1f);
+
+        WorldStreamingSettings settings = m_worldStreamer.GetSettings();
+        float budgetMB = float(settings.memoryBudget >> 20);
+        bool changed = ImGui::SliderFloat("Load radius", &settings.loadRadius, 4.0f, 40.0f);
+        changed |= ImGui::SliderFloat("Unload radius", &settings.unloadRadius, 4.0f, 48.0f);
+        changed |= ImGui::SliderFloat("Direction weight", &settings.directionWeight, 0.0f, 1.0f);
+        changed |= ImGui::SliderFloat("Budget MB", &budgetMB, 1.0f, 256.0f);
+        if (changed) {
+            settings.memoryBudget = uint64_t(budgetMB) << 20;
+            m_worldStreamer.SetSettings(settings);
+        }
+
+        const WorldStreamingStats &stats = m_worldStreamer.GetStats();
+        ImGui::Text("Cells resident %u, loading %u, waiting %u", stats.residentCells, stats.loadingCells,
+                    stats.waitingCells);
+        ImGui::Text("Resident %.1f MB (peak %.1f MB), uploaded %.1f KB this frame",
+                    stats.residentBytes / (1024.0f * 1024.0f), stats.peakResidentBytes / (1024.0f * 1024.0f),
+                    stats.uploadBytesThisFrame / 1024.0f);
+        ImGui::Text("Loads %llu, unloads %llu, evictions %llu, cancelled %llu",
+                    (unsigned long long)stats.loads, (unsigned long long)stats.unloads,
+                    (unsigned long long)stats.evictions, (unsigned long long)stats.cancelledLoads);
+        ImGui::Text("Stall frames %llu / %llu (missing now %u)", (unsigned long long)stats.stallFrames,
+                    (unsigned long long)stats.frames, stats.missingRequiredCells);
+    }
+
+    void Application::UpdateCrowdGUI()
+    {
+        if (!ImGui::CollapsingHeader("Animated Crowd"))
+            return;
+
+        ImGui::Checkbox("m_drawCrowd", &m_drawCrowd);
+        ImGui::SliderInt("m_crowdCount", &m_crowdCount, 1, 512);
+        ImGui::SliderFloat("m_crowdSpeed (walk - run)", &m_crowdSpeed, 0.0f, 1.0f);
+
+        const CrowdStats &stats = m_crowd.GetStats();
+        ImGui::Text("Pose %.3f ms, skin %.3f ms (%llu vertices)", stats.poseMs, stats.skinMs,
+                    (unsigned long long)stats.skinnedVertices);
+        ImGui::Text("Clips %.1f KB + %.1f KB", m_walkClip.GetSizeBytes() / 1024.0f,
+                    m_runClip.GetSizeBytes() / 1024.0f);
+    }
+
+    void Application::UpdateParticlesGUI()
+    {
+        if (!ImGui::CollapsingHeader("Particles"))
+            return;
+
+        ImGui::Checkbox("m_drawParticles", &m_drawParticles);
+        const ParticleStats &stats = m_particles.GetStats();
+        ImGui::Text("Particles %llu in %u emitters (spawned %llu, killed %llu)",
+                    (unsigned long long)m_particles.GetParticleCount(), m_particles.GetEmitterCount(),
+                    (unsigned long long)stats.spawned, (unsigned long long)stats.killed);
+        ImGui::Text("Simulate %.3f ms, write instances %.3f ms (%.0f particles/ms)", stats.simulateMs,
+                    stats.writeMs, stats.simulateMs > 0.0 ? stats.simulated / stats.simulateMs : 0.0);
+    }
+
+    void Application::UpdateLightingGUI()
+    {
+        if (!ImGui::CollapsingHeader("Clustered lighting"))
+            return;
+
+        ImGui::Checkbox("m_useClusteredLighting", &m_useClusteredLighting);
+        ImGui::SliderInt("m_lightCount", &m_lightCount, 0, 4096);
+        const LightBinningStats &stats = m_lightGrid.GetStats();
+        ImGui::Text("Clusters %u, visible lights %u / %u", m_lightGrid.GetClusterCount(), stats.visibleLights,
+                    stats.lightCount);
+        ImGui::Text("Bin %.3f ms, indices %u, max %u per cluster, %u clusters lit", stats.binMs, stats.indexCount,
+                    stats.maxClusterLights, stats.occupiedClusters);
     }
 
     void Application::UpdateGUI()
@@ -157,6 +1102,148 @@ namespace luke
         ImGui::SliderFloat("m_nearZ", &m_nearZ, 0.01f, 10.0f);
         ImGui::SliderFloat("m_farZ", &m_farZ, 0.01f, 10.0f);
         ImGui::SliderFloat("m_aspect", &m_aspect, 1.0f, 3.0f);
+
+        ImGui::Checkbox("m_useGrayscale", &m_useGrayscale);
+        ImGui::Checkbox("m_useWireframe", &m_useWireframe);
+        {
+            const PipelineCacheStats &stats = m_pipelineStates.GetStats();
+            ImGui::Text("Pipelines %u (shaders %u), hits %u, misses %u, prewarm %.3f ms",
+                        stats.pipelineCount, stats.shaderCount, stats.hits, stats.misses,
+                        stats.prewarmMs);
+        }
+
+        ImGui::Checkbox("m_drawOcclusionScene", &m_drawOcclusionScene);
+        ImGui::Checkbox("m_useOcclusionCulling", &m_useOcclusionCulling);
+        ImGui::SliderInt("m_viewCount", &m_viewCount, 1, int(kMaxViews));
+        if (IsMultiViewFrame()) {
+            // 여러 뷰에서는 오클루전 컬링 대신 모든 뷰의 절두체 컬링을 한 번에 함
+            const MultiViewStats &stats = m_multiViewCuller.GetStats();
+            ImGui::Text("Views %u: visible %u / %u (union rejected %u)", stats.viewCount,
+                        stats.visibleObjects, stats.testedObjects, stats.unionRejected);
+            ImGui::Text("Cull %.3f ms, lists %.3f ms, record %.3f ms", stats.cullMs, stats.buildMs,
+                        m_recordMs);
+        }
+        else if (m_drawOcclusionScene && m_useOcclusionCulling) {
+            const OcclusionStats &stats = m_occlusionCuller.GetStats();
+            const float rejectedRatio =
+                stats.testedBoxes > 0 ? float(stats.rejectedBoxes) / stats.testedBoxes : 0.0f;
+            ImGui::Text("Occlusion rejected %u / %u (%.1f%%)", stats.rejectedBoxes,
+                        stats.testedBoxes, rejectedRatio * 100.0f);
+            ImGui::Text("Occluder raster %.3f ms (%u tris), Hi-Z %.3f ms, test %.3f ms",
+                        stats.rasterizeMs, stats.occluderTriangles, stats.hierarchyMs,
+                        stats.testMs);
+        }
+
+        UpdateStreamingGUI();
+        UpdateCrowdGUI();
+        UpdateParticlesGUI();
+        UpdateLightingGUI();
+
+        // 다음 프레임의 명령을 저장 (Graphics_Benchmark --replay FILE로 재생)
+        if (ImGui::Button("Capture commands")) {
+            std::error_code error;
+            filesystem::create_directories("captures", error);
+            RequestCommandCapture(filesystem::path("captures") /
+                                  ("frame_" + to_string(m_frameIndex) + ".lcap"));
+        }
+
+        if (ImGui::CollapsingHeader("Memory")) {
+            for (uint32_t i = 0; i < uint32_t(MemoryCategory::Count); i++) {
+                const MemoryCategory category = MemoryCategory(i);
+                ImGui::Text("%-10s current %8.1f KB  peak %8.1f KB  allocs %llu",
+                            GetMemoryCategoryName(category),
+                            MemoryTracker::GetCurrentBytes(category) / 1024.0f,
+                            MemoryTracker::GetPeakBytes(category) / 1024.0f,
+                            (unsigned long long)MemoryTracker::GetAllocationCount(category));
+            }
+            ImGui::Text("Frame arena peak %.1f KB / %.1f KB", m_frameArena.GetPeakBytes() / 1024.0f,
+                        m_frameArena.GetCapacity() / 1024.0f);
+            ImGui::Text("Resources: meshes %zu, buffers %zu, shaders %zu",
+                        m_resources.m_meshes.GetCount(), m_resources.m_buffers.GetCount(),
+                        m_resources.m_shaders.GetCount());
+
+            if (ImGui::Button("Run allocator benchmark"))
+                m_allocatorBenchmark = RunAllocatorBenchmark(10000);
+            if (m_allocatorBenchmark.iterations > 0) {
+                ImGui::Text("MeshData: default %.3f ms, arena %.3f ms",
+                            m_allocatorBenchmark.meshDataDefaultMs, m_allocatorBenchmark.meshDataArenaMs);
+                ImGui::Text("Object: make_shared %.3f ms, pool %.3f ms",
+                            m_allocatorBenchmark.objectMakeSharedMs, m_allocatorBenchmark.objectPoolMs);
+            }
+
+            if (ImGui::Button("Run handle benchmark"))
+                m_handleBenchmark = RunHandleBenchmark(100000);
+            if (m_handleBenchmark.count > 0) {
+                ImGui::Text("shared_ptr copy %.3f ms, deref %.3f ms", m_handleBenchmark.sharedPtrCopyMs,
+                            m_handleBenchmark.sharedPtrDerefMs);
+                ImGui::Text("handle lookup %.3f ms, dense iterate %.3f ms",
+                            m_handleBenchmark.handleLookupMs, m_handleBenchmark.denseIterateMs);
+            }
+        }
+
+        if (!IsOffscreen() && ImGui::CollapsingHeader("Dynamic Resolution")) {
+            bool enable = IsDynamicResolution();
+            if (ImGui::Checkbox("Enable", &enable))
+                SetDynamicResolution(enable);
+
+            DynamicResolutionSettings settings = m_dynamicResolution.GetSettings();
+            bool changed = ImGui::SliderFloat("Target ms", &settings.targetFrameMs, 4.0f, 50.0f);
+            changed |= ImGui::SliderFloat("Min scale", &settings.minScale, 0.25f, 1.0f);
+            changed |= ImGui::Checkbox("Adjust MSAA", &settings.adjustMsaa);
+            if (changed)
+                m_dynamicResolution.SetSettings(settings);
+
+            if (enable) {
+                uint32_t width, height;
+                m_dynamicResolution.GetRenderSize(m_screenWidth, m_screenHeight, width, height);
+                ImGui::Text("Render %ux%u (%.0f%%), MSAA %ux", width, height,
+                            m_dynamicResolution.GetScale() * 100.0f, m_dynamicResolution.GetMsaaSamples());
+                ImGui::Text("Average %.2f ms (CPU %.2f ms, GPU %.2f ms)",
+                            m_dynamicResolution.GetAverageFrameMs(), m_cpuFrameMs, m_gpuFrameMs);
+            }
+
+            // 최근 결정부터
+            const auto &log = m_dynamicResolution.GetLog();
+            for (auto it = log.rbegin(); it != log.rend() && it - log.rbegin() < 8; ++it)
+                ImGui::Text("frame %llu: %.2f -> %.2f, MSAA %u -> %u (%.2f ms)",
+                            (unsigned long long)it->frame, it->oldScale, it->newScale,
+                            it->oldMsaaSamples, it->newMsaaSamples, it->frameMs);
+        }
+
+        if (ImGui::CollapsingHeader("Capture")) {
+            const bool capturing = IsCapturing();
+            if (capturing)
+                ImGui::BeginDisabled();
+            ImGui::RadioButton("PNG", &m_captureFormat, int(ImageFormat::Png));
+            ImGui::SameLine();
+            ImGui::RadioButton("QOI", &m_captureFormat, int(ImageFormat::Qoi));
+            ImGui::SameLine();
+            ImGui::RadioButton("Raw", &m_captureFormat, int(ImageFormat::Raw));
+            if (capturing)
+                ImGui::EndDisabled();
+
+            bool capture = capturing;
+            if (ImGui::Checkbox("Capture frames to ./capture", &capture)) {
+                if (capture)
+                    StartCapture("capture", ImageFormat(m_captureFormat));
+                else
+                    StopCapture();
+            }
+
+            if (const ImageWriter *writer = GetImageWriter()) {
+                const ImageWriterStats stats = writer->GetStats();
+                const OffscreenStats &offscreen = GetOffscreenStats();
+                ImGui::Text("Written %llu, dropped %llu, skipped %llu, failed %llu",
+                            (unsigned long long)stats.written, (unsigned long long)stats.dropped,
+                            (unsigned long long)offscreen.framesSkipped, (unsigned long long)stats.failed);
+                ImGui::Text("Queue high water %u / %u, encoders %zu", stats.queueHighWater,
+                            stats.queueCapacity, writer->GetThreadCount());
+                if (stats.written > 0)
+                    ImGui::Text("Encode %.2f ms/image, write %.2f ms/image, %.1f MB",
+                                stats.encodeMs / stats.written, stats.writeMs / stats.written,
+                                stats.bytesOut / (1024.0 * 1024.0));
+            }
+        }
     }
 
 }
@@ -1,25 +1,41 @@
 ﻿#pragma once
 
 #include <algorithm>
+#include <d3d11_1.h>
 #include <directxtk/SimpleMath.h>
 #include <iostream>
 #include <vector>
 #include <memory>
 
+#include "Animation.h"
+#include "ClusteredLighting.h"
 #include "Graphics.h"
+#include "JobSystem.h"
 #include "MeshGenerator.h"
 #include "Mesh.h"
+#include "MemoryBenchmark.h"
+#include "HandleBenchmark.h"
+#include "MultiView.h"
+#include "OcclusionCuller.h"
+#include "ParticleSystem.h"
+#include "ShaderConstants.h"
+#include "WorldStreamer.h"
 
 namespace luke
 {
     using DirectX::SimpleMath::Matrix;
     using DirectX::SimpleMath::Vector3;
+    using DirectX::BoundingBox;
 
-    struct ModelViewProjectionConstantBuffer
+    // 메쉬 하나와 월드 변환을 묶은 장면 속 물체
+    // 같은 모양의 물체는 Mesh(Graphics::m_resources)를 공유하고, world는 프레임마다
+    // 물체 상수 버퍼(Application::m_objectConstantBuffer)에 올립니다.
+    struct SceneObject
     {
-        Matrix model;
-        Matrix view;
-        Matrix projection;
+        MeshHandle mesh;
+        Matrix world;
+        BoundingBox worldBounds;
+        bool isOccluder = false;
     };
 
     class Application : public Graphics
@@ -31,17 +47,82 @@ namespace luke
         virtual void UpdateGUI() override;
         virtual void Update(float dt) override;
         virtual void Render() override;
+        virtual void OnResize() override;
+
+        // 오프스크린 모드(Initialize()에 hwnd == nullptr)에서 모델을 한 바퀴 돌리며
+        // count장을 directory에 저장하고 초당 이미지 수를 출력합니다.
+        bool RenderImageBatch(const std::filesystem::path &directory, uint32_t count,
+                              ImageFormat format = ImageFormat::Png);
 
     protected:
-        ComPtr<ID3D11VertexShader> m_colorVertexShader;
-        ComPtr<ID3D11PixelShader> m_colorPixelShader;
-        ComPtr<ID3D11InputLayout> m_colorInputLayout;
-        std::shared_ptr<Mesh> m_mesh;
+        void CreateOcclusionScene();
+        void UpdateOcclusionCulling(const Matrix &view, const Matrix &projection);
+        void UpdateViews(const Matrix &view, const Matrix &projection);
+        // 물체 상수: Begin에서 한 번 Map하고 Add마다 256바이트씩 이어 씀. Add는 물체 번호를 반환
+        bool BeginObjectConstants(UINT count);
+        UINT AddObjectConstants(const Matrix &world);
+        void EndObjectConstants();
+        void UploadObjectConstants();
+        void UploadPassConstants(const D3D11_VIEWPORT *viewports, UINT count);
+        // b0(프레임), b3(pass번째 패스). context1이 nullptr이면 오프셋 바인딩 없이 (m_context1 참고)
+        void BindFrameConstants(ID3D11DeviceContext *context, ID3D11DeviceContext1 *context1,
+                                ID3D11Buffer *frameBuffer, UINT pass);
+        // 오프셋 바인딩이 없으면 object의 상수를 drawBuffer(컨텍스트마다 하나)에 Map해서 바인딩
+        void BindObjectConstants(ID3D11DeviceContext *context, ID3D11DeviceContext1 *context1,
+                                 ID3D11Buffer *drawBuffer, UINT object);
+        void RenderMesh(const Mesh &mesh, UINT object);
+        void RenderViews();
+        // Render()가 RenderViews()로 그리는 프레임인지 (뷰가 여럿이어도 오클루전 장면이 꺼져 있으면 한 뷰로 그림)
+        bool IsMultiViewFrame() const { return m_drawOcclusionScene && m_viewCount > 1; }
+        void RecordView(uint32_t viewIndex, const PipelineState &pipeline);
+        void InitWorldStreaming();
+        void UpdateStreamingGUI();
+        void InitCrowd();
+        void UpdateCrowd(float dt);
+        void UpdateCrowdGUI();
+        bool InitParticles();
+        void RenderParticles();
+        void UpdateParticlesGUI();
+        void UpdateLights(float dt, const Matrix &view, const Matrix &projection);
+        void UploadLightBuffer(ComPtr<ID3D11Buffer> &buffer, ComPtr<ID3D11ShaderResourceView> &view,
+                               UINT &capacity, UINT stride, const void *data, UINT count);
+        void BindLights();
+        void UpdateLightingGUI();
+
+        PipelineHandle m_colorPipelines[8]; // [lighting * 4 + grayscale * 2 + wireframe]
+        MeshHandle m_mesh;
         UINT m_indexCount;
 
-        ModelViewProjectionConstantBuffer m_constantBufferData;
+        // 상수는 갱신 빈도별로 나눔 (ShaderConstants.h)
+        // b0: 프레임 상수. 프레임에 한 번 (여러 뷰면 뷰마다 한 번) 올림
+        // b2: 물체 상수. 이번 프레임에 그릴 물체를 한 버퍼에 이어 붙여 Map 한 번으로 올리고,
+        //     그릴 때 VSSetConstantBuffers1로 그 물체의 256바이트만 바인딩
+        // b3: 패스 상수. 뷰마다 256바이트씩 한 버퍼
+        // D3D11.1의 ConstantBufferOffsetting이 없으면 m_context1은 nullptr이고, 물체 상수는 CPU에 모아 두었다가
+        // 드로우마다 m_drawConstantBuffers에 Map해서, 패스 상수는 뷰마다 따로 둔 버퍼로 바인딩
+        ComPtr<ID3D11DeviceContext1> m_context1;
+        FrameConstants m_frameConstantData;
+        Matrix m_model; // 가운데 모델의 world
+        float m_time = 0.0f;
+        ComPtr<ID3D11Buffer> m_frameConstantBuffer;
+        ComPtr<ID3D11Buffer> m_passConstantBuffer;
+        ComPtr<ID3D11Buffer> m_objectConstantBuffer;
+        UINT m_objectCapacity = 0;
+        UINT m_objectCount = 0;
+        UINT m_objectReserved = 0;
+        uint8_t *m_objectConstants = nullptr;     // Map ~ Unmap
+        std::vector<uint8_t> m_objectCaptureData; // 명령 캡처 중에만 사용
+        std::vector<uint8_t> m_objectConstantData;             // 오프셋 바인딩이 없을 때
+        ComPtr<ID3D11Buffer> m_drawConstantBuffers[kMaxViews]; // 오프셋 바인딩이 없을 때 (컨텍스트마다 하나)
+        ComPtr<ID3D11Buffer> m_passConstantBuffers[kMaxViews]; // 오프셋 바인딩이 없을 때 (패스마다 하나)
+        UINT m_modelObject = 0;
+        UINT m_identityObject = 0;                // 월드 좌표로 만든 메쉬 (스트리밍 셀)
+        UINT m_crowdFirstObject = 0;
+        std::vector<UINT> m_sceneObjectSlots;     // m_sceneObjects -> 물체 번호
 
         bool m_usePerspectiveProjection = true;
+        bool m_useGrayscale = false;
+        bool m_useWireframe = false;
         Vector3 m_modelTranslation = Vector3(0.0f);
         Vector3 m_modelRotation = Vector3(0.0f);
         Vector3 m_modelScaling = Vector3(0.5f);
@@ -52,5 +133,88 @@ namespace luke
         float m_nearZ = 0.01f;
         float m_farZ = 100.0f;
         float m_aspect = 0.0f;
+
+        // 오클루전 컬링 예제: 벽(가리개) 뒤에 큐브들을 배치
+        JobSystem m_jobSystem;
+        OcclusionCuller m_occlusionCuller;
+        MeshData m_occluderMeshData; // CPU 래스터화를 위해 보관
+        std::vector<SceneObject> m_sceneObjects;
+        std::vector<BoundingBox> m_occludeeBounds;
+        std::vector<size_t> m_occludeeIndices; // m_occludeeBounds[i] -> m_sceneObjects 인덱스
+        std::vector<uint8_t> m_sceneVisible;   // m_sceneObjects와 같은 크기
+        std::vector<uint8_t> m_occludeeVisible;
+        bool m_drawOcclusionScene = true;
+        bool m_useOcclusionCulling = true;
+
+        // 여러 뷰: 0번은 메인 카메라, 나머지는 장면 주위를 도는 카메라
+        // 컬링은 MultiViewCuller로 한 번만 하고, 뷰마다 디퍼드 컨텍스트에 병렬로 기록
+        int m_viewCount = 1;
+        RenderView m_views[kMaxViews];
+        MultiViewCuller m_multiViewCuller;
+        std::vector<BoundingBox> m_sceneBounds; // m_sceneObjects의 worldBounds
+        std::vector<ViewMask> m_viewMasks;
+        ComPtr<ID3D11DeviceContext> m_deferredContexts[kMaxViews];
+        ComPtr<ID3D11DeviceContext1> m_deferredContexts1[kMaxViews]; // 오프셋 바인딩이 없으면 nullptr
+        ComPtr<ID3D11CommandList> m_commandLists[kMaxViews];
+        ComPtr<ID3D11Buffer> m_viewConstantBuffers[kMaxViews]; // 뷰마다 FrameConstants
+        float m_recordMs = 0.0f;
+
+        AllocatorBenchmarkResult m_allocatorBenchmark;
+        HandleBenchmarkResult m_handleBenchmark;
+
+        int m_captureFormat = 0; // ImageFormat
+
+        // 스트리밍 월드: m_viewEyePos 주변의 셀만 작업 스레드에서 만들고 GPU에 올림
+        // (m_worldStreamer가 소멸하면서 Unload()를 부르므로 셀 저장소보다 뒤에 선언)
+        struct StreamedCell
+        {
+            MeshData meshData; // Load() ~ Upload() 사이에만 있음
+            MeshHandle mesh;
+        };
+        bool m_drawStreamedWorld = false;
+        float m_flySpeed = 0.0f; // m_viewEyeDir 방향으로 초당 이동 거리
+        std::vector<StreamedCell> m_streamedCells;
+        WorldStreamer m_worldStreamer;
+
+        // 스키닝 캐릭터 무리: 작업 스레드에서 스키닝한 버텍스를 캐릭터마다 동적 버텍스 버퍼에 복사
+        // (인덱스 버퍼는 모든 캐릭터가 공유)
+        bool m_drawCrowd = false;
+        int m_crowdCount = 32;
+        float m_crowdSpeed = 0.5f; // 0이면 모두 걷기, 1이면 모두 뛰기
+        SkinnedMeshData m_characterData;
+        AnimationClip m_walkClip;
+        AnimationClip m_runClip;
+        CrowdAnimator m_crowd;
+        ComPtr<ID3D11Buffer> m_crowdIndexBuffer;
+        std::vector<MeshHandle> m_crowdMeshes;
+
+        // 파티클: 이미터마다 동적 인스턴스 버퍼를 Map해서 바로 쓰고 인스턴스 드로우 한 번으로 그림
+        // (사각형 버텍스/인덱스 버퍼는 모든 이미터가 공유)
+        bool m_drawParticles = false;
+        ParticleSystem m_particles;
+        PipelineHandle m_particlePipeline;
+        ComPtr<ID3D11Buffer> m_particleVertexBuffer;
+        ComPtr<ID3D11Buffer> m_particleIndexBuffer;
+        std::vector<ComPtr<ID3D11Buffer>> m_particleInstanceBuffers;
+        std::vector<ParticleInstance> m_particleCaptureData; // 명령 캡처 중에만 사용
+        UINT m_particleIndexCount = 0;
+
+        // 클러스터 조명: 매 프레임 빛을 움직이고 CPU에서 클러스터에 분류한 뒤 목록을 구조화 버퍼로 올림
+        // 버퍼는 모자랄 때만 1.5배로 다시 만듦 (여러 뷰 모드에서는 조명 없이 그림)
+        bool m_useClusteredLighting = false;
+        int m_lightCount = 256;
+        float m_lightTime = 0.0f;
+        std::vector<Light> m_lights;
+        LightClusterGrid m_lightGrid;
+        ComPtr<ID3D11Buffer> m_clusterConstantBuffer;
+        ComPtr<ID3D11Buffer> m_lightBuffer;
+        ComPtr<ID3D11Buffer> m_clusterBuffer;
+        ComPtr<ID3D11Buffer> m_lightIndexBuffer;
+        ComPtr<ID3D11ShaderResourceView> m_lightView;
+        ComPtr<ID3D11ShaderResourceView> m_clusterView;
+        ComPtr<ID3D11ShaderResourceView> m_lightIndexView;
+        UINT m_lightCapacity = 0;
+        UINT m_clusterCapacity = 0;
+        UINT m_lightIndexCapacity = 0;
     };
 } // namespace hlab
\ No newline at end of file
@@ -0,0 +1,570 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        // BC7 4비트 인덱스의 보간 가중치 (/64)
+        constexpr int kBC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        // 128비트를 LSB부터 채우거나 읽음
+        struct BitStream {
+            uint64_t bits[2] = {0, 0};
+            uint32_t position = 0;
+
+            void Write(uint32_t value, uint32_t count)
+            {
+                for (uint32_t i = 0; i < count; i++, position++)
+                    bits[position >> 6] |= uint64_t((value >> i) & 1) << (position & 63);
+            }
+            uint32_t Read(uint32_t count)
+            {
+                uint32_t value = 0;
+                for (uint32_t i = 0; i < count; i++, position++)
+                    value |= uint32_t((bits[position >> 6] >> (position & 63)) & 1) << i;
+                return value;
+            }
+        };
+
+        template <int N>
+        void PrincipalAxis(const float (&covariance)[N][N], const float (&initial)[N], float (&axis)[N])
+        {
+            for (int i = 0; i < N; i++)
+                axis[i] = initial[i];
+            // 거듭제곱법: 공분산을 몇 번 곱하면 가장 큰 고유벡터 쪽으로 수렴
+            for (int iteration = 0; iteration < 8; iteration++) {
+                float next[N] = {};
+                for (int r = 0; r < N; r++)
+                    for (int c = 0; c < N; c++)
+                        next[r] += covariance[r][c] * axis[c];
+                float largest = 0.0f;
+                for (int i = 0; i < N; i++)
+                    largest = max(largest, fabs(next[i]));
+                if (largest < 1e-8f)
+                    break;
+                for (int i = 0; i < N; i++)
+                    axis[i] = next[i] / largest;
+            }
+            float length = 0.0f;
+            for (int i = 0; i < N; i++)
+                length += axis[i] * axis[i];
+            length = sqrt(length);
+            for (int i = 0; i < N; i++)
+                axis[i] = length > 1e-8f ? axis[i] / length : 1.0f / sqrt(float(N));
+        }
+
+        // 16픽셀의 처음 N개 채널에 대해 평균과 주성분 축
+        template <int N>
+        void FitLine(const uint8_t *rgba, float (&mean)[N], float (&axis)[N])
+        {
+            for (int c = 0; c < N; c++) {
+                mean[c] = 0.0f;
+                for (int i = 0; i < 16; i++)
+                    mean[c] += rgba[i * 4 + c];
+                mean[c] /= 16.0f;
+            }
+
+            float covariance[N][N] = {};
+            float low[N], high[N];
+            for (int c = 0; c < N; c++) {
+                low[c] = 255.0f;
+                high[c] = 0.0f;
+            }
+            for (int i = 0; i < 16; i++) {
+                float d[N];
+                for (int c = 0; c < N; c++) {
+                    d[c] = rgba[i * 4 + c] - mean[c];
+                    low[c] = min(low[c], float(rgba[i * 4 + c]));
+                    high[c] = max(high[c], float(rgba[i * 4 + c]));
+                }
+                for (int r = 0; r < N; r++)
+                    for (int c = 0; c < N; c++)
+                        covariance[r][c] += d[r] * d[c];
+            }
+
+            // 시작 벡터는 채널별 범위 (회색조 블록에서도 바로 맞는 방향)
+            float initial[N];
+            for (int c = 0; c < N; c++)
+                initial[c] = high[c] - low[c] + 1e-3f;
+            PrincipalAxis(covariance, initial, axis);
+        }
+
+        uint16_t Pack565(const float *color)
+        {
+            const int r = clamp(int(color[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+            const int g = clamp(int(color[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+            const int b = clamp(int(color[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+            return uint16_t((r << 11) | (g << 5) | b);
+        }
+
+        void Unpack565(uint16_t value, int *color)
+        {
+            const int r = (value >> 11) & 31;
+            const int g = (value >> 5) & 63;
+            const int b = value & 31;
+            color[0] = (r << 3) | (r >> 2);
+            color[1] = (g << 2) | (g >> 4);
+            color[2] = (b << 3) | (b >> 2);
+        }
+
+        // 4색 모드 팔레트 (c0 > c1)
+        void MakeColorPalette(uint16_t c0, uint16_t c1, int (&palette)[4][3])
+        {
+            Unpack565(c0, palette[0]);
+            Unpack565(c1, palette[1]);
+            for (int c = 0; c < 3; c++) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+        }
+
+        int FitColorIndices(const uint8_t *rgba, uint16_t c0, uint16_t c1, uint8_t (&indices)[16])
+        {
+            int palette[4][3];
+            MakeColorPalette(c0, c1, palette);
+            int total = 0;
+            for (int i = 0; i < 16; i++) {
+                int best = 0, bestError = INT32_MAX;
+                for (int p = 0; p < 4; p++) {
+                    int error = 0;
+                    for (int c = 0; c < 3; c++) {
+                        const int d = rgba[i * 4 + c] - palette[p][c];
+                        error += d * d;
+                    }
+                    if (error < bestError) {
+                        bestError = error;
+                        best = p;
+                    }
+                }
+                indices[i] = uint8_t(best);
+                total += bestError;
+            }
+            return total;
+        }
+
+        void EncodeColorBlock(const uint8_t *rgba, uint8_t *block)
+        {
+            float mean[3], axis[3];
+            FitLine<3>(rgba, mean, axis);
+
+            float minT = FLT_MAX, maxT = -FLT_MAX;
+            for (int i = 0; i < 16; i++) {
+                float t = 0.0f;
+                for (int c = 0; c < 3; c++)
+                    t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+                minT = min(minT, t);
+                maxT = max(maxT, t);
+            }
+            // 양 끝을 조금 안쪽으로 (중간색 두 개가 실제 분포에 더 잘 맞음)
+            const float inset = (maxT - minT) / 16.0f;
+            minT += inset;
+            maxT -= inset;
+
+            float e0[3], e1[3];
+            for (int c = 0; c < 3; c++) {
+                e0[c] = mean[c] + axis[c] * maxT;
+                e1[c] = mean[c] + axis[c] * minT;
+            }
+            uint16_t c0 = Pack565(e0), c1 = Pack565(e1);
+            uint8_t indices[16];
+            int error = FitColorIndices(rgba, c0, c1, indices);
+
+            // 고른 인덱스로 끝점을 최소제곱으로 다시 구함 (p = a * e0 + b * e1)
+            {
+                constexpr float kWeight[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+                float aa = 0.0f, ab = 0.0f, bb = 0.0f, ap[3] = {}, bp[3] = {};
+                for (int i = 0; i < 16; i++) {
+                    const float a = kWeight[indices[i]];
+                    const float b = 1.0f - a;
+                    aa += a * a;
+                    ab += a * b;
+                    bb += b * b;
+                    for (int c = 0; c < 3; c++) {
+                        ap[c] += a * rgba[i * 4 + c];
+                        bp[c] += b * rgba[i * 4 + c];
+                    }
+                }
+                const float determinant = aa * bb - ab * ab;
+                if (fabs(determinant) > 1e-6f) {
+                    float r0[3], r1[3];
+                    for (int c = 0; c < 3; c++) {
+                        r0[c] = (ap[c] * bb - bp[c] * ab) / determinant;
+                        r1[c] = (bp[c] * aa - ap[c] * ab) / determinant;
+                    }
+                    const uint16_t refined0 = Pack565(r0), refined1 = Pack565(r1);
+                    uint8_t refinedIndices[16];
+                    const int refinedError = FitColorIndices(rgba, refined0, refined1, refinedIndices);
+                    if (refinedError < error) {
+                        c0 = refined0;
+                        c1 = refined1;
+                        error = refinedError;
+                        memcpy(indices, refinedIndices, sizeof(indices));
+                    }
+                }
+            }
+
+            // 4색 모드는 c0 > c1이어야 함
+            if (c0 < c1) {
+                swap(c0, c1);
+                for (uint8_t &index : indices)
+                    index ^= 1; // 0 <-> 1, 2 <-> 3
+            }
+            else if (c0 == c1) {
+                memset(indices, 0, sizeof(indices));
+            }
+
+            uint32_t packed = 0;
+            for (int i = 0; i < 16; i++)
+                packed |= uint32_t(indices[i]) << (i * 2);
+            block[0] = uint8_t(c0);
+            block[1] = uint8_t(c0 >> 8);
+            block[2] = uint8_t(c1);
+            block[3] = uint8_t(c1 >> 8);
+            memcpy(block + 4, &packed, 4);
+        }
+
+        void DecodeColorBlock(const uint8_t *block, uint8_t *rgba, bool allowTransparent)
+        {
+            const uint16_t c0 = uint16_t(block[0] | (block[1] << 8));
+            const uint16_t c1 = uint16_t(block[2] | (block[3] << 8));
+            int palette[4][3];
+            int alpha[4] = {255, 255, 255, 255};
+            MakeColorPalette(c0, c1, palette);
+            if (c0 <= c1) {
+                // 3색 모드: 중간색 하나와 검은색(투명)
+                for (int c = 0; c < 3; c++) {
+                    palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                    palette[3][c] = 0;
+                }
+                if (allowTransparent)
+                    alpha[3] = 0;
+            }
+            uint32_t packed;
+            memcpy(&packed, block + 4, 4);
+            for (int i = 0; i < 16; i++) {
+                const uint32_t index = (packed >> (i * 2)) & 3;
+                for (int c = 0; c < 3; c++)
+                    rgba[i * 4 + c] = uint8_t(palette[index][c]);
+                rgba[i * 4 + 3] = uint8_t(alpha[index]);
+            }
+        }
+
+        // BC4 (8단계: a0 > a1)
+        void EncodeAlphaBlock(const uint8_t *rgba, uint8_t *block)
+        {
+            int low = 255, high = 0;
+            for (int i = 0; i < 16; i++) {
+                low = min(low, int(rgba[i * 4 + 3]));
+                high = max(high, int(rgba[i * 4 + 3]));
+            }
+            block[0] = uint8_t(high);
+            block[1] = uint8_t(low);
+
+            uint64_t packed = 0;
+            if (high > low) {
+                int palette[8];
+                palette[0] = high;
+                palette[1] = low;
+                for (int i = 2; i < 8; i++)
+                    palette[i] = ((8 - i) * high + (i - 1) * low) / 7;
+                for (int i = 0; i < 16; i++) {
+                    const int value = rgba[i * 4 + 3];
+                    int best = 0, bestError = INT32_MAX;
+                    for (int p = 0; p < 8; p++) {
+                        const int error = abs(value - palette[p]);
+                        if (error < bestError) {
+                            bestError = error;
+                            best = p;
+                        }
+                    }
+                    packed |= uint64_t(best) << (i * 3);
+                }
+            }
+            for (int i = 0; i < 6; i++)
+                block[2 + i] = uint8_t(packed >> (i * 8));
+        }
+
+        void DecodeAlphaBlock(const uint8_t *block, uint8_t *rgba)
+        {
+            const int a0 = block[0], a1 = block[1];
+            int palette[8] = {a0, a1};
+            if (a0 > a1) {
+                for (int i = 2; i < 8; i++)
+                    palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+            }
+            else {
+                for (int i = 2; i < 6; i++)
+                    palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+            uint64_t packed = 0;
+            for (int i = 0; i < 6; i++)
+                packed |= uint64_t(block[2 + i]) << (i * 8);
+            for (int i = 0; i < 16; i++)
+                rgba[i * 4 + 3] = uint8_t(palette[(packed >> (i * 3)) & 7]);
+        }
+
+        int InterpolateBC7(int e0, int e1, int weight) { return ((64 - weight) * e0 + weight * e1 + 32) >> 6; }
+
+        // 끝점(8비트, p비트 포함)이 정해졌을 때 픽셀마다 가장 가까운 인덱스
+        int FitBC7Indices(const uint8_t *rgba, const int (&e0)[4], const int (&e1)[4], uint8_t (&indices)[16])
+        {
+            int palette[16][4];
+            for (int w = 0; w < 16; w++)
+                for (int c = 0; c < 4; c++)
+                    palette[w][c] = InterpolateBC7(e0[c], e1[c], kBC7Weights4[w]);
+
+            int total = 0;
+            for (int i = 0; i < 16; i++) {
+                int best = 0, bestError = INT32_MAX;
+                for (int w = 0; w < 16; w++) {
+                    int error = 0;
+                    for (int c = 0; c < 4; c++) {
+                        const int d = rgba[i * 4 + c] - palette[w][c];
+                        error += d * d;
+                    }
+                    if (error < bestError) {
+                        bestError = error;
+                        best = w;
+                    }
+                }
+                indices[i] = uint8_t(best);
+                total += bestError;
+            }
+            return total;
+        }
+
+        void EncodeBC7Mode6(const uint8_t *rgba, uint8_t *block)
+        {
+            float mean[4], axis[4];
+            FitLine<4>(rgba, mean, axis);
+
+            float minT = FLT_MAX, maxT = -FLT_MAX;
+            for (int i = 0; i < 16; i++) {
+                float t = 0.0f;
+                for (int c = 0; c < 4; c++)
+                    t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+                minT = min(minT, t);
+                maxT = max(maxT, t);
+            }
+
+            // p비트 네 가지 조합을 모두 해보고 오차가 가장 작은 것
+            int bestError = INT32_MAX;
+            int bestQ0[4] = {}, bestQ1[4] = {}, bestP0 = 0, bestP1 = 0;
+            uint8_t bestIndices[16] = {};
+            for (int p0 = 0; p0 < 2; p0++) {
+                for (int p1 = 0; p1 < 2; p1++) {
+                    int q0[4], q1[4], e0[4], e1[4];
+                    for (int c = 0; c < 4; c++) {
+                        const float v0 = mean[c] + axis[c] * minT;
+                        const float v1 = mean[c] + axis[c] * maxT;
+                        q0[c] = clamp(int((v0 - p0) / 2.0f + 0.5f), 0, 127);
+                        q1[c] = clamp(int((v1 - p1) / 2.0f + 0.5f), 0, 127);
+                        e0[c] = (q0[c] << 1) | p0;
+                        e1[c] = (q1[c] << 1) | p1;
+                    }
+                    uint8_t indices[16];
+                    const int error = FitBC7Indices(rgba, e0, e1, indices);
+                    if (error < bestError) {
+                        bestError = error;
+                        memcpy(bestQ0, q0, sizeof(q0));
+                        memcpy(bestQ1, q1, sizeof(q1));
+                        bestP0 = p0;
+                        bestP1 = p1;
+                        memcpy(bestIndices, indices, sizeof(indices));
+                    }
+                }
+            }
+
+            // 첫 픽셀 인덱스의 최상위 비트는 저장하지 않으므로 0이 되도록 끝점을 바꿈
+            if (bestIndices[0] & 8) {
+                swap(bestQ0, bestQ1);
+                swap(bestP0, bestP1);
+                for (uint8_t &index : bestIndices)
+                    index = uint8_t(15 - index);
+            }
+
+            BitStream stream;
+            stream.Write(1u << 6, 7); // 모드 6
+            for (int c = 0; c < 4; c++) {
+                stream.Write(uint32_t(bestQ0[c]), 7);
+                stream.Write(uint32_t(bestQ1[c]), 7);
+            }
+            stream.Write(uint32_t(bestP0), 1);
+            stream.Write(uint32_t(bestP1), 1);
+            stream.Write(bestIndices[0], 3);
+            for (int i = 1; i < 16; i++)
+                stream.Write(bestIndices[i], 4);
+            memcpy(block, stream.bits, 16);
+        }
+
+        void GatherBlock(uint32_t width, uint32_t height, const uint8_t *rgba, uint32_t blockX, uint32_t blockY,
+                         uint8_t (&pixels)[64])
+        {
+            for (uint32_t y = 0; y < 4; y++) {
+                const uint32_t sourceY = min(blockY * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; x++) {
+                    const uint32_t sourceX = min(blockX * 4 + x, width - 1);
+                    memcpy(&pixels[(y * 4 + x) * 4], &rgba[(size_t(sourceY) * width + sourceX) * 4], 4);
+                }
+            }
+        }
+    }
+
+    const char *GetTextureFormatName(TextureFormat format)
+    {
+        switch (format) {
+        case TextureFormat::RGBA8:
+            return "rgba8";
+        case TextureFormat::BC1:
+            return "bc1";
+        case TextureFormat::BC3:
+            return "bc3";
+        case TextureFormat::BC7:
+            return "bc7";
+        }
+        return "unknown";
+    }
+
+    bool IsBlockCompressed(TextureFormat format) { return format != TextureFormat::RGBA8; }
+
+    uint32_t GetTextureBlockBytes(TextureFormat format)
+    {
+        switch (format) {
+        case TextureFormat::BC1:
+            return 8;
+        case TextureFormat::BC3:
+        case TextureFormat::BC7:
+            return 16;
+        default:
+            return 4;
+        }
+    }
+
+    uint32_t GetTextureRowPitch(TextureFormat format, uint32_t width)
+    {
+        return IsBlockCompressed(format) ? (width + 3) / 4 * GetTextureBlockBytes(format) : width * 4;
+    }
+
+    uint32_t GetTextureRowCount(TextureFormat format, uint32_t height)
+    {
+        return IsBlockCompressed(format) ? (height + 3) / 4 : height;
+    }
+
+    void EncodeBC1Block(const uint8_t *rgba, uint8_t *block) { EncodeColorBlock(rgba, block); }
+
+    void EncodeBC3Block(const uint8_t *rgba, uint8_t *block)
+    {
+        EncodeAlphaBlock(rgba, block);
+        EncodeColorBlock(rgba, block + 8);
+    }
+
+    void EncodeBC7Block(const uint8_t *rgba, uint8_t *block) { EncodeBC7Mode6(rgba, block); }
+
+    void DecodeBC1Block(const uint8_t *block, uint8_t *rgba) { DecodeColorBlock(block, rgba, true); }
+
+    void DecodeBC3Block(const uint8_t *block, uint8_t *rgba)
+    {
+        DecodeColorBlock(block + 8, rgba, false);
+        DecodeAlphaBlock(block, rgba);
+    }
+
+    bool DecodeBC7Block(const uint8_t *block, uint8_t *rgba)
+    {
+        BitStream stream;
+        memcpy(stream.bits, block, 16);
+        if (stream.Read(7) != (1u << 6)) {
+            for (int i = 0; i < 16; i++) {
+                rgba[i * 4 + 0] = 255;
+                rgba[i * 4 + 1] = 0;
+                rgba[i * 4 + 2] = 255;
+                rgba[i * 4 + 3] = 255;
+            }
+            return false;
+        }
+
+        int q[2][4];
+        for (int c = 0; c < 4; c++) {
+            q[0][c] = int(stream.Read(7));
+            q[1][c] = int(stream.Read(7));
+        }
+        const int p0 = int(stream.Read(1));
+        const int p1 = int(stream.Read(1));
+        for (int i = 0; i < 16; i++) {
+            const uint32_t index = stream.Read(i == 0 ? 3 : 4);
+            for (int c = 0; c < 4; c++)
+                rgba[i * 4 + c] = uint8_t(InterpolateBC7((q[0][c] << 1) | p0, (q[1][c] << 1) | p1,
+                                                         kBC7Weights4[index]));
+        }
+        return true;
+    }
+
+    void CompressTexture(TextureFormat format, uint32_t width, uint32_t height, const uint8_t *rgba,
+                         vector<uint8_t> &out, JobSystem &jobSystem)
+    {
+        const uint32_t rowPitch = GetTextureRowPitch(format, width);
+        const uint32_t rowCount = GetTextureRowCount(format, height);
+        out.resize(size_t(rowPitch) * rowCount);
+        if (!IsBlockCompressed(format)) {
+            memcpy(out.data(), rgba, out.size());
+            return;
+        }
+
+        const uint32_t blocksX = (width + 3) / 4;
+        const uint32_t blockBytes = GetTextureBlockBytes(format);
+        // 블록 수천 개 단위로 나눠야 작은 밉에서 작업 분배 비용이 압축 비용보다 커지지 않음
+        const size_t grainRows = max<size_t>(1, 1024 / blocksX);
+        jobSystem.ParallelFor(rowCount, grainRows, [&](size_t begin, size_t end) {
+            uint8_t pixels[64];
+            for (size_t blockY = begin; blockY < end; blockY++) {
+                uint8_t *row = out.data() + blockY * rowPitch;
+                for (uint32_t blockX = 0; blockX < blocksX; blockX++) {
+                    GatherBlock(width, height, rgba, blockX, uint32_t(blockY), pixels);
+                    uint8_t *block = row + size_t(blockX) * blockBytes;
+                    if (format == TextureFormat::BC1)
+                        EncodeBC1Block(pixels, block);
+                    else if (format == TextureFormat::BC3)
+                        EncodeBC3Block(pixels, block);
+                    else
+                        EncodeBC7Block(pixels, block);
+                }
+            }
+        });
+    }
+
+    void DecompressTexture(TextureFormat format, uint32_t width, uint32_t height, const uint8_t *data,
+                           vector<uint8_t> &rgba)
+    {
+        rgba.resize(size_t(width) * height * 4);
+        if (!IsBlockCompressed(format)) {
+            memcpy(rgba.data(), data, rgba.size());
+            return;
+        }
+
+        const uint32_t rowPitch = GetTextureRowPitch(format, width);
+        const uint32_t blockBytes = GetTextureBlockBytes(format);
+        uint8_t pixels[64];
+        for (uint32_t blockY = 0; blockY < GetTextureRowCount(format, height); blockY++) {
+            for (uint32_t blockX = 0; blockX < (width + 3) / 4; blockX++) {
+                const uint8_t *block = data + size_t(blockY) * rowPitch + size_t(blockX) * blockBytes;
+                if (format == TextureFormat::BC1)
+                    DecodeBC1Block(block, pixels);
+                else if (format == TextureFormat::BC3)
+                    DecodeBC3Block(block, pixels);
+                else
+                    DecodeBC7Block(block, pixels);
+
+                for (uint32_t y = 0; y < 4 && blockY * 4 + y < height; y++)
+                    for (uint32_t x = 0; x < 4 && blockX * 4 + x < width; x++)
+                        memcpy(&rgba[(size_t(blockY * 4 + y) * width + blockX * 4 + x) * 4], &pixels[(y * 4 + x) * 4],
+                               4);
+            }
+        }
+    }
+}
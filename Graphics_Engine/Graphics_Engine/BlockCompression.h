@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "JobSystem.h"
+
+namespace luke {
+
+    // 텍스처 픽셀 형식. 값은 컨테이너 파일에 그대로 저장되므로 바꾸지 마세요.
+    enum class TextureFormat : uint32_t {
+        RGBA8 = 0, // 압축하지 않음
+        BC1 = 1,   // RGB (1비트 알파 없음), 4x4 블록당 8바이트 (4 bpp)
+        BC3 = 2,   // RGB(BC1) + 알파(BC4), 블록당 16바이트 (8 bpp)
+        BC7 = 3,   // RGBA, 블록당 16바이트 (8 bpp). 모드 6만 사용
+    };
+
+    const char *GetTextureFormatName(TextureFormat format); // "rgba8", "bc1", "bc3", "bc7"
+    bool IsBlockCompressed(TextureFormat format);
+    // 블록 압축이면 4x4 블록 하나, 아니면 픽셀 하나의 바이트 수
+    uint32_t GetTextureBlockBytes(TextureFormat format);
+    // 한 행(블록 압축이면 블록 한 줄)의 바이트 수와 행 수
+    uint32_t GetTextureRowPitch(TextureFormat format, uint32_t width);
+    uint32_t GetTextureRowCount(TextureFormat format, uint32_t height);
+
+    // 4x4 블록 하나 (rgba는 행 우선 16픽셀 = 64바이트)
+    // BC1/BC3 색상: 주성분 축의 양 끝을 끝점으로 잡고 최소제곱으로 한 번 다듬음
+    // BC7: 모드 6 (RGBA 끝점 7비트 + p비트, 16단계 인덱스). 불투명/반투명 모두 한 모드로 처리
+    void EncodeBC1Block(const uint8_t *rgba, uint8_t *block);
+    void EncodeBC3Block(const uint8_t *rgba, uint8_t *block);
+    void EncodeBC7Block(const uint8_t *rgba, uint8_t *block);
+
+    void DecodeBC1Block(const uint8_t *block, uint8_t *rgba);
+    void DecodeBC3Block(const uint8_t *block, uint8_t *rgba);
+    // 모드 6 이외의 블록은 false (자홍색으로 채움)
+    bool DecodeBC7Block(const uint8_t *block, uint8_t *rgba);
+
+    // 행 우선 RGBA8 이미지를 format으로 압축해서 out을 채움 (행 간격은 GetTextureRowPitch())
+    // 블록 행을 나눠서 jobSystem으로 병렬 처리합니다. 가장자리 블록은 마지막 픽셀을 반복해서 채움
+    void CompressTexture(TextureFormat format, uint32_t width, uint32_t height, const uint8_t *rgba,
+                         std::vector<uint8_t> &out, JobSystem &jobSystem);
+    // 품질 측정용
+    void DecompressTexture(TextureFormat format, uint32_t width, uint32_t height, const uint8_t *data,
+                           std::vector<uint8_t> &rgba);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace luke {
+
+    // 크기가 고정된 다중 생산자/다중 소비자 큐 (잠금 없음)
+    // 칸마다 순번(sequence)을 두고 생산자/소비자가 위치를 compare_exchange로 예약하는 방식입니다.
+    // (Dmitry Vyukov의 bounded MPMC queue)
+    // 가득 차거나 비어 있으면 기다리지 않고 false를 반환하므로 대기는 호출하는 쪽이 결정합니다.
+    template <typename T>
+    class BoundedQueue {
+    public:
+        // capacity는 2의 거듭제곱으로 올림
+        explicit BoundedQueue(size_t capacity)
+            : m_capacity(std::bit_ceil(capacity < 2 ? size_t(2) : capacity)),
+              m_cells(std::make_unique<Cell[]>(m_capacity))
+        {
+            for (size_t i = 0; i < m_capacity; i++)
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        BoundedQueue(const BoundedQueue &) = delete;
+        BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+        bool TryPush(T &&value)
+        {
+            size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            while (true) {
+                Cell &cell = m_cells[pos & (m_capacity - 1)];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                const intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+                if (diff == 0) {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        cell.value = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false; // 가득 참
+                }
+                else {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool TryPop(T &value)
+        {
+            size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            while (true) {
+                Cell &cell = m_cells[pos & (m_capacity - 1)];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                const intptr_t diff = intptr_t(sequence) - intptr_t(pos + 1);
+                if (diff == 0) {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        value = std::move(cell.value);
+                        cell.sequence.store(pos + m_capacity, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (diff < 0) {
+                    return false; // 비어 있음 (또는 생산자가 아직 쓰는 중)
+                }
+                else {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        size_t GetCapacity() const { return m_capacity; }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        const size_t m_capacity;
+        std::unique_ptr<Cell[]> m_cells;
+        // 생산자와 소비자가 같은 캐시 라인을 두고 다투지 않도록 떨어뜨려 둠
+        alignas(64) std::atomic<size_t> m_enqueuePos{0};
+        alignas(64) std::atomic<size_t> m_dequeuePos{0};
+    };
+}
@@ -0,0 +1,358 @@
+#include "ClusteredLighting.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace luke {
+
+    using namespace std;
+    using namespace DirectX;
+
+    namespace {
+        XMVECTOR Load4(const float *values) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(values)); }
+
+        void Store4(float *values, XMVECTOR v) { XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(values), v); }
+
+        // NDC 점을 뷰 공간으로
+        Vector3 Unproject(const XMMATRIX &inverseProjection, float x, float y, float z)
+        {
+            const XMVECTOR v = XMVector4Transform(XMVectorSet(x, y, z, 1.0f), inverseProjection);
+            XMFLOAT4 p;
+            XMStoreFloat4(&p, v);
+            return Vector3(p.x / p.w, p.y / p.w, p.z / p.w);
+        }
+
+        // 뷰 공간 깊이 -> NDC 깊이
+        float ProjectDepth(const XMMATRIX &projection, float viewZ)
+        {
+            XMFLOAT4 p;
+            XMStoreFloat4(&p, XMVector4Transform(XMVectorSet(0.0f, 0.0f, viewZ, 1.0f), projection));
+            return p.z / p.w;
+        }
+
+        struct BoxVectors {
+            XMVECTOR minX, minY, minZ, maxX, maxY, maxZ;
+
+            BoxVectors(const Vector3 &boxMin, const Vector3 &boxMax)
+                : minX(XMVectorReplicate(boxMin.x)), minY(XMVectorReplicate(boxMin.y)),
+                  minZ(XMVectorReplicate(boxMin.z)), maxX(XMVectorReplicate(boxMax.x)),
+                  maxY(XMVectorReplicate(boxMax.y)), maxZ(XMVectorReplicate(boxMax.z))
+            {
+            }
+        };
+
+        // 구 4개와 AABB의 교차: AABB에서 중심까지 거리의 제곱 <= 반지름 제곱이면 1, 아니면 0
+        void TestSpheres(const float *x, const float *y, const float *z, const float *radiusSq,
+                         const BoxVectors &box, float overlap[4])
+        {
+            const XMVECTOR zero = XMVectorZero();
+            const XMVECTOR cx = Load4(x);
+            const XMVECTOR cy = Load4(y);
+            const XMVECTOR cz = Load4(z);
+            // 중심이 상자 밖이면 둘 중 하나만 양수
+            const XMVECTOR dx =
+                XMVectorAdd(XMVectorMax(XMVectorSubtract(box.minX, cx), zero), XMVectorMax(XMVectorSubtract(cx, box.maxX), zero));
+            const XMVECTOR dy =
+                XMVectorAdd(XMVectorMax(XMVectorSubtract(box.minY, cy), zero), XMVectorMax(XMVectorSubtract(cy, box.maxY), zero));
+            const XMVECTOR dz =
+                XMVectorAdd(XMVectorMax(XMVectorSubtract(box.minZ, cz), zero), XMVectorMax(XMVectorSubtract(cz, box.maxZ), zero));
+            const XMVECTOR distanceSq =
+                XMVectorMultiplyAdd(dz, dz, XMVectorMultiplyAdd(dy, dy, XMVectorMultiply(dx, dx)));
+            Store4(overlap, XMVectorSelect(zero, XMVectorSplatOne(), XMVectorLessOrEqual(distanceSq, Load4(radiusSq))));
+        }
+
+        float SmoothStep(float edge0, float edge1, float x)
+        {
+            const float t = clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+            return t * t * (3.0f - 2.0f * t);
+        }
+    }
+
+    Light Light::Point(const Vector3 &position, float radius, const Vector3 &color)
+    {
+        Light light;
+        light.position = position;
+        light.radius = radius;
+        light.color = color;
+        return light;
+    }
+
+    Light Light::Spot(const Vector3 &position, const Vector3 &direction, float radius, float outerAngle,
+                      float innerAngle, const Vector3 &color)
+    {
+        Light light = Point(position, radius, color);
+        light.direction = direction;
+        light.direction.Normalize();
+        light.spotCosOuter = cosf(outerAngle);
+        light.spotCosInner = cosf(min(innerAngle, outerAngle - 1e-3f));
+        return light;
+    }
+
+    Vector3 ShadeClustered(const ClusteredLightData &data, uint32_t tileX, uint32_t tileY, float viewZ,
+                           const Vector3 &albedo, const Vector3 &worldPosition, const Vector3 &normal)
+    {
+        const ClusterConstants &constants = data.constants;
+        const float sliceValue = viewZ > 0.0f ? log2f(viewZ) * constants.sliceScale + constants.sliceBias : 0.0f;
+        const uint32_t slice = uint32_t(clamp(int(sliceValue), 0, int(constants.sliceCount) - 1));
+        const size_t cluster = (size_t(slice) * constants.tileCountY + tileY) * constants.tileCountX + tileX;
+
+        Vector3 lighting = constants.ambient;
+        if (cluster < data.clusters.size()) {
+            const LightCluster &range = data.clusters[cluster];
+            for (uint32_t k = 0; k < range.count && range.offset + k < data.lightIndices.size(); k++) {
+                const uint32_t index = data.lightIndices[range.offset + k];
+                if (index >= data.lights.size())
+                    continue;
+                const Light &light = data.lights[index];
+
+                Vector3 toLight = light.position - worldPosition;
+                const float distanceSq = toLight.Dot(toLight);
+                const float radiusSq = light.radius * light.radius;
+                if (distanceSq >= radiusSq || distanceSq <= 0.0f)
+                    continue;
+                toLight = toLight / sqrtf(distanceSq);
+
+                const float window = 1.0f - distanceSq / radiusSq;
+                const float spot = SmoothStep(light.spotCosOuter, light.spotCosInner, -toLight.Dot(light.direction));
+                lighting += light.color * (max(normal.Dot(toLight), 0.0f) * window * window * spot);
+            }
+        }
+        return albedo * lighting;
+    }
+
+    void LightClusterGrid::Candidates::Reserve(size_t capacity)
+    {
+        // 4개 묶음으로 읽고 마지막 묶음 뒤에 채움 레인을 쓰므로 여유를 둠
+        capacity = ((capacity + 3) & ~size_t(3)) + 4;
+        if (light.size() >= capacity)
+            return;
+        for (vector<float> *values : {&x, &y, &z, &radiusSq})
+            values->resize(capacity);
+        light.resize(capacity);
+    }
+
+    void LightClusterGrid::Configure(const Matrix &projection, uint32_t tileCountX, uint32_t tileCountY,
+                                     uint32_t sliceCount)
+    {
+        tileCountX = max(tileCountX, 1u);
+        tileCountY = max(tileCountY, 1u);
+        sliceCount = max(sliceCount, 1u);
+        if (tileCountX == m_tileCountX && tileCountY == m_tileCountY && sliceCount == m_sliceCount &&
+            memcmp(&projection, &m_projection, sizeof(Matrix)) == 0)
+            return;
+
+        m_tileCountX = tileCountX;
+        m_tileCountY = tileCountY;
+        m_sliceCount = sliceCount;
+        m_projection = projection;
+
+        const XMMATRIX projectionMatrix = projection;
+        const XMMATRIX inverse = XMMatrixInverse(nullptr, projectionMatrix);
+        m_near = max(Unproject(inverse, 0.0f, 0.0f, 0.0f).z, 1e-4f);
+        m_far = max(Unproject(inverse, 0.0f, 0.0f, 1.0f).z, m_near * 1.001f);
+
+        const size_t clusterCount = size_t(tileCountX) * tileCountY * sliceCount;
+        m_clusterMin.resize(clusterCount);
+        m_clusterMax.resize(clusterCount);
+        m_rowMin.resize(size_t(tileCountY) * sliceCount);
+        m_rowMax.resize(size_t(tileCountY) * sliceCount);
+        m_sliceMin.resize(sliceCount);
+        m_sliceMax.resize(sliceCount);
+        m_clusters.resize(clusterCount);
+        m_slices.resize(sliceCount);
+
+        // 깊이는 지수 간격: 가까운 곳일수록 얇은 슬라이스
+        const float ratio = m_far / m_near;
+        for (uint32_t s = 0; s < sliceCount; s++) {
+            const float depths[2] = {ProjectDepth(projectionMatrix, m_near * powf(ratio, float(s) / sliceCount)),
+                                     ProjectDepth(projectionMatrix, m_near * powf(ratio, float(s + 1) / sliceCount))};
+            Vector3 sliceMin(FLT_MAX, FLT_MAX, FLT_MAX), sliceMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            for (uint32_t y = 0; y < tileCountY; y++) {
+                // 타일 y는 화면 위에서 아래로 (픽셀 좌표와 같은 방향)
+                const float ndcY[2] = {1.0f - 2.0f * (y + 1) / tileCountY, 1.0f - 2.0f * y / tileCountY};
+                Vector3 rowMin(FLT_MAX, FLT_MAX, FLT_MAX), rowMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+                for (uint32_t x = 0; x < tileCountX; x++) {
+                    const float ndcX[2] = {-1.0f + 2.0f * x / tileCountX, -1.0f + 2.0f * (x + 1) / tileCountX};
+                    Vector3 boxMin(FLT_MAX, FLT_MAX, FLT_MAX), boxMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+                    for (uint32_t corner = 0; corner < 8; corner++) {
+                        const Vector3 p =
+                            Unproject(inverse, ndcX[corner & 1], ndcY[(corner >> 1) & 1], depths[corner >> 2]);
+                        boxMin = Vector3::Min(boxMin, p);
+                        boxMax = Vector3::Max(boxMax, p);
+                    }
+                    const size_t cluster = (size_t(s) * tileCountY + y) * tileCountX + x;
+                    m_clusterMin[cluster] = boxMin;
+                    m_clusterMax[cluster] = boxMax;
+                    rowMin = Vector3::Min(rowMin, boxMin);
+                    rowMax = Vector3::Max(rowMax, boxMax);
+                }
+                m_rowMin[size_t(s) * tileCountY + y] = rowMin;
+                m_rowMax[size_t(s) * tileCountY + y] = rowMax;
+                sliceMin = Vector3::Min(sliceMin, rowMin);
+                sliceMax = Vector3::Max(sliceMax, rowMax);
+            }
+            m_sliceMin[s] = sliceMin;
+            m_sliceMax[s] = sliceMax;
+        }
+    }
+
+    void LightClusterGrid::Filter(const Candidates &source, const Vector3 &boxMin, const Vector3 &boxMax,
+                                  Candidates &out)
+    {
+        out.Reserve(source.count);
+        const BoxVectors box(boxMin, boxMax);
+        uint32_t write = 0;
+        for (uint32_t i = 0; i < source.count; i += 4) {
+            float overlap[4];
+            TestSpheres(&source.x[i], &source.y[i], &source.z[i], &source.radiusSq[i], box, overlap);
+            // 분기 없는 압축 (채움 레인은 겹치지 않으므로 source.count를 넘어도 됨)
+            for (uint32_t lane = 0; lane < 4; lane++) {
+                out.x[write] = source.x[i + lane];
+                out.y[write] = source.y[i + lane];
+                out.z[write] = source.z[i + lane];
+                out.radiusSq[write] = source.radiusSq[i + lane];
+                out.light[write] = source.light[i + lane];
+                write += uint32_t(overlap[lane]);
+            }
+        }
+        out.count = write;
+        for (uint32_t i = write; i < ((write + 3) & ~3u); i++)
+            out.radiusSq[i] = -1.0f;
+    }
+
+    void LightClusterGrid::Bin(span<const Light> lights, const Matrix &view, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+        const auto start = Clock::now();
+
+        // 빛의 중심을 4개씩 뷰 공간으로 (SoA)
+        const uint32_t lightCount = uint32_t(lights.size());
+        Candidates &all = m_viewLights;
+        all.Reserve(lightCount);
+        const XMMATRIX viewMatrix = view;
+        XMFLOAT4X4 m;
+        XMStoreFloat4x4(&m, viewMatrix);
+        for (uint32_t i = 0; i < lightCount; i += 4) {
+            float px[4] = {}, py[4] = {}, pz[4] = {}, radius[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+            for (uint32_t lane = 0; lane < min(4u, lightCount - i); lane++) {
+                const Light &light = lights[i + lane];
+                px[lane] = light.position.x;
+                py[lane] = light.position.y;
+                pz[lane] = light.position.z;
+                radius[lane] = light.radius;
+                all.light[i + lane] = i + lane;
+            }
+            const XMVECTOR x = Load4(px), y = Load4(py), z = Load4(pz);
+            auto transform = [&](int column) {
+                return XMVectorMultiplyAdd(
+                    x, XMVectorReplicate(m.m[0][column]),
+                    XMVectorMultiplyAdd(y, XMVectorReplicate(m.m[1][column]),
+                                        XMVectorMultiplyAdd(z, XMVectorReplicate(m.m[2][column]),
+                                                            XMVectorReplicate(m.m[3][column]))));
+            };
+            Store4(&all.x[i], transform(0));
+            Store4(&all.y[i], transform(1));
+            Store4(&all.z[i], transform(2));
+            // 채움 레인(-1)은 제곱하면 양수가 되므로 부호를 살림
+            const XMVECTOR r = Load4(radius);
+            Store4(&all.radiusSq[i], XMVectorMultiply(r, XMVectorAbs(r)));
+        }
+        all.count = lightCount;
+
+        // 절두체 전체와 겹치는 빛만 남김
+        Vector3 frustumMin = m_sliceMin[0], frustumMax = m_sliceMax[0];
+        for (uint32_t s = 1; s < m_sliceCount; s++) {
+            frustumMin = Vector3::Min(frustumMin, m_sliceMin[s]);
+            frustumMax = Vector3::Max(frustumMax, m_sliceMax[s]);
+        }
+        Filter(all, frustumMin, frustumMax, m_visible);
+
+        jobSystem.ParallelFor(m_sliceCount, 1, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; s++) {
+                SliceWork &work = m_slices[s];
+                work.indices.clear();
+                Filter(m_visible, m_sliceMin[s], m_sliceMax[s], work.slice);
+                for (uint32_t y = 0; y < m_tileCountY; y++) {
+                    const size_t row = s * m_tileCountY + y;
+                    Filter(work.slice, m_rowMin[row], m_rowMax[row], work.row);
+                    const Candidates &candidates = work.row;
+                    for (uint32_t x = 0; x < m_tileCountX; x++) {
+                        const size_t cluster = row * m_tileCountX + x;
+                        const BoxVectors box(m_clusterMin[cluster], m_clusterMax[cluster]);
+                        const uint32_t offset = uint32_t(work.indices.size());
+                        work.indices.resize(offset + ((candidates.count + 3) & ~3u));
+                        uint32_t write = offset;
+                        for (uint32_t i = 0; i < candidates.count; i += 4) {
+                            float overlap[4];
+                            TestSpheres(&candidates.x[i], &candidates.y[i], &candidates.z[i],
+                                        &candidates.radiusSq[i], box, overlap);
+                            for (uint32_t lane = 0; lane < 4; lane++) {
+                                work.indices[write] = candidates.light[i + lane];
+                                write += uint32_t(overlap[lane]);
+                            }
+                        }
+                        work.indices.resize(write);
+                        m_clusters[cluster] = {offset, write - offset};
+                    }
+                }
+            }
+        });
+
+        // 슬라이스별 목록을 이어 붙이고 offset을 전체 배열 기준으로
+        size_t total = 0;
+        for (const SliceWork &work : m_slices)
+            total += work.indices.size();
+        m_lightIndices.resize(total);
+        const uint32_t clustersPerSlice = m_tileCountX * m_tileCountY;
+        uint32_t base = 0;
+        m_stats = {};
+        for (uint32_t s = 0; s < m_sliceCount; s++) {
+            const vector<uint32_t> &indices = m_slices[s].indices;
+            if (!indices.empty())
+                memcpy(m_lightIndices.data() + base, indices.data(), indices.size() * sizeof(uint32_t));
+            for (uint32_t c = s * clustersPerSlice; c < (s + 1) * clustersPerSlice; c++) {
+                m_clusters[c].offset += base;
+                m_stats.maxClusterLights = max(m_stats.maxClusterLights, m_clusters[c].count);
+                m_stats.occupiedClusters += m_clusters[c].count > 0 ? 1 : 0;
+            }
+            base += uint32_t(indices.size());
+        }
+
+        m_stats.binMs = chrono::duration<double, milli>(Clock::now() - start).count();
+        m_stats.lightCount = lightCount;
+        m_stats.visibleLights = m_visible.count;
+        m_stats.indexCount = uint32_t(total);
+    }
+
+    ClusterConstants LightClusterGrid::GetConstants(float viewportWidth, float viewportHeight,
+                                                    const Vector3 &ambient) const
+    {
+        ClusterConstants constants;
+        constants.tileCountX = m_tileCountX;
+        constants.tileCountY = m_tileCountY;
+        constants.sliceCount = m_sliceCount;
+        constants.tileScaleX = viewportWidth > 0.0f ? m_tileCountX / viewportWidth : 0.0f;
+        constants.tileScaleY = viewportHeight > 0.0f ? m_tileCountY / viewportHeight : 0.0f;
+        // slice = sliceCount * log(z / near) / log(far / near)
+        const float logRatio = log2f(m_far / m_near);
+        constants.sliceScale = m_sliceCount / logRatio;
+        constants.sliceBias = -float(m_sliceCount) * log2f(m_near) / logRatio;
+        constants.ambient = ambient;
+        return constants;
+    }
+
+    ClusteredLightData LightClusterGrid::GetData(span<const Light> lights, float viewportWidth,
+                                                 float viewportHeight, const Vector3 &ambient) const
+    {
+        ClusteredLightData data;
+        data.constants = GetConstants(viewportWidth, viewportHeight, ambient);
+        data.constants.lightCount = uint32_t(lights.size());
+        data.lights = lights;
+        data.clusters = m_clusters;
+        data.lightIndices = m_lightIndices;
+        return data;
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <directxtk/SimpleMath.h>
+#include <span>
+#include <vector>
+
+#include "JobSystem.h"
+
+namespace luke {
+
+    using DirectX::SimpleMath::Matrix;
+    using DirectX::SimpleMath::Vector3;
+
+    // 점광원/스포트라이트 (48바이트, 쉐이더의 StructuredBuffer<Light>와 같은 배치)
+    // 감쇠는 거리 radius에서 0이 되고, 스포트라이트는 spotCosOuter ~ spotCosInner 사이에서 부드럽게 줄어듦
+    struct Light {
+        Vector3 position;           // 월드 공간
+        float radius;
+        Vector3 color;              // 밝기를 곱한 값
+        float spotCosOuter = -2.0f; // 점광원은 -2 (원뿔 없음)
+        Vector3 direction;          // 스포트라이트가 비추는 방향 (정규화)
+        float spotCosInner = -1.0f;
+
+        static Light Point(const Vector3 &position, float radius, const Vector3 &color);
+        static Light Spot(const Vector3 &position, const Vector3 &direction, float radius, float outerAngle,
+                          float innerAngle, const Vector3 &color);
+    };
+
+    static_assert(sizeof(Light) == 48);
+
+    // 클러스터 하나의 빛 목록: lightIndices[offset, offset + count)
+    struct LightCluster {
+        uint32_t offset = 0;
+        uint32_t count = 0;
+    };
+
+    // 쉐이더 상수 (b1, ClusterConstantBuffer)
+    struct ClusterConstants {
+        uint32_t tileCountX = 0;
+        uint32_t tileCountY = 0;
+        uint32_t sliceCount = 0;
+        uint32_t lightCount = 0;
+        float tileScaleX = 0.0f; // 픽셀 좌표 -> 타일 (타일 수 / 뷰포트 크기)
+        float tileScaleY = 0.0f;
+        float sliceScale = 0.0f; // 슬라이스 = log2(뷰 공간 z) * sliceScale + sliceBias
+        float sliceBias = 0.0f;
+        Vector3 ambient;
+        float padding = 0.0f;
+    };
+
+    static_assert(sizeof(ClusterConstants) % 16 == 0);
+
+    // 픽셀 쉐이더와 소프트웨어 래스터라이저가 읽는 한 프레임의 빛 데이터
+    struct ClusteredLightData {
+        ClusterConstants constants;
+        std::span<const Light> lights;
+        std::span<const LightCluster> clusters; // [slice][y][x]
+        std::span<const uint32_t> lightIndices;
+    };
+
+    // 한 점의 색: albedo * (ambient + 클러스터 목록의 빛). ColorPixelShader(CLUSTERED_LIGHTING)와 같은 계산
+    // 소프트웨어 래스터라이저가 씁니다. tileX/tileY는 이미 [0, 타일 수)로 자른 값
+    Vector3 ShadeClustered(const ClusteredLightData &data, uint32_t tileX, uint32_t tileY, float viewZ,
+                           const Vector3 &albedo, const Vector3 &worldPosition, const Vector3 &normal);
+
+    struct LightBinningStats {
+        double binMs = 0.0;            // 뷰 공간 변환 + 분류 + 목록 합치기
+        uint32_t lightCount = 0;
+        uint32_t visibleLights = 0;    // 절두체에 걸친 빛
+        uint32_t indexCount = 0;       // 모든 클러스터 목록 길이의 합
+        uint32_t maxClusterLights = 0;
+        uint32_t occupiedClusters = 0; // 빛이 하나 이상인 클러스터
+    };
+
+    // 뷰 절두체를 화면 타일 x 깊이 슬라이스(지수 간격)의 클러스터로 나누고 빛을 클러스터마다 분류합니다.
+    // 분류는 슬라이스 단위로 작업 풀에서 하고, 빛 4개를 XMVECTOR 레인에 나눠 구/AABB 교차를 한 번에 검사합니다.
+    //   슬라이스 AABB -> 타일 행 AABB -> 클러스터 AABB 순서로 후보를 줄여 가며 검사
+    // 결과는 클러스터마다 (offset, count)와 이어 붙인 빛 번호 배열이므로 그대로 GPU 버퍼에 올리면 됩니다.
+    class LightClusterGrid {
+    public:
+        // projection은 전치하기 전의 투영 행렬 (원근/직교 모두). 바뀌었을 때만 클러스터 AABB를 다시 계산
+        void Configure(const Matrix &projection, uint32_t tileCountX = 16, uint32_t tileCountY = 9,
+                       uint32_t sliceCount = 24);
+
+        // view는 전치하기 전의 뷰 행렬
+        void Bin(std::span<const Light> lights, const Matrix &view, JobSystem &jobSystem);
+
+        // viewportWidth/Height: 픽셀 좌표에서 타일을 찾기 위한 크기
+        ClusterConstants GetConstants(float viewportWidth, float viewportHeight, const Vector3 &ambient) const;
+        ClusteredLightData GetData(std::span<const Light> lights, float viewportWidth, float viewportHeight,
+                                   const Vector3 &ambient) const;
+
+        uint32_t GetClusterCount() const { return m_tileCountX * m_tileCountY * m_sliceCount; }
+        const std::vector<LightCluster> &GetClusters() const { return m_clusters; }
+        const std::vector<uint32_t> &GetLightIndices() const { return m_lightIndices; }
+        const LightBinningStats &GetStats() const { return m_stats; }
+
+    private:
+        // 후보 빛의 뷰 공간 구 (SoA, 4의 배수로 채움. 채운 레인은 radiusSq < 0이라 항상 실패)
+        struct Candidates {
+            std::vector<float> x, y, z, radiusSq;
+            std::vector<uint32_t> light;
+            uint32_t count = 0;
+
+            void Reserve(size_t count);
+        };
+
+        struct SliceWork {
+            Candidates slice;
+            Candidates row;
+            std::vector<uint32_t> indices; // 슬라이스 안 클러스터 목록 (offset은 이 배열 기준)
+        };
+
+        // source의 구 중에서 AABB와 겹치는 것을 out에 (분기 없이) 모음
+        static void Filter(const Candidates &source, const Vector3 &boxMin, const Vector3 &boxMax,
+                           Candidates &out);
+
+        uint32_t m_tileCountX = 0;
+        uint32_t m_tileCountY = 0;
+        uint32_t m_sliceCount = 0;
+        Matrix m_projection;
+        float m_near = 0.0f;
+        float m_far = 0.0f;
+        std::vector<Vector3> m_clusterMin; // 뷰 공간 AABB [slice][y][x]
+        std::vector<Vector3> m_clusterMax;
+        std::vector<Vector3> m_rowMin;     // [slice][y]
+        std::vector<Vector3> m_rowMax;
+        std::vector<Vector3> m_sliceMin;   // [slice]
+        std::vector<Vector3> m_sliceMax;
+
+        Candidates m_viewLights; // 모든 빛의 뷰 공간 구
+        Candidates m_visible;    // 그중 절두체와 겹치는 것
+        std::vector<SliceWork> m_slices;
+        std::vector<LightCluster> m_clusters;
+        std::vector<uint32_t> m_lightIndices;
+        LightBinningStats m_stats;
+    };
+}
@@ -0,0 +1,681 @@
+#include "CommandCapture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        constexpr uint32_t kCaptureMagic = 0x5041434C; // "LCAP"
+        constexpr uint32_t kCaptureVersion = 1;
+
+        struct CaptureFileHeader {
+            uint32_t magic = kCaptureMagic;
+            uint32_t version = kCaptureVersion;
+            uint32_t bufferCount = 0;
+            uint32_t reserved = 0;
+            uint64_t setupCommands = 0;
+            uint64_t frameCommands = 0;
+            uint64_t setupBytes = 0;
+            uint64_t frameBytes = 0;
+        };
+
+        constexpr int32_t kDynamicFlag = 1 << 8;
+        constexpr int32_t kHasDataFlag = 1 << 9;
+
+        int32_t PackBufferFlags(GpuBufferType type, bool dynamic, bool hasData)
+        {
+            return int32_t(type) | (dynamic ? kDynamicFlag : 0) | (hasData ? kHasDataFlag : 0);
+        }
+
+        // 명령 뒤에 data 배열에 붙은 바이트 수
+        size_t GetPayloadSize(const CaptureRecord &record)
+        {
+            if (record.command == CaptureCommand::CreateBuffer)
+                return (record.c & kHasDataFlag) ? record.b : 0;
+            if (record.command == CaptureCommand::UpdateBuffer || record.command == CaptureCommand::UpdateBufferRange)
+                return record.b;
+            return 0;
+        }
+
+        void AppendData(vector<uint8_t> &out, const void *data, size_t size)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t *>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        }
+
+        // 버퍼 번호가 범위 안이고, 데이터가 data 배열 안에 들어오는지
+        bool ValidateCommands(const vector<CaptureRecord> &commands, size_t dataSize, uint32_t bufferCount,
+                              bool setup)
+        {
+            auto validBuffer = [&](uint32_t buffer, bool allowNull) {
+                return buffer < bufferCount || (allowNull && buffer == kNullCaptureBuffer);
+            };
+            size_t offset = 0;
+            for (const CaptureRecord &record : commands) {
+                if (record.command >= CaptureCommand::Count)
+                    return false;
+                if (setup && record.command != CaptureCommand::CreateBuffer)
+                    return false;
+
+                bool valid = true;
+                switch (record.command) {
+                case CaptureCommand::CreateBuffer:
+                    valid = validBuffer(record.a, false) && (record.c & 0xFF) <= int32_t(GpuBufferType::Structured);
+                    break;
+                case CaptureCommand::UpdateBuffer:
+                case CaptureCommand::DestroyBuffer:
+                    valid = validBuffer(record.a, false);
+                    break;
+                case CaptureCommand::UpdateBufferRange:
+                    valid = validBuffer(record.a, false) && record.c >= 0;
+                    break;
+                case CaptureCommand::SetVertexBuffer:
+                case CaptureCommand::SetIndexBuffer:
+                    valid = validBuffer(record.a, true);
+                    break;
+                case CaptureCommand::SetInstanceBuffer:
+                    valid = validBuffer(record.a, true) && record.c >= 0;
+                    break;
+                case CaptureCommand::SetConstantBuffer:
+                case CaptureCommand::SetShaderBuffer:
+                    valid = validBuffer(record.b, true);
+                    break;
+                case CaptureCommand::SetConstantBufferRange:
+                    valid = validBuffer(record.b, false) && record.c >= 0;
+                    break;
+                default:
+                    break;
+                }
+
+                const size_t payload = GetPayloadSize(record);
+                if (!valid || payload > dataSize - offset)
+                    return false;
+                offset += payload;
+            }
+            return offset == dataSize;
+        }
+    }
+
+    const char *GetCaptureCommandName(CaptureCommand command)
+    {
+        switch (command) {
+        case CaptureCommand::BeginFrame:
+            return "BeginFrame";
+        case CaptureCommand::EndFrame:
+            return "EndFrame";
+        case CaptureCommand::CreateBuffer:
+            return "CreateBuffer";
+        case CaptureCommand::UpdateBuffer:
+            return "UpdateBuffer";
+        case CaptureCommand::DestroyBuffer:
+            return "DestroyBuffer";
+        case CaptureCommand::SetVertexBuffer:
+            return "SetVertexBuffer";
+        case CaptureCommand::SetIndexBuffer:
+            return "SetIndexBuffer";
+        case CaptureCommand::SetConstantBuffer:
+            return "SetConstantBuffer";
+        case CaptureCommand::SetPipeline:
+            return "SetPipeline";
+        case CaptureCommand::DrawIndexed:
+            return "DrawIndexed";
+        case CaptureCommand::SetInstanceBuffer:
+            return "SetInstanceBuffer";
+        case CaptureCommand::DrawIndexedInstanced:
+            return "DrawIndexedInstanced";
+        case CaptureCommand::SetShaderBuffer:
+            return "SetShaderBuffer";
+        case CaptureCommand::UpdateBufferRange:
+            return "UpdateBufferRange";
+        case CaptureCommand::SetConstantBufferRange:
+            return "SetConstantBufferRange";
+        default:
+            return "Unknown";
+        }
+    }
+
+#pragma region CommandCapture
+    void CommandCapture::Clear()
+    {
+        bufferCount = 0;
+        setupCommands.clear();
+        setupData.clear();
+        frameCommands.clear();
+        frameData.clear();
+    }
+
+    uint32_t CommandCapture::AddBuffer(GpuBufferType type, const void *data, size_t size, bool dynamic)
+    {
+        const uint32_t buffer = bufferCount++;
+        setupCommands.push_back(
+            {CaptureCommand::CreateBuffer, buffer, uint32_t(size), PackBufferFlags(type, dynamic, data != nullptr)});
+        if (data)
+            AppendData(setupData, data, size);
+        return buffer;
+    }
+
+    uint32_t CommandCapture::CreateBuffer(GpuBufferType type, const void *data, size_t size, bool dynamic)
+    {
+        const uint32_t buffer = bufferCount++;
+        Add(CaptureCommand::CreateBuffer, buffer, uint32_t(size), PackBufferFlags(type, dynamic, data != nullptr));
+        if (data)
+            AppendData(frameData, data, size);
+        return buffer;
+    }
+
+    void CommandCapture::UpdateBuffer(uint32_t buffer, const void *data, size_t size)
+    {
+        Add(CaptureCommand::UpdateBuffer, buffer, uint32_t(size));
+        AppendData(frameData, data, size);
+    }
+
+    void CommandCapture::DestroyBuffer(uint32_t buffer) { Add(CaptureCommand::DestroyBuffer, buffer); }
+
+    void CommandCapture::SetVertexBuffer(uint32_t buffer, uint32_t stride)
+    {
+        Add(CaptureCommand::SetVertexBuffer, buffer, stride);
+    }
+
+    void CommandCapture::SetIndexBuffer(uint32_t buffer) { Add(CaptureCommand::SetIndexBuffer, buffer); }
+
+    void CommandCapture::SetConstantBuffer(uint32_t slot, uint32_t buffer)
+    {
+        Add(CaptureCommand::SetConstantBuffer, slot, buffer);
+    }
+
+    void CommandCapture::SetPipeline(uint32_t pipeline) { Add(CaptureCommand::SetPipeline, pipeline); }
+
+    void CommandCapture::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+    {
+        Add(CaptureCommand::DrawIndexed, indexCount, startIndex, baseVertex);
+    }
+
+    void CommandCapture::SetInstanceBuffer(uint32_t buffer, uint32_t stride, size_t offset)
+    {
+        Add(CaptureCommand::SetInstanceBuffer, buffer, stride, int32_t(offset));
+    }
+
+    void CommandCapture::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex)
+    {
+        Add(CaptureCommand::DrawIndexedInstanced, indexCount, instanceCount, int32_t(startIndex));
+    }
+
+    void CommandCapture::SetShaderBuffer(uint32_t slot, uint32_t buffer)
+    {
+        Add(CaptureCommand::SetShaderBuffer, slot, buffer);
+    }
+
+    void CommandCapture::UpdateBufferRange(uint32_t buffer, size_t offset, const void *data, size_t size)
+    {
+        Add(CaptureCommand::UpdateBufferRange, buffer, uint32_t(size), int32_t(offset));
+        AppendData(frameData, data, size);
+    }
+
+    void CommandCapture::SetConstantBufferRange(uint32_t slot, uint32_t buffer, size_t offset, size_t size)
+    {
+        Add(CaptureCommand::SetConstantBufferRange, slot | uint32_t(size / 16) << 8, buffer, int32_t(offset / 16));
+    }
+
+    void CommandCapture::Add(CaptureCommand command, uint32_t a, uint32_t b, int32_t c)
+    {
+        frameCommands.push_back({command, a, b, c});
+    }
+
+    uint64_t CommandCapture::GetFileSize() const
+    {
+        return sizeof(CaptureFileHeader) + (setupCommands.size() + frameCommands.size()) * sizeof(CaptureRecord) +
+               setupData.size() + frameData.size();
+    }
+
+    bool SaveCommandCapture(const filesystem::path &path, const CommandCapture &capture)
+    {
+        CaptureFileHeader header;
+        header.bufferCount = capture.bufferCount;
+        header.setupCommands = capture.setupCommands.size();
+        header.frameCommands = capture.frameCommands.size();
+        header.setupBytes = capture.setupData.size();
+        header.frameBytes = capture.frameData.size();
+
+        ofstream file(path, ios::binary | ios::trunc);
+        if (!file) {
+            cout << "Cannot write " << path.string() << endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(capture.setupCommands.data()),
+                   streamsize(capture.setupCommands.size() * sizeof(CaptureRecord)));
+        file.write(reinterpret_cast<const char *>(capture.frameCommands.data()),
+                   streamsize(capture.frameCommands.size() * sizeof(CaptureRecord)));
+        file.write(reinterpret_cast<const char *>(capture.setupData.data()), streamsize(capture.setupData.size()));
+        file.write(reinterpret_cast<const char *>(capture.frameData.data()), streamsize(capture.frameData.size()));
+        if (!file) {
+            cout << "Failed to write " << path.string() << endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool LoadCommandCapture(const filesystem::path &path, CommandCapture &capture)
+    {
+        capture.Clear();
+
+        ifstream file(path, ios::binary | ios::ate);
+        if (!file) {
+            cout << "Cannot open " << path.string() << endl;
+            return false;
+        }
+        const uint64_t fileSize = uint64_t(file.tellg());
+        file.seekg(0);
+
+        CaptureFileHeader header;
+        if (fileSize < sizeof(header) || !file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+            header.magic != kCaptureMagic || header.version != kCaptureVersion) {
+            cout << "Not a command capture: " << path.string() << endl;
+            return false;
+        }
+        // 크기를 먼저 확인해서 잘못된 헤더로 큰 메모리를 잡지 않음
+        const uint64_t commandBytes = (header.setupCommands + header.frameCommands) * sizeof(CaptureRecord);
+        if (header.setupCommands > fileSize || header.frameCommands > fileSize ||
+            sizeof(header) + commandBytes + header.setupBytes + header.frameBytes != fileSize) {
+            cout << "Truncated command capture: " << path.string() << endl;
+            return false;
+        }
+
+        capture.bufferCount = header.bufferCount;
+        capture.setupCommands.resize(size_t(header.setupCommands));
+        capture.frameCommands.resize(size_t(header.frameCommands));
+        capture.setupData.resize(size_t(header.setupBytes));
+        capture.frameData.resize(size_t(header.frameBytes));
+        file.read(reinterpret_cast<char *>(capture.setupCommands.data()),
+                  streamsize(capture.setupCommands.size() * sizeof(CaptureRecord)));
+        file.read(reinterpret_cast<char *>(capture.frameCommands.data()),
+                  streamsize(capture.frameCommands.size() * sizeof(CaptureRecord)));
+        file.read(reinterpret_cast<char *>(capture.setupData.data()), streamsize(capture.setupData.size()));
+        file.read(reinterpret_cast<char *>(capture.frameData.data()), streamsize(capture.frameData.size()));
+
+        if (!file ||
+            !ValidateCommands(capture.setupCommands, capture.setupData.size(), capture.bufferCount, true) ||
+            !ValidateCommands(capture.frameCommands, capture.frameData.size(), capture.bufferCount, false)) {
+            cout << "Invalid command capture: " << path.string() << endl;
+            capture.Clear();
+            return false;
+        }
+        return true;
+    }
+#pragma endregion
+
+#pragma region CommandRecorder
+    void CommandRecorder::BeginFrame()
+    {
+        m_backend.BeginFrame();
+        if (m_captureRequested) {
+            m_captureRequested = false;
+            m_capturing = true;
+            m_capture.Clear();
+            m_capture.Add(CaptureCommand::BeginFrame);
+        }
+        SyncStats();
+    }
+
+    void CommandRecorder::EndFrame()
+    {
+        m_backend.EndFrame();
+        if (m_capturing) {
+            m_capture.Add(CaptureCommand::EndFrame);
+            m_capturing = false;
+            m_hasCapture = true;
+            // 다음 캡처는 버퍼 내용을 다시 읽어야 함
+            for (uint32_t value : m_capturedBuffers) {
+                auto it = m_bufferInfos.find(value);
+                if (it != m_bufferInfos.end())
+                    it->second.captureId = kNullCaptureBuffer;
+            }
+            m_capturedBuffers.clear();
+        }
+        SyncStats();
+    }
+
+    GpuBufferHandle CommandRecorder::CreateBuffer(GpuBufferType type, const void *data, size_t size, bool dynamic)
+    {
+        const GpuBufferHandle buffer = m_backend.CreateBuffer(type, data, size, dynamic);
+        if (buffer.IsNull())
+            return buffer;
+
+        BufferInfo &info = m_bufferInfos[buffer.value];
+        info = {type, dynamic, size, kNullCaptureBuffer};
+        if (m_capturing) {
+            info.captureId = m_capture.CreateBuffer(type, data, size, dynamic);
+            m_capturedBuffers.push_back(buffer.value);
+        }
+        return buffer;
+    }
+
+    void CommandRecorder::UpdateBuffer(GpuBufferHandle buffer, const void *data, size_t size)
+    {
+        if (m_capturing) {
+            // 바뀌기 전의 내용을 setup에 넣어야 하므로 넘기기 전에 번호를 받음
+            const uint32_t id = GetCaptureId(buffer);
+            if (id != kNullCaptureBuffer)
+                m_capture.UpdateBuffer(id, data, size);
+        }
+        m_backend.UpdateBuffer(buffer, data, size);
+    }
+
+    void CommandRecorder::UpdateBufferRange(GpuBufferHandle buffer, size_t offset, const void *data, size_t size)
+    {
+        if (m_capturing) {
+            const uint32_t id = GetCaptureId(buffer);
+            if (id != kNullCaptureBuffer)
+                m_capture.UpdateBufferRange(id, offset, data, size);
+        }
+        m_backend.UpdateBufferRange(buffer, offset, data, size);
+    }
+
+    void CommandRecorder::DestroyBuffer(GpuBufferHandle buffer)
+    {
+        auto it = m_bufferInfos.find(buffer.value);
+        if (it != m_bufferInfos.end()) {
+            if (m_capturing && it->second.captureId != kNullCaptureBuffer)
+                m_capture.DestroyBuffer(it->second.captureId);
+            m_bufferInfos.erase(it);
+        }
+        m_backend.DestroyBuffer(buffer);
+    }
+
+    void *CommandRecorder::MapBuffer(GpuBufferHandle buffer)
+    {
+        if (m_capturing)
+            GetCaptureId(buffer); // 덮어쓰기 전의 내용을 setup에 넣음
+        void *mapped = m_backend.MapBuffer(buffer);
+        m_mapped = mapped;
+        return mapped;
+    }
+
+    void CommandRecorder::UnmapBuffer(GpuBufferHandle buffer, size_t writtenBytes)
+    {
+        if (m_capturing && m_mapped) {
+            // Unmap 뒤에는 메모리를 읽을 수 없으므로 넘기기 전에 기록
+            const uint32_t id = GetCaptureId(buffer);
+            if (id != kNullCaptureBuffer)
+                m_capture.UpdateBuffer(id, m_mapped, writtenBytes);
+        }
+        m_mapped = nullptr;
+        m_backend.UnmapBuffer(buffer, writtenBytes);
+    }
+
+    void CommandRecorder::SetVertexBuffer(GpuBufferHandle buffer, uint32_t stride)
+    {
+        if (m_capturing)
+            m_capture.SetVertexBuffer(GetCaptureId(buffer), stride);
+        m_backend.SetVertexBuffer(buffer, stride);
+    }
+
+    void CommandRecorder::SetIndexBuffer(GpuBufferHandle buffer)
+    {
+        if (m_capturing)
+            m_capture.SetIndexBuffer(GetCaptureId(buffer));
+        m_backend.SetIndexBuffer(buffer);
+    }
+
+    void CommandRecorder::SetInstanceBuffer(GpuBufferHandle buffer, uint32_t stride, size_t offset)
+    {
+        if (m_capturing)
+            m_capture.SetInstanceBuffer(GetCaptureId(buffer), stride, offset);
+        m_backend.SetInstanceBuffer(buffer, stride, offset);
+    }
+
+    void CommandRecorder::SetConstantBuffer(uint32_t slot, GpuBufferHandle buffer)
+    {
+        if (m_capturing)
+            m_capture.SetConstantBuffer(slot, GetCaptureId(buffer));
+        m_backend.SetConstantBuffer(slot, buffer);
+    }
+
+    void CommandRecorder::SetConstantBufferRange(uint32_t slot, GpuBufferHandle buffer, size_t offset, size_t size)
+    {
+        if (m_capturing)
+            m_capture.SetConstantBufferRange(slot, GetCaptureId(buffer), offset, size);
+        m_backend.SetConstantBufferRange(slot, buffer, offset, size);
+    }
+
+    void CommandRecorder::SetShaderBuffer(uint32_t slot, GpuBufferHandle buffer)
+    {
+        if (m_capturing)
+            m_capture.SetShaderBuffer(slot, GetCaptureId(buffer));
+        m_backend.SetShaderBuffer(slot, buffer);
+    }
+
+    void CommandRecorder::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+    {
+        if (m_capturing)
+            m_capture.DrawIndexed(indexCount, startIndex, baseVertex);
+        m_backend.DrawIndexed(indexCount, startIndex, baseVertex);
+    }
+
+    void CommandRecorder::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex)
+    {
+        if (m_capturing)
+            m_capture.DrawIndexedInstanced(indexCount, instanceCount, startIndex);
+        m_backend.DrawIndexedInstanced(indexCount, instanceCount, startIndex);
+    }
+
+    RenderTargetHandle CommandRecorder::CreateRenderTarget(uint32_t width, uint32_t height)
+    {
+        return m_backend.CreateRenderTarget(width, height);
+    }
+
+    void CommandRecorder::DestroyRenderTarget(RenderTargetHandle target) { m_backend.DestroyRenderTarget(target); }
+
+    void CommandRecorder::SetRenderTarget(RenderTargetHandle target, const float clearColor[4])
+    {
+        m_backend.SetRenderTarget(target, clearColor);
+    }
+
+    void CommandRecorder::CopyToStaging(RenderTargetHandle target) { m_backend.CopyToStaging(target); }
+
+    bool CommandRecorder::TryReadStaging(RenderTargetHandle target, vector<uint8_t> &rgba)
+    {
+        return m_backend.TryReadStaging(target, rgba);
+    }
+
+    bool CommandRecorder::ReadBuffer(GpuBufferHandle buffer, vector<uint8_t> &data) const
+    {
+        return m_backend.ReadBuffer(buffer, data);
+    }
+
+    uint32_t CommandRecorder::GetCaptureId(GpuBufferHandle buffer)
+    {
+        auto it = m_bufferInfos.find(buffer.value);
+        if (it == m_bufferInfos.end())
+            return kNullCaptureBuffer; // 빈 핸들이나 이미 지운 버퍼 (감싼 백엔드가 오류로 셈)
+
+        BufferInfo &info = it->second;
+        if (info.captureId == kNullCaptureBuffer) {
+            // 읽을 수 없는 백엔드면 내용 없이 크기만 (재생 시간에는 영향이 없음)
+            const bool hasData = m_backend.ReadBuffer(buffer, m_readback) && m_readback.size() == info.size;
+            info.captureId =
+                m_capture.AddBuffer(info.type, hasData ? m_readback.data() : nullptr, info.size, info.dynamic);
+            m_capturedBuffers.push_back(buffer.value);
+        }
+        return info.captureId;
+    }
+
+    void CommandRecorder::SyncStats()
+    {
+        m_frameStats = m_backend.GetFrameStats();
+        m_totalStats = m_backend.GetTotalStats();
+    }
+#pragma endregion
+
+#pragma region CommandReplayer
+    bool CommandReplayer::Prepare(const CommandCapture &capture, RenderBackend &backend)
+    {
+        Release();
+        m_capture = &capture;
+        m_backend = &backend;
+        m_buffers.assign(capture.bufferCount, ReplayBuffer());
+
+        size_t offset = 0;
+        for (size_t i = 0; i < capture.setupCommands.size(); i++) {
+            const CaptureRecord &record = capture.setupCommands[i];
+            if (record.command != CaptureCommand::CreateBuffer || record.a >= capture.bufferCount) {
+                cout << "CommandReplayer: invalid setup command." << endl;
+                Release();
+                return false;
+            }
+            m_buffers[record.a].setupRecord = i;
+            m_buffers[record.a].setupOffset = offset;
+            Execute(record, capture.setupData.data() + offset);
+            offset += GetPayloadSize(record);
+        }
+
+        m_dataOffsets.resize(capture.frameCommands.size());
+        offset = 0;
+        for (size_t i = 0; i < capture.frameCommands.size(); i++) {
+            const CaptureRecord &record = capture.frameCommands[i];
+            m_dataOffsets[i] = offset;
+            offset += GetPayloadSize(record);
+            if (record.a >= capture.bufferCount)
+                continue;
+
+            ReplayBuffer &buffer = m_buffers[record.a];
+            if (record.command == CaptureCommand::CreateBuffer && !buffer.frameCreated) {
+                buffer.frameCreated = true;
+                m_frameCreatedBuffers.push_back(record.a);
+            }
+            else if ((record.command == CaptureCommand::UpdateBuffer ||
+                      record.command == CaptureCommand::UpdateBufferRange ||
+                      record.command == CaptureCommand::DestroyBuffer) &&
+                     buffer.setupRecord != SIZE_MAX &&
+                     find(m_restoreBuffers.begin(), m_restoreBuffers.end(), record.a) == m_restoreBuffers.end()) {
+                m_restoreBuffers.push_back(record.a);
+            }
+        }
+        return true;
+    }
+
+    void CommandReplayer::ReplayFrame(uint64_t *commandNs)
+    {
+        using Clock = chrono::steady_clock;
+        if (!m_capture)
+            return;
+
+        Restore();
+        const CommandCapture &capture = *m_capture;
+        const uint8_t *data = capture.frameData.data();
+        if (commandNs) {
+            for (size_t i = 0; i < capture.frameCommands.size(); i++) {
+                const auto start = Clock::now();
+                Execute(capture.frameCommands[i], data + m_dataOffsets[i]);
+                commandNs[i] += uint64_t(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start).count());
+            }
+        }
+        else {
+            for (size_t i = 0; i < capture.frameCommands.size(); i++)
+                Execute(capture.frameCommands[i], data + m_dataOffsets[i]);
+        }
+
+        // 프레임에서 만들고 지우지 않은 버퍼
+        for (uint32_t buffer : m_frameCreatedBuffers) {
+            if (!m_buffers[buffer].handle.IsNull()) {
+                m_backend->DestroyBuffer(m_buffers[buffer].handle);
+                m_buffers[buffer].handle = GpuBufferHandle();
+            }
+        }
+    }
+
+    void CommandReplayer::Release()
+    {
+        if (m_backend) {
+            for (ReplayBuffer &buffer : m_buffers) {
+                if (!buffer.handle.IsNull())
+                    m_backend->DestroyBuffer(buffer.handle);
+            }
+        }
+        m_buffers.clear();
+        m_dataOffsets.clear();
+        m_restoreBuffers.clear();
+        m_frameCreatedBuffers.clear();
+        m_capture = nullptr;
+        m_backend = nullptr;
+    }
+
+    void CommandReplayer::Execute(const CaptureRecord &record, const uint8_t *data)
+    {
+        auto handle = [&](uint32_t id) { return id < m_buffers.size() ? m_buffers[id].handle : GpuBufferHandle(); };
+
+        switch (record.command) {
+        case CaptureCommand::BeginFrame:
+            m_backend->BeginFrame();
+            break;
+        case CaptureCommand::EndFrame:
+            m_backend->EndFrame();
+            break;
+        case CaptureCommand::CreateBuffer:
+            m_buffers[record.a].handle =
+                m_backend->CreateBuffer(GpuBufferType(record.c & 0xFF), (record.c & kHasDataFlag) ? data : nullptr,
+                                        record.b, (record.c & kDynamicFlag) != 0);
+            break;
+        case CaptureCommand::UpdateBuffer:
+            m_backend->UpdateBuffer(handle(record.a), data, record.b);
+            break;
+        case CaptureCommand::DestroyBuffer:
+            if (!handle(record.a).IsNull()) {
+                m_backend->DestroyBuffer(m_buffers[record.a].handle);
+                m_buffers[record.a].handle = GpuBufferHandle();
+            }
+            break;
+        case CaptureCommand::SetVertexBuffer:
+            m_backend->SetVertexBuffer(handle(record.a), record.b);
+            break;
+        case CaptureCommand::SetIndexBuffer:
+            m_backend->SetIndexBuffer(handle(record.a));
+            break;
+        case CaptureCommand::SetConstantBuffer:
+            m_backend->SetConstantBuffer(record.a, handle(record.b));
+            break;
+        case CaptureCommand::DrawIndexed:
+            m_backend->DrawIndexed(record.a, record.b, record.c);
+            break;
+        case CaptureCommand::SetInstanceBuffer:
+            m_backend->SetInstanceBuffer(handle(record.a), record.b, size_t(record.c));
+            break;
+        case CaptureCommand::DrawIndexedInstanced:
+            m_backend->DrawIndexedInstanced(record.a, record.b, uint32_t(record.c));
+            break;
+        case CaptureCommand::SetShaderBuffer:
+            m_backend->SetShaderBuffer(record.a, handle(record.b));
+            break;
+        case CaptureCommand::UpdateBufferRange:
+            m_backend->UpdateBufferRange(handle(record.a), uint32_t(record.c), data, record.b);
+            break;
+        case CaptureCommand::SetConstantBufferRange:
+            m_backend->SetConstantBufferRange(record.a & 0xFF, handle(record.b), size_t(record.c) * 16,
+                                              size_t(record.a >> 8) * 16);
+            break;
+        default: // SetPipeline: 헤드리스 백엔드에는 파이프라인이 없음
+            break;
+        }
+    }
+
+    void CommandReplayer::Restore()
+    {
+        // 지난 반복에서 지운 setup 버퍼는 다시 만들고, 바꾼 버퍼는 캡처 시작 때의 내용으로
+        for (uint32_t id : m_restoreBuffers) {
+            ReplayBuffer &buffer = m_buffers[id];
+            const CaptureRecord &record = m_capture->setupCommands[buffer.setupRecord];
+            const uint8_t *data = m_capture->setupData.data() + buffer.setupOffset;
+            if (buffer.handle.IsNull())
+                Execute(record, data);
+            else if ((record.c & kHasDataFlag) && (record.c & kDynamicFlag))
+                m_backend->UpdateBuffer(buffer.handle, data, record.b);
+            else if (record.c & kHasDataFlag)
+                m_backend->UpdateBufferRange(buffer.handle, 0, data, record.b);
+        }
+    }
+#pragma endregion
+}
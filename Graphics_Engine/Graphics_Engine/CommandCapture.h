@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+#include "RenderBackend.h"
+
+namespace luke {
+
+    // 캡처한 명령의 종류. 값은 파일에 그대로 저장되므로 바꾸지 마세요.
+    enum class CaptureCommand : uint32_t {
+        BeginFrame,
+        EndFrame,
+        CreateBuffer,         // a: 버퍼, b: 크기, c: 타입 | dynamic << 8 | 데이터 있음 << 9
+        UpdateBuffer,         // a: 버퍼, b: 크기
+        DestroyBuffer,        // a: 버퍼
+        SetVertexBuffer,      // a: 버퍼, b: stride
+        SetIndexBuffer,       // a: 버퍼
+        SetConstantBuffer,    // a: 슬롯, b: 버퍼
+        SetPipeline,          // a: 파이프라인 (D3D11 쪽 핸들 값. 헤드리스 재생에서는 아무것도 하지 않음)
+        DrawIndexed,          // a: 인덱스 수, b: 시작 인덱스, c: baseVertex
+        SetInstanceBuffer,    // a: 버퍼, b: stride, c: 시작 바이트
+        DrawIndexedInstanced, // a: 인덱스 수, b: 인스턴스 수, c: 시작 인덱스
+        SetShaderBuffer,      // a: 슬롯, b: 버퍼
+        UpdateBufferRange,    // a: 버퍼, b: 크기, c: 시작 바이트
+        SetConstantBufferRange, // a: 슬롯 | 상수 수 << 8, b: 버퍼, c: 첫 상수 (상수 하나는 16바이트)
+        Count
+    };
+
+    const char *GetCaptureCommandName(CaptureCommand command);
+
+    // 명령 하나 (16바이트). 버퍼 내용은 명령 순서대로 data 배열에 이어 붙임
+    struct CaptureRecord {
+        CaptureCommand command = CaptureCommand::BeginFrame;
+        uint32_t a = 0;
+        uint32_t b = 0;
+        int32_t c = 0;
+    };
+
+    static_assert(sizeof(CaptureRecord) == 16);
+
+    // 캡처 안에서 쓰는 버퍼 번호. 빈 핸들은 kNullCaptureBuffer
+    constexpr uint32_t kNullCaptureBuffer = 0xFFFFFFFF;
+
+    // 한 프레임의 명령 스트림
+    // setup: 캡처를 시작하기 전에 만들어진 버퍼를 처음 쓰일 때의 내용으로 만드는 CreateBuffer 명령들
+    // frame: 실제로 기록한 명령들 (BeginFrame ~ EndFrame)
+    // 재생은 setup을 한 번 실행하고 frame을 반복합니다. (CommandReplayer)
+    struct CommandCapture {
+        uint32_t bufferCount = 0;
+        std::vector<CaptureRecord> setupCommands;
+        std::vector<uint8_t> setupData;
+        std::vector<CaptureRecord> frameCommands;
+        std::vector<uint8_t> frameData;
+
+        void Clear();
+        // 이미 있던 버퍼를 setup에 추가하고 캡처 안의 번호를 반환
+        uint32_t AddBuffer(GpuBufferType type, const void *data, size_t size, bool dynamic);
+
+        // frame에 기록
+        uint32_t CreateBuffer(GpuBufferType type, const void *data, size_t size, bool dynamic);
+        void UpdateBuffer(uint32_t buffer, const void *data, size_t size);
+        void DestroyBuffer(uint32_t buffer);
+        void SetVertexBuffer(uint32_t buffer, uint32_t stride);
+        void SetIndexBuffer(uint32_t buffer);
+        void SetConstantBuffer(uint32_t slot, uint32_t buffer);
+        void SetPipeline(uint32_t pipeline);
+        void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex);
+        void SetInstanceBuffer(uint32_t buffer, uint32_t stride, size_t offset = 0);
+        void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex);
+        void SetShaderBuffer(uint32_t slot, uint32_t buffer);
+        void UpdateBufferRange(uint32_t buffer, size_t offset, const void *data, size_t size);
+        void SetConstantBufferRange(uint32_t slot, uint32_t buffer, size_t offset, size_t size);
+        void Add(CaptureCommand command, uint32_t a = 0, uint32_t b = 0, int32_t c = 0);
+
+        uint64_t GetFileSize() const;
+    };
+
+    // [헤더][setup 명령][frame 명령][setup 데이터][frame 데이터] (리틀 엔디언)
+    bool SaveCommandCapture(const std::filesystem::path &path, const CommandCapture &capture);
+    // 명령이 가리키는 버퍼 번호와 데이터 크기가 맞는지까지 확인
+    bool LoadCommandCapture(const std::filesystem::path &path, CommandCapture &capture);
+
+    // 다른 백엔드를 감싸서 모든 명령을 그대로 넘기고, RequestCapture() 다음 프레임의 명령을 기록하는 백엔드
+    // 감싼 백엔드가 만든 버퍼의 내용은 처음 쓰일 때 ReadBuffer()로 읽어서 setup에 넣습니다.
+    class CommandRecorder : public RenderBackend {
+    public:
+        explicit CommandRecorder(RenderBackend &backend) : m_backend(backend) {}
+
+        // 다음 BeginFrame()부터 EndFrame()까지 기록
+        void RequestCapture() { m_captureRequested = true; }
+        bool IsCapturing() const { return m_capturing; }
+        bool HasCapture() const { return m_hasCapture; }
+        const CommandCapture &GetCapture() const { return m_capture; }
+
+        void BeginFrame() override;
+        void EndFrame() override;
+
+        GpuBufferHandle CreateBuffer(GpuBufferType type, const void *data, size_t size,
+                                     bool dynamic) override;
+        void UpdateBuffer(GpuBufferHandle buffer, const void *data, size_t size) override;
+        void UpdateBufferRange(GpuBufferHandle buffer, size_t offset, const void *data, size_t size) override;
+        void DestroyBuffer(GpuBufferHandle buffer) override;
+        // Map한 메모리에 쓴 내용은 UnmapBuffer()에서 UpdateBuffer 명령으로 기록
+        void *MapBuffer(GpuBufferHandle buffer) override;
+        void UnmapBuffer(GpuBufferHandle buffer, size_t writtenBytes) override;
+
+        void SetVertexBuffer(GpuBufferHandle buffer, uint32_t stride) override;
+        void SetIndexBuffer(GpuBufferHandle buffer) override;
+        void SetInstanceBuffer(GpuBufferHandle buffer, uint32_t stride, size_t offset = 0) override;
+        void SetConstantBuffer(uint32_t slot, GpuBufferHandle buffer) override;
+        void SetConstantBufferRange(uint32_t slot, GpuBufferHandle buffer, size_t offset, size_t size) override;
+        void SetShaderBuffer(uint32_t slot, GpuBufferHandle buffer) override;
+        void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+        void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex) override;
+
+        // 렌더 타겟은 기록하지 않고 넘기기만 함
+        RenderTargetHandle CreateRenderTarget(uint32_t width, uint32_t height) override;
+        void DestroyRenderTarget(RenderTargetHandle target) override;
+        void SetRenderTarget(RenderTargetHandle target, const float clearColor[4]) override;
+        void CopyToStaging(RenderTargetHandle target) override;
+        bool TryReadStaging(RenderTargetHandle target, std::vector<uint8_t> &rgba) override;
+
+        bool ReadBuffer(GpuBufferHandle buffer, std::vector<uint8_t> &data) const override;
+        uint64_t GetErrorCount() const override { return m_backend.GetErrorCount(); }
+
+    private:
+        struct BufferInfo {
+            GpuBufferType type = GpuBufferType::Vertex;
+            bool dynamic = false;
+            size_t size = 0;
+            uint32_t captureId = kNullCaptureBuffer; // 이번 캡처에서 아직 쓰이지 않았으면 kNull
+        };
+
+        // 처음 쓰이면 지금 내용으로 setup에 추가
+        uint32_t GetCaptureId(GpuBufferHandle buffer);
+        void SyncStats();
+
+        RenderBackend &m_backend;
+        std::unordered_map<uint32_t, BufferInfo> m_bufferInfos; // Handle::value
+        std::vector<uint32_t> m_capturedBuffers;                // 캡처가 끝나면 captureId를 되돌릴 버퍼
+        std::vector<uint8_t> m_readback;
+        const void *m_mapped = nullptr; // MapBuffer() ~ UnmapBuffer()
+        CommandCapture m_capture;
+        bool m_captureRequested = false;
+        bool m_capturing = false;
+        bool m_hasCapture = false;
+    };
+
+    // 캡처를 백엔드에 반복해서 재생하고 명령마다 시간을 잽니다.
+    // 반복할 때마다 같은 결과가 나오도록 프레임이 바꾸거나 지운 setup 버퍼는 매 ReplayFrame() 시작에
+    // 캡처 시작 때의 상태로 되돌리고, 프레임에서 만들고 지우지 않은 버퍼는 끝에 지웁니다.
+    // (둘 다 시간 측정에서 빠짐)
+    class CommandReplayer {
+    public:
+        ~CommandReplayer() { Release(); }
+
+        // setup 명령을 실행해서 버퍼를 만듦. capture는 Release()까지 살아 있어야 합니다.
+        bool Prepare(const CommandCapture &capture, RenderBackend &backend);
+        // commandNs가 있으면 frame 명령마다 걸린 시간(ns)을 더함 (frameCommands와 같은 크기)
+        void ReplayFrame(uint64_t *commandNs = nullptr);
+        void Release();
+
+    private:
+        struct ReplayBuffer {
+            GpuBufferHandle handle;
+            size_t setupRecord = SIZE_MAX; // setupCommands 안의 CreateBuffer (setup 버퍼만)
+            size_t setupOffset = 0;        // setupData 안의 내용
+            bool frameCreated = false;     // frame에서 CreateBuffer
+        };
+
+        void Execute(const CaptureRecord &record, const uint8_t *data);
+        void Restore();
+
+        const CommandCapture *m_capture = nullptr;
+        RenderBackend *m_backend = nullptr;
+        std::vector<ReplayBuffer> m_buffers;         // 캡처 번호 -> 버퍼
+        std::vector<size_t> m_dataOffsets;           // frame 명령 -> frameData 위치
+        std::vector<uint32_t> m_restoreBuffers;      // 프레임이 바꾸거나 지우는 setup 버퍼
+        std::vector<uint32_t> m_frameCreatedBuffers;
+    };
+}
@@ -0,0 +1,229 @@
+#include "D3D11Memory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        // {5B1C7E2A-9D43-4F6B-A1E8-3C2D7F90B614}
+        const GUID kGpuAllocationGuid = {0x5b1c7e2a, 0x9d43, 0x4f6b, {0xa1, 0xe8, 0x3c, 0x2d, 0x7f, 0x90, 0xb6, 0x14}};
+
+        // 리소스의 private data로 붙어서, 리소스가 해제될 때 같이 해제되며 기록을 지움
+        class GpuAllocationReleaser : public IUnknown {
+        public:
+            GpuAllocationReleaser(GpuMemoryTracker &tracker, GpuAllocationId id) : m_tracker(tracker), m_id(id) {}
+
+            HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **object) override
+            {
+                if (!object)
+                    return E_POINTER;
+                if (riid != __uuidof(IUnknown)) {
+                    *object = nullptr;
+                    return E_NOINTERFACE;
+                }
+                AddRef();
+                *object = static_cast<IUnknown *>(this);
+                return S_OK;
+            }
+
+            ULONG STDMETHODCALLTYPE AddRef() override { return ++m_references; }
+
+            ULONG STDMETHODCALLTYPE Release() override
+            {
+                const ULONG references = --m_references;
+                if (references == 0) {
+                    m_tracker.Free(m_id);
+                    delete this;
+                }
+                return references;
+            }
+
+        private:
+            GpuMemoryTracker &m_tracker;
+            GpuAllocationId m_id;
+            atomic<ULONG> m_references{1};
+        };
+
+        void Attach(ID3D11DeviceChild *resource, GpuMemoryTracker &tracker, GpuAllocationId id)
+        {
+            GpuAllocationReleaser *releaser = new GpuAllocationReleaser(tracker, id);
+            // 리소스가 AddRef()하므로 여기서 만든 참조는 바로 놓음. 실패하면 이 Release()가 기록을 지움
+            resource->SetPrivateDataInterface(kGpuAllocationGuid, releaser);
+            releaser->Release();
+        }
+
+        // 텍셀당 비트 (블록 압축 형식은 4x4 블록을 16텍셀로 나눈 값)
+        uint32_t GetBitsPerTexel(DXGI_FORMAT format)
+        {
+            switch (format) {
+            case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+            case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            case DXGI_FORMAT_R32G32B32A32_UINT:
+                return 128;
+            case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+            case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            case DXGI_FORMAT_R16G16B16A16_UNORM:
+            case DXGI_FORMAT_R32G32_FLOAT:
+            case DXGI_FORMAT_R32G8X24_TYPELESS:
+            case DXGI_FORMAT_D32_FLOAT_S8X24_UINT:
+                return 64;
+            case DXGI_FORMAT_R16G16_FLOAT:
+            case DXGI_FORMAT_R16_FLOAT:
+            case DXGI_FORMAT_R16_UNORM:
+            case DXGI_FORMAT_R16_TYPELESS:
+            case DXGI_FORMAT_D16_UNORM:
+            case DXGI_FORMAT_R8G8_UNORM:
+                return 16;
+            case DXGI_FORMAT_R8_UNORM:
+            case DXGI_FORMAT_R8_UINT:
+            case DXGI_FORMAT_R8_TYPELESS:
+            case DXGI_FORMAT_A8_UNORM:
+                return 8;
+            case DXGI_FORMAT_BC1_TYPELESS:
+            case DXGI_FORMAT_BC1_UNORM:
+            case DXGI_FORMAT_BC1_UNORM_SRGB:
+            case DXGI_FORMAT_BC4_TYPELESS:
+            case DXGI_FORMAT_BC4_UNORM:
+            case DXGI_FORMAT_BC4_SNORM:
+                return 4;
+            case DXGI_FORMAT_BC2_TYPELESS:
+            case DXGI_FORMAT_BC2_UNORM:
+            case DXGI_FORMAT_BC2_UNORM_SRGB:
+            case DXGI_FORMAT_BC3_TYPELESS:
+            case DXGI_FORMAT_BC3_UNORM:
+            case DXGI_FORMAT_BC3_UNORM_SRGB:
+            case DXGI_FORMAT_BC5_TYPELESS:
+            case DXGI_FORMAT_BC5_UNORM:
+            case DXGI_FORMAT_BC5_SNORM:
+            case DXGI_FORMAT_BC6H_TYPELESS:
+            case DXGI_FORMAT_BC6H_UF16:
+            case DXGI_FORMAT_BC6H_SF16:
+            case DXGI_FORMAT_BC7_TYPELESS:
+            case DXGI_FORMAT_BC7_UNORM:
+            case DXGI_FORMAT_BC7_UNORM_SRGB:
+                return 8;
+            default:
+                // RGBA8, BGRA8, R10G10B10A2, R11G11B10, R32, D24S8 등 대부분의 렌더 타겟 형식
+                return 32;
+            }
+        }
+
+        bool IsBlockCompressed(DXGI_FORMAT format)
+        {
+            return (format >= DXGI_FORMAT_BC1_TYPELESS && format <= DXGI_FORMAT_BC5_SNORM) ||
+                   (format >= DXGI_FORMAT_BC6H_TYPELESS && format <= DXGI_FORMAT_BC7_UNORM_SRGB);
+        }
+    }
+
+    GpuMemoryCategory GetGpuMemoryCategory(const D3D11_BUFFER_DESC &desc)
+    {
+        if (desc.Usage == D3D11_USAGE_STAGING)
+            return GpuMemoryCategory::Staging;
+        if (desc.BindFlags & D3D11_BIND_INDEX_BUFFER)
+            return GpuMemoryCategory::IndexBuffer;
+        if (desc.BindFlags & D3D11_BIND_CONSTANT_BUFFER)
+            return GpuMemoryCategory::ConstantBuffer;
+        if (desc.BindFlags & D3D11_BIND_VERTEX_BUFFER)
+            return GpuMemoryCategory::VertexBuffer;
+        return GpuMemoryCategory::StructuredBuffer;
+    }
+
+    GpuMemoryCategory GetGpuMemoryCategory(const D3D11_TEXTURE2D_DESC &desc)
+    {
+        if (desc.Usage == D3D11_USAGE_STAGING)
+            return GpuMemoryCategory::Staging;
+        if (desc.BindFlags & D3D11_BIND_DEPTH_STENCIL)
+            return GpuMemoryCategory::DepthStencil;
+        if (desc.BindFlags & D3D11_BIND_RENDER_TARGET)
+            return GpuMemoryCategory::RenderTarget;
+        return GpuMemoryCategory::Texture;
+    }
+
+    uint64_t GetGpuMemoryBytes(const D3D11_TEXTURE2D_DESC &desc)
+    {
+        const bool blocks = IsBlockCompressed(desc.Format);
+        const uint32_t bits = GetBitsPerTexel(desc.Format);
+        // MipLevels가 0이면 1x1까지 전부
+        uint32_t mipCount = desc.MipLevels;
+        if (mipCount == 0) {
+            for (uint32_t size = (std::max)(desc.Width, desc.Height); size > 0; size >>= 1)
+                mipCount++;
+        }
+
+        uint64_t bytes = 0;
+        for (uint32_t mip = 0; mip < mipCount; mip++) {
+            uint64_t width = (std::max)(desc.Width >> mip, 1u);
+            uint64_t height = (std::max)(desc.Height >> mip, 1u);
+            if (blocks) {
+                width = (width + 3) & ~3ull;
+                height = (height + 3) & ~3ull;
+            }
+            bytes += width * height * bits / 8;
+        }
+        return bytes * (std::max)(desc.ArraySize, 1u) * (std::max)(desc.SampleDesc.Count, 1u);
+    }
+
+    HRESULT CreateTrackedBuffer(ID3D11Device *device, GpuMemoryTracker &tracker, const D3D11_BUFFER_DESC &desc,
+                                const D3D11_SUBRESOURCE_DATA *data, ID3D11Buffer **buffer, const char *owner)
+    {
+        const GpuAllocationId id = tracker.Allocate(GetGpuMemoryCategory(desc), desc.ByteWidth, owner);
+        if (id == kInvalidGpuAllocation) {
+            cout << "CreateBuffer() over the GPU memory budget (" << desc.ByteWidth << " bytes)." << endl;
+            return E_OUTOFMEMORY;
+        }
+
+        const HRESULT hr = device->CreateBuffer(&desc, data, buffer);
+        if (FAILED(hr)) {
+            tracker.Free(id);
+            return hr;
+        }
+        Attach(*buffer, tracker, id);
+        return hr;
+    }
+
+    HRESULT CreateTrackedTexture2D(ID3D11Device *device, GpuMemoryTracker &tracker,
+                                   const D3D11_TEXTURE2D_DESC &desc, const D3D11_SUBRESOURCE_DATA *data,
+                                   ID3D11Texture2D **texture, const char *owner)
+    {
+        const uint64_t bytes = GetGpuMemoryBytes(desc);
+        const GpuAllocationId id = tracker.Allocate(GetGpuMemoryCategory(desc), bytes, owner);
+        if (id == kInvalidGpuAllocation) {
+            cout << "CreateTexture2D() over the GPU memory budget (" << bytes << " bytes)." << endl;
+            return E_OUTOFMEMORY;
+        }
+
+        const HRESULT hr = device->CreateTexture2D(&desc, data, texture);
+        if (FAILED(hr)) {
+            tracker.Free(id);
+            return hr;
+        }
+        Attach(*texture, tracker, id);
+        return hr;
+    }
+
+    void TrackTexture(GpuMemoryTracker &tracker, ID3D11Texture2D *texture, uint32_t copies, const char *owner)
+    {
+        if (!texture)
+            return;
+
+        IUnknown *existing = nullptr;
+        UINT size = sizeof(existing);
+        if (SUCCEEDED(texture->GetPrivateData(kGpuAllocationGuid, &size, &existing))) {
+            existing->Release();
+            return;
+        }
+
+        D3D11_TEXTURE2D_DESC desc;
+        texture->GetDesc(&desc);
+        const uint64_t bytes = GetGpuMemoryBytes(desc) * copies;
+        const GpuAllocationId id = tracker.Allocate(GetGpuMemoryCategory(desc), bytes, owner);
+        if (id == kInvalidGpuAllocation) {
+            cout << "Existing texture is over the GPU memory budget (" << bytes << " bytes)." << endl;
+            return;
+        }
+        Attach(texture, tracker, id);
+    }
+}
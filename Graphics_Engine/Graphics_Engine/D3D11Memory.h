@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <d3d11.h>
+
+#include "GpuMemory.h"
+
+namespace luke {
+
+    // desc의 Usage/BindFlags로 정한 분류 (STAGING이 먼저, 텍스처는 깊이 > 렌더 타겟 > 텍스처 순서)
+    GpuMemoryCategory GetGpuMemoryCategory(const D3D11_BUFFER_DESC &desc);
+    GpuMemoryCategory GetGpuMemoryCategory(const D3D11_TEXTURE2D_DESC &desc);
+
+    // 모든 밉, 배열, MSAA 샘플을 더한 크기 (블록 압축 형식은 4x4 블록 단위로 올림)
+    // 드라이버의 정렬과 패딩은 모르므로 실제 사용량보다 조금 작을 수 있습니다.
+    uint64_t GetGpuMemoryBytes(const D3D11_TEXTURE2D_DESC &desc);
+
+    // tracker에 기록한 뒤 리소스를 만듦. 리소스의 참조가 모두 없어지면 tracker에서 저절로 지워짐
+    // (SetPrivateDataInterface()로 붙인 객체가 리소스와 함께 해제될 때 Free())
+    // 예산을 넘으면 E_OUTOFMEMORY를 반환하고 만들지 않습니다. tracker는 리소스보다 오래 살아 있어야 합니다.
+    HRESULT CreateTrackedBuffer(ID3D11Device *device, GpuMemoryTracker &tracker, const D3D11_BUFFER_DESC &desc,
+                                const D3D11_SUBRESOURCE_DATA *data, ID3D11Buffer **buffer,
+                                const char *owner = nullptr);
+    HRESULT CreateTrackedTexture2D(ID3D11Device *device, GpuMemoryTracker &tracker,
+                                   const D3D11_TEXTURE2D_DESC &desc, const D3D11_SUBRESOURCE_DATA *data,
+                                   ID3D11Texture2D **texture, const char *owner = nullptr);
+
+    // 직접 만들지 않은 텍스처(스왑 체인의 백 버퍼)를 copies장으로 기록. 이미 기록된 텍스처면 아무것도 하지 않음
+    // 이미 있는 리소스이므로 hard 예산을 넘어도 지우지 않고, 기록만 빠진 채 failedAllocations에 셉니다.
+    void TrackTexture(GpuMemoryTracker &tracker, ID3D11Texture2D *texture, uint32_t copies = 1,
+                      const char *owner = nullptr);
+}
@@ -0,0 +1,69 @@
+#include "D3D11Texture.h"
+
+#include <iostream>
+#include <vector>
+
+#include "D3D11Memory.h"
+
+namespace luke {
+    using namespace std;
+
+    DXGI_FORMAT GetDxgiFormat(TextureFormat format, bool srgb)
+    {
+        switch (format) {
+        case TextureFormat::RGBA8:
+            return srgb ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+        case TextureFormat::BC1:
+            return srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+        case TextureFormat::BC3:
+            return srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+        case TextureFormat::BC7:
+            return srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+        }
+        return DXGI_FORMAT_UNKNOWN;
+    }
+
+    bool CreateTextureFromFile(ID3D11Device *device, const MappedTextureFile &file,
+                               ComPtr<ID3D11Texture2D> &texture, ComPtr<ID3D11ShaderResourceView> &view,
+                               GpuMemoryTracker *tracker)
+    {
+        if (!file.IsOpen())
+            return false;
+
+        const TextureFileHeader &header = file.GetHeader();
+        if (IsBlockCompressed(file.GetFormat()) && (header.width % 4 != 0 || header.height % 4 != 0)) {
+            cout << "Block-compressed texture size must be a multiple of 4 (" << header.width << "x"
+                 << header.height << ")." << endl;
+            return false;
+        }
+
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.Width = header.width;
+        desc.Height = header.height;
+        desc.MipLevels = header.mipCount;
+        desc.ArraySize = 1;
+        desc.Format = GetDxgiFormat(file.GetFormat(), file.IsSrgb());
+        desc.SampleDesc.Count = 1;
+        desc.Usage = D3D11_USAGE_IMMUTABLE;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        vector<D3D11_SUBRESOURCE_DATA> mips(header.mipCount);
+        for (uint32_t mip = 0; mip < header.mipCount; mip++) {
+            mips[mip].pSysMem = file.GetMipData(mip);
+            mips[mip].SysMemPitch = file.GetMip(mip).rowPitch;
+        }
+
+        const HRESULT hr =
+            tracker ? CreateTrackedTexture2D(device, *tracker, desc, mips.data(), texture.ReleaseAndGetAddressOf())
+                    : device->CreateTexture2D(&desc, mips.data(), texture.ReleaseAndGetAddressOf());
+        if (FAILED(hr)) {
+            cout << "CreateTexture2D() failed." << endl;
+            return false;
+        }
+        if (FAILED(device->CreateShaderResourceView(texture.Get(), nullptr, view.ReleaseAndGetAddressOf()))) {
+            cout << "CreateShaderResourceView() failed." << endl;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl.h> // ComPtr
+
+#include "GpuMemory.h"
+#include "TexturePipeline.h"
+
+namespace luke {
+
+    using Microsoft::WRL::ComPtr;
+
+    DXGI_FORMAT GetDxgiFormat(TextureFormat format, bool srgb);
+
+    // 매핑한 .ltex 파일의 밉을 복사 없이 D3D11_SUBRESOURCE_DATA로 넘겨서 IMMUTABLE 텍스처와 SRV를 만듦
+    // 블록 압축 형식은 첫 밉의 가로/세로가 4의 배수여야 합니다.
+    // tracker가 있으면 Texture 분류로 기록합니다. (D3D11Memory.h)
+    bool CreateTextureFromFile(ID3D11Device *device, const MappedTextureFile &file,
+                               ComPtr<ID3D11Texture2D> &texture, ComPtr<ID3D11ShaderResourceView> &view,
+                               GpuMemoryTracker *tracker = nullptr);
+}
@@ -0,0 +1,66 @@
+#include "D3D11Timestamps.h"
+
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    bool D3D11Timestamps::Initialize(ID3D11Device *device, ID3D11DeviceContext *context)
+    {
+        m_device = device;
+        m_context = context;
+
+        D3D11_QUERY_DESC desc = {};
+        desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+        for (Slot &slot : m_slots) {
+            if (FAILED(m_device->CreateQuery(&desc, slot.disjoint.ReleaseAndGetAddressOf()))) {
+                cout << "CreateQuery() failed." << endl;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void D3D11Timestamps::BeginTimestampFrame(uint32_t frameSlot)
+    {
+        m_context->Begin(m_slots[frameSlot].disjoint.Get());
+    }
+
+    void D3D11Timestamps::EndTimestampFrame(uint32_t frameSlot)
+    {
+        m_context->End(m_slots[frameSlot].disjoint.Get());
+    }
+
+    void D3D11Timestamps::WriteTimestamp(uint32_t frameSlot, uint32_t index)
+    {
+        ComPtr<ID3D11Query> &query = m_slots[frameSlot].timestamps[index];
+        if (!query) {
+            D3D11_QUERY_DESC desc = {};
+            desc.Query = D3D11_QUERY_TIMESTAMP;
+            if (FAILED(m_device->CreateQuery(&desc, query.GetAddressOf())))
+                return;
+        }
+        m_context->End(query.Get()); // 타임스탬프 쿼리는 End()만 호출
+    }
+
+    bool D3D11Timestamps::TryReadTimestamps(uint32_t frameSlot, uint32_t count, uint64_t *ticks,
+                                            uint64_t &frequency)
+    {
+        Slot &slot = m_slots[frameSlot];
+
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+        if (m_context->GetData(slot.disjoint.Get(), &disjoint, sizeof(disjoint),
+                               D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+            return false;
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (!slot.timestamps[i] ||
+                m_context->GetData(slot.timestamps[i].Get(), &ticks[i], sizeof(uint64_t),
+                                   D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+                return false;
+        }
+
+        frequency = disjoint.Disjoint ? 0 : disjoint.Frequency;
+        return true;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl.h> // ComPtr
+
+#include "Profiler.h"
+
+namespace luke {
+
+    using Microsoft::WRL::ComPtr;
+
+    // D3D11 타임스탬프 쿼리로 구현한 GpuTimestamps
+    // 프레임 슬롯마다 disjoint 쿼리 하나와 타임스탬프 쿼리 kMaxTimestamps개를 두고,
+    // 결과는 D3D11_ASYNC_GETDATA_DONOTFLUSH로 기다리지 않고 읽습니다.
+    class D3D11Timestamps : public GpuTimestamps {
+    public:
+        bool Initialize(ID3D11Device *device, ID3D11DeviceContext *context);
+
+        void BeginTimestampFrame(uint32_t frameSlot) override;
+        void EndTimestampFrame(uint32_t frameSlot) override;
+        void WriteTimestamp(uint32_t frameSlot, uint32_t index) override;
+        bool TryReadTimestamps(uint32_t frameSlot, uint32_t count, uint64_t *ticks,
+                               uint64_t &frequency) override;
+
+    private:
+        struct Slot {
+            ComPtr<ID3D11Query> disjoint;
+            ComPtr<ID3D11Query> timestamps[Profiler::kMaxTimestamps]; // 처음 쓸 때 만듦
+        };
+
+        ComPtr<ID3D11Device> m_device;
+        ComPtr<ID3D11DeviceContext> m_context;
+        Slot m_slots[Profiler::kLatency];
+    };
+}
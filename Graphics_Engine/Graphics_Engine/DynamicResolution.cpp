@@ -0,0 +1,133 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        // 프레임 하나가 튀어도 바로 반응하지 않도록 평균에 반영하는 비율
+        constexpr float kAverageWeight = 0.1f;
+    }
+
+    DynamicResolutionController::DynamicResolutionController(const DynamicResolutionSettings &settings)
+    {
+        SetSettings(settings);
+        m_scale = m_settings.maxScale;
+        m_msaaSamples = m_settings.maxMsaaSamples;
+    }
+
+    void DynamicResolutionController::SetSettings(const DynamicResolutionSettings &settings)
+    {
+        m_settings = settings;
+        m_settings.maxScale = clamp(m_settings.maxScale, 0.1f, 1.0f);
+        m_settings.minScale = clamp(m_settings.minScale, 0.1f, m_settings.maxScale);
+        m_settings.scaleStep = max(m_settings.scaleStep, 0.01f);
+        m_settings.maxMsaaSamples = max(m_settings.maxMsaaSamples, 1u);
+
+        m_scale = clamp(m_scale, m_settings.minScale, m_settings.maxScale);
+        m_msaaSamples = m_settings.adjustMsaa ? min(m_msaaSamples, m_settings.maxMsaaSamples)
+                                              : m_settings.maxMsaaSamples;
+        Reset();
+    }
+
+    void DynamicResolutionController::Reset()
+    {
+        m_hasSample = false;
+        m_averageMs = 0.0f;
+        m_slowFrames = 0;
+        m_fastFrames = 0;
+        m_cooldown = 0;
+    }
+
+    bool DynamicResolutionController::Update(float frameMs)
+    {
+        m_frame++;
+        if (!(frameMs > 0.0f))
+            return false;
+
+        m_averageMs = m_hasSample ? m_averageMs + (frameMs - m_averageMs) * kAverageWeight : frameMs;
+        m_hasSample = true;
+
+        // 방금 바꾼 해상도의 비용이 평균에 충분히 반영될 때까지 기다림
+        if (m_cooldown > 0) {
+            m_cooldown--;
+            return false;
+        }
+
+        const float ratio = m_averageMs / m_settings.targetFrameMs;
+        if (ratio > m_settings.decreaseThreshold) {
+            m_slowFrames++;
+            m_fastFrames = 0;
+        }
+        else if (ratio < m_settings.increaseThreshold) {
+            m_fastFrames++;
+            m_slowFrames = 0;
+        }
+        else {
+            m_slowFrames = 0;
+            m_fastFrames = 0;
+        }
+
+        if (m_slowFrames >= m_settings.decreaseFrames) {
+            if (m_scale > m_settings.minScale) {
+                // 픽셀 수가 배율의 제곱이므로 목표에 맞는 배율은 sqrt(목표 / 현재)배
+                const float fitted = Quantize(m_scale * sqrt(1.0f / ratio));
+                const float scale = max(min(fitted, m_scale - m_settings.scaleStep), m_settings.minScale);
+                Apply(scale, m_msaaSamples);
+                return true;
+            }
+            if (m_settings.adjustMsaa && m_msaaSamples > 1) {
+                Apply(m_scale, 1);
+                return true;
+            }
+            m_slowFrames = 0; // 더 낮출 수 없음
+        }
+        else if (m_fastFrames >= m_settings.increaseFrames) {
+            if (m_scale < m_settings.maxScale) {
+                Apply(min(Quantize(m_scale + m_settings.scaleStep), m_settings.maxScale), m_msaaSamples);
+                return true;
+            }
+            if (m_settings.adjustMsaa && m_msaaSamples < m_settings.maxMsaaSamples) {
+                Apply(m_scale, m_settings.maxMsaaSamples);
+                return true;
+            }
+            m_fastFrames = 0;
+        }
+        return false;
+    }
+
+    void DynamicResolutionController::GetRenderSize(uint32_t width, uint32_t height,
+                                                    uint32_t &renderWidth, uint32_t &renderHeight) const
+    {
+        renderWidth = max(1u, uint32_t(lround(width * m_scale)));
+        renderHeight = max(1u, uint32_t(lround(height * m_scale)));
+    }
+
+    float DynamicResolutionController::Quantize(float scale) const
+    {
+        return round(scale / m_settings.scaleStep) * m_settings.scaleStep;
+    }
+
+    void DynamicResolutionController::Apply(float scale, uint32_t msaaSamples)
+    {
+        ResolutionDecision decision;
+        decision.frame = m_frame;
+        decision.frameMs = m_averageMs;
+        decision.oldScale = m_scale;
+        decision.newScale = scale;
+        decision.oldMsaaSamples = m_msaaSamples;
+        decision.newMsaaSamples = msaaSamples;
+
+        if (m_log.size() == kMaxLogEntries)
+            m_log.pop_front();
+        m_log.push_back(decision);
+
+        m_scale = scale;
+        m_msaaSamples = msaaSamples;
+        m_slowFrames = 0;
+        m_fastFrames = 0;
+        m_cooldown = m_settings.cooldownFrames;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace luke {
+
+    struct DynamicResolutionSettings {
+        float targetFrameMs = 1000.0f / 60.0f;
+        float minScale = 0.5f; // 가로/세로 각각에 곱하는 배율
+        float maxScale = 1.0f;
+        float scaleStep = 0.05f; // 배율을 이 단위로 맞춰서 비슷한 크기를 오가지 않게 함
+
+        // 히스테리시스: 목표의 decreaseThreshold배보다 느린 프레임이 decreaseFrames번 이어지면 낮추고,
+        // increaseThreshold배보다 빠른 프레임이 increaseFrames번 이어지면 한 단계 올립니다.
+        // 두 기준 사이에서는 바꾸지 않으며, 바꾼 뒤 cooldownFrames 동안은 측정만 합니다.
+        float decreaseThreshold = 1.05f;
+        float increaseThreshold = 0.85f;
+        uint32_t decreaseFrames = 8;
+        uint32_t increaseFrames = 60;
+        uint32_t cooldownFrames = 30;
+
+        // 최소 배율에서도 느리면 MSAA를 끄고, 최대 배율에서 여유가 있으면 다시 켭니다.
+        bool adjustMsaa = false;
+        uint32_t maxMsaaSamples = 4; // 장치가 지원하는 샘플 수
+    };
+
+    // 배율이나 MSAA를 바꾼 기록 하나
+    struct ResolutionDecision {
+        uint64_t frame = 0;
+        float frameMs = 0.0f; // 결정할 때의 평균 프레임 시간
+        float oldScale = 1.0f;
+        float newScale = 1.0f;
+        uint32_t oldMsaaSamples = 1;
+        uint32_t newMsaaSamples = 1;
+    };
+
+    // 측정한 프레임 시간으로 내부 렌더링 해상도(와 MSAA)를 조절해서 목표 프레임 시간을 유지합니다.
+    // 그리는 비용은 픽셀 수(배율의 제곱)에 비례한다고 보고, 낮출 때는 목표에 맞는 배율로 한 번에,
+    // 올릴 때는 한 단계씩 조심스럽게 올립니다.
+    // D3D11과 상관없으므로 HeadlessBackend 벤치마크에서도 그대로 쓸 수 있습니다.
+    class DynamicResolutionController {
+    public:
+        static constexpr size_t kMaxLogEntries = 64;
+
+        explicit DynamicResolutionController(const DynamicResolutionSettings &settings = {});
+
+        // 배율/MSAA는 새 범위 안으로 옮기고 측정은 처음부터 다시 시작
+        void SetSettings(const DynamicResolutionSettings &settings);
+        const DynamicResolutionSettings &GetSettings() const { return m_settings; }
+        void Reset();
+
+        // 프레임 시간을 하나 넣습니다. 배율이나 MSAA 샘플 수가 바뀌었으면 true (GetLog().back())
+        bool Update(float frameMs);
+
+        float GetScale() const { return m_scale; }
+        uint32_t GetMsaaSamples() const { return m_msaaSamples; }
+        float GetAverageFrameMs() const { return m_averageMs; }
+
+        // width x height에 배율을 적용한 크기 (최소 1)
+        void GetRenderSize(uint32_t width, uint32_t height, uint32_t &renderWidth,
+                           uint32_t &renderHeight) const;
+
+        // 최근 kMaxLogEntries개의 결정 (오래된 것부터)
+        const std::deque<ResolutionDecision> &GetLog() const { return m_log; }
+
+    private:
+        float Quantize(float scale) const;
+        void Apply(float scale, uint32_t msaaSamples);
+
+        DynamicResolutionSettings m_settings;
+        float m_scale = 1.0f;
+        uint32_t m_msaaSamples = 1;
+
+        float m_averageMs = 0.0f; // 지수 이동 평균
+        bool m_hasSample = false;
+        uint32_t m_slowFrames = 0;
+        uint32_t m_fastFrames = 0;
+        uint32_t m_cooldown = 0;
+        uint64_t m_frame = 0;
+
+        std::deque<ResolutionDecision> m_log;
+    };
+}
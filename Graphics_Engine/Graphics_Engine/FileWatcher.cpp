@@ -0,0 +1,179 @@
+#include "FileWatcher.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace luke {
+    using namespace std;
+
+    FileWatcher::~FileWatcher() { Stop(); }
+
+#ifdef _WIN32
+
+    bool FileWatcher::Start(const filesystem::path &directory, Callback callback)
+    {
+        Stop();
+
+        // 읽기를 걸어 둔 채로 정지 이벤트와 같이 기다릴 수 있도록 overlapped로 엶
+        HANDLE handle = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY,
+                                    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                                    OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            cout << "FileWatcher: CreateFileW() failed. " << directory.string() << endl;
+            return false;
+        }
+
+        HANDLE stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!stopEvent) {
+            cout << "FileWatcher: CreateEventW() failed." << endl;
+            CloseHandle(handle);
+            return false;
+        }
+
+        m_directory = directory;
+        m_callback = std::move(callback);
+        m_directoryHandle = handle;
+        m_stopEvent = stopEvent;
+        m_thread = thread([this] { WatchLoop(); });
+        return true;
+    }
+
+    void FileWatcher::Stop()
+    {
+        if (!m_thread.joinable())
+            return;
+
+        // 수동 리셋 이벤트이므로 스레드가 아직 기다리기 전이어도 신호가 남아 있음
+        SetEvent(m_stopEvent);
+        m_thread.join();
+
+        CloseHandle(m_stopEvent);
+        m_stopEvent = nullptr;
+        CloseHandle(m_directoryHandle);
+        m_directoryHandle = nullptr;
+    }
+
+    void FileWatcher::WatchLoop()
+    {
+        alignas(DWORD) BYTE buffer[4096];
+
+        HANDLE readEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (!readEvent) {
+            cout << "FileWatcher: CreateEventW() failed." << endl;
+            return;
+        }
+        const HANDLE events[2] = {m_stopEvent, readEvent};
+
+        while (true) {
+            OVERLAPPED overlapped = {};
+            overlapped.hEvent = readEvent;
+            ResetEvent(readEvent);
+            if (!ReadDirectoryChangesW(m_directoryHandle, buffer, sizeof(buffer), FALSE,
+                                       FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME, nullptr,
+                                       &overlapped, nullptr)) {
+                cout << "FileWatcher: ReadDirectoryChangesW() failed." << endl;
+                break;
+            }
+
+            DWORD bytesReturned = 0;
+            if (WaitForMultipleObjects(2, events, FALSE, INFINITE) != WAIT_OBJECT_0 + 1) {
+                // Stop() (또는 대기 실패): buffer가 이 스택에 있으므로 읽기를 취소하고 끝날 때까지 기다린 뒤 나감
+                CancelIoEx(m_directoryHandle, &overlapped);
+                GetOverlappedResult(m_directoryHandle, &overlapped, &bytesReturned, TRUE);
+                break;
+            }
+            if (!GetOverlappedResult(m_directoryHandle, &overlapped, &bytesReturned, FALSE))
+                break;
+
+            if (bytesReturned == 0)
+                continue; // 버퍼가 넘침. 다음 변경을 기다림
+
+            const BYTE *cursor = buffer;
+            while (true) {
+                const auto *info = reinterpret_cast<const FILE_NOTIFY_INFORMATION *>(cursor);
+                if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED ||
+                    info->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                    const wstring fileName(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                    m_callback(m_directory / fileName);
+                }
+
+                if (info->NextEntryOffset == 0)
+                    break;
+                cursor += info->NextEntryOffset;
+            }
+        }
+
+        CloseHandle(readEvent);
+    }
+
+#else
+
+    bool FileWatcher::Start(const filesystem::path &directory, Callback callback)
+    {
+        Stop();
+
+        const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0) {
+            cout << "FileWatcher: inotify_init1() failed." << endl;
+            return false;
+        }
+
+        // 에디터는 보통 임시 파일에 쓴 뒤 이름을 바꾸므로 IN_MOVED_TO도 감시
+        if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+            cout << "FileWatcher: inotify_add_watch() failed. " << directory.string() << endl;
+            close(fd);
+            return false;
+        }
+
+        m_directory = directory;
+        m_callback = std::move(callback);
+        m_inotifyFd = fd;
+        m_stop = false;
+        m_thread = thread([this] { WatchLoop(); });
+        return true;
+    }
+
+    void FileWatcher::Stop()
+    {
+        if (!m_thread.joinable())
+            return;
+
+        m_stop = true;
+        m_thread.join();
+
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+
+    void FileWatcher::WatchLoop()
+    {
+        alignas(inotify_event) char buffer[4096];
+
+        while (!m_stop) {
+            // Stop()을 확인할 수 있도록 짧게 대기
+            pollfd pfd = {m_inotifyFd, POLLIN, 0};
+            if (poll(&pfd, 1, 100) <= 0)
+                continue;
+
+            const ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0)
+                continue;
+
+            for (ssize_t offset = 0; offset < length;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+                if (event->len > 0 && !(event->mask & IN_ISDIR))
+                    m_callback(m_directory / event->name);
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+
+#endif
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace luke {
+
+    // 디렉토리 하나를 감시하다가 파일이 바뀌면 콜백을 부르는 클래스
+    // Windows: ReadDirectoryChangesW, Linux: inotify
+    // 콜백은 감시 스레드에서 호출되므로 콜백 안에서는 동기화가 필요합니다.
+    class FileWatcher {
+    public:
+        using Callback = std::function<void(const std::filesystem::path &changedFile)>;
+
+        FileWatcher() = default;
+        ~FileWatcher();
+
+        FileWatcher(const FileWatcher &) = delete;
+        FileWatcher &operator=(const FileWatcher &) = delete;
+
+        bool Start(const std::filesystem::path &directory, Callback callback);
+        void Stop();
+
+        bool IsRunning() const { return m_thread.joinable(); }
+        const std::filesystem::path &GetDirectory() const { return m_directory; }
+
+    private:
+        void WatchLoop();
+
+        std::filesystem::path m_directory;
+        Callback m_callback;
+        std::thread m_thread;
+
+#ifdef _WIN32
+        void *m_directoryHandle = nullptr; // HANDLE (FILE_FLAG_OVERLAPPED)
+        void *m_stopEvent = nullptr;       // HANDLE. Stop()이 신호를 줌
+#else
+        int m_inotifyFd = -1;
+        std::atomic<bool> m_stop{false};
+#endif
+    };
+}
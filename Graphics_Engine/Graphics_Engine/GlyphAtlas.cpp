@@ -0,0 +1,150 @@
+#include "GlyphAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace luke {
+    using namespace std;
+
+    GlyphAtlas::GlyphAtlas(uint32_t width, uint32_t height, float lineHeight, RasterizeFunction rasterize,
+                           uint16_t texture)
+        : m_width(width), m_height(height), m_lineHeight(lineHeight), m_rasterize(move(rasterize)),
+          m_texture(texture)
+    {
+        Clear();
+    }
+
+    const Glyph *GlyphAtlas::GetGlyph(uint32_t codepoint)
+    {
+        int32_t *slot;
+        if (codepoint < m_ascii.size()) {
+            slot = &m_ascii[codepoint];
+        }
+        else {
+            slot = &m_others.try_emplace(codepoint, kMissing).first->second;
+        }
+
+        if (*slot == kMissing)
+            *slot = AddGlyph(codepoint);
+        return *slot >= 0 ? &m_glyphs[*slot] : nullptr;
+    }
+
+    void GlyphAtlas::Clear()
+    {
+        m_pixels.assign(size_t(m_width) * m_height, 0);
+        m_glyphs.clear();
+        m_ascii.fill(kMissing);
+        m_others.clear();
+        m_shelfX = 0;
+        m_shelfY = 0;
+        m_shelfHeight = 0;
+        m_stats = {};
+
+        // 처음에는 전체를 올림
+        m_dirtyMinX = 0;
+        m_dirtyMinY = 0;
+        m_dirtyMaxX = m_width;
+        m_dirtyMaxY = m_height;
+    }
+
+    bool GlyphAtlas::GetDirtyRect(uint32_t &x, uint32_t &y, uint32_t &width, uint32_t &height) const
+    {
+        if (m_dirtyMinX >= m_dirtyMaxX || m_dirtyMinY >= m_dirtyMaxY)
+            return false;
+        x = m_dirtyMinX;
+        y = m_dirtyMinY;
+        width = m_dirtyMaxX - m_dirtyMinX;
+        height = m_dirtyMaxY - m_dirtyMinY;
+        return true;
+    }
+
+    void GlyphAtlas::ClearDirty()
+    {
+        m_dirtyMinX = m_width;
+        m_dirtyMinY = m_height;
+        m_dirtyMaxX = 0;
+        m_dirtyMaxY = 0;
+    }
+
+    int32_t GlyphAtlas::AddGlyph(uint32_t codepoint)
+    {
+        GlyphBitmap bitmap;
+        m_stats.rasterized++;
+        if (!m_rasterize || !m_rasterize(codepoint, bitmap) ||
+            bitmap.alpha.size() < size_t(bitmap.width) * bitmap.height) {
+            m_stats.failed++;
+            return kFailed;
+        }
+
+        // 공백처럼 비트맵이 없는 글자는 자리를 차지하지 않음
+        Glyph glyph;
+        glyph.offset = Vector2(float(bitmap.offsetX), float(bitmap.offsetY));
+        glyph.advance = bitmap.advance;
+        if (bitmap.width > 0 && bitmap.height > 0) {
+            const uint32_t width = bitmap.width + kPadding;
+            const uint32_t height = bitmap.height + kPadding;
+            if (m_shelfX + width > m_width) {
+                // 다음 선반
+                m_shelfY += m_shelfHeight;
+                m_shelfX = 0;
+                m_shelfHeight = 0;
+            }
+            if (width > m_width || m_shelfY + height > m_height) {
+                m_stats.failed++;
+                return kFailed;
+            }
+
+            const uint32_t x = m_shelfX;
+            const uint32_t y = m_shelfY;
+            for (uint32_t row = 0; row < bitmap.height; row++) {
+                memcpy(&m_pixels[size_t(y + row) * m_width + x], &bitmap.alpha[size_t(row) * bitmap.width],
+                       bitmap.width);
+            }
+            m_shelfX += width;
+            m_shelfHeight = max(m_shelfHeight, height);
+
+            m_dirtyMinX = min(m_dirtyMinX, x);
+            m_dirtyMinY = min(m_dirtyMinY, y);
+            m_dirtyMaxX = max(m_dirtyMaxX, x + bitmap.width);
+            m_dirtyMaxY = max(m_dirtyMaxY, y + bitmap.height);
+
+            glyph.uvRect = Vector4(float(x) / m_width, float(y) / m_height, float(x + bitmap.width) / m_width,
+                                   float(y + bitmap.height) / m_height);
+            glyph.size = Vector2(float(bitmap.width), float(bitmap.height));
+        }
+
+        m_glyphs.push_back(glyph);
+        m_stats.glyphCount = uint32_t(m_glyphs.size());
+        m_stats.usedHeight = m_shelfY + m_shelfHeight;
+        return int32_t(m_glyphs.size() - 1);
+    }
+
+    bool MakeTestGlyph(uint32_t codepoint, uint32_t pixelSize, GlyphBitmap &bitmap)
+    {
+        const uint32_t height = max(pixelSize, 4u);
+        const uint32_t width = height * 5 / 8;
+        bitmap.advance = float(width + height / 8);
+        bitmap.offsetX = 0;
+        bitmap.offsetY = -int32_t(height);
+        if (codepoint == ' ') {
+            bitmap.width = 0;
+            bitmap.height = 0;
+            bitmap.alpha.clear();
+            return true;
+        }
+
+        // 테두리 + 코드 포인트의 비트를 3x5 칸에 찍은 무늬
+        bitmap.width = width;
+        bitmap.height = height;
+        bitmap.alpha.assign(size_t(width) * height, 0);
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                const bool border = x == 0 || y == 0 || x == width - 1 || y == height - 1;
+                const uint32_t cell = min(y * 5 / height, 4u) * 3 + min(x * 3 / width, 2u);
+                const bool bit = ((codepoint * 2654435761u) >> (cell + 8)) & 1;
+                bitmap.alpha[size_t(y) * width + x] = border ? 255 : (bit ? 192 : 0);
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <directxtk/SimpleMath.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace luke {
+
+    using DirectX::SimpleMath::Vector2;
+    using DirectX::SimpleMath::Vector4;
+
+    // 폰트 래스터라이저가 만든 글자 하나 (알파 8비트, 행 우선)
+    struct GlyphBitmap {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        int32_t offsetX = 0; // 펜 위치(기준선 왼쪽)에서 비트맵 왼쪽 위까지 (픽셀, 아래가 +y)
+        int32_t offsetY = 0;
+        float advance = 0.0f; // 다음 글자까지 펜이 움직이는 거리
+        std::vector<uint8_t> alpha;
+    };
+
+    // 아틀라스에 올라간 글자
+    struct Glyph {
+        Vector4 uvRect; // (u0, v0, u1, v1)
+        Vector2 size;   // 픽셀
+        Vector2 offset; // 펜 위치에서 왼쪽 위까지
+        float advance = 0.0f;
+    };
+
+    struct GlyphAtlasStats {
+        uint32_t glyphCount = 0;
+        uint32_t usedHeight = 0;  // 선반이 차지한 높이
+        uint32_t rasterized = 0;  // 래스터라이저를 부른 횟수
+        uint32_t failed = 0;      // 래스터라이저가 실패했거나 아틀라스가 가득 찬 글자
+    };
+
+    // 글자를 처음 쓸 때 래스터라이저로 그려서 한 장의 R8 텍스처에 선반(shelf) 방식으로 채워 넣는 글자 아틀라스
+    // 모든 글자가 한 텍스처에 있으므로 SpriteBatcher로 그리면 글자 수와 상관없이 텍스처가 바뀌지 않습니다.
+    // 새로 들어간 글자가 있으면 GetDirtyRect()의 영역만 텍스처에 올리고 ClearDirty()를 부르세요. (D3D11의 UpdateSubresource)
+    // 가득 차면 새 글자는 그려지지 않습니다. (Clear() 후 다시 채우거나 더 큰 아틀라스를 쓰세요)
+    class GlyphAtlas {
+    public:
+        // 실패하면 false. DirectWrite, stb_truetype 같은 폰트 래스터라이저를 연결
+        using RasterizeFunction = std::function<bool(uint32_t codepoint, GlyphBitmap &bitmap)>;
+
+        GlyphAtlas(uint32_t width, uint32_t height, float lineHeight, RasterizeFunction rasterize,
+                   uint16_t texture = 0);
+
+        // 없으면 래스터화해서 넣음. 실패하면 nullptr (같은 글자는 다시 시도하지 않음)
+        const Glyph *GetGlyph(uint32_t codepoint);
+        void Clear();
+
+        // 마지막 ClearDirty() 뒤로 바뀐 영역. 없으면 false
+        bool GetDirtyRect(uint32_t &x, uint32_t &y, uint32_t &width, uint32_t &height) const;
+        void ClearDirty();
+
+        const std::vector<uint8_t> &GetPixels() const { return m_pixels; }
+        uint32_t GetWidth() const { return m_width; }
+        uint32_t GetHeight() const { return m_height; }
+        float GetLineHeight() const { return m_lineHeight; }
+        uint16_t GetTexture() const { return m_texture; } // SpriteBatcher의 텍스처 번호
+        const GlyphAtlasStats &GetStats() const { return m_stats; }
+
+    private:
+        static constexpr uint32_t kPadding = 1; // 글자 사이 빈 텍셀 (필터링할 때 옆 글자가 번지지 않게)
+        static constexpr int32_t kMissing = -1;
+        static constexpr int32_t kFailed = -2;
+
+        int32_t AddGlyph(uint32_t codepoint);
+
+        uint32_t m_width;
+        uint32_t m_height;
+        float m_lineHeight;
+        RasterizeFunction m_rasterize;
+        uint16_t m_texture;
+
+        std::vector<uint8_t> m_pixels;
+        std::vector<Glyph> m_glyphs;
+        std::array<int32_t, 128> m_ascii;                // ASCII -> m_glyphs 번호 (kMissing/kFailed)
+        std::unordered_map<uint32_t, int32_t> m_others;  // 그 외 코드 포인트
+
+        // 현재 선반
+        uint32_t m_shelfX = 0;
+        uint32_t m_shelfY = 0;
+        uint32_t m_shelfHeight = 0;
+
+        uint32_t m_dirtyMinX, m_dirtyMinY, m_dirtyMaxX, m_dirtyMaxY; // [min, max)
+        GlyphAtlasStats m_stats;
+    };
+
+    // 폰트 없이 쓰는 시험용 글자 (벤치마크/헤드리스). pixelSize 높이의 상자 안에 코드 포인트 비트로 정한 무늬를 그림
+    bool MakeTestGlyph(uint32_t codepoint, uint32_t pixelSize, GlyphBitmap &bitmap);
+}
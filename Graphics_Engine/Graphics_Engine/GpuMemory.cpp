@@ -0,0 +1,319 @@
+#include "GpuMemory.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        thread_local const char *t_owner = nullptr;
+        thread_local bool t_evicting = false; // 퇴출 콜백 안에서 다시 퇴출하지 않도록
+
+        // 레이블 값에 쓸 수 없는 문자 이스케이프
+        void WriteLabel(ostream &out, const string &value)
+        {
+            for (char c : value) {
+                if (c == '\\' || c == '"')
+                    out << '\\' << c;
+                else if (c == '\n')
+                    out << "\\n";
+                else
+                    out << c;
+            }
+        }
+
+        void WriteHeader(ostream &out, const char *name, const char *type, const char *help)
+        {
+            out << "# HELP " << name << ' ' << help << '\n' << "# TYPE " << name << ' ' << type << '\n';
+        }
+
+        // 예산 하나를 넘는 바이트. 지금 쓰고 있는 것을 다 비워도 모자라면 fixable = false
+        uint64_t GetBudgetOverage(const GpuMemoryBudget &budget, uint64_t current, uint64_t bytes, bool &fixable)
+        {
+            if (budget.bytes == 0 || current + bytes <= budget.bytes)
+                return 0;
+            const uint64_t overage = current + bytes - budget.bytes;
+            if (overage > current)
+                fixable = false;
+            return overage;
+        }
+    }
+
+    const char *GetGpuMemoryCategoryName(GpuMemoryCategory category)
+    {
+        switch (category) {
+        case GpuMemoryCategory::VertexBuffer:
+            return "vertex_buffer";
+        case GpuMemoryCategory::IndexBuffer:
+            return "index_buffer";
+        case GpuMemoryCategory::ConstantBuffer:
+            return "constant_buffer";
+        case GpuMemoryCategory::StructuredBuffer:
+            return "structured_buffer";
+        case GpuMemoryCategory::Texture:
+            return "texture";
+        case GpuMemoryCategory::RenderTarget:
+            return "render_target";
+        case GpuMemoryCategory::DepthStencil:
+            return "depth_stencil";
+        case GpuMemoryCategory::Staging:
+            return "staging";
+        default:
+            return "unknown";
+        }
+    }
+
+    GpuAllocationId GpuMemoryTracker::Allocate(GpuMemoryCategory category, uint64_t bytes, const char *owner)
+    {
+        if (!owner)
+            owner = GpuMemoryOwnerScope::GetCurrent();
+        if (!owner)
+            owner = "unknown";
+
+        unique_lock lock(m_mutex);
+        bool hard = false;
+        bool fixable = true;
+        uint64_t overage = GetOverage(category, bytes, hard, fixable);
+        if (overage > 0 && fixable && !t_evicting && !m_evictionCallbacks.empty()) {
+            // 콜백이 Free()를 부를 수 있으므로 잠금을 풀고 부름
+            const auto callbacks = m_evictionCallbacks;
+            lock.unlock();
+            t_evicting = true;
+            uint64_t requests = 0;
+            uint64_t evicted = 0;
+            for (const auto &[id, callback] : callbacks) {
+                requests++;
+                evicted += callback(category, overage);
+
+                lock.lock();
+                overage = GetOverage(category, bytes, hard, fixable);
+                lock.unlock();
+                if (overage == 0)
+                    break;
+            }
+            t_evicting = false;
+
+            lock.lock();
+            m_stats.evictionRequests += requests;
+            m_stats.evictedBytes += evicted;
+            overage = GetOverage(category, bytes, hard, fixable);
+        }
+
+        if (overage > 0) {
+            if (hard) {
+                m_stats.failedAllocations++;
+                return kInvalidGpuAllocation;
+            }
+            m_stats.overBudgetAllocations++;
+        }
+
+        GpuMemoryCategoryStats &stats = m_stats.categories[size_t(category)];
+        stats.currentBytes += bytes;
+        stats.peakBytes = max(stats.peakBytes, stats.currentBytes);
+        stats.liveAllocations++;
+        stats.totalAllocations++;
+        m_stats.currentBytes += bytes;
+        m_stats.peakBytes = max(m_stats.peakBytes, m_stats.currentBytes);
+
+        GpuMemoryOwnerUsage &usage = m_owners[owner];
+        if (usage.owner.empty())
+            usage.owner = owner;
+        usage.currentBytes += bytes;
+        usage.peakBytes = max(usage.peakBytes, usage.currentBytes);
+        usage.liveAllocations++;
+
+        const GpuAllocationId id = m_nextId++;
+        m_allocations.emplace(id, Allocation{category, bytes, &usage});
+        return id;
+    }
+
+    void GpuMemoryTracker::Free(GpuAllocationId id)
+    {
+        if (id == kInvalidGpuAllocation)
+            return;
+
+        lock_guard lock(m_mutex);
+        auto it = m_allocations.find(id);
+        if (it == m_allocations.end()) {
+            cout << "GpuMemoryTracker: Free() on an unknown allocation." << endl;
+            return;
+        }
+
+        const Allocation &allocation = it->second;
+        GpuMemoryCategoryStats &stats = m_stats.categories[size_t(allocation.category)];
+        stats.currentBytes -= allocation.bytes;
+        stats.liveAllocations--;
+        m_stats.currentBytes -= allocation.bytes;
+        allocation.owner->currentBytes -= allocation.bytes;
+        allocation.owner->liveAllocations--;
+        m_allocations.erase(it);
+    }
+
+    void GpuMemoryTracker::SetBudget(GpuMemoryCategory category, const GpuMemoryBudget &budget)
+    {
+        lock_guard lock(m_mutex);
+        m_stats.categories[size_t(category)].budget = budget;
+    }
+
+    void GpuMemoryTracker::SetTotalBudget(const GpuMemoryBudget &budget)
+    {
+        lock_guard lock(m_mutex);
+        m_stats.totalBudget = budget;
+    }
+
+    uint32_t GpuMemoryTracker::AddEvictionCallback(EvictionCallback callback)
+    {
+        lock_guard lock(m_mutex);
+        const uint32_t id = m_nextCallbackId++;
+        m_evictionCallbacks.emplace_back(id, std::move(callback));
+        return id;
+    }
+
+    void GpuMemoryTracker::RemoveEvictionCallback(uint32_t id)
+    {
+        lock_guard lock(m_mutex);
+        erase_if(m_evictionCallbacks, [id](const auto &entry) { return entry.first == id; });
+    }
+
+    GpuMemoryStats GpuMemoryTracker::GetStats() const
+    {
+        lock_guard lock(m_mutex);
+        return m_stats;
+    }
+
+    vector<GpuMemoryOwnerUsage> GpuMemoryTracker::GetOwnerUsage() const
+    {
+        vector<GpuMemoryOwnerUsage> owners;
+        {
+            lock_guard lock(m_mutex);
+            owners.reserve(m_owners.size());
+            for (const auto &[name, usage] : m_owners)
+                owners.push_back(usage);
+        }
+        stable_sort(owners.begin(), owners.end(), [](const GpuMemoryOwnerUsage &a, const GpuMemoryOwnerUsage &b) {
+            return a.currentBytes > b.currentBytes;
+        });
+        return owners;
+    }
+
+    void GpuMemoryTracker::WriteStats(ostream &out) const
+    {
+        const GpuMemoryStats stats = GetStats();
+        const vector<GpuMemoryOwnerUsage> owners = GetOwnerUsage();
+        constexpr size_t kCategories = size_t(GpuMemoryCategory::Count);
+
+        auto writeCategories = [&](const char *name, const char *type, const char *help, auto value) {
+            WriteHeader(out, name, type, help);
+            for (size_t i = 0; i < kCategories; i++) {
+                out << name << "{category=\"" << GetGpuMemoryCategoryName(GpuMemoryCategory(i)) << "\"} "
+                    << value(stats.categories[i]) << '\n';
+            }
+        };
+        writeCategories("luke_gpu_memory_bytes", "gauge", "GPU memory currently allocated.",
+                        [](const GpuMemoryCategoryStats &s) { return s.currentBytes; });
+        writeCategories("luke_gpu_memory_peak_bytes", "gauge", "Highest GPU memory allocated since startup.",
+                        [](const GpuMemoryCategoryStats &s) { return s.peakBytes; });
+        writeCategories("luke_gpu_memory_live_allocations", "gauge", "Buffers and textures currently alive.",
+                        [](const GpuMemoryCategoryStats &s) { return s.liveAllocations; });
+        writeCategories("luke_gpu_memory_allocations_total", "counter", "Buffers and textures created.",
+                        [](const GpuMemoryCategoryStats &s) { return s.totalAllocations; });
+
+        // 예산은 정해진 분류만 (0 = 제한 없음)
+        WriteHeader(out, "luke_gpu_memory_budget_bytes", "gauge", "Configured GPU memory budget.");
+        for (size_t i = 0; i < kCategories; i++) {
+            const GpuMemoryBudget &budget = stats.categories[i].budget;
+            if (budget.bytes > 0) {
+                out << "luke_gpu_memory_budget_bytes{category=\"" << GetGpuMemoryCategoryName(GpuMemoryCategory(i))
+                    << "\",hard=\"" << (budget.hard ? 1 : 0) << "\"} " << budget.bytes << '\n';
+            }
+        }
+        if (stats.totalBudget.bytes > 0) {
+            out << "luke_gpu_memory_budget_bytes{category=\"total\",hard=\"" << (stats.totalBudget.hard ? 1 : 0)
+                << "\"} " << stats.totalBudget.bytes << '\n';
+        }
+
+        WriteHeader(out, "luke_gpu_memory_total_bytes", "gauge", "GPU memory currently allocated in all categories.");
+        out << "luke_gpu_memory_total_bytes " << stats.currentBytes << '\n';
+        WriteHeader(out, "luke_gpu_memory_total_peak_bytes", "gauge", "Highest total GPU memory since startup.");
+        out << "luke_gpu_memory_total_peak_bytes " << stats.peakBytes << '\n';
+
+        WriteHeader(out, "luke_gpu_memory_owner_bytes", "gauge", "GPU memory currently allocated per owner.");
+        for (const GpuMemoryOwnerUsage &owner : owners) {
+            out << "luke_gpu_memory_owner_bytes{owner=\"";
+            WriteLabel(out, owner.owner);
+            out << "\"} " << owner.currentBytes << '\n';
+        }
+        WriteHeader(out, "luke_gpu_memory_owner_live_allocations", "gauge",
+                    "Buffers and textures currently alive per owner.");
+        for (const GpuMemoryOwnerUsage &owner : owners) {
+            out << "luke_gpu_memory_owner_live_allocations{owner=\"";
+            WriteLabel(out, owner.owner);
+            out << "\"} " << owner.liveAllocations << '\n';
+        }
+
+        WriteHeader(out, "luke_gpu_memory_eviction_requests_total", "counter", "Eviction callbacks invoked.");
+        out << "luke_gpu_memory_eviction_requests_total " << stats.evictionRequests << '\n';
+        WriteHeader(out, "luke_gpu_memory_evicted_bytes_total", "counter", "Bytes released by eviction callbacks.");
+        out << "luke_gpu_memory_evicted_bytes_total " << stats.evictedBytes << '\n';
+        WriteHeader(out, "luke_gpu_memory_over_budget_allocations_total", "counter",
+                    "Allocations allowed over a soft budget.");
+        out << "luke_gpu_memory_over_budget_allocations_total " << stats.overBudgetAllocations << '\n';
+        WriteHeader(out, "luke_gpu_memory_failed_allocations_total", "counter",
+                    "Allocations refused by a hard budget.");
+        out << "luke_gpu_memory_failed_allocations_total " << stats.failedAllocations << '\n';
+    }
+
+    bool GpuMemoryTracker::ExportStats(const filesystem::path &path) const
+    {
+        filesystem::path temporary = path;
+        temporary += ".tmp";
+        {
+            ofstream file(temporary, ios::trunc);
+            if (!file) {
+                cout << "Cannot write " << temporary.string() << endl;
+                return false;
+            }
+            WriteStats(file);
+            if (!file) {
+                cout << "Cannot write " << temporary.string() << endl;
+                return false;
+            }
+        }
+
+        error_code error;
+        filesystem::rename(temporary, path, error);
+        if (error) {
+            cout << "Cannot rename " << temporary.string() << " to " << path.string() << ": " << error.message()
+                 << endl;
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t GpuMemoryTracker::GetOverage(GpuMemoryCategory category, uint64_t bytes, bool &hard, bool &fixable) const
+    {
+        const GpuMemoryCategoryStats &stats = m_stats.categories[size_t(category)];
+        fixable = true;
+        const uint64_t categoryOverage = GetBudgetOverage(stats.budget, stats.currentBytes, bytes, fixable);
+        const uint64_t totalOverage = GetBudgetOverage(m_stats.totalBudget, m_stats.currentBytes, bytes, fixable);
+        hard = (categoryOverage > 0 && stats.budget.hard) || (totalOverage > 0 && m_stats.totalBudget.hard);
+        return max(categoryOverage, totalOverage);
+    }
+
+    GpuMemoryOwnerScope::GpuMemoryOwnerScope(const char *name) : m_previous(t_owner)
+    {
+        t_owner = name;
+    }
+
+    GpuMemoryOwnerScope::~GpuMemoryOwnerScope()
+    {
+        t_owner = m_previous;
+    }
+
+    const char *GpuMemoryOwnerScope::GetCurrent()
+    {
+        return t_owner;
+    }
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace luke {
+
+    // GPU 리소스 메모리를 나눠서 볼 분류 (Memory.h의 MemoryCategory는 CPU 메모리)
+    enum class GpuMemoryCategory : uint32_t {
+        VertexBuffer,
+        IndexBuffer,
+        ConstantBuffer,
+        StructuredBuffer,
+        Texture,      // 쉐이더가 읽기만 하는 텍스처
+        RenderTarget, // 백 버퍼, 오프스크린/장면 렌더 타겟
+        DepthStencil,
+        Staging,      // CPU가 읽는 복사본
+        Count
+    };
+
+    // 내보내는 통계의 category 레이블 ("vertex_buffer" 등)
+    const char *GetGpuMemoryCategoryName(GpuMemoryCategory category);
+
+    // bytes가 0이면 제한 없음
+    // hard면 퇴출(eviction) 후에도 넘치는 할당을 실패시키고, 아니면 할당은 하고 overBudgetAllocations만 셈
+    struct GpuMemoryBudget {
+        uint64_t bytes = 0;
+        bool hard = false;
+    };
+
+    struct GpuMemoryCategoryStats {
+        uint64_t currentBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t liveAllocations = 0;
+        uint64_t totalAllocations = 0; // 처음부터 센 할당 수
+        GpuMemoryBudget budget;
+    };
+
+    struct GpuMemoryStats {
+        GpuMemoryCategoryStats categories[size_t(GpuMemoryCategory::Count)];
+        uint64_t currentBytes = 0;
+        uint64_t peakBytes = 0;
+        GpuMemoryBudget totalBudget;
+
+        uint64_t evictionRequests = 0;      // 퇴출 콜백을 부른 횟수
+        uint64_t evictedBytes = 0;          // 콜백이 비웠다고 알려준 바이트
+        uint64_t overBudgetAllocations = 0; // soft 예산을 넘긴 채로 허용한 할당
+        uint64_t failedAllocations = 0;     // hard 예산 때문에 거절한 할당
+    };
+
+    // 할당한 곳(owner)별 사용량
+    struct GpuMemoryOwnerUsage {
+        std::string owner;
+        uint64_t currentBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t liveAllocations = 0;
+    };
+
+    using GpuAllocationId = uint64_t;
+    constexpr GpuAllocationId kInvalidGpuAllocation = 0;
+
+    // 버퍼/텍스처 할당을 분류, 크기, owner별로 기록하고 예산을 지키게 하는 계정(accounting) 계층
+    // 실제 메모리는 만들지 않습니다. 백엔드가 리소스를 만들기 전에 Allocate()하고, 지울 때 Free()합니다.
+    // (HeadlessBackend는 SetMemoryTracker()로, Graphics는 D3D11Memory.h의 도우미로 기록)
+    // - 분류별 예산이나 전체 예산을 넘게 되면 먼저 퇴출 콜백을 등록한 순서대로 불러서 자리를 만들게 합니다.
+    //   콜백은 잠금 없이 불리므로 안에서 리소스를 지워도(Free()) 됩니다. 콜백 안에서의 할당은 다시 퇴출하지 않습니다.
+    // - WriteStats()/ExportStats()는 Prometheus 텍스트 형식으로 현재 값을 씁니다.
+    //   ExportStats()는 임시 파일에 쓴 뒤 이름을 바꾸므로 수집기가 반쯤 쓴 파일을 읽지 않습니다.
+    //   (node_exporter의 textfile collector 같은 에이전트가 주기적으로 읽게 하세요)
+    // 여러 스레드에서 호출해도 됩니다.
+    class GpuMemoryTracker {
+    public:
+        // category에 bytesNeeded 이상의 자리가 필요함. 실제로 비운 바이트를 반환
+        using EvictionCallback = std::function<uint64_t(GpuMemoryCategory category, uint64_t bytesNeeded)>;
+
+        // owner가 nullptr이면 GpuMemoryOwnerScope로 지정한 현재 스레드의 owner ("unknown")
+        // hard 예산을 넘으면 kInvalidGpuAllocation (리소스를 만들지 마세요)
+        GpuAllocationId Allocate(GpuMemoryCategory category, uint64_t bytes, const char *owner = nullptr);
+        void Free(GpuAllocationId id);
+
+        void SetBudget(GpuMemoryCategory category, const GpuMemoryBudget &budget);
+        void SetTotalBudget(const GpuMemoryBudget &budget);
+
+        // 반환한 번호로 RemoveEvictionCallback()
+        uint32_t AddEvictionCallback(EvictionCallback callback);
+        void RemoveEvictionCallback(uint32_t id);
+
+        GpuMemoryStats GetStats() const;
+        std::vector<GpuMemoryOwnerUsage> GetOwnerUsage() const; // 현재 사용량이 큰 순서
+
+        void WriteStats(std::ostream &out) const;
+        bool ExportStats(const std::filesystem::path &path) const;
+
+    private:
+        struct Allocation {
+            GpuMemoryCategory category;
+            uint64_t bytes;
+            GpuMemoryOwnerUsage *owner;
+        };
+
+        // bytes를 더하면 예산을 넘는 바이트 (넘지 않으면 0). 잠근 상태에서 부름
+        // 넘은 예산 중 하나라도 hard면 hard, 지금 쓰는 것을 다 비워도 모자라면 fixable = false (퇴출하지 않음)
+        uint64_t GetOverage(GpuMemoryCategory category, uint64_t bytes, bool &hard, bool &fixable) const;
+
+        mutable std::mutex m_mutex;
+        GpuMemoryStats m_stats;
+        GpuAllocationId m_nextId = 1;
+        std::unordered_map<GpuAllocationId, Allocation> m_allocations;
+        std::map<std::string, GpuMemoryOwnerUsage> m_owners; // 주소가 바뀌지 않아야 하므로 map
+
+        uint32_t m_nextCallbackId = 1;
+        std::vector<std::pair<uint32_t, EvictionCallback>> m_evictionCallbacks;
+    };
+
+    // 범위 안에서 현재 스레드의 owner를 name으로 바꾸는 도우미 (중첩되면 안쪽이 우선)
+    // CreateBuffer()처럼 owner를 받지 않는 함수로 만든 리소스에 이름을 붙일 때 사용합니다.
+    class GpuMemoryOwnerScope {
+    public:
+        explicit GpuMemoryOwnerScope(const char *name);
+        ~GpuMemoryOwnerScope();
+
+        GpuMemoryOwnerScope(const GpuMemoryOwnerScope &) = delete;
+        GpuMemoryOwnerScope &operator=(const GpuMemoryOwnerScope &) = delete;
+
+        static const char *GetCurrent(); // 없으면 nullptr
+
+    private:
+        const char *m_previous;
+    };
+}
@@ -20,10 +20,20 @@ namespace luke
     // 클래스의 멤버 함수에서 간접적으로 메시지를 처리할 수 있도록 도와줍니다.
     Graphics *g_graphics = nullptr;
 
+    namespace
+    {
+        struct UpscaleConstantBuffer
+        {
+            float uvScale[2];
+            float uvClamp[2];
+        };
+    }
+
     // 생성자
     Graphics::Graphics()
         : m_mainWindow(0),
-          m_screenViewport(D3D11_VIEWPORT())
+          m_screenViewport(D3D11_VIEWPORT()),
+          m_frameArena(1024 * 1024)
     {
 
         g_graphics = this;
@@ -33,6 +43,11 @@ namespace luke
     {
         g_graphics = nullptr;
 
+        // 오프스크린 모드에는 ImGui와 창이 없음
+        FlushOffscreen();
+        if (m_offscreen)
+            return;
+
         // Cleanup
         ImGui_ImplDX11_Shutdown();
         ImGui_ImplWin32_Shutdown();
@@ -97,31 +112,113 @@ namespace luke
 
     int Graphics::Run()
     {
-        ImGui_ImplDX11_NewFrame(); // GUI 프레임 시작
-        ImGui_ImplWin32_NewFrame();
+        // 창 크기 변경은 프레임 경계인 여기서만 적용. 최소화돼 있으면 그리지 않음
+        if (!ApplyPendingResize())
+            return 0;
 
-        ImGui::NewFrame(); // 어떤 것들을 렌더링 할지 기록 시작
-        ImGui::Begin("Scene Control");
+        // 몇 프레임 전의 GPU 타임스탬프를 모아서 타임라인을 완성
+        m_profiler.BeginFrame();
 
-        // ImGui가 측정해주는 Framerate 출력
-        ImGui::Text("Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate,
-            ImGui::GetIO().Framerate);
+        // GPU가 다 쓴 리소스 정리
+        m_resources.BeginFrame(m_frameIndex);
+        m_targetPool.BeginFrame(m_frameIndex);
+        ExportMemoryStats();
 
-        UpdateGUI(); // 추가적으로 사용할 GUI
+        // 백그라운드에서 다시 컴파일된 쉐이더는 프레임 경계에서만 교체
+        if (m_shaderReloader)
+            m_shaderReloader->ApplyPending(
+                [this](const CompiledShader &shader) { return ApplyReloadedShader(shader); });
 
-        ImGui::End();
-        ImGui::Render(); // 렌더링할 것들 기록 끝
+        if (m_offscreen)
+        {
+            // 창이 없으므로 GUI 없이 고정된 시간 간격으로 그림
+            BeginOffscreenFrame();
+            if (!m_commandCapturePath.empty())
+                BeginCommandCapture();
+            {
+                CpuProfileScope cpuScope(&m_profiler, "Update");
+                Update(1.0f / 60.0f);
+            }
+            {
+                CpuProfileScope cpuScope(&m_profiler, "Render");
+                GpuProfileScope gpuScope(&m_profiler, "Scene");
+                Render();
+            }
+            if (m_recordingCommands)
+                EndCommandCapture();
+            m_profiler.EndFrame();
+            EndOffscreenFrame();
+
+            m_frameArena.Reset();
+            m_frameIndex++;
+            return 0;
+        }
 
-        Update(ImGui::GetIO().DeltaTime); // 애니메이션 같은 변화
+        // 프레임 간격은 직접 잼 (오버레이를 다시 만들지 않는 프레임에는 ImGui의 DeltaTime이 갱신되지 않음)
+        const auto now = chrono::high_resolution_clock::now();
+        if (m_lastRunTime.time_since_epoch().count() != 0)
+            m_frameDt = chrono::duration<float>(now - m_lastRunTime).count();
+        m_lastRunTime = now;
+        m_overlayFrameMsSum += m_frameDt * 1000.0f;
+        m_overlayFrameCount++;
+
+        const OverlayAction overlay =
+            m_overlay.BeginFrame(chrono::duration<double, milli>(now.time_since_epoch()).count());
+        if (overlay == OverlayAction::Rebuild)
+        {
+            CpuProfileScope cpuScope(&m_profiler, "GUI");
+            BuildGUI();
+        }
 
-        Render(); // 우리가 구현한 렌더링
+        // 동적 해상도: 배율을 정하고 렌더 타겟을 축소된 장면 텍스처로 바꿈
+        if (m_useDynamicResolution)
+            BeginScaledFrame();
 
-        ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData()); // GUI 렌더링
+        if (!m_commandCapturePath.empty())
+            BeginCommandCapture();
+
+        {
+            CpuProfileScope cpuScope(&m_profiler, "Update");
+            Update(m_frameDt); // 애니메이션 같은 변화
+        }
+
+        {
+            CpuProfileScope cpuScope(&m_profiler, "Render");
+            GpuProfileScope gpuScope(&m_profiler, "Scene");
+            Render(); // 우리가 구현한 렌더링
+        }
+
+        if (m_recordingCommands)
+            EndCommandCapture();
+
+        if (m_useDynamicResolution)
+            EndScaledFrame(); // 백 버퍼로 확대
+
+        // GUI를 그리기 전의 장면만 저장
+        if (m_capturing)
+        {
+            CpuProfileScope cpuScope(&m_profiler, "Capture");
+            CaptureBackBuffer();
+        }
+
+        // Reuse이면 지난번 Render()의 그리기 데이터를 그대로 다시 그림 (다음 NewFrame()까지 유효)
+        if (overlay != OverlayAction::Skip)
+        {
+            GpuProfileScope gpuScope(&m_profiler, "GUI");
+            ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData()); // GUI 렌더링
+        }
+
+        // vsync 대기가 GPU 시간에 들어가지 않도록 Present() 전에 닫음
+        m_profiler.EndFrame();
 
         // Switch the back buffer and the front buffer
         // 주의: ImGui RenderDrawData() 다음에 Present() 호출
         m_swapChain->Present(1, 0);
 
+        // 이번 프레임에 할당한 임시 메모리를 한꺼번에 해제
+        m_frameArena.Reset();
+        m_frameIndex++;
+
         return 0;
     }
 
@@ -129,12 +226,23 @@ namespace luke
     {
         m_screenWidth = width;
         m_screenHeight = height;
+        m_offscreen = hwnd == nullptr;
         if (!InitDirect3D(hwnd))
             return false;
 
-        if (!InitGUI())
+        // 타임스탬프 쿼리를 만들 수 없으면 CPU 시간만 기록
+        if (m_gpuTimestamps.Initialize(m_device.Get(), m_context.Get()))
+            m_profiler.SetGpuTimestamps(&m_gpuTimestamps);
+
+        // 동적 해상도가 켜져 있으면 장면을 그리는 동안만 축소된 뷰포트로 바뀜
+        m_screenViewport = {0.0f, 0.0f, float(m_screenWidth), float(m_screenHeight), 0.0f, 1.0f};
+
+        if (!m_offscreen && !InitGUI())
             return false;
 
+        m_shaderReloader = std::make_unique<ShaderHotReloader>(CompileShaderFile);
+        m_pipelineStates.Initialize(m_device.Get(), m_shaderReloader.get());
+
         return true;
     }
 
@@ -151,7 +259,8 @@ namespace luke
 
         // 여기서 생성하는 것들
         // m_device, m_context, m_swapChain,
-        // m_renderTargetView, m_screenViewport, m_rasterizerSate
+        // m_renderTargetView, m_screenViewport
+        // (래스터라이저/깊이 상태는 PipelineStateDesc::Default()에 있습니다.)
 
         // m_device와 m_context 생성
 
@@ -232,6 +341,7 @@ namespace luke
         // 4X MSAA 지원하는지 확인
         UINT numQualityLevels = 0;
         device->CheckMultisampleQualityLevels(DXGI_FORMAT_R8G8B8A8_UNORM, 4, &numQualityLevels);
+        m_numQualityLevels = numQualityLevels;
 #pragma endregion
         if (numQualityLevels > 0)
         {
@@ -256,6 +366,15 @@ namespace luke
             return false;
         }
 
+        // 깊이 버퍼와 동적 해상도 타겟은 크기 버킷별로 돌려 씀 (RequestResize() 참고)
+        m_targetPool.Initialize([this](const RenderTargetDesc &desc, PooledTexture &target) {
+            return CreatePooledTexture(desc, target);
+        });
+
+        // 오프스크린 모드는 스왑 체인 대신 렌더 타겟 텍스처들을 만듦
+        if (m_offscreen)
+            return InitOffscreenTargets();
+
         if (!(CreateSwapchain(swapChainDesc)))
             assert(NULL && "Create Swapchain Failed!");
 #pragma region CreateDeviceAndSwapChain
@@ -271,77 +390,818 @@ namespace luke
         }
 #pragma endregion
 
+        return CreateBackBufferTargets();
+    }
+
+    bool Graphics::CreateBackBufferTargets()
+    {
 #pragma region GetBuffer
-        m_swapChain->GetBuffer(0, IID_PPV_ARGS(&mFrameBuffer));
+        m_swapChain->GetBuffer(0, IID_PPV_ARGS(mFrameBuffer.ReleaseAndGetAddressOf()));
+        // 스왑 체인의 버퍼는 모두 같은 크기. 0번에 모두 기록하고 ResizeBuffers()로 해제될 때 같이 지움
+        DXGI_SWAP_CHAIN_DESC swapChainDesc;
+        m_swapChain->GetDesc(&swapChainDesc);
+        TrackTexture(m_gpuMemory, mFrameBuffer.Get(), swapChainDesc.BufferCount, "SwapChain");
 #pragma endregion
 
 #pragma region CreateRenderTargetView
-        if (!(CreateRenderTargetView(mFrameBuffer.Get(), nullptr, m_renderTargetView.GetAddressOf())))
-            assert(NULL && "Create RenderTargetView Failed!");
+        if (!(CreateRenderTargetView(mFrameBuffer.Get(), nullptr, m_renderTargetView.ReleaseAndGetAddressOf())))
+        {
+            cout << "CreateRenderTargetView() failed." << endl;
+            return false;
+        }
 #pragma endregion
 
-#pragma region CreateRasterizerState
-        // Create a rasterizer state
-        D3D11_RASTERIZER_DESC rastDesc;
-        ZeroMemory(&rastDesc, sizeof(D3D11_RASTERIZER_DESC)); // Need this
-        rastDesc.FillMode = D3D11_FILL_MODE::D3D11_FILL_SOLID;
-        // rastDesc.FillMode = D3D11_FILL_MODE::D3D11_FILL_WIREFRAME;
-        rastDesc.CullMode = D3D11_CULL_MODE::D3D11_CULL_NONE;
-        rastDesc.FrontCounterClockwise = false;
-        rastDesc.DepthClipEnable = true; // <- zNear, zFar 확인에 필요
-
-        m_device->CreateRasterizerState(&rastDesc, &m_rasterizerSate);
+#pragma region depthstencil desc
+        // 백 버퍼와 같은 샘플 수(4X MSAA 또는 1). 버킷 크기로 받으므로 백 버퍼보다 클 수 있음
+        D3D11_TEXTURE2D_DESC backBufferDesc;
+        mFrameBuffer->GetDesc(&backBufferDesc);
+        m_depthTargetDesc.width = m_screenWidth;
+        m_depthTargetDesc.height = m_screenHeight;
+        m_depthTargetDesc.format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+        m_depthTargetDesc.samples = backBufferDesc.SampleDesc.Count;
+        m_depthTargetDesc.bindFlags = D3D11_BIND_DEPTH_STENCIL;
 #pragma endregion
+        if (!m_targetPool.Acquire(m_depthTargetDesc, m_depthTarget))
+        {
+            cout << "Creating depth buffer failed." << endl;
+            return false;
+        }
+        m_depthStencilBuffer = m_depthTarget.texture;
+        m_depthStencilView = m_depthTarget.depthStencilView;
+
+        return true;
+    }
+
+    bool Graphics::CreatePooledTexture(const RenderTargetDesc &desc, PooledTexture &target)
+    {
+        D3D11_TEXTURE2D_DESC textureDesc = {};
+        textureDesc.Width = desc.width;
+        textureDesc.Height = desc.height;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = DXGI_FORMAT(desc.format);
+        textureDesc.SampleDesc.Count = desc.samples;
+        textureDesc.SampleDesc.Quality = desc.samples > 1 ? m_numQualityLevels - 1 : 0;
+        textureDesc.Usage = D3D11_USAGE_DEFAULT;
+        textureDesc.BindFlags = desc.bindFlags;
+
+        if (FAILED(CreateTrackedTexture2D(m_device.Get(), m_gpuMemory, textureDesc, nullptr,
+                                          target.texture.GetAddressOf(), "RenderTargetPool")))
+        {
+            cout << "CreateTexture2D() failed." << endl;
+            return false;
+        }
+        if ((desc.bindFlags & D3D11_BIND_RENDER_TARGET) &&
+            !CreateRenderTargetView(target.texture.Get(), nullptr, target.renderTargetView.GetAddressOf()))
+        {
+            cout << "CreateRenderTargetView() failed." << endl;
+            return false;
+        }
+        if ((desc.bindFlags & D3D11_BIND_DEPTH_STENCIL) &&
+            FAILED(m_device->CreateDepthStencilView(target.texture.Get(), nullptr,
+                                                    target.depthStencilView.GetAddressOf())))
+        {
+            cout << "CreateDepthStencilView() failed." << endl;
+            return false;
+        }
+        if ((desc.bindFlags & D3D11_BIND_SHADER_RESOURCE) &&
+            FAILED(m_device->CreateShaderResourceView(target.texture.Get(), nullptr,
+                                                      target.shaderResourceView.GetAddressOf())))
+        {
+            cout << "CreateShaderResourceView() failed." << endl;
+            return false;
+        }
+        return true;
+    }
+
+    void Graphics::RequestResize(UINT width, UINT height)
+    {
+        m_pendingWidth = width;
+        m_pendingHeight = height;
+        m_resizePending = true;
+    }
+
+    bool Graphics::ApplyPendingResize()
+    {
+        if (!m_resizePending || m_offscreen || !m_swapChain)
+            return !m_minimized;
+        m_resizePending = false;
+
+        m_minimized = m_pendingWidth == 0 || m_pendingHeight == 0;
+        if (m_minimized || (int(m_pendingWidth) == m_screenWidth && int(m_pendingHeight) == m_screenHeight))
+            return !m_minimized;
+
+        // 캡처 중인 프레임은 이전 크기로 먼저 저장
+        if (!m_offscreenTargets.empty())
+        {
+            FlushOffscreen();
+            m_offscreenTargets.clear();
+        }
+
+        // ResizeBuffers()는 백 버퍼를 가리키는 참조가 모두 없어야 성공
+        m_context->OMSetRenderTargets(0, nullptr, nullptr);
+        m_renderTargetView.Reset();
+        mFrameBuffer.Reset();
+        m_depthStencilView.Reset();
+        m_depthStencilBuffer.Reset();
+        m_targetPool.Release(m_depthTargetDesc, std::move(m_depthTarget));
+        m_depthTarget = {};
+        ReleaseSceneTargets(); // 다음 BeginScaledFrame()에서 새 크기로 받음
+        m_context->Flush();
+
+        if (FAILED(m_swapChain->ResizeBuffers(0, m_pendingWidth, m_pendingHeight, DXGI_FORMAT_UNKNOWN,
+                                              DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH)))
+        {
+            cout << "ResizeBuffers() failed." << endl;
+            return false;
+        }
+
+        m_screenWidth = m_pendingWidth;
+        m_screenHeight = m_pendingHeight;
+        m_screenViewport = {0.0f, 0.0f, float(m_screenWidth), float(m_screenHeight), 0.0f, 1.0f};
+        if (!CreateBackBufferTargets())
+            return false;
+
+        if (m_capturing && !CreateOffscreenTargets())
+            m_capturing = false;
+
+        m_overlay.Invalidate(); // 지난 그리기 데이터는 이전 화면 크기 기준
+        OnResize();
+        return true;
+    }
+
+    bool Graphics::InitOffscreenTargets()
+    {
+        if (!CreateOffscreenTargets())
+            return false;
+        m_renderTargetView = m_offscreenTargets[0].renderTargetView;
 
-#pragma region depthstencil desc
         D3D11_TEXTURE2D_DESC depthStencilBufferDesc;
-        depthStencilBufferDesc.Width = m_screenWidth;
-        depthStencilBufferDesc.Height = m_screenHeight;
-        depthStencilBufferDesc.MipLevels = 1;
-        depthStencilBufferDesc.ArraySize = 1;
+        m_offscreenTargets[0].texture->GetDesc(&depthStencilBufferDesc);
         depthStencilBufferDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
-        if (numQualityLevels > 0)
+        depthStencilBufferDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+        if (FAILED(CreateTrackedTexture2D(m_device.Get(), m_gpuMemory, depthStencilBufferDesc, nullptr,
+                                          m_depthStencilBuffer.GetAddressOf(), "Offscreen")) ||
+            FAILED(m_device->CreateDepthStencilView(m_depthStencilBuffer.Get(), 0,
+                                                    &m_depthStencilView)))
+        {
+            cout << "Creating offscreen depth buffer failed." << endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool Graphics::CreateOffscreenTargets()
+    {
+        // 스테이징 텍스처로 복사(CopyResource)하려면 MSAA가 아니어야 하므로 샘플은 1개
+        D3D11_TEXTURE2D_DESC textureDesc = {};
+        textureDesc.Width = m_screenWidth;
+        textureDesc.Height = m_screenHeight;
+        textureDesc.MipLevels = 1;
+        textureDesc.ArraySize = 1;
+        textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        textureDesc.SampleDesc.Count = 1;
+        textureDesc.SampleDesc.Quality = 0;
+        textureDesc.Usage = D3D11_USAGE_DEFAULT;
+        textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+        D3D11_TEXTURE2D_DESC stagingDesc = textureDesc;
+        stagingDesc.Usage = D3D11_USAGE_STAGING;
+        stagingDesc.BindFlags = 0;
+        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+        m_offscreenTargets.resize(kOffscreenLatency);
+        for (OffscreenTarget &target : m_offscreenTargets)
+        {
+            if (FAILED(CreateTrackedTexture2D(m_device.Get(), m_gpuMemory, textureDesc, nullptr,
+                                              target.texture.GetAddressOf(), "Offscreen")) ||
+                !CreateRenderTargetView(target.texture.Get(), nullptr,
+                                        target.renderTargetView.GetAddressOf()) ||
+                FAILED(CreateTrackedTexture2D(m_device.Get(), m_gpuMemory, stagingDesc, nullptr,
+                                              target.staging.GetAddressOf(), "Offscreen")))
+            {
+                cout << "Creating offscreen render targets failed." << endl;
+                m_offscreenTargets.clear();
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void Graphics::SetMemoryStatsOutput(const std::filesystem::path &path, double intervalMs)
+    {
+        m_memoryStatsPath = path;
+        m_memoryStatsIntervalMs = intervalMs;
+        m_lastMemoryStatsTime = {};
+    }
+
+    void Graphics::ExportMemoryStats()
+    {
+        if (m_memoryStatsPath.empty())
+            return;
+
+        const auto now = chrono::high_resolution_clock::now();
+        if (m_lastMemoryStatsTime.time_since_epoch().count() != 0 &&
+            chrono::duration<double, milli>(now - m_lastMemoryStatsTime).count() < m_memoryStatsIntervalMs)
+            return;
+        m_lastMemoryStatsTime = now;
+        m_gpuMemory.ExportStats(m_memoryStatsPath);
+    }
+
+    void Graphics::ResetImageWriter(ImageFormat format, QueueFullPolicy policy)
+    {
+        if (m_imageWriter && (m_imageWriter->GetFormat() != format || m_imageWriter->GetPolicy() != policy))
+        {
+            FlushOffscreen(); // 이전 형식으로 예약된 이미지를 먼저 저장
+            m_imageWriter.reset();
+        }
+        if (!m_imageWriter)
+            m_imageWriter = std::make_unique<ImageWriter>(format, 0, 8, policy);
+    }
+
+    void Graphics::SetOffscreenOutput(const std::filesystem::path &path, ImageFormat format)
+    {
+        // 배치 렌더링은 이미지를 빠뜨리면 안 되므로 큐가 가득 차면 기다림
+        ResetImageWriter(format, QueueFullPolicy::Wait);
+        m_offscreenOutputPath = path;
+    }
+
+    bool Graphics::StartCapture(const std::filesystem::path &directory, ImageFormat format)
+    {
+        if (m_offscreen)
+            return false; // 오프스크린 모드는 SetOffscreenOutput() 사용
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error)
         {
-            depthStencilBufferDesc.SampleDesc.Count = 4; // how many multisamples
-            depthStencilBufferDesc.SampleDesc.Quality = numQualityLevels - 1;
+            cout << "Cannot create " << directory.string() << endl;
+            return false;
         }
+
+        if (m_offscreenTargets.empty() && !CreateOffscreenTargets())
+            return false;
+
+        ResetImageWriter(format, QueueFullPolicy::Drop);
+        m_captureDirectory = directory;
+        m_capturing = true;
+        return true;
+    }
+
+    void Graphics::StopCapture()
+    {
+        m_capturing = false;
+        FlushOffscreen();
+    }
+
+    void Graphics::RequestCommandCapture(const std::filesystem::path &path)
+    {
+        m_commandCapturePath = path;
+    }
+
+    void Graphics::BeginCommandCapture()
+    {
+        m_commandCapture.Clear();
+        m_commandCaptureIds.clear();
+        m_commandCaptureBuffers.clear();
+        m_recordingCommands = true;
+        m_commandCapture.Add(CaptureCommand::BeginFrame);
+    }
+
+    void Graphics::EndCommandCapture()
+    {
+        m_commandCapture.Add(CaptureCommand::EndFrame);
+        m_recordingCommands = false;
+
+        if (SaveCommandCapture(m_commandCapturePath, m_commandCapture))
+            cout << "Captured " << m_commandCapture.frameCommands.size() << " commands, "
+                 << m_commandCapture.bufferCount << " buffers to " << m_commandCapturePath.string() << endl;
         else
+            cout << "Cannot write " << m_commandCapturePath.string() << endl;
+
+        m_commandCapturePath.clear();
+        m_commandCaptureIds.clear();
+        m_commandCaptureBuffers.clear();
+    }
+
+    uint32_t Graphics::GetCaptureBufferId(ID3D11Buffer *buffer)
+    {
+        if (!buffer)
+            return kNullCaptureBuffer;
+
+        auto it = m_commandCaptureIds.find(buffer);
+        if (it != m_commandCaptureIds.end())
+            return it->second;
+
+        D3D11_BUFFER_DESC desc;
+        buffer->GetDesc(&desc);
+        GpuBufferType type = GpuBufferType::Vertex;
+        if (desc.BindFlags & D3D11_BIND_INDEX_BUFFER)
+            type = GpuBufferType::Index;
+        else if (desc.BindFlags & D3D11_BIND_CONSTANT_BUFFER)
+            type = GpuBufferType::Constant;
+        else if (desc.BindFlags & D3D11_BIND_SHADER_RESOURCE)
+            type = GpuBufferType::Structured;
+
+        // 스테이징 버퍼로 복사해서 지금 내용을 읽음 (실패하면 내용 없이 크기만 기록)
+        D3D11_BUFFER_DESC stagingDesc = {};
+        stagingDesc.ByteWidth = desc.ByteWidth;
+        stagingDesc.Usage = D3D11_USAGE_STAGING;
+        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        stagingDesc.MiscFlags = desc.MiscFlags & D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        stagingDesc.StructureByteStride = desc.StructureByteStride;
+
+        ComPtr<ID3D11Buffer> staging;
+        D3D11_MAPPED_SUBRESOURCE mapped = {};
+        if (SUCCEEDED(CreateTrackedBuffer(m_device.Get(), m_gpuMemory, stagingDesc, nullptr,
+                                          staging.GetAddressOf(), "CommandCapture")))
         {
-            depthStencilBufferDesc.SampleDesc.Count = 1; // how many multisamples
-            depthStencilBufferDesc.SampleDesc.Quality = 0;
+            m_context->CopyResource(staging.Get(), buffer);
+            if (FAILED(m_context->Map(staging.Get(), 0, D3D11_MAP_READ, 0, &mapped)))
+                mapped.pData = nullptr;
         }
-        depthStencilBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-        depthStencilBufferDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
-        depthStencilBufferDesc.CPUAccessFlags = 0;
-        depthStencilBufferDesc.MiscFlags = 0;
-#pragma endregion
-        if (FAILED(m_device->CreateTexture2D(&depthStencilBufferDesc, 0,
-                                             m_depthStencilBuffer.GetAddressOf())))
+
+        const uint32_t id = m_commandCapture.AddBuffer(type, mapped.pData, desc.ByteWidth,
+                                                       desc.Usage == D3D11_USAGE_DYNAMIC);
+        if (mapped.pData)
+            m_context->Unmap(staging.Get(), 0);
+
+        m_commandCaptureIds.emplace(buffer, id);
+        m_commandCaptureBuffers.emplace_back(buffer);
+        return id;
+    }
+
+    void Graphics::FlushOffscreen()
+    {
+        // 오래된 프레임부터 읽음
+        for (size_t i = 0; i < m_offscreenTargets.size(); i++)
         {
-            cout << "CreateTexture2D() failed." << endl;
+            size_t oldest = m_offscreenTargets.size();
+            for (size_t j = 0; j < m_offscreenTargets.size(); j++)
+            {
+                if (m_offscreenTargets[j].pending &&
+                    (oldest == m_offscreenTargets.size() ||
+                     m_offscreenTargets[j].frame < m_offscreenTargets[oldest].frame))
+                    oldest = j;
+            }
+            if (oldest == m_offscreenTargets.size())
+                break;
+            ReadOffscreenTarget(oldest, true);
         }
-        if (FAILED(
-                m_device->CreateDepthStencilView(m_depthStencilBuffer.Get(), 0, &m_depthStencilView)))
+
+        if (m_imageWriter)
+            m_imageWriter->WaitIdle();
+    }
+
+    void Graphics::BeginOffscreenFrame()
+    {
+        const size_t index = m_frameIndex % m_offscreenTargets.size();
+        OffscreenTarget &target = m_offscreenTargets[index];
+
+        // kOffscreenLatency 프레임 동안 GPU가 복사를 끝내지 못했으면 여기서만 기다림
+        if (target.pending)
+            ReadOffscreenTarget(index, true);
+
+        target.outputPath = m_offscreenOutputPath;
+        m_renderTargetView = target.renderTargetView; // Render()가 이 타겟에 그림
+    }
+
+    void Graphics::EndOffscreenFrame()
+    {
+        const size_t latency = m_offscreenTargets.size();
+        OffscreenTarget &target = m_offscreenTargets[m_frameIndex % latency];
+        m_offscreenStats.framesRendered++;
+
+        if (!target.outputPath.empty() && m_imageWriter)
         {
-            cout << "CreateDepthStencilView() failed." << endl;
+            // GPU에서 스테이징 텍스처로 복사만 예약하고 기다리지 않음
+            m_context->CopyResource(target.staging.Get(), target.texture.Get());
+            target.frame = m_frameIndex;
+            target.pending = true;
         }
 
-#pragma region CreateDepthStencilState desc
-        D3D11_DEPTH_STENCIL_DESC depthStencilDesc;
-        ZeroMemory(&depthStencilDesc, sizeof(D3D11_DEPTH_STENCIL_DESC));
-        depthStencilDesc.DepthEnable = true; // false
-        depthStencilDesc.DepthWriteMask = D3D11_DEPTH_WRITE_MASK::D3D11_DEPTH_WRITE_MASK_ALL;
-        depthStencilDesc.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_LESS_EQUAL;
-        if (FAILED(m_device->CreateDepthStencilState(&depthStencilDesc,
-                                                     m_depthStencilState.GetAddressOf())))
+        // Present()가 없으므로 직접 명령을 GPU로 보냄 (완료를 기다리지는 않음)
+        m_context->Flush();
+
+        ReadFinishedOffscreenTargets();
+    }
+
+    void Graphics::CaptureBackBuffer()
+    {
+        const size_t index = m_frameIndex % m_offscreenTargets.size();
+        OffscreenTarget &target = m_offscreenTargets[index];
+
+        // 창 모드에서는 프레임을 멈추지 않음: 아직 읽지 못한 타겟이면 이번 프레임은 건너뜀
+        if (target.pending && !ReadOffscreenTarget(index, false))
         {
-            cout << "CreateDepthStencilState() failed." << endl;
+            m_offscreenStats.framesSkipped++;
+            return;
+        }
+
+        char name[32];
+        snprintf(name, sizeof(name), "frame_%06llu", (unsigned long long)m_frameIndex);
+        target.outputPath = m_captureDirectory / name;
+
+        // MSAA 백 버퍼는 스테이징으로 바로 복사할 수 없으므로 먼저 resolve
+        D3D11_TEXTURE2D_DESC backBufferDesc;
+        mFrameBuffer->GetDesc(&backBufferDesc);
+        if (backBufferDesc.SampleDesc.Count > 1)
+        {
+            m_context->ResolveSubresource(target.texture.Get(), 0, mFrameBuffer.Get(), 0,
+                                          backBufferDesc.Format);
+            m_context->CopyResource(target.staging.Get(), target.texture.Get());
+        }
+        else
+        {
+            m_context->CopyResource(target.staging.Get(), mFrameBuffer.Get());
+        }
+        target.frame = m_frameIndex;
+        target.pending = true;
+        m_offscreenStats.framesRendered++;
+
+        ReadFinishedOffscreenTargets();
+    }
+
+    void Graphics::ReadFinishedOffscreenTargets()
+    {
+        const size_t latency = m_offscreenTargets.size();
+        for (size_t i = 0; i < latency; i++)
+        {
+            const OffscreenTarget &candidate = m_offscreenTargets[i];
+            if (candidate.pending && candidate.frame + latency - 1 <= m_frameIndex)
+                ReadOffscreenTarget(i, false);
+        }
+    }
+
+    bool Graphics::ReadOffscreenTarget(size_t index, bool wait)
+    {
+        OffscreenTarget &target = m_offscreenTargets[index];
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        HRESULT hr = m_context->Map(target.staging.Get(), 0, D3D11_MAP_READ,
+                                    D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+        {
+            if (!wait)
+            {
+                m_offscreenStats.readbackMisses++;
+                return false;
+            }
+            m_offscreenStats.readbackStalls++;
+            hr = m_context->Map(target.staging.Get(), 0, D3D11_MAP_READ, 0, &mapped);
+        }
+
+        if (FAILED(hr))
+        {
+            cout << "Map() failed. " << std::hex << hr << std::dec << endl;
+            target.pending = false;
+            return false;
+        }
+
+        // RowPitch는 가로 바이트 수보다 클 수 있으므로 행 단위로 복사
+        const size_t rowBytes = size_t(m_screenWidth) * 4;
+        vector<uint8_t> pixels = m_imageWriter->AcquireBuffer(rowBytes * m_screenHeight);
+        for (int y = 0; y < m_screenHeight; y++)
+            memcpy(pixels.data() + y * rowBytes, static_cast<const uint8_t *>(mapped.pData) + y * mapped.RowPitch,
+                   rowBytes);
+        m_context->Unmap(target.staging.Get(), 0);
+
+        target.pending = false;
+        if (m_imageWriter->Submit(target.outputPath, m_screenWidth, m_screenHeight, std::move(pixels)))
+            m_offscreenStats.framesWritten++;
+        return true;
+    }
+
+    void Graphics::SetDynamicResolution(bool enable)
+    {
+        if (m_offscreen || enable == m_useDynamicResolution)
+            return;
+        if (enable && m_upscalePipeline.IsNull() && !InitDynamicResolution())
+            return;
+
+        m_useDynamicResolution = enable;
+        m_dynamicResolution.Reset();
+        if (!enable)
+            ReleaseSceneTargets();
+        m_cpuFrameMs = 0.0f;
+        m_gpuFrameMs = 0.0f;
+    }
+
+    bool Graphics::InitDynamicResolution()
+    {
+        DynamicResolutionSettings settings = m_dynamicResolution.GetSettings();
+        settings.maxMsaaSamples = m_numQualityLevels > 0 ? 4 : 1;
+        m_dynamicResolution.SetSettings(settings);
+
+        D3D11_SAMPLER_DESC samplerDesc = {};
+        samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+        samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+        samplerDesc.ComparisonFunc = D3D11_COMPARISON_NEVER;
+        samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+        if (FAILED(m_device->CreateSamplerState(&samplerDesc, m_upscaleSampler.GetAddressOf())))
+        {
+            cout << "CreateSamplerState() failed." << endl;
+            return false;
         }
-#pragma endregion
 
+        CreateConstantBuffer(UpscaleConstantBuffer{}, m_upscaleConstantBuffer);
+
+        // 화면을 덮는 삼각형 하나: 버텍스 버퍼/입력 레이아웃과 깊이 버퍼 없음
+        PipelineStateDesc desc = PipelineStateDesc::Default();
+        desc.vertexShaderFile = L"../Shader_Source/UpscaleVertexShader.hlsl";
+        desc.pixelShaderFile = L"../Shader_Source/UpscalePixelShader.hlsl";
+        desc.depthStencil.DepthEnable = false;
+        desc.depthStencil.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+        m_upscalePipeline = m_pipelineStates.GetOrCreate(desc);
+        return !m_upscalePipeline.IsNull();
+    }
+
+    bool Graphics::CreateSceneTargets(UINT samples)
+    {
+        ReleaseSceneTargets();
+
+        m_sceneColorDesc.width = m_screenWidth;
+        m_sceneColorDesc.height = m_screenHeight;
+        m_sceneColorDesc.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        m_sceneColorDesc.samples = samples;
+        // MSAA 텍스처는 resolve한 텍스처를 샘플링
+        m_sceneColorDesc.bindFlags =
+            D3D11_BIND_RENDER_TARGET | (samples > 1 ? 0 : D3D11_BIND_SHADER_RESOURCE);
+
+        m_sceneDepthDesc = m_sceneColorDesc;
+        m_sceneDepthDesc.format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+        m_sceneDepthDesc.bindFlags = D3D11_BIND_DEPTH_STENCIL;
+
+        m_sceneResolvedDesc = m_sceneColorDesc;
+        m_sceneResolvedDesc.samples = 1;
+        m_sceneResolvedDesc.bindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        if (!m_targetPool.Acquire(m_sceneColorDesc, m_sceneColor) ||
+            !m_targetPool.Acquire(m_sceneDepthDesc, m_sceneDepth) ||
+            (samples > 1 && !m_targetPool.Acquire(m_sceneResolvedDesc, m_sceneResolved)))
+        {
+            cout << "Creating dynamic resolution targets failed." << endl;
+            m_sceneColor = {};
+            m_sceneDepth = {};
+            return false;
+        }
+
+        m_sceneSamples = samples;
         return true;
     }
 
+    void Graphics::ReleaseSceneTargets()
+    {
+        if (m_sceneSamples == 0)
+            return;
+
+        m_targetPool.Release(m_sceneColorDesc, std::move(m_sceneColor));
+        m_targetPool.Release(m_sceneDepthDesc, std::move(m_sceneDepth));
+        if (m_sceneSamples > 1)
+            m_targetPool.Release(m_sceneResolvedDesc, std::move(m_sceneResolved));
+        m_sceneColor = {};
+        m_sceneDepth = {};
+        m_sceneResolved = {};
+        m_sceneSamples = 0;
+    }
+
+    void Graphics::BeginScaledFrame()
+    {
+        // 프로파일러가 가장 최근에 완성한 프레임의 GPU 시간 (보통 몇 프레임 전)
+        const ProfileFrame *profiled = m_profiler.GetLatestFrame();
+        if (profiled && profiled->gpuValid)
+            m_gpuFrameMs = float(profiled->gpuMs);
+
+        uint32_t oldWidth, oldHeight;
+        m_dynamicResolution.GetRenderSize(m_screenWidth, m_screenHeight, oldWidth, oldHeight);
+        // 괄호: windows.h의 max 매크로 회피
+        if (m_cpuFrameMs > 0.0f && m_dynamicResolution.Update((std::max)(m_cpuFrameMs, m_gpuFrameMs)))
+        {
+            const ResolutionDecision &decision = m_dynamicResolution.GetLog().back();
+            uint32_t newWidth, newHeight;
+            m_dynamicResolution.GetRenderSize(m_screenWidth, m_screenHeight, newWidth, newHeight);
+            cout << "Dynamic resolution: " << oldWidth << "x" << oldHeight << " " << decision.oldMsaaSamples
+                 << "x MSAA -> " << newWidth << "x" << newHeight << " " << decision.newMsaaSamples
+                 << "x MSAA (average " << decision.frameMs << " ms, target "
+                 << m_dynamicResolution.GetSettings().targetFrameMs << " ms)" << endl;
+        }
+
+        // MSAA 샘플 수가 바뀌었으면 프레임 경계인 지금 다시 만듦
+        if (m_sceneSamples != m_dynamicResolution.GetMsaaSamples() &&
+            !CreateSceneTargets(m_dynamicResolution.GetMsaaSamples()))
+        {
+            m_useDynamicResolution = false;
+            return;
+        }
+
+        m_backBufferView = m_renderTargetView;
+        m_backBufferDepthView = m_depthStencilView;
+        m_renderTargetView = m_sceneColor.renderTargetView;
+        m_depthStencilView = m_sceneDepth.depthStencilView;
+
+        uint32_t renderWidth, renderHeight;
+        m_dynamicResolution.GetRenderSize(m_screenWidth, m_screenHeight, renderWidth, renderHeight);
+        m_screenViewport = {0.0f, 0.0f, float(renderWidth), float(renderHeight), 0.0f, 1.0f};
+
+        m_scaledFrameStart = chrono::high_resolution_clock::now();
+    }
+
+    void Graphics::EndScaledFrame()
+    {
+        if (!m_backBufferView)
+            return; // BeginScaledFrame()에서 꺼진 경우
+
+        m_cpuFrameMs = chrono::duration<float, milli>(chrono::high_resolution_clock::now() -
+                                                      m_scaledFrameStart).count();
+
+        const D3D11_VIEWPORT sceneViewport = m_screenViewport;
+        m_screenViewport = {0.0f, 0.0f, float(m_screenWidth), float(m_screenHeight), 0.0f, 1.0f};
+        m_renderTargetView = std::move(m_backBufferView);
+        m_depthStencilView = std::move(m_backBufferDepthView);
+
+        if (m_sceneSamples > 1)
+            m_context->ResolveSubresource(m_sceneResolved.texture.Get(), 0, m_sceneColor.texture.Get(), 0,
+                                          DXGI_FORMAT_R8G8B8A8_UNORM);
+
+        // 장면 텍스처는 버킷 크기라 화면보다 클 수 있으므로 텍스처 크기 기준으로 계산
+        const RenderTargetDesc bucket = m_targetPool.GetBucket(m_sceneColorDesc);
+        UpscaleConstantBuffer constants;
+        constants.uvScale[0] = sceneViewport.Width / bucket.width;
+        constants.uvScale[1] = sceneViewport.Height / bucket.height;
+        constants.uvClamp[0] = (sceneViewport.Width - 0.5f) / bucket.width;
+        constants.uvClamp[1] = (sceneViewport.Height - 0.5f) / bucket.height;
+        UpdateBuffer(constants, m_upscaleConstantBuffer);
+
+        m_context->OMSetRenderTargets(1, m_renderTargetView.GetAddressOf(), nullptr);
+        m_context->RSSetViewports(1, &m_screenViewport);
+        m_pipelineStates.Get(m_upscalePipeline)->Bind(m_context.Get());
+        const PooledTexture &sampled = m_sceneSamples > 1 ? m_sceneResolved : m_sceneColor;
+        m_context->PSSetShaderResources(0, 1, sampled.shaderResourceView.GetAddressOf());
+        m_context->PSSetSamplers(0, 1, m_upscaleSampler.GetAddressOf());
+        m_context->PSSetConstantBuffers(0, 1, m_upscaleConstantBuffer.GetAddressOf());
+        {
+            GpuProfileScope gpuScope(&m_profiler, "Upscale");
+            m_context->Draw(3, 0);
+        }
+
+        // 다음 프레임에 렌더 타겟으로 다시 쓰므로 바인딩 해제
+        ID3D11ShaderResourceView *nullView = nullptr;
+        m_context->PSSetShaderResources(0, 1, &nullView);
+    }
+
+    void Graphics::BuildGUI()
+    {
+        const auto start = chrono::high_resolution_clock::now();
+
+        ImGui_ImplDX11_NewFrame(); // GUI 프레임 시작
+        ImGui_ImplWin32_NewFrame();
+
+        ImGui::NewFrame(); // 어떤 것들을 렌더링 할지 기록 시작
+        ImGui::Begin("Scene Control");
+
+        // 프레임 시간은 통계를 새로 고칠 때만 갱신 (그 사이 프레임들의 평균)
+        if (IsOverlayStatsRefresh() && m_overlayFrameCount > 0)
+        {
+            m_overlayFrameMs = m_overlayFrameMsSum / m_overlayFrameCount;
+            m_overlayFrameMsSum = 0.0f;
+            m_overlayFrameCount = 0;
+        }
+        ImGui::Text("Average %.3f ms/frame (%.1f FPS)", m_overlayFrameMs,
+                    m_overlayFrameMs > 0.0f ? 1000.0f / m_overlayFrameMs : 0.0f);
+
+        if (m_shaderReloader)
+            ImGui::Text("Shader reloads %u, failures %u", m_shaderReloader->GetReloadCount(),
+                        m_shaderReloader->GetFailureCount());
+
+        UpdateOverlayGUI();
+        UpdateProfilerGUI();
+
+        UpdateGUI(); // 추가적으로 사용할 GUI
+
+        ImGui::End();
+        ImGui::Render(); // 렌더링할 것들 기록 끝
+
+        // 슬라이더를 끌거나 글자를 입력하는 동안은 입력 메시지가 없어도 매 프레임 다시 만들어야 함
+        const ImGuiIO &io = ImGui::GetIO();
+        m_overlay.SetBusy(ImGui::IsAnyItemActive() || io.WantTextInput);
+        m_overlay.EndBuild(
+            chrono::duration<float, milli>(chrono::high_resolution_clock::now() - start).count());
+    }
+
+    void Graphics::SetOverlayMode(OverlayMode mode) { m_overlay.SetMode(mode); }
+
+    void Graphics::OnInputMessage(UINT message, WPARAM wParam)
+    {
+        // F1: Throttled -> EveryFrame -> Hidden -> Throttled
+        if (message == WM_KEYDOWN && wParam == VK_F1)
+        {
+            const OverlayMode next = m_overlay.GetMode() == OverlayMode::Throttled    ? OverlayMode::EveryFrame
+                                     : m_overlay.GetMode() == OverlayMode::EveryFrame ? OverlayMode::Hidden
+                                                                                      : OverlayMode::Throttled;
+            m_overlay.SetMode(next);
+            return;
+        }
+
+        const bool isInput = (message >= WM_MOUSEFIRST && message <= WM_MOUSELAST) ||
+                             (message >= WM_KEYFIRST && message <= WM_KEYLAST) ||
+                             message == WM_MOUSELEAVE || message == WM_SETFOCUS ||
+                             message == WM_KILLFOCUS || message == WM_SETCURSOR;
+        if (isInput)
+            m_overlay.NotifyInput();
+    }
+
+    void Graphics::UpdateOverlayGUI()
+    {
+        if (!ImGui::CollapsingHeader("Overlay"))
+            return;
+
+        int mode = int(m_overlay.GetMode());
+        ImGui::Text("F1: throttled / every frame / hidden");
+        bool changed = ImGui::RadioButton("Throttled", &mode, int(OverlayMode::Throttled));
+        ImGui::SameLine();
+        changed |= ImGui::RadioButton("Every frame", &mode, int(OverlayMode::EveryFrame));
+        ImGui::SameLine();
+        changed |= ImGui::RadioButton("Hidden", &mode, int(OverlayMode::Hidden));
+        if (changed)
+            m_overlay.SetMode(OverlayMode(mode));
+
+        OverlaySettings settings = m_overlay.GetSettings();
+        if (ImGui::SliderFloat("Stats interval ms", &settings.statsIntervalMs, 0.0f, 1000.0f))
+            m_overlay.SetSettings(settings);
+
+        const OverlayStats &stats = m_overlay.GetStats();
+        ImGui::Text("Rebuilt %llu, reused %llu, stats %llu, build %.3f ms",
+                    (unsigned long long)stats.rebuiltFrames, (unsigned long long)stats.reusedFrames,
+                    (unsigned long long)stats.statsRefreshes, stats.lastBuildMs);
+    }
+
+    void Graphics::UpdateProfilerGUI()
+    {
+        if (!ImGui::CollapsingHeader("Profiler"))
+            return;
+
+        // 최근 프레임과 그래프는 통계를 새로 고칠 때만 복사 (그 사이에는 같은 값을 보여줌)
+        if (IsOverlayStatsRefresh() || !m_hasProfilerSnapshot)
+        {
+            if (const ProfileFrame *latest = m_profiler.GetLatestFrame())
+            {
+                m_profilerSnapshot = *latest;
+                m_hasProfilerSnapshot = true;
+            }
+            const size_t count = m_profiler.GetFrameCount();
+            m_profilerCpuPlot.resize(count);
+            m_profilerGpuPlot.resize(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                const ProfileFrame &frame = m_profiler.GetFrame(i);
+                m_profilerCpuPlot[i] = float(frame.cpuMs);
+                m_profilerGpuPlot[i] = float(frame.gpuMs);
+            }
+        }
+
+        if (!m_hasProfilerSnapshot)
+        {
+            ImGui::Text("Waiting for GPU timestamps...");
+            return;
+        }
+        const ProfileFrame *latest = &m_profilerSnapshot;
+
+        // 최근 프레임 기준. GPU 결과는 kLatency 프레임 안에서 늦게 도착함
+        if (latest->gpuValid)
+            ImGui::Text("Frame %llu: CPU %.3f ms, GPU %.3f ms (%s-bound)", latest->frame, latest->cpuMs,
+                        latest->gpuMs, latest->gpuMs > latest->cpuMs ? "GPU" : "CPU");
+        else
+            ImGui::Text("Frame %llu: CPU %.3f ms, GPU n/a", latest->frame, latest->cpuMs);
+
+        const int count = int(m_profilerCpuPlot.size());
+        ImGui::PlotLines("CPU ms", m_profilerCpuPlot.data(), count, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 40));
+        ImGui::PlotLines("GPU ms", m_profilerGpuPlot.data(), count, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 40));
+
+        ImGui::Text("CPU scopes");
+        for (const ProfileEvent &event : latest->cpuEvents)
+            ImGui::Text("%*s%-10s %7.3f ms", int(event.depth + 1) * 2, "", event.name,
+                        event.endMs - event.startMs);
+        if (latest->gpuValid)
+        {
+            ImGui::Text("GPU scopes");
+            for (const ProfileEvent &event : latest->gpuEvents)
+                ImGui::Text("%*s%-10s %7.3f ms", int(event.depth + 1) * 2, "", event.name,
+                            event.endMs - event.startMs);
+        }
+
+        const ProfilerStats &stats = m_profiler.GetStats();
+        ImGui::Text("GPU frames dropped %llu, disjoint %llu", stats.gpuFramesDropped,
+                    stats.gpuFramesDisjoint);
+
+        // chrome://tracing이나 ui.perfetto.dev에서 열 수 있음
+        if (ImGui::Button("Export timeline") && m_profiler.ExportTrace("profile.json"))
+            cout << "Profiler timeline saved to profile.json" << endl;
+    }
+
     bool Graphics::InitGUI()
     {
 
@@ -434,7 +1294,74 @@ namespace luke
                                     &pixelShader);
     }
 
-    void Graphics::CreateIndexBuffer(const std::vector<uint16_t> &indices,
+    void Graphics::WatchShaderProgram(ShaderHandle program, const wstring &vertexShaderFile,
+                                      const wstring &pixelShaderFile,
+                                      const vector<D3D11_INPUT_ELEMENT_DESC> &inputElements)
+    {
+        if (!m_shaderReloader)
+            return;
+
+        auto addTarget = [&](const wstring &file, const char *profile,
+                             const vector<D3D11_INPUT_ELEMENT_DESC> &elements) {
+            const std::filesystem::path path = std::filesystem::weakly_canonical(file);
+            if (!m_shaderReloader->Watch(path, profile))
+                return;
+            m_shaderReloadTargets.push_back({program, path, elements});
+        };
+
+        addTarget(vertexShaderFile, "vs_5_0", inputElements);
+        addTarget(pixelShaderFile, "ps_5_0", {});
+    }
+
+    bool Graphics::ApplyReloadedShader(const CompiledShader &shader)
+    {
+        const bool isVertexShader = shader.profile.rfind("vs_", 0) == 0;
+        bool applied = m_pipelineStates.ApplyReloadedShader(shader);
+
+        for (const ShaderReloadTarget &target : m_shaderReloadTargets)
+        {
+            if (target.path != shader.path || !shader.defines.empty())
+                continue;
+
+            ShaderProgram *program = m_resources.m_shaders.Get(target.program);
+            if (!program)
+                continue; // 이미 삭제된 쉐이더
+
+            // 새 객체를 모두 만든 뒤에 교체. 하나라도 실패하면 이전 쉐이더를 유지합니다.
+            if (isVertexShader)
+            {
+                ComPtr<ID3D11VertexShader> vertexShader;
+                ComPtr<ID3D11InputLayout> inputLayout;
+                if (FAILED(m_device->CreateVertexShader(shader.bytecode.data(), shader.bytecode.size(),
+                                                        NULL, &vertexShader)) ||
+                    FAILED(m_device->CreateInputLayout(
+                        target.inputElements.data(), UINT(target.inputElements.size()),
+                        shader.bytecode.data(), shader.bytecode.size(), &inputLayout)))
+                {
+                    cout << "CreateVertexShader() failed while reloading." << endl;
+                    return false;
+                }
+                program->m_vertexShader = vertexShader;
+                program->m_inputLayout = inputLayout;
+            }
+            else
+            {
+                ComPtr<ID3D11PixelShader> pixelShader;
+                if (FAILED(m_device->CreatePixelShader(shader.bytecode.data(), shader.bytecode.size(),
+                                                       NULL, &pixelShader)))
+                {
+                    cout << "CreatePixelShader() failed while reloading." << endl;
+                    return false;
+                }
+                program->m_pixelShader = pixelShader;
+            }
+            applied = true;
+        }
+
+        return applied;
+    }
+
+    void Graphics::CreateIndexBuffer(std::span<const uint16_t> indices,
                                     ComPtr<ID3D11Buffer> &m_indexBuffer)
     {
         D3D11_BUFFER_DESC bufferDesc = {};
@@ -449,7 +1376,77 @@ namespace luke
         indexBufferData.SysMemPitch = 0;
         indexBufferData.SysMemSlicePitch = 0;
 
-        m_device->CreateBuffer(&bufferDesc, &indexBufferData, m_indexBuffer.GetAddressOf());
+        const HRESULT hr = CreateTrackedBuffer(m_device.Get(), m_gpuMemory, bufferDesc, &indexBufferData,
+                                               m_indexBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            std::cout << "CreateBuffer() failed. " << std::hex << hr << std::dec << std::endl;
+        }
+    }
+
+    void Graphics::CreateDynamicVertexBuffer(UINT byteWidth, ComPtr<ID3D11Buffer> &vertexBuffer)
+    {
+        D3D11_BUFFER_DESC bufferDesc = {};
+        bufferDesc.Usage = D3D11_USAGE_DYNAMIC; // CPU가 매 프레임 씀
+        bufferDesc.ByteWidth = byteWidth;
+        bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+        const HRESULT hr =
+            CreateTrackedBuffer(m_device.Get(), m_gpuMemory, bufferDesc, nullptr, vertexBuffer.GetAddressOf());
+        if (FAILED(hr))
+        {
+            std::cout << "CreateBuffer() failed. " << std::hex << hr << std::dec << std::endl;
+        }
+    }
+
+    void Graphics::CreateDynamicConstantBuffer(UINT byteWidth, ComPtr<ID3D11Buffer> &constantBuffer)
+    {
+        D3D11_BUFFER_DESC bufferDesc = {};
+        bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+        bufferDesc.ByteWidth = byteWidth;
+        bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+        bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+        const HRESULT hr = CreateTrackedBuffer(m_device.Get(), m_gpuMemory, bufferDesc, nullptr,
+                                               constantBuffer.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            std::cout << "CreateBuffer() failed. " << std::hex << hr << std::dec << std::endl;
+        }
+    }
+
+    bool Graphics::CreateDynamicStructuredBuffer(UINT stride, UINT count, ComPtr<ID3D11Buffer> &buffer,
+                                                 ComPtr<ID3D11ShaderResourceView> &view)
+    {
+        D3D11_BUFFER_DESC bufferDesc = {};
+        bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+        bufferDesc.ByteWidth = stride * count;
+        bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        bufferDesc.StructureByteStride = stride;
+
+        HRESULT hr = CreateTrackedBuffer(m_device.Get(), m_gpuMemory, bufferDesc, nullptr,
+                                         buffer.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            std::cout << "CreateBuffer() failed. " << std::hex << hr << std::dec << std::endl;
+            return false;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc = {};
+        viewDesc.Format = DXGI_FORMAT_UNKNOWN;
+        viewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        viewDesc.Buffer.FirstElement = 0;
+        viewDesc.Buffer.NumElements = count;
+        hr = m_device->CreateShaderResourceView(buffer.Get(), &viewDesc, view.ReleaseAndGetAddressOf());
+        if (FAILED(hr))
+        {
+            std::cout << "CreateShaderResourceView() failed. " << std::hex << hr << std::dec << std::endl;
+            return false;
+        }
+        return true;
     }
 
 } // namespace hlab
\ No newline at end of file
@@ -1,14 +1,33 @@
 ﻿#pragma once
 
+#include <chrono>
 #include <d3d11.h>
 #include <d3dcompiler.h>
 #include <imgui.h>
 #include <imgui_impl_dx11.h>
 #include <imgui_impl_win32.h>
 #include <iostream>
+#include <memory>
+#include <span>
+#include <unordered_map>
 #include <vector>
 #include <windows.h>
 #include <wrl.h> // ComPtr
+
+#include "CommandCapture.h"
+#include "D3D11Memory.h"
+#include "D3D11Timestamps.h"
+#include "DynamicResolution.h"
+#include "GpuMemory.h"
+#include "GuiOverlay.h"
+#include "ImageWriter.h"
+#include "Memory.h"
+#include "OffscreenRenderer.h"
+#include "PipelineState.h"
+#include "Profiler.h"
+#include "RenderTargetPool.h"
+#include "ResourceRegistry.h"
+#include "ShaderHotReloader.h"
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "d3dcompiler.lib")
 
@@ -19,6 +38,15 @@ namespace luke
   using std::vector;
   using std::wstring;
 
+  // RenderTargetPool에 보관하는 D3D11 텍스처와 desc.bindFlags에 맞춰 만든 뷰들
+  struct PooledTexture
+  {
+    ComPtr<ID3D11Texture2D> texture;
+    ComPtr<ID3D11RenderTargetView> renderTargetView;
+    ComPtr<ID3D11DepthStencilView> depthStencilView;
+    ComPtr<ID3D11ShaderResourceView> shaderResourceView;
+  };
+
   // 모든 예제들이 공통적으로 사용할 기능들을 가지고 있는
   // 부모 클래스
   class Graphics
@@ -35,10 +63,61 @@ namespace luke
 
     int Run();
 
+    // hwnd == nullptr 이면 창과 스왑 체인 없이 오프스크린 모드로 초기화합니다.
+    // 오프스크린 모드의 Run()은 ImGui와 Present() 없이 렌더 타겟 여러 장을 돌려 쓰며 그리고,
+    // SetOffscreenOutput()으로 지정한 파일에 kOffscreenLatency - 1 프레임 뒤에 저장합니다.
     virtual bool Initialize(HWND hwnd, UINT width, UINT height);
+
+    // 창 크기가 바뀌면 WndProc(WM_SIZE)에서 호출합니다. 스왑 체인과 깊이 버퍼는 다음 Run()의
+    // 시작(프레임 경계)에서 한 번만 다시 만들므로, 크기를 끄는 동안 메시지가 여러 번 와도 마지막 크기만 적용됩니다.
+    // 0 x 0(최소화)이면 다시 커질 때까지 그리지 않습니다.
+    void RequestResize(UINT width, UINT height);
+
+    // 다음 Run()에서 그린 이미지를 저장할 파일 (확장자 없이). 비어 있으면 저장하지 않습니다.
+    void SetOffscreenOutput(const std::filesystem::path &path, ImageFormat format = ImageFormat::Png);
+    // 아직 읽지 않은 렌더 타겟을 모두 읽고 파일 쓰기가 끝날 때까지 대기
+    void FlushOffscreen();
+    bool IsOffscreen() const { return m_offscreen; }
+
+    // 창 모드에서 매 프레임 백 버퍼를 directory/frame_000123.png 처럼 저장합니다.
+    // 렌더링을 멈추지 않도록 인코더 큐가 가득 차면 그 프레임은 버리고(QueueFullPolicy::Drop),
+    // 스테이징 텍스처가 아직 읽히지 않았으면 캡처를 건너뜁니다. (OffscreenStats::framesSkipped)
+    bool StartCapture(const std::filesystem::path &directory, ImageFormat format = ImageFormat::Png);
+    void StopCapture(); // 남은 프레임을 저장하고 끝냄
+    bool IsCapturing() const { return m_capturing; }
+
+    // 다음 프레임(Update() ~ Render())의 버퍼 갱신/바인딩/그리기 명령을 path에 저장합니다. (.lcap)
+    // Graphics_Benchmark --replay로 헤드리스 백엔드에서 다시 재생할 수 있습니다.
+    // 처음 쓰이는 버퍼는 스테이징 버퍼로 내용을 읽으므로 그 프레임은 느립니다.
+    void RequestCommandCapture(const std::filesystem::path &path);
+    bool IsRecordingCommands() const { return m_recordingCommands; }
+
+    // Graphics가 만드는 버퍼/텍스처의 GPU 메모리 기록 (예산과 퇴출 콜백도 여기에 설정)
+    GpuMemoryTracker &GetGpuMemory() { return m_gpuMemory; }
+    // intervalMs마다 Run()의 시작에서 GPU 메모리 통계를 path에 씁니다. (Prometheus 텍스트 형식)
+    // 모니터링 에이전트가 읽는 파일입니다. 비어 있으면 쓰지 않습니다.
+    void SetMemoryStatsOutput(const std::filesystem::path &path, double intervalMs = 1000.0);
+
+    // 창 모드에서 측정한 프레임 시간에 맞춰 내부 해상도(와 MSAA)를 조절하고 백 버퍼로 확대합니다.
+    // 켜져 있는 동안 Render()는 m_renderTargetView/m_depthStencilView/m_screenViewport를 그대로 쓰면 됩니다.
+    void SetDynamicResolution(bool enable);
+    bool IsDynamicResolution() const { return m_useDynamicResolution; }
+    const ImageWriter *GetImageWriter() const { return m_imageWriter.get(); }
+    const OffscreenStats &GetOffscreenStats() const { return m_offscreenStats; }
+
+    // 디버그 오버레이(ImGui). Hidden이면 ImGui를 전혀 부르지 않고,
+    // Throttled(기본)면 입력이 있거나 통계를 새로 고칠 때만 다시 만들고 나머지 프레임은 지난 그리기 데이터를 다시 그립니다.
+    void SetOverlayMode(OverlayMode mode);
+    OverlayMode GetOverlayMode() const { return m_overlay.GetMode(); }
+    bool IsOverlayVisible() const { return m_overlay.IsVisible(); }
+    // WndProc에서 모든 메시지를 넘겨줍니다. 입력이면 오버레이를 다시 만들고, F1은 오버레이 모드를 바꿉니다.
+    // 숨겨져 있으면 ImGui_ImplWin32_WndProcHandler()를 부르지 않아야 합니다. (NewFrame() 없이 입력이 쌓임)
+    void OnInputMessage(UINT message, WPARAM wParam);
     virtual void UpdateGUI() = 0;
     virtual void Update(float dt) = 0;
     virtual void Render() = 0;
+    // 화면 크기가 실제로 바뀐 프레임에 한 번 호출됩니다. (m_screenWidth/m_screenHeight/m_screenViewport는 새 값)
+    virtual void OnResize() {}
 
     //virtual LRESULT MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
@@ -49,16 +128,60 @@ namespace luke
 
   protected: // 상속 받은 클래스에서도 접근 가능
     bool InitDirect3D(HWND hwnd);
+    bool CreateBackBufferTargets(); // 백 버퍼 뷰 + 풀에서 받은 깊이 버퍼
+    bool ApplyPendingResize();      // 그릴 수 없으면(최소화) false
+    bool CreatePooledTexture(const RenderTargetDesc &desc, PooledTexture &target);
     bool InitGUI();
+    bool InitOffscreenTargets();
+    bool CreateOffscreenTargets(); // 렌더 타겟 + 스테이징 텍스처 kOffscreenLatency장
+    void ExportMemoryStats(); // SetMemoryStatsOutput()의 간격이 지났으면 씀
+    void ResetImageWriter(ImageFormat format, QueueFullPolicy policy);
+    void BeginOffscreenFrame();
+    void EndOffscreenFrame();
+    void CaptureBackBuffer();
+    void BeginCommandCapture();
+    void EndCommandCapture();
+    // 이번 명령 캡처 안의 버퍼 번호. 처음 쓰이면 지금 내용을 읽어서 setup에 추가
+    uint32_t GetCaptureBufferId(ID3D11Buffer *buffer);
+    void ReadFinishedOffscreenTargets(); // (latency - 1) 프레임 이상 지난 타겟을 기다리지 않고 읽음
+    bool ReadOffscreenTarget(size_t index, bool wait); // m_offscreenTargets[index]
+    bool InitDynamicResolution();       // 확대 파이프라인, 샘플러
+    bool CreateSceneTargets(UINT samples);
+    void ReleaseSceneTargets(); // m_targetPool로 돌려줌
+    void BeginScaledFrame();
+    void EndScaledFrame();
+    void BuildGUI();          // NewFrame() ~ Render()
+    void UpdateOverlayGUI();  // "Scene Control" 창의 Overlay 항목
+    void UpdateProfilerGUI(); // "Scene Control" 창의 Profiler 항목
+    // 이번에 다시 만드는 GUI에서 비싼 통계도 새로 계산할지 (OverlaySettings::statsIntervalMs마다)
+    // false이면 지난번에 계산한 값을 그대로 보여주면 됩니다.
+    bool IsOverlayStatsRefresh() const { return m_overlay.IsStatsRefresh(); }
     void CreateVertexShaderAndInputLayout(const wstring &filename,
                                           const vector<D3D11_INPUT_ELEMENT_DESC> &inputElements,
                                           ComPtr<ID3D11VertexShader> &vertexShader,
                                           ComPtr<ID3D11InputLayout> &inputLayout);
     void CreatePixelShader(const wstring &filename, ComPtr<ID3D11PixelShader> &pixelShader);
-    void CreateIndexBuffer(const vector<uint16_t> &indices, ComPtr<ID3D11Buffer> &m_indexBuffer);
 
-    template <typename T_VERTEX>
-    void CreateVertexBuffer(const vector<T_VERTEX> &vertices, ComPtr<ID3D11Buffer> &vertexBuffer)
+    // 쉐이더 파일이 바뀌면 백그라운드에서 다시 컴파일해서
+    // 다음 프레임 시작 시 program의 쉐이더(와 입력 레이아웃)를 교체합니다.
+    void WatchShaderProgram(ShaderHandle program, const wstring &vertexShaderFile,
+                            const wstring &pixelShaderFile,
+                            const vector<D3D11_INPUT_ELEMENT_DESC> &inputElements);
+    bool ApplyReloadedShader(const CompiledShader &shader);
+    void CreateIndexBuffer(std::span<const uint16_t> indices, ComPtr<ID3D11Buffer> &m_indexBuffer);
+    // 매 프레임 Map(WRITE_DISCARD)으로 다시 쓰는 버텍스 버퍼 (스키닝 결과 등)
+    void CreateDynamicVertexBuffer(UINT byteWidth, ComPtr<ID3D11Buffer> &vertexBuffer);
+    // 매 프레임 Map(WRITE_DISCARD)으로 다시 쓰는 상수 버퍼. 여러 물체의 상수를 이어 붙이고
+    // VSSetConstantBuffers1()로 범위만 바인딩하는 경우처럼 크기가 상수 구조체와 다를 때 사용
+    void CreateDynamicConstantBuffer(UINT byteWidth, ComPtr<ID3D11Buffer> &constantBuffer);
+    // 매 프레임 Map(WRITE_DISCARD)으로 다시 쓰고 쉐이더가 StructuredBuffer로 읽는 버퍼와 SRV
+    bool CreateDynamicStructuredBuffer(UINT stride, UINT count, ComPtr<ID3D11Buffer> &buffer,
+                                       ComPtr<ID3D11ShaderResourceView> &view);
+
+    // MeshData는 std::pmr::vector를 사용하므로 할당자 종류에 상관없이 받습니다.
+    template <typename T_VERTEX, typename T_ALLOC>
+    void CreateVertexBuffer(const vector<T_VERTEX, T_ALLOC> &vertices,
+                            ComPtr<ID3D11Buffer> &vertexBuffer)
     {
 
       // D3D11_USAGE enumeration (d3d11.h)
@@ -77,8 +200,8 @@ namespace luke
       vertexBufferData.SysMemPitch = 0;
       vertexBufferData.SysMemSlicePitch = 0;
 
-      const HRESULT hr =
-          m_device->CreateBuffer(&bufferDesc, &vertexBufferData, vertexBuffer.GetAddressOf());
+      const HRESULT hr = CreateTrackedBuffer(m_device.Get(), m_gpuMemory, bufferDesc, &vertexBufferData,
+                                             vertexBuffer.GetAddressOf());
       if (FAILED(hr))
       {
         std::cout << "CreateBuffer() failed. " << std::hex << hr << std::endl;
@@ -103,12 +226,20 @@ namespace luke
       InitData.SysMemPitch = 0;
       InitData.SysMemSlicePitch = 0;
 
-      m_device->CreateBuffer(&cbDesc, &InitData, constantBuffer.GetAddressOf());
+      const HRESULT hr =
+          CreateTrackedBuffer(m_device.Get(), m_gpuMemory, cbDesc, &InitData, constantBuffer.GetAddressOf());
+      if (FAILED(hr))
+      {
+        std::cout << "CreateBuffer() failed. " << std::hex << hr << std::dec << std::endl;
+      }
     }
 
     template <typename T_DATA>
     void UpdateBuffer(const T_DATA &bufferData, ComPtr<ID3D11Buffer> &buffer)
     {
+      if (m_recordingCommands)
+        m_commandCapture.UpdateBuffer(GetCaptureBufferId(buffer.Get()), &bufferData, sizeof(bufferData));
+
       D3D11_MAPPED_SUBRESOURCE ms;
       m_context->Map(buffer.Get(), NULL, D3D11_MAP_WRITE_DISCARD, NULL, &ms);
       memcpy(ms.pData, &bufferData, sizeof(bufferData));
@@ -120,18 +251,121 @@ namespace luke
     int m_screenHeight;
     HWND m_mainWindow;
 
+    // 버퍼/텍스처가 해제될 때 기록을 지우므로 모든 D3D11 리소스보다 먼저 선언 (나중에 소멸)
+    GpuMemoryTracker m_gpuMemory;
+    std::filesystem::path m_memoryStatsPath;
+    double m_memoryStatsIntervalMs = 1000.0;
+    std::chrono::high_resolution_clock::time_point m_lastMemoryStatsTime;
+
     ComPtr<ID3D11Device> m_device;
     ComPtr<ID3D11DeviceContext> m_context;
     ComPtr<ID3D11Texture2D> mFrameBuffer;
     ComPtr<ID3D11RenderTargetView> m_renderTargetView;
     ComPtr<IDXGISwapChain> m_swapChain;
-    ComPtr<ID3D11RasterizerState> m_rasterizerSate;
 
     // Depth buffer 관련
     ComPtr<ID3D11Texture2D> m_depthStencilBuffer;
     ComPtr<ID3D11DepthStencilView> m_depthStencilView;
-    ComPtr<ID3D11DepthStencilState> m_depthStencilState;
 
     D3D11_VIEWPORT m_screenViewport;
+
+    // 깊이 버퍼와 동적 해상도 타겟은 크기 버킷별로 돌려 쓰므로 실제 텍스처는 화면보다 클 수 있습니다.
+    // (그리는 영역은 m_screenViewport)
+    RenderTargetPool<PooledTexture> m_targetPool;
+    PooledTexture m_depthTarget;
+    RenderTargetDesc m_depthTargetDesc;
+    UINT m_pendingWidth = 0; // RequestResize()
+    UINT m_pendingHeight = 0;
+    bool m_resizePending = false;
+    bool m_minimized = false;
+
+    // 한 프레임 동안만 쓰는 임시 메모리. Run()의 마지막에 Reset()됩니다.
+    LinearArena m_frameArena;
+
+    // 메쉬/버퍼/쉐이더 저장소. Release()된 리소스는 m_frameIndex를 기준으로 늦게 삭제됩니다.
+    ResourceRegistry m_resources;
+    uint64_t m_frameIndex = 0;
+
+    // 쉐이더 핫 리로드
+    struct ShaderReloadTarget
+    {
+      ShaderHandle program;
+      std::filesystem::path path;
+      vector<D3D11_INPUT_ELEMENT_DESC> inputElements; // 버텍스 쉐이더만 사용
+    };
+    std::unique_ptr<ShaderHotReloader> m_shaderReloader;
+    vector<ShaderReloadTarget> m_shaderReloadTargets;
+
+    // 래스터라이저/깊이/블렌드 상태와 쉐이더 퍼뮤테이션을 묶은 파이프라인 캐시
+    PipelineStateCache m_pipelineStates;
+
+    // 프레임마다 CPU 스코프와 GPU 타임스탬프를 기록해서 하나의 타임라인으로 합침
+    // (GPU 결과는 기다리지 않고 Profiler::kLatency 프레임 안에 읽음)
+    Profiler m_profiler;
+    D3D11Timestamps m_gpuTimestamps;
+
+    // 디버그 오버레이. 통계는 m_overlay가 정한 간격으로만 다시 계산해서 아래에 보관
+    OverlayScheduler m_overlay;
+    std::chrono::high_resolution_clock::time_point m_lastRunTime;
+    float m_frameDt = 1.0f / 60.0f;
+    float m_overlayFrameMs = 0.0f; // statsIntervalMs 동안의 평균
+    float m_overlayFrameMsSum = 0.0f;
+    uint32_t m_overlayFrameCount = 0;
+    ProfileFrame m_profilerSnapshot; // UpdateProfilerGUI()가 보여주는 프레임
+    bool m_hasProfilerSnapshot = false;
+    vector<float> m_profilerCpuPlot;
+    vector<float> m_profilerGpuPlot;
+
+    // 오프스크린 모드: 스왑 체인 대신 렌더 타겟을 돌려 쓰고 스테이징 텍스처로 늦게 읽음
+    // (OffscreenRenderer와 같은 방식을 D3D11 텍스처로 구현)
+    static constexpr UINT kOffscreenLatency = 3;
+    struct OffscreenTarget
+    {
+      ComPtr<ID3D11Texture2D> texture;
+      ComPtr<ID3D11RenderTargetView> renderTargetView;
+      ComPtr<ID3D11Texture2D> staging; // D3D11_USAGE_STAGING, CPU 읽기 전용
+      std::filesystem::path outputPath;
+      uint64_t frame = 0;
+      bool pending = false; // CopyResource() 했고 아직 Map() 하지 않음
+    };
+
+    bool m_offscreen = false;
+    bool m_capturing = false; // 창 모드 캡처 (StartCapture)
+    std::filesystem::path m_captureDirectory;
+    vector<OffscreenTarget> m_offscreenTargets;
+    std::filesystem::path m_offscreenOutputPath;
+    std::unique_ptr<ImageWriter> m_imageWriter;
+    OffscreenStats m_offscreenStats;
+
+    // 명령 캡처 (RequestCommandCapture). 캡처하는 동안 버퍼가 지워지지 않도록 참조를 들고 있음
+    std::filesystem::path m_commandCapturePath;
+    bool m_recordingCommands = false;
+    CommandCapture m_commandCapture;
+    std::unordered_map<ID3D11Buffer *, uint32_t> m_commandCaptureIds;
+    vector<ComPtr<ID3D11Buffer>> m_commandCaptureBuffers;
+
+    // 동적 해상도: 장면은 화면 크기 이상의 m_sceneColor 왼쪽 위 (배율 x 화면 크기) 영역에 그리고
+    // EndScaledFrame()에서 백 버퍼 전체로 늘립니다. 배율이 바뀌면 뷰포트만 바꾸고,
+    // MSAA 샘플 수나 화면 크기가 바뀔 때만 다음 프레임 시작에서 m_targetPool에서 다시 받습니다.
+    DynamicResolutionController m_dynamicResolution;
+    bool m_useDynamicResolution = false;
+    UINT m_numQualityLevels = 0; // 4x MSAA 품질 단계 수 (0이면 지원하지 않음)
+    UINT m_sceneSamples = 0;     // 0이면 아직 만들지 않음
+    PooledTexture m_sceneColor;
+    PooledTexture m_sceneDepth;
+    PooledTexture m_sceneResolved; // MSAA일 때 resolve 대상
+    RenderTargetDesc m_sceneColorDesc;
+    RenderTargetDesc m_sceneDepthDesc;
+    RenderTargetDesc m_sceneResolvedDesc;
+    ComPtr<ID3D11RenderTargetView> m_backBufferView; // 장면을 그리는 동안 보관
+    ComPtr<ID3D11DepthStencilView> m_backBufferDepthView;
+    ComPtr<ID3D11SamplerState> m_upscaleSampler;
+    ComPtr<ID3D11Buffer> m_upscaleConstantBuffer;
+    PipelineHandle m_upscalePipeline;
+
+    // 프레임 시간: Update()+Render()의 CPU 시간과 m_profiler의 GPU 프레임 시간 중 큰 쪽
+    float m_gpuFrameMs = 0.0f;
+    float m_cpuFrameMs = 0.0f;
+    std::chrono::high_resolution_clock::time_point m_scaledFrameStart;
   };
 } 
\ No newline at end of file
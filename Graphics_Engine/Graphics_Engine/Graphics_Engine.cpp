@@ -5,9 +5,12 @@
 #include "Graphics_Engine.h"
 #include "Application.h"
 
+#include <sstream>
+
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam,
     LPARAM lParam); //imgui 마우스 동작
 
+// 처음 창 크기. 이후에는 WM_SIZE로 바뀜
 #define WIDTH 1600
 #define HEIGHT 900
 luke::Application application;
@@ -35,7 +38,30 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     freopen_s(&console, "CONOUT$", "w", stdout);    // 표준 출력 리다이렉션
 #endif
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
+
+    // GPU 메모리 통계를 1초마다 파일로 씀 (모니터링 에이전트가 읽음): --memory-stats <파일> (다른 옵션 뒤에)
+    if (const wchar_t *option = wcsstr(lpCmdLine, L"--memory-stats"))
+    {
+        std::wistringstream args(option + 14);
+        std::wstring path;
+        if (args >> path)
+            application.SetMemoryStatsOutput(path);
+    }
+
+    // 창 없이 이미지만 저장: Graphics_Engine.exe --offscreen <디렉토리> [장수]
+    if (wcsncmp(lpCmdLine, L"--offscreen", 11) == 0)
+    {
+        std::wistringstream args(lpCmdLine + 11);
+        std::wstring directory = L"offscreen";
+        unsigned int count = 64;
+        args >> directory;
+        if (!(args >> count))
+            count = 64;
+
+        if (!application.Initialize(nullptr, WIDTH, HEIGHT))
+            return 1;
+        return application.RenderImageBatch(directory, count) ? 0 : 1;
+    }
 
     // TODO: 여기에 코드를 입력합니다.
 
@@ -147,13 +173,17 @@ BOOL InitInstance(HINSTANCE hInstance, int nCmdShow)
 //  용도: 주 창의 메시지를 처리합니다.
 //
 //  WM_COMMAND  - 애플리케이션 메뉴를 처리합니다.
+//  WM_SIZE     - 스왑 체인 크기 변경을 예약합니다.
 //  WM_PAINT    - 주 창을 그립니다.
 //  WM_DESTROY  - 종료 메시지를 게시하고 반환합니다.
 //
 //
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
-    if (ImGui_ImplWin32_WndProcHandler(hWnd, message, wParam, lParam)) //imgui 마우스 동작
+    // 입력이 오면 다음 프레임에 오버레이를 다시 만듦. 숨겨져 있으면 ImGui에 넘기지 않음
+    application.OnInputMessage(message, wParam);
+    if (application.IsOverlayVisible() &&
+        ImGui_ImplWin32_WndProcHandler(hWnd, message, wParam, lParam)) //imgui 마우스 동작
         return true;
     switch (message)
     {
@@ -174,6 +204,10 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             }
         }
         break;
+    case WM_SIZE:
+        // 스왑 체인은 다음 프레임 시작에서 한 번만 다시 만듦 (창을 끄는 동안은 Run()이 불리지 않음)
+        application.RequestResize(LOWORD(lParam), HIWORD(lParam));
+        break;
     case WM_PAINT:
         {
             PAINTSTRUCT ps;
@@ -0,0 +1,58 @@
+#include "GuiOverlay.h"
+
+#include <algorithm>
+
+namespace luke {
+    using namespace std;
+
+    void OverlayScheduler::SetMode(OverlayMode mode)
+    {
+        if (mode == m_mode)
+            return;
+        // 숨겨져 있던 동안의 그리기 데이터는 쓸 수 없음
+        if (m_mode == OverlayMode::Hidden || mode == OverlayMode::Hidden)
+            Invalidate();
+        m_mode = mode;
+    }
+
+    void OverlayScheduler::NotifyInput()
+    {
+        m_pendingFrames = max(m_pendingFrames, max(m_settings.settleFrames, 1u));
+    }
+
+    void OverlayScheduler::Invalidate()
+    {
+        m_hasDrawData = false;
+        m_lastStatsMs = -1.0;
+        NotifyInput();
+    }
+
+    OverlayAction OverlayScheduler::BeginFrame(double nowMs)
+    {
+        m_statsRefresh = false;
+        if (m_mode == OverlayMode::Hidden) {
+            m_stats.hiddenFrames++;
+            return OverlayAction::Skip;
+        }
+
+        if (m_mode == OverlayMode::EveryFrame || m_lastStatsMs < 0.0 ||
+            nowMs - m_lastStatsMs >= m_settings.statsIntervalMs) {
+            m_statsRefresh = true;
+            m_lastStatsMs = nowMs;
+            m_stats.statsRefreshes++;
+        }
+
+        const bool rebuild = m_mode == OverlayMode::EveryFrame || !m_hasDrawData || m_statsRefresh ||
+                             m_busy || m_pendingFrames > 0;
+        if (!rebuild) {
+            m_stats.reusedFrames++;
+            return OverlayAction::Reuse;
+        }
+
+        if (m_pendingFrames > 0)
+            m_pendingFrames--;
+        m_hasDrawData = true;
+        m_stats.rebuiltFrames++;
+        return OverlayAction::Rebuild;
+    }
+}
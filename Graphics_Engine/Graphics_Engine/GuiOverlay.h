@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+
+namespace luke {
+
+    enum class OverlayMode : uint8_t {
+        Hidden,     // ImGui를 전혀 호출하지 않음 (입력도 넘기지 않음)
+        Throttled,  // 입력이 있거나 통계를 새로 고칠 때만 다시 만들고, 나머지 프레임은 이전 그리기 데이터를 다시 그림
+        EveryFrame, // 예전처럼 매 프레임 다시 만듦
+    };
+
+    // 이번 프레임에 오버레이를 어떻게 할지
+    enum class OverlayAction : uint8_t {
+        Skip,    // 아무것도 하지 않음
+        Reuse,   // NewFrame() 없이 지난번 ImGui::GetDrawData()만 다시 그림
+        Rebuild, // NewFrame() ~ Render()
+    };
+
+    struct OverlaySettings {
+        float statsIntervalMs = 250.0f; // 통계 패널을 새로 고치는 간격
+        // 입력이 끝난 뒤에도 이만큼은 더 다시 만듦 (호버 해제, 창 이동처럼 한두 프레임 늦게 반영되는 것들)
+        uint32_t settleFrames = 3;
+    };
+
+    struct OverlayStats {
+        uint64_t rebuiltFrames = 0;
+        uint64_t reusedFrames = 0;
+        uint64_t hiddenFrames = 0;
+        uint64_t statsRefreshes = 0;
+        float lastBuildMs = 0.0f; // 마지막으로 다시 만든 프레임의 NewFrame() ~ Render() 시간
+    };
+
+    // 디버그 오버레이(ImGui)를 언제 다시 만들지 정합니다.
+    // ImGui에 의존하지 않으므로 Graphics가 입력 메시지와 시간을 넘겨주고 결과대로 호출합니다.
+    //   NotifyInput()  : 마우스/키보드 메시지가 왔음 (settleFrames 동안 다시 만듦)
+    //   Invalidate()   : 화면 크기처럼 그리기 데이터가 무효가 됨
+    //   SetBusy(true)  : ImGui가 계속 그려야 하는 상태 (드래그 중인 슬라이더, 입력 중인 텍스트)
+    class OverlayScheduler {
+    public:
+        void SetMode(OverlayMode mode);
+        OverlayMode GetMode() const { return m_mode; }
+        bool IsVisible() const { return m_mode != OverlayMode::Hidden; }
+
+        void SetSettings(const OverlaySettings &settings) { m_settings = settings; }
+        const OverlaySettings &GetSettings() const { return m_settings; }
+
+        void NotifyInput();
+        void Invalidate();
+        void SetBusy(bool busy) { m_busy = busy; }
+
+        // 프레임마다 한 번. nowMs는 단조 증가하는 시각
+        OverlayAction BeginFrame(double nowMs);
+        // Rebuild인 프레임에서 통계 패널도 새로 계산해야 하면 true
+        // (입력 때문에 다시 만드는 프레임에서는 이전에 계산한 값을 그대로 보여주면 됨)
+        bool IsStatsRefresh() const { return m_statsRefresh; }
+        void EndBuild(float buildMs) { m_stats.lastBuildMs = buildMs; }
+
+        const OverlayStats &GetStats() const { return m_stats; }
+
+    private:
+        OverlayMode m_mode = OverlayMode::Throttled;
+        OverlaySettings m_settings;
+        OverlayStats m_stats;
+        uint32_t m_pendingFrames = 1; // 처음 프레임은 반드시 만듦
+        double m_lastStatsMs = -1.0;
+        bool m_hasDrawData = false;
+        bool m_statsRefresh = false;
+        bool m_busy = false;
+    };
+}
@@ -0,0 +1,90 @@
+#include "HandleBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "HandlePool.h"
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        // Mesh와 같은 크기의 객체 (ComPtr 3개 + 인덱스 개수)
+        struct MeshSizedObject {
+            void *vertexBuffer = nullptr;
+            void *indexBuffer = nullptr;
+            void *constantBuffer = nullptr;
+            unsigned int indexCount = 0;
+        };
+        struct MeshSizedTag;
+
+        template <typename T_FUNC>
+        double MeasureMs(T_FUNC &&func)
+        {
+            const auto start = chrono::high_resolution_clock::now();
+            func();
+            return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start)
+                .count();
+        }
+    }
+
+    HandleBenchmarkResult RunHandleBenchmark(int count)
+    {
+        HandleBenchmarkResult result;
+        result.count = count;
+
+        // 실제 프로그램처럼 중간중간 다른 할당이 끼어 힙에 흩어지도록 만듦
+        vector<shared_ptr<MeshSizedObject>> sharedObjects;
+        vector<unique_ptr<char[]>> noise;
+        HandlePool<MeshSizedObject, MeshSizedTag> pool;
+        vector<Handle<MeshSizedTag>> handles;
+        sharedObjects.reserve(count);
+        handles.reserve(count);
+
+        mt19937 random(42);
+        for (int i = 0; i < count; i++) {
+            MeshSizedObject object;
+            object.indexCount = unsigned(i % 36);
+            sharedObjects.push_back(make_shared<MeshSizedObject>(object));
+            handles.push_back(pool.Create(object));
+            noise.push_back(make_unique<char[]>(16 + random() % 256));
+        }
+        noise.clear();
+
+        uint64_t checksum = 0;
+
+        result.sharedPtrCopyMs = MeasureMs([&] {
+            for (const auto &object : sharedObjects) {
+                shared_ptr<MeshSizedObject> copy = object;
+                checksum += copy->indexCount;
+            }
+        });
+
+        result.sharedPtrDerefMs = MeasureMs([&] {
+            for (const auto &object : sharedObjects)
+                checksum += object->indexCount;
+        });
+
+        result.handleLookupMs = MeasureMs([&] {
+            for (const auto handle : handles)
+                checksum += pool.Get(handle)->indexCount;
+        });
+
+        result.denseIterateMs = MeasureMs([&] {
+            for (const auto &object : pool.GetDense())
+                checksum += object.indexCount;
+        });
+
+        cout << "Handle benchmark (" << count << " objects, checksum " << checksum << ")" << endl;
+        cout << "  shared_ptr copy " << result.sharedPtrCopyMs << " ms, deref "
+             << result.sharedPtrDerefMs << " ms" << endl;
+        cout << "  handle lookup " << result.handleLookupMs << " ms, dense iterate "
+             << result.denseIterateMs << " ms" << endl;
+
+        return result;
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace luke {
+
+    struct HandleBenchmarkResult {
+        int count = 0;
+        double sharedPtrCopyMs = 0.0;  // shared_ptr를 복사해서 접근 (참조 카운트 증감)
+        double sharedPtrDerefMs = 0.0; // shared_ptr를 참조로 접근 (흩어진 힙 메모리)
+        double handleLookupMs = 0.0;   // 핸들로 HandlePool::Get()
+        double denseIterateMs = 0.0;   // HandlePool::GetDense() 순회
+    };
+
+    // shared_ptr<Mesh>와 세대 핸들의 조회/순회 비용을 비교합니다.
+    HandleBenchmarkResult RunHandleBenchmark(int count);
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Memory.h"
+
+namespace luke {
+
+    // 32비트 세대(generation) 핸들
+    // 하위 20비트: 슬롯 인덱스, 상위 12비트: 세대
+    // 슬롯이 재사용될 때마다 세대가 올라가므로 지워진 리소스를 가리키는 핸들을 구별할 수 있습니다.
+    // value == 0 은 항상 유효하지 않은 핸들입니다. (세대는 1부터 시작)
+    template <typename T_TAG>
+    struct Handle {
+        static constexpr uint32_t kIndexBits = 20;
+        static constexpr uint32_t kIndexMask = (1u << kIndexBits) - 1;
+        static constexpr uint32_t kMaxGeneration = (1u << (32 - kIndexBits)) - 1;
+
+        uint32_t value = 0;
+
+        static Handle Make(uint32_t index, uint32_t generation)
+        {
+            return Handle{(generation << kIndexBits) | index};
+        }
+
+        uint32_t Index() const { return value & kIndexMask; }
+        uint32_t Generation() const { return value >> kIndexBits; }
+        bool IsNull() const { return value == 0; }
+
+        bool operator==(const Handle &other) const { return value == other.value; }
+        bool operator!=(const Handle &other) const { return value != other.value; }
+    };
+
+    // 리소스를 빈틈없는(dense) 배열에 저장하고 핸들로 접근하는 풀
+    // - Get()은 인덱스 두 번으로 끝나고 참조 카운트를 건드리지 않습니다.
+    // - 삭제할 때는 마지막 원소를 빈자리로 옮겨서 배열을 빽빽하게 유지하므로
+    //   GetDense()로 모든 리소스를 순서대로 순회할 수 있습니다.
+    // - Release()는 GPU가 아직 사용 중일 수 있는 리소스를 바로 지우지 않고
+    //   kFramesInFlight 프레임 뒤에 지웁니다. (BeginFrame() 참고)
+    // 주의: Create()/Destroy() 이후에는 Get()으로 받은 포인터가 무효화될 수 있습니다.
+    template <typename T, typename T_TAG>
+    class HandlePool {
+    public:
+        using HandleType = Handle<T_TAG>;
+
+        explicit HandlePool(std::pmr::memory_resource *resource = GetResourceMemory())
+            : m_dense(resource), m_denseToSlot(resource), m_slots(resource), m_freeSlots(resource)
+        {
+        }
+
+        HandleType Create(T resource)
+        {
+            uint32_t slotIndex;
+            if (!m_freeSlots.empty()) {
+                slotIndex = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            }
+            else {
+                slotIndex = uint32_t(m_slots.size());
+                assert(slotIndex <= HandleType::kIndexMask && "HandlePool is full");
+                m_slots.push_back(Slot{0, 1});
+            }
+
+            Slot &slot = m_slots[slotIndex];
+            slot.denseIndex = uint32_t(m_dense.size());
+            m_dense.push_back(std::move(resource));
+            m_denseToSlot.push_back(slotIndex);
+
+            return HandleType::Make(slotIndex, slot.generation);
+        }
+
+        bool IsValid(HandleType handle) const
+        {
+            const uint32_t index = handle.Index();
+            return !handle.IsNull() && index < m_slots.size() &&
+                   m_slots[index].generation == handle.Generation() &&
+                   m_slots[index].denseIndex != kInvalidDense;
+        }
+
+        // 지워진 리소스의 핸들이면 nullptr
+        T *Get(HandleType handle)
+        {
+            return IsValid(handle) ? &m_dense[m_slots[handle.Index()].denseIndex] : nullptr;
+        }
+
+        const T *Get(HandleType handle) const
+        {
+            return IsValid(handle) ? &m_dense[m_slots[handle.Index()].denseIndex] : nullptr;
+        }
+
+        // 즉시 삭제. GPU가 사용 중일 수 있는 리소스는 Release()를 쓰세요.
+        bool Destroy(HandleType handle)
+        {
+            if (!IsValid(handle))
+                return false;
+
+            Slot &slot = m_slots[handle.Index()];
+            const uint32_t denseIndex = slot.denseIndex;
+            const uint32_t lastIndex = uint32_t(m_dense.size() - 1);
+
+            if (denseIndex != lastIndex) {
+                m_dense[denseIndex] = std::move(m_dense[lastIndex]);
+                m_denseToSlot[denseIndex] = m_denseToSlot[lastIndex];
+                m_slots[m_denseToSlot[denseIndex]].denseIndex = denseIndex;
+            }
+            m_dense.pop_back();
+            m_denseToSlot.pop_back();
+
+            // 세대를 올려서 남아있는 핸들을 무효화. 세대가 다 차면 슬롯을 더 이상 쓰지 않습니다.
+            slot.denseIndex = kInvalidDense;
+            if (slot.generation < HandleType::kMaxGeneration) {
+                slot.generation++;
+                m_freeSlots.push_back(handle.Index());
+            }
+            return true;
+        }
+
+        // frameIndex 프레임에서 더 이상 쓰지 않게 된 리소스를 삭제 예약
+        void Release(HandleType handle, uint64_t frameIndex)
+        {
+            if (IsValid(handle))
+                m_pendingReleases.push_back({handle, frameIndex + kFramesInFlight});
+        }
+
+        // frameIndex 프레임을 시작할 때 호출
+        // kFramesInFlight 프레임 전에 예약된 리소스는 GPU가 다 썼으므로 삭제합니다.
+        void BeginFrame(uint64_t frameIndex)
+        {
+            while (!m_pendingReleases.empty() &&
+                   m_pendingReleases.front().retireFrame <= frameIndex) {
+                Destroy(m_pendingReleases.front().handle);
+                m_pendingReleases.pop_front();
+            }
+        }
+
+        std::span<T> GetDense() { return m_dense; }
+        std::span<const T> GetDense() const { return m_dense; }
+        size_t GetCount() const { return m_dense.size(); }
+        size_t GetPendingReleaseCount() const { return m_pendingReleases.size(); }
+
+        // 스왑체인 버퍼 수와 같게 둡니다. (Graphics::InitDirect3D의 BufferCount)
+        static constexpr uint64_t kFramesInFlight = 2;
+
+    private:
+        static constexpr uint32_t kInvalidDense = ~0u;
+
+        struct Slot {
+            uint32_t denseIndex;
+            uint32_t generation;
+        };
+
+        struct PendingRelease {
+            HandleType handle;
+            uint64_t retireFrame;
+        };
+
+        std::pmr::vector<T> m_dense;
+        std::pmr::vector<uint32_t> m_denseToSlot;
+        std::pmr::vector<Slot> m_slots;
+        std::pmr::vector<uint32_t> m_freeSlots;
+        std::deque<PendingRelease> m_pendingReleases;
+    };
+}
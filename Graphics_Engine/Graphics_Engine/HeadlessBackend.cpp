@@ -0,0 +1,461 @@
+#include "HeadlessBackend.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <span>
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        GpuMemoryCategory GetMemoryCategory(GpuBufferType type)
+        {
+            switch (type) {
+            case GpuBufferType::Index:
+                return GpuMemoryCategory::IndexBuffer;
+            case GpuBufferType::Constant:
+                return GpuMemoryCategory::ConstantBuffer;
+            case GpuBufferType::Structured:
+                return GpuMemoryCategory::StructuredBuffer;
+            default:
+                return GpuMemoryCategory::VertexBuffer;
+            }
+        }
+
+        void Accumulate(RenderStats &total, const RenderStats &frame)
+        {
+            total.drawCalls += frame.drawCalls;
+            total.indexCount += frame.indexCount;
+            total.instanceCount += frame.instanceCount;
+            total.bufferBinds += frame.bufferBinds;
+            total.bufferCreates += frame.bufferCreates;
+            total.bufferUpdates += frame.bufferUpdates;
+            total.bytesUploaded += frame.bytesUploaded;
+        }
+    }
+
+    void HeadlessBackend::BeginFrame()
+    {
+        m_frameStats = RenderStats();
+    }
+
+    void HeadlessBackend::EndFrame()
+    {
+        Accumulate(m_totalStats, m_frameStats);
+    }
+
+    GpuBufferHandle HeadlessBackend::CreateBuffer(GpuBufferType type, const void *data, size_t size,
+                                                  bool dynamic)
+    {
+        Buffer buffer;
+        if (m_memoryTracker) {
+            buffer.allocation = m_memoryTracker->Allocate(GetMemoryCategory(type), size);
+            if (buffer.allocation == kInvalidGpuAllocation)
+                return {};
+        }
+        buffer.type = type;
+        buffer.dynamic = dynamic;
+        buffer.data.resize(size);
+        if (data) {
+            memcpy(buffer.data.data(), data, size);
+            m_frameStats.bytesUploaded += size;
+        }
+
+        m_frameStats.bufferCreates++;
+        m_bufferBytes += size;
+        return m_buffers.Create(std::move(buffer));
+    }
+
+    void HeadlessBackend::UpdateBuffer(GpuBufferHandle handle, const void *data, size_t size)
+    {
+        Buffer *buffer = m_buffers.Get(handle);
+        if (!buffer || !buffer->dynamic || size > buffer->data.size()) {
+            ReportError("UpdateBuffer() on an invalid, immutable or too small buffer.");
+            return;
+        }
+
+        memcpy(buffer->data.data(), data, size);
+        m_frameStats.bufferUpdates++;
+        m_frameStats.bytesUploaded += size;
+    }
+
+    void HeadlessBackend::UpdateBufferRange(GpuBufferHandle handle, size_t offset, const void *data, size_t size)
+    {
+        Buffer *buffer = m_buffers.Get(handle);
+        if (!buffer || buffer->dynamic || offset > buffer->data.size() || size > buffer->data.size() - offset) {
+            ReportError("UpdateBufferRange() on an invalid or dynamic buffer, or outside of the buffer.");
+            return;
+        }
+
+        memcpy(buffer->data.data() + offset, data, size);
+        m_frameStats.bufferUpdates++;
+        m_frameStats.bytesUploaded += size;
+    }
+
+    void *HeadlessBackend::MapBuffer(GpuBufferHandle handle)
+    {
+        Buffer *buffer = m_buffers.Get(handle);
+        if (!buffer || !buffer->dynamic || !m_mappedBuffer.IsNull()) {
+            ReportError("MapBuffer() on an invalid or immutable buffer, or while another buffer is mapped.");
+            return nullptr;
+        }
+        m_mappedBuffer = handle;
+        return buffer->data.data();
+    }
+
+    void HeadlessBackend::UnmapBuffer(GpuBufferHandle handle, size_t writtenBytes)
+    {
+        const Buffer *buffer = m_buffers.Get(handle);
+        if (!buffer || m_mappedBuffer != handle || writtenBytes > buffer->data.size()) {
+            ReportError("UnmapBuffer() without a matching MapBuffer() or with too many bytes.");
+            return;
+        }
+        m_mappedBuffer = {};
+        m_frameStats.bufferUpdates++;
+        m_frameStats.bytesUploaded += writtenBytes;
+    }
+
+    void HeadlessBackend::DestroyBuffer(GpuBufferHandle handle)
+    {
+        const Buffer *buffer = m_buffers.Get(handle);
+        if (!buffer) {
+            ReportError("DestroyBuffer() on an invalid buffer.");
+            return;
+        }
+
+        m_bufferBytes -= buffer->data.size();
+        if (m_memoryTracker)
+            m_memoryTracker->Free(buffer->allocation);
+        m_buffers.Destroy(handle);
+    }
+
+    void HeadlessBackend::SetVertexBuffer(GpuBufferHandle buffer, uint32_t stride)
+    {
+        m_vertexBuffer = buffer;
+        m_vertexStride = stride;
+        m_frameStats.bufferBinds++;
+    }
+
+    void HeadlessBackend::SetIndexBuffer(GpuBufferHandle buffer)
+    {
+        m_indexBuffer = buffer;
+        m_frameStats.bufferBinds++;
+    }
+
+    void HeadlessBackend::SetInstanceBuffer(GpuBufferHandle buffer, uint32_t stride, size_t offset)
+    {
+        m_instanceBuffer = buffer;
+        m_instanceStride = stride;
+        m_instanceOffset = offset;
+        m_frameStats.bufferBinds++;
+    }
+
+    void HeadlessBackend::SetConstantBuffer(uint32_t slot, GpuBufferHandle buffer)
+    {
+        if (slot >= kConstantSlots) {
+            ReportError("SetConstantBuffer() slot out of range.");
+            return;
+        }
+        m_constantBuffers[slot] = buffer;
+        m_constantOffsets[slot] = 0;
+        m_constantSizes[slot] = 0;
+        m_frameStats.bufferBinds++;
+    }
+
+    void HeadlessBackend::SetConstantBufferRange(uint32_t slot, GpuBufferHandle buffer, size_t offset, size_t size)
+    {
+        const Buffer *constants = m_buffers.Get(buffer);
+        if (slot >= kConstantSlots || !constants || offset % kConstantBufferAlignment != 0 || size == 0 ||
+            size % kConstantBufferAlignment != 0 || offset > constants->data.size() ||
+            size > constants->data.size() - offset) {
+            ReportError("SetConstantBufferRange() with an invalid slot or buffer, or an unaligned range.");
+            return;
+        }
+        m_constantBuffers[slot] = buffer;
+        m_constantOffsets[slot] = offset;
+        m_constantSizes[slot] = size;
+        m_frameStats.bufferBinds++;
+    }
+
+    void HeadlessBackend::SetShaderBuffer(uint32_t slot, GpuBufferHandle buffer)
+    {
+        if (slot >= kShaderBufferSlots) {
+            ReportError("SetShaderBuffer() slot out of range.");
+            return;
+        }
+        m_shaderBuffers[slot] = buffer;
+        m_frameStats.bufferBinds++;
+    }
+
+    void HeadlessBackend::DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex)
+    {
+        // 실제 GPU였다면 디바이스가 제거되거나 아무것도 그려지지 않았을 경우를 잡아냄
+        const Buffer *vertexBuffer = m_buffers.Get(m_vertexBuffer);
+        const Buffer *indexBuffer = m_buffers.Get(m_indexBuffer);
+        if (!vertexBuffer || !indexBuffer || m_vertexStride == 0) {
+            ReportError("DrawIndexed() without valid vertex/index buffers.");
+            return;
+        }
+        if ((size_t(startIndex) + indexCount) * sizeof(uint16_t) > indexBuffer->data.size() ||
+            baseVertex < 0 || size_t(baseVertex) * m_vertexStride > vertexBuffer->data.size()) {
+            ReportError("DrawIndexed() range is outside of the bound buffers.");
+            return;
+        }
+
+        m_frameStats.drawCalls++;
+        m_frameStats.indexCount += indexCount;
+
+        if (RenderTarget *target = m_renderTargets.Get(m_renderTarget))
+            Rasterize(*target, *vertexBuffer, *indexBuffer, indexCount, startIndex, baseVertex);
+    }
+
+    void HeadlessBackend::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex)
+    {
+        const Buffer *vertexBuffer = m_buffers.Get(m_vertexBuffer);
+        const Buffer *indexBuffer = m_buffers.Get(m_indexBuffer);
+        const Buffer *instanceBuffer = m_buffers.Get(m_instanceBuffer);
+        if (!vertexBuffer || !indexBuffer || !instanceBuffer || m_vertexStride == 0 || m_instanceStride == 0) {
+            ReportError("DrawIndexedInstanced() without valid vertex/index/instance buffers.");
+            return;
+        }
+        if ((size_t(startIndex) + indexCount) * sizeof(uint16_t) > indexBuffer->data.size() ||
+            m_instanceOffset + size_t(instanceCount) * m_instanceStride > instanceBuffer->data.size()) {
+            ReportError("DrawIndexedInstanced() range is outside of the bound buffers.");
+            return;
+        }
+
+        m_frameStats.drawCalls++;
+        m_frameStats.indexCount += uint64_t(indexCount) * instanceCount;
+        m_frameStats.instanceCount += instanceCount;
+    }
+
+    RenderTargetHandle HeadlessBackend::CreateRenderTarget(uint32_t width, uint32_t height)
+    {
+        if (width == 0 || height == 0) {
+            ReportError("CreateRenderTarget() with an empty size.");
+            return {};
+        }
+
+        RenderTarget target;
+        if (m_memoryTracker) {
+            const uint64_t bytes = uint64_t(width) * height * 4;
+            target.colorAllocation = m_memoryTracker->Allocate(GpuMemoryCategory::RenderTarget, bytes);
+            if (target.colorAllocation != kInvalidGpuAllocation)
+                target.depthAllocation = m_memoryTracker->Allocate(GpuMemoryCategory::DepthStencil, bytes);
+            if (target.depthAllocation == kInvalidGpuAllocation) {
+                FreeAllocations(target);
+                return {};
+            }
+        }
+        target.surface.Resize(width, height);
+        return m_renderTargets.Create(std::move(target));
+    }
+
+    void HeadlessBackend::DestroyRenderTarget(RenderTargetHandle handle)
+    {
+        const RenderTarget *target = m_renderTargets.Get(handle);
+        if (!target) {
+            ReportError("DestroyRenderTarget() on an invalid render target.");
+            return;
+        }
+        if (m_renderTarget == handle)
+            m_renderTarget = {};
+        FreeAllocations(*target);
+        m_renderTargets.Destroy(handle);
+    }
+
+    void HeadlessBackend::SetRenderTarget(RenderTargetHandle handle, const float clearColor[4])
+    {
+        m_renderTarget = handle;
+        if (handle.IsNull())
+            return;
+
+        RenderTarget *target = m_renderTargets.Get(handle);
+        if (!target) {
+            ReportError("SetRenderTarget() on an invalid render target.");
+            m_renderTarget = {};
+            return;
+        }
+        target->surface.Clear(clearColor);
+    }
+
+    void HeadlessBackend::CopyToStaging(RenderTargetHandle handle)
+    {
+        RenderTarget *target = m_renderTargets.Get(handle);
+        if (!target) {
+            ReportError("CopyToStaging() on an invalid render target.");
+            return;
+        }
+
+        const vector<uint32_t> &color = target->surface.color;
+        if (m_memoryTracker && target->stagingAllocation == kInvalidGpuAllocation) {
+            target->stagingAllocation =
+                m_memoryTracker->Allocate(GpuMemoryCategory::Staging, color.size() * sizeof(uint32_t));
+            if (target->stagingAllocation == kInvalidGpuAllocation)
+                return; // TryReadStaging()이 false
+        }
+        target->staging.resize(color.size() * sizeof(uint32_t));
+        memcpy(target->staging.data(), color.data(), target->staging.size());
+        target->stagingReady = true;
+    }
+
+    bool HeadlessBackend::TryReadStaging(RenderTargetHandle handle, vector<uint8_t> &rgba)
+    {
+        RenderTarget *target = m_renderTargets.Get(handle);
+        if (!target || !target->stagingReady)
+            return false;
+
+        rgba.resize(target->staging.size());
+        memcpy(rgba.data(), target->staging.data(), rgba.size());
+        target->stagingReady = false;
+        return true;
+    }
+
+    bool HeadlessBackend::ReadBuffer(GpuBufferHandle handle, vector<uint8_t> &data) const
+    {
+        const Buffer *buffer = m_buffers.Get(handle);
+        if (!buffer)
+            return false;
+        data = buffer->data;
+        return true;
+    }
+
+    HeadlessPipelineHandle HeadlessBackend::CreatePipeline(vector<uint8_t> vertexShader, vector<uint8_t> pixelShader)
+    {
+        Pipeline pipeline;
+        pipeline.vertexShader = std::move(vertexShader);
+        pipeline.pixelShader = std::move(pixelShader);
+        return m_pipelines.Create(std::move(pipeline));
+    }
+
+    bool HeadlessBackend::ReplacePipeline(HeadlessPipelineHandle handle, vector<uint8_t> vertexShader,
+                                          vector<uint8_t> pixelShader)
+    {
+        Pipeline *pipeline = m_pipelines.Get(handle);
+        if (!pipeline) {
+            ReportError("ReplacePipeline() on an invalid pipeline.");
+            return false;
+        }
+
+        pipeline->vertexShader = std::move(vertexShader);
+        pipeline->pixelShader = std::move(pixelShader);
+        pipeline->version++;
+        return true;
+    }
+
+    void HeadlessBackend::DestroyPipeline(HeadlessPipelineHandle handle)
+    {
+        if (!m_pipelines.Destroy(handle))
+            ReportError("DestroyPipeline() on an invalid pipeline.");
+    }
+
+    void HeadlessBackend::BeginTimestampFrame(uint32_t frameSlot)
+    {
+        m_timestampFrames[frameSlot % Profiler::kLatency].ended = false;
+    }
+
+    void HeadlessBackend::EndTimestampFrame(uint32_t frameSlot)
+    {
+        m_timestampFrames[frameSlot % Profiler::kLatency].ended = true;
+    }
+
+    void HeadlessBackend::WriteTimestamp(uint32_t frameSlot, uint32_t index)
+    {
+        if (index >= Profiler::kMaxTimestamps) {
+            ReportError("WriteTimestamp() index out of range.");
+            return;
+        }
+        // 드로우를 기록 즉시 실행하므로 지금이 곧 "GPU"가 이 지점에 도달한 시각
+        const auto now = chrono::steady_clock::now().time_since_epoch();
+        m_timestampFrames[frameSlot % Profiler::kLatency].ticks[index] =
+            uint64_t(chrono::duration_cast<chrono::nanoseconds>(now).count());
+    }
+
+    bool HeadlessBackend::TryReadTimestamps(uint32_t frameSlot, uint32_t count, uint64_t *ticks,
+                                            uint64_t &frequency)
+    {
+        const TimestampFrame &frame = m_timestampFrames[frameSlot % Profiler::kLatency];
+        if (!frame.ended || count > Profiler::kMaxTimestamps)
+            return false;
+
+        memcpy(ticks, frame.ticks, count * sizeof(uint64_t));
+        frequency = 1000000000; // 나노초
+        return true;
+    }
+
+    void HeadlessBackend::Rasterize(RenderTarget &target, const Buffer &vertexBuffer,
+                                    const Buffer &indexBuffer, uint32_t indexCount,
+                                    uint32_t startIndex, int32_t baseVertex)
+    {
+        // ColorVertexShader의 b0(FrameConstants)과 b2(ObjectConstants). 행렬은 전치된 상태로 올라옴
+        const uint8_t *frameData = GetConstants(kFrameConstantSlot, sizeof(FrameConstants));
+        const uint8_t *objectData = GetConstants(kObjectConstantSlot, sizeof(ObjectConstants));
+        if (!frameData || !objectData || m_vertexStride != sizeof(Vertex)) {
+            ReportError("Rasterization needs Vertex buffers, FrameConstants in slot 0 and ObjectConstants in slot 2.");
+            return;
+        }
+
+        FrameConstants frame;
+        ObjectConstants object;
+        memcpy(&frame, frameData, sizeof(frame));
+        memcpy(&object, objectData, sizeof(object));
+        const Matrix world = object.model.Transpose();
+        const Matrix worldViewProjection = world * frame.viewProjection.Transpose();
+
+        const span<const Vertex> vertices(reinterpret_cast<const Vertex *>(vertexBuffer.data.data()),
+                                          vertexBuffer.data.size() / sizeof(Vertex));
+        const span<const uint16_t> indices(
+            reinterpret_cast<const uint16_t *>(indexBuffer.data.data()) + startIndex, indexCount);
+
+        // ColorPixelShader(CLUSTERED_LIGHTING)의 b1, t0, t1, t2
+        const Buffer *clusterConstants = m_buffers.Get(m_constantBuffers[1]);
+        const Buffer *lights = m_buffers.Get(m_shaderBuffers[0]);
+        const Buffer *clusters = m_buffers.Get(m_shaderBuffers[1]);
+        const Buffer *lightIndices = m_buffers.Get(m_shaderBuffers[2]);
+        if (clusterConstants && lights && clusters && lightIndices &&
+            clusterConstants->data.size() >= sizeof(ClusterConstants)) {
+            ClusteredLightData data;
+            memcpy(&data.constants, clusterConstants->data.data(), sizeof(ClusterConstants));
+            data.lights = span(reinterpret_cast<const Light *>(lights->data.data()),
+                               min<size_t>(data.constants.lightCount, lights->data.size() / sizeof(Light)));
+            data.clusters = span(reinterpret_cast<const LightCluster *>(clusters->data.data()),
+                                 clusters->data.size() / sizeof(LightCluster));
+            data.lightIndices = span(reinterpret_cast<const uint32_t *>(lightIndices->data.data()),
+                                     lightIndices->data.size() / sizeof(uint32_t));
+            DrawLitTriangles(target.surface, vertices, indices, baseVertex, world, object.normalMatrix.Transpose(),
+                             frame.view.Transpose(), frame.projection.Transpose(), data);
+            return;
+        }
+        DrawColorTriangles(target.surface, vertices, indices, baseVertex, worldViewProjection);
+    }
+
+    const uint8_t *HeadlessBackend::GetConstants(uint32_t slot, size_t size) const
+    {
+        const Buffer *constants = m_buffers.Get(m_constantBuffers[slot]);
+        if (!constants || m_constantOffsets[slot] > constants->data.size())
+            return nullptr;
+        const size_t available = m_constantSizes[slot] > 0 ? m_constantSizes[slot]
+                                                           : constants->data.size() - m_constantOffsets[slot];
+        if (available < size || m_constantOffsets[slot] + available > constants->data.size())
+            return nullptr;
+        return constants->data.data() + m_constantOffsets[slot];
+    }
+
+    void HeadlessBackend::FreeAllocations(const RenderTarget &target)
+    {
+        if (!m_memoryTracker)
+            return;
+        m_memoryTracker->Free(target.colorAllocation);
+        m_memoryTracker->Free(target.depthAllocation);
+        m_memoryTracker->Free(target.stagingAllocation);
+    }
+
+    void HeadlessBackend::ReportError(const char *message)
+    {
+        // 같은 실수가 매 프레임 반복되면 출력이 넘치므로 처음 몇 번만 출력
+        if (m_errorCount++ < 8)
+            cout << "HeadlessBackend: " << message << endl;
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "HandlePool.h"
+#include "Profiler.h"
+#include "RenderBackend.h"
+#include "ShaderConstants.h"
+#include "SoftwareRasterizer.h"
+
+namespace luke {
+
+    struct HeadlessPipelineTag;
+    using HeadlessPipelineHandle = Handle<HeadlessPipelineTag>;
+
+    // GPU 없이 명령을 받아서 개수만 세는 백엔드
+    // 버퍼 내용은 CPU 메모리에 그대로 보관하므로 나중에 내용을 확인할 수 있습니다.
+    // 벤치마크처럼 창과 디바이스가 없는 환경(리눅스, CI)에서 장면 코드를 돌릴 때 사용합니다.
+    // 렌더 타겟이 바인딩돼 있으면 드로우를 SoftwareRasterizer로 실제로 그립니다.
+    // 이때 버텍스는 Vertex, 상수 버퍼 슬롯 0은 FrameConstants, 슬롯 2는 ObjectConstants 배치여야 합니다.
+    // 슬롯 1에 ClusterConstants, 쉐이더 버퍼 t0/t1/t2에 빛/클러스터/빛 번호가 있으면 클러스터 조명으로 그립니다.
+    // 드로우는 호출 즉시 실행되므로 CopyToStaging() 직후의 TryReadStaging()은 항상 성공합니다.
+    // GPU 타임스탬프도 같은 이유로 기록하는 순간의 CPU 시각이며, EndTimestampFrame() 뒤에 읽을 수 있습니다.
+    // 파이프라인은 쉐이더 바이트코드만 보관합니다. (HeadlessPipelineCache가 만들고 핫 리로드 때 교체)
+    // SetMemoryTracker()로 기록할 때 렌더 타겟은 색상과 깊이(각각 텍셀당 4바이트), 스테이징은 처음 복사할 때 기록합니다.
+    class HeadlessBackend : public RenderBackend, public GpuTimestamps {
+    public:
+        struct Buffer {
+            GpuBufferType type = GpuBufferType::Vertex;
+            bool dynamic = false;
+            std::vector<uint8_t> data;
+            GpuAllocationId allocation = kInvalidGpuAllocation;
+        };
+
+        // D3D11의 PipelineState에 해당. 래스터라이저는 쉐이더를 실행하지 않으므로 내용은 확인용
+        struct Pipeline {
+            std::vector<uint8_t> vertexShader;
+            std::vector<uint8_t> pixelShader;
+            uint32_t version = 0; // ReplacePipeline()마다 1씩 올라감
+        };
+
+        void BeginFrame() override;
+        void EndFrame() override;
+
+        GpuBufferHandle CreateBuffer(GpuBufferType type, const void *data, size_t size,
+                                     bool dynamic) override;
+        void UpdateBuffer(GpuBufferHandle buffer, const void *data, size_t size) override;
+        void UpdateBufferRange(GpuBufferHandle buffer, size_t offset, const void *data, size_t size) override;
+        void DestroyBuffer(GpuBufferHandle buffer) override;
+        void *MapBuffer(GpuBufferHandle buffer) override;
+        void UnmapBuffer(GpuBufferHandle buffer, size_t writtenBytes) override;
+
+        void SetVertexBuffer(GpuBufferHandle buffer, uint32_t stride) override;
+        void SetIndexBuffer(GpuBufferHandle buffer) override;
+        void SetInstanceBuffer(GpuBufferHandle buffer, uint32_t stride, size_t offset = 0) override;
+        void SetConstantBuffer(uint32_t slot, GpuBufferHandle buffer) override;
+        void SetConstantBufferRange(uint32_t slot, GpuBufferHandle buffer, size_t offset, size_t size) override;
+        void SetShaderBuffer(uint32_t slot, GpuBufferHandle buffer) override;
+        void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) override;
+        // 소프트웨어 래스터라이저는 Vertex 드로우만 그리므로 인스턴스 드로우는 검사하고 세기만 함
+        void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex) override;
+
+        RenderTargetHandle CreateRenderTarget(uint32_t width, uint32_t height) override;
+        void DestroyRenderTarget(RenderTargetHandle target) override;
+        void SetRenderTarget(RenderTargetHandle target, const float clearColor[4]) override;
+        void CopyToStaging(RenderTargetHandle target) override;
+        bool TryReadStaging(RenderTargetHandle target, std::vector<uint8_t> &rgba) override;
+        bool ReadBuffer(GpuBufferHandle buffer, std::vector<uint8_t> &data) const override;
+
+        HeadlessPipelineHandle CreatePipeline(std::vector<uint8_t> vertexShader, std::vector<uint8_t> pixelShader);
+        // 핸들은 그대로 두고 쉐이더를 통째로 바꿈 (이미 받은 핸들로 새 쉐이더를 쓰게 됨)
+        bool ReplacePipeline(HeadlessPipelineHandle pipeline, std::vector<uint8_t> vertexShader,
+                             std::vector<uint8_t> pixelShader);
+        void DestroyPipeline(HeadlessPipelineHandle pipeline);
+
+        void BeginTimestampFrame(uint32_t frameSlot) override;
+        void EndTimestampFrame(uint32_t frameSlot) override;
+        void WriteTimestamp(uint32_t frameSlot, uint32_t index) override;
+        bool TryReadTimestamps(uint32_t frameSlot, uint32_t count, uint64_t *ticks,
+                               uint64_t &frequency) override;
+
+        const Buffer *GetBuffer(GpuBufferHandle buffer) const { return m_buffers.Get(buffer); }
+        size_t GetBufferCount() const { return m_buffers.GetCount(); }
+        size_t GetBufferBytes() const { return m_bufferBytes; }
+        const Pipeline *GetPipeline(HeadlessPipelineHandle pipeline) const { return m_pipelines.Get(pipeline); }
+        uint64_t GetErrorCount() const override { return m_errorCount; }
+
+    private:
+        static constexpr uint32_t kConstantSlots = 14; // D3D11 상수 버퍼 슬롯 수
+        static constexpr uint32_t kShaderBufferSlots = 8;
+
+        struct RenderTarget {
+            SoftwareRenderTarget surface;
+            std::vector<uint8_t> staging;
+            bool stagingReady = false;
+            GpuAllocationId colorAllocation = kInvalidGpuAllocation;
+            GpuAllocationId depthAllocation = kInvalidGpuAllocation;
+            GpuAllocationId stagingAllocation = kInvalidGpuAllocation;
+        };
+
+        // 슬롯에 바인딩된 범위가 size바이트 이상이면 그 시작
+        const uint8_t *GetConstants(uint32_t slot, size_t size) const;
+        void ReportError(const char *message);
+        void FreeAllocations(const RenderTarget &target);
+        void Rasterize(RenderTarget &target, const Buffer &vertexBuffer, const Buffer &indexBuffer,
+                       uint32_t indexCount, uint32_t startIndex, int32_t baseVertex);
+
+        HandlePool<Buffer, GpuBufferTag> m_buffers;
+        size_t m_bufferBytes = 0;
+        uint64_t m_errorCount = 0;
+
+        GpuBufferHandle m_vertexBuffer;
+        uint32_t m_vertexStride = 0;
+        GpuBufferHandle m_indexBuffer;
+        GpuBufferHandle m_instanceBuffer;
+        uint32_t m_instanceStride = 0;
+        size_t m_instanceOffset = 0;
+        GpuBufferHandle m_mappedBuffer; // MapBuffer() ~ UnmapBuffer()
+        GpuBufferHandle m_constantBuffers[kConstantSlots];
+        size_t m_constantOffsets[kConstantSlots] = {};
+        size_t m_constantSizes[kConstantSlots] = {}; // 0이면 버퍼 전체 (SetConstantBuffer())
+        GpuBufferHandle m_shaderBuffers[kShaderBufferSlots];
+
+        HandlePool<RenderTarget, RenderTargetTag> m_renderTargets;
+        RenderTargetHandle m_renderTarget;
+
+        HandlePool<Pipeline, HeadlessPipelineTag> m_pipelines;
+
+        struct TimestampFrame {
+            uint64_t ticks[Profiler::kMaxTimestamps] = {};
+            bool ended = false;
+        };
+        TimestampFrame m_timestampFrames[Profiler::kLatency];
+    };
+}
@@ -0,0 +1,77 @@
+#include "HeadlessPipelineCache.h"
+
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    void HeadlessPipelineCache::Initialize(HeadlessBackend *backend, ShaderCompiler compiler,
+                                           ShaderHotReloader *reloader)
+    {
+        m_backend = backend;
+        m_compiler = std::move(compiler);
+        m_reloader = reloader;
+    }
+
+    const vector<uint8_t> *HeadlessPipelineCache::GetBytecode(const filesystem::path &file, const string &profile,
+                                                              const ShaderDefines &defines)
+    {
+        const string key = MakeShaderKey(file, profile, defines);
+        auto it = m_bytecode.find(key);
+        if (it != m_bytecode.end())
+            return &it->second;
+
+        vector<uint8_t> bytecode;
+        string errors;
+        if (!m_compiler(file, profile, defines, bytecode, errors)) {
+            cout << "Shader compile error\n" << errors << endl;
+            return nullptr;
+        }
+        return &m_bytecode.emplace(key, std::move(bytecode)).first->second;
+    }
+
+    HeadlessPipelineHandle HeadlessPipelineCache::GetOrCreate(const filesystem::path &vertexShaderFile,
+                                                              const filesystem::path &pixelShaderFile,
+                                                              const ShaderDefines &defines)
+    {
+        Entry entry;
+        entry.vertexShaderKey = MakeShaderKey(vertexShaderFile, "vs_5_0", defines);
+        entry.pixelShaderKey = MakeShaderKey(pixelShaderFile, "ps_5_0", defines);
+        for (const Entry &existing : m_entries) {
+            if (existing.vertexShaderKey == entry.vertexShaderKey && existing.pixelShaderKey == entry.pixelShaderKey)
+                return existing.handle;
+        }
+
+        const vector<uint8_t> *vertexShader = GetBytecode(vertexShaderFile, "vs_5_0", defines);
+        const vector<uint8_t> *pixelShader = GetBytecode(pixelShaderFile, "ps_5_0", defines);
+        if (!vertexShader || !pixelShader)
+            return {};
+
+        entry.handle = m_backend->CreatePipeline(*vertexShader, *pixelShader);
+        if (m_reloader) {
+            m_reloader->Watch(vertexShaderFile, "vs_5_0", defines);
+            m_reloader->Watch(pixelShaderFile, "ps_5_0", defines);
+        }
+        m_entries.push_back(std::move(entry));
+        return m_entries.back().handle;
+    }
+
+    bool HeadlessPipelineCache::ApplyReloadedShader(const CompiledShader &shader)
+    {
+        const string key = MakeShaderKey(shader.path, shader.profile, shader.defines);
+        auto it = m_bytecode.find(key);
+        if (it == m_bytecode.end())
+            return false; // 이 캐시가 쓰지 않는 쉐이더
+        it->second = shader.bytecode;
+
+        // 핸들은 그대로 두고 내용만 교체하므로 이미 받은 핸들로 그리는 곳도 새 쉐이더를 씀
+        bool applied = false;
+        for (const Entry &entry : m_entries) {
+            if (entry.vertexShaderKey != key && entry.pixelShaderKey != key)
+                continue;
+            applied |= m_backend->ReplacePipeline(entry.handle, m_bytecode[entry.vertexShaderKey],
+                                                  m_bytecode[entry.pixelShaderKey]);
+        }
+        return applied;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "HeadlessBackend.h"
+#include "ShaderHotReloader.h"
+
+namespace luke {
+
+    // HeadlessBackend용 파이프라인 캐시 (D3D11의 PipelineStateCache와 같은 역할)
+    // 쉐이더를 ShaderCompiler로 컴파일해서 (파일, 프로파일, defines) 단위로 캐시하고,
+    // ShaderHotReloader가 다시 컴파일한 쉐이더를 쓰는 파이프라인을 ApplyReloadedShader()에서 교체합니다.
+    // D3DCompile 대신 대체 컴파일러를 넘길 수 있으므로 리눅스에서도 리로드 교체를 돌려볼 수 있습니다.
+    class HeadlessPipelineCache {
+    public:
+        // reloader가 있으면 만든 파이프라인의 쉐이더 파일을 감시하게 함
+        void Initialize(HeadlessBackend *backend, ShaderCompiler compiler, ShaderHotReloader *reloader);
+
+        // 컴파일에 실패하면 빈 핸들
+        HeadlessPipelineHandle GetOrCreate(const std::filesystem::path &vertexShaderFile,
+                                           const std::filesystem::path &pixelShaderFile,
+                                           const ShaderDefines &defines = {});
+
+        // 프레임 경계에서 ShaderHotReloader::ApplyPending()의 apply로 넘기세요.
+        // 이 쉐이더를 쓰는 파이프라인이 하나라도 바뀌면 true
+        bool ApplyReloadedShader(const CompiledShader &shader);
+
+        size_t GetPipelineCount() const { return m_entries.size(); }
+
+    private:
+        struct Entry {
+            std::string vertexShaderKey;
+            std::string pixelShaderKey;
+            HeadlessPipelineHandle handle;
+        };
+
+        const std::vector<uint8_t> *GetBytecode(const std::filesystem::path &file, const std::string &profile,
+                                                const ShaderDefines &defines);
+
+        HeadlessBackend *m_backend = nullptr;
+        ShaderCompiler m_compiler;
+        ShaderHotReloader *m_reloader = nullptr;
+
+        std::vector<Entry> m_entries;
+        std::map<std::string, std::vector<uint8_t>> m_bytecode; // 쉐이더 키 -> 바이트코드
+    };
+}
@@ -0,0 +1,575 @@
+#include "ImageEncoder.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+// PNG 필터는 바이트 단위 정수 연산이라 DirectXMath(float)로는 할 수 없으므로 SSE2를 직접 사용
+// x64에서는 항상 사용할 수 있고, 그 밖의 환경에서는 같은 계산을 하는 스칼라 코드를 사용합니다.
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define GRAPHICS_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define GRAPHICS_USE_SSE2 0
+#endif
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        uint8_t *PutBigEndian(uint8_t *p, uint32_t value)
+        {
+            p[0] = uint8_t(value >> 24);
+            p[1] = uint8_t(value >> 16);
+            p[2] = uint8_t(value >> 8);
+            p[3] = uint8_t(value);
+            return p + 4;
+        }
+
+        uint32_t Load32(const uint8_t *p)
+        {
+            uint32_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+#pragma region CRC-32, Adler-32
+        const array<uint32_t, 256> &GetCrcTable()
+        {
+            static const array<uint32_t, 256> table = [] {
+                array<uint32_t, 256> result{};
+                for (uint32_t n = 0; n < 256; n++) {
+                    uint32_t c = n;
+                    for (int k = 0; k < 8; k++)
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    result[n] = c;
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        uint32_t Crc32(const uint8_t *data, size_t size)
+        {
+            const array<uint32_t, 256> &table = GetCrcTable();
+            uint32_t crc = 0xFFFFFFFFu;
+            for (size_t i = 0; i < size; i++)
+                crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            return crc ^ 0xFFFFFFFFu;
+        }
+
+        uint32_t Adler32(const uint8_t *data, size_t size)
+        {
+            // 5552바이트까지는 32비트에서 넘치지 않으므로 나머지 연산을 모아서 함
+            uint32_t a = 1, b = 0;
+            while (size > 0) {
+                size_t count = min<size_t>(size, 5552);
+                size -= count;
+                while (count--) {
+                    a += *data++;
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+            }
+            return (b << 16) | a;
+        }
+#pragma endregion
+
+#pragma region Deflate (고정 허프만)
+        constexpr uint16_t kLengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                              31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        constexpr uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                              2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        constexpr uint16_t kDistanceBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,
+                                                33,  49,  65,  97,  129, 193,  257,  385,  513,  769,
+                                                1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        constexpr uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+        // RFC 1951 3.2.6의 고정 부호. 허프만 부호는 MSB부터 쓰므로 미리 비트를 뒤집어 둠
+        struct FixedHuffman {
+            uint16_t literalCode[288];
+            uint8_t literalBits[288];
+            uint16_t distanceCode[30];
+            uint8_t lengthSymbol[259];   // 길이 3 ~ 258 -> 0 ~ 28
+            uint8_t distanceSymbol[512]; // zlib과 같은 방식: d < 256 ? [d] : [256 + (d >> 7)], d = 거리 - 1
+
+            FixedHuffman()
+            {
+                auto reverse = [](uint32_t code, uint32_t bits) {
+                    uint32_t result = 0;
+                    for (uint32_t i = 0; i < bits; i++)
+                        result |= ((code >> i) & 1) << (bits - 1 - i);
+                    return uint16_t(result);
+                };
+                for (uint32_t i = 0; i < 288; i++) {
+                    uint32_t code, bits;
+                    if (i < 144)
+                        code = 0x30 + i, bits = 8;
+                    else if (i < 256)
+                        code = 0x190 + (i - 144), bits = 9;
+                    else if (i < 280)
+                        code = i - 256, bits = 7;
+                    else
+                        code = 0xC0 + (i - 280), bits = 8;
+                    literalCode[i] = reverse(code, bits);
+                    literalBits[i] = uint8_t(bits);
+                }
+                for (uint32_t i = 0; i < 30; i++)
+                    distanceCode[i] = reverse(i, 5);
+
+                for (uint32_t s = 0; s < 29; s++)
+                    for (uint32_t length = kLengthBase[s];
+                         length < kLengthBase[s] + (1u << kLengthExtra[s]) && length <= 258; length++)
+                        lengthSymbol[length] = uint8_t(s);
+
+                for (uint32_t s = 0; s < 30; s++) {
+                    for (uint32_t d = kDistanceBase[s] - 1u; d < kDistanceBase[s] - 1u + (1u << kDistanceExtra[s]);
+                         d++) {
+                        if (d < 256)
+                            distanceSymbol[d] = uint8_t(s);
+                        else
+                            distanceSymbol[256 + (d >> 7)] = uint8_t(s);
+                    }
+                }
+            }
+        };
+
+        const FixedHuffman &GetFixedHuffman()
+        {
+            static const FixedHuffman table;
+            return table;
+        }
+
+        // LSB부터 채우는 비트 출력. 32비트가 모이면 한 번에 씀
+        struct BitWriter {
+            uint8_t *p;
+            uint64_t bits = 0;
+            uint32_t count = 0;
+
+            void Put(uint32_t value, uint32_t bitCount)
+            {
+                bits |= uint64_t(value) << count;
+                count += bitCount;
+                if (count >= 32) {
+                    p[0] = uint8_t(bits);
+                    p[1] = uint8_t(bits >> 8);
+                    p[2] = uint8_t(bits >> 16);
+                    p[3] = uint8_t(bits >> 24);
+                    p += 4;
+                    bits >>= 32;
+                    count -= 32;
+                }
+            }
+
+            void Flush()
+            {
+                while (count > 0) {
+                    *p++ = uint8_t(bits);
+                    bits >>= 8;
+                    count = count > 8 ? count - 8 : 0;
+                }
+            }
+        };
+
+        constexpr uint32_t kHashBits = 14;
+        constexpr uint32_t kWindowSize = 32768;
+        constexpr uint32_t kMaxMatch = 258;
+
+        size_t GetZlibBound(size_t size)
+        {
+            // 모든 바이트가 9비트 리터럴인 최악의 경우 + 헤더/블록 헤더/Adler-32
+            return 2 + (size * 9 + 3 + 7 + 7) / 8 + 4 + 8;
+        }
+
+        // data를 zlib 스트림으로 out에 쓰고 쓴 바이트 수를 반환합니다.
+        // 해시 버킷마다 가장 최근 위치 하나만 보고 4바이트 이상 일치하면 바로 사용하는 빠른 LZ77
+        size_t CompressZlib(const uint8_t *data, size_t size, uint8_t *out, vector<int32_t> &hashTable)
+        {
+            const FixedHuffman &huffman = GetFixedHuffman();
+            hashTable.assign(size_t(1) << kHashBits, -1);
+
+            uint8_t *begin = out;
+            *out++ = 0x78; // deflate, 32K 윈도우
+            *out++ = 0x01; // 가장 빠른 압축 수준
+
+            BitWriter writer{out};
+            writer.Put(3, 3); // BFINAL = 1, BTYPE = 01 (고정 허프만)
+
+            auto putLiteral = [&](uint8_t value) {
+                writer.Put(huffman.literalCode[value], huffman.literalBits[value]);
+            };
+
+            size_t pos = 0;
+            while (pos + 4 <= size) {
+                const uint32_t value = Load32(data + pos);
+                const uint32_t hash = (value * 2654435761u) >> (32 - kHashBits);
+                const int32_t candidate = hashTable[hash];
+                hashTable[hash] = int32_t(pos);
+
+                if (candidate < 0 || pos - size_t(candidate) > kWindowSize ||
+                    Load32(data + candidate) != value) {
+                    putLiteral(data[pos++]);
+                    continue;
+                }
+
+                // 8바이트씩 비교해서 일치 길이를 늘림
+                const size_t maxLength = min<size_t>(kMaxMatch, size - pos);
+                size_t length = 4;
+                bool mismatch = false;
+                while (!mismatch && length + 8 <= maxLength) {
+                    uint64_t a, b;
+                    memcpy(&a, data + candidate + length, 8);
+                    memcpy(&b, data + pos + length, 8);
+                    const uint64_t diff = a ^ b;
+                    if (diff != 0) {
+                        length += countr_zero(diff) / 8; // 리틀 엔디언 가정
+                        mismatch = true;
+                    }
+                    else {
+                        length += 8;
+                    }
+                }
+                while (!mismatch && length < maxLength && data[candidate + length] == data[pos + length])
+                    length++;
+
+                const uint32_t distance = uint32_t(pos - size_t(candidate));
+                const uint32_t lengthSymbol = huffman.lengthSymbol[length];
+                writer.Put(huffman.literalCode[257 + lengthSymbol], huffman.literalBits[257 + lengthSymbol]);
+                writer.Put(uint32_t(length) - kLengthBase[lengthSymbol], kLengthExtra[lengthSymbol]);
+
+                const uint32_t d = distance - 1;
+                const uint32_t distanceSymbol =
+                    d < 256 ? huffman.distanceSymbol[d] : huffman.distanceSymbol[256 + (d >> 7)];
+                writer.Put(huffman.distanceCode[distanceSymbol], 5);
+                writer.Put(distance - kDistanceBase[distanceSymbol], kDistanceExtra[distanceSymbol]);
+
+                // 일치 구간의 마지막 위치만 해시에 넣어서 다음 일치를 이어 찾기 쉽게 함
+                if (pos + length + 3 < size) {
+                    const size_t last = pos + length - 1;
+                    hashTable[(Load32(data + last) * 2654435761u) >> (32 - kHashBits)] = int32_t(last);
+                }
+                pos += length;
+            }
+            while (pos < size)
+                putLiteral(data[pos++]);
+
+            writer.Put(huffman.literalCode[256], huffman.literalBits[256]); // 블록 끝
+            writer.Flush();
+            out = PutBigEndian(writer.p, Adler32(data, size));
+            return size_t(out - begin);
+        }
+#pragma endregion
+
+#pragma region PNG 필터
+        enum PngFilter : uint8_t { kNone, kSub, kUp, kAverage, kPaeth, kFilterCount };
+
+        uint32_t SignedAbs(uint8_t value) { return value < 128 ? value : 256u - value; }
+
+        uint8_t PaethPredictor(int a, int b, int c)
+        {
+            const int pa = abs(b - c);
+            const int pb = abs(a - c);
+            const int pc = abs(a + b - 2 * c);
+            if (pa <= pb && pa <= pc)
+                return uint8_t(a);
+            return uint8_t(pb <= pc ? b : c);
+        }
+
+        // [begin, end) 바이트의 필터 후보와 비용(부호 있는 바이트로 본 절대값 합)을 계산
+        // RGBA8이므로 왼쪽 픽셀은 4바이트 앞
+        void FilterRangeScalar(const uint8_t *cur, const uint8_t *prev, size_t begin, size_t end,
+                               uint8_t *out[kFilterCount], uint64_t cost[kFilterCount])
+        {
+            for (size_t i = begin; i < end; i++) {
+                const uint8_t x = cur[i];
+                const uint8_t a = i >= 4 ? cur[i - 4] : 0;
+                const uint8_t b = prev[i];
+                const uint8_t c = i >= 4 ? prev[i - 4] : 0;
+
+                const uint8_t filtered[kFilterCount] = {
+                    x, uint8_t(x - a), uint8_t(x - b), uint8_t(x - ((a + b) >> 1)),
+                    uint8_t(x - PaethPredictor(a, b, c))};
+                for (int f = 0; f < kFilterCount; f++) {
+                    cost[f] += SignedAbs(filtered[f]);
+                    if (f != kNone)
+                        out[f][i] = filtered[f];
+                }
+            }
+        }
+
+#if GRAPHICS_USE_SSE2
+        __m128i Abs16(__m128i value)
+        {
+            return _mm_max_epi16(value, _mm_sub_epi16(_mm_setzero_si128(), value));
+        }
+
+        // 16비트로 넓혀서 Paeth 예측값을 계산
+        __m128i PaethPredictor16(__m128i a, __m128i b, __m128i c)
+        {
+            const __m128i pa = Abs16(_mm_sub_epi16(b, c));
+            const __m128i pb = Abs16(_mm_sub_epi16(a, c));
+            const __m128i pc = Abs16(_mm_add_epi16(_mm_sub_epi16(a, c), _mm_sub_epi16(b, c)));
+
+            // pa <= pb && pa <= pc 이면 a, 아니면 pb <= pc 이면 b, 아니면 c
+            const __m128i notA = _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc));
+            const __m128i notB = _mm_cmpgt_epi16(pb, pc);
+            const __m128i bOrC = _mm_or_si128(_mm_andnot_si128(notB, b), _mm_and_si128(notB, c));
+            return _mm_or_si128(_mm_andnot_si128(notA, a), _mm_and_si128(notA, bOrC));
+        }
+
+        // 부호 있는 바이트로 본 절대값 16개의 합 (64비트 2개에 나눠 담김)
+        __m128i SignedAbsSum(__m128i value)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i absolute = _mm_min_epu8(value, _mm_sub_epi8(zero, value));
+            return _mm_sad_epu8(absolute, zero);
+        }
+
+        size_t FilterRangeSse2(const uint8_t *cur, const uint8_t *prev, size_t begin, size_t end,
+                               uint8_t *out[kFilterCount], uint64_t cost[kFilterCount])
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i one = _mm_set1_epi8(1);
+            __m128i sums[kFilterCount] = {zero, zero, zero, zero, zero};
+
+            size_t i = begin;
+            for (; i + 16 <= end; i += 16) {
+                const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cur + i));
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(cur + i - 4));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(prev + i));
+                const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(prev + i - 4));
+
+                // floor((a + b) / 2): _mm_avg_epu8는 올림이므로 (a ^ b) & 1을 빼줌
+                const __m128i average =
+                    _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+                const __m128i paeth = _mm_packus_epi16(
+                    PaethPredictor16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero),
+                                     _mm_unpacklo_epi8(c, zero)),
+                    PaethPredictor16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero),
+                                     _mm_unpackhi_epi8(c, zero)));
+
+                const __m128i filtered[kFilterCount] = {x, _mm_sub_epi8(x, a), _mm_sub_epi8(x, b),
+                                                        _mm_sub_epi8(x, average), _mm_sub_epi8(x, paeth)};
+                for (int f = 0; f < kFilterCount; f++) {
+                    sums[f] = _mm_add_epi64(sums[f], SignedAbsSum(filtered[f]));
+                    if (f != kNone)
+                        _mm_storeu_si128(reinterpret_cast<__m128i *>(out[f] + i), filtered[f]);
+                }
+            }
+
+            for (int f = 0; f < kFilterCount; f++) {
+                alignas(16) uint64_t parts[2];
+                _mm_store_si128(reinterpret_cast<__m128i *>(parts), sums[f]);
+                cost[f] += parts[0] + parts[1];
+            }
+            return i;
+        }
+#endif
+
+        // 스캔라인마다 필터 바이트 + 필터된 데이터를 filtered에 씀
+        void FilterImage(uint32_t width, uint32_t height, const uint8_t *rgba, ImageEncodeScratch &scratch)
+        {
+            const size_t rowBytes = size_t(width) * 4;
+            scratch.filtered.resize((rowBytes + 1) * height);
+            scratch.rows.assign(rowBytes * kFilterCount, 0); // 후보 4개 + 첫 행의 "이전 행"(0)
+
+            uint8_t *candidates[kFilterCount] = {nullptr};
+            for (int f = kSub; f < kFilterCount; f++)
+                candidates[f] = scratch.rows.data() + rowBytes * (f - 1);
+            const uint8_t *zeroRow = scratch.rows.data() + rowBytes * (kFilterCount - 1);
+
+            for (uint32_t y = 0; y < height; y++) {
+                const uint8_t *cur = rgba + y * rowBytes;
+                const uint8_t *prev = y > 0 ? cur - rowBytes : zeroRow;
+
+                uint64_t cost[kFilterCount] = {0};
+                size_t done = min<size_t>(4, rowBytes);
+                FilterRangeScalar(cur, prev, 0, done, candidates, cost);
+#if GRAPHICS_USE_SSE2
+                done = FilterRangeSse2(cur, prev, done, rowBytes, candidates, cost);
+#endif
+                FilterRangeScalar(cur, prev, done, rowBytes, candidates, cost);
+
+                // 절대값 합이 가장 작은 필터 (libpng의 기본 휴리스틱)
+                int best = kNone;
+                for (int f = kSub; f < kFilterCount; f++)
+                    if (cost[f] < cost[best])
+                        best = f;
+
+                uint8_t *row = scratch.filtered.data() + y * (rowBytes + 1);
+                row[0] = uint8_t(best);
+                memcpy(row + 1, best == kNone ? cur : candidates[best], rowBytes);
+            }
+        }
+#pragma endregion
+    }
+
+    const char *GetImageFormatName(ImageFormat format)
+    {
+        switch (format) {
+        case ImageFormat::Png:
+            return "png";
+        case ImageFormat::Qoi:
+            return "qoi";
+        case ImageFormat::Raw:
+        default:
+            return "raw";
+        }
+    }
+
+    const char *GetImageFormatExtension(ImageFormat format)
+    {
+        switch (format) {
+        case ImageFormat::Png:
+            return ".png";
+        case ImageFormat::Qoi:
+            return ".qoi";
+        case ImageFormat::Raw:
+        default:
+            return ".rgba";
+        }
+    }
+
+    void EncodeImage(ImageFormat format, uint32_t width, uint32_t height, const uint8_t *rgba,
+                     vector<uint8_t> &out, ImageEncodeScratch &scratch)
+    {
+        switch (format) {
+        case ImageFormat::Png:
+            EncodePng(width, height, rgba, out, scratch);
+            break;
+        case ImageFormat::Qoi:
+            EncodeQoi(width, height, rgba, out);
+            break;
+        case ImageFormat::Raw:
+        default:
+            out.assign(rgba, rgba + size_t(width) * height * 4);
+            break;
+        }
+    }
+
+    void EncodePng(uint32_t width, uint32_t height, const uint8_t *rgba, vector<uint8_t> &out,
+                   ImageEncodeScratch &scratch)
+    {
+        FilterImage(width, height, rgba, scratch);
+        const vector<uint8_t> &filtered = scratch.filtered;
+
+        // 시그니처 + IHDR(25) + IDAT 헤더(8) + zlib + IDAT CRC(4) + IEND(12)
+        out.resize(8 + 25 + 8 + GetZlibBound(filtered.size()) + 4 + 12);
+        uint8_t *p = out.data();
+
+        static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+        memcpy(p, kSignature, 8);
+        p += 8;
+
+        uint8_t *chunk = p;
+        p = PutBigEndian(p, 13);
+        memcpy(p, "IHDR", 4);
+        p = PutBigEndian(p + 4, width);
+        p = PutBigEndian(p, height);
+        *p++ = 8; // 채널당 8비트
+        *p++ = 6; // RGBA
+        *p++ = 0; // deflate
+        *p++ = 0; // 적응형 필터
+        *p++ = 0; // 인터레이스 없음
+        p = PutBigEndian(p, Crc32(chunk + 4, 17));
+
+        chunk = p;
+        memcpy(p + 4, "IDAT", 4);
+        const size_t compressedSize =
+            CompressZlib(filtered.data(), filtered.size(), p + 8, scratch.hashTable);
+        PutBigEndian(chunk, uint32_t(compressedSize));
+        p += 8 + compressedSize;
+        p = PutBigEndian(p, Crc32(chunk + 4, compressedSize + 4));
+
+        p = PutBigEndian(p, 0);
+        memcpy(p, "IEND", 4);
+        p = PutBigEndian(p + 4, 0xAE426082u); // "IEND"의 CRC
+
+        out.resize(size_t(p - out.data()));
+    }
+
+    void EncodeQoi(uint32_t width, uint32_t height, const uint8_t *rgba, vector<uint8_t> &out)
+    {
+        constexpr uint8_t kOpIndex = 0x00;
+        constexpr uint8_t kOpDiff = 0x40;
+        constexpr uint8_t kOpLuma = 0x80;
+        constexpr uint8_t kOpRun = 0xC0;
+        constexpr uint8_t kOpRgb = 0xFE;
+        constexpr uint8_t kOpRgba = 0xFF;
+
+        const size_t pixelCount = size_t(width) * height;
+        out.resize(14 + pixelCount * 5 + 8); // 최악의 경우 픽셀마다 QOI_OP_RGBA
+        uint8_t *p = out.data();
+
+        memcpy(p, "qoif", 4);
+        p = PutBigEndian(p + 4, width);
+        p = PutBigEndian(p, height);
+        *p++ = 4; // RGBA
+        *p++ = 0; // sRGB + 선형 알파
+
+        uint32_t index[64] = {0};
+        uint8_t prev[4] = {0, 0, 0, 255};
+        uint32_t run = 0;
+
+        for (size_t i = 0; i < pixelCount; i++) {
+            const uint8_t *px = rgba + i * 4;
+            if (memcmp(px, prev, 4) == 0) {
+                run++;
+                if (run == 62 || i + 1 == pixelCount) {
+                    *p++ = uint8_t(kOpRun | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0) {
+                *p++ = uint8_t(kOpRun | (run - 1));
+                run = 0;
+            }
+
+            const uint32_t packed = Load32(px);
+            const uint32_t slot = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+            if (index[slot] == packed) {
+                *p++ = uint8_t(kOpIndex | slot);
+            }
+            else {
+                index[slot] = packed;
+                if (px[3] == prev[3]) {
+                    const int8_t dr = int8_t(px[0] - prev[0]);
+                    const int8_t dg = int8_t(px[1] - prev[1]);
+                    const int8_t db = int8_t(px[2] - prev[2]);
+                    const int8_t drdg = int8_t(dr - dg);
+                    const int8_t dbdg = int8_t(db - dg);
+
+                    if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+                        *p++ = uint8_t(kOpDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                    }
+                    else if (drdg > -9 && drdg < 8 && dg > -33 && dg < 32 && dbdg > -9 && dbdg < 8) {
+                        *p++ = uint8_t(kOpLuma | (dg + 32));
+                        *p++ = uint8_t((drdg + 8) << 4 | (dbdg + 8));
+                    }
+                    else {
+                        *p++ = kOpRgb;
+                        *p++ = px[0];
+                        *p++ = px[1];
+                        *p++ = px[2];
+                    }
+                }
+                else {
+                    *p++ = kOpRgba;
+                    memcpy(p, px, 4);
+                    p += 4;
+                }
+            }
+            memcpy(prev, px, 4);
+        }
+
+        static const uint8_t kEnd[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+        memcpy(p, kEnd, 8);
+        p += 8;
+        out.resize(size_t(p - out.data()));
+    }
+}
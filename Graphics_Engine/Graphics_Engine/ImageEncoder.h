@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace luke {
+
+    enum class ImageFormat : uint32_t { Png, Qoi, Raw };
+
+    const char *GetImageFormatName(ImageFormat format);      // "png", "qoi", "raw"
+    const char *GetImageFormatExtension(ImageFormat format); // ".png", ".qoi", ".rgba"
+
+    // 인코더가 프레임마다 재사용하는 임시 버퍼 (스레드마다 하나씩)
+    struct ImageEncodeScratch {
+        std::vector<uint8_t> filtered; // PNG: 필터 바이트를 붙인 스캔라인들
+        std::vector<uint8_t> rows;     // PNG: 필터 후보 5개 + 첫 행용 0 행
+        std::vector<int32_t> hashTable; // deflate LZ77 해시 테이블
+    };
+
+    // 행 우선 RGBA8 픽셀을 format으로 인코딩해서 out을 채웁니다. (out의 용량은 재사용)
+    // PNG : 행마다 None/Sub/Up/Average/Paeth 중 절대값 합이 가장 작은 필터를 고르고(SSE2),
+    //       고정 허프만 부호 + 해시 한 번만 찾는 LZ77로 빠르게 deflate 합니다.
+    // QOI : https://qoiformat.org 규격 그대로. PNG보다 훨씬 빠르고 압축률은 비슷하거나 약간 낮음
+    // Raw : 헤더 없이 픽셀 그대로
+    void EncodeImage(ImageFormat format, uint32_t width, uint32_t height, const uint8_t *rgba,
+                     std::vector<uint8_t> &out, ImageEncodeScratch &scratch);
+
+    void EncodePng(uint32_t width, uint32_t height, const uint8_t *rgba, std::vector<uint8_t> &out,
+                   ImageEncodeScratch &scratch);
+    void EncodeQoi(uint32_t width, uint32_t height, const uint8_t *rgba, std::vector<uint8_t> &out);
+}
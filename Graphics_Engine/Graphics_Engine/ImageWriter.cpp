@@ -0,0 +1,184 @@
+#include "ImageWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        using Clock = chrono::high_resolution_clock;
+
+        double ElapsedMs(Clock::time_point start)
+        {
+            return chrono::duration<double, milli>(Clock::now() - start).count();
+        }
+
+        bool WriteFile(const filesystem::path &path, const vector<uint8_t> &data)
+        {
+            ofstream file(path, ios::binary);
+            if (!file)
+                return false;
+            file.write(reinterpret_cast<const char *>(data.data()), streamsize(data.size()));
+            return bool(file);
+        }
+    }
+
+    ImageWriter::ImageWriter(ImageFormat format, unsigned int threadCount, size_t queueCapacity,
+                             QueueFullPolicy policy)
+        : m_format(format), m_policy(policy), m_queueCapacity(max<size_t>(queueCapacity, 1)),
+          m_queue(m_queueCapacity), m_freeSlots(ptrdiff_t(m_queueCapacity)), m_queuedImages(0)
+    {
+        if (threadCount == 0)
+            threadCount = max(1u, thread::hardware_concurrency() / 2);
+
+        m_stats.queueCapacity = uint32_t(m_queueCapacity);
+        m_workers.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; i++)
+            m_workers.emplace_back([this] { WorkerLoop(); });
+    }
+
+    ImageWriter::~ImageWriter()
+    {
+        WaitIdle();
+        m_stop = true;
+        m_queuedImages.release(ptrdiff_t(m_workers.size()));
+
+        for (auto &worker : m_workers)
+            worker.join();
+    }
+
+    vector<uint8_t> ImageWriter::AcquireBuffer(size_t size)
+    {
+        vector<uint8_t> buffer;
+        {
+            lock_guard<mutex> lock(m_poolMutex);
+            if (!m_freeBuffers.empty()) {
+                buffer = std::move(m_freeBuffers.back());
+                m_freeBuffers.pop_back();
+            }
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            if (buffer.capacity() >= size)
+                m_stats.buffersReused++;
+            else
+                m_stats.buffersAllocated++;
+        }
+        buffer.resize(size);
+        return buffer;
+    }
+
+    void ImageWriter::ReleaseBuffer(vector<uint8_t> &&buffer)
+    {
+        if (buffer.capacity() == 0)
+            return;
+
+        // 큐 + 인코딩 중 + 생산자가 채우는 중인 버퍼만큼만 보관
+        lock_guard<mutex> lock(m_poolMutex);
+        if (m_freeBuffers.size() < m_queueCapacity + m_workers.size() + 2)
+            m_freeBuffers.push_back(std::move(buffer));
+    }
+
+    bool ImageWriter::Submit(filesystem::path path, uint32_t width, uint32_t height, vector<uint8_t> &&rgba)
+    {
+        if (!path.has_extension())
+            path += GetImageFormatExtension(m_format);
+
+        if (!m_freeSlots.try_acquire()) {
+            if (m_policy == QueueFullPolicy::Drop) {
+                {
+                    lock_guard<mutex> lock(m_mutex);
+                    m_stats.submitted++;
+                    m_stats.dropped++;
+                }
+                ReleaseBuffer(std::move(rgba));
+                return false;
+            }
+
+            const auto start = Clock::now();
+            m_freeSlots.acquire();
+            lock_guard<mutex> lock(m_mutex);
+            m_stats.producerWaits++;
+            m_stats.producerWaitMs += ElapsedMs(start);
+        }
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_stats.submitted++;
+            m_pending++;
+            const uint32_t queued = m_queuedCount.fetch_add(1, memory_order_relaxed) + 1;
+            m_stats.queueHighWater = max(m_stats.queueHighWater, queued);
+        }
+
+        // m_freeSlots를 얻었으므로 빈자리가 있음
+        Image image{std::move(path), width, height, std::move(rgba)};
+        while (!m_queue.TryPush(std::move(image)))
+            this_thread::yield();
+        m_queuedImages.release();
+        return true;
+    }
+
+    void ImageWriter::WaitIdle()
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_pending == 0; });
+    }
+
+    ImageWriterStats ImageWriter::GetStats() const
+    {
+        lock_guard<mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void ImageWriter::WorkerLoop()
+    {
+        // 스레드마다 재사용하는 인코딩 버퍼
+        vector<uint8_t> encoded;
+        ImageEncodeScratch scratch;
+
+        while (true) {
+            m_queuedImages.acquire();
+
+            Image image;
+            // 다른 생산자가 앞 칸을 아직 쓰는 중이면 잠깐 실패할 수 있음
+            while (!m_queue.TryPop(image)) {
+                if (m_stop)
+                    return;
+                this_thread::yield();
+            }
+            m_queuedCount.fetch_sub(1, memory_order_relaxed);
+            m_freeSlots.release();
+
+            const auto encodeStart = Clock::now();
+            EncodeImage(m_format, image.width, image.height, image.rgba.data(), encoded, scratch);
+            const double encodeMs = ElapsedMs(encodeStart);
+
+            const auto writeStart = Clock::now();
+            const bool written = WriteFile(image.path, encoded);
+            const double writeMs = ElapsedMs(writeStart);
+            if (!written)
+                cout << "Cannot write image " << image.path.string() << endl;
+
+            const size_t bytesIn = image.rgba.size();
+            ReleaseBuffer(std::move(image.rgba));
+
+            lock_guard<mutex> lock(m_mutex);
+            m_stats.encodeMs += encodeMs;
+            m_stats.writeMs += writeMs;
+            m_stats.bytesIn += bytesIn;
+            if (written) {
+                m_stats.written++;
+                m_stats.bytesOut += encoded.size();
+            }
+            else {
+                m_stats.failed++;
+            }
+            if (--m_pending == 0)
+                m_idle.notify_all();
+        }
+    }
+}
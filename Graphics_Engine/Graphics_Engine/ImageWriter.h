@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "ImageEncoder.h"
+
+namespace luke {
+
+    // 큐가 가득 찼을 때 Submit()의 동작
+    enum class QueueFullPolicy : uint32_t {
+        Wait, // 빈자리가 날 때까지 기다림 (배치 렌더링: 이미지를 빠뜨리면 안 됨)
+        Drop, // 이번 이미지를 버림 (창 모드 캡처: 프레임을 멈추면 안 됨)
+    };
+
+    struct ImageWriterStats {
+        uint64_t submitted = 0;
+        uint64_t written = 0;
+        uint64_t failed = 0;
+        uint64_t dropped = 0; // QueueFullPolicy::Drop으로 버린 이미지
+
+        // 역압(back-pressure): 인코더가 렌더링을 따라가지 못한 정도
+        uint64_t producerWaits = 0;  // Submit()이 큐가 가득 차서 기다린 횟수
+        double producerWaitMs = 0.0; // 그 대기 시간의 합
+        uint32_t queueCapacity = 0;
+        uint32_t queueHighWater = 0; // 큐에 동시에 쌓였던 최대 이미지 수
+
+        double encodeMs = 0.0; // 인코더 스레드들의 인코딩 시간 합
+        double writeMs = 0.0;  // 파일 쓰기 시간 합
+        uint64_t bytesIn = 0;  // 픽셀 바이트
+        uint64_t bytesOut = 0; // 파일 바이트
+
+        uint64_t buffersAllocated = 0; // 풀에 남는 버퍼가 없어서 새로 할당한 횟수
+        uint64_t buffersReused = 0;
+    };
+
+    // 캡처한 프레임을 여러 인코더 스레드에서 병렬로 인코딩해서 저장합니다.
+    // - 렌더링 스레드(여러 개여도 됨)는 AcquireBuffer()로 받은 버퍼에 RGBA8 픽셀을 채워서 Submit()하고,
+    //   인코딩/파일 쓰기를 기다리지 않습니다.
+    // - 큐(BoundedQueue)는 queueCapacity장까지만 받고, 가득 차면 policy에 따라 기다리거나 버립니다.
+    // - 인코딩이 끝난 픽셀 버퍼는 풀로 돌아가서 다음 프레임에 재사용되므로
+    //   워밍업 이후에는 프레임마다 할당하지 않습니다. (인코더 출력 버퍼도 스레드마다 재사용)
+    class ImageWriter {
+    public:
+        // threadCount == 0 이면 (하드웨어 스레드 수 / 2)개
+        explicit ImageWriter(ImageFormat format, unsigned int threadCount = 0, size_t queueCapacity = 8,
+                             QueueFullPolicy policy = QueueFullPolicy::Wait);
+        ~ImageWriter();
+
+        ImageWriter(const ImageWriter &) = delete;
+        ImageWriter &operator=(const ImageWriter &) = delete;
+
+        // 크기가 size인 픽셀 버퍼. Submit()으로 넘기거나 ReleaseBuffer()로 돌려주세요.
+        std::vector<uint8_t> AcquireBuffer(size_t size);
+        void ReleaseBuffer(std::vector<uint8_t> &&buffer);
+
+        // path에 확장자가 없으면 GetImageFormatExtension()을 붙입니다.
+        // 버렸으면(QueueFullPolicy::Drop) false. 어느 경우든 rgba는 풀로 돌아갑니다.
+        bool Submit(std::filesystem::path path, uint32_t width, uint32_t height,
+                    std::vector<uint8_t> &&rgba);
+
+        // 큐에 남은 이미지와 인코딩 중인 이미지가 모두 끝날 때까지 대기
+        void WaitIdle();
+
+        ImageFormat GetFormat() const { return m_format; }
+        QueueFullPolicy GetPolicy() const { return m_policy; }
+        size_t GetThreadCount() const { return m_workers.size(); }
+        ImageWriterStats GetStats() const;
+
+    private:
+        struct Image {
+            std::filesystem::path path;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            std::vector<uint8_t> rgba;
+        };
+
+        void WorkerLoop();
+
+        ImageFormat m_format;
+        QueueFullPolicy m_policy;
+        size_t m_queueCapacity;
+        BoundedQueue<Image> m_queue;
+        std::counting_semaphore<> m_freeSlots;   // 큐의 빈자리 (queueCapacity부터 시작)
+        std::counting_semaphore<> m_queuedImages; // 인코더가 꺼낼 수 있는 이미지
+        std::atomic<uint32_t> m_queuedCount{0};
+        std::atomic<bool> m_stop{false};
+        std::vector<std::thread> m_workers;
+
+        // 픽셀 버퍼 풀
+        std::mutex m_poolMutex;
+        std::vector<std::vector<uint8_t>> m_freeBuffers;
+
+        // 통계와 WaitIdle()
+        mutable std::mutex m_mutex;
+        std::condition_variable m_idle;
+        uint64_t m_pending = 0; // Submit()됐지만 아직 끝나지 않은 이미지
+        ImageWriterStats m_stats;
+    };
+}
@@ -0,0 +1,125 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <memory>
+
+namespace luke {
+    using namespace std;
+
+    JobSystem::JobSystem(unsigned int threadCount)
+    {
+        if (threadCount == 0) {
+            const unsigned int hardwareThreads = thread::hardware_concurrency();
+            threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        m_workers.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; i++)
+            m_workers.emplace_back([this] { WorkerLoop(); });
+    }
+
+    JobSystem::~JobSystem()
+    {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_jobAvailable.notify_all();
+
+        for (auto &worker : m_workers)
+            worker.join();
+    }
+
+    void JobSystem::Submit(function<void()> job)
+    {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_jobs.push_back(std::move(job));
+        }
+        m_jobAvailable.notify_one();
+    }
+
+    void JobSystem::ParallelFor(size_t count, size_t grainSize,
+                                const function<void(size_t begin, size_t end)> &func)
+    {
+        if (count == 0)
+            return;
+
+        grainSize = max<size_t>(grainSize, 1);
+        const size_t chunkCount = (count + grainSize - 1) / grainSize;
+
+        // 구간이 하나뿐이면 스레드를 깨우는 비용이 더 큽니다.
+        if (chunkCount == 1 || m_workers.empty()) {
+            func(0, count);
+            return;
+        }
+
+        // 워커가 ParallelFor 반환 이후에 실행될 수도 있으므로
+        // 공유 상태는 스택이 아니라 shared_ptr로 관리합니다.
+        struct ForState {
+            atomic<size_t> nextChunk{0};
+            atomic<size_t> doneChunks{0};
+            mutex doneMutex;
+            condition_variable doneCondition;
+        };
+        auto state = make_shared<ForState>();
+
+        auto runChunks = [state, count, grainSize, chunkCount, &func]() {
+            while (true) {
+                const size_t chunk = state->nextChunk.fetch_add(1);
+                if (chunk >= chunkCount)
+                    return;
+
+                const size_t begin = chunk * grainSize;
+                func(begin, min(begin + grainSize, count));
+
+                if (state->doneChunks.fetch_add(1) + 1 == chunkCount) {
+                    lock_guard<mutex> lock(state->doneMutex);
+                    state->doneCondition.notify_all();
+                }
+            }
+        };
+
+        const size_t helperCount = min(m_workers.size(), chunkCount - 1);
+        for (size_t i = 0; i < helperCount; i++)
+            Submit(runChunks);
+
+        runChunks();
+
+        unique_lock<mutex> lock(state->doneMutex);
+        state->doneCondition.wait(lock,
+                                  [&] { return state->doneChunks.load() == chunkCount; });
+    }
+
+    void JobSystem::WaitIdle()
+    {
+        unique_lock<mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return m_jobs.empty() && m_activeJobs == 0; });
+    }
+
+    void JobSystem::WorkerLoop()
+    {
+        while (true) {
+            function<void()> job;
+            {
+                unique_lock<mutex> lock(m_mutex);
+                m_jobAvailable.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+                if (m_stop && m_jobs.empty())
+                    return;
+
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+                m_activeJobs++;
+            }
+
+            job();
+
+            {
+                lock_guard<mutex> lock(m_mutex);
+                m_activeJobs--;
+                if (m_jobs.empty() && m_activeJobs == 0)
+                    m_idle.notify_all();
+            }
+        }
+    }
+}
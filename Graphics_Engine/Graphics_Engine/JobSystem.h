@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace luke {
+
+    // 고정 개수의 워커 스레드를 가진 간단한 작업 풀
+    // 컬링, 스키닝처럼 독립적인 원소가 많은 작업을 나눠서 처리할 때 사용합니다.
+    class JobSystem {
+    public:
+        // threadCount == 0 이면 (하드웨어 스레드 수 - 1)개의 워커를 만듭니다.
+        explicit JobSystem(unsigned int threadCount = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem &) = delete;
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        // 작업 하나를 큐에 넣습니다. 완료를 기다리지 않습니다.
+        void Submit(std::function<void()> job);
+
+        // [0, count) 범위를 grainSize 크기의 구간으로 나눠 병렬로 처리합니다.
+        // 호출한 스레드도 구간 처리에 참여하고, 모든 구간이 끝나야 반환합니다.
+        void ParallelFor(size_t count, size_t grainSize,
+                         const std::function<void(size_t begin, size_t end)> &func);
+
+        // 큐에 남은 작업과 실행 중인 작업이 모두 끝날 때까지 대기
+        void WaitIdle();
+
+        size_t GetThreadCount() const { return m_workers.size(); }
+
+    private:
+        void WorkerLoop();
+
+        std::vector<std::thread> m_workers;
+        std::deque<std::function<void()>> m_jobs;
+        std::mutex m_mutex;
+        std::condition_variable m_jobAvailable;
+        std::condition_variable m_idle;
+        size_t m_activeJobs = 0;
+        bool m_stop = false;
+    };
+}
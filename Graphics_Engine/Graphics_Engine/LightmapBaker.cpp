@@ -0,0 +1,608 @@
+#include "LightmapBaker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+
+namespace luke {
+
+    using namespace std;
+
+    namespace {
+        constexpr uint32_t kNoNeighbour = ~0u;
+        // 삼각형 밖이어도 텍셀 중심이 이 거리(텍셀) 안이면 가장 가까운 점으로 굽습니다. (경계 텍셀이 비지 않게)
+        constexpr float kConservativeDistance = 0.75f;
+        constexpr float kPi = 3.14159265f;
+        constexpr uint32_t kMaxAtlasSize = 16384; // D3D11 텍스처 한 변의 최대 크기
+
+        uint32_t Hash(uint32_t value)
+        {
+            const uint32_t state = value * 747796405u + 2891336453u;
+            const uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+            return (word >> 22u) ^ word;
+        }
+
+        float SmoothStep(float edge0, float edge1, float x)
+        {
+            const float t = clamp((x - edge0) / (edge1 - edge0), 0.0f, 1.0f);
+            return t * t * (3.0f - 2.0f * t);
+        }
+
+        // 법선 n에 수직인 두 축 (Duff et al. 2017)
+        void MakeBasis(const Vector3 &n, Vector3 &tangent, Vector3 &bitangent)
+        {
+            const float sign = copysignf(1.0f, n.z);
+            const float a = -1.0f / (sign + n.z);
+            const float b = n.x * n.y * a;
+            tangent = Vector3(1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x);
+            bitangent = Vector3(b, sign + n.y * n.y * a, -n.y);
+        }
+
+        float EdgeFunction(const Vector2 &a, const Vector2 &b, float px, float py)
+        {
+            return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+        }
+
+        uint8_t EncodeSrgb(float linear)
+        {
+            linear = clamp(linear, 0.0f, 1.0f);
+            const float srgb = linear <= 0.0031308f ? linear * 12.92f : 1.055f * powf(linear, 1.0f / 2.4f) - 0.055f;
+            return uint8_t(srgb * 255.0f + 0.5f);
+        }
+    }
+
+    float LightmapBaker::Random::Next()
+    {
+        state = Hash(state);
+        return float(state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    uint32_t LightmapBaker::AddMesh(const MeshData &mesh, const Matrix &world)
+    {
+        SourceMesh source;
+        source.positions.reserve(mesh.vertices.size());
+        source.normals.reserve(mesh.vertices.size());
+        source.colors.reserve(mesh.vertices.size());
+        for (const Vertex &vertex : mesh.vertices) {
+            source.positions.push_back(Vector3::Transform(vertex.position, world));
+            Vector3 normal = Vector3::TransformNormal(vertex.normal, world);
+            normal.Normalize();
+            source.normals.push_back(normal);
+            source.colors.push_back(vertex.color);
+        }
+        source.indices.assign(mesh.indices.begin(), mesh.indices.end() - mesh.indices.size() % 3);
+        m_meshes.push_back(std::move(source));
+        return uint32_t(m_meshes.size() - 1);
+    }
+
+    bool LightmapBaker::Prepare(const LightmapSettings &settings)
+    {
+        using Clock = chrono::high_resolution_clock;
+        const auto start = Clock::now();
+
+        m_settings = settings;
+        m_settings.width = max(m_settings.width, 4u);
+        m_settings.height = max(m_settings.height, 4u);
+        m_settings.tileSize = max(m_settings.tileSize, 1u);
+        m_charts.clear();
+        m_meshUvs.clear();
+        m_trianglePositions.clear();
+        m_triangleColors.clear();
+        m_triangleNormals.clear();
+        m_stats = LightmapStats();
+        m_stats.meshCount = uint32_t(m_meshes.size());
+
+        for (SourceMesh &mesh : m_meshes) {
+            mesh.firstTriangle = uint32_t(m_triangleNormals.size());
+            for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+                const uint16_t i0 = mesh.indices[i], i1 = mesh.indices[i + 1], i2 = mesh.indices[i + 2];
+                for (uint16_t index : {i0, i1, i2}) {
+                    m_trianglePositions.push_back(mesh.positions[index]);
+                    m_triangleColors.push_back(mesh.colors[index]);
+                }
+                Vector3 normal = (mesh.positions[i1] - mesh.positions[i0]).Cross(mesh.positions[i2] - mesh.positions[i0]);
+                if (normal.LengthSquared() > 0.0f)
+                    normal.Normalize();
+                m_triangleNormals.push_back(normal);
+            }
+        }
+        m_stats.triangleCount = uint32_t(m_triangleNormals.size());
+
+        for (uint32_t mesh = 0; mesh < uint32_t(m_meshes.size()); mesh++)
+            BuildCharts(mesh);
+        m_stats.chartCount = uint32_t(m_charts.size());
+
+        // 다 들어갈 때까지 밀도를 15%씩 줄임
+        float density = m_settings.texelsPerUnit;
+        bool packed = PackCharts(m_settings, density, m_charts, m_stats);
+        for (uint32_t attempt = 1; attempt < 32 && !packed; attempt++) {
+            density *= 0.85f;
+            packed = PackCharts(m_settings, density, m_charts, m_stats);
+        }
+        if (!packed) {
+            // 차트 수가 너무 많으면 밀도를 줄여도 패딩 때문에 안 들어감. 마지막 밀도로 들어가는 정사각형 크기를 알려 줌
+            cout << "LightmapBaker::Prepare() failed: " << m_charts.size() << " charts do not fit in "
+                 << m_settings.width << "x" << m_settings.height << " even at " << density << " texels/unit";
+            const uint32_t minimumSize = FindMinimumAtlasSize(density);
+            if (minimumSize > 0)
+                cout << "; the atlas needs at least " << minimumSize << "x" << minimumSize << "." << endl;
+            else
+                cout << "." << endl;
+            return false;
+        }
+
+        BuildUvs();
+        for (const LightmapMeshUvs &uvs : m_meshUvs) {
+            if (uvs.sourceVertices.size() > 65536) {
+                cout << "LightmapBaker::Prepare() failed: a mesh has more than 65536 vertices after splitting charts."
+                     << endl;
+                return false;
+            }
+        }
+
+        RasterizeCharts();
+        m_accumulated.assign(m_texelPositions.size(), Vector3());
+        m_stats.coveredTexels = uint32_t(m_texelPositions.size());
+        m_stats.tileCount = uint32_t(m_tiles.size());
+        m_stats.chartMs = chrono::duration<double, milli>(Clock::now() - start).count();
+
+        m_bvh.Build(m_trianglePositions);
+        m_stats.bvh = m_bvh.GetStats();
+        return true;
+    }
+
+    void LightmapBaker::BuildCharts(uint32_t meshIndex)
+    {
+        const SourceMesh &mesh = m_meshes[meshIndex];
+        const uint32_t triangleCount = uint32_t(mesh.indices.size() / 3);
+
+        // 인덱스가 같은 변을 공유하는 이웃 (한 변을 셋 이상이 공유하면 처음 둘만 잇습니다)
+        vector<uint32_t> neighbours(size_t(triangleCount) * 3, kNoNeighbour);
+        unordered_map<uint32_t, uint32_t> openEdges; // (작은 인덱스 << 16 | 큰 인덱스) -> 삼각형 * 3 + 변
+        openEdges.reserve(mesh.indices.size());
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            for (uint32_t k = 0; k < 3; k++) {
+                const uint32_t a = mesh.indices[t * 3 + k], b = mesh.indices[t * 3 + (k + 1) % 3];
+                const uint32_t key = (min(a, b) << 16) | max(a, b);
+                const auto [it, inserted] = openEdges.emplace(key, t * 3 + k);
+                if (inserted)
+                    continue;
+                neighbours[t * 3 + k] = it->second / 3;
+                neighbours[it->second] = t;
+                openEdges.erase(it);
+            }
+        }
+
+        // 첫 삼각형과 법선이 비슷한 이웃을 너비 우선으로 모음 (첫 삼각형 기준이라 펼쳐도 겹치지 않음)
+        const float cosLimit = cosf(m_settings.chartAngle);
+        vector<uint8_t> assigned(triangleCount, 0);
+        vector<uint32_t> queue;
+        for (uint32_t seed = 0; seed < triangleCount; seed++) {
+            if (assigned[seed])
+                continue;
+
+            Chart chart;
+            chart.mesh = meshIndex;
+            Vector3 normal = m_triangleNormals[mesh.firstTriangle + seed];
+            if (normal.LengthSquared() == 0.0f)
+                normal = Vector3::Up;
+
+            assigned[seed] = 1;
+            queue.assign(1, seed);
+            for (size_t head = 0; head < queue.size(); head++) {
+                const uint32_t t = queue[head];
+                chart.triangles.push_back(t);
+                for (uint32_t k = 0; k < 3; k++) {
+                    const uint32_t next = neighbours[t * 3 + k];
+                    if (next == kNoNeighbour || assigned[next] ||
+                        m_triangleNormals[mesh.firstTriangle + next].Dot(normal) < cosLimit)
+                        continue;
+                    assigned[next] = 1;
+                    queue.push_back(next);
+                }
+            }
+
+            MakeBasis(normal, chart.tangent, chart.bitangent);
+            float minU = INFINITY, minV = INFINITY, maxU = -INFINITY, maxV = -INFINITY;
+            for (uint32_t t : chart.triangles) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    const Vector3 &p = mesh.positions[mesh.indices[t * 3 + k]];
+                    const float u = p.Dot(chart.tangent), v = p.Dot(chart.bitangent);
+                    minU = min(minU, u);
+                    maxU = max(maxU, u);
+                    minV = min(minV, v);
+                    maxV = max(maxV, v);
+                }
+            }
+            chart.planeMin = Vector2(minU, minV);
+            chart.planeSize = Vector2(maxU - minU, maxV - minV);
+            m_charts.push_back(std::move(chart));
+        }
+    }
+
+    bool LightmapBaker::PackCharts(const LightmapSettings &settings, float texelsPerUnit, vector<Chart> &charts,
+                                   LightmapStats &stats)
+    {
+        stats.packAttempts++;
+        stats.texelsPerUnit = texelsPerUnit;
+        const uint32_t padding = settings.padding;
+        const float maxInnerWidth = float(settings.width) - 2.0f * padding - 1.0f;
+        const float maxInnerHeight = float(settings.height) - 2.0f * padding - 1.0f;
+        if (maxInnerWidth < 1.0f || maxInnerHeight < 1.0f)
+            return false;
+
+        for (Chart &chart : charts) {
+            const float innerWidth = chart.planeSize.x * texelsPerUnit;
+            const float innerHeight = chart.planeSize.y * texelsPerUnit;
+            chart.scale = min({1.0f, maxInnerWidth / max(innerWidth, 1e-6f), maxInnerHeight / max(innerHeight, 1e-6f)});
+            chart.width = max(1u, uint32_t(ceilf(innerWidth * chart.scale))) + 2 * padding;
+            chart.height = max(1u, uint32_t(ceilf(innerHeight * chart.scale))) + 2 * padding;
+        }
+
+        // 높은 차트부터 선반에 왼쪽에서 오른쪽으로
+        vector<uint32_t> order(charts.size());
+        iota(order.begin(), order.end(), 0u);
+        sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return charts[a].height != charts[b].height ? charts[a].height > charts[b].height
+                                                        : charts[a].width > charts[b].width;
+        });
+        uint32_t x = 0, y = 0, shelfHeight = 0;
+        for (uint32_t index : order) {
+            Chart &chart = charts[index];
+            if (x + chart.width > settings.width) {
+                y += shelfHeight;
+                x = 0;
+                shelfHeight = 0;
+            }
+            if (y + chart.height > settings.height)
+                return false;
+            chart.x = x;
+            chart.y = y;
+            x += chart.width;
+            shelfHeight = max(shelfHeight, chart.height);
+        }
+        return true;
+    }
+
+    uint32_t LightmapBaker::FindMinimumAtlasSize(float texelsPerUnit) const
+    {
+        // 복사본에 패킹해 보므로 베이커의 설정, 통계, 차트 위치는 그대로
+        LightmapSettings settings = m_settings;
+        LightmapStats stats;
+        vector<Chart> charts = m_charts;
+        auto fits = [&](uint32_t size) {
+            settings.width = settings.height = size;
+            return PackCharts(settings, texelsPerUnit, charts, stats);
+        };
+
+        // 두 배씩 늘려서 들어가는 크기를 찾은 뒤 그 사이를 이분 탐색
+        uint32_t low = max(m_settings.width, m_settings.height), high = low * 2;
+        while (high <= kMaxAtlasSize && !fits(high)) {
+            low = high;
+            high *= 2;
+        }
+        uint32_t result = 0;
+        if (high <= kMaxAtlasSize) {
+            while (high - low > 1) {
+                const uint32_t middle = low + (high - low) / 2;
+                (fits(middle) ? high : low) = middle;
+            }
+            result = high;
+        }
+        return result;
+    }
+
+    Vector2 LightmapBaker::GetChartTexel(const Chart &chart, const Vector3 &position) const
+    {
+        const float scale = m_stats.texelsPerUnit * chart.scale;
+        return Vector2(float(chart.x + m_settings.padding) + (position.Dot(chart.tangent) - chart.planeMin.x) * scale,
+                       float(chart.y + m_settings.padding) + (position.Dot(chart.bitangent) - chart.planeMin.y) * scale);
+    }
+
+    void LightmapBaker::BuildUvs()
+    {
+        m_meshUvs.assign(m_meshes.size(), LightmapMeshUvs());
+        for (uint32_t mesh = 0; mesh < uint32_t(m_meshes.size()); mesh++)
+            m_meshUvs[mesh].indices.resize(m_meshes[mesh].indices.size());
+
+        // 차트마다 정점을 새로 만듦 (한 정점이 여러 차트에 걸치면 UV가 다르므로 나눔)
+        const float invWidth = 1.0f / float(m_settings.width);
+        const float invHeight = 1.0f / float(m_settings.height);
+        unordered_map<uint32_t, uint32_t> chartVertices;
+        for (const Chart &chart : m_charts) {
+            const SourceMesh &mesh = m_meshes[chart.mesh];
+            LightmapMeshUvs &uvs = m_meshUvs[chart.mesh];
+            chartVertices.clear();
+            for (uint32_t t : chart.triangles) {
+                for (uint32_t k = 0; k < 3; k++) {
+                    const uint32_t source = mesh.indices[t * 3 + k];
+                    auto [it, inserted] = chartVertices.emplace(source, uint32_t(uvs.sourceVertices.size()));
+                    if (inserted) {
+                        const Vector2 texel = GetChartTexel(chart, mesh.positions[source]);
+                        uvs.sourceVertices.push_back(source);
+                        uvs.uvs.push_back(Vector2(texel.x * invWidth, texel.y * invHeight));
+                    }
+                    uvs.indices[t * 3 + k] = uint16_t(it->second);
+                }
+            }
+        }
+    }
+
+    void LightmapBaker::RasterizeCharts()
+    {
+        const uint32_t width = m_settings.width, height = m_settings.height;
+        const size_t pixelCount = size_t(width) * height;
+        vector<float> distances(pixelCount, INFINITY); // 0이면 텍셀 중심이 삼각형 안
+        vector<Vector3> positions(pixelCount);
+        vector<Vector3> normals(pixelCount);
+
+        for (const Chart &chart : m_charts) {
+            const SourceMesh &mesh = m_meshes[chart.mesh];
+            for (uint32_t t : chart.triangles) {
+                const uint16_t *index = &mesh.indices[t * 3];
+                const Vector2 a = GetChartTexel(chart, mesh.positions[index[0]]);
+                const Vector2 b = GetChartTexel(chart, mesh.positions[index[1]]);
+                const Vector2 c = GetChartTexel(chart, mesh.positions[index[2]]);
+                const float area = EdgeFunction(a, b, c.x, c.y);
+                if (fabsf(area) < 1e-12f)
+                    continue;
+                const float sign = area > 0.0f ? 1.0f : -1.0f;
+                const float lengthA = hypotf(c.x - b.x, c.y - b.y); // 꼭짓점 a 맞은편 변
+                const float lengthB = hypotf(a.x - c.x, a.y - c.y);
+                const float lengthC = hypotf(b.x - a.x, b.y - a.y);
+
+                const int minX = max(0, int(floorf(min({a.x, b.x, c.x}) - 1.0f)));
+                const int maxX = min(int(width) - 1, int(ceilf(max({a.x, b.x, c.x}) + 1.0f)));
+                const int minY = max(0, int(floorf(min({a.y, b.y, c.y}) - 1.0f)));
+                const int maxY = min(int(height) - 1, int(ceilf(max({a.y, b.y, c.y}) + 1.0f)));
+                for (int y = minY; y <= maxY; y++) {
+                    for (int x = minX; x <= maxX; x++) {
+                        const float px = x + 0.5f, py = y + 0.5f;
+                        const float ea = EdgeFunction(b, c, px, py) * sign;
+                        const float eb = EdgeFunction(c, a, px, py) * sign;
+                        const float ec = EdgeFunction(a, b, px, py) * sign;
+                        // 변까지의 부호 있는 거리 (안쪽이 양수). 가장 음수인 변이 밖으로 나간 거리
+                        const float outside = max(0.0f, -min({ea / lengthA, eb / lengthB, ec / lengthC}));
+                        const size_t pixel = size_t(y) * width + x;
+                        if (outside > kConservativeDistance || outside >= distances[pixel])
+                            continue;
+
+                        // 밖이면 무게중심 좌표를 잘라서 삼각형 위의 가까운 점으로
+                        float wa = max(ea, 0.0f), wb = max(eb, 0.0f), wc = max(ec, 0.0f);
+                        const float sum = wa + wb + wc;
+                        if (sum <= 0.0f)
+                            continue;
+                        wa /= sum;
+                        wb /= sum;
+                        wc /= sum;
+
+                        distances[pixel] = outside;
+                        positions[pixel] = mesh.positions[index[0]] * wa + mesh.positions[index[1]] * wb +
+                                           mesh.positions[index[2]] * wc;
+                        Vector3 normal =
+                            mesh.normals[index[0]] * wa + mesh.normals[index[1]] * wb + mesh.normals[index[2]] * wc;
+                        if (normal.LengthSquared() < 1e-12f)
+                            normal = m_triangleNormals[mesh.firstTriangle + t];
+                        normal.Normalize();
+                        normals[pixel] = normal;
+                    }
+                }
+            }
+        }
+
+        // 타일 순서로 모아서 작업 하나가 이어진 텍셀을 맡게 함
+        m_texelPositions.clear();
+        m_texelNormals.clear();
+        m_texelPixels.clear();
+        m_tiles.clear();
+        const uint32_t tileSize = m_settings.tileSize;
+        for (uint32_t tileY = 0; tileY < height; tileY += tileSize) {
+            for (uint32_t tileX = 0; tileX < width; tileX += tileSize) {
+                const uint32_t first = uint32_t(m_texelPixels.size());
+                for (uint32_t y = tileY; y < min(tileY + tileSize, height); y++) {
+                    for (uint32_t x = tileX; x < min(tileX + tileSize, width); x++) {
+                        const size_t pixel = size_t(y) * width + x;
+                        if (distances[pixel] > kConservativeDistance)
+                            continue;
+                        m_texelPositions.push_back(positions[pixel]);
+                        m_texelNormals.push_back(normals[pixel]);
+                        m_texelPixels.push_back(uint32_t(pixel));
+                    }
+                }
+                if (m_texelPixels.size() > first)
+                    m_tiles.push_back({first, uint32_t(m_texelPixels.size()) - first});
+            }
+        }
+    }
+
+    void LightmapBaker::BakePass(uint32_t samplesPerTexel, JobSystem &jobSystem)
+    {
+        if (m_tiles.empty() || samplesPerTexel == 0)
+            return;
+
+        using Clock = chrono::high_resolution_clock;
+        const auto start = Clock::now();
+        const uint32_t firstSample = m_stats.samplesPerTexel;
+        atomic<uint64_t> totalRays{0};
+
+        jobSystem.ParallelFor(m_tiles.size(), 1, [&](size_t begin, size_t end) {
+            uint64_t rays = 0;
+            for (size_t tile = begin; tile < end; tile++) {
+                const Tile &range = m_tiles[tile];
+                for (uint32_t texel = range.first; texel < range.first + range.count; texel++) {
+                    Vector3 sum;
+                    for (uint32_t sample = firstSample; sample < firstSample + samplesPerTexel; sample++) {
+                        Random random{Hash(texel) ^ Hash(sample * 0x9E3779B9u + 1u)};
+                        sum += TracePath(m_texelPositions[texel], m_texelNormals[texel], random, rays);
+                    }
+                    m_accumulated[texel] += sum;
+                }
+            }
+            totalRays.fetch_add(rays, memory_order_relaxed);
+        });
+
+        m_stats.samplesPerTexel += samplesPerTexel;
+        m_stats.rays += totalRays.load();
+        m_stats.bakeMs += chrono::duration<double, milli>(Clock::now() - start).count();
+        m_stats.threadCount = uint32_t(jobSystem.GetThreadCount() + 1);
+    }
+
+    Vector3 LightmapBaker::TracePath(const Vector3 &position, const Vector3 &normal, Random &random,
+                                     uint64_t &rays) const
+    {
+        Vector3 result;
+        Vector3 throughput(1.0f, 1.0f, 1.0f);
+        Vector3 point = position;
+        Vector3 surfaceNormal = normal;
+
+        for (uint32_t bounce = 0;; bounce++) {
+            result += throughput * GetDirectLight(point, surfaceNormal, rays);
+            if (bounce == m_settings.maxBounces)
+                break;
+
+            // 코사인 가중 반구 샘플: 평균이 곧 sum(들어오는 빛 * cos) / pi
+            const float u1 = random.Next(), u2 = random.Next();
+            const float r = sqrtf(u1), phi = 2.0f * kPi * u2;
+            Vector3 tangent, bitangent;
+            MakeBasis(surfaceNormal, tangent, bitangent);
+            const Vector3 direction = tangent * (r * cosf(phi)) + bitangent * (r * sinf(phi)) +
+                                      surfaceNormal * sqrtf(max(0.0f, 1.0f - u1));
+
+            const Vector3 origin = point + surfaceNormal * m_settings.rayBias;
+            RayHit hit;
+            rays++;
+            if (!m_bvh.Intersect(origin, direction, 0.0f, INFINITY, hit)) {
+                result += throughput * m_settings.skyColor;
+                break;
+            }
+
+            // 뒷면에 맞으면 물체 안쪽이므로 빛이 없음 (바닥에 놓인 상자 밑 같은 곳)
+            const Vector3 &hitNormal = m_triangleNormals[hit.triangle];
+            if (hitNormal.Dot(direction) >= 0.0f)
+                break;
+
+            const Vector3 *colors = &m_triangleColors[size_t(hit.triangle) * 3];
+            const Vector3 albedo = colors[0] * (1.0f - hit.u - hit.v) + colors[1] * hit.u + colors[2] * hit.v;
+            throughput = throughput * albedo;
+            point = origin + direction * hit.t;
+            surfaceNormal = hitNormal;
+
+            // 러시안 룰렛: 두 번째로 튕긴 곳부터 (bounce는 0부터 셈) 기여가 작은 경로를 확률적으로 끊고
+            // 살아남은 경로의 가중치를 올림
+            if (bounce >= 1) {
+                const float survive = min(0.95f, max({throughput.x, throughput.y, throughput.z}));
+                if (random.Next() >= survive)
+                    break;
+                throughput = throughput / survive;
+            }
+        }
+        return result;
+    }
+
+    Vector3 LightmapBaker::GetDirectLight(const Vector3 &position, const Vector3 &normal, uint64_t &rays) const
+    {
+        const Vector3 origin = position + normal * m_settings.rayBias;
+        Vector3 result;
+
+        for (const Light &light : m_lights) {
+            Vector3 toLight = light.position - position;
+            const float distanceSq = toLight.Dot(toLight);
+            const float radiusSq = light.radius * light.radius;
+            if (distanceSq >= radiusSq || distanceSq <= 0.0f)
+                continue;
+            const float distance = sqrtf(distanceSq);
+            toLight = toLight / distance;
+            const float nDotL = normal.Dot(toLight);
+            if (nDotL <= 0.0f)
+                continue;
+
+            const float window = 1.0f - distanceSq / radiusSq;
+            const float spot = SmoothStep(light.spotCosOuter, light.spotCosInner, -toLight.Dot(light.direction));
+            const float attenuation = nDotL * window * window * spot;
+            if (attenuation <= 1e-4f)
+                continue;
+            rays++;
+            if (!m_bvh.IsOccluded(origin, toLight, 0.0f, distance - m_settings.rayBias))
+                result += light.color * attenuation;
+        }
+
+        if (m_settings.sunColor.LengthSquared() > 0.0f) {
+            Vector3 toSun = -m_settings.sunDirection;
+            toSun.Normalize();
+            const float nDotL = normal.Dot(toSun);
+            if (nDotL > 0.0f) {
+                rays++;
+                if (!m_bvh.IsOccluded(origin, toSun, 0.0f, INFINITY))
+                    result += m_settings.sunColor * nDotL;
+            }
+        }
+        return result;
+    }
+
+    void LightmapBaker::Resolve(vector<uint8_t> &rgba) const
+    {
+        const uint32_t width = m_settings.width, height = m_settings.height;
+        const size_t pixelCount = size_t(width) * height;
+        rgba.assign(pixelCount * 4, 0);
+
+        vector<Vector3> colors(pixelCount);
+        vector<uint8_t> filled(pixelCount, 0);
+        const float scale = m_stats.samplesPerTexel > 0 ? 1.0f / float(m_stats.samplesPerTexel) : 0.0f;
+        for (size_t texel = 0; texel < m_texelPixels.size(); texel++) {
+            colors[m_texelPixels[texel]] = m_accumulated[texel] * scale;
+            filled[m_texelPixels[texel]] = 1;
+        }
+
+        // 차트 둘레의 빈 텍셀을 이웃 평균으로 padding번 채움 (쌍선형 필터와 밉이 검은 테두리를 읽지 않게)
+        vector<pair<uint32_t, Vector3>> grown;
+        for (uint32_t pass = 0; pass < m_settings.padding; pass++) {
+            grown.clear();
+            for (uint32_t y = 0; y < height; y++) {
+                for (uint32_t x = 0; x < width; x++) {
+                    const size_t pixel = size_t(y) * width + x;
+                    if (filled[pixel])
+                        continue;
+                    Vector3 sum;
+                    uint32_t count = 0;
+                    for (uint32_t ny = y > 0 ? y - 1 : 0; ny <= min(y + 1, height - 1); ny++) {
+                        for (uint32_t nx = x > 0 ? x - 1 : 0; nx <= min(x + 1, width - 1); nx++) {
+                            const size_t neighbour = size_t(ny) * width + nx;
+                            if (filled[neighbour]) {
+                                sum += colors[neighbour];
+                                count++;
+                            }
+                        }
+                    }
+                    if (count > 0)
+                        grown.push_back({uint32_t(pixel), sum / float(count)});
+                }
+            }
+            for (const auto &[pixel, color] : grown) {
+                colors[pixel] = color;
+                filled[pixel] = 1;
+            }
+        }
+
+        for (size_t pixel = 0; pixel < pixelCount; pixel++) {
+            if (!filled[pixel])
+                continue;
+            uint8_t *p = &rgba[pixel * 4];
+            p[0] = EncodeSrgb(colors[pixel].x);
+            p[1] = EncodeSrgb(colors[pixel].y);
+            p[2] = EncodeSrgb(colors[pixel].z);
+            p[3] = 255;
+        }
+    }
+
+    void LightmapBaker::Export(const TextureImportSettings &settings, TextureAsset &out, JobSystem &jobSystem,
+                               TextureImportStats *stats) const
+    {
+        vector<uint8_t> rgba;
+        Resolve(rgba);
+        ImportTexture(m_settings.width, m_settings.height, rgba.data(), settings, out, jobSystem, stats);
+    }
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <directxtk/SimpleMath.h>
+#include <vector>
+
+#include "ClusteredLighting.h"
+#include "JobSystem.h"
+#include "MeshGenerator.h"
+#include "TexturePipeline.h"
+#include "TriangleBvh.h"
+
+namespace luke {
+
+    using DirectX::SimpleMath::Matrix;
+    using DirectX::SimpleMath::Vector2;
+    using DirectX::SimpleMath::Vector3;
+
+    struct LightmapSettings {
+        uint32_t width = 1024;
+        uint32_t height = 1024;
+        float texelsPerUnit = 16.0f; // 시작 밀도. 아틀라스에 다 안 들어가면 줄여 가며 다시 배치
+        uint32_t padding = 2;        // 차트 둘레의 빈 텍셀 (필터링/밉에서 옆 차트가 번지지 않게)
+        float chartAngle = 0.35f;    // 차트에 넣을 이웃 삼각형의 법선이 첫 삼각형과 이루는 최대 각 (라디안)
+        uint32_t tileSize = 16;      // 작업 하나가 맡는 아틀라스 타일 한 변 (텍셀)
+        uint32_t maxBounces = 3;     // 간접광 튕김 수 (0이면 직접광 + 하늘만)
+        float rayBias = 1e-3f;       // 광선 시작점을 법선 방향으로 띄우는 거리
+        Vector3 skyColor{0.35f, 0.4f, 0.5f}; // 막히지 않은 광선이 받는 빛 (ShadeClustered의 ambient와 같은 뜻)
+        Vector3 sunDirection{-0.4f, -1.0f, 0.3f}; // 햇빛이 향하는 방향
+        Vector3 sunColor;                         // 0이면 해 없음
+    };
+
+    struct LightmapStats {
+        uint32_t meshCount = 0;
+        uint32_t triangleCount = 0;
+        uint32_t chartCount = 0;
+        uint32_t coveredTexels = 0; // 표면에 대응하는 텍셀 (굽는 텍셀)
+        uint32_t tileCount = 0;     // 굽는 텍셀이 있는 타일
+        float texelsPerUnit = 0.0f; // 배치에 실제로 쓴 밀도
+        uint32_t packAttempts = 0;
+        double chartMs = 0.0;       // 차트 + 배치 + 텍셀 래스터화
+        BvhStats bvh;
+
+        // BakePass() 누적
+        uint32_t samplesPerTexel = 0;
+        uint64_t rays = 0;          // 경로 광선 + 그림자 광선
+        double bakeMs = 0.0;
+        uint32_t threadCount = 0;   // 마지막 BakePass()의 스레드 수 (호출한 스레드 포함)
+
+        double GetRaysPerSecondPerCore() const
+        {
+            return bakeMs > 0.0 && threadCount > 0 ? rays / (bakeMs * 0.001) / threadCount : 0.0;
+        }
+    };
+
+    // 차트 경계에서 정점을 나눈 메쉬의 라이트맵 UV
+    // 정점 i는 원본 정점 sourceVertices[i]에 UV uvs[i]를 붙인 것이고, indices는 원본과 같은 순서의 삼각형
+    struct LightmapMeshUvs {
+        std::vector<uint32_t> sourceVertices;
+        std::vector<Vector2> uvs; // [0, 1] 아틀라스 좌표
+        std::vector<uint16_t> indices;
+    };
+
+    // 정적 장면의 빛을 CPU 경로 추적으로 라이트맵에 굽습니다.
+    //   1. Prepare(): 메쉬마다 법선이 비슷한 이웃 삼각형을 모아 차트로 나누고, 차트 평면에 펼쳐서 아틀라스에
+    //      선반(shelf) 방식으로 배치한 뒤 텍셀마다 표면 위치/법선을 래스터화합니다. 모든 삼각형으로 BVH를 만듦
+    //   2. BakePass(): 텍셀마다 경로를 samples개씩 더 추적해서 누적 (점진적. 사이사이에 Resolve()로 결과를 볼 수 있음)
+    //      아틀라스를 타일로 나눠 작업 풀에 맡기고, 난수는 (텍셀, 샘플 번호)로 정하므로 스레드 수와 상관없이 같은 결과
+    //   3. Resolve()/Export(): 평균을 sRGB RGBA8로 바꾸고 차트 밖 텍셀을 채운 뒤 TexturePipeline으로 압축
+    // 텍셀 값은 들어오는 빛(하늘 + 광원 + 튕긴 빛)이라 쓰는 쪽에서 albedo(정점 색)를 곱합니다.
+    // 광원 감쇠는 ShadeClustered와 같은 식을 쓰고 그림자 광선으로 가림을 확인합니다.
+    class LightmapBaker {
+    public:
+        // 메쉬 번호를 반환. Prepare() 전에 추가
+        uint32_t AddMesh(const MeshData &mesh, const Matrix &world);
+        void AddLight(const Light &light) { m_lights.push_back(light); }
+
+        // 차트가 아틀라스에 들어가지 않거나 차트로 나눈 정점이 16비트를 넘으면 false
+        bool Prepare(const LightmapSettings &settings);
+        void BakePass(uint32_t samplesPerTexel, JobSystem &jobSystem);
+
+        // 행 우선 RGBA8 (sRGB). 알파는 차트 안(과 채운 가장자리)이면 255
+        void Resolve(std::vector<uint8_t> &rgba) const;
+        void Export(const TextureImportSettings &settings, TextureAsset &out, JobSystem &jobSystem,
+                    TextureImportStats *stats = nullptr) const;
+
+        const LightmapMeshUvs &GetMeshUvs(uint32_t mesh) const { return m_meshUvs[mesh]; }
+        const LightmapStats &GetStats() const { return m_stats; }
+        uint32_t GetWidth() const { return m_settings.width; }
+        uint32_t GetHeight() const { return m_settings.height; }
+
+    private:
+        struct SourceMesh {
+            std::vector<Vector3> positions; // 월드 공간
+            std::vector<Vector3> normals;
+            std::vector<Vector3> colors;
+            std::vector<uint16_t> indices;
+            uint32_t firstTriangle = 0; // m_triangle*에서 이 메쉬의 첫 삼각형
+        };
+
+        struct Chart {
+            uint32_t mesh;
+            std::vector<uint32_t> triangles; // 메쉬 안의 삼각형 번호
+            Vector3 tangent;                 // 차트 평면의 축 (월드 단위)
+            Vector3 bitangent;
+            Vector2 planeMin;                // 평면 좌표의 최소값
+            Vector2 planeSize;
+            float scale = 1.0f;              // 큰 차트는 아틀라스 한 변에 맞게 따로 줄임
+            uint32_t width = 0;              // 패딩을 포함한 텍셀 크기
+            uint32_t height = 0;
+            uint32_t x = 0;                  // 아틀라스 위치
+            uint32_t y = 0;
+        };
+
+        struct Tile {
+            uint32_t first; // m_texel*[first, first + count)
+            uint32_t count;
+        };
+
+        // 한 스레드가 경로를 추적할 때 쓰는 난수 (PCG 해시)
+        struct Random {
+            uint32_t state;
+
+            float Next();
+        };
+
+        void BuildCharts(uint32_t mesh);
+        // settings 크기의 아틀라스에 charts를 선반 방식으로 배치 (위치와 scale을 charts에 씀)
+        static bool PackCharts(const LightmapSettings &settings, float texelsPerUnit, std::vector<Chart> &charts,
+                               LightmapStats &stats);
+        // texelsPerUnit로 모든 차트가 들어가는 가장 작은 정사각형 아틀라스 한 변 (16384까지 안 되면 0)
+        uint32_t FindMinimumAtlasSize(float texelsPerUnit) const;
+        Vector2 GetChartTexel(const Chart &chart, const Vector3 &position) const;
+        void RasterizeCharts();
+        void BuildUvs();
+
+        Vector3 TracePath(const Vector3 &position, const Vector3 &normal, Random &random, uint64_t &rays) const;
+        Vector3 GetDirectLight(const Vector3 &position, const Vector3 &normal, uint64_t &rays) const;
+
+        LightmapSettings m_settings;
+        std::vector<SourceMesh> m_meshes;
+        std::vector<Light> m_lights;
+        std::vector<Chart> m_charts;
+        std::vector<LightmapMeshUvs> m_meshUvs;
+
+        // 모든 메쉬의 삼각형 (BVH 순서가 아니라 추가한 순서)
+        std::vector<Vector3> m_trianglePositions; // 삼각형마다 3개
+        std::vector<Vector3> m_triangleColors;    // 삼각형마다 3개
+        std::vector<Vector3> m_triangleNormals;   // 면 법선
+        TriangleBvh m_bvh;
+
+        // 굽는 텍셀 (타일 순서)
+        std::vector<Vector3> m_texelPositions;
+        std::vector<Vector3> m_texelNormals;
+        std::vector<uint32_t> m_texelPixels; // y * width + x
+        std::vector<Vector3> m_accumulated;  // 샘플 합
+        std::vector<Tile> m_tiles;
+
+        LightmapStats m_stats;
+    };
+}
@@ -0,0 +1,167 @@
+#include "Memory.h"
+
+#include <algorithm>
+#include <new>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        size_t AlignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    const char *GetMemoryCategoryName(MemoryCategory category)
+    {
+        switch (category) {
+        case MemoryCategory::FrameArena:
+            return "FrameArena";
+        case MemoryCategory::Geometry:
+            return "Geometry";
+        case MemoryCategory::MeshPool:
+            return "MeshPool";
+        case MemoryCategory::Resources:
+            return "Resources";
+        default:
+            return "Unknown";
+        }
+    }
+
+    MemoryTracker::Counter MemoryTracker::s_counters[size_t(MemoryCategory::Count)];
+
+    void MemoryTracker::OnAllocate(MemoryCategory category, size_t bytes)
+    {
+        Counter &counter = s_counters[size_t(category)];
+        const size_t current = counter.current.fetch_add(bytes) + bytes;
+        counter.allocations.fetch_add(1, memory_order_relaxed);
+
+        size_t peak = counter.peak.load();
+        while (current > peak && !counter.peak.compare_exchange_weak(peak, current)) {
+        }
+    }
+
+    void MemoryTracker::OnFree(MemoryCategory category, size_t bytes)
+    {
+        s_counters[size_t(category)].current.fetch_sub(bytes);
+    }
+
+    size_t MemoryTracker::GetCurrentBytes(MemoryCategory category)
+    {
+        return s_counters[size_t(category)].current.load();
+    }
+
+    size_t MemoryTracker::GetPeakBytes(MemoryCategory category)
+    {
+        return s_counters[size_t(category)].peak.load();
+    }
+
+    uint64_t MemoryTracker::GetAllocationCount(MemoryCategory category)
+    {
+        return s_counters[size_t(category)].allocations.load();
+    }
+
+    TrackingResource::TrackingResource(MemoryCategory category, pmr::memory_resource *upstream)
+        : m_category(category), m_upstream(upstream)
+    {
+    }
+
+    void *TrackingResource::do_allocate(size_t bytes, size_t alignment)
+    {
+        void *p = m_upstream->allocate(bytes, alignment);
+        MemoryTracker::OnAllocate(m_category, bytes);
+        return p;
+    }
+
+    void TrackingResource::do_deallocate(void *p, size_t bytes, size_t alignment)
+    {
+        m_upstream->deallocate(p, bytes, alignment);
+        MemoryTracker::OnFree(m_category, bytes);
+    }
+
+    bool TrackingResource::do_is_equal(const pmr::memory_resource &other) const noexcept
+    {
+        return this == &other;
+    }
+
+    LinearArena::LinearArena(size_t capacity, MemoryCategory category) : m_category(category)
+    {
+        AddBlock(capacity);
+    }
+
+    LinearArena::~LinearArena() { FreeBlocks(); }
+
+    void LinearArena::Reset()
+    {
+        // 지난 프레임에 블록이 추가됐다면 전체 크기의 블록 하나로 다시 만들어서
+        // 다음 프레임부터는 추가 할당이 일어나지 않도록 합니다.
+        if (m_blocks.size() > 1) {
+            const size_t total = m_capacity;
+            FreeBlocks();
+            AddBlock(total);
+        }
+
+        m_offset = 0;
+        m_usedBytes = 0;
+    }
+
+    void *LinearArena::do_allocate(size_t bytes, size_t alignment)
+    {
+        // 블록 시작 주소가 alignment보다 덜 정렬돼 있을 수 있으므로 주소 기준으로 정렬
+        auto alignedOffset = [&]() {
+            const uintptr_t base = reinterpret_cast<uintptr_t>(m_blocks.back().data);
+            return AlignUp(base + m_offset, alignment) - base;
+        };
+
+        size_t offset = alignedOffset();
+        if (offset + bytes > m_blocks.back().size) {
+            AddBlock(max(bytes + alignment, m_blocks.back().size));
+            offset = alignedOffset();
+        }
+
+        void *p = m_blocks.back().data + offset;
+        m_offset = offset + bytes;
+        m_usedBytes += bytes;
+        m_peakBytes = max(m_peakBytes, m_usedBytes);
+        return p;
+    }
+
+    bool LinearArena::do_is_equal(const pmr::memory_resource &other) const noexcept
+    {
+        return this == &other;
+    }
+
+    void LinearArena::AddBlock(size_t minSize)
+    {
+        Block block;
+        block.size = minSize;
+        block.data = static_cast<byte *>(::operator new(block.size, align_val_t(alignof(max_align_t))));
+        m_blocks.push_back(block);
+        m_offset = 0;
+        m_capacity += block.size;
+        MemoryTracker::OnAllocate(m_category, block.size);
+    }
+
+    void LinearArena::FreeBlocks()
+    {
+        for (const Block &block : m_blocks) {
+            ::operator delete(block.data, align_val_t(alignof(max_align_t)));
+            MemoryTracker::OnFree(m_category, block.size);
+        }
+        m_blocks.clear();
+        m_capacity = 0;
+    }
+
+    pmr::memory_resource *GetGeometryResource()
+    {
+        static TrackingResource resource(MemoryCategory::Geometry);
+        return &resource;
+    }
+
+    pmr::memory_resource *GetResourceMemory()
+    {
+        static TrackingResource resource(MemoryCategory::Resources);
+        return &resource;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace luke {
+
+    // 메모리 사용량을 나눠서 볼 분류
+    enum class MemoryCategory : uint32_t {
+        FrameArena, // 프레임마다 리셋되는 임시 메모리
+        Geometry,   // MeshData (버텍스/인덱스)
+        MeshPool,   // ObjectPool 기본 분류
+        Resources,  // ResourceRegistry의 메쉬/버퍼/쉐이더 배열
+        Count
+    };
+
+    const char *GetMemoryCategoryName(MemoryCategory category);
+
+    // 분류별 현재 사용량과 최대(peak) 사용량
+    // 여러 스레드에서 호출될 수 있으므로 atomic으로 관리합니다.
+    class MemoryTracker {
+    public:
+        static void OnAllocate(MemoryCategory category, size_t bytes);
+        static void OnFree(MemoryCategory category, size_t bytes);
+
+        static size_t GetCurrentBytes(MemoryCategory category);
+        static size_t GetPeakBytes(MemoryCategory category);
+        static uint64_t GetAllocationCount(MemoryCategory category);
+
+    private:
+        struct Counter {
+            std::atomic<size_t> current{0};
+            std::atomic<size_t> peak{0};
+            std::atomic<uint64_t> allocations{0};
+        };
+        static Counter s_counters[size_t(MemoryCategory::Count)];
+    };
+
+    // upstream에서 할당하면서 MemoryTracker에 기록만 하는 memory_resource
+    class TrackingResource : public std::pmr::memory_resource {
+    public:
+        TrackingResource(MemoryCategory category,
+                         std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+        MemoryCategory m_category;
+        std::pmr::memory_resource *m_upstream;
+    };
+
+    // 포인터만 앞으로 밀어서 할당하는 선형(linear) 할당자
+    // 개별 해제는 하지 않고 Reset()으로 한꺼번에 비웁니다.
+    // 처음 블록이 부족하면 블록을 추가하고, 다음 Reset()에서 하나의 큰 블록으로 합칩니다.
+    // 주의: 스레드 안전하지 않습니다. 메인(렌더) 스레드에서만 사용하세요.
+    class LinearArena : public std::pmr::memory_resource {
+    public:
+        explicit LinearArena(size_t capacity, MemoryCategory category = MemoryCategory::FrameArena);
+        ~LinearArena() override;
+
+        LinearArena(const LinearArena &) = delete;
+        LinearArena &operator=(const LinearArena &) = delete;
+
+        void Reset();
+
+        size_t GetUsedBytes() const { return m_usedBytes; }
+        size_t GetPeakBytes() const { return m_peakBytes; }
+        size_t GetCapacity() const { return m_capacity; }
+
+    private:
+        struct Block {
+            std::byte *data;
+            size_t size;
+        };
+
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+
+        void AddBlock(size_t minSize);
+        void FreeBlocks();
+
+        std::vector<Block> m_blocks;
+        size_t m_offset = 0; // 마지막 블록 안에서의 위치
+        size_t m_capacity = 0;
+        size_t m_usedBytes = 0;
+        size_t m_peakBytes = 0;
+        MemoryCategory m_category;
+    };
+
+    // MeshGenerator 등에서 기본으로 사용하는, 기록이 남는 Geometry 메모리
+    std::pmr::memory_resource *GetGeometryResource();
+
+    // HandlePool이 기본으로 사용하는, 기록이 남는 Resources 메모리
+    std::pmr::memory_resource *GetResourceMemory();
+}
@@ -0,0 +1,87 @@
+#include "MemoryBenchmark.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "MeshGenerator.h"
+#include "ObjectPool.h"
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        // Mesh와 같은 크기의 객체 (ComPtr 3개 + 인덱스 개수)
+        struct MeshSizedObject {
+            void *vertexBuffer = nullptr;
+            void *indexBuffer = nullptr;
+            void *constantBuffer = nullptr;
+            unsigned int indexCount = 0;
+        };
+
+        template <typename T_FUNC>
+        double MeasureMs(T_FUNC &&func)
+        {
+            const auto start = chrono::high_resolution_clock::now();
+            func();
+            return chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start)
+                .count();
+        }
+    }
+
+    AllocatorBenchmarkResult RunAllocatorBenchmark(int iterations)
+    {
+        AllocatorBenchmarkResult result;
+        result.iterations = iterations;
+
+        // 최적화로 사라지지 않도록 결과를 누적
+        size_t checksum = 0;
+
+        result.meshDataDefaultMs = MeasureMs([&] {
+            for (int i = 0; i < iterations; i++) {
+                MeshData meshData = MeshGenerator::MakeCube(pmr::new_delete_resource());
+                checksum += meshData.indices.size();
+            }
+        });
+
+        LinearArena arena(64 * 1024);
+        result.meshDataArenaMs = MeasureMs([&] {
+            for (int i = 0; i < iterations; i++) {
+                MeshData meshData = MeshGenerator::MakeCube(&arena);
+                checksum += meshData.indices.size();
+                arena.Reset(); // 프레임 끝에서 리셋하는 것과 같음
+            }
+        });
+
+        vector<shared_ptr<MeshSizedObject>> sharedObjects;
+        sharedObjects.reserve(iterations);
+        result.objectMakeSharedMs = MeasureMs([&] {
+            for (int i = 0; i < iterations; i++)
+                sharedObjects.push_back(make_shared<MeshSizedObject>());
+            checksum += sharedObjects.size();
+            sharedObjects.clear();
+        });
+
+        ObjectPool<MeshSizedObject> pool;
+        vector<MeshSizedObject *> pooledObjects;
+        pooledObjects.reserve(iterations);
+        result.objectPoolMs = MeasureMs([&] {
+            for (int i = 0; i < iterations; i++)
+                pooledObjects.push_back(pool.Create());
+            checksum += pooledObjects.size();
+            for (MeshSizedObject *object : pooledObjects)
+                pool.Destroy(object);
+            pooledObjects.clear();
+        });
+
+        cout << "Allocator benchmark (" << iterations << " iterations, checksum " << checksum
+             << ")" << endl;
+        cout << "  MeshData default " << result.meshDataDefaultMs << " ms, arena "
+             << result.meshDataArenaMs << " ms" << endl;
+        cout << "  Object make_shared " << result.objectMakeSharedMs << " ms, pool "
+             << result.objectPoolMs << " ms" << endl;
+
+        return result;
+    }
+}
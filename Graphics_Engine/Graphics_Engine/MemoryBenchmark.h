@@ -0,0 +1,16 @@
+#pragma once
+
+namespace luke {
+
+    struct AllocatorBenchmarkResult {
+        int iterations = 0;
+        double meshDataDefaultMs = 0.0;  // MakeCube() + new/delete
+        double meshDataArenaMs = 0.0;    // MakeCube() + LinearArena
+        double objectMakeSharedMs = 0.0; // std::make_shared로 객체 생성/해제
+        double objectPoolMs = 0.0;       // ObjectPool로 객체 생성/해제
+    };
+
+    // 기본 할당자와 LinearArena/ObjectPool의 비용을 비교합니다.
+    // 결과는 std::cout으로도 출력합니다.
+    AllocatorBenchmarkResult RunAllocatorBenchmark(int iterations);
+}
@@ -1,16 +1,18 @@
 #include "MeshGenerator.h"
+#include <algorithm>
 #include <iostream>
 
 namespace luke {
     using namespace std;
     using namespace DirectX;
     using namespace DirectX::SimpleMath;
-    MeshData MeshGenerator::MakeTriangle()
+    MeshData MeshGenerator::MakeTriangle(pmr::memory_resource *resource)
     {
 
-        vector<Vector3> positions;
-        vector<Vector3> colors;
-        vector<Vector3> normals;
+        // 임시 배열도 같은 메모리에서 할당 (LinearArena라면 해제 비용이 없음)
+        pmr::vector<Vector3> positions(resource);
+        pmr::vector<Vector3> colors(resource);
+        pmr::vector<Vector3> normals(resource);
 
         const float scale = 1.0f;
 
@@ -25,13 +27,14 @@ namespace luke {
         normals.push_back(Vector3(0.0f, 1.0f, 0.0f));
         normals.push_back(Vector3(0.0f, 1.0f, 0.0f));
 
-        MeshData meshData;
+        MeshData meshData(resource);
+        meshData.vertices.reserve(positions.size());
         for (size_t i = 0; i < positions.size(); i++)
         {
             Vertex v;
             v.position = positions[i];
             v.color = colors[i];
-            //v.normal = normals[i];
+            v.normal = normals[i];
             meshData.vertices.push_back(v);
         }
 
@@ -42,10 +45,10 @@ namespace luke {
         return meshData;
     }
 
-    MeshData MeshGenerator::MakeSquare() {
-        vector<Vector3> positions;
-        vector<Vector3> colors;
-        vector<Vector3> normals;
+    MeshData MeshGenerator::MakeSquare(pmr::memory_resource *resource) {
+        pmr::vector<Vector3> positions(resource);
+        pmr::vector<Vector3> colors(resource);
+        pmr::vector<Vector3> normals(resource);
 
         const float scale = 0.5f;
 
@@ -62,13 +65,14 @@ namespace luke {
         normals.push_back(Vector3(0.0f, 0.0f, -1.0f));
         normals.push_back(Vector3(0.0f, 0.0f, -1.0f));
 
-        MeshData meshData;
+        MeshData meshData(resource);
+        meshData.vertices.reserve(positions.size());
 
         for (size_t i = 0; i < positions.size(); i++) {
             Vertex v;
             v.position = positions[i];
             v.color = colors[i];
-            // v.normals = normals[i];
+            v.normal = normals[i];
 
             meshData.vertices.push_back(v);
         }
@@ -78,11 +82,11 @@ namespace luke {
 
         return meshData;
     }
-    MeshData MeshGenerator::MakeCube() {
+    MeshData MeshGenerator::MakeCube(pmr::memory_resource *resource) {
 
-        vector<Vector3> positions;
-        vector<Vector3> colors;
-        vector<Vector3> normals;
+        pmr::vector<Vector3> positions(resource);
+        pmr::vector<Vector3> colors(resource);
+        pmr::vector<Vector3> normals(resource);
 
         const float scale = 1.0f;
 
@@ -170,11 +174,13 @@ namespace luke {
         normals.push_back(Vector3(1.0f, 0.0f, 0.0f));
         normals.push_back(Vector3(1.0f, 0.0f, 0.0f));
 
-        MeshData meshData;
+        MeshData meshData(resource);
+        meshData.vertices.reserve(positions.size());
         for (size_t i = 0; i < positions.size(); i++) {
             Vertex v;
             v.position = positions[i];
             v.color = colors[i];
+            v.normal = normals[i];
             meshData.vertices.push_back(v);
         }
 
@@ -189,4 +195,51 @@ namespace luke {
 
         return meshData;
     }
+
+    MeshData MeshGenerator::MakeWorldCell(const Vector3 &center, float cellSize, uint32_t cubeCount,
+                                          uint32_t seed, pmr::memory_resource *resource)
+    {
+        cubeCount = min(cubeCount, kMaxCellCubes);
+        const MeshData cube = MakeCube(resource);
+
+        MeshData meshData(resource);
+        meshData.vertices.reserve(4 + cube.vertices.size() * cubeCount);
+        meshData.indices.reserve(6 + cube.indices.size() * cubeCount);
+
+        // 바닥
+        const float half = 0.5f * cellSize;
+        const Vector3 groundColor(0.3f, 0.35f, 0.3f);
+        const Vector3 up(0.0f, 1.0f, 0.0f);
+        meshData.vertices.push_back({center + Vector3(-half, 0.0f, -half), groundColor, up});
+        meshData.vertices.push_back({center + Vector3(-half, 0.0f, half), groundColor, up});
+        meshData.vertices.push_back({center + Vector3(half, 0.0f, half), groundColor, up});
+        meshData.vertices.push_back({center + Vector3(half, 0.0f, -half), groundColor, up});
+        meshData.indices.insert(meshData.indices.end(), {0, 1, 2, 0, 2, 3});
+
+        // xorshift (셀마다 같은 배치가 나오도록 rand() 대신 씀)
+        uint32_t state = seed * 2654435761u + 1u;
+        auto random = [&]() {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return float(state & 0xFFFFFF) / float(0x1000000);
+        };
+
+        for (uint32_t i = 0; i < cubeCount; i++) {
+            const float size = 0.1f + 0.4f * random();
+            const float height = size * (1.0f + 4.0f * random());
+            const Vector3 position(center.x + (random() - 0.5f) * (cellSize - 2.0f * size), height,
+                                   center.z + (random() - 0.5f) * (cellSize - 2.0f * size));
+            const Vector3 scale(size, height, size);
+
+            // 축에 나란한 스케일이므로 법선은 그대로
+            const uint16_t base = uint16_t(meshData.vertices.size());
+            for (const Vertex &vertex : cube.vertices)
+                meshData.vertices.push_back({position + vertex.position * scale, vertex.color, vertex.normal});
+            for (uint16_t index : cube.indices)
+                meshData.indices.push_back(uint16_t(base + index));
+        }
+
+        return meshData;
+    }
 }
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <directxtk/SimpleMath.h>
+#include <memory_resource>
 #include <vector>
 
+#include "Memory.h"
+
 namespace luke {
 
     using DirectX::SimpleMath::Vector2;
@@ -11,17 +14,41 @@ namespace luke {
     struct Vertex {
         Vector3 position;
         Vector3 color;
+        Vector3 normal;
     };
 
+    // 버텍스/인덱스는 memory_resource에서 할당합니다.
+    // 기본값은 사용량이 기록되는 Geometry 메모리이고,
+    // 한 프레임만 쓰는 데이터라면 LinearArena를 넘겨서 만들 수 있습니다.
     struct MeshData {
-        std::vector<Vertex> vertices;
-        std::vector<uint16_t> indices;
+        explicit MeshData(std::pmr::memory_resource *resource = GetGeometryResource())
+            : vertices(resource), indices(resource)
+        {
+        }
+
+        // pmr 컨테이너의 복사는 할당자를 따라가지 않고 기본 리소스를 쓰므로 (아레나와 메모리 기록에서 빠짐)
+        // 복사는 막고 이동만 허용. 이동한 쪽도 원래 리소스를 그대로 씀
+        MeshData(const MeshData &) = delete;
+        MeshData &operator=(const MeshData &) = delete;
+        MeshData(MeshData &&) = default;
+        MeshData &operator=(MeshData &&) = default;
+
+        std::pmr::vector<Vertex> vertices;
+        std::pmr::vector<uint16_t> indices;
     };
 
     class MeshGenerator {
     public:
-        static MeshData MakeTriangle();
-        static MeshData MakeSquare();
-        static MeshData MakeCube();
+        static MeshData MakeTriangle(std::pmr::memory_resource *resource = GetGeometryResource());
+        static MeshData MakeSquare(std::pmr::memory_resource *resource = GetGeometryResource());
+        static MeshData MakeCube(std::pmr::memory_resource *resource = GetGeometryResource());
+
+        // 스트리밍 월드의 셀 하나: center를 중심으로 한 변이 cellSize인 바닥 위에
+        // 크기/높이가 다른 큐브 cubeCount개를 월드 좌표로 합친 메쉬 (seed가 같으면 같은 결과)
+        // 16비트 인덱스이므로 cubeCount는 최대 kMaxCellCubes개
+        static constexpr uint32_t kMaxCellCubes = 2700;
+        static MeshData MakeWorldCell(const Vector3 &center, float cellSize, uint32_t cubeCount,
+                                      uint32_t seed,
+                                      std::pmr::memory_resource *resource = GetGeometryResource());
     };
 }
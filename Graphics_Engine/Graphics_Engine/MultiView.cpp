@@ -0,0 +1,128 @@
+#include "MultiView.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace luke {
+    using namespace std;
+    using namespace DirectX;
+
+    namespace {
+        constexpr size_t kCullGrainSize = 4096;
+        constexpr uint32_t kFrustumCorners = 8; // BoundingFrustum::GetCorners()
+
+        // 뷰 수별 격자 (열, 행)
+        constexpr uint32_t kGridColumns[kMaxViews + 1] = {1, 1, 2, 2, 2, 3, 3, 3, 3};
+        constexpr uint32_t kGridRows[kMaxViews + 1] = {1, 1, 1, 2, 2, 2, 2, 3, 3};
+    }
+
+    void LayoutViewGrid(uint32_t viewCount, RenderView *views)
+    {
+        viewCount = min(viewCount, kMaxViews);
+        const uint32_t columns = kGridColumns[viewCount];
+        const uint32_t rows = kGridRows[viewCount];
+        for (uint32_t v = 0; v < viewCount; v++) {
+            views[v].width = 1.0f / columns;
+            views[v].height = 1.0f / rows;
+            views[v].x = (v % columns) * views[v].width;
+            views[v].y = (v / columns) * views[v].height;
+        }
+    }
+
+    void MultiViewCuller::Cull(span<const RenderView> views, span<const BoundingBox> bounds,
+                               vector<ViewMask> &masks, JobSystem &jobSystem, bool frustumCulling)
+    {
+        using Clock = chrono::high_resolution_clock;
+        const auto start = Clock::now();
+
+        const uint32_t viewCount = uint32_t(min<size_t>(views.size(), kMaxViews));
+        const size_t count = bounds.size();
+        masks.resize(count);
+
+        m_stats.viewCount = viewCount;
+        m_stats.testedObjects = uint32_t(count);
+        m_stats.unionRejected = 0;
+
+        const ViewMask allViews = ViewMask((1u << viewCount) - 1);
+        if (!frustumCulling || viewCount == 0) {
+            fill(masks.begin(), masks.end(), viewCount ? allViews : ViewMask(0));
+            m_stats.visibleObjects = viewCount ? uint32_t(count) : 0;
+            m_stats.cullMs = chrono::duration<float, milli>(Clock::now() - start).count();
+            return;
+        }
+
+        // 월드 공간 절두체와 그 꼭짓점을 모두 감싸는 박스
+        BoundingFrustum frusta[kMaxViews];
+        XMFLOAT3 corners[kMaxViews * kFrustumCorners];
+        for (uint32_t v = 0; v < viewCount; v++) {
+            BoundingFrustum frustum(views[v].projection);
+            frustum.Transform(frusta[v], views[v].view.Invert());
+            frusta[v].GetCorners(&corners[v * kFrustumCorners]);
+        }
+        BoundingBox unionBox;
+        BoundingBox::CreateFromPoints(unionBox, viewCount * kFrustumCorners, corners,
+                                      sizeof(XMFLOAT3));
+
+        atomic<uint32_t> rejected{0};
+        atomic<uint32_t> visible{0};
+        jobSystem.ParallelFor(count, kCullGrainSize, [&](size_t begin, size_t end) {
+            uint32_t localRejected = 0;
+            uint32_t localVisible = 0;
+            for (size_t i = begin; i < end; i++) {
+                const BoundingBox &box = bounds[i];
+                if (!unionBox.Intersects(box)) {
+                    masks[i] = 0;
+                    localRejected++;
+                    continue;
+                }
+                ViewMask mask = 0;
+                for (uint32_t v = 0; v < viewCount; v++)
+                    mask |= frusta[v].Intersects(box) ? ViewMask(1u << v) : ViewMask(0);
+                masks[i] = mask;
+                localVisible += mask != 0;
+            }
+            rejected.fetch_add(localRejected, memory_order_relaxed);
+            visible.fetch_add(localVisible, memory_order_relaxed);
+        });
+
+        m_stats.unionRejected = rejected.load();
+        m_stats.visibleObjects = visible.load();
+        m_stats.cullMs = chrono::duration<float, milli>(Clock::now() - start).count();
+    }
+
+    void MultiViewCuller::BuildDrawLists(span<const ViewMask> masks, uint32_t viewCount,
+                                         JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+        const auto start = Clock::now();
+
+        viewCount = min(viewCount, kMaxViews);
+        const size_t count = masks.size();
+        for (uint32_t v = 0; v < viewCount; v++) {
+            // 최대 크기로 한 번 잡아두면 프레임마다 할당하지 않음
+            if (m_drawLists[v].capacity() < count)
+                m_drawLists[v].reserve(count);
+        }
+
+        // 뷰마다 하나의 작업: 마스크를 훑어서 자기 비트가 켜진 물체만 모음
+        jobSystem.ParallelFor(viewCount, 1, [&](size_t begin, size_t end) {
+            for (size_t v = begin; v < end; v++) {
+                const ViewMask bit = ViewMask(1u << v);
+                vector<uint32_t> &list = m_drawLists[v];
+                list.clear();
+                for (size_t i = 0; i < count; i++) {
+                    if (masks[i] & bit)
+                        list.push_back(uint32_t(i));
+                }
+                m_stats.drawCount[v] = uint32_t(list.size());
+            }
+        });
+        for (uint32_t v = viewCount; v < kMaxViews; v++) {
+            m_drawLists[v].clear();
+            m_stats.drawCount[v] = 0;
+        }
+
+        m_stats.buildMs = chrono::duration<float, milli>(Clock::now() - start).count();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <directxtk/SimpleMath.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "JobSystem.h"
+
+namespace luke {
+
+    using DirectX::BoundingBox;
+    using DirectX::SimpleMath::Matrix;
+
+    constexpr uint32_t kMaxViews = 8;
+    using ViewMask = uint8_t; // 비트 v가 켜져 있으면 뷰 v에서 보임
+
+    // 카메라 하나와 화면에서의 영역
+    struct RenderView {
+        Matrix view;
+        Matrix projection;
+        // 화면 크기에 대한 비율 [0, 1]. 크기가 바뀌어도 다시 계산할 필요 없음
+        float x = 0.0f;
+        float y = 0.0f;
+        float width = 1.0f;
+        float height = 1.0f;
+    };
+
+    // viewCount개 뷰를 화면에 격자로 배치 (1, 2x1, 2x2, 3x2, 3x3에서 앞쪽 8칸)
+    void LayoutViewGrid(uint32_t viewCount, RenderView *views);
+
+    struct MultiViewStats {
+        uint32_t viewCount = 0;
+        uint32_t testedObjects = 0;
+        uint32_t unionRejected = 0; // 모든 절두체를 감싸는 박스 밖이라 뷰별 검사 없이 버린 물체
+        uint32_t visibleObjects = 0; // 한 뷰 이상에서 보이는 물체
+        uint32_t drawCount[kMaxViews] = {};
+        float cullMs = 0.0f;
+        float buildMs = 0.0f;
+    };
+
+    // 여러 뷰의 컬링을 물체 배열 한 번 순회로 끝냅니다.
+    // 모든 절두체의 꼭짓점을 감싸는 박스로 먼저 거르고, 남은 물체만 뷰별 절두체와 비교해서
+    // 물체마다 ViewMask 하나를 남깁니다. 뷰별 그리기 목록은 뷰마다 병렬로 만듭니다.
+    // 물체별 작업(월드 행렬 등)은 마스크가 0이 아닌 물체에 대해 한 번만 하고 모든 뷰가 같이 쓰면 됩니다.
+    class MultiViewCuller {
+    public:
+        // frustumCulling == false이면 모든 물체가 모든 뷰에서 보임
+        void Cull(std::span<const RenderView> views, std::span<const BoundingBox> bounds,
+                  std::vector<ViewMask> &masks, JobSystem &jobSystem, bool frustumCulling = true);
+
+        // masks에서 뷰마다 보이는 물체 인덱스(오름차순)를 뽑음
+        void BuildDrawLists(std::span<const ViewMask> masks, uint32_t viewCount, JobSystem &jobSystem);
+        const std::vector<uint32_t> &GetDrawList(uint32_t view) const { return m_drawLists[view]; }
+
+        const MultiViewStats &GetStats() const { return m_stats; }
+
+    private:
+        std::vector<uint32_t> m_drawLists[kMaxViews]; // 용량은 재사용
+        MultiViewStats m_stats;
+    };
+}
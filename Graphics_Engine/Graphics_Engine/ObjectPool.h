@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Memory.h"
+
+namespace luke {
+
+    // 같은 타입의 객체를 고정 크기 슬롯에 담는 풀
+    // 슬롯은 kChunkSize개씩 묶어서 한 번에 할당하므로 객체마다 힙 할당이 일어나지 않고
+    // 포인터는 풀이 살아있는 동안 바뀌지 않습니다.
+    // 슬롯마다 자기 청크 번호를 같이 두므로 Destroy()는 청크 수와 상관없이 O(1)입니다.
+    // 풀이 소멸될 때 남아있는 객체도 모두 소멸시킵니다.
+    template <typename T, size_t kChunkSize = 256>
+    class ObjectPool {
+    public:
+        // 소멸될 때 Destroy()로 슬롯을 돌려주는 unique_ptr. 풀보다 먼저 소멸돼야 합니다.
+        struct Deleter {
+            ObjectPool *pool = nullptr;
+            void operator()(T *object) const { pool->Destroy(object); }
+        };
+        using UniquePtr = std::unique_ptr<T, Deleter>;
+
+        explicit ObjectPool(MemoryCategory category = MemoryCategory::MeshPool)
+            : m_category(category)
+        {
+        }
+
+        ~ObjectPool()
+        {
+            for (auto &chunk : m_chunks) {
+                for (size_t i = 0; i < kChunkSize; i++) {
+                    if (chunk->alive[i])
+                        reinterpret_cast<T *>(chunk->slots[i].data)->~T();
+                }
+                MemoryTracker::OnFree(m_category, sizeof(Chunk));
+            }
+        }
+
+        ObjectPool(const ObjectPool &) = delete;
+        ObjectPool &operator=(const ObjectPool &) = delete;
+
+        template <typename... Args>
+        T *Create(Args &&...args)
+        {
+            if (m_freeList.empty())
+                AddChunk();
+
+            const SlotIndex index = m_freeList.back();
+            m_freeList.pop_back();
+
+            Chunk &chunk = *m_chunks[index.chunk];
+            T *object = new (chunk.slots[index.slot].data) T(std::forward<Args>(args)...);
+            chunk.alive[index.slot] = true;
+            m_liveCount++;
+            return object;
+        }
+
+        template <typename... Args>
+        UniquePtr MakeUnique(Args &&...args)
+        {
+            return UniquePtr(Create(std::forward<Args>(args)...), Deleter{this});
+        }
+
+        void Destroy(T *object)
+        {
+            if (!object)
+                return;
+
+            // 객체는 슬롯의 맨 앞에 있으므로 슬롯에 적어 둔 청크 번호로 바로 찾음
+            const auto *slot = reinterpret_cast<const Slot *>(object);
+            const size_t c = slot->chunk;
+            assert(c < m_chunks.size() && "ObjectPool::Destroy() with a pointer from another pool");
+            Chunk &chunk = *m_chunks[c];
+            assert(slot >= chunk.slots && slot < chunk.slots + kChunkSize &&
+                   "ObjectPool::Destroy() with a pointer from another pool");
+
+            const size_t s = size_t(slot - chunk.slots);
+            assert(chunk.alive[s] && "ObjectPool::Destroy() called twice");
+            object->~T();
+            chunk.alive[s] = false;
+            m_freeList.push_back({c, s});
+            m_liveCount--;
+        }
+
+        size_t GetLiveCount() const { return m_liveCount; }
+        size_t GetCapacity() const { return m_chunks.size() * kChunkSize; }
+
+    private:
+        struct alignas(T) Slot {
+            std::byte data[sizeof(T)]; // 객체 (맨 앞이어야 객체 포인터로 슬롯을 찾을 수 있음)
+            uint32_t chunk = 0;        // m_chunks 번호
+        };
+
+        struct Chunk {
+            Slot slots[kChunkSize];
+            bool alive[kChunkSize] = {};
+        };
+
+        struct SlotIndex {
+            size_t chunk;
+            size_t slot;
+        };
+
+        void AddChunk()
+        {
+            m_chunks.push_back(std::make_unique<Chunk>());
+            MemoryTracker::OnAllocate(m_category, sizeof(Chunk));
+
+            const size_t c = m_chunks.size() - 1;
+            for (Slot &slot : m_chunks.back()->slots)
+                slot.chunk = uint32_t(c);
+
+            // 낮은 슬롯부터 쓰도록 역순으로 넣음
+            for (size_t s = kChunkSize; s > 0; s--)
+                m_freeList.push_back({c, s - 1});
+        }
+
+        std::vector<std::unique_ptr<Chunk>> m_chunks;
+        std::vector<SlotIndex> m_freeList;
+        size_t m_liveCount = 0;
+        MemoryCategory m_category;
+    };
+}
@@ -0,0 +1,260 @@
+#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+
+namespace luke {
+    using namespace std;
+    using namespace DirectX;
+
+    namespace {
+        // 카메라 뒤(w <= 0)나 near plane에 걸친 점은 투영할 수 없으므로 따로 처리합니다.
+        constexpr float kMinClipW = 1e-4f;
+
+        float ElapsedMs(chrono::high_resolution_clock::time_point start)
+        {
+            return chrono::duration<float, milli>(chrono::high_resolution_clock::now() - start)
+                .count();
+        }
+    }
+
+    OcclusionCuller::OcclusionCuller()
+        : m_depth(size_t(kWidth) * kHeight, 1.0f), m_tileMax(size_t(kTilesX) * kTilesY, 1.0f)
+    {
+    }
+
+    void OcclusionCuller::BeginFrame(const Matrix &view, const Matrix &projection,
+                                     pmr::memory_resource *frameMemory)
+    {
+        m_viewProjection = view * projection;
+        m_frameMemory = frameMemory;
+        fill(m_depth.begin(), m_depth.end(), 1.0f);
+        m_stats = OcclusionStats();
+    }
+
+    void OcclusionCuller::RasterizeOccluder(span<const Vertex> vertices,
+                                            span<const uint16_t> indices, const Matrix &world)
+    {
+        const auto start = chrono::high_resolution_clock::now();
+
+        const XMMATRIX worldViewProj = XMMatrixMultiply(world, m_viewProjection);
+
+        // 버텍스를 한 번만 변환해서 스크린 좌표(x, y)와 NDC 깊이(z)로 저장
+        // w가 너무 작은 버텍스는 z에 음수를 넣어 표시해둡니다.
+        pmr::vector<XMFLOAT3> screen(vertices.size(), m_frameMemory);
+        for (size_t i = 0; i < vertices.size(); i++) {
+            const XMVECTOR clip = XMVector3Transform(XMLoadFloat3(&vertices[i].position),
+                                                     worldViewProj);
+            const float w = XMVectorGetW(clip);
+            if (w < kMinClipW) {
+                screen[i] = XMFLOAT3(0.0f, 0.0f, -1.0f);
+                continue;
+            }
+
+            const float invW = 1.0f / w;
+            screen[i].x = (XMVectorGetX(clip) * invW * 0.5f + 0.5f) * kWidth;
+            screen[i].y = (0.5f - XMVectorGetY(clip) * invW * 0.5f) * kHeight;
+            screen[i].z = XMVectorGetZ(clip) * invW;
+        }
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const XMFLOAT3 &v0 = screen[indices[i]];
+            const XMFLOAT3 &v1 = screen[indices[i + 1]];
+            const XMFLOAT3 &v2 = screen[indices[i + 2]];
+
+            // near plane에 걸친 삼각형은 그리지 않습니다.
+            // 가리개를 덜 그리는 것은 컬링이 덜 될 뿐 잘못된 결과를 만들지 않습니다.
+            if (v0.z < 0.0f || v1.z < 0.0f || v2.z < 0.0f)
+                continue;
+
+            RasterizeTriangle(v0, v1, v2);
+            m_stats.occluderTriangles++;
+        }
+
+        m_stats.rasterizeMs += ElapsedMs(start);
+    }
+
+    void OcclusionCuller::RasterizeTriangle(const XMFLOAT3 &v0, const XMFLOAT3 &v1,
+                                            const XMFLOAT3 &v2)
+    {
+        // 엣지 함수 E(x, y) = A * x + B * y + C
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+        if (fabsf(area) < 1e-8f)
+            return;
+
+        // CullMode가 NONE이므로 감기 순서(winding)에 상관없이 그립니다.
+        const XMFLOAT3 *p0 = &v0;
+        const XMFLOAT3 *p1 = &v1;
+        const XMFLOAT3 *p2 = &v2;
+        if (area < 0.0f) {
+            swap(p1, p2);
+            area = -area;
+        }
+
+        const int minX = max(0, int(floorf(min({p0->x, p1->x, p2->x}))));
+        const int maxX = min(kWidth - 1, int(ceilf(max({p0->x, p1->x, p2->x}))));
+        const int minY = max(0, int(floorf(min({p0->y, p1->y, p2->y}))));
+        const int maxY = min(kHeight - 1, int(ceilf(max({p0->y, p1->y, p2->y}))));
+        if (minX > maxX || minY > maxY)
+            return;
+
+        const float a0 = p1->y - p2->y, b0 = p2->x - p1->x, c0 = p1->x * p2->y - p2->x * p1->y;
+        const float a1 = p2->y - p0->y, b1 = p0->x - p2->x, c1 = p2->x * p0->y - p0->x * p2->y;
+        const float a2 = p0->y - p1->y, b2 = p1->x - p0->x, c2 = p0->x * p1->y - p1->x * p0->y;
+
+        // 깊이 z는 스크린 공간에서 선형이므로 무게중심 좌표로 보간합니다.
+        const float invArea = 1.0f / area;
+        const float z0 = p0->z * invArea, z1 = p1->z * invArea, z2 = p2->z * invArea;
+
+        // 4픽셀을 한꺼번에 처리: x 시작점을 4의 배수로 맞춥니다.
+        const int startX = minX & ~3;
+        const XMVECTOR pixelOffset = XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f);
+        const XMVECTOR zero = XMVectorZero();
+        const XMVECTOR stepA0 = XMVectorReplicate(a0 * 4.0f);
+        const XMVECTOR stepA1 = XMVectorReplicate(a1 * 4.0f);
+        const XMVECTOR stepA2 = XMVectorReplicate(a2 * 4.0f);
+        const XMVECTOR vz0 = XMVectorReplicate(z0);
+        const XMVECTOR vz1 = XMVectorReplicate(z1);
+        const XMVECTOR vz2 = XMVectorReplicate(z2);
+
+        for (int y = minY; y <= maxY; y++) {
+            const float py = float(y) + 0.5f;
+            const XMVECTOR px = XMVectorAdd(XMVectorReplicate(float(startX)), pixelOffset);
+
+            XMVECTOR w0 = XMVectorMultiplyAdd(XMVectorReplicate(a0), px,
+                                              XMVectorReplicate(b0 * py + c0));
+            XMVECTOR w1 = XMVectorMultiplyAdd(XMVectorReplicate(a1), px,
+                                              XMVectorReplicate(b1 * py + c1));
+            XMVECTOR w2 = XMVectorMultiplyAdd(XMVectorReplicate(a2), px,
+                                              XMVectorReplicate(b2 * py + c2));
+
+            float *row = m_depth.data() + size_t(y) * kWidth;
+            for (int x = startX; x <= maxX; x += 4) {
+                const XMVECTOR inside = XMVectorAndInt(
+                    XMVectorAndInt(XMVectorGreaterOrEqual(w0, zero),
+                                   XMVectorGreaterOrEqual(w1, zero)),
+                    XMVectorGreaterOrEqual(w2, zero));
+
+                if (!XMVector4EqualInt(inside, XMVectorFalseInt())) {
+                    const XMVECTOR depth = XMVectorMultiplyAdd(
+                        w0, vz0, XMVectorMultiplyAdd(w1, vz1, XMVectorMultiply(w2, vz2)));
+                    const XMVECTOR old = XMLoadFloat4(reinterpret_cast<XMFLOAT4 *>(row + x));
+                    const XMVECTOR result = XMVectorSelect(old, XMVectorMin(old, depth), inside);
+                    XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(row + x), result);
+                }
+
+                w0 = XMVectorAdd(w0, stepA0);
+                w1 = XMVectorAdd(w1, stepA1);
+                w2 = XMVectorAdd(w2, stepA2);
+            }
+        }
+    }
+
+    void OcclusionCuller::EndOccluders()
+    {
+        const auto start = chrono::high_resolution_clock::now();
+
+        for (int ty = 0; ty < kTilesY; ty++) {
+            for (int tx = 0; tx < kTilesX; tx++) {
+                XMVECTOR tileMax = XMVectorZero();
+                for (int y = 0; y < kTileSize; y++) {
+                    const float *row =
+                        m_depth.data() + size_t(ty * kTileSize + y) * kWidth + tx * kTileSize;
+                    for (int x = 0; x < kTileSize; x += 4)
+                        tileMax = XMVectorMax(
+                            tileMax, XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(row + x)));
+                }
+
+                XMFLOAT4 lanes;
+                XMStoreFloat4(&lanes, tileMax);
+                m_tileMax[size_t(ty) * kTilesX + tx] =
+                    max(max(lanes.x, lanes.y), max(lanes.z, lanes.w));
+            }
+        }
+
+        m_stats.hierarchyMs = ElapsedMs(start);
+    }
+
+    bool OcclusionCuller::IsVisible(const BoundingBox &worldBox) const
+    {
+        XMFLOAT3 corners[BoundingBox::CORNER_COUNT];
+        worldBox.GetCorners(corners);
+
+        float minX = float(kWidth), maxX = 0.0f;
+        float minY = float(kHeight), maxY = 0.0f;
+        float minZ = 1.0f;
+
+        for (const auto &corner : corners) {
+            const XMVECTOR clip = XMVector3Transform(XMLoadFloat3(&corner), m_viewProjection);
+            const float w = XMVectorGetW(clip);
+
+            // 카메라에 걸쳐 있는 박스는 판단하지 않고 그립니다.
+            if (w < kMinClipW)
+                return true;
+
+            const float invW = 1.0f / w;
+            const float sx = (XMVectorGetX(clip) * invW * 0.5f + 0.5f) * kWidth;
+            const float sy = (0.5f - XMVectorGetY(clip) * invW * 0.5f) * kHeight;
+            minX = min(minX, sx);
+            maxX = max(maxX, sx);
+            minY = min(minY, sy);
+            maxY = max(maxY, sy);
+            minZ = min(minZ, XMVectorGetZ(clip) * invW);
+        }
+
+        const int x0 = max(0, int(floorf(minX)));
+        const int x1 = min(kWidth - 1, int(ceilf(maxX)));
+        const int y0 = max(0, int(floorf(minY)));
+        const int y1 = min(kHeight - 1, int(ceilf(maxY)));
+
+        // 화면 밖은 뷰 프러스텀 컬링의 몫이므로 여기서는 보이는 것으로 둡니다.
+        if (x0 > x1 || y0 > y1)
+            return true;
+
+        // 타일의 최대 깊이보다 박스가 가까우면 타일 안의 픽셀을 자세히 검사합니다.
+        for (int ty = y0 / kTileSize; ty <= y1 / kTileSize; ty++) {
+            for (int tx = x0 / kTileSize; tx <= x1 / kTileSize; tx++) {
+                if (m_tileMax[size_t(ty) * kTilesX + tx] < minZ)
+                    continue; // 타일 전체가 박스보다 앞에 있음
+
+                const int px0 = max(x0, tx * kTileSize);
+                const int px1 = min(x1, tx * kTileSize + kTileSize - 1);
+                const int py0 = max(y0, ty * kTileSize);
+                const int py1 = min(y1, ty * kTileSize + kTileSize - 1);
+                for (int y = py0; y <= py1; y++) {
+                    const float *row = m_depth.data() + size_t(y) * kWidth;
+                    for (int x = px0; x <= px1; x++) {
+                        if (row[x] >= minZ)
+                            return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void OcclusionCuller::TestBoxes(const vector<BoundingBox> &worldBoxes, vector<uint8_t> &visible,
+                                    JobSystem &jobSystem)
+    {
+        const auto start = chrono::high_resolution_clock::now();
+
+        visible.resize(worldBoxes.size());
+        atomic<uint32_t> rejected{0};
+
+        jobSystem.ParallelFor(worldBoxes.size(), 64, [&](size_t begin, size_t end) {
+            uint32_t localRejected = 0;
+            for (size_t i = begin; i < end; i++) {
+                visible[i] = IsVisible(worldBoxes[i]) ? 1 : 0;
+                localRejected += visible[i] ? 0 : 1;
+            }
+            rejected += localRejected;
+        });
+
+        m_stats.testedBoxes += uint32_t(worldBoxes.size());
+        m_stats.rejectedBoxes += rejected.load();
+        m_stats.testMs += ElapsedMs(start);
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <directxtk/SimpleMath.h>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include "JobSystem.h"
+#include "MeshGenerator.h"
+
+namespace luke {
+
+    using DirectX::BoundingBox;
+    using DirectX::SimpleMath::Matrix;
+
+    struct OcclusionStats {
+        float rasterizeMs = 0.0f; // 가리개(occluder) 래스터화 시간
+        float hierarchyMs = 0.0f; // 타일별 최대 깊이 계산 시간
+        float testMs = 0.0f;      // 바운딩 박스 검사 시간
+        uint32_t occluderTriangles = 0;
+        uint32_t testedBoxes = 0;
+        uint32_t rejectedBoxes = 0;
+    };
+
+    // CPU에서 저해상도 깊이 버퍼를 만들어 가려진 물체를 미리 걸러내는 컬러
+    // 1. BeginFrame()에 FrameConstants와 같은 view/projection을 (전치하지 않고) 넣고
+    // 2. RasterizeOccluder()로 벽처럼 큰 물체들을 깊이 버퍼에 그린 뒤
+    // 3. EndOccluders()로 타일 단위 계층 깊이(Hi-Z)를 만들고
+    // 4. TestBoxes()/IsVisible()로 월드 공간 바운딩 박스를 검사합니다.
+    // 깊이는 D3D와 같이 0(가까움) ~ 1(멂)이며, 애매한 경우에는 항상 보이는 것으로 판단합니다.
+    class OcclusionCuller {
+    public:
+        static constexpr int kWidth = 256;  // 4의 배수 (SIMD로 4픽셀씩 처리)
+        static constexpr int kHeight = 128;
+        static constexpr int kTileSize = 8;
+        static constexpr int kTilesX = kWidth / kTileSize;
+        static constexpr int kTilesY = kHeight / kTileSize;
+
+        OcclusionCuller();
+
+        // view, projection은 전치(Transpose)하기 전의 행렬
+        // frameMemory: 래스터화 중의 임시 버퍼를 할당할 곳 (보통 Graphics::m_frameArena)
+        void BeginFrame(const Matrix &view, const Matrix &projection,
+                        std::pmr::memory_resource *frameMemory = std::pmr::get_default_resource());
+        void RasterizeOccluder(std::span<const Vertex> vertices, std::span<const uint16_t> indices,
+                               const Matrix &world);
+        void EndOccluders();
+
+        bool IsVisible(const BoundingBox &worldBox) const;
+
+        // visible[i]에 worldBoxes[i]의 결과(1: 그림, 0: 가려짐)를 기록합니다.
+        void TestBoxes(const std::vector<BoundingBox> &worldBoxes, std::vector<uint8_t> &visible,
+                       JobSystem &jobSystem);
+
+        const OcclusionStats &GetStats() const { return m_stats; }
+        const std::vector<float> &GetDepthBuffer() const { return m_depth; }
+
+    private:
+        void RasterizeTriangle(const DirectX::XMFLOAT3 &v0, const DirectX::XMFLOAT3 &v1,
+                               const DirectX::XMFLOAT3 &v2);
+
+        Matrix m_viewProjection;
+        std::pmr::memory_resource *m_frameMemory = std::pmr::get_default_resource();
+        std::vector<float> m_depth;   // kWidth x kHeight
+        std::vector<float> m_tileMax; // kTilesX x kTilesY, 타일 안에서 가장 먼 깊이
+        OcclusionStats m_stats;
+    };
+}
@@ -0,0 +1,102 @@
+#include "OffscreenRenderer.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace luke {
+    using namespace std;
+
+    OffscreenRenderer::OffscreenRenderer(RenderBackend &backend, ImageWriter &writer, uint32_t width,
+                                         uint32_t height, uint32_t latency)
+        : m_backend(backend), m_writer(writer), m_width(width), m_height(height)
+    {
+        m_slots.resize(max(latency, 1u));
+        for (Slot &slot : m_slots)
+            slot.target = m_backend.CreateRenderTarget(width, height);
+    }
+
+    OffscreenRenderer::~OffscreenRenderer()
+    {
+        Flush();
+        for (Slot &slot : m_slots)
+            if (!slot.target.IsNull())
+                m_backend.DestroyRenderTarget(slot.target);
+    }
+
+    RenderTargetHandle OffscreenRenderer::BeginFrame(filesystem::path outputPath)
+    {
+        Slot &slot = m_slots[m_frameIndex % m_slots.size()];
+
+        // latency 프레임 동안 한 번도 읽지 못했으면 더 쓸 타겟이 없으므로 기다림
+        if (slot.pending)
+            ReadSlot(slot, true);
+
+        slot.outputPath = std::move(outputPath);
+        m_inFrame = true;
+        return slot.target;
+    }
+
+    void OffscreenRenderer::EndFrame()
+    {
+        if (!m_inFrame)
+            return;
+        m_inFrame = false;
+
+        Slot &slot = m_slots[m_frameIndex % m_slots.size()];
+        m_frameIndex++;
+        m_stats.framesRendered++;
+        if (slot.target.IsNull())
+            return; // 타겟 생성에 실패한 경우 (백엔드가 오류를 출력함)
+
+        m_backend.CopyToStaging(slot.target);
+        slot.frame = m_frameIndex - 1;
+        slot.pending = true;
+
+        // (latency - 1) 프레임 이상 지난 것만 확인. 더 최근 프레임은 아직 GPU에 있을 가능성이 높음
+        const uint64_t readableFrames = m_slots.size() - 1;
+        for (Slot &candidate : m_slots) {
+            if (candidate.pending && candidate.frame + readableFrames < m_frameIndex)
+                ReadSlot(candidate, false);
+        }
+    }
+
+    void OffscreenRenderer::Flush()
+    {
+        // 오래된 프레임부터 읽어서 파일 순서를 유지
+        vector<Slot *> pending;
+        for (Slot &slot : m_slots)
+            if (slot.pending)
+                pending.push_back(&slot);
+        sort(pending.begin(), pending.end(),
+             [](const Slot *a, const Slot *b) { return a->frame < b->frame; });
+
+        for (Slot *slot : pending)
+            ReadSlot(*slot, true);
+    }
+
+    bool OffscreenRenderer::ReadSlot(Slot &slot, bool wait)
+    {
+        // 읽지 못하면 다음 호출에서 그대로 다시 씀
+        if (m_pixels.empty())
+            m_pixels = m_writer.AcquireBuffer(size_t(m_width) * m_height * 4);
+
+        bool stalled = false;
+        while (!m_backend.TryReadStaging(slot.target, m_pixels)) {
+            if (!wait) {
+                m_stats.readbackMisses++;
+                return false;
+            }
+            if (!stalled) {
+                m_stats.readbackStalls++;
+                stalled = true;
+            }
+            this_thread::yield();
+        }
+
+        slot.pending = false;
+        if (m_writer.Submit(slot.outputPath, m_width, m_height, std::move(m_pixels)))
+            m_stats.framesWritten++;
+        m_pixels = {};
+        return true;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "ImageWriter.h"
+#include "RenderBackend.h"
+
+namespace luke {
+
+    struct OffscreenStats {
+        uint64_t framesRendered = 0;
+        uint64_t framesWritten = 0;   // 스테이징에서 읽어서 ImageWriter로 넘긴 프레임
+        uint64_t readbackMisses = 0;  // TryReadStaging()이 아직 준비되지 않아 다음 프레임으로 미룬 횟수
+        uint64_t readbackStalls = 0;  // 렌더 타겟을 다시 쓰려는데 복사가 안 끝나서 기다린 횟수
+        uint64_t framesSkipped = 0;   // 창 모드 캡처에서 타겟이 아직 읽히지 않아 저장하지 않은 프레임
+    };
+
+    // 창 없이 렌더 타겟 여러 장을 돌려 쓰면서 그린 이미지를 파일로 저장합니다.
+    // 프레임 N에 그린 타겟은 스테이징으로 복사만 예약하고, (latency - 1) 프레임 뒤에
+    // 기다리지 않고 읽어서 ImageWriter로 넘깁니다. 그동안 CPU는 다음 프레임들을 계속 기록하므로
+    // GPU(또는 소프트웨어 백엔드)의 완료나 파일 쓰기를 기다리지 않습니다.
+    // 모든 타겟이 아직 읽히지 않은 상태일 때만 BeginFrame()이 대기합니다. (readbackStalls)
+    class OffscreenRenderer {
+    public:
+        OffscreenRenderer(RenderBackend &backend, ImageWriter &writer, uint32_t width,
+                          uint32_t height, uint32_t latency = 3);
+        ~OffscreenRenderer(); // Flush() 후 렌더 타겟 삭제
+
+        OffscreenRenderer(const OffscreenRenderer &) = delete;
+        OffscreenRenderer &operator=(const OffscreenRenderer &) = delete;
+
+        // 이번 프레임에 그릴 렌더 타겟을 반환합니다. 그리기 전에 SetRenderTarget()으로 바인딩하세요.
+        // outputPath: 이 프레임을 저장할 파일 (확장자는 ImageWriter가 붙임)
+        RenderTargetHandle BeginFrame(std::filesystem::path outputPath);
+        // 스테이징 복사를 예약하고 충분히 지난 프레임들을 읽습니다.
+        void EndFrame();
+
+        // 남은 프레임을 모두 읽어서 ImageWriter로 넘깁니다. (파일 쓰기 완료는 ImageWriter::WaitIdle())
+        void Flush();
+
+        uint32_t GetWidth() const { return m_width; }
+        uint32_t GetHeight() const { return m_height; }
+        uint32_t GetLatency() const { return uint32_t(m_slots.size()); }
+        const OffscreenStats &GetStats() const { return m_stats; }
+
+    private:
+        struct Slot {
+            RenderTargetHandle target;
+            std::filesystem::path outputPath;
+            uint64_t frame = 0;
+            bool pending = false; // 복사를 예약했고 아직 읽지 않음
+        };
+
+        bool ReadSlot(Slot &slot, bool wait);
+
+        RenderBackend &m_backend;
+        ImageWriter &m_writer;
+        uint32_t m_width;
+        uint32_t m_height;
+        std::vector<Slot> m_slots;
+        std::vector<uint8_t> m_pixels; // ImageWriter 풀에서 받은 읽기 버퍼
+        uint64_t m_frameIndex = 0;
+        bool m_inFrame = false;
+        OffscreenStats m_stats;
+    };
+}
@@ -0,0 +1,274 @@
+#include "ParticleSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace luke {
+
+    using namespace std;
+    using namespace DirectX;
+
+    namespace {
+        uint32_t NextRandom(uint32_t &state)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        // [0, 1)
+        float RandomFloat(uint32_t &state) { return float(NextRandom(state) >> 8) * (1.0f / 16777216.0f); }
+
+        float RandomRange(uint32_t &state, float jitter) { return (RandomFloat(state) * 2.0f - 1.0f) * jitter; }
+
+        XMVECTOR Load4(const float *values) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(values)); }
+
+        void Store4(float *values, XMVECTOR v) { XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(values), v); }
+
+        // 정상 상태에서 파티클 수가 maxParticles 근처에 머무는 생성 속도
+        float SteadySpawnRate(const EmitterSettings &settings)
+        {
+            return float(settings.maxParticles) / (0.5f * (settings.minLifetime + settings.maxLifetime));
+        }
+
+        uint32_t PackColor(const Vector4 &color)
+        {
+            return uint32_t(color.x * 255.0f + 0.5f) | uint32_t(color.y * 255.0f + 0.5f) << 8 |
+                   uint32_t(color.z * 255.0f + 0.5f) << 16 | uint32_t(color.w * 255.0f + 0.5f) << 24;
+        }
+    }
+
+#pragma region 프리셋
+    EmitterSettings EmitterSettings::Smoke(uint32_t maxParticles)
+    {
+        EmitterSettings settings;
+        settings.velocity = Vector3(0.0f, 1.0f, 0.0f);
+        settings.velocityJitter = Vector3(0.4f, 0.3f, 0.4f);
+        settings.gravity = Vector3(0.0f, 0.2f, 0.0f); // 부력
+        settings.drag = 0.5f;
+        settings.minLifetime = 3.0f;
+        settings.maxLifetime = 5.0f;
+        settings.startSize = 0.2f;
+        settings.endSize = 1.0f;
+        settings.startColor = Vector4(0.5f, 0.5f, 0.5f, 0.6f);
+        settings.endColor = Vector4(0.3f, 0.3f, 0.3f, 0.0f);
+        settings.maxParticles = maxParticles;
+        settings.spawnRate = SteadySpawnRate(settings);
+        return settings;
+    }
+
+    EmitterSettings EmitterSettings::Sparks(uint32_t maxParticles)
+    {
+        EmitterSettings settings;
+        settings.velocity = Vector3(0.0f, 4.0f, 0.0f);
+        settings.velocityJitter = Vector3(3.0f, 2.0f, 3.0f);
+        settings.gravity = Vector3(0.0f, -9.8f, 0.0f);
+        settings.drag = 0.1f;
+        settings.minLifetime = 0.5f;
+        settings.maxLifetime = 1.5f;
+        settings.startSize = 0.05f;
+        settings.endSize = 0.02f;
+        settings.startColor = Vector4(1.0f, 0.8f, 0.3f, 1.0f);
+        settings.endColor = Vector4(1.0f, 0.2f, 0.0f, 0.0f);
+        settings.maxParticles = maxParticles;
+        settings.spawnRate = SteadySpawnRate(settings);
+        return settings;
+    }
+
+    EmitterSettings EmitterSettings::Debris(uint32_t maxParticles)
+    {
+        EmitterSettings settings;
+        settings.velocity = Vector3(0.0f, 5.0f, 0.0f);
+        settings.velocityJitter = Vector3(2.0f, 1.5f, 2.0f);
+        settings.gravity = Vector3(0.0f, -9.8f, 0.0f);
+        settings.drag = 0.02f;
+        settings.minLifetime = 1.5f;
+        settings.maxLifetime = 2.5f;
+        settings.startSize = 0.1f;
+        settings.endSize = 0.1f;
+        settings.startColor = Vector4(0.4f, 0.35f, 0.3f, 1.0f);
+        settings.endColor = Vector4(0.3f, 0.25f, 0.2f, 1.0f);
+        settings.maxParticles = maxParticles;
+        settings.spawnRate = SteadySpawnRate(settings);
+        return settings;
+    }
+#pragma endregion
+
+    uint32_t ParticleSystem::AddEmitter(const EmitterSettings &settings, uint32_t seed)
+    {
+        Emitter &emitter = m_emitters.emplace_back();
+        emitter.settings = settings;
+        emitter.random = seed ? seed : 1;
+
+        // 마지막 4개 묶음이 배열 끝을 넘지 않도록 4의 배수로 올림
+        const size_t capacity = (size_t(settings.maxParticles) + 3) & ~size_t(3);
+        for (vector<float> *values : {&emitter.positionX, &emitter.positionY, &emitter.positionZ, &emitter.velocityX,
+                                      &emitter.velocityY, &emitter.velocityZ, &emitter.age, &emitter.invLifetime})
+            values->assign(capacity, 0.0f);
+        return uint32_t(m_emitters.size() - 1);
+    }
+
+    uint64_t ParticleSystem::GetParticleCount() const
+    {
+        uint64_t count = 0;
+        for (const Emitter &emitter : m_emitters)
+            count += emitter.count;
+        return count;
+    }
+
+    void ParticleSystem::Update(float dt, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+        const auto start = Clock::now();
+        m_stats = {};
+
+        m_chunks.clear();
+        for (uint32_t e = 0; e < uint32_t(m_emitters.size()); e++) {
+            const uint32_t count = m_emitters[e].count;
+            for (uint32_t begin = 0; begin < count; begin += kChunkSize)
+                m_chunks.push_back({e, begin, min(begin + kChunkSize, count), 0});
+            m_stats.simulated += count;
+        }
+
+        jobSystem.ParallelFor(m_chunks.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                SimulateChunk(m_emitters[m_chunks[i].emitter], m_chunks[i], dt);
+        });
+
+        // 청크마다 앞쪽에 모인 파티클을 이어 붙임. 청크는 이미터 순서, 위치 순서로 들어 있음
+        for (size_t i = 0; i < m_chunks.size();) {
+            const uint32_t emitterIndex = m_chunks[i].emitter;
+            Emitter &emitter = m_emitters[emitterIndex];
+            float *arrays[] = {emitter.positionX.data(), emitter.positionY.data(), emitter.positionZ.data(),
+                               emitter.velocityX.data(), emitter.velocityY.data(), emitter.velocityZ.data(),
+                               emitter.age.data(),       emitter.invLifetime.data()};
+            uint32_t write = 0;
+            for (; i < m_chunks.size() && m_chunks[i].emitter == emitterIndex; i++) {
+                const Chunk &chunk = m_chunks[i];
+                if (chunk.begin != write && chunk.alive > 0) {
+                    for (float *values : arrays)
+                        memmove(values + write, values + chunk.begin, chunk.alive * sizeof(float));
+                }
+                write += chunk.alive;
+            }
+            m_stats.killed += emitter.count - write;
+            emitter.count = write;
+        }
+
+        for (Emitter &emitter : m_emitters)
+            Spawn(emitter, dt, m_stats);
+
+        m_stats.simulateMs = chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+
+    void ParticleSystem::SimulateChunk(Emitter &emitter, Chunk &chunk, float dt)
+    {
+        const EmitterSettings &settings = emitter.settings;
+        const XMVECTOR step = XMVectorReplicate(dt);
+        const XMVECTOR damping = XMVectorReplicate(max(0.0f, 1.0f - settings.drag * dt));
+        const XMVECTOR gravityX = XMVectorReplicate(settings.gravity.x * dt);
+        const XMVECTOR gravityY = XMVectorReplicate(settings.gravity.y * dt);
+        const XMVECTOR gravityZ = XMVectorReplicate(settings.gravity.z * dt);
+        const XMVECTOR one = XMVectorSplatOne();
+        const XMVECTOR zero = XMVectorZero();
+
+        float *positionX = emitter.positionX.data();
+        float *positionY = emitter.positionY.data();
+        float *positionZ = emitter.positionZ.data();
+        float *velocityX = emitter.velocityX.data();
+        float *velocityY = emitter.velocityY.data();
+        float *velocityZ = emitter.velocityZ.data();
+        float *age = emitter.age.data();
+        float *invLifetime = emitter.invLifetime.data();
+
+        uint32_t write = chunk.begin;
+        for (uint32_t i = chunk.begin; i < chunk.end; i += 4) {
+            // v = v * (1 - drag * dt) + g * dt, p += v * dt, age += dt / lifetime
+            const XMVECTOR vx = XMVectorMultiplyAdd(Load4(velocityX + i), damping, gravityX);
+            const XMVECTOR vy = XMVectorMultiplyAdd(Load4(velocityY + i), damping, gravityY);
+            const XMVECTOR vz = XMVectorMultiplyAdd(Load4(velocityZ + i), damping, gravityZ);
+            const XMVECTOR px = XMVectorMultiplyAdd(vx, step, Load4(positionX + i));
+            const XMVECTOR py = XMVectorMultiplyAdd(vy, step, Load4(positionY + i));
+            const XMVECTOR pz = XMVectorMultiplyAdd(vz, step, Load4(positionZ + i));
+            const XMVECTOR life = Load4(invLifetime + i);
+            const XMVECTOR nextAge = XMVectorMultiplyAdd(life, step, Load4(age + i));
+            const XMVECTOR alive = XMVectorSelect(zero, one, XMVectorLess(nextAge, one));
+
+            float lanes[9][4];
+            Store4(lanes[0], px);
+            Store4(lanes[1], py);
+            Store4(lanes[2], pz);
+            Store4(lanes[3], vx);
+            Store4(lanes[4], vy);
+            Store4(lanes[5], vz);
+            Store4(lanes[6], nextAge);
+            Store4(lanes[7], life);
+            Store4(lanes[8], alive);
+
+            // 분기 없는 압축: 죽은 파티클도 write에 쓰지만 write가 늘지 않으므로 다음 파티클이 덮어씀.
+            // write <= i이고 이 묶음은 이미 읽었으므로 제자리에서 해도 됨
+            const uint32_t laneCount = min(4u, chunk.end - i);
+            for (uint32_t lane = 0; lane < laneCount; lane++) {
+                positionX[write] = lanes[0][lane];
+                positionY[write] = lanes[1][lane];
+                positionZ[write] = lanes[2][lane];
+                velocityX[write] = lanes[3][lane];
+                velocityY[write] = lanes[4][lane];
+                velocityZ[write] = lanes[5][lane];
+                age[write] = lanes[6][lane];
+                invLifetime[write] = lanes[7][lane];
+                write += uint32_t(lanes[8][lane]);
+            }
+        }
+        chunk.alive = write - chunk.begin;
+    }
+
+    void ParticleSystem::Spawn(Emitter &emitter, float dt, ParticleStats &stats)
+    {
+        const EmitterSettings &settings = emitter.settings;
+        emitter.spawnAccumulator += settings.spawnRate * dt;
+        const uint32_t requested = uint32_t(emitter.spawnAccumulator);
+        emitter.spawnAccumulator -= float(requested);
+        // 가득 차면 넘치는 만큼은 버림
+        const uint32_t spawn = min(requested, settings.maxParticles - emitter.count);
+
+        for (uint32_t i = emitter.count; i < emitter.count + spawn; i++) {
+            emitter.positionX[i] = settings.position.x;
+            emitter.positionY[i] = settings.position.y;
+            emitter.positionZ[i] = settings.position.z;
+            emitter.velocityX[i] = settings.velocity.x + RandomRange(emitter.random, settings.velocityJitter.x);
+            emitter.velocityY[i] = settings.velocity.y + RandomRange(emitter.random, settings.velocityJitter.y);
+            emitter.velocityZ[i] = settings.velocity.z + RandomRange(emitter.random, settings.velocityJitter.z);
+            emitter.age[i] = 0.0f;
+            const float lifetime =
+                settings.minLifetime + (settings.maxLifetime - settings.minLifetime) * RandomFloat(emitter.random);
+            emitter.invLifetime[i] = 1.0f / max(lifetime, 1e-3f);
+        }
+        emitter.count += spawn;
+        stats.spawned += spawn;
+    }
+
+    void ParticleSystem::WriteInstances(uint32_t emitterIndex, ParticleInstance *out, JobSystem &jobSystem)
+    {
+        using Clock = chrono::high_resolution_clock;
+        const auto start = Clock::now();
+
+        const Emitter &emitter = m_emitters[emitterIndex];
+        const EmitterSettings &settings = emitter.settings;
+        const float sizeDelta = settings.endSize - settings.startSize;
+        const Vector4 colorDelta = settings.endColor - settings.startColor;
+
+        jobSystem.ParallelFor(emitter.count, kChunkSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const float t = emitter.age[i];
+                // 쓰기 결합 메모리일 수 있으므로 인스턴스 하나를 한 번에 씀
+                out[i] = {Vector3(emitter.positionX[i], emitter.positionY[i], emitter.positionZ[i]),
+                          settings.startSize + sizeDelta * t, PackColor(settings.startColor + colorDelta * t)};
+            }
+        });
+
+        m_stats.writeMs += chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+}
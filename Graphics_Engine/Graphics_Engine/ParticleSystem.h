@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <directxtk/SimpleMath.h>
+#include <vector>
+
+#include "JobSystem.h"
+
+namespace luke {
+
+    using DirectX::SimpleMath::Vector3;
+    using DirectX::SimpleMath::Vector4;
+
+    struct EmitterSettings {
+        Vector3 position;
+        Vector3 velocity;          // 생성 속도
+        Vector3 velocityJitter;    // 축마다 [-jitter, jitter]를 더함
+        Vector3 gravity;           // 가속도
+        float drag = 0.0f;         // 초당 속도 감소 비율
+        float spawnRate = 1000.0f; // 초당 생성 수
+        float minLifetime = 1.0f;
+        float maxLifetime = 2.0f;
+        float startSize = 0.1f;
+        float endSize = 0.1f;
+        Vector4 startColor{1.0f, 1.0f, 1.0f, 1.0f};
+        Vector4 endColor{1.0f, 1.0f, 1.0f, 0.0f};
+        uint32_t maxParticles = 10000;
+
+        // 위로 퍼지며 커지는 연기 / 빠르게 떨어지는 불꽃 / 무거운 파편
+        static EmitterSettings Smoke(uint32_t maxParticles);
+        static EmitterSettings Sparks(uint32_t maxParticles);
+        static EmitterSettings Debris(uint32_t maxParticles);
+    };
+
+    // 빌보드 인스턴스 하나 (20바이트). 버텍스 쉐이더가 뷰 공간에서 사각형으로 펼침
+    struct ParticleInstance {
+        Vector3 position;
+        float size;
+        uint32_t color; // RGBA8 (DXGI_FORMAT_R8G8B8A8_UNORM)
+    };
+
+    static_assert(sizeof(ParticleInstance) == 20);
+
+    struct ParticleStats {
+        double simulateMs = 0.0; // 적분 + 제거 + 압축 + 생성
+        double writeMs = 0.0;    // WriteInstances() 합계
+        uint64_t simulated = 0;  // 이번 Update()에서 적분한 파티클
+        uint64_t spawned = 0;
+        uint64_t killed = 0;
+    };
+
+    // 이미터마다 파티클을 성분별 배열(SoA)에 저장하고 XMVECTOR 한 번에 4개씩 적분합니다.
+    // Update()는 모든 이미터의 파티클을 kChunkSize개씩 나눠 작업 풀에서 처리합니다.
+    //   1. 청크 안에서 적분하고 수명이 다한 파티클을 분기 없이 앞으로 당겨 압축
+    //      (살아 있는지와 상관없이 쓰기 위치에 쓰고, 살아 있으면 위치를 하나 늘림)
+    //   2. 청크마다 남은 파티클을 이어 붙임 (memmove)
+    //   3. 끝에 새 파티클을 생성
+    // 살아 있는 파티클은 항상 [0, count)에 모여 있으므로 WriteInstances()는 Map한 버퍼에 그대로 쓰고
+    // 이미터마다 DrawIndexedInstanced() 한 번으로 그립니다.
+    class ParticleSystem {
+    public:
+        static constexpr uint32_t kChunkSize = 4096; // 4의 배수
+
+        uint32_t AddEmitter(const EmitterSettings &settings, uint32_t seed = 1);
+        void SetEmitterPosition(uint32_t emitter, const Vector3 &position)
+        {
+            m_emitters[emitter].settings.position = position;
+        }
+        void Clear() { m_emitters.clear(); }
+
+        void Update(float dt, JobSystem &jobSystem);
+
+        // 살아 있는 파티클을 out에 씀 (GetParticleCount(emitter)개). out은 쓰기만 하므로 Map한 메모리여도 됨
+        void WriteInstances(uint32_t emitter, ParticleInstance *out, JobSystem &jobSystem);
+
+        uint32_t GetEmitterCount() const { return uint32_t(m_emitters.size()); }
+        uint32_t GetParticleCount(uint32_t emitter) const { return m_emitters[emitter].count; }
+        uint32_t GetCapacity(uint32_t emitter) const { return m_emitters[emitter].settings.maxParticles; }
+        uint64_t GetParticleCount() const;
+        const ParticleStats &GetStats() const { return m_stats; }
+
+    private:
+        // 성분별 배열. 크기는 maxParticles를 4의 배수로 올린 값
+        struct Emitter {
+            EmitterSettings settings;
+            std::vector<float> positionX, positionY, positionZ;
+            std::vector<float> velocityX, velocityY, velocityZ;
+            std::vector<float> age;         // 정규화한 나이 [0, 1). 1 이상이면 제거
+            std::vector<float> invLifetime; // 1 / 수명
+            uint32_t count = 0;
+            float spawnAccumulator = 0.0f;
+            uint32_t random = 1; // xorshift32 상태
+        };
+
+        struct Chunk {
+            uint32_t emitter = 0;
+            uint32_t begin = 0;
+            uint32_t end = 0;
+            uint32_t alive = 0; // 압축 후 [begin, begin + alive)
+        };
+
+        static void SimulateChunk(Emitter &emitter, Chunk &chunk, float dt);
+        static void Spawn(Emitter &emitter, float dt, ParticleStats &stats);
+
+        std::vector<Emitter> m_emitters;
+        std::vector<Chunk> m_chunks;
+        ParticleStats m_stats;
+    };
+}
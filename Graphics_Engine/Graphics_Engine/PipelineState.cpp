@@ -0,0 +1,402 @@
+#include "PipelineState.h"
+
+#include <chrono>
+#include <cstring>
+#include <d3dcompiler.h>
+#include <iostream>
+#include <tuple>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        void HashCombine(size_t &seed, size_t value)
+        {
+            seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+        }
+
+        // D3D11 상태 desc는 필드 사이에 패딩이 있어서 (UINT8 마스크 뒤) 바이트로 비교하면
+        // 값이 같아도 만든 방법에 따라 다르게 나올 수 있으므로 필드를 하나씩 비교/해시
+        auto Fields(const D3D11_RASTERIZER_DESC &d)
+        {
+            return tie(d.FillMode, d.CullMode, d.FrontCounterClockwise, d.DepthBias, d.DepthBiasClamp,
+                       d.SlopeScaledDepthBias, d.DepthClipEnable, d.ScissorEnable, d.MultisampleEnable,
+                       d.AntialiasedLineEnable);
+        }
+
+        auto Fields(const D3D11_DEPTH_STENCILOP_DESC &d)
+        {
+            return tie(d.StencilFailOp, d.StencilDepthFailOp, d.StencilPassOp, d.StencilFunc);
+        }
+
+        auto Fields(const D3D11_DEPTH_STENCIL_DESC &d)
+        {
+            return tuple_cat(tie(d.DepthEnable, d.DepthWriteMask, d.DepthFunc, d.StencilEnable, d.StencilReadMask,
+                                 d.StencilWriteMask),
+                             Fields(d.FrontFace), Fields(d.BackFace));
+        }
+
+        auto Fields(const D3D11_RENDER_TARGET_BLEND_DESC &d)
+        {
+            return tie(d.BlendEnable, d.SrcBlend, d.DestBlend, d.BlendOp, d.SrcBlendAlpha, d.DestBlendAlpha,
+                       d.BlendOpAlpha, d.RenderTargetWriteMask);
+        }
+
+        template <typename T>
+        size_t HashFields(const T &desc)
+        {
+            size_t seed = 0;
+            apply([&](const auto &...fields) { (HashCombine(seed, hash<decay_t<decltype(fields)>>()(fields)), ...); },
+                  Fields(desc));
+            return seed;
+        }
+
+        template <typename T>
+        bool EqualFields(const T &a, const T &b)
+        {
+            return Fields(a) == Fields(b);
+        }
+
+        size_t HashFields(const D3D11_BLEND_DESC &desc)
+        {
+            size_t seed = 0;
+            HashCombine(seed, hash<BOOL>()(desc.AlphaToCoverageEnable));
+            HashCombine(seed, hash<BOOL>()(desc.IndependentBlendEnable));
+            for (const auto &target : desc.RenderTarget)
+                HashCombine(seed, HashFields(target));
+            return seed;
+        }
+
+        bool EqualFields(const D3D11_BLEND_DESC &a, const D3D11_BLEND_DESC &b)
+        {
+            if (a.AlphaToCoverageEnable != b.AlphaToCoverageEnable ||
+                a.IndependentBlendEnable != b.IndependentBlendEnable)
+                return false;
+            for (size_t i = 0; i < D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT; i++) {
+                if (!EqualFields(a.RenderTarget[i], b.RenderTarget[i]))
+                    return false;
+            }
+            return true;
+        }
+
+        bool EqualInputElements(const vector<D3D11_INPUT_ELEMENT_DESC> &a,
+                                const vector<D3D11_INPUT_ELEMENT_DESC> &b)
+        {
+            if (a.size() != b.size())
+                return false;
+
+            for (size_t i = 0; i < a.size(); i++) {
+                if (strcmp(a[i].SemanticName, b[i].SemanticName) != 0 ||
+                    a[i].SemanticIndex != b[i].SemanticIndex || a[i].Format != b[i].Format ||
+                    a[i].InputSlot != b[i].InputSlot ||
+                    a[i].AlignedByteOffset != b[i].AlignedByteOffset ||
+                    a[i].InputSlotClass != b[i].InputSlotClass ||
+                    a[i].InstanceDataStepRate != b[i].InstanceDataStepRate)
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    PipelineStateDesc PipelineStateDesc::Default()
+    {
+        PipelineStateDesc desc;
+
+        ZeroMemory(&desc.rasterizer, sizeof(desc.rasterizer));
+        desc.rasterizer.FillMode = D3D11_FILL_MODE::D3D11_FILL_SOLID;
+        desc.rasterizer.CullMode = D3D11_CULL_MODE::D3D11_CULL_NONE;
+        desc.rasterizer.FrontCounterClockwise = false;
+        desc.rasterizer.DepthClipEnable = true; // <- zNear, zFar 확인에 필요
+
+        ZeroMemory(&desc.depthStencil, sizeof(desc.depthStencil));
+        desc.depthStencil.DepthEnable = true;
+        desc.depthStencil.DepthWriteMask = D3D11_DEPTH_WRITE_MASK::D3D11_DEPTH_WRITE_MASK_ALL;
+        desc.depthStencil.DepthFunc = D3D11_COMPARISON_FUNC::D3D11_COMPARISON_LESS_EQUAL;
+
+        ZeroMemory(&desc.blend, sizeof(desc.blend));
+        for (auto &target : desc.blend.RenderTarget) {
+            target.BlendEnable = false;
+            target.SrcBlend = D3D11_BLEND_ONE;
+            target.DestBlend = D3D11_BLEND_ZERO;
+            target.BlendOp = D3D11_BLEND_OP_ADD;
+            target.SrcBlendAlpha = D3D11_BLEND_ONE;
+            target.DestBlendAlpha = D3D11_BLEND_ZERO;
+            target.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+            target.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+        }
+
+        desc.topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+        return desc;
+    }
+
+    size_t PipelineStateDesc::Hash() const
+    {
+        size_t seed = 0;
+        HashCombine(seed, hash<wstring>()(vertexShaderFile));
+        HashCombine(seed, hash<wstring>()(pixelShaderFile));
+        for (const ShaderDefine &define : defines) {
+            HashCombine(seed, hash<string>()(define.name));
+            HashCombine(seed, hash<string>()(define.value));
+        }
+        for (const auto &element : inputElements) {
+            HashCombine(seed, hash<string_view>()(element.SemanticName));
+            HashCombine(seed, element.SemanticIndex);
+            HashCombine(seed, element.Format);
+            HashCombine(seed, element.AlignedByteOffset);
+        }
+        HashCombine(seed, HashFields(rasterizer));
+        HashCombine(seed, HashFields(depthStencil));
+        HashCombine(seed, HashFields(blend));
+        HashCombine(seed, topology);
+        return seed;
+    }
+
+    bool PipelineStateDesc::operator==(const PipelineStateDesc &other) const
+    {
+        return vertexShaderFile == other.vertexShaderFile &&
+               pixelShaderFile == other.pixelShaderFile && defines == other.defines &&
+               EqualInputElements(inputElements, other.inputElements) &&
+               EqualFields(rasterizer, other.rasterizer) &&
+               EqualFields(depthStencil, other.depthStencil) && EqualFields(blend, other.blend) &&
+               topology == other.topology;
+    }
+
+    void PipelineState::Bind(ID3D11DeviceContext *context) const
+    {
+        context->IASetInputLayout(m_inputLayout.Get());
+        context->IASetPrimitiveTopology(m_topology);
+        context->VSSetShader(m_vertexShader.Get(), 0, 0);
+        context->RSSetState(m_rasterizerState.Get());
+        context->PSSetShader(m_pixelShader.Get(), 0, 0);
+        context->OMSetDepthStencilState(m_depthStencilState.Get(), 0);
+        context->OMSetBlendState(m_blendState.Get(), nullptr, 0xffffffff);
+    }
+
+    void PipelineStateCache::Initialize(ID3D11Device *device, ShaderHotReloader *reloader)
+    {
+        m_device = device;
+        m_reloader = reloader;
+    }
+
+    const vector<uint8_t> *PipelineStateCache::GetBytecode(const wstring &file,
+                                                           const string &profile,
+                                                           const ShaderDefines &defines)
+    {
+        const string key = MakeShaderKey(file, profile, defines);
+        {
+            lock_guard<mutex> lock(m_bytecodeMutex);
+            auto it = m_bytecode.find(key);
+            if (it != m_bytecode.end())
+                return &it->second;
+        }
+
+        // 컴파일은 잠금 밖에서. 두 스레드가 같은 쉐이더를 동시에 컴파일할 수는 있지만
+        // 먼저 넣은 결과를 함께 사용합니다.
+        vector<uint8_t> bytecode;
+        string errors;
+        if (!CompileShaderFile(file, profile, defines, bytecode, errors)) {
+            cout << "Shader compile error\n" << errors << endl;
+            return nullptr;
+        }
+
+        lock_guard<mutex> lock(m_bytecodeMutex);
+        auto result = m_bytecode.emplace(key, std::move(bytecode));
+        if (result.second)
+            m_stats.shaderCount++;
+        return &result.first->second;
+    }
+
+    bool PipelineStateCache::Build(const PipelineStateDesc &desc, const vector<uint8_t> &vertexShader,
+                                   const vector<uint8_t> &pixelShader, PipelineState &pipeline) const
+    {
+        // 같은 desc의 상태 객체는 D3D11 런타임이 알아서 같은 객체를 돌려줍니다.
+        if (FAILED(m_device->CreateVertexShader(vertexShader.data(), vertexShader.size(), NULL,
+                                                &pipeline.m_vertexShader)) ||
+            FAILED(m_device->CreatePixelShader(pixelShader.data(), pixelShader.size(), NULL,
+                                               &pipeline.m_pixelShader)) ||
+            // 입력이 SV_VertexID뿐인 쉐이더(화면을 덮는 삼각형)는 입력 레이아웃 없이 바인딩
+            (!desc.inputElements.empty() &&
+             FAILED(m_device->CreateInputLayout(desc.inputElements.data(),
+                                                UINT(desc.inputElements.size()), vertexShader.data(),
+                                                vertexShader.size(), &pipeline.m_inputLayout))) ||
+            FAILED(m_device->CreateRasterizerState(&desc.rasterizer, &pipeline.m_rasterizerState)) ||
+            FAILED(m_device->CreateDepthStencilState(&desc.depthStencil,
+                                                     &pipeline.m_depthStencilState)) ||
+            FAILED(m_device->CreateBlendState(&desc.blend, &pipeline.m_blendState)))
+        {
+            cout << "PipelineStateCache: failed to create pipeline objects." << endl;
+            return false;
+        }
+
+        pipeline.m_topology = desc.topology;
+        return true;
+    }
+
+    bool PipelineStateCache::Build(const PipelineStateDesc &desc, PipelineState &pipeline)
+    {
+        const vector<uint8_t> *vertexShader =
+            GetBytecode(desc.vertexShaderFile, "vs_5_0", desc.defines);
+        const vector<uint8_t> *pixelShader = GetBytecode(desc.pixelShaderFile, "ps_5_0", desc.defines);
+        if (!vertexShader || !pixelShader)
+            return false;
+
+        return Build(desc, *vertexShader, *pixelShader, pipeline);
+    }
+
+    PipelineHandle PipelineStateCache::Insert(const PipelineStateDesc &desc, PipelineState &&pipeline)
+    {
+        Entry entry;
+        entry.desc = desc;
+        entry.handle = m_pipelines.Create(std::move(pipeline));
+        entry.vertexShaderKey = MakeShaderKey(desc.vertexShaderFile, "vs_5_0", desc.defines);
+        entry.pixelShaderKey = MakeShaderKey(desc.pixelShaderFile, "ps_5_0", desc.defines);
+
+        if (m_reloader) {
+            m_reloader->Watch(desc.vertexShaderFile, "vs_5_0", desc.defines);
+            m_reloader->Watch(desc.pixelShaderFile, "ps_5_0", desc.defines);
+        }
+
+        const PipelineHandle handle = entry.handle;
+        m_entries.emplace(desc.Hash(), std::move(entry));
+        m_stats.pipelineCount = uint32_t(m_pipelines.GetCount());
+        return handle;
+    }
+
+    PipelineHandle PipelineStateCache::Find(const PipelineStateDesc &desc) const
+    {
+        const auto range = m_entries.equal_range(desc.Hash());
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.desc == desc)
+                return it->second.handle;
+        }
+        return PipelineHandle();
+    }
+
+    PipelineHandle PipelineStateCache::GetOrCreate(const PipelineStateDesc &desc)
+    {
+        const PipelineHandle existing = Find(desc);
+        if (!existing.IsNull()) {
+            m_stats.hits++;
+            return existing;
+        }
+
+        m_stats.misses++;
+        PipelineState pipeline;
+        if (!Build(desc, pipeline))
+            return PipelineHandle();
+
+        return Insert(desc, std::move(pipeline));
+    }
+
+    vector<PipelineHandle> PipelineStateCache::Prewarm(const vector<PipelineStateDesc> &descs,
+                                                       JobSystem &jobSystem)
+    {
+        const auto start = chrono::high_resolution_clock::now();
+
+        // 캐시에 있거나 목록 안에서 앞에 나온 desc는 만들지 않음 (GetOrCreate()와 같이 hit/miss를 셈)
+        vector<PipelineHandle> handles(descs.size());
+        vector<size_t> sources(descs.size()); // 같은 desc 중 처음 나온 번호
+        vector<size_t> misses;
+        unordered_multimap<size_t, size_t> pending; // desc 해시 -> 새로 만들 desc 번호
+        for (size_t i = 0; i < descs.size(); i++) {
+            sources[i] = i;
+            handles[i] = Find(descs[i]);
+            if (!handles[i].IsNull()) {
+                m_stats.hits++;
+                continue;
+            }
+
+            const auto range = pending.equal_range(descs[i].Hash());
+            auto it = find_if(range.first, range.second,
+                              [&](const auto &item) { return descs[item.second] == descs[i]; });
+            if (it != range.second) {
+                sources[i] = it->second;
+                m_stats.hits++;
+                continue;
+            }
+
+            m_stats.misses++;
+            pending.emplace(descs[i].Hash(), i);
+            misses.push_back(i);
+        }
+
+        // 없는 것만 쉐이더 컴파일과 D3D 객체 생성을 병렬로 하고 (ID3D11Device는 스레드 안전)
+        // 캐시에 넣는 것은 현재 스레드에서 순서대로 합니다.
+        vector<PipelineState> pipelines(misses.size());
+        vector<uint8_t> succeeded(misses.size(), 0);
+        jobSystem.ParallelFor(misses.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                succeeded[i] = Build(descs[misses[i]], pipelines[i]) ? 1 : 0;
+        });
+
+        for (size_t i = 0; i < misses.size(); i++) {
+            if (succeeded[i])
+                handles[misses[i]] = Insert(descs[misses[i]], std::move(pipelines[i]));
+        }
+        for (size_t i = 0; i < descs.size(); i++) {
+            if (sources[i] != i)
+                handles[i] = handles[sources[i]];
+        }
+
+        m_stats.prewarmMs =
+            chrono::duration<float, milli>(chrono::high_resolution_clock::now() - start).count();
+        return handles;
+    }
+
+    bool PipelineStateCache::ApplyReloadedShader(const CompiledShader &shader)
+    {
+        const string key = MakeShaderKey(shader.path, shader.profile, shader.defines);
+        {
+            lock_guard<mutex> lock(m_bytecodeMutex);
+            auto it = m_bytecode.find(key);
+            if (it == m_bytecode.end())
+                return false; // 이 캐시가 쓰지 않는 쉐이더
+            it->second = shader.bytecode;
+        }
+
+        bool applied = false;
+        for (auto &[hashValue, entry] : m_entries) {
+            if (entry.vertexShaderKey != key && entry.pixelShaderKey != key)
+                continue;
+
+            const vector<uint8_t> &vertexShader = m_bytecode[entry.vertexShaderKey];
+            const vector<uint8_t> &pixelShader = m_bytecode[entry.pixelShaderKey];
+
+            // 새 객체를 다 만든 뒤에 통째로 교체 (실패하면 이전 파이프라인 유지)
+            PipelineState pipeline;
+            if (!Build(entry.desc, vertexShader, pixelShader, pipeline))
+                continue;
+
+            *m_pipelines.Get(entry.handle) = std::move(pipeline);
+            applied = true;
+        }
+        return applied;
+    }
+
+    bool CompileShaderFile(const filesystem::path &path, const string &profile,
+                           const ShaderDefines &defines, vector<uint8_t> &bytecode, string &errors)
+    {
+        vector<D3D_SHADER_MACRO> macros;
+        for (const ShaderDefine &define : defines)
+            macros.push_back({define.name.c_str(), define.value.c_str()});
+        macros.push_back({nullptr, nullptr});
+
+        ComPtr<ID3DBlob> shaderBlob;
+        ComPtr<ID3DBlob> errorBlob;
+
+        // 주의: 쉐이더의 시작점의 이름이 "main"인 함수로 지정
+        HRESULT hr = D3DCompileFromFile(path.c_str(), macros.data(), D3D_COMPILE_STANDARD_FILE_INCLUDE,
+                                        "main", profile.c_str(), 0, 0, &shaderBlob, &errorBlob);
+        if (FAILED(hr)) {
+            if (errorBlob)
+                errors.assign((const char *)errorBlob->GetBufferPointer(), errorBlob->GetBufferSize());
+            else
+                errors = "D3DCompileFromFile() failed.";
+            return false;
+        }
+
+        const uint8_t *begin = (const uint8_t *)shaderBlob->GetBufferPointer();
+        bytecode.assign(begin, begin + shaderBlob->GetBufferSize());
+        return true;
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <d3d11.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wrl.h> // ComPtr
+
+#include "HandlePool.h"
+#include "JobSystem.h"
+#include "ShaderHotReloader.h"
+
+namespace luke {
+
+    using Microsoft::WRL::ComPtr;
+
+    // 파이프라인 하나를 만드는 데 필요한 모든 설정
+    // Default()로 시작해서 필요한 값만 바꾸세요.
+    // (desc 구조체들을 바이트 단위로 비교/해시하므로 패딩까지 0으로 초기화돼 있어야 합니다.)
+    struct PipelineStateDesc {
+        std::wstring vertexShaderFile;
+        std::wstring pixelShaderFile;
+        ShaderDefines defines; // 퍼뮤테이션 키. 버텍스/픽셀 쉐이더 모두에 적용
+        std::vector<D3D11_INPUT_ELEMENT_DESC> inputElements;
+        D3D11_RASTERIZER_DESC rasterizer;
+        D3D11_DEPTH_STENCIL_DESC depthStencil;
+        D3D11_BLEND_DESC blend;
+        D3D11_PRIMITIVE_TOPOLOGY topology;
+
+        static PipelineStateDesc Default();
+
+        size_t Hash() const;
+        bool operator==(const PipelineStateDesc &other) const;
+    };
+
+    // 한 번 만들어지면 바뀌지 않는 파이프라인 상태
+    // 쉐이더 + 입력 레이아웃 + 래스터라이저 + 깊이/스텐실 + 블렌드 + 토폴로지를 한 번에 바인딩합니다.
+    class PipelineState {
+    public:
+        void Bind(ID3D11DeviceContext *context) const;
+
+    private:
+        friend class PipelineStateCache;
+
+        ComPtr<ID3D11VertexShader> m_vertexShader;
+        ComPtr<ID3D11PixelShader> m_pixelShader;
+        ComPtr<ID3D11InputLayout> m_inputLayout;
+        ComPtr<ID3D11RasterizerState> m_rasterizerState;
+        ComPtr<ID3D11DepthStencilState> m_depthStencilState;
+        ComPtr<ID3D11BlendState> m_blendState;
+        D3D11_PRIMITIVE_TOPOLOGY m_topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    };
+
+    struct PipelineTag;
+    using PipelineHandle = Handle<PipelineTag>;
+
+    struct PipelineCacheStats {
+        uint32_t pipelineCount = 0;
+        uint32_t shaderCount = 0; // 컴파일된 쉐이더 (파일 + 프로파일 + defines) 개수
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        float prewarmMs = 0.0f;
+    };
+
+    // 같은 desc로 요청하면 같은 핸들을 돌려주는 파이프라인 캐시
+    // 쉐이더 바이트코드도 (파일, 프로파일, defines) 단위로 캐시해서
+    // 상태만 다른 퍼뮤테이션끼리는 다시 컴파일하지 않습니다.
+    // 쉐이더 파일이 바뀌면 (ShaderHotReloader) 관련 파이프라인을 새로 만들어서 교체합니다.
+    class PipelineStateCache {
+    public:
+        void Initialize(ID3D11Device *device, ShaderHotReloader *reloader);
+
+        PipelineHandle GetOrCreate(const PipelineStateDesc &desc);
+        const PipelineState *Get(PipelineHandle handle) const { return m_pipelines.Get(handle); }
+
+        // 시작할 때 필요한 퍼뮤테이션을 병렬로 미리 만들어 둡니다.
+        std::vector<PipelineHandle> Prewarm(const std::vector<PipelineStateDesc> &descs,
+                                            JobSystem &jobSystem);
+
+        // Graphics::ApplyReloadedShader()에서 프레임 경계에 호출
+        bool ApplyReloadedShader(const CompiledShader &shader);
+
+        const PipelineCacheStats &GetStats() const { return m_stats; }
+
+    private:
+        struct Entry {
+            PipelineStateDesc desc;
+            PipelineHandle handle;
+            std::string vertexShaderKey;
+            std::string pixelShaderKey;
+        };
+
+        // 여러 스레드에서 동시에 불릴 수 있음
+        const std::vector<uint8_t> *GetBytecode(const std::wstring &file, const std::string &profile,
+                                                const ShaderDefines &defines);
+        bool Build(const PipelineStateDesc &desc, const std::vector<uint8_t> &vertexShader,
+                   const std::vector<uint8_t> &pixelShader, PipelineState &pipeline) const;
+        bool Build(const PipelineStateDesc &desc, PipelineState &pipeline);
+        PipelineHandle Find(const PipelineStateDesc &desc) const;
+        PipelineHandle Insert(const PipelineStateDesc &desc, PipelineState &&pipeline);
+
+        ComPtr<ID3D11Device> m_device;
+        ShaderHotReloader *m_reloader = nullptr;
+
+        HandlePool<PipelineState, PipelineTag> m_pipelines;
+        std::unordered_multimap<size_t, Entry> m_entries; // desc 해시 -> 항목
+
+        std::mutex m_bytecodeMutex;
+        std::map<std::string, std::vector<uint8_t>> m_bytecode; // 쉐이더 키 -> 바이트코드
+
+        PipelineCacheStats m_stats;
+    };
+
+    // D3DCompileFromFile()로 쉐이더 파일 하나를 컴파일합니다. 여러 스레드에서 불러도 안전합니다.
+    bool CompileShaderFile(const std::filesystem::path &path, const std::string &profile,
+                           const ShaderDefines &defines, std::vector<uint8_t> &bytecode,
+                           std::string &errors);
+}
@@ -0,0 +1,291 @@
+#include "Profiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        void WriteTraceEvent(ofstream &file, bool &first, const char *name, int thread, double startMs,
+                             double durationMs)
+        {
+            file << (first ? "\n" : ",\n") << "{\"name\":\"";
+            for (const char *c = name; *c; c++) {
+                if (*c == '"' || *c == '\\')
+                    file << '\\';
+                file << *c;
+            }
+            // Chrome trace의 시간 단위는 마이크로초
+            file << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread << ",\"ts\":" << startMs * 1000.0
+                 << ",\"dur\":" << durationMs * 1000.0 << "}";
+            first = false;
+        }
+    }
+
+    Profiler::Profiler() : m_epoch(Clock::now())
+    {
+        // 프레임 중에는 할당하지 않도록 최대 크기로 미리 잡아둠
+        auto reserve = [](ProfileFrame &frame) {
+            frame.cpuEvents.reserve(kMaxScopes);
+            frame.gpuEvents.reserve(kMaxScopes);
+        };
+        for (PendingFrame &slot : m_slots) {
+            reserve(slot.frame);
+            slot.gpuScopes.reserve(kMaxScopes);
+        }
+        m_history.resize(kHistoryFrames);
+        for (ProfileFrame &frame : m_history)
+            reserve(frame);
+        m_ticks.resize(kMaxTimestamps);
+    }
+
+    void Profiler::SetGpuTimestamps(GpuTimestamps *gpu)
+    {
+        // 이전 백엔드의 쿼리 결과는 더 이상 읽을 수 없음
+        for (PendingFrame &slot : m_slots)
+            slot.pending = false;
+        m_gpu = gpu;
+    }
+
+    void Profiler::BeginFrame()
+    {
+        const uint64_t frame = m_frameIndex++;
+        if (m_current)
+            EndFrame();
+
+        // 도착한 GPU 결과를 오래된 프레임부터 모음 (순서를 지키기 위해 처음 안 된 곳에서 멈춤)
+        while (true) {
+            PendingFrame *oldest = nullptr;
+            for (PendingFrame &slot : m_slots)
+                if (slot.pending && (!oldest || slot.frame.frame < oldest->frame.frame))
+                    oldest = &slot;
+            if (!oldest || !Resolve(*oldest))
+                break;
+        }
+
+        m_currentSlot = uint32_t(frame % kLatency);
+        PendingFrame &slot = m_slots[m_currentSlot];
+
+        // kLatency 프레임이 지나도 결과가 없으면 CPU 기록만 남김
+        if (slot.pending) {
+            m_stats.gpuFramesDropped++;
+            slot.frame.gpuValid = false;
+            slot.frame.gpuEvents.clear();
+            slot.pending = false;
+            Publish(slot.frame);
+        }
+
+        slot.frame.frame = frame;
+        slot.frame.startMs = NowMs();
+        slot.frame.cpuMs = 0.0;
+        slot.frame.gpuMs = 0.0;
+        slot.frame.gpuValid = false;
+        slot.frame.cpuEvents.clear();
+        slot.frame.gpuEvents.clear();
+        slot.gpuScopes.clear();
+        slot.timestampCount = 0;
+        m_cpuDepth = 0;
+        m_gpuDepth = 0;
+        m_cpuOverflow = 0;
+        m_gpuOverflow = 0;
+        m_current = &slot;
+
+        if (m_gpu) {
+            m_gpu->BeginTimestampFrame(m_currentSlot);
+            m_gpu->WriteTimestamp(m_currentSlot, slot.timestampCount++);
+        }
+    }
+
+    void Profiler::EndFrame()
+    {
+        if (!m_current)
+            return;
+
+        while (m_cpuOverflow > 0 || m_cpuDepth > 0)
+            EndCpuScope();
+        while (m_gpuOverflow > 0 || m_gpuDepth > 0)
+            EndGpuScope();
+
+        PendingFrame &slot = *m_current;
+        slot.frame.cpuMs = NowMs() - slot.frame.startMs;
+        m_current = nullptr;
+
+        if (!m_gpu) {
+            Publish(slot.frame);
+            return;
+        }
+
+        m_gpu->WriteTimestamp(m_currentSlot, slot.timestampCount++);
+        m_gpu->EndTimestampFrame(m_currentSlot);
+        slot.pending = true;
+    }
+
+    void Profiler::BeginCpuScope(const char *name)
+    {
+        if (!m_current)
+            return;
+
+        vector<ProfileEvent> &events = m_current->frame.cpuEvents;
+        if (m_cpuOverflow > 0 || events.size() >= kMaxScopes) {
+            m_cpuOverflow++;
+            m_stats.scopesDropped++;
+            return;
+        }
+
+        ProfileEvent event;
+        event.name = name;
+        event.depth = m_cpuDepth;
+        event.startMs = NowMs() - m_current->frame.startMs;
+        event.endMs = event.startMs;
+        m_cpuStack[m_cpuDepth++] = uint32_t(events.size());
+        events.push_back(event);
+    }
+
+    void Profiler::EndCpuScope()
+    {
+        if (m_cpuOverflow > 0) {
+            m_cpuOverflow--;
+            return;
+        }
+        if (!m_current || m_cpuDepth == 0)
+            return;
+
+        ProfileEvent &event = m_current->frame.cpuEvents[m_cpuStack[--m_cpuDepth]];
+        event.endMs = NowMs() - m_current->frame.startMs;
+    }
+
+    void Profiler::BeginGpuScope(const char *name)
+    {
+        if (!m_current || !m_gpu)
+            return;
+
+        PendingFrame &slot = *m_current;
+        if (m_gpuOverflow > 0 || slot.gpuScopes.size() >= kMaxScopes) {
+            m_gpuOverflow++;
+            m_stats.scopesDropped++;
+            return;
+        }
+
+        ProfileEvent event;
+        event.name = name;
+        event.depth = m_gpuDepth;
+        GpuScope scope;
+        scope.event = uint32_t(slot.frame.gpuEvents.size());
+        scope.beginIndex = slot.timestampCount++;
+        scope.endIndex = scope.beginIndex;
+        m_gpu->WriteTimestamp(m_currentSlot, scope.beginIndex);
+
+        m_gpuStack[m_gpuDepth++] = uint32_t(slot.gpuScopes.size());
+        slot.frame.gpuEvents.push_back(event);
+        slot.gpuScopes.push_back(scope);
+    }
+
+    void Profiler::EndGpuScope()
+    {
+        if (m_gpuOverflow > 0) {
+            m_gpuOverflow--;
+            return;
+        }
+        if (!m_current || !m_gpu || m_gpuDepth == 0)
+            return;
+
+        GpuScope &scope = m_current->gpuScopes[m_gpuStack[--m_gpuDepth]];
+        scope.endIndex = m_current->timestampCount++;
+        m_gpu->WriteTimestamp(m_currentSlot, scope.endIndex);
+    }
+
+    const ProfileFrame &Profiler::GetFrame(size_t index) const
+    {
+        return m_history[(m_historyStart + index) % kHistoryFrames];
+    }
+
+    const ProfileFrame *Profiler::GetLatestFrame() const
+    {
+        return m_historyCount > 0 ? &GetFrame(m_historyCount - 1) : nullptr;
+    }
+
+    bool Profiler::ExportTrace(const filesystem::path &path) const
+    {
+        ofstream file(path);
+        if (!file) {
+            cout << "Cannot write " << path.string() << endl;
+            return false;
+        }
+
+        file << fixed << setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+                "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+                "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+        bool first = false;
+        for (size_t i = 0; i < m_historyCount; i++) {
+            const ProfileFrame &frame = GetFrame(i);
+            const string name = "Frame " + to_string(frame.frame);
+            WriteTraceEvent(file, first, name.c_str(), 1, frame.startMs, frame.cpuMs);
+            for (const ProfileEvent &event : frame.cpuEvents)
+                WriteTraceEvent(file, first, event.name, 1, frame.startMs + event.startMs,
+                                event.endMs - event.startMs);
+
+            if (!frame.gpuValid)
+                continue;
+            WriteTraceEvent(file, first, name.c_str(), 2, frame.startMs, frame.gpuMs);
+            for (const ProfileEvent &event : frame.gpuEvents)
+                WriteTraceEvent(file, first, event.name, 2, frame.startMs + event.startMs,
+                                event.endMs - event.startMs);
+        }
+        file << "\n]}\n";
+        return bool(file);
+    }
+
+    double Profiler::NowMs() const
+    {
+        return chrono::duration<double, milli>(Clock::now() - m_epoch).count();
+    }
+
+    bool Profiler::Resolve(PendingFrame &pending)
+    {
+        const uint32_t slot = uint32_t(&pending - m_slots);
+        uint64_t frequency = 0;
+        if (!m_gpu->TryReadTimestamps(slot, pending.timestampCount, m_ticks.data(), frequency))
+            return false;
+
+        ProfileFrame &frame = pending.frame;
+        if (frequency == 0) {
+            m_stats.gpuFramesDisjoint++;
+            frame.gpuValid = false;
+            frame.gpuEvents.clear();
+        }
+        else {
+            const uint64_t start = m_ticks[0];
+            auto toMs = [&](uint32_t index) { return double(m_ticks[index] - start) * 1000.0 / double(frequency); };
+            for (const GpuScope &scope : pending.gpuScopes) {
+                ProfileEvent &event = frame.gpuEvents[scope.event];
+                event.startMs = toMs(scope.beginIndex);
+                event.endMs = toMs(scope.endIndex);
+            }
+            frame.gpuMs = toMs(pending.timestampCount - 1);
+            frame.gpuValid = true;
+        }
+
+        pending.pending = false;
+        Publish(frame);
+        return true;
+    }
+
+    void Profiler::Publish(const ProfileFrame &frame)
+    {
+        size_t index;
+        if (m_historyCount < kHistoryFrames) {
+            index = (m_historyStart + m_historyCount) % kHistoryFrames;
+            m_historyCount++;
+        }
+        else {
+            index = m_historyStart;
+            m_historyStart = (m_historyStart + 1) % kHistoryFrames;
+        }
+        // 벡터 용량은 미리 잡아뒀으므로 복사해도 할당하지 않음
+        m_history[index] = frame;
+        m_stats.framesResolved++;
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace luke {
+
+    // GPU 타임스탬프를 기록하는 백엔드 (D3D11Timestamps, HeadlessBackend)
+    // 쿼리는 frameSlot(0 ~ Profiler::kLatency - 1)마다 따로 두고,
+    // 결과는 몇 프레임 뒤에 기다리지 않고 읽습니다.
+    class GpuTimestamps {
+    public:
+        virtual ~GpuTimestamps() = default;
+
+        // D3D11_QUERY_TIMESTAMP_DISJOINT의 Begin()/End()에 해당
+        virtual void BeginTimestampFrame(uint32_t frameSlot) = 0;
+        virtual void EndTimestampFrame(uint32_t frameSlot) = 0;
+        // index: 0 ~ Profiler::kMaxTimestamps - 1
+        virtual void WriteTimestamp(uint32_t frameSlot, uint32_t index) = 0;
+        // 결과가 준비됐으면 ticks[0, count)와 초당 tick 수를 채우고 true를 반환합니다.
+        // 아직이면 기다리지 않고 false. 측정 중 클럭이 바뀌었으면(disjoint) frequency = 0
+        virtual bool TryReadTimestamps(uint32_t frameSlot, uint32_t count, uint64_t *ticks,
+                                       uint64_t &frequency) = 0;
+    };
+
+    struct ProfileEvent {
+        const char *name = nullptr; // 문자열 리터럴 (포인터만 보관)
+        uint32_t depth = 0;         // 중첩 깊이 (0이 가장 바깥)
+        double startMs = 0.0;       // 프레임 시작(CPU) 기준
+        double endMs = 0.0;
+    };
+
+    // CPU 스코프와 GPU 스코프를 한 시간축에 합친 프레임 하나
+    // D3D11에는 CPU/GPU 클럭을 맞추는 방법이 없으므로 GPU 이벤트는 프레임의 첫 타임스탬프를
+    // CPU의 BeginFrame() 시각에 맞춰서 놓습니다. (실제 GPU 시작은 그보다 늦을 수 있음)
+    struct ProfileFrame {
+        uint64_t frame = 0;
+        double startMs = 0.0; // Profiler를 만든 시각 기준 CPU 시각
+        double cpuMs = 0.0;   // BeginFrame() ~ EndFrame()
+        double gpuMs = 0.0;   // 첫 타임스탬프 ~ 마지막 타임스탬프
+        bool gpuValid = false; // GPU 결과가 있음 (GPU가 없거나 disjoint, 늦어서 버렸으면 false)
+        std::vector<ProfileEvent> cpuEvents;
+        std::vector<ProfileEvent> gpuEvents;
+    };
+
+    struct ProfilerStats {
+        uint64_t framesResolved = 0;
+        uint64_t gpuFramesDropped = 0; // kLatency 프레임 안에 GPU 결과가 오지 않아 버림
+        uint64_t gpuFramesDisjoint = 0;
+        uint64_t scopesDropped = 0;    // kMaxScopes를 넘은 스코프
+    };
+
+    // 프레임마다 CPU 스코프(시계)와 GPU 스코프(타임스탬프 쿼리)를 기록하고,
+    // GPU 결과가 도착하면(보통 1~3 프레임 뒤) 하나의 타임라인으로 합쳐서 최근 kHistoryFrames개를 보관합니다.
+    // GPU를 기다리지 않으므로 프레임 시간에 영향을 주지 않으며, 버퍼는 미리 잡아두어서 프레임마다 할당하지 않습니다.
+    // 스코프는 한 스레드(렌더링 스레드)에서만 기록하세요.
+    class Profiler {
+    public:
+        static constexpr uint32_t kLatency = 4;
+        static constexpr uint32_t kMaxScopes = 32; // 프레임당 CPU, GPU 각각
+        static constexpr uint32_t kMaxTimestamps = 2 * kMaxScopes + 2;
+        static constexpr uint32_t kHistoryFrames = 240;
+
+        Profiler();
+
+        Profiler(const Profiler &) = delete;
+        Profiler &operator=(const Profiler &) = delete;
+
+        // nullptr이면 CPU 스코프만 기록
+        void SetGpuTimestamps(GpuTimestamps *gpu);
+
+        // BeginFrame()에서 도착한 GPU 결과를 모아서 타임라인을 완성합니다.
+        // 프레임 번호는 0부터 BeginFrame()마다 1씩 증가
+        void BeginFrame();
+        void EndFrame(); // 닫히지 않은 스코프는 여기서 닫음
+
+        void BeginCpuScope(const char *name);
+        void EndCpuScope();
+        void BeginGpuScope(const char *name);
+        void EndGpuScope();
+
+        // 완성된 프레임. 0이 가장 오래된 것
+        size_t GetFrameCount() const { return m_historyCount; }
+        const ProfileFrame &GetFrame(size_t index) const;
+        const ProfileFrame *GetLatestFrame() const;
+        const ProfilerStats &GetStats() const { return m_stats; }
+
+        // Chrome trace 형식(JSON). chrome://tracing이나 ui.perfetto.dev에서 열 수 있습니다.
+        // CPU는 스레드 "CPU", GPU는 스레드 "GPU"로 보입니다.
+        bool ExportTrace(const std::filesystem::path &path) const;
+
+    private:
+        struct GpuScope {
+            uint32_t event;      // frame.gpuEvents 인덱스
+            uint32_t beginIndex; // 타임스탬프 인덱스
+            uint32_t endIndex;
+        };
+
+        struct PendingFrame {
+            ProfileFrame frame;
+            std::vector<GpuScope> gpuScopes;
+            uint32_t timestampCount = 0;
+            bool pending = false; // GPU 결과를 기다리는 중
+        };
+
+        double NowMs() const;
+        bool Resolve(PendingFrame &pending); // GPU 결과가 아직이면 false
+        void Publish(const ProfileFrame &frame);
+
+        using Clock = std::chrono::high_resolution_clock;
+        Clock::time_point m_epoch;
+        GpuTimestamps *m_gpu = nullptr;
+
+        PendingFrame m_slots[kLatency];
+        PendingFrame *m_current = nullptr;
+        uint32_t m_currentSlot = 0;
+        uint64_t m_frameIndex = 0;
+        uint32_t m_cpuStack[kMaxScopes];
+        uint32_t m_cpuDepth = 0;
+        uint32_t m_gpuStack[kMaxScopes];
+        uint32_t m_gpuDepth = 0;
+        uint32_t m_cpuOverflow = 0; // 열렸지만 기록하지 않은 스코프 (End를 맞추기 위함)
+        uint32_t m_gpuOverflow = 0;
+
+        std::vector<ProfileFrame> m_history; // kHistoryFrames 크기의 원형 버퍼
+        size_t m_historyStart = 0;
+        size_t m_historyCount = 0;
+        std::vector<uint64_t> m_ticks;
+
+        ProfilerStats m_stats;
+    };
+
+    // 범위가 끝나면 스코프를 닫는 도우미. profiler가 nullptr이면 아무것도 하지 않습니다.
+    class CpuProfileScope {
+    public:
+        CpuProfileScope(Profiler *profiler, const char *name) : m_profiler(profiler)
+        {
+            if (m_profiler)
+                m_profiler->BeginCpuScope(name);
+        }
+        ~CpuProfileScope()
+        {
+            if (m_profiler)
+                m_profiler->EndCpuScope();
+        }
+
+        CpuProfileScope(const CpuProfileScope &) = delete;
+        CpuProfileScope &operator=(const CpuProfileScope &) = delete;
+
+    private:
+        Profiler *m_profiler;
+    };
+
+    class GpuProfileScope {
+    public:
+        GpuProfileScope(Profiler *profiler, const char *name) : m_profiler(profiler)
+        {
+            if (m_profiler)
+                m_profiler->BeginGpuScope(name);
+        }
+        ~GpuProfileScope()
+        {
+            if (m_profiler)
+                m_profiler->EndGpuScope();
+        }
+
+        GpuProfileScope(const GpuProfileScope &) = delete;
+        GpuProfileScope &operator=(const GpuProfileScope &) = delete;
+
+    private:
+        Profiler *m_profiler;
+    };
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GpuMemory.h"
+#include "HandlePool.h"
+
+namespace luke {
+
+    struct GpuBufferTag;
+    using GpuBufferHandle = Handle<GpuBufferTag>;
+
+    struct RenderTargetTag;
+    using RenderTargetHandle = Handle<RenderTargetTag>;
+
+    // Structured: 쉐이더가 StructuredBuffer로 읽는 버퍼 (SetShaderBuffer)
+    enum class GpuBufferType : uint32_t { Vertex, Index, Constant, Structured };
+
+    // 백엔드가 한 프레임 동안 받은 명령 수
+    struct RenderStats {
+        uint64_t drawCalls = 0;
+        uint64_t indexCount = 0;    // 인스턴스 드로우는 인덱스 수 x 인스턴스 수
+        uint64_t instanceCount = 0; // DrawIndexedInstanced()로 그린 인스턴스
+        uint64_t bufferBinds = 0;   // 버텍스/인덱스/인스턴스/상수/쉐이더 버퍼 바인딩
+        uint64_t bufferCreates = 0;
+        uint64_t bufferUpdates = 0; // Map/Unmap 횟수
+        uint64_t bytesUploaded = 0; // 생성 시 초기 데이터 + 업데이트
+    };
+
+    // 렌더링 명령을 받는 최소한의 인터페이스
+    // D3D11을 직접 부르는 Graphics와 달리 창/디바이스 없이도 장면 코드를 돌릴 수 있도록
+    // 버퍼와 드로우 명령만 추상화합니다. (HeadlessBackend 참고)
+    class RenderBackend {
+    public:
+        virtual ~RenderBackend() = default;
+
+        virtual void BeginFrame() = 0;
+        virtual void EndFrame() = 0;
+
+        // dynamic이면 UpdateBuffer()로 내용을 바꿀 수 있습니다. data는 nullptr이어도 됩니다.
+        virtual GpuBufferHandle CreateBuffer(GpuBufferType type, const void *data, size_t size,
+                                             bool dynamic) = 0;
+        virtual void UpdateBuffer(GpuBufferHandle buffer, const void *data, size_t size) = 0;
+        // dynamic이 아닌 버퍼의 [offset, offset + size)만 바꿉니다. (D3D11의 UpdateSubresource)
+        virtual void UpdateBufferRange(GpuBufferHandle buffer, size_t offset, const void *data, size_t size) = 0;
+        virtual void DestroyBuffer(GpuBufferHandle buffer) = 0;
+        // dynamic 버퍼 전체를 쓰기 전용으로 엽니다. (D3D11_MAP_WRITE_DISCARD: 이전 내용은 없어짐)
+        // 반환된 메모리는 읽지 말고 앞에서부터 쓰기만 하세요. UnmapBuffer()에는 실제로 쓴 바이트 수를 넘깁니다.
+        virtual void *MapBuffer(GpuBufferHandle buffer) = 0;
+        virtual void UnmapBuffer(GpuBufferHandle buffer, size_t writtenBytes) = 0;
+
+        virtual void SetVertexBuffer(GpuBufferHandle buffer, uint32_t stride) = 0;
+        virtual void SetIndexBuffer(GpuBufferHandle buffer) = 0; // 16비트 인덱스
+        // 인스턴스마다 읽는 버텍스 버퍼 (D3D11의 슬롯 1, D3D11_INPUT_PER_INSTANCE_DATA)
+        // offset 바이트부터 첫 인스턴스로 읽음 (IASetVertexBuffers의 offset. 한 버퍼를 여러 드로우가 나눠 쓸 때)
+        virtual void SetInstanceBuffer(GpuBufferHandle buffer, uint32_t stride, size_t offset = 0) = 0;
+        virtual void SetConstantBuffer(uint32_t slot, GpuBufferHandle buffer) = 0;
+        // 상수 버퍼의 [offset, offset + size)만 바인딩합니다. (D3D11.1의 VSSetConstantBuffers1)
+        // offset과 size는 kConstantBufferAlignment(256바이트)의 배수여야 합니다. (ShaderConstants.h)
+        virtual void SetConstantBufferRange(uint32_t slot, GpuBufferHandle buffer, size_t offset, size_t size) = 0;
+        // Structured 버퍼를 픽셀 쉐이더의 t 슬롯에 바인딩 (D3D11이면 SRV)
+        virtual void SetShaderBuffer(uint32_t slot, GpuBufferHandle buffer) = 0;
+        virtual void DrawIndexed(uint32_t indexCount, uint32_t startIndex, int32_t baseVertex) = 0;
+        virtual void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex) = 0;
+
+        // 오프스크린 렌더 타겟 (RGBA8 색상 + 깊이)
+        // 바인딩된 타겟이 없으면 드로우는 기록만 되고 픽셀은 만들어지지 않습니다.
+        virtual RenderTargetHandle CreateRenderTarget(uint32_t width, uint32_t height) = 0;
+        virtual void DestroyRenderTarget(RenderTargetHandle target) = 0;
+        // target을 바인딩하고 clearColor와 깊이 1.0으로 지웁니다. 빈 핸들이면 바인딩 해제.
+        virtual void SetRenderTarget(RenderTargetHandle target, const float clearColor[4]) = 0;
+
+        // target의 현재 내용을 CPU가 읽을 수 있는 스테이징 메모리로 복사하도록 예약합니다.
+        // (D3D11의 CopyResource(staging, texture)에 해당)
+        virtual void CopyToStaging(RenderTargetHandle target) = 0;
+        // 복사가 끝났으면 픽셀(행 우선 RGBA8)을 rgba에 넣고 true를 반환합니다.
+        // 아직 끝나지 않았으면 기다리지 않고 false를 반환합니다. (D3D11_MAP_FLAG_DO_NOT_WAIT)
+        virtual bool TryReadStaging(RenderTargetHandle target, std::vector<uint8_t> &rgba) = 0;
+
+        // 버퍼의 현재 내용을 data로 복사합니다. 명령 캡처(CommandRecorder)가 캡처 전에 만들어진 버퍼의
+        // 내용을 저장할 때 사용하며, 읽을 수 없는 백엔드는 false를 반환합니다. (D3D11이면 스테이징 복사)
+        virtual bool ReadBuffer(GpuBufferHandle buffer, std::vector<uint8_t> &data) const
+        {
+            (void)buffer;
+            (void)data;
+            return false;
+        }
+
+        // BeginFrame()부터 센 이번 프레임 통계와 처음부터 센 누적 통계
+        const RenderStats &GetFrameStats() const { return m_frameStats; }
+        const RenderStats &GetTotalStats() const { return m_totalStats; }
+
+        // 잘못된 핸들 바인딩, 범위를 벗어난 드로우 같은 API 오용 횟수
+        virtual uint64_t GetErrorCount() const { return 0; }
+
+        // 버퍼와 렌더 타겟을 만들고 지울 때마다 tracker에 기록합니다. (nullptr이면 기록하지 않음)
+        // tracker의 hard 예산을 넘는 Create*()는 빈 핸들을 반환합니다. (오용이 아니므로 GetErrorCount()에는 세지 않고
+        // tracker의 failedAllocations에 셈)
+        // 이미 만든 리소스는 기록되지 않으므로 리소스를 만들기 전에 설정하세요.
+        // 지우지 않고 남은 리소스는 백엔드가 없어져도 tracker에 남습니다. (D3D11의 누수 보고처럼 보임)
+        void SetMemoryTracker(GpuMemoryTracker *tracker) { m_memoryTracker = tracker; }
+        GpuMemoryTracker *GetMemoryTracker() const { return m_memoryTracker; }
+
+    protected:
+        RenderStats m_frameStats;
+        RenderStats m_totalStats;
+        GpuMemoryTracker *m_memoryTracker = nullptr;
+    };
+}
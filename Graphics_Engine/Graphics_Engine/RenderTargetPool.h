@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace luke {
+
+    // 풀에서 찾는 키. format/bindFlags는 백엔드 값을 그대로 넣습니다. (DXGI_FORMAT, D3D11_BIND_FLAG)
+    struct RenderTargetDesc {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t format = 0;
+        uint32_t samples = 1;
+        uint32_t bindFlags = 0;
+
+        bool operator==(const RenderTargetDesc &other) const = default;
+    };
+
+    struct RenderTargetPoolSettings {
+        // 가로/세로를 이 단위로 올려서 만듭니다. 창 크기를 조금씩 바꾸는 동안은 같은 타겟을 계속 쓰고,
+        // 실제로 그리는 영역은 뷰포트로 맞춥니다. 1이면 요청한 크기 그대로
+        uint32_t granularity = 64;
+        // 이 프레임 수 동안 쓰이지 않은 타겟은 BeginFrame()에서 삭제
+        uint32_t maxIdleFrames = 120;
+        size_t maxPooledTargets = 8; // 넘으면 가장 오래 쉰 것부터 삭제
+    };
+
+    struct RenderTargetPoolStats {
+        uint64_t created = 0;
+        uint64_t reused = 0;
+        uint64_t destroyed = 0;
+        uint64_t failed = 0;
+        size_t live = 0;   // Acquire() 했고 아직 Release() 하지 않음
+        size_t pooled = 0; // 다음 Acquire()를 기다리는 중
+    };
+
+    // 크기/포맷 버킷별로 렌더 타겟을 돌려 쓰는 풀
+    // 창 크기가 바뀌면 이전 타겟을 Release()하고 새 크기로 Acquire()하면 되는데,
+    // 같은 버킷이면 만들지 않고 그대로 돌려주므로 크기를 끄는 동안 할당이 튀지 않습니다.
+    // T_TARGET은 백엔드의 타겟 (D3D11 텍스처와 뷰들, HeadlessBackend의 RenderTargetHandle)
+    // 만들고 지우는 방법은 Initialize()에 넘기므로 D3D11 없이 HeadlessBackend로도 돌려볼 수 있습니다.
+    template <typename T_TARGET>
+    class RenderTargetPool {
+    public:
+        // desc는 버킷 크기. 실패하면 false
+        using CreateFunction = std::function<bool(const RenderTargetDesc &desc, T_TARGET &target)>;
+        // 비어 있으면 T_TARGET의 소멸자에 맡김 (ComPtr)
+        using DestroyFunction = std::function<void(T_TARGET &target)>;
+
+        RenderTargetPool() = default;
+        ~RenderTargetPool() { Clear(); }
+
+        RenderTargetPool(const RenderTargetPool &) = delete;
+        RenderTargetPool &operator=(const RenderTargetPool &) = delete;
+
+        void Initialize(CreateFunction create, DestroyFunction destroy = {},
+                        const RenderTargetPoolSettings &settings = {})
+        {
+            Clear();
+            m_create = std::move(create);
+            m_destroy = std::move(destroy);
+            m_settings = settings;
+            m_settings.granularity = std::max(m_settings.granularity, 1u);
+        }
+
+        // desc의 가로/세로를 granularity 단위로 올린 크기 (실제로 만들어지는 크기)
+        RenderTargetDesc GetBucket(const RenderTargetDesc &desc) const
+        {
+            RenderTargetDesc bucket = desc;
+            const uint32_t g = m_settings.granularity;
+            bucket.width = std::max((desc.width + g - 1) / g * g, g);
+            bucket.height = std::max((desc.height + g - 1) / g * g, g);
+            return bucket;
+        }
+
+        // desc 크기 이상의 타겟을 꺼냅니다. 실제 크기는 GetBucket(desc)
+        bool Acquire(const RenderTargetDesc &desc, T_TARGET &target)
+        {
+            const RenderTargetDesc bucket = GetBucket(desc);
+            for (size_t i = 0; i < m_free.size(); i++) {
+                if (m_free[i].desc == bucket) {
+                    target = std::move(m_free[i].target);
+                    m_free.erase(m_free.begin() + i);
+                    m_stats.reused++;
+                    m_stats.live++;
+                    m_stats.pooled = m_free.size();
+                    return true;
+                }
+            }
+
+            if (!m_create || !m_create(bucket, target)) {
+                m_stats.failed++;
+                return false;
+            }
+            m_stats.created++;
+            m_stats.live++;
+            return true;
+        }
+
+        // Acquire()에 넘긴 desc와 함께 돌려줍니다.
+        void Release(const RenderTargetDesc &desc, T_TARGET target)
+        {
+            if (m_stats.live > 0)
+                m_stats.live--;
+
+            Entry entry;
+            entry.desc = GetBucket(desc);
+            entry.target = std::move(target);
+            entry.lastUsedFrame = m_frameIndex;
+            m_free.push_back(std::move(entry));
+
+            while (m_free.size() > m_settings.maxPooledTargets)
+                DestroyEntry(0); // 앞쪽이 가장 오래 쉰 것
+            m_stats.pooled = m_free.size();
+        }
+
+        // 프레임 경계에서 호출합니다. 오래 쓰이지 않은 타겟을 삭제
+        void BeginFrame(uint64_t frameIndex)
+        {
+            m_frameIndex = frameIndex;
+            for (size_t i = m_free.size(); i-- > 0;) {
+                if (m_free[i].lastUsedFrame + m_settings.maxIdleFrames < frameIndex)
+                    DestroyEntry(i);
+            }
+            m_stats.pooled = m_free.size();
+        }
+
+        // 쉬고 있는 타겟을 모두 삭제 (Acquire()한 타겟은 그대로)
+        void Clear()
+        {
+            while (!m_free.empty())
+                DestroyEntry(m_free.size() - 1);
+            m_stats.pooled = 0;
+        }
+
+        const RenderTargetPoolSettings &GetSettings() const { return m_settings; }
+        const RenderTargetPoolStats &GetStats() const { return m_stats; }
+
+    private:
+        struct Entry {
+            RenderTargetDesc desc;
+            T_TARGET target;
+            uint64_t lastUsedFrame = 0;
+        };
+
+        void DestroyEntry(size_t index)
+        {
+            if (m_destroy)
+                m_destroy(m_free[index].target);
+            m_free.erase(m_free.begin() + index);
+            m_stats.destroyed++;
+        }
+
+        CreateFunction m_create;
+        DestroyFunction m_destroy;
+        RenderTargetPoolSettings m_settings;
+        std::vector<Entry> m_free; // Release()한 순서
+        uint64_t m_frameIndex = 0;
+        RenderTargetPoolStats m_stats;
+    };
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <d3d11.h>
+#include <wrl.h> // ComPtr
+
+#include "HandlePool.h"
+#include "Mesh.h"
+#include "ObjectPool.h"
+
+namespace luke {
+
+    using Microsoft::WRL::ComPtr;
+
+    struct MeshTag;
+    struct BufferTag;
+    struct ShaderTag;
+    using MeshHandle = Handle<MeshTag>;
+    using BufferHandle = Handle<BufferTag>;
+    using ShaderHandle = Handle<ShaderTag>;
+
+    // 버텍스 쉐이더, 픽셀 쉐이더와 입력 레이아웃 한 벌
+    struct ShaderProgram {
+        ComPtr<ID3D11VertexShader> m_vertexShader;
+        ComPtr<ID3D11PixelShader> m_pixelShader;
+        ComPtr<ID3D11InputLayout> m_inputLayout;
+    };
+
+    // Mesh 본체는 ObjectPool의 고정 슬롯에 두고 HandlePool에는 슬롯을 가리키는 포인터만 둡니다.
+    // 스트리밍으로 메쉬를 자주 만들고 지워도 힙 할당이 없고, 삭제할 때 dense 배열에서는 포인터만 옮깁니다.
+    // 인터페이스는 HandlePool과 같음
+    class MeshStore {
+    public:
+        MeshHandle Create(Mesh mesh) { return m_handles.Create(m_pool.MakeUnique(std::move(mesh))); }
+
+        Mesh *Get(MeshHandle handle)
+        {
+            ObjectPool<Mesh>::UniquePtr *mesh = m_handles.Get(handle);
+            return mesh ? mesh->get() : nullptr;
+        }
+
+        bool Destroy(MeshHandle handle) { return m_handles.Destroy(handle); }
+        void Release(MeshHandle handle, uint64_t frameIndex) { m_handles.Release(handle, frameIndex); }
+        void BeginFrame(uint64_t frameIndex) { m_handles.BeginFrame(frameIndex); }
+
+        size_t GetCount() const { return m_handles.GetCount(); }
+        size_t GetPoolCapacity() const { return m_pool.GetCapacity(); }
+
+    private:
+        ObjectPool<Mesh> m_pool; // m_handles보다 먼저 선언해서 나중에 소멸
+        HandlePool<ObjectPool<Mesh>::UniquePtr, MeshTag> m_handles;
+    };
+
+    // 메쉬/버퍼/쉐이더를 종류별 dense 배열에 모아두는 저장소
+    // shared_ptr 대신 32비트 핸들로 가리키므로 복사와 조회에 원자적 참조 카운트가 없습니다.
+    class ResourceRegistry {
+    public:
+        // Graphics::Run()에서 프레임 시작마다 호출
+        void BeginFrame(uint64_t frameIndex)
+        {
+            m_meshes.BeginFrame(frameIndex);
+            m_buffers.BeginFrame(frameIndex);
+            m_shaders.BeginFrame(frameIndex);
+        }
+
+        MeshStore m_meshes;
+        HandlePool<ComPtr<ID3D11Buffer>, BufferTag> m_buffers;
+        HandlePool<ShaderProgram, ShaderTag> m_shaders;
+    };
+}
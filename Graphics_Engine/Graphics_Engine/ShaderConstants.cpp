@@ -0,0 +1,95 @@
+#include "ShaderConstants.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace luke {
+    using namespace std;
+
+    FrameConstants MakeFrameConstants(const Matrix &view, const Matrix &projection, float time, float deltaTime)
+    {
+        FrameConstants constants;
+        constants.view = view.Transpose();
+        constants.projection = projection.Transpose();
+        constants.viewProjection = (view * projection).Transpose();
+        constants.time = time;
+        constants.deltaTime = deltaTime;
+        return constants;
+    }
+
+    ObjectConstants MakeObjectConstants(const Matrix &world)
+    {
+        // 쉐이더가 쓰는 (world^-1)^T를 전치해서 올리므로 world^-1을 넣어야 하는데,
+        // 법선은 픽셀 쉐이더에서 정규화하니 방향만 맞으면 됨. 4x4 역행렬 대신 3x3 여인수 행렬
+        // (행 두 개씩의 외적. (det * world^-1)의 전치)을 쓰고 det의 부호만 맞춤
+        const Vector3 row0(world.m[0][0], world.m[0][1], world.m[0][2]);
+        const Vector3 row1(world.m[1][0], world.m[1][1], world.m[1][2]);
+        const Vector3 row2(world.m[2][0], world.m[2][1], world.m[2][2]);
+        Vector3 cofactor0 = row1.Cross(row2);
+        Vector3 cofactor1 = row2.Cross(row0);
+        Vector3 cofactor2 = row0.Cross(row1);
+        if (row0.Dot(cofactor0) < 0.0f) {
+            cofactor0 = -cofactor0;
+            cofactor1 = -cofactor1;
+            cofactor2 = -cofactor2;
+        }
+
+        ObjectConstants constants;
+        constants.model = world.Transpose();
+        constants.normalMatrix = Matrix(cofactor0, cofactor1, cofactor2).Transpose();
+        return constants;
+    }
+
+    ObjectConstantBuffer::~ObjectConstantBuffer()
+    {
+        if (!m_buffer.IsNull())
+            m_backend.DestroyBuffer(m_buffer);
+    }
+
+    bool ObjectConstantBuffer::Begin(uint32_t count)
+    {
+        m_count = 0;
+        if (count == 0)
+            return false;
+        if (count > m_capacity) {
+            if (!m_buffer.IsNull())
+                m_backend.DestroyBuffer(m_buffer);
+            m_capacity = max(count, m_capacity + m_capacity / 2);
+            m_buffer = m_backend.CreateBuffer(GpuBufferType::Constant, nullptr,
+                                              size_t(m_capacity) * kConstantBufferAlignment, true);
+        }
+
+        m_mapped = static_cast<uint8_t *>(m_backend.MapBuffer(m_buffer));
+        if (!m_mapped)
+            return false;
+        m_count = count;
+        return true;
+    }
+
+    void ObjectConstantBuffer::Write(uint32_t object, const Matrix &world)
+    {
+        Write(object, MakeObjectConstants(world));
+    }
+
+    void ObjectConstantBuffer::Write(uint32_t object, const ObjectConstants &constants)
+    {
+        if (!m_mapped || object >= m_count)
+            return;
+        memcpy(m_mapped + size_t(object) * kConstantBufferAlignment, &constants, sizeof(constants));
+    }
+
+    void ObjectConstantBuffer::End()
+    {
+        if (!m_mapped)
+            return;
+        // 마지막 물체 뒤의 빈 공간은 올리지 않음
+        m_backend.UnmapBuffer(m_buffer, size_t(m_count - 1) * kConstantBufferAlignment + sizeof(ObjectConstants));
+        m_mapped = nullptr;
+    }
+
+    void ObjectConstantBuffer::Bind(uint32_t object) const
+    {
+        m_backend.SetConstantBufferRange(kObjectConstantSlot, m_buffer, size_t(object) * kConstantBufferAlignment,
+                                         kConstantBufferAlignment);
+    }
+}
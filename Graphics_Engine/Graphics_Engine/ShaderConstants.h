@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <directxtk/SimpleMath.h>
+
+#include "RenderBackend.h"
+
+namespace luke {
+
+    using DirectX::SimpleMath::Matrix;
+    using DirectX::SimpleMath::Vector3;
+
+    // 갱신 빈도별 상수 버퍼 슬롯 (ColorVertexShader/ColorPixelShader/ParticleVertexShader와 같은 번호)
+    // b1은 클러스터 조명의 ClusterConstants
+    constexpr uint32_t kFrameConstantSlot = 0;
+    constexpr uint32_t kObjectConstantSlot = 2;
+    constexpr uint32_t kPassConstantSlot = 3;
+
+    // 버퍼 일부를 바인딩할 때 오프셋과 크기의 단위 (D3D11.1 VSSetConstantBuffers1의 상수 16개)
+    constexpr size_t kConstantBufferAlignment = 256;
+
+    // 프레임(뷰)마다 한 번 올리는 카메라와 시간. 행렬은 HLSL에 맞게 전치한 상태
+    struct FrameConstants {
+        Matrix view;
+        Matrix projection;
+        Matrix viewProjection;
+        float time = 0.0f; // 초
+        float deltaTime = 0.0f;
+        float padding[2] = {};
+    };
+
+    // 렌더 패스마다 바뀌는 값. 픽셀 쉐이더의 SV_POSITION은 렌더 타겟 좌표이므로
+    // 뷰포트 안의 좌표가 필요하면 viewportX/Y를 뺍니다. (여러 뷰의 클러스터 타일)
+    struct PassConstants {
+        float viewportX = 0.0f;
+        float viewportY = 0.0f;
+        float viewportWidth = 0.0f;
+        float viewportHeight = 0.0f;
+        uint32_t passIndex = 0;
+        uint32_t padding[3] = {};
+    };
+
+    // 물체마다 바뀌는 값. 한 버퍼에 kConstantBufferAlignment 간격으로 이어 붙이고 오프셋으로 바인딩
+    struct ObjectConstants {
+        Matrix model;        // 전치한 world
+        Matrix normalMatrix; // 쉐이더에서는 world의 역전치에 비례 (3x3만 씀, 크기는 정규화로 무시)
+    };
+
+    static_assert(sizeof(FrameConstants) % 16 == 0);
+    static_assert(sizeof(PassConstants) % 16 == 0);
+    static_assert(sizeof(ObjectConstants) <= kConstantBufferAlignment);
+
+    // view/projection은 전치하지 않은 값
+    FrameConstants MakeFrameConstants(const Matrix &view, const Matrix &projection, float time = 0.0f,
+                                      float deltaTime = 0.0f);
+    ObjectConstants MakeObjectConstants(const Matrix &world);
+
+    // 한 프레임의 물체 상수를 동적 상수 버퍼 하나에 이어 쓰고, 그릴 때 물체의 범위만 바인딩합니다.
+    // 물체마다 상수 버퍼를 두고 매번 Map하는 대신 프레임에 Map 한 번으로 올립니다.
+    //   Begin(count) -> Write(0 ~ count - 1, world) -> End() -> 그릴 때마다 Bind(물체 번호)
+    // 서로 다른 번호의 Write()는 여러 스레드에서 동시에 불러도 됩니다.
+    // 용량이 모자라면 Begin()에서 1.5배로 다시 만들고, 다른 버퍼를 Map한 채로 부르면 안 됩니다.
+    class ObjectConstantBuffer {
+    public:
+        explicit ObjectConstantBuffer(RenderBackend &backend) : m_backend(backend) {}
+        ~ObjectConstantBuffer();
+
+        ObjectConstantBuffer(const ObjectConstantBuffer &) = delete;
+        ObjectConstantBuffer &operator=(const ObjectConstantBuffer &) = delete;
+
+        bool Begin(uint32_t count);
+        void Write(uint32_t object, const Matrix &world);
+        void Write(uint32_t object, const ObjectConstants &constants); // 미리 만든 상수 (움직이지 않는 물체)
+        void End();
+        void Bind(uint32_t object) const;
+
+        uint32_t GetCount() const { return m_count; }
+        uint32_t GetCapacity() const { return m_capacity; }
+
+    private:
+        RenderBackend &m_backend;
+        GpuBufferHandle m_buffer;
+        uint32_t m_capacity = 0;
+        uint32_t m_count = 0; // Begin()의 count
+        uint8_t *m_mapped = nullptr;
+    };
+}
@@ -0,0 +1,176 @@
+#include "ShaderHotReloader.h"
+
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        // 에디터가 저장하면서 여러 번 쓰기 이벤트를 보내므로,
+        // 마지막 변경 후 잠시 기다렸다가 한 번만 컴파일합니다.
+        constexpr chrono::milliseconds kSettleTime(100);
+
+        filesystem::path Normalize(const filesystem::path &path)
+        {
+            error_code error;
+            filesystem::path result = filesystem::weakly_canonical(path, error);
+            return error ? path : result;
+        }
+    }
+
+    string MakeShaderKey(const filesystem::path &file, const string &profile, const ShaderDefines &defines)
+    {
+        string key = Normalize(file).string() + "|" + profile;
+        for (const ShaderDefine &define : defines)
+            key += "|" + define.name + "=" + define.value;
+        return key;
+    }
+
+    ShaderHotReloader::ShaderHotReloader(ShaderCompiler compiler) : m_compiler(std::move(compiler))
+    {
+        m_compileThread = thread([this] { CompileLoop(); });
+    }
+
+    ShaderHotReloader::~ShaderHotReloader()
+    {
+        // 감시 스레드가 먼저 멈춰야 OnFileChanged()가 더 이상 불리지 않습니다.
+        m_watchers.clear();
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_changed.notify_all();
+        m_compileThread.join();
+    }
+
+    bool ShaderHotReloader::Watch(const filesystem::path &file, const string &profile,
+                                  const ShaderDefines &defines)
+    {
+        const filesystem::path path = Normalize(file);
+        const filesystem::path directory = path.parent_path();
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            auto &variants = m_watchedFiles[path];
+            for (const ShaderVariant &variant : variants) {
+                if (variant.profile == profile && variant.defines == defines)
+                    return true; // 이미 등록됨
+            }
+            variants.push_back({profile, defines});
+        }
+
+        for (const auto &watcher : m_watchers) {
+            if (watcher->GetDirectory() == directory)
+                return true;
+        }
+
+        auto watcher = make_unique<FileWatcher>();
+        if (!watcher->Start(directory, [this](const filesystem::path &changed) {
+                OnFileChanged(changed);
+            }))
+            return false;
+
+        m_watchers.push_back(std::move(watcher));
+        return true;
+    }
+
+    void ShaderHotReloader::OnFileChanged(const filesystem::path &file)
+    {
+        const filesystem::path path = Normalize(file);
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            if (m_watchedFiles.find(path) == m_watchedFiles.end())
+                return;
+            m_dirtyFiles[path] = Clock::now();
+        }
+        m_changed.notify_one();
+    }
+
+    void ShaderHotReloader::CompileLoop()
+    {
+        unique_lock<mutex> lock(m_mutex);
+
+        while (!m_stop) {
+            if (m_dirtyFiles.empty()) {
+                m_changed.wait(lock);
+                continue;
+            }
+
+            // 가장 오래 기다린 파일이 안정될 때까지 대기
+            auto oldest = m_dirtyFiles.begin();
+            for (auto it = m_dirtyFiles.begin(); it != m_dirtyFiles.end(); ++it) {
+                if (it->second < oldest->second)
+                    oldest = it;
+            }
+
+            const auto readyTime = oldest->second + kSettleTime;
+            if (Clock::now() < readyTime) {
+                m_changed.wait_until(lock, readyTime);
+                continue;
+            }
+
+            const filesystem::path path = oldest->first;
+            const vector<ShaderVariant> variants = m_watchedFiles[path];
+            m_dirtyFiles.erase(oldest);
+
+            // 컴파일하는 동안에는 잠금을 풀어서 렌더 스레드가 막히지 않도록 함
+            for (const ShaderVariant &variant : variants) {
+                lock.unlock();
+                CompiledShader shader;
+                shader.path = path;
+                shader.profile = variant.profile;
+                shader.defines = variant.defines;
+                string errors;
+                const bool succeeded =
+                    m_compiler(path, variant.profile, variant.defines, shader.bytecode, errors);
+                lock.lock();
+
+                if (succeeded) {
+                    m_compiled.push_back(std::move(shader));
+                }
+                else {
+                    m_failureCount++;
+                    m_lastError = path.filename().string() + ": " + errors;
+                    cout << "Shader reload failed, keeping previous version.\n"
+                         << m_lastError << endl;
+                }
+            }
+        }
+    }
+
+    size_t ShaderHotReloader::ApplyPending(const function<bool(const CompiledShader &)> &apply)
+    {
+        vector<CompiledShader> compiled;
+        {
+            lock_guard<mutex> lock(m_mutex);
+            if (m_compiled.empty())
+                return 0;
+            compiled.swap(m_compiled);
+        }
+
+        for (const CompiledShader &shader : compiled) {
+            if (apply(shader)) {
+                m_reloadCount++;
+                cout << "Shader reloaded: " << shader.path.filename().string() << endl;
+            }
+            else {
+                m_failureCount++;
+            }
+        }
+        return compiled.size();
+    }
+
+    size_t ShaderHotReloader::GetPendingCount()
+    {
+        lock_guard<mutex> lock(m_mutex);
+        return m_compiled.size();
+    }
+
+    string ShaderHotReloader::GetLastError()
+    {
+        lock_guard<mutex> lock(m_mutex);
+        return m_lastError;
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileWatcher.h"
+
+namespace luke {
+
+    // 쉐이더 매크로 (#define name value). 같은 파일의 퍼뮤테이션을 구분합니다.
+    struct ShaderDefine {
+        std::string name;
+        std::string value;
+
+        bool operator==(const ShaderDefine &other) const
+        {
+            return name == other.name && value == other.value;
+        }
+    };
+    using ShaderDefines = std::vector<ShaderDefine>;
+
+    // 백그라운드에서 컴파일을 끝낸 쉐이더
+    struct CompiledShader {
+        std::filesystem::path path;
+        std::string profile; // "vs_5_0", "ps_5_0" ...
+        ShaderDefines defines;
+        std::vector<uint8_t> bytecode;
+    };
+
+    // 캐시에서 쉐이더를 구분하는 키 (정규화된 경로 + 프로파일 + defines)
+    // 핫 리로드로 오는 CompiledShader의 경로도 정규화돼 있으므로 같은 키가 나옵니다.
+    std::string MakeShaderKey(const std::filesystem::path &file, const std::string &profile,
+                              const ShaderDefines &defines);
+
+    // 쉐이더 파일 하나를 컴파일하는 함수. 실패하면 errors에 메시지를 넣고 false를 반환합니다.
+    // Windows에서는 D3DCompileFromFile()을, 다른 플랫폼에서는 대체 컴파일러를 넘깁니다.
+    using ShaderCompiler = std::function<bool(
+        const std::filesystem::path &path, const std::string &profile, const ShaderDefines &defines,
+        std::vector<uint8_t> &bytecode, std::string &errors)>;
+
+    // 쉐이더 파일이 바뀌면 백그라운드 스레드에서 다시 컴파일하고,
+    // 렌더 스레드가 ApplyPending()을 부르는 프레임 경계에서만 결과를 넘겨줍니다.
+    // 컴파일에 실패하면 아무것도 넘기지 않으므로 이전 쉐이더가 그대로 쓰입니다.
+    class ShaderHotReloader {
+    public:
+        explicit ShaderHotReloader(ShaderCompiler compiler);
+        ~ShaderHotReloader();
+
+        ShaderHotReloader(const ShaderHotReloader &) = delete;
+        ShaderHotReloader &operator=(const ShaderHotReloader &) = delete;
+
+        // 파일이 있는 디렉토리를 감시하기 시작합니다.
+        // 같은 파일을 다른 defines로 여러 번 등록하면 파일이 바뀔 때 모두 다시 컴파일합니다.
+        // 여러 스레드에서 동시에 부르면 안 됩니다.
+        bool Watch(const std::filesystem::path &file, const std::string &profile,
+                   const ShaderDefines &defines = {});
+
+        // 컴파일이 끝난 쉐이더를 apply로 넘깁니다. apply가 false를 반환하면 실패로 셉니다.
+        // 렌더 스레드에서 프레임 시작 시 호출하세요. 넘긴 쉐이더 개수를 반환합니다.
+        size_t ApplyPending(const std::function<bool(const CompiledShader &)> &apply);
+
+        // 컴파일이 끝났고 아직 ApplyPending()으로 넘기지 않은 쉐이더 개수
+        size_t GetPendingCount();
+        uint32_t GetReloadCount() const { return m_reloadCount; }
+        uint32_t GetFailureCount() const { return m_failureCount; }
+        std::string GetLastError();
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        void OnFileChanged(const std::filesystem::path &file);
+        void CompileLoop();
+
+        ShaderCompiler m_compiler;
+        std::vector<std::unique_ptr<FileWatcher>> m_watchers;
+        struct ShaderVariant {
+            std::string profile;
+            ShaderDefines defines;
+        };
+        std::map<std::filesystem::path, std::vector<ShaderVariant>> m_watchedFiles;
+
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+        std::map<std::filesystem::path, Clock::time_point> m_dirtyFiles;
+        std::vector<CompiledShader> m_compiled;
+        std::string m_lastError;
+        bool m_stop = false;
+        std::thread m_compileThread;
+
+        std::atomic<uint32_t> m_reloadCount{0};
+        std::atomic<uint32_t> m_failureCount{0};
+    };
+}
@@ -0,0 +1,248 @@
+#include "SoftwareRasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace luke {
+    using namespace std;
+    using namespace DirectX;
+
+    namespace {
+        // 클립 공간 정점 (x, y, z, w)와 보간할 속성 N개
+        template <int N>
+        struct ClipVertex {
+            XMFLOAT4 position;
+            float attributes[N];
+        };
+
+        template <int N>
+        ClipVertex<N> Lerp(const ClipVertex<N> &a, const ClipVertex<N> &b, float t)
+        {
+            ClipVertex<N> result;
+            result.position = {a.position.x + (b.position.x - a.position.x) * t,
+                               a.position.y + (b.position.y - a.position.y) * t,
+                               a.position.z + (b.position.z - a.position.z) * t,
+                               a.position.w + (b.position.w - a.position.w) * t};
+            for (int i = 0; i < N; i++)
+                result.attributes[i] = a.attributes[i] + (b.attributes[i] - a.attributes[i]) * t;
+            return result;
+        }
+
+        uint32_t PackColor(float r, float g, float b, float a)
+        {
+            auto toByte = [](float value) {
+                return uint32_t(clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+            };
+            return toByte(r) | (toByte(g) << 8) | (toByte(b) << 16) | (toByte(a) << 24);
+        }
+
+        // 화면 공간 정점: 픽셀 좌표, 깊이, 1/w, 속성/w
+        template <int N>
+        struct ScreenVertex {
+            float x, y, z, invW;
+            float attributesOverW[N];
+        };
+
+        template <int N>
+        ScreenVertex<N> ToScreen(const ClipVertex<N> &v, float width, float height)
+        {
+            const float invW = 1.0f / v.position.w;
+            ScreenVertex<N> s;
+            s.x = (v.position.x * invW * 0.5f + 0.5f) * width;
+            s.y = (0.5f - v.position.y * invW * 0.5f) * height;
+            s.z = v.position.z * invW;
+            s.invW = invW;
+            for (int i = 0; i < N; i++)
+                s.attributesOverW[i] = v.attributes[i] * invW;
+            return s;
+        }
+
+        // shade(x, y, attributes)는 원근 보정한 속성으로 픽셀 색(RGBA8)을 반환
+        template <int N, typename Shade>
+        void RasterizeTriangle(SoftwareRenderTarget &target, ScreenVertex<N> v0, ScreenVertex<N> v1,
+                               ScreenVertex<N> v2, const Shade &shade)
+        {
+            float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+            if (area == 0.0f || !isfinite(area))
+                return;
+            // 컬링하지 않으므로 감긴 방향을 한쪽으로 맞춤
+            if (area < 0.0f) {
+                swap(v1, v2);
+                area = -area;
+            }
+
+            const int minX = max(0, int(floor(min({v0.x, v1.x, v2.x}))));
+            const int maxX = min(int(target.width) - 1, int(ceil(max({v0.x, v1.x, v2.x}))));
+            const int minY = max(0, int(floor(min({v0.y, v1.y, v2.y}))));
+            const int maxY = min(int(target.height) - 1, int(ceil(max({v0.y, v1.y, v2.y}))));
+            if (minX > maxX || minY > maxY)
+                return;
+
+            const float invArea = 1.0f / area;
+            auto edge = [](const ScreenVertex<N> &a, const ScreenVertex<N> &b, float px, float py) {
+                return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+            };
+
+            for (int y = minY; y <= maxY; y++) {
+                const float py = y + 0.5f;
+                uint32_t *colorRow = target.color.data() + size_t(y) * target.width;
+                float *depthRow = target.depth.data() + size_t(y) * target.width;
+
+                for (int x = minX; x <= maxX; x++) {
+                    const float px = x + 0.5f;
+                    const float w0 = edge(v1, v2, px, py);
+                    const float w1 = edge(v2, v0, px, py);
+                    const float w2 = edge(v0, v1, px, py);
+                    if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                        continue;
+
+                    const float b0 = w0 * invArea, b1 = w1 * invArea, b2 = w2 * invArea;
+                    const float z = b0 * v0.z + b1 * v1.z + b2 * v2.z;
+                    if (z < 0.0f || z > 1.0f || z > depthRow[x])
+                        continue;
+
+                    const float invW = b0 * v0.invW + b1 * v1.invW + b2 * v2.invW;
+                    const float w = 1.0f / invW;
+                    float attributes[N];
+                    for (int i = 0; i < N; i++)
+                        attributes[i] =
+                            (b0 * v0.attributesOverW[i] + b1 * v1.attributesOverW[i] + b2 * v2.attributesOverW[i]) * w;
+
+                    depthRow[x] = z;
+                    colorRow[x] = shade(x, y, attributes);
+                }
+            }
+        }
+
+        // 삼각형마다 정점을 클립 공간으로 옮기고 near plane으로 잘라서 그림
+        // setup(vertex, clip)은 clip.position과 clip.attributes를 채움
+        template <int N, typename Setup, typename Shade>
+        void DrawTriangles(SoftwareRenderTarget &target, span<const Vertex> vertices,
+                           span<const uint16_t> indices, int32_t baseVertex, const Setup &setup,
+                           const Shade &shade)
+        {
+            if (target.width == 0 || target.height == 0)
+                return;
+
+            const float width = float(target.width);
+            const float height = float(target.height);
+
+            for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+                ClipVertex<N> clip[3];
+                bool valid = true;
+                for (int k = 0; k < 3; k++) {
+                    const int64_t index = int64_t(indices[i + k]) + baseVertex;
+                    if (index < 0 || size_t(index) >= vertices.size()) {
+                        valid = false;
+                        break;
+                    }
+                    setup(vertices[size_t(index)], clip[k]);
+                }
+                if (!valid)
+                    continue;
+
+                // near plane (z >= 0)으로 잘라서 최대 4개의 정점으로 된 볼록 다각형을 만듦
+                ClipVertex<N> polygon[4];
+                int count = 0;
+                for (int k = 0; k < 3; k++) {
+                    const ClipVertex<N> &a = clip[k];
+                    const ClipVertex<N> &b = clip[(k + 1) % 3];
+                    const bool aInside = a.position.z >= 0.0f;
+                    const bool bInside = b.position.z >= 0.0f;
+                    if (aInside)
+                        polygon[count++] = a;
+                    if (aInside != bInside)
+                        polygon[count++] = Lerp(a, b, a.position.z / (a.position.z - b.position.z));
+                }
+                if (count < 3)
+                    continue;
+
+                // z >= 0 이고 투영 행렬의 near > 0 이면 w > 0 이므로 나눗셈이 안전함
+                ScreenVertex<N> screen[4];
+                for (int k = 0; k < count; k++) {
+                    if (polygon[k].position.w <= 0.0f) {
+                        count = 0;
+                        break;
+                    }
+                    screen[k] = ToScreen(polygon[k], width, height);
+                }
+                for (int k = 1; k + 1 < count; k++)
+                    RasterizeTriangle(target, screen[0], screen[k], screen[k + 1], shade);
+            }
+        }
+    }
+
+    void SoftwareRenderTarget::Resize(uint32_t newWidth, uint32_t newHeight)
+    {
+        width = newWidth;
+        height = newHeight;
+        color.assign(size_t(width) * height, 0);
+        depth.assign(size_t(width) * height, 1.0f);
+    }
+
+    void SoftwareRenderTarget::Clear(const float clearColor[4])
+    {
+        fill(color.begin(), color.end(),
+             PackColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]));
+        fill(depth.begin(), depth.end(), 1.0f);
+    }
+
+    void DrawColorTriangles(SoftwareRenderTarget &target, span<const Vertex> vertices,
+                            span<const uint16_t> indices, int32_t baseVertex,
+                            const Matrix &worldViewProjection)
+    {
+        const XMMATRIX transform = worldViewProjection;
+        DrawTriangles<3>(
+            target, vertices, indices, baseVertex,
+            [&](const Vertex &vertex, ClipVertex<3> &clip) {
+                const XMVECTOR position = XMVector4Transform(
+                    XMVectorSet(vertex.position.x, vertex.position.y, vertex.position.z, 1.0f), transform);
+                XMStoreFloat4(&clip.position, position);
+                clip.attributes[0] = vertex.color.x;
+                clip.attributes[1] = vertex.color.y;
+                clip.attributes[2] = vertex.color.z;
+            },
+            [](int, int, const float *color) { return PackColor(color[0], color[1], color[2], 1.0f); });
+    }
+
+    void DrawLitTriangles(SoftwareRenderTarget &target, span<const Vertex> vertices,
+                          span<const uint16_t> indices, int32_t baseVertex, const Matrix &world,
+                          const Matrix &normalMatrix, const Matrix &view, const Matrix &projection,
+                          const ClusteredLightData &lights)
+    {
+        const XMMATRIX worldMatrix = world;
+        const XMMATRIX normalTransform = normalMatrix;
+        const XMMATRIX viewMatrix = view;
+        const XMMATRIX projectionMatrix = projection;
+        const ClusterConstants &constants = lights.constants;
+        if (constants.tileCountX == 0 || constants.tileCountY == 0)
+            return;
+
+        // 속성: 색(3), 월드 위치(3), 월드 법선(3), 뷰 공간 z(1)
+        DrawTriangles<10>(
+            target, vertices, indices, baseVertex,
+            [&](const Vertex &vertex, ClipVertex<10> &clip) {
+                const XMVECTOR worldPosition = XMVector4Transform(
+                    XMVectorSet(vertex.position.x, vertex.position.y, vertex.position.z, 1.0f), worldMatrix);
+                const XMVECTOR viewPosition = XMVector4Transform(worldPosition, viewMatrix);
+                XMStoreFloat4(&clip.position, XMVector4Transform(viewPosition, projectionMatrix));
+                // ColorVertexShader와 같이 (float3x3)normalMatrix를 곱함 (정규화는 픽셀에서)
+                const XMVECTOR normal = XMVector3TransformNormal(XMLoadFloat3(&vertex.normal), normalTransform);
+                XMFLOAT3 p, n;
+                XMStoreFloat3(&p, worldPosition);
+                XMStoreFloat3(&n, normal);
+                const float values[10] = {vertex.color.x, vertex.color.y, vertex.color.z, p.x, p.y, p.z,
+                                          n.x, n.y, n.z, XMVectorGetZ(viewPosition)};
+                copy(begin(values), end(values), clip.attributes);
+            },
+            [&](int x, int y, const float *a) {
+                const uint32_t tileX = min(uint32_t((x + 0.5f) * constants.tileScaleX), constants.tileCountX - 1);
+                const uint32_t tileY = min(uint32_t((y + 0.5f) * constants.tileScaleY), constants.tileCountY - 1);
+                Vector3 normal(a[6], a[7], a[8]);
+                normal.Normalize();
+                const Vector3 color = ShadeClustered(lights, tileX, tileY, a[9], Vector3(a[0], a[1], a[2]),
+                                                     Vector3(a[3], a[4], a[5]), normal);
+                return PackColor(color.x, color.y, color.z, 1.0f);
+            });
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <directxtk/SimpleMath.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "ClusteredLighting.h"
+#include "MeshGenerator.h"
+
+namespace luke {
+
+    using DirectX::SimpleMath::Matrix;
+
+    // CPU 메모리에 있는 색상(RGBA8) + 깊이(float) 렌더 타겟
+    // 픽셀은 행 우선이고 color의 각 원소는 메모리에서 R, G, B, A 순서의 바이트입니다.
+    struct SoftwareRenderTarget {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint32_t> color;
+        std::vector<float> depth;
+
+        void Resize(uint32_t newWidth, uint32_t newHeight);
+        void Clear(const float clearColor[4]); // 깊이는 1.0으로
+    };
+
+    // ColorVertexShader/ColorPixelShader와 같은 계산을 CPU에서 합니다.
+    // 위치에 worldViewProjection(전치하기 전의 model * view * projection)을 곱하고
+    // 정점 색을 원근 보정해서 보간합니다. 깊이 테스트는 PipelineStateDesc::Default()와 같은 LESS_EQUAL,
+    // 컬링은 하지 않으며 near plane에 걸친 삼각형은 잘라서 그립니다.
+    // indices[i] + baseVertex가 vertices 범위를 벗어나는 삼각형은 건너뜁니다.
+    void DrawColorTriangles(SoftwareRenderTarget &target, std::span<const Vertex> vertices,
+                            std::span<const uint16_t> indices, int32_t baseVertex,
+                            const Matrix &worldViewProjection);
+
+    // ColorPixelShader(CLUSTERED_LIGHTING)와 같은 계산: 정점 색을 albedo로 보고 클러스터의 빛을 더합니다.
+    // world/normalMatrix/view/projection은 전치하기 전의 행렬이고, 타일은 픽셀 좌표에 lights.constants.tileScale을 곱해 찾습니다.
+    // normalMatrix는 ObjectConstants::normalMatrix를 전치한 것 (world의 역전치에 비례)
+    void DrawLitTriangles(SoftwareRenderTarget &target, std::span<const Vertex> vertices,
+                          std::span<const uint16_t> indices, int32_t baseVertex, const Matrix &world,
+                          const Matrix &normalMatrix, const Matrix &view, const Matrix &projection, const ClusteredLightData &lights);
+}
@@ -0,0 +1,235 @@
+#include "SpriteBatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+#include "MeshGenerator.h"
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        using Clock = chrono::high_resolution_clock;
+
+        constexpr size_t kWriteGrainSize = 16384;
+
+        double ElapsedMs(Clock::time_point start)
+        {
+            return chrono::duration<double, milli>(Clock::now() - start).count();
+        }
+
+        // UTF-8 한 글자를 읽고 text를 그만큼 넘김. 잘못된 바이트는 U+FFFD
+        uint32_t DecodeUtf8(string_view &text)
+        {
+            const uint8_t lead = uint8_t(text[0]);
+            const uint32_t length = lead < 0x80           ? 1
+                                    : (lead >> 5) == 0x6  ? 2
+                                    : (lead >> 4) == 0xE  ? 3
+                                    : (lead >> 3) == 0x1E ? 4
+                                                          : 0;
+            if (length == 0 || length > text.size()) {
+                text.remove_prefix(1);
+                return 0xFFFD;
+            }
+
+            uint32_t codepoint = length == 1 ? lead : lead & (0x7F >> length);
+            for (uint32_t i = 1; i < length; i++) {
+                const uint8_t next = uint8_t(text[i]);
+                if ((next >> 6) != 0x2) {
+                    text.remove_prefix(i);
+                    return 0xFFFD;
+                }
+                codepoint = (codepoint << 6) | (next & 0x3F);
+            }
+            text.remove_prefix(length);
+            return codepoint;
+        }
+    }
+
+    SpriteBatcher::SpriteBatcher(RenderBackend &backend) : m_backend(backend)
+    {
+        const MeshData quad = MeshGenerator::MakeSquare();
+        m_quadVertexBuffer = m_backend.CreateBuffer(GpuBufferType::Vertex, quad.vertices.data(),
+                                                    quad.vertices.size() * sizeof(Vertex), false);
+        m_quadIndexBuffer = m_backend.CreateBuffer(GpuBufferType::Index, quad.indices.data(),
+                                                   quad.indices.size() * sizeof(uint16_t), false);
+        m_quadIndexCount = uint32_t(quad.indices.size());
+    }
+
+    SpriteBatcher::~SpriteBatcher()
+    {
+        m_backend.DestroyBuffer(m_quadVertexBuffer);
+        m_backend.DestroyBuffer(m_quadIndexBuffer);
+        if (!m_stream.IsNull())
+            m_backend.DestroyBuffer(m_stream);
+    }
+
+    void SpriteBatcher::Begin()
+    {
+        m_instances.clear();
+        m_keys.clear();
+        m_batches.clear();
+    }
+
+    void SpriteBatcher::Add(const Sprite &sprite)
+    {
+        SpriteInstance instance;
+        instance.position = sprite.position;
+        instance.size = sprite.size;
+        instance.uvRect = sprite.uvRect;
+        instance.rotation = sprite.rotation;
+        instance.color = sprite.color;
+        m_instances.push_back(instance);
+        m_keys.push_back((uint32_t(sprite.layer) << 16) | sprite.texture);
+    }
+
+    float SpriteBatcher::AddText(GlyphAtlas &atlas, string_view text, const Vector2 &position, uint32_t color,
+                                 uint16_t layer, float scale)
+    {
+        Vector2 pen = position;
+        float width = 0.0f;
+        while (!text.empty()) {
+            const uint32_t codepoint = DecodeUtf8(text);
+            if (codepoint == '\n') {
+                width = max(width, pen.x - position.x);
+                pen.x = position.x;
+                pen.y += atlas.GetLineHeight() * scale;
+                continue;
+            }
+
+            const Glyph *glyph = atlas.GetGlyph(codepoint);
+            if (!glyph)
+                continue;
+            if (glyph->size.x > 0.0f) {
+                Sprite sprite;
+                sprite.size = glyph->size * scale;
+                sprite.position = pen + (glyph->offset + glyph->size * 0.5f) * scale;
+                sprite.uvRect = glyph->uvRect;
+                sprite.color = color;
+                sprite.texture = atlas.GetTexture();
+                sprite.layer = layer;
+                Add(sprite);
+            }
+            pen.x += glyph->advance * scale;
+        }
+        return max(width, pen.x - position.x);
+    }
+
+    void SpriteBatcher::End(JobSystem &jobSystem)
+    {
+        const uint32_t count = uint32_t(m_instances.size());
+        m_stats.spriteCount = count;
+        m_stats.batchCount = 0;
+        m_stats.sortPasses = 0;
+        m_stats.sortMs = 0.0;
+        m_stats.writeMs = 0.0;
+        m_batches.clear();
+        if (count == 0)
+            return;
+
+        auto start = Clock::now();
+        SortKeys();
+        m_stats.sortMs = ElapsedMs(start);
+
+        start = Clock::now();
+        if (!ReserveStream(count))
+            return;
+        SpriteInstance *out = static_cast<SpriteInstance *>(m_backend.MapBuffer(m_stream));
+        if (!out)
+            return;
+        // 쓰기 결합 메모리일 수 있으므로 앞에서부터 쓰기만 함 (정렬 순서로 모아 오기)
+        jobSystem.ParallelFor(count, kWriteGrainSize, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                out[i] = m_instances[m_order[i]];
+        });
+        m_backend.UnmapBuffer(m_stream, size_t(count) * sizeof(SpriteInstance));
+        m_stats.writeMs = ElapsedMs(start);
+
+        // 텍스처가 이어지는 구간이 배치 하나
+        for (uint32_t i = 0; i < count; i++) {
+            const uint16_t texture = uint16_t(m_sortedKeys[i] & 0xFFFF);
+            if (m_batches.empty() || m_batches.back().texture != texture)
+                m_batches.push_back({texture, i, 0});
+            m_batches.back().count++;
+        }
+        m_stats.batchCount = uint32_t(m_batches.size());
+    }
+
+    void SpriteBatcher::Draw(const function<void(uint16_t texture)> &bindTexture)
+    {
+        if (m_batches.empty())
+            return;
+
+        m_backend.SetVertexBuffer(m_quadVertexBuffer, sizeof(Vertex));
+        m_backend.SetIndexBuffer(m_quadIndexBuffer);
+        for (size_t i = 0; i < m_batches.size(); i++) {
+            const Batch &batch = m_batches[i];
+            if (bindTexture && (i == 0 || m_batches[i - 1].texture != batch.texture))
+                bindTexture(batch.texture);
+            m_backend.SetInstanceBuffer(m_stream, sizeof(SpriteInstance), size_t(batch.first) * sizeof(SpriteInstance));
+            m_backend.DrawIndexedInstanced(m_quadIndexCount, batch.count, 0);
+        }
+    }
+
+    void SpriteBatcher::SortKeys()
+    {
+        const uint32_t count = uint32_t(m_keys.size());
+        m_sortedKeys.assign(m_keys.begin(), m_keys.end());
+        m_order.resize(count);
+        iota(m_order.begin(), m_order.end(), 0u);
+        m_tempKeys.resize(count);
+        m_tempOrder.resize(count);
+
+        // 네 자릿수의 히스토그램을 한 번에 셈
+        uint32_t histograms[4][256] = {};
+        for (uint32_t key : m_sortedKeys) {
+            histograms[0][key & 0xFF]++;
+            histograms[1][(key >> 8) & 0xFF]++;
+            histograms[2][(key >> 16) & 0xFF]++;
+            histograms[3][key >> 24]++;
+        }
+
+        for (uint32_t digit = 0; digit < 4; digit++) {
+            uint32_t *histogram = histograms[digit];
+            const uint32_t shift = digit * 8;
+            // 모든 키가 이 자릿수에서 같으면 순서가 바뀌지 않음 (층이나 텍스처가 적으면 대부분의 패스를 건너뜀)
+            if (histogram[(m_sortedKeys[0] >> shift) & 0xFF] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t bucket = 0; bucket < 256; bucket++) {
+                const uint32_t bucketCount = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketCount;
+            }
+            for (uint32_t i = 0; i < count; i++) {
+                const uint32_t key = m_sortedKeys[i];
+                const uint32_t position = histogram[(key >> shift) & 0xFF]++;
+                m_tempKeys[position] = key;
+                m_tempOrder[position] = m_order[i];
+            }
+            m_sortedKeys.swap(m_tempKeys);
+            m_order.swap(m_tempOrder);
+            m_stats.sortPasses++;
+        }
+    }
+
+    bool SpriteBatcher::ReserveStream(uint32_t count)
+    {
+        if (count <= m_streamCapacity)
+            return true;
+
+        if (!m_stream.IsNull())
+            m_backend.DestroyBuffer(m_stream);
+        m_streamCapacity = max(count, m_streamCapacity + m_streamCapacity / 2);
+        m_stream = m_backend.CreateBuffer(GpuBufferType::Vertex, nullptr,
+                                          size_t(m_streamCapacity) * sizeof(SpriteInstance), true);
+        m_stats.streamGrows++;
+        if (m_stream.IsNull()) {
+            m_streamCapacity = 0;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <directxtk/SimpleMath.h>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "GlyphAtlas.h"
+#include "JobSystem.h"
+#include "RenderBackend.h"
+
+namespace luke {
+
+    using DirectX::SimpleMath::Vector2;
+    using DirectX::SimpleMath::Vector4;
+
+    // 그릴 사각형 하나. 좌표는 뷰포트 픽셀 (왼쪽 위가 원점, 아래가 +y)
+    struct Sprite {
+        Vector2 position;              // 중심
+        Vector2 size;
+        float rotation = 0.0f;         // 라디안, 시계 방향
+        uint32_t color = 0xFFFFFFFF;   // RGBA8 (DXGI_FORMAT_R8G8B8A8_UNORM)
+        Vector4 uvRect{0.0f, 0.0f, 1.0f, 1.0f}; // (u0, v0, u1, v1)
+        uint16_t texture = 0;          // Draw()의 bindTexture에 넘기는 번호
+        uint16_t layer = 0;            // 작은 층부터 그림
+    };
+
+    // 인스턴스 하나 (40바이트). SpriteVertexShader가 MakeSquare의 사각형(-0.5 ~ 0.5)을 펼침
+    struct SpriteInstance {
+        Vector2 position;
+        Vector2 size;
+        Vector4 uvRect;
+        float rotation;
+        uint32_t color;
+    };
+
+    static_assert(sizeof(SpriteInstance) == 40);
+
+    struct SpriteStats {
+        uint32_t spriteCount = 0;
+        uint32_t batchCount = 0;   // Draw() 한 번의 드로우 수
+        uint32_t sortPasses = 0;   // 기수 정렬에서 실제로 돈 8비트 패스 (키가 모두 같은 자릿수는 건너뜀)
+        uint32_t streamGrows = 0;  // 스트림 버퍼를 다시 만든 횟수 (누적)
+        double sortMs = 0.0;
+        double writeMs = 0.0;      // Map + 정렬 순서로 쓰기 + Unmap
+    };
+
+    // 2D 사각형(마커, 글자)을 모아서 적은 수의 인스턴스 드로우로 그리는 스프라이트 배처
+    //   Begin() -> Add()/AddText() -> End(jobSystem) -> Draw(bindTexture) (Draw는 여러 번 불러도 됨)
+    // - Add()는 CPU 배열에 인스턴스와 정렬 키((층 << 16) | 텍스처)만 쌓습니다.
+    // - End()는 키를 8비트씩 LSD 기수 정렬하고 (안정 정렬이라 같은 키는 넣은 순서), 스트림 버퍼를 한 번 Map해서
+    //   정렬 순서대로 인스턴스를 바로 씁니다. 스트림 버퍼는 계속 들고 있다가 모자랄 때만 1.5배로 다시 만듦
+    // - 정렬 순서에서 텍스처가 이어지는 구간이 배치 하나. 층이 바뀌어도 텍스처가 같으면 같은 드로우로 그림
+    // - 드로우는 MakeSquare 사각형(슬롯 0) + 스트림의 배치 위치부터 읽는 인스턴스(슬롯 1)의 DrawIndexedInstanced
+    // 같은 층 안에서 텍스처가 다른 스프라이트끼리의 순서는 지켜지지 않습니다. 겹치는 순서가 중요하면 층을 나누세요.
+    // 쉐이더는 픽셀 좌표를 PassConstants(b3)의 viewportWidth/Height로 나눠서 클립 공간으로 바꿉니다.
+    class SpriteBatcher {
+    public:
+        explicit SpriteBatcher(RenderBackend &backend);
+        ~SpriteBatcher();
+
+        SpriteBatcher(const SpriteBatcher &) = delete;
+        SpriteBatcher &operator=(const SpriteBatcher &) = delete;
+
+        void Begin();
+        void Add(const Sprite &sprite);
+        // UTF-8 문자열을 글자마다 스프라이트로 추가하고 가장 긴 줄의 폭을 반환 ('\n'이면 다음 줄)
+        // position은 첫 줄 기준선의 왼쪽 끝
+        float AddText(GlyphAtlas &atlas, std::string_view text, const Vector2 &position, uint32_t color,
+                      uint16_t layer = 0, float scale = 1.0f);
+        void End(JobSystem &jobSystem);
+
+        // 텍스처가 바뀔 때마다 bindTexture(번호)를 부름
+        void Draw(const std::function<void(uint16_t texture)> &bindTexture = nullptr);
+
+        uint32_t GetSpriteCount() const { return uint32_t(m_instances.size()); }
+        const SpriteStats &GetStats() const { return m_stats; }
+
+    private:
+        struct Batch {
+            uint16_t texture;
+            uint32_t first; // 스트림 안의 첫 인스턴스
+            uint32_t count;
+        };
+
+        void SortKeys();
+        bool ReserveStream(uint32_t count);
+
+        RenderBackend &m_backend;
+        GpuBufferHandle m_quadVertexBuffer;
+        GpuBufferHandle m_quadIndexBuffer;
+        uint32_t m_quadIndexCount = 0;
+
+        GpuBufferHandle m_stream;
+        uint32_t m_streamCapacity = 0; // 인스턴스 수
+
+        // Add() 순서
+        std::vector<SpriteInstance> m_instances;
+        std::vector<uint32_t> m_keys;
+        // 정렬 결과와 기수 정렬 임시 배열 (프레임마다 재사용)
+        std::vector<uint32_t> m_order;
+        std::vector<uint32_t> m_sortedKeys;
+        std::vector<uint32_t> m_tempOrder;
+        std::vector<uint32_t> m_tempKeys;
+
+        std::vector<Batch> m_batches;
+        SpriteStats m_stats;
+    };
+}
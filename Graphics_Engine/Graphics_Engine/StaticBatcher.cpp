@@ -0,0 +1,394 @@
+#include "StaticBatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        using Clock = chrono::high_resolution_clock;
+
+        double ElapsedMs(Clock::time_point start)
+        {
+            return chrono::duration<double, milli>(Clock::now() - start).count();
+        }
+    }
+
+#pragma region RangeAllocator
+    uint32_t RangeAllocator::Allocate(uint32_t count)
+    {
+        if (count == 0)
+            return kInvalidOffset;
+
+        for (size_t i = 0; i < m_free.size(); i++) {
+            Range &range = m_free[i];
+            if (range.count < count)
+                continue;
+
+            const uint32_t offset = range.offset;
+            range.offset += count;
+            range.count -= count;
+            if (range.count == 0)
+                m_free.erase(m_free.begin() + i);
+            m_used += count;
+            return offset;
+        }
+        return kInvalidOffset;
+    }
+
+    void RangeAllocator::Free(uint32_t offset, uint32_t count)
+    {
+        if (count == 0)
+            return;
+
+        // offset보다 뒤에 있는 첫 빈 구간 앞에 넣고 앞/뒤 구간과 붙어 있으면 합침
+        auto next = lower_bound(m_free.begin(), m_free.end(), offset,
+                                [](const Range &range, uint32_t value) { return range.offset < value; });
+        const bool mergePrevious = next != m_free.begin() && prev(next)->offset + prev(next)->count == offset;
+        const bool mergeNext = next != m_free.end() && offset + count == next->offset;
+
+        if (mergePrevious && mergeNext) {
+            prev(next)->count += count + next->count;
+            m_free.erase(next);
+        }
+        else if (mergePrevious) {
+            prev(next)->count += count;
+        }
+        else if (mergeNext) {
+            next->offset = offset;
+            next->count += count;
+        }
+        else {
+            m_free.insert(next, Range{offset, count});
+        }
+        m_used -= count;
+    }
+
+    void RangeAllocator::Reset(uint32_t capacity)
+    {
+        m_capacity = capacity;
+        m_used = 0;
+        m_free.clear();
+        if (capacity > 0)
+            m_free.push_back(Range{0, capacity});
+    }
+
+    uint32_t RangeAllocator::GetLargestFree() const
+    {
+        uint32_t largest = 0;
+        for (const Range &range : m_free)
+            largest = max(largest, range.count);
+        return largest;
+    }
+#pragma endregion
+
+#pragma region StaticBatcher
+    StaticBatcher::StaticBatcher(RenderBackend &backend, const StaticBatchSettings &settings)
+        : m_backend(backend), m_settings(settings)
+    {
+        m_settings.cellSize = max(m_settings.cellSize, 1e-3f);
+        m_settings.pageVertexCount = max(m_settings.pageVertexCount, 1u);
+        m_settings.pageIndexCount = max(m_settings.pageIndexCount, 3u);
+    }
+
+    StaticBatcher::~StaticBatcher()
+    {
+        for (Page &page : m_pages) {
+            m_backend.DestroyBuffer(page.vertexBuffer);
+            m_backend.DestroyBuffer(page.indexBuffer);
+        }
+    }
+
+    StaticMeshHandle StaticBatcher::Add(const MeshData &mesh, const Matrix &world, uint32_t material)
+    {
+        if (mesh.vertices.empty() || mesh.indices.empty() || mesh.vertices.size() > kMaxBatchVertices ||
+            mesh.indices.size() > m_settings.pageIndexCount) {
+            cout << "StaticBatcher::Add() failed: empty mesh or too many vertices/indices." << endl;
+            return {};
+        }
+
+        // 월드 공간으로 옮겨서 보관 (법선은 비균등 스케일을 위해 다시 정규화)
+        SourceMesh source;
+        source.vertices.resize(mesh.vertices.size());
+        source.indices.assign(mesh.indices.begin(), mesh.indices.end());
+        Vector3 boundsMin(INFINITY, INFINITY, INFINITY);
+        Vector3 boundsMax(-INFINITY, -INFINITY, -INFINITY);
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            Vertex &vertex = source.vertices[i];
+            vertex.position = Vector3::Transform(mesh.vertices[i].position, world);
+            vertex.color = mesh.vertices[i].color;
+            vertex.normal = Vector3::TransformNormal(mesh.vertices[i].normal, world);
+            vertex.normal.Normalize();
+            boundsMin = Vector3::Min(boundsMin, vertex.position);
+            boundsMax = Vector3::Max(boundsMax, vertex.position);
+        }
+
+        source.group = GetGroupKey((boundsMin + boundsMax) * 0.5f, material);
+        Group &group = m_groups[source.group];
+        const StaticMeshHandle handle = m_meshes.Create(std::move(source));
+        group.material = material;
+        group.meshes.push_back(handle);
+        group.dirty = true;
+        m_dirty = true;
+        return handle;
+    }
+
+    void StaticBatcher::Remove(StaticMeshHandle handle)
+    {
+        const SourceMesh *mesh = m_meshes.Get(handle);
+        if (!mesh)
+            return;
+
+        Group &group = m_groups[mesh->group];
+        group.meshes.erase(find(group.meshes.begin(), group.meshes.end(), handle));
+        group.dirty = true;
+        m_dirty = true;
+        m_meshes.Destroy(handle);
+    }
+
+    void StaticBatcher::Build()
+    {
+        const auto start = Clock::now();
+        m_stats.rebuiltBatches = 0;
+        m_stats.bytesUploaded = 0;
+
+        for (auto it = m_groups.begin(); it != m_groups.end();) {
+            Group &group = it->second;
+            if (!group.dirty) {
+                ++it;
+                continue;
+            }
+
+            for (const Batch &batch : group.batches)
+                FreeBatch(batch);
+            group.batches.clear();
+            group.dirty = false;
+            if (group.meshes.empty()) {
+                it = m_groups.erase(it);
+                continue;
+            }
+
+            // 16비트 인덱스와 페이지 크기를 넘지 않게 메쉬를 순서대로 잘라 배치를 만듦
+            Batch batch = {};
+            for (uint32_t i = 0; i < uint32_t(group.meshes.size()); i++) {
+                const SourceMesh &mesh = *m_meshes.Get(group.meshes[i]);
+                const uint32_t vertexCount = uint32_t(mesh.vertices.size());
+                const uint32_t indexCount = uint32_t(mesh.indices.size());
+                if (batch.meshCount > 0 && (batch.vertexCount + vertexCount > kMaxBatchVertices ||
+                                            batch.indexCount + indexCount > m_settings.pageIndexCount)) {
+                    group.batches.push_back(batch);
+                    batch = {};
+                    batch.firstMesh = i;
+                }
+                batch.vertexCount += vertexCount;
+                batch.indexCount += indexCount;
+                batch.meshCount++;
+            }
+            group.batches.push_back(batch);
+
+            for (Batch &placed : group.batches) {
+                PlaceBatch(placed);
+                UploadBatch(group, placed);
+                m_stats.rebuiltBatches++;
+            }
+            ++it;
+        }
+
+        m_dirty = false;
+        UpdateDrawList();
+        UpdateStats();
+        m_stats.buildMs = ElapsedMs(start);
+    }
+
+    void StaticBatcher::Compact()
+    {
+        if (m_dirty)
+            Build();
+
+        const auto start = Clock::now();
+        m_stats.movedBatches = 0;
+        m_stats.bytesUploaded = 0;
+
+        // 지금 위치 순서대로 다시 놓으면 앞쪽 빈틈이 채워지고 뒤쪽 페이지가 비게 됨
+        struct Placement {
+            Group *group;
+            Batch *batch;
+            uint32_t page;
+            uint32_t vertexOffset;
+            uint32_t indexOffset;
+        };
+        vector<Placement> placements;
+        for (auto &[key, group] : m_groups) {
+            for (Batch &batch : group.batches)
+                placements.push_back({&group, &batch, batch.page, batch.vertexOffset, batch.indexOffset});
+        }
+        sort(placements.begin(), placements.end(), [](const Placement &a, const Placement &b) {
+            return a.page != b.page ? a.page < b.page : a.vertexOffset < b.vertexOffset;
+        });
+
+        for (Page &page : m_pages) {
+            page.vertices.Reset(page.vertices.GetCapacity());
+            page.indices.Reset(page.indices.GetCapacity());
+        }
+
+        // CPU에 있는 원본에서 다시 올리므로 아직 옮기지 않은 배치 자리에 덮어써도 됨
+        // (그 배치는 자리가 바뀌므로 뒤에서 다시 올라감)
+        for (Placement &placement : placements) {
+            Batch &batch = *placement.batch;
+            PlaceBatch(batch);
+            if (batch.page != placement.page || batch.vertexOffset != placement.vertexOffset ||
+                batch.indexOffset != placement.indexOffset) {
+                UploadBatch(*placement.group, batch);
+                m_stats.movedBatches++;
+            }
+        }
+
+        // 빈 페이지를 지우고 배치의 페이지 번호를 당김
+        vector<uint32_t> remap(m_pages.size());
+        uint32_t kept = 0;
+        for (uint32_t i = 0; i < uint32_t(m_pages.size()); i++) {
+            if (m_pages[i].vertices.GetUsed() == 0) {
+                m_backend.DestroyBuffer(m_pages[i].vertexBuffer);
+                m_backend.DestroyBuffer(m_pages[i].indexBuffer);
+                continue;
+            }
+            remap[i] = kept;
+            if (kept != i)
+                m_pages[kept] = std::move(m_pages[i]);
+            kept++;
+        }
+        m_pages.resize(kept);
+        for (Placement &placement : placements)
+            placement.batch->page = remap[placement.batch->page];
+
+        UpdateDrawList();
+        UpdateStats();
+        m_stats.compactMs = ElapsedMs(start);
+    }
+
+    void StaticBatcher::Draw(const function<void(uint32_t)> &bindMaterial)
+    {
+        uint32_t material = ~0u;
+        uint32_t page = ~0u;
+        for (const DrawItem &item : m_drawList) {
+            if (item.material != material) {
+                material = item.material;
+                if (bindMaterial)
+                    bindMaterial(material);
+            }
+            if (item.page != page) {
+                page = item.page;
+                m_backend.SetVertexBuffer(m_pages[page].vertexBuffer, sizeof(Vertex));
+                m_backend.SetIndexBuffer(m_pages[page].indexBuffer);
+            }
+            m_backend.DrawIndexed(item.indexCount, item.indexOffset, int32_t(item.vertexOffset));
+        }
+    }
+
+    uint64_t StaticBatcher::GetGroupKey(const Vector3 &center, uint32_t material) const
+    {
+        // 셀 좌표는 16비트씩 (셀 크기 32면 +-1000 km)
+        const int32_t cellX = int32_t(floor(center.x / m_settings.cellSize));
+        const int32_t cellZ = int32_t(floor(center.z / m_settings.cellSize));
+        return (uint64_t(uint16_t(cellX)) << 48) | (uint64_t(uint16_t(cellZ)) << 32) | material;
+    }
+
+    void StaticBatcher::FreeBatch(const Batch &batch)
+    {
+        Page &page = m_pages[batch.page];
+        page.vertices.Free(batch.vertexOffset, batch.vertexCount);
+        page.indices.Free(batch.indexOffset, batch.indexCount);
+    }
+
+    void StaticBatcher::PlaceBatch(Batch &batch)
+    {
+        for (uint32_t i = 0; i < uint32_t(m_pages.size()); i++) {
+            Page &page = m_pages[i];
+            const uint32_t vertexOffset = page.vertices.Allocate(batch.vertexCount);
+            if (vertexOffset == RangeAllocator::kInvalidOffset)
+                continue;
+            const uint32_t indexOffset = page.indices.Allocate(batch.indexCount);
+            if (indexOffset == RangeAllocator::kInvalidOffset) {
+                page.vertices.Free(vertexOffset, batch.vertexCount);
+                continue;
+            }
+
+            batch.page = i;
+            batch.vertexOffset = vertexOffset;
+            batch.indexOffset = indexOffset;
+            return;
+        }
+
+        // 버퍼는 비워서 만들고 배치마다 필요한 구간만 올림
+        Page page;
+        page.vertices.Reset(max(m_settings.pageVertexCount, batch.vertexCount));
+        page.indices.Reset(max(m_settings.pageIndexCount, batch.indexCount));
+        page.vertexBuffer = m_backend.CreateBuffer(GpuBufferType::Vertex, nullptr,
+                                                   size_t(page.vertices.GetCapacity()) * sizeof(Vertex), false);
+        page.indexBuffer = m_backend.CreateBuffer(GpuBufferType::Index, nullptr,
+                                                  size_t(page.indices.GetCapacity()) * sizeof(uint16_t), false);
+        batch.page = uint32_t(m_pages.size());
+        batch.vertexOffset = page.vertices.Allocate(batch.vertexCount);
+        batch.indexOffset = page.indices.Allocate(batch.indexCount);
+        m_pages.push_back(std::move(page));
+    }
+
+    void StaticBatcher::UploadBatch(const Group &group, const Batch &batch)
+    {
+        // 메쉬를 이어 붙이고 인덱스를 배치 시작 기준으로 옮김 (baseVertex = 배치의 vertexOffset)
+        m_scratchVertices.clear();
+        m_scratchIndices.clear();
+        for (uint32_t i = batch.firstMesh; i < batch.firstMesh + batch.meshCount; i++) {
+            const SourceMesh &mesh = *m_meshes.Get(group.meshes[i]);
+            const uint16_t base = uint16_t(m_scratchVertices.size());
+            m_scratchVertices.insert(m_scratchVertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+            for (uint16_t index : mesh.indices)
+                m_scratchIndices.push_back(uint16_t(index + base));
+        }
+
+        const Page &page = m_pages[batch.page];
+        const size_t vertexBytes = m_scratchVertices.size() * sizeof(Vertex);
+        const size_t indexBytes = m_scratchIndices.size() * sizeof(uint16_t);
+        m_backend.UpdateBufferRange(page.vertexBuffer, size_t(batch.vertexOffset) * sizeof(Vertex),
+                                    m_scratchVertices.data(), vertexBytes);
+        m_backend.UpdateBufferRange(page.indexBuffer, size_t(batch.indexOffset) * sizeof(uint16_t),
+                                    m_scratchIndices.data(), indexBytes);
+        m_stats.bytesUploaded += vertexBytes + indexBytes;
+    }
+
+    void StaticBatcher::UpdateDrawList()
+    {
+        m_drawList.clear();
+        for (const auto &[key, group] : m_groups) {
+            for (const Batch &batch : group.batches)
+                m_drawList.push_back(
+                    {group.material, batch.page, batch.indexOffset, batch.indexCount, batch.vertexOffset});
+        }
+        sort(m_drawList.begin(), m_drawList.end(), [](const DrawItem &a, const DrawItem &b) {
+            if (a.material != b.material)
+                return a.material < b.material;
+            return a.page != b.page ? a.page < b.page : a.indexOffset < b.indexOffset;
+        });
+    }
+
+    void StaticBatcher::UpdateStats()
+    {
+        m_stats.meshCount = uint32_t(m_meshes.GetCount());
+        m_stats.batchCount = uint32_t(m_drawList.size());
+        m_stats.pageCount = uint32_t(m_pages.size());
+        m_stats.usedVertices = m_stats.usedIndices = 0;
+        m_stats.vertexCapacity = m_stats.indexCapacity = 0;
+        m_stats.freeRanges = 0;
+        for (const Page &page : m_pages) {
+            m_stats.usedVertices += page.vertices.GetUsed();
+            m_stats.usedIndices += page.indices.GetUsed();
+            m_stats.vertexCapacity += page.vertices.GetCapacity();
+            m_stats.indexCapacity += page.indices.GetCapacity();
+            m_stats.freeRanges += uint32_t(page.vertices.GetFreeRangeCount());
+        }
+    }
+#pragma endregion
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <directxtk/SimpleMath.h>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "HandlePool.h"
+#include "MeshGenerator.h"
+#include "RenderBackend.h"
+
+namespace luke {
+
+    using DirectX::SimpleMath::Matrix;
+    using DirectX::SimpleMath::Vector3;
+
+    // [0, capacity) 안의 연속 구간을 나눠 주는 할당자 (단위는 버텍스/인덱스 개수)
+    // 빈 구간을 시작 위치 순서로 들고 있다가 처음 들어가는 곳(first fit)을 자르고, 해제하면 이웃과 합칩니다.
+    class RangeAllocator {
+    public:
+        static constexpr uint32_t kInvalidOffset = ~0u;
+
+        explicit RangeAllocator(uint32_t capacity = 0) { Reset(capacity); }
+
+        // 실패하면 kInvalidOffset
+        uint32_t Allocate(uint32_t count);
+        void Free(uint32_t offset, uint32_t count);
+        void Reset(uint32_t capacity);
+
+        uint32_t GetCapacity() const { return m_capacity; }
+        uint32_t GetUsed() const { return m_used; }
+        uint32_t GetLargestFree() const;
+        size_t GetFreeRangeCount() const { return m_free.size(); }
+
+    private:
+        struct Range {
+            uint32_t offset;
+            uint32_t count;
+        };
+
+        std::vector<Range> m_free; // offset 순서, 서로 붙어 있는 구간은 없음
+        uint32_t m_capacity = 0;
+        uint32_t m_used = 0;
+    };
+
+    struct StaticBatchSettings {
+        float cellSize = 32.0f;              // XZ 평면 격자의 한 변. 같은 셀 + 같은 재질이면 한 드로우로 합침
+        uint32_t pageVertexCount = 1u << 18; // 페이지(공유 버텍스 버퍼 하나)의 버텍스 수 (36바이트 x 256K = 9 MB)
+        uint32_t pageIndexCount = 1u << 20;  // 페이지의 인덱스 수 (2 MB)
+    };
+
+    struct StaticBatchStats {
+        uint32_t meshCount = 0;
+        uint32_t batchCount = 0;       // 프레임당 드로우 수
+        uint32_t pageCount = 0;        // 버퍼 수 = pageCount * 2
+        uint64_t usedVertices = 0;
+        uint64_t usedIndices = 0;
+        uint64_t vertexCapacity = 0;
+        uint64_t indexCapacity = 0;
+        uint32_t freeRanges = 0;       // 모든 페이지의 빈 구간 수 (조각난 정도)
+
+        // 마지막 Build()/Compact()
+        double buildMs = 0.0;
+        double compactMs = 0.0;
+        uint32_t rebuiltBatches = 0;   // Build()에서 다시 합친 배치
+        uint32_t movedBatches = 0;     // Compact()에서 옮긴 배치
+        uint64_t bytesUploaded = 0;
+    };
+
+    struct StaticMeshTag;
+    using StaticMeshHandle = Handle<StaticMeshTag>;
+
+    // 움직이지 않는 메쉬를 몇 개의 큰 공유 버텍스/인덱스 버퍼(페이지)에 모아 담는 정적 배칭
+    // - Add()한 메쉬는 월드 변환을 미리 적용해서 CPU에 보관하고, 월드 XZ 격자 셀과 재질로 그룹을 나눕니다.
+    // - Build()는 바뀐 그룹만 다시 합칩니다. 그룹의 메쉬를 이어 붙여 한 구간에 올리므로 그룹 하나가 드로우 하나
+    //   (16비트 인덱스라 버텍스 65536개를 넘으면 여러 배치로 나눔)
+    // - 페이지 안의 위치는 RangeAllocator로 나누고, 드로우는 DrawIndexed(count, startIndex, baseVertex)
+    // - Remove()로 생긴 빈 구간은 Compact()가 배치를 앞쪽으로 당겨 없애고, 비게 된 페이지는 지웁니다.
+    // 상수 버퍼는 쓰지 않습니다. 버텍스가 이미 월드 공간이므로 호출하는 쪽이 model = 단위 행렬로 한 번만 올리면 됩니다.
+    class StaticBatcher {
+    public:
+        static constexpr uint32_t kMaxBatchVertices = 1u << 16;
+
+        explicit StaticBatcher(RenderBackend &backend, const StaticBatchSettings &settings = {});
+        ~StaticBatcher();
+
+        StaticBatcher(const StaticBatcher &) = delete;
+        StaticBatcher &operator=(const StaticBatcher &) = delete;
+
+        // 다음 Build()부터 그려짐. 한 메쉬는 kMaxBatchVertices개 이하여야 함
+        StaticMeshHandle Add(const MeshData &mesh, const Matrix &world, uint32_t material);
+        // 다음 Build()까지는 이전 내용으로 그려짐
+        void Remove(StaticMeshHandle mesh);
+
+        // 바뀐 (셀, 재질) 그룹만 다시 합쳐서 올림
+        void Build();
+        // 배치를 앞쪽 페이지/앞쪽 위치로 다시 채우고 빈 페이지를 지움 (바뀐 그룹이 있으면 먼저 Build())
+        void Compact();
+
+        // (재질, 페이지) 순서로 그림. 버텍스/인덱스 버퍼는 페이지가 바뀔 때만 바인딩하고,
+        // 재질이 바뀌면 bindMaterial(material)을 부름
+        void Draw(const std::function<void(uint32_t)> &bindMaterial = nullptr);
+
+        const StaticBatchStats &GetStats() const { return m_stats; }
+
+    private:
+        struct SourceMesh {
+            std::vector<Vertex> vertices; // 월드 공간
+            std::vector<uint16_t> indices;
+            uint64_t group;
+        };
+
+        // 한 페이지 안의 연속 구간. 그룹의 meshes[firstMesh, firstMesh + meshCount)를 이어 붙인 것
+        struct Batch {
+            uint32_t page;
+            uint32_t vertexOffset;
+            uint32_t vertexCount;
+            uint32_t indexOffset;
+            uint32_t indexCount;
+            uint32_t firstMesh;
+            uint32_t meshCount;
+        };
+
+        struct Group {
+            uint32_t material = 0;
+            std::vector<StaticMeshHandle> meshes;
+            std::vector<Batch> batches;
+            bool dirty = false;
+        };
+
+        struct Page {
+            GpuBufferHandle vertexBuffer;
+            GpuBufferHandle indexBuffer;
+            RangeAllocator vertices;
+            RangeAllocator indices;
+        };
+
+        struct DrawItem {
+            uint32_t material;
+            uint32_t page;
+            uint32_t indexOffset;
+            uint32_t indexCount;
+            uint32_t vertexOffset;
+        };
+
+        uint64_t GetGroupKey(const Vector3 &center, uint32_t material) const;
+        void FreeBatch(const Batch &batch);
+        // 빈 자리가 있는 페이지에 배치를 놓음 (없으면 페이지를 새로 만듦)
+        void PlaceBatch(Batch &batch);
+        void UploadBatch(const Group &group, const Batch &batch);
+        void UpdateDrawList();
+        void UpdateStats();
+
+        RenderBackend &m_backend;
+        StaticBatchSettings m_settings;
+
+        HandlePool<SourceMesh, StaticMeshTag> m_meshes;
+        std::unordered_map<uint64_t, Group> m_groups;
+        std::vector<Page> m_pages;
+        std::vector<DrawItem> m_drawList;
+        bool m_dirty = false;
+
+        // 업로드 임시 버퍼 (배치 하나 분량, 재사용)
+        std::vector<Vertex> m_scratchVertices;
+        std::vector<uint16_t> m_scratchIndices;
+
+        StaticBatchStats m_stats;
+    };
+}
@@ -0,0 +1,419 @@
+#include "TexturePipeline.h"
+
+#include <directxtk/SimpleMath.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace luke {
+    using namespace std;
+    using namespace DirectX;
+
+    namespace {
+        using FloatImage = vector<XMFLOAT4>;
+
+        // sRGB <-> 선형 변환표. 선형 -> sRGB는 12비트로 나눠서 찾음 (8비트 결과에는 충분)
+        struct ColorTables {
+            float toLinear[256];
+            uint8_t toSrgb[4096];
+
+            ColorTables()
+            {
+                for (int i = 0; i < 256; i++) {
+                    const float c = i / 255.0f;
+                    toLinear[i] = c <= 0.04045f ? c / 12.92f : pow((c + 0.055f) / 1.055f, 2.4f);
+                }
+                for (int i = 0; i < 4096; i++) {
+                    const float c = i / 4095.0f;
+                    const float s = c <= 0.0031308f ? c * 12.92f : 1.055f * pow(c, 1.0f / 2.4f) - 0.055f;
+                    toSrgb[i] = uint8_t(clamp(int(s * 255.0f + 0.5f), 0, 255));
+                }
+            }
+        };
+
+        const ColorTables &GetColorTables()
+        {
+            static const ColorTables tables;
+            return tables;
+        }
+
+        double BesselI0(double x)
+        {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 32; k++) {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        }
+
+        // 절반으로 줄일 때의 8탭 가중치. 원본 픽셀 중심은 출력 픽셀 중심에서 ±0.5, ±1.5, ±2.5, ±3.5
+        // 출력 픽셀 단위 거리 x = d / 2에 대해 sinc(x) * Kaiser(x / 2, alpha = 4)
+        struct KaiserKernel {
+            static constexpr int kTaps = 8;
+            float weights[kTaps];
+
+            KaiserKernel()
+            {
+                constexpr double kAlpha = 4.0, kWidth = 2.0, kPi = 3.14159265358979;
+                double sum = 0.0;
+                for (int i = 0; i < kTaps; i++) {
+                    const double x = (i - 3.5) / 2.0;
+                    const double sinc = sin(kPi * x) / (kPi * x);
+                    const double r = x / kWidth;
+                    const double window = BesselI0(kAlpha * sqrt((std::max)(0.0, 1.0 - r * r))) / BesselI0(kAlpha);
+                    weights[i] = float(sinc * window);
+                    sum += weights[i];
+                }
+                for (float &weight : weights)
+                    weight = float(weight / sum);
+            }
+        };
+
+        const KaiserKernel &GetKaiserKernel()
+        {
+            static const KaiserKernel kernel;
+            return kernel;
+        }
+
+        // 행 단위로 나눌 때 구간 하나가 대략 16K 픽셀이 되도록
+        size_t GetRowGrain(uint32_t width) { return (std::max)(size_t(1), size_t(16384) / width); }
+
+        void ToFloat(uint32_t width, uint32_t height, const uint8_t *rgba, bool srgb, FloatImage &out,
+                     JobSystem &jobSystem)
+        {
+            const ColorTables &tables = GetColorTables();
+            out.resize(size_t(width) * height);
+            jobSystem.ParallelFor(height, GetRowGrain(width), [&](size_t begin, size_t end) {
+                for (size_t i = begin * width; i < end * width; i++) {
+                    const uint8_t *p = rgba + i * 4;
+                    if (srgb)
+                        out[i] = XMFLOAT4(tables.toLinear[p[0]], tables.toLinear[p[1]], tables.toLinear[p[2]],
+                                          p[3] / 255.0f);
+                    else
+                        out[i] = XMFLOAT4(p[0] / 255.0f, p[1] / 255.0f, p[2] / 255.0f, p[3] / 255.0f);
+                }
+            });
+        }
+
+        void ToRgba8(uint32_t width, uint32_t height, const FloatImage &image, bool srgb, vector<uint8_t> &out,
+                     JobSystem &jobSystem)
+        {
+            const ColorTables &tables = GetColorTables();
+            out.resize(size_t(width) * height * 4);
+            jobSystem.ParallelFor(height, GetRowGrain(width), [&](size_t begin, size_t end) {
+                const XMVECTOR colorScale = srgb ? XMVectorSet(4095.0f, 4095.0f, 4095.0f, 255.0f)
+                                                 : XMVectorReplicate(255.0f);
+                const XMVECTOR half = XMVectorReplicate(0.5f);
+                for (size_t i = begin * width; i < end * width; i++) {
+                    // Kaiser는 음수 엽 때문에 [0, 1]을 벗어날 수 있음
+                    XMFLOAT4 scaled;
+                    XMStoreFloat4(&scaled, XMVectorMultiplyAdd(XMVectorSaturate(XMLoadFloat4(&image[i])),
+                                                               colorScale, half));
+                    uint8_t *p = out.data() + i * 4;
+                    if (srgb) {
+                        p[0] = tables.toSrgb[int(scaled.x)];
+                        p[1] = tables.toSrgb[int(scaled.y)];
+                        p[2] = tables.toSrgb[int(scaled.z)];
+                    }
+                    else {
+                        p[0] = uint8_t(scaled.x);
+                        p[1] = uint8_t(scaled.y);
+                        p[2] = uint8_t(scaled.z);
+                    }
+                    p[3] = uint8_t(scaled.w);
+                }
+            });
+        }
+
+        void DownsampleBox(uint32_t width, uint32_t height, const FloatImage &source, uint32_t mipWidth,
+                           uint32_t mipHeight, FloatImage &out, JobSystem &jobSystem)
+        {
+            out.resize(size_t(mipWidth) * mipHeight);
+            jobSystem.ParallelFor(mipHeight, GetRowGrain(mipWidth), [&](size_t begin, size_t end) {
+                const XMVECTOR quarter = XMVectorReplicate(0.25f);
+                for (size_t y = begin; y < end; y++) {
+                    // 홀수 크기면 마지막 행/열을 반복
+                    const XMFLOAT4 *row0 = &source[(2 * y) * width];
+                    const XMFLOAT4 *row1 = &source[(std::min)(2 * y + 1, size_t(height) - 1) * width];
+                    for (uint32_t x = 0; x < mipWidth; x++) {
+                        const uint32_t x0 = 2 * x;
+                        const uint32_t x1 = (std::min)(2 * x + 1, width - 1);
+                        XMVECTOR sum = XMVectorAdd(XMLoadFloat4(&row0[x0]), XMLoadFloat4(&row0[x1]));
+                        sum = XMVectorAdd(sum, XMVectorAdd(XMLoadFloat4(&row1[x0]), XMLoadFloat4(&row1[x1])));
+                        XMStoreFloat4(&out[y * mipWidth + x], XMVectorMultiply(sum, quarter));
+                    }
+                }
+            });
+        }
+
+        // 가로로 줄이고(temp) 세로로 줄임. 가장자리 밖의 탭은 가장자리 픽셀을 반복
+        void DownsampleKaiser(uint32_t width, uint32_t height, const FloatImage &source, uint32_t mipWidth,
+                              uint32_t mipHeight, FloatImage &temp, FloatImage &out, JobSystem &jobSystem)
+        {
+            const KaiserKernel &kernel = GetKaiserKernel();
+            temp.resize(size_t(mipWidth) * height);
+            out.resize(size_t(mipWidth) * mipHeight);
+
+            jobSystem.ParallelFor(height, GetRowGrain(mipWidth), [&](size_t begin, size_t end) {
+                for (size_t y = begin; y < end; y++) {
+                    const XMFLOAT4 *row = &source[y * width];
+                    for (uint32_t x = 0; x < mipWidth; x++) {
+                        XMVECTOR sum = XMVectorZero();
+                        for (int tap = 0; tap < KaiserKernel::kTaps; tap++) {
+                            const int sourceX = clamp(int(2 * x) - 3 + tap, 0, int(width) - 1);
+                            sum = XMVectorMultiplyAdd(XMLoadFloat4(&row[sourceX]),
+                                                      XMVectorReplicate(kernel.weights[tap]), sum);
+                        }
+                        XMStoreFloat4(&temp[y * mipWidth + x], sum);
+                    }
+                }
+            });
+
+            jobSystem.ParallelFor(mipHeight, GetRowGrain(mipWidth), [&](size_t begin, size_t end) {
+                for (size_t y = begin; y < end; y++) {
+                    const XMFLOAT4 *rows[KaiserKernel::kTaps];
+                    for (int tap = 0; tap < KaiserKernel::kTaps; tap++)
+                        rows[tap] = &temp[size_t(clamp(int(2 * y) - 3 + tap, 0, int(height) - 1)) * mipWidth];
+                    for (uint32_t x = 0; x < mipWidth; x++) {
+                        XMVECTOR sum = XMVectorZero();
+                        for (int tap = 0; tap < KaiserKernel::kTaps; tap++)
+                            sum = XMVectorMultiplyAdd(XMLoadFloat4(&rows[tap][x]),
+                                                      XMVectorReplicate(kernel.weights[tap]), sum);
+                        XMStoreFloat4(&out[y * mipWidth + x], sum);
+                    }
+                }
+            });
+        }
+
+        uint64_t AlignUp(uint64_t value, uint64_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+    }
+
+    const char *GetMipFilterName(MipFilter filter) { return filter == MipFilter::Box ? "box" : "kaiser"; }
+
+    void GenerateMipChain(uint32_t width, uint32_t height, const uint8_t *rgba, MipFilter filter, bool srgb,
+                          uint32_t maxMips, vector<vector<uint8_t>> &levels, JobSystem &jobSystem)
+    {
+        uint32_t mipCount = 1;
+        for (uint32_t size = (std::max)(width, height); size > 1; size /= 2)
+            mipCount++;
+        if (maxMips > 0)
+            mipCount = (std::min)(mipCount, maxMips);
+
+        levels.resize(mipCount);
+        levels[0].assign(rgba, rgba + size_t(width) * height * 4);
+        if (mipCount == 1)
+            return;
+
+        FloatImage current, next, temp;
+        ToFloat(width, height, rgba, srgb, current, jobSystem);
+        for (uint32_t mip = 1; mip < mipCount; mip++) {
+            const uint32_t mipWidth = (std::max)(width / 2, 1u);
+            const uint32_t mipHeight = (std::max)(height / 2, 1u);
+            if (filter == MipFilter::Box)
+                DownsampleBox(width, height, current, mipWidth, mipHeight, next, jobSystem);
+            else
+                DownsampleKaiser(width, height, current, mipWidth, mipHeight, temp, next, jobSystem);
+            ToRgba8(mipWidth, mipHeight, next, srgb, levels[mip], jobSystem);
+
+            swap(current, next);
+            width = mipWidth;
+            height = mipHeight;
+        }
+    }
+
+    void ImportTexture(uint32_t width, uint32_t height, const uint8_t *rgba, const TextureImportSettings &settings,
+                       TextureAsset &out, JobSystem &jobSystem, TextureImportStats *stats)
+    {
+        using Clock = chrono::high_resolution_clock;
+
+        const auto mipStart = Clock::now();
+        vector<vector<uint8_t>> levels;
+        GenerateMipChain(width, height, rgba, settings.filter, settings.srgb, settings.maxMips, levels, jobSystem);
+        const auto encodeStart = Clock::now();
+
+        out.format = settings.format;
+        out.srgb = settings.srgb;
+        out.width = width;
+        out.height = height;
+        out.mips.resize(levels.size());
+        uint64_t pixels = 0, bytes = 0;
+        for (size_t mip = 0; mip < levels.size(); mip++) {
+            TextureMip &level = out.mips[mip];
+            level.width = (std::max)(width >> mip, 1u);
+            level.height = (std::max)(height >> mip, 1u);
+            level.rowPitch = GetTextureRowPitch(settings.format, level.width);
+            level.rowCount = GetTextureRowCount(settings.format, level.height);
+            CompressTexture(settings.format, level.width, level.height, levels[mip].data(), level.data, jobSystem);
+            pixels += uint64_t(level.width) * level.height;
+            bytes += level.data.size();
+        }
+
+        if (stats) {
+            stats->mipMs = chrono::duration<double, milli>(encodeStart - mipStart).count();
+            stats->encodeMs = chrono::duration<double, milli>(Clock::now() - encodeStart).count();
+            stats->encodedPixels = pixels;
+            stats->encodedBytes = bytes;
+        }
+    }
+
+    double ComputePsnr(uint32_t width, uint32_t height, const uint8_t *a, const uint8_t *b, bool alpha)
+    {
+        const size_t channels = alpha ? 4 : 3;
+        const size_t count = size_t(width) * height * channels;
+        uint64_t squaredError = 0;
+        for (size_t i = 0; i < size_t(width) * height * 4; i++) {
+            if (!alpha && i % 4 == 3)
+                continue;
+            const int d = int(a[i]) - int(b[i]);
+            squaredError += uint64_t(d * d);
+        }
+        if (squaredError == 0 || count == 0)
+            return 100.0;
+        const double mse = double(squaredError) / double(count);
+        return (std::min)(100.0, 10.0 * log10(255.0 * 255.0 / mse));
+    }
+
+#pragma region 컨테이너
+    bool WriteTextureFile(const filesystem::path &path, const TextureAsset &asset)
+    {
+        TextureFileHeader header;
+        header.format = uint32_t(asset.format);
+        header.flags = asset.srgb ? kTextureFlagSrgb : 0;
+        header.width = asset.width;
+        header.height = asset.height;
+        header.mipCount = uint32_t(asset.mips.size());
+
+        vector<TextureFileMip> table(asset.mips.size());
+        uint64_t offset = sizeof(TextureFileHeader) + sizeof(TextureFileMip) * table.size();
+        for (size_t mip = 0; mip < table.size(); mip++) {
+            const TextureMip &level = asset.mips[mip];
+            offset = AlignUp(offset, kTextureDataAlignment);
+            table[mip].offset = offset;
+            table[mip].size = level.data.size();
+            table[mip].width = level.width;
+            table[mip].height = level.height;
+            table[mip].rowPitch = level.rowPitch;
+            table[mip].rowCount = level.rowCount;
+            offset += level.data.size();
+        }
+
+        ofstream file(path, ios::binary | ios::trunc);
+        if (!file) {
+            cout << "Cannot write " << path.string() << endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(table.data()), streamsize(sizeof(TextureFileMip) * table.size()));
+        uint64_t written = sizeof(TextureFileHeader) + sizeof(TextureFileMip) * table.size();
+        const char padding[kTextureDataAlignment] = {};
+        for (size_t mip = 0; mip < table.size(); mip++) {
+            file.write(padding, streamsize(table[mip].offset - written));
+            file.write(reinterpret_cast<const char *>(asset.mips[mip].data.data()), streamsize(table[mip].size));
+            written = table[mip].offset + table[mip].size;
+        }
+        if (!file) {
+            cout << "Failed to write " << path.string() << endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool MappedTextureFile::Open(const filesystem::path &path)
+    {
+        Close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            cout << "Cannot open " << path.string() << endl;
+            return false;
+        }
+        LARGE_INTEGER size = {};
+        GetFileSizeEx(file, &size);
+        HANDLE mapping = size.QuadPart > 0 ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        const void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            cout << "Cannot map " << path.string() << endl;
+            if (mapping)
+                CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        m_file = file;
+        m_mapping = mapping;
+        m_data = static_cast<const uint8_t *>(view);
+        m_size = uint64_t(size.QuadPart);
+#else
+        const int file = open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            cout << "Cannot open " << path.string() << endl;
+            return false;
+        }
+        struct stat info = {};
+        fstat(file, &info);
+        void *view = info.st_size > 0 ? mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0)
+                                      : MAP_FAILED;
+        close(file); // 매핑은 파일 디스크립터를 닫아도 유지됨
+        if (view == MAP_FAILED) {
+            cout << "Cannot map " << path.string() << endl;
+            return false;
+        }
+        m_data = static_cast<const uint8_t *>(view);
+        m_size = uint64_t(info.st_size);
+#endif
+
+        // 헤더와 밉 테이블 검사
+        bool valid = m_size >= sizeof(TextureFileHeader);
+        if (valid) {
+            const TextureFileHeader &header = GetHeader();
+            valid = header.magic == kTextureFileMagic && header.version == kTextureFileVersion &&
+                    header.format <= uint32_t(TextureFormat::BC7) && header.mipCount > 0 &&
+                    m_size >= sizeof(TextureFileHeader) + uint64_t(header.mipCount) * sizeof(TextureFileMip);
+        }
+        for (uint32_t mip = 0; valid && mip < GetMipCount(); mip++) {
+            const TextureFileMip &level = GetMip(mip);
+            valid = level.offset % kTextureDataAlignment == 0 && level.offset <= m_size &&
+                    level.size <= m_size - level.offset &&
+                    level.size == uint64_t(level.rowPitch) * level.rowCount &&
+                    level.rowPitch == GetTextureRowPitch(GetFormat(), level.width) &&
+                    level.rowCount == GetTextureRowCount(GetFormat(), level.height);
+        }
+        if (!valid) {
+            cout << "Invalid texture file: " << path.string() << endl;
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedTextureFile::Close()
+    {
+        if (!m_data)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mapping);
+        CloseHandle(m_file);
+        m_file = nullptr;
+        m_mapping = nullptr;
+#else
+        munmap(const_cast<uint8_t *>(m_data), size_t(m_size));
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+#pragma endregion
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "BlockCompression.h"
+#include "JobSystem.h"
+
+namespace luke {
+
+    // 밉 축소 필터
+    enum class MipFilter : uint32_t {
+        Box,    // 2x2 평균. 빠르지만 작은 밉이 흐려지고 무늬가 번짐
+        Kaiser, // 분리형 8탭 Kaiser 창 sinc. 선명하고 앨리어싱이 적음
+    };
+
+    const char *GetMipFilterName(MipFilter filter); // "box", "kaiser"
+
+    struct TextureImportSettings {
+        TextureFormat format = TextureFormat::BC7;
+        MipFilter filter = MipFilter::Kaiser;
+        bool srgb = true;     // 색상은 sRGB로 저장됨. 필터링은 선형 공간에서 (알파는 항상 선형)
+        uint32_t maxMips = 0; // 0이면 1x1까지
+    };
+
+    struct TextureImportStats {
+        double mipMs = 0.0;    // 밉 체인 생성 (첫 밉 변환 포함)
+        double encodeMs = 0.0; // 모든 밉의 블록 압축
+        uint64_t encodedPixels = 0;
+        uint64_t encodedBytes = 0;
+    };
+
+    struct TextureMip {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t rowPitch = 0; // 블록 압축이면 블록 한 줄의 바이트 수
+        uint32_t rowCount = 0; // 블록 압축이면 블록 줄 수
+        std::vector<uint8_t> data;
+    };
+
+    struct TextureAsset {
+        TextureFormat format = TextureFormat::RGBA8;
+        bool srgb = false;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<TextureMip> mips;
+    };
+
+    // 행 우선 RGBA8 이미지로 밉 체인을 만듭니다. levels[0]은 원본 그대로
+    // 각 밉은 이전 밉의 float(선형) 결과에서 만들므로 8비트 양자화 오차가 쌓이지 않습니다.
+    // 한 밉 안에서는 행을 나눠서 jobSystem으로 병렬 처리하고, 픽셀 하나의 RGBA를 XMVECTOR 하나로 계산합니다.
+    void GenerateMipChain(uint32_t width, uint32_t height, const uint8_t *rgba, MipFilter filter, bool srgb,
+                          uint32_t maxMips, std::vector<std::vector<uint8_t>> &levels, JobSystem &jobSystem);
+
+    // 밉 체인을 만들고 밉마다 settings.format으로 압축
+    void ImportTexture(uint32_t width, uint32_t height, const uint8_t *rgba, const TextureImportSettings &settings,
+                       TextureAsset &out, JobSystem &jobSystem, TextureImportStats *stats = nullptr);
+
+    // RGBA 네 채널(alpha == false면 RGB만)의 PSNR (dB). 두 이미지가 같으면 100
+    double ComputePsnr(uint32_t width, uint32_t height, const uint8_t *a, const uint8_t *b, bool alpha = true);
+
+#pragma region 컨테이너 (.ltex)
+    // [헤더][밉 테이블][밉 0][밉 1]...
+    // 밉 데이터는 행 간격까지 GPU 업로드 형식 그대로이고 kTextureDataAlignment로 정렬되어 있으므로
+    // 파일을 메모리 매핑한 포인터를 그대로 D3D11_SUBRESOURCE_DATA에 넘기면 됩니다.
+    constexpr uint32_t kTextureFileMagic = 0x5845544C; // "LTEX"
+    constexpr uint32_t kTextureFileVersion = 1;
+    constexpr uint32_t kTextureDataAlignment = 16;
+    constexpr uint32_t kTextureFlagSrgb = 1;
+
+    struct TextureFileHeader {
+        uint32_t magic = kTextureFileMagic;
+        uint32_t version = kTextureFileVersion;
+        uint32_t format = 0; // TextureFormat
+        uint32_t flags = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipCount = 0;
+        uint32_t reserved = 0;
+    };
+
+    struct TextureFileMip {
+        uint64_t offset = 0; // 파일 처음부터
+        uint64_t size = 0;   // rowPitch * rowCount
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t rowPitch = 0;
+        uint32_t rowCount = 0;
+    };
+
+    static_assert(sizeof(TextureFileHeader) == 32 && sizeof(TextureFileMip) == 32);
+
+    bool WriteTextureFile(const std::filesystem::path &path, const TextureAsset &asset);
+
+    // 읽기 전용으로 매핑한 .ltex 파일. 매핑을 닫기 전까지 GetMipData()의 포인터가 유효합니다.
+    class MappedTextureFile {
+    public:
+        MappedTextureFile() = default;
+        ~MappedTextureFile() { Close(); }
+
+        MappedTextureFile(const MappedTextureFile &) = delete;
+        MappedTextureFile &operator=(const MappedTextureFile &) = delete;
+
+        // 헤더와 밉 테이블이 파일 크기 안에 들어오는지까지 확인
+        bool Open(const std::filesystem::path &path);
+        void Close();
+
+        bool IsOpen() const { return m_data != nullptr; }
+        const TextureFileHeader &GetHeader() const { return *reinterpret_cast<const TextureFileHeader *>(m_data); }
+        TextureFormat GetFormat() const { return TextureFormat(GetHeader().format); }
+        bool IsSrgb() const { return (GetHeader().flags & kTextureFlagSrgb) != 0; }
+        uint32_t GetMipCount() const { return GetHeader().mipCount; }
+        const TextureFileMip &GetMip(uint32_t mip) const
+        {
+            return reinterpret_cast<const TextureFileMip *>(m_data + sizeof(TextureFileHeader))[mip];
+        }
+        const uint8_t *GetMipData(uint32_t mip) const { return m_data + GetMip(mip).offset; }
+        uint64_t GetFileSize() const { return m_size; }
+
+    private:
+        const uint8_t *m_data = nullptr;
+        uint64_t m_size = 0;
+#ifdef _WIN32
+        void *m_file = nullptr;    // HANDLE
+        void *m_mapping = nullptr; // HANDLE
+#endif
+    };
+#pragma endregion
+}
@@ -0,0 +1,392 @@
+#include "TriangleBvh.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+
+namespace luke {
+
+    using namespace std;
+    using namespace DirectX;
+
+    namespace {
+        constexpr uint32_t kBinCount = 16;
+        constexpr uint32_t kLeafSize = 4;
+        constexpr uint32_t kStackSize = 256;
+
+        XMVECTOR Load4(const float *values) { return XMLoadFloat4(reinterpret_cast<const XMFLOAT4 *>(values)); }
+
+        void Store4(float *values, XMVECTOR v) { XMStoreFloat4(reinterpret_cast<XMFLOAT4 *>(values), v); }
+
+        float SurfaceArea(const Vector3 &boundsMin, const Vector3 &boundsMax)
+        {
+            const Vector3 d = boundsMax - boundsMin;
+            return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+
+        float GetAxis(const Vector3 &v, uint32_t axis) { return axis == 0 ? v.x : (axis == 1 ? v.y : v.z); }
+
+        // 0에 가까운 성분은 아주 큰 값으로 (0 * inf = NaN 방지)
+        float SafeReciprocal(float value)
+        {
+            return fabsf(value) > 1e-20f ? 1.0f / value : copysignf(1e20f, value);
+        }
+    }
+
+    void TriangleBvh::Build(span<const Vector3> positions)
+    {
+        using Clock = chrono::high_resolution_clock;
+        const auto start = Clock::now();
+
+        m_nodes.clear();
+        m_packets.clear();
+        m_stats = BvhStats();
+        const uint32_t triangleCount = uint32_t(positions.size() / 3);
+        m_stats.triangleCount = triangleCount;
+        if (triangleCount == 0)
+            return;
+
+        m_positions = positions;
+        m_centroids.resize(triangleCount);
+        m_triangleMin.resize(triangleCount);
+        m_triangleMax.resize(triangleCount);
+        for (uint32_t i = 0; i < triangleCount; i++) {
+            const Vector3 &p0 = positions[i * 3], &p1 = positions[i * 3 + 1], &p2 = positions[i * 3 + 2];
+            m_triangleMin[i] = Vector3::Min(p0, Vector3::Min(p1, p2));
+            m_triangleMax[i] = Vector3::Max(p0, Vector3::Max(p1, p2));
+            m_centroids[i] = (m_triangleMin[i] + m_triangleMax[i]) * 0.5f;
+        }
+        m_buildOrder.resize(triangleCount);
+        iota(m_buildOrder.begin(), m_buildOrder.end(), 0u);
+        m_buildNodes.clear();
+        m_buildNodes.reserve(size_t(triangleCount) * 2 / kLeafSize + 1);
+
+        const uint32_t root = BuildBinary(0, triangleCount);
+        m_packets.reserve(m_buildNodes.size() / 2 + 1);
+        m_nodes.reserve(m_buildNodes.size() / 3 + 1);
+        if (m_buildNodes[root].left == 0) {
+            // 삼각형이 4개 이하면 잎 하나짜리 루트
+            Node node = {};
+            fill(begin(node.child), end(node.child), kEmptyChild);
+            m_nodes.push_back(node);
+            const BuildNode &leaf = m_buildNodes[root];
+            m_nodes[0].minX[0] = leaf.boundsMin.x;
+            m_nodes[0].minY[0] = leaf.boundsMin.y;
+            m_nodes[0].minZ[0] = leaf.boundsMin.z;
+            m_nodes[0].maxX[0] = leaf.boundsMax.x;
+            m_nodes[0].maxY[0] = leaf.boundsMax.y;
+            m_nodes[0].maxZ[0] = leaf.boundsMax.z;
+            m_nodes[0].child[0] = kLeafFlag | MakePacket(leaf);
+            m_stats.maxDepth = 1;
+        }
+        else {
+            Collapse(root, 1);
+        }
+
+        // 만드는 동안만 쓰는 배열은 돌려줌
+        m_buildNodes = {};
+        m_buildOrder = {};
+        m_centroids = {};
+        m_triangleMin = {};
+        m_triangleMax = {};
+        m_positions = {};
+
+        m_stats.nodeCount = uint32_t(m_nodes.size());
+        m_stats.packetCount = uint32_t(m_packets.size());
+        m_stats.buildMs = chrono::duration<double, milli>(Clock::now() - start).count();
+    }
+
+    uint32_t TriangleBvh::BuildBinary(uint32_t first, uint32_t count)
+    {
+        const uint32_t index = uint32_t(m_buildNodes.size());
+        m_buildNodes.emplace_back();
+
+        Vector3 boundsMin(INFINITY, INFINITY, INFINITY), boundsMax(-INFINITY, -INFINITY, -INFINITY);
+        Vector3 centroidMin = boundsMin, centroidMax = boundsMax;
+        for (uint32_t i = first; i < first + count; i++) {
+            const uint32_t triangle = m_buildOrder[i];
+            boundsMin = Vector3::Min(boundsMin, m_triangleMin[triangle]);
+            boundsMax = Vector3::Max(boundsMax, m_triangleMax[triangle]);
+            centroidMin = Vector3::Min(centroidMin, m_centroids[triangle]);
+            centroidMax = Vector3::Max(centroidMax, m_centroids[triangle]);
+        }
+        {
+            BuildNode &node = m_buildNodes[index];
+            node.boundsMin = boundsMin;
+            node.boundsMax = boundsMax;
+            node.first = first;
+            node.count = count;
+        }
+        if (count <= kLeafSize)
+            return index;
+
+        const Vector3 extent = centroidMax - centroidMin;
+        const uint32_t axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        const float axisMin = GetAxis(centroidMin, axis);
+        const float axisExtent = GetAxis(extent, axis);
+        uint32_t middle = count / 2;
+
+        if (axisExtent > 0.0f) {
+            // 중심점을 축을 따라 16칸에 나누고, 칸 경계 15곳 중 SAH 비용이 가장 작은 곳에서 자름
+            struct Bin {
+                Vector3 boundsMin{INFINITY, INFINITY, INFINITY};
+                Vector3 boundsMax{-INFINITY, -INFINITY, -INFINITY};
+                uint32_t count = 0;
+            };
+            Bin bins[kBinCount];
+            const float scale = float(kBinCount) / axisExtent;
+            auto getBin = [&](uint32_t triangle) {
+                return min(kBinCount - 1, uint32_t((GetAxis(m_centroids[triangle], axis) - axisMin) * scale));
+            };
+            for (uint32_t i = first; i < first + count; i++) {
+                const uint32_t triangle = m_buildOrder[i];
+                Bin &bin = bins[getBin(triangle)];
+                bin.boundsMin = Vector3::Min(bin.boundsMin, m_triangleMin[triangle]);
+                bin.boundsMax = Vector3::Max(bin.boundsMax, m_triangleMax[triangle]);
+                bin.count++;
+            }
+
+            float rightCost[kBinCount] = {};
+            Bin right;
+            for (uint32_t i = kBinCount - 1; i > 0; i--) {
+                right.boundsMin = Vector3::Min(right.boundsMin, bins[i].boundsMin);
+                right.boundsMax = Vector3::Max(right.boundsMax, bins[i].boundsMax);
+                right.count += bins[i].count;
+                rightCost[i] = right.count > 0 ? right.count * SurfaceArea(right.boundsMin, right.boundsMax) : 0.0f;
+            }
+            Bin left;
+            float bestCost = INFINITY;
+            uint32_t bestSplit = 0;
+            for (uint32_t i = 0; i + 1 < kBinCount; i++) {
+                left.boundsMin = Vector3::Min(left.boundsMin, bins[i].boundsMin);
+                left.boundsMax = Vector3::Max(left.boundsMax, bins[i].boundsMax);
+                left.count += bins[i].count;
+                if (left.count == 0 || left.count == count)
+                    continue;
+                const float cost = left.count * SurfaceArea(left.boundsMin, left.boundsMax) + rightCost[i + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestSplit = i;
+                }
+            }
+
+            if (bestCost < INFINITY) {
+                const auto split =
+                    partition(m_buildOrder.begin() + first, m_buildOrder.begin() + first + count,
+                              [&](uint32_t triangle) { return getBin(triangle) <= bestSplit; });
+                middle = uint32_t(split - (m_buildOrder.begin() + first));
+            }
+            else {
+                // 모든 중심점이 한 칸에 몰림: 축 위의 순서로 반씩
+                nth_element(m_buildOrder.begin() + first, m_buildOrder.begin() + first + middle,
+                            m_buildOrder.begin() + first + count, [&](uint32_t a, uint32_t b) {
+                                return GetAxis(m_centroids[a], axis) < GetAxis(m_centroids[b], axis);
+                            });
+            }
+        }
+
+        const uint32_t left = BuildBinary(first, middle);
+        const uint32_t right = BuildBinary(first + middle, count - middle);
+        m_buildNodes[index].left = left;
+        m_buildNodes[index].right = right;
+        return index;
+    }
+
+    uint32_t TriangleBvh::Collapse(uint32_t buildNode, uint32_t depth)
+    {
+        // 표면적이 가장 큰 안쪽 자식을 그 자식의 두 자식으로 바꾸기를 4개가 될 때까지 반복
+        uint32_t children[4] = {m_buildNodes[buildNode].left, m_buildNodes[buildNode].right};
+        uint32_t childCount = 2;
+        while (childCount < 4) {
+            int best = -1;
+            float bestArea = -1.0f;
+            for (uint32_t i = 0; i < childCount; i++) {
+                const BuildNode &child = m_buildNodes[children[i]];
+                const float area = SurfaceArea(child.boundsMin, child.boundsMax);
+                if (child.left != 0 && area > bestArea) {
+                    best = int(i);
+                    bestArea = area;
+                }
+            }
+            if (best < 0)
+                break;
+            const BuildNode &expanded = m_buildNodes[children[best]];
+            children[best] = expanded.left;
+            children[childCount++] = expanded.right;
+        }
+
+        const uint32_t index = uint32_t(m_nodes.size());
+        Node empty = {};
+        fill(begin(empty.child), end(empty.child), kEmptyChild);
+        m_nodes.push_back(empty);
+        m_stats.maxDepth = max(m_stats.maxDepth, depth);
+
+        for (uint32_t i = 0; i < childCount; i++) {
+            const BuildNode &child = m_buildNodes[children[i]];
+            const uint32_t encoded = child.left == 0 ? (kLeafFlag | MakePacket(child)) : Collapse(children[i], depth + 1);
+            Node &node = m_nodes[index]; // Collapse()가 m_nodes를 늘릴 수 있으므로 다시 찾음
+            node.minX[i] = child.boundsMin.x;
+            node.minY[i] = child.boundsMin.y;
+            node.minZ[i] = child.boundsMin.z;
+            node.maxX[i] = child.boundsMax.x;
+            node.maxY[i] = child.boundsMax.y;
+            node.maxZ[i] = child.boundsMax.z;
+            node.child[i] = encoded;
+        }
+        return index;
+    }
+
+    uint32_t TriangleBvh::MakePacket(const BuildNode &leaf)
+    {
+        TrianglePacket packet = {};
+        for (uint32_t lane = 0; lane < leaf.count; lane++) {
+            const uint32_t triangle = m_buildOrder[leaf.first + lane];
+            const Vector3 &p0 = m_positions[triangle * 3];
+            const Vector3 e1 = m_positions[triangle * 3 + 1] - p0;
+            const Vector3 e2 = m_positions[triangle * 3 + 2] - p0;
+            packet.p0x[lane] = p0.x;
+            packet.p0y[lane] = p0.y;
+            packet.p0z[lane] = p0.z;
+            packet.e1x[lane] = e1.x;
+            packet.e1y[lane] = e1.y;
+            packet.e1z[lane] = e1.z;
+            packet.e2x[lane] = e2.x;
+            packet.e2y[lane] = e2.y;
+            packet.e2z[lane] = e2.z;
+            packet.triangle[lane] = triangle;
+        }
+        m_packets.push_back(packet);
+        return uint32_t(m_packets.size() - 1);
+    }
+
+    bool TriangleBvh::Intersect(const Vector3 &origin, const Vector3 &direction, float tMin, float tMax,
+                                RayHit &hit) const
+    {
+        return Traverse<false>(origin, direction, tMin, tMax, &hit);
+    }
+
+    bool TriangleBvh::IsOccluded(const Vector3 &origin, const Vector3 &direction, float tMin, float tMax) const
+    {
+        return Traverse<true>(origin, direction, tMin, tMax, nullptr);
+    }
+
+    template <bool T_ANY_HIT>
+    bool TriangleBvh::Traverse(const Vector3 &origin, const Vector3 &direction, float tMin, float tMax,
+                               RayHit *hit) const
+    {
+        if (m_nodes.empty())
+            return false;
+
+        const XMVECTOR ox = XMVectorReplicate(origin.x), oy = XMVectorReplicate(origin.y),
+                       oz = XMVectorReplicate(origin.z);
+        const XMVECTOR dx = XMVectorReplicate(direction.x), dy = XMVectorReplicate(direction.y),
+                       dz = XMVectorReplicate(direction.z);
+        const XMVECTOR invX = XMVectorReplicate(SafeReciprocal(direction.x));
+        const XMVECTOR invY = XMVectorReplicate(SafeReciprocal(direction.y));
+        const XMVECTOR invZ = XMVectorReplicate(SafeReciprocal(direction.z));
+        const XMVECTOR nearLimit = XMVectorReplicate(tMin);
+        const XMVECTOR zero = XMVectorZero();
+        const XMVECTOR one = XMVectorSplatOne();
+        const XMVECTOR epsilon = XMVectorReplicate(1e-20f);
+
+        float best = tMax;
+        bool found = false;
+        uint32_t stack[kStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0) {
+            const uint32_t entry = stack[--stackSize];
+
+            if (entry & kLeafFlag) {
+                // Moller-Trumbore를 4레인으로
+                const TrianglePacket &packet = m_packets[entry & ~kLeafFlag];
+                const XMVECTOR e1x = Load4(packet.e1x), e1y = Load4(packet.e1y), e1z = Load4(packet.e1z);
+                const XMVECTOR e2x = Load4(packet.e2x), e2y = Load4(packet.e2y), e2z = Load4(packet.e2z);
+                const XMVECTOR px = XMVectorSubtract(XMVectorMultiply(dy, e2z), XMVectorMultiply(dz, e2y));
+                const XMVECTOR py = XMVectorSubtract(XMVectorMultiply(dz, e2x), XMVectorMultiply(dx, e2z));
+                const XMVECTOR pz = XMVectorSubtract(XMVectorMultiply(dx, e2y), XMVectorMultiply(dy, e2x));
+                const XMVECTOR det = XMVectorMultiplyAdd(e1x, px, XMVectorMultiplyAdd(e1y, py, XMVectorMultiply(e1z, pz)));
+                const XMVECTOR invDet = XMVectorReciprocal(det);
+
+                const XMVECTOR tx = XMVectorSubtract(ox, Load4(packet.p0x));
+                const XMVECTOR ty = XMVectorSubtract(oy, Load4(packet.p0y));
+                const XMVECTOR tz = XMVectorSubtract(oz, Load4(packet.p0z));
+                const XMVECTOR u =
+                    XMVectorMultiply(XMVectorMultiplyAdd(tx, px, XMVectorMultiplyAdd(ty, py, XMVectorMultiply(tz, pz))), invDet);
+                const XMVECTOR qx = XMVectorSubtract(XMVectorMultiply(ty, e1z), XMVectorMultiply(tz, e1y));
+                const XMVECTOR qy = XMVectorSubtract(XMVectorMultiply(tz, e1x), XMVectorMultiply(tx, e1z));
+                const XMVECTOR qz = XMVectorSubtract(XMVectorMultiply(tx, e1y), XMVectorMultiply(ty, e1x));
+                const XMVECTOR v =
+                    XMVectorMultiply(XMVectorMultiplyAdd(dx, qx, XMVectorMultiplyAdd(dy, qy, XMVectorMultiply(dz, qz))), invDet);
+                const XMVECTOR t =
+                    XMVectorMultiply(XMVectorMultiplyAdd(e2x, qx, XMVectorMultiplyAdd(e2y, qy, XMVectorMultiply(e2z, qz))), invDet);
+
+                XMVECTOR mask = XMVectorGreater(XMVectorAbs(det), epsilon);
+                mask = XMVectorAndInt(mask, XMVectorGreaterOrEqual(u, zero));
+                mask = XMVectorAndInt(mask, XMVectorGreaterOrEqual(v, zero));
+                mask = XMVectorAndInt(mask, XMVectorLessOrEqual(XMVectorAdd(u, v), one));
+                mask = XMVectorAndInt(mask, XMVectorGreater(t, nearLimit));
+                mask = XMVectorAndInt(mask, XMVectorLess(t, XMVectorReplicate(best)));
+
+                float hits[4], ts[4], us[4], vs[4];
+                Store4(hits, XMVectorSelect(zero, one, mask));
+                Store4(ts, t);
+                for (uint32_t lane = 0; lane < 4; lane++) {
+                    if (hits[lane] == 0.0f || ts[lane] >= best)
+                        continue;
+                    if constexpr (T_ANY_HIT) {
+                        return true;
+                    }
+                    else {
+                        Store4(us, u);
+                        Store4(vs, v);
+                        best = ts[lane];
+                        hit->t = ts[lane];
+                        hit->triangle = packet.triangle[lane];
+                        hit->u = us[lane];
+                        hit->v = vs[lane];
+                        found = true;
+                    }
+                }
+                continue;
+            }
+
+            // 자식 상자 4개와 광선의 slab 검사
+            const Node &node = m_nodes[entry];
+            const XMVECTOR x0 = XMVectorMultiply(XMVectorSubtract(Load4(node.minX), ox), invX);
+            const XMVECTOR x1 = XMVectorMultiply(XMVectorSubtract(Load4(node.maxX), ox), invX);
+            const XMVECTOR y0 = XMVectorMultiply(XMVectorSubtract(Load4(node.minY), oy), invY);
+            const XMVECTOR y1 = XMVectorMultiply(XMVectorSubtract(Load4(node.maxY), oy), invY);
+            const XMVECTOR z0 = XMVectorMultiply(XMVectorSubtract(Load4(node.minZ), oz), invZ);
+            const XMVECTOR z1 = XMVectorMultiply(XMVectorSubtract(Load4(node.maxZ), oz), invZ);
+            const XMVECTOR tNear = XMVectorMax(XMVectorMax(XMVectorMin(x0, x1), XMVectorMin(y0, y1)),
+                                               XMVectorMax(XMVectorMin(z0, z1), nearLimit));
+            const XMVECTOR tFar = XMVectorMin(XMVectorMin(XMVectorMax(x0, x1), XMVectorMax(y0, y1)),
+                                              XMVectorMin(XMVectorMax(z0, z1), XMVectorReplicate(best)));
+            float hits[4], distances[4];
+            Store4(hits, XMVectorSelect(zero, one, XMVectorLessOrEqual(tNear, tFar)));
+            Store4(distances, tNear);
+
+            // 가까운 자식을 먼저 꺼내도록 먼 것부터 쌓음
+            uint32_t order[4];
+            uint32_t orderCount = 0;
+            for (uint32_t lane = 0; lane < 4; lane++) {
+                if (hits[lane] == 0.0f || node.child[lane] == kEmptyChild)
+                    continue;
+                uint32_t k = orderCount++;
+                while (k > 0 && distances[order[k - 1]] < distances[lane]) {
+                    order[k] = order[k - 1];
+                    k--;
+                }
+                order[k] = lane;
+            }
+            if (stackSize + orderCount > kStackSize)
+                orderCount = kStackSize - stackSize; // 깊이 제한 (SAH 트리에서는 일어나지 않음)
+            for (uint32_t k = 0; k < orderCount; k++)
+                stack[stackSize++] = node.child[order[k]];
+        }
+        return found;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <directxtk/SimpleMath.h>
+#include <span>
+#include <vector>
+
+namespace luke {
+
+    using DirectX::SimpleMath::Vector3;
+
+    struct RayHit {
+        float t = 0.0f;
+        uint32_t triangle = 0; // Build()에 넘긴 삼각형 번호
+        float u = 0.0f;        // 무게중심 좌표: 점 = (1 - u - v) * p0 + u * p1 + v * p2
+        float v = 0.0f;
+    };
+
+    struct BvhStats {
+        uint32_t triangleCount = 0;
+        uint32_t nodeCount = 0;   // 4갈래 노드
+        uint32_t packetCount = 0; // 삼각형 4개 묶음 (= 잎)
+        uint32_t maxDepth = 0;
+        double buildMs = 0.0;
+    };
+
+    // 삼각형 단위 BVH. 자식이 4개인 노드와 삼각형 4개 묶음(패킷)으로 저장해서 XMVECTOR 한 번에
+    // 상자 4개 또는 삼각형 4개를 검사합니다.
+    //   1. 중심점을 16칸으로 나눈 SAH로 이진 트리를 만들고 (삼각형 4개 이하면 잎)
+    //   2. 표면적이 가장 큰 자식을 펼쳐 가며 4갈래 노드로 합침
+    // 노드/패킷은 성분별 배열(SoA)이라 그대로 4레인에 읽힙니다.
+    // Build() 이후에는 읽기만 하므로 여러 스레드에서 동시에 광선을 쏴도 됩니다.
+    class TriangleBvh {
+    public:
+        // positions: 삼각형마다 정점 3개 (p0, p1, p2 순서)
+        void Build(std::span<const Vector3> positions);
+
+        // 가장 가까운 교차 (tMin < t < tMax). direction은 정규화하지 않아도 되고 t는 direction 단위
+        bool Intersect(const Vector3 &origin, const Vector3 &direction, float tMin, float tMax, RayHit &hit) const;
+        // (tMin, tMax) 사이에 무엇이든 있는지. 처음 찾은 교차에서 멈춤 (그림자 광선)
+        bool IsOccluded(const Vector3 &origin, const Vector3 &direction, float tMin, float tMax) const;
+
+        const BvhStats &GetStats() const { return m_stats; }
+
+    private:
+        static constexpr uint32_t kLeafFlag = 0x80000000u;
+        static constexpr uint32_t kEmptyChild = ~0u;
+
+        // 자식 4개의 AABB. child는 노드 번호, kLeafFlag | 패킷 번호, 또는 kEmptyChild
+        struct alignas(16) Node {
+            float minX[4], minY[4], minZ[4];
+            float maxX[4], maxY[4], maxZ[4];
+            uint32_t child[4];
+        };
+
+        // 삼각형 4개 (p0, e1 = p1 - p0, e2 = p2 - p0). 빈 레인은 e1 = e2 = 0이라 항상 빗나감
+        struct alignas(16) TrianglePacket {
+            float p0x[4], p0y[4], p0z[4];
+            float e1x[4], e1y[4], e1z[4];
+            float e2x[4], e2y[4], e2z[4];
+            uint32_t triangle[4];
+        };
+
+        struct BuildNode {
+            Vector3 boundsMin;
+            Vector3 boundsMax;
+            uint32_t left = 0; // 잎이면 0
+            uint32_t right = 0;
+            uint32_t first = 0; // m_buildOrder[first, first + count)
+            uint32_t count = 0;
+        };
+
+        template <bool T_ANY_HIT>
+        bool Traverse(const Vector3 &origin, const Vector3 &direction, float tMin, float tMax, RayHit *hit) const;
+
+        uint32_t BuildBinary(uint32_t first, uint32_t count);
+        uint32_t Collapse(uint32_t buildNode, uint32_t depth);
+        uint32_t MakePacket(const BuildNode &leaf);
+
+        std::vector<Node> m_nodes; // m_nodes[0]이 루트
+        std::vector<TrianglePacket> m_packets;
+        BvhStats m_stats;
+
+        // Build() 중에만 씀
+        std::vector<BuildNode> m_buildNodes;
+        std::vector<uint32_t> m_buildOrder;
+        std::vector<Vector3> m_centroids;
+        std::vector<Vector3> m_triangleMin;
+        std::vector<Vector3> m_triangleMax;
+        std::span<const Vector3> m_positions;
+    };
+}
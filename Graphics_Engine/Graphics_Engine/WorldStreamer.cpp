@@ -0,0 +1,347 @@
+#include "WorldStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace luke {
+    using namespace std;
+
+    namespace {
+        // 한 번도 읽지 않았고 평균도 없을 때 예산에 잡아두는 크기
+        constexpr uint64_t kDefaultCellBytes = 256 * 1024;
+
+        void RemoveCell(vector<uint32_t> &cells, uint32_t cell)
+        {
+            const auto it = find(cells.begin(), cells.end(), cell);
+            if (it != cells.end()) {
+                *it = cells.back();
+                cells.pop_back();
+            }
+        }
+    }
+
+    void WorldStreamer::Initialize(const WorldStreamingSettings &settings, JobSystem &jobSystem,
+                                   LoadFunction load, UploadFunction upload, UnloadFunction unload)
+    {
+        Shutdown();
+
+        m_jobSystem = &jobSystem;
+        m_load = std::move(load);
+        m_upload = std::move(upload);
+        m_unload = std::move(unload);
+        m_cells.clear(); // 격자 크기를 새로 받도록 먼저 비움
+        SetSettings(settings);
+        m_cellSize = m_settings.cellSize;
+        m_gridWidth = m_settings.gridWidth;
+        m_gridDepth = m_settings.gridDepth;
+        m_cells.assign(size_t(m_gridWidth) * m_gridDepth, Cell());
+        m_stats = WorldStreamingStats();
+        m_averageCellBytes = 0;
+
+        // 프레임 중에는 할당하지 않도록 최대 크기로 잡아둠
+        m_resident.reserve(m_cells.size());
+        m_waiting.reserve(m_cells.size());
+        m_loading.reserve(m_cells.size());
+        m_candidates.reserve(m_cells.size());
+        m_evictable.reserve(m_cells.size());
+        m_finished.reserve(m_cells.size());
+        m_finishedSwap.reserve(m_cells.size());
+    }
+
+    void WorldStreamer::Shutdown()
+    {
+        if (!m_jobSystem)
+            return;
+
+        WaitForLoads();
+        CollectFinishedLoads();
+        while (!m_waiting.empty())
+            UnloadCell(m_waiting.back());
+        while (!m_resident.empty())
+            UnloadCell(m_resident.back());
+        m_jobSystem = nullptr;
+    }
+
+    void WorldStreamer::SetSettings(const WorldStreamingSettings &settings)
+    {
+        m_settings = settings;
+        if (!m_cells.empty()) {
+            m_settings.cellSize = m_cellSize;
+            m_settings.gridWidth = m_gridWidth;
+            m_settings.gridDepth = m_gridDepth;
+        }
+        m_settings.unloadRadius = max(m_settings.unloadRadius, m_settings.loadRadius);
+        m_settings.maxPendingLoads = max(m_settings.maxPendingLoads, 1u);
+        m_settings.maxUploadsPerFrame = max(m_settings.maxUploadsPerFrame, 1u);
+    }
+
+    Vector3 WorldStreamer::GetCellCenter(uint32_t cell) const
+    {
+        const uint32_t x = cell % m_gridWidth;
+        const uint32_t z = cell / m_gridWidth;
+        return Vector3((float(x) + 0.5f - 0.5f * m_gridWidth) * m_cellSize, 0.0f,
+                       (float(z) + 0.5f - 0.5f * m_gridDepth) * m_cellSize);
+    }
+
+    float WorldStreamer::GetPriority(uint32_t cell, const Vector3 &eye, const Vector3 &direction,
+                                     float &distance) const
+    {
+        // 높이는 무시하고 XZ 평면에서만 잼
+        Vector3 offset = GetCellCenter(cell) - eye;
+        offset.y = 0.0f;
+        distance = offset.Length();
+        if (distance < 1e-4f)
+            return 0.0f;
+        const float facing = offset.Dot(direction) / distance; // [-1, 1]
+        return distance * (1.0f - m_settings.directionWeight * facing);
+    }
+
+    uint64_t WorldStreamer::EstimateBytes(uint32_t cell) const
+    {
+        if (m_cells[cell].bytes > 0)
+            return m_cells[cell].bytes;
+        return m_averageCellBytes > 0 ? m_averageCellBytes : kDefaultCellBytes;
+    }
+
+    void WorldStreamer::UnloadCell(uint32_t cell)
+    {
+        Cell &state = m_cells[cell];
+        if (state.state == CellState::Resident)
+            RemoveCell(m_resident, cell);
+        else if (state.state == CellState::Loaded)
+            RemoveCell(m_waiting, cell);
+        else
+            return;
+
+        if (m_unload)
+            m_unload(cell);
+        m_stats.residentBytes -= min(m_stats.residentBytes, state.bytes);
+        state.state = CellState::Unloaded;
+        m_stats.unloads++;
+    }
+
+    void WorldStreamer::CollectFinishedLoads()
+    {
+        {
+            lock_guard<mutex> lock(m_finishedMutex);
+            m_finishedSwap.swap(m_finished);
+        }
+
+        for (const auto &[cell, bytes] : m_finishedSwap) {
+            Cell &state = m_cells[cell];
+            RemoveCell(m_loading, cell);
+            m_loadingBytes -= min(m_loadingBytes, state.estimate);
+
+            if (bytes == 0 || state.cancelled) {
+                // 읽다 만 데이터도 있을 수 있으므로 항상 Unload()
+                if (m_unload)
+                    m_unload(cell);
+                state.state = CellState::Unloaded;
+                if (bytes == 0)
+                    m_stats.failedLoads++;
+                else
+                    m_stats.cancelledLoads++;
+                continue;
+            }
+
+            state.state = CellState::Loaded;
+            state.bytes = bytes;
+            m_averageCellBytes = m_averageCellBytes == 0 ? bytes : (m_averageCellBytes * 7 + bytes) / 8;
+            m_stats.residentBytes += bytes;
+            m_waiting.push_back(cell);
+        }
+        m_finishedSwap.clear();
+    }
+
+    void WorldStreamer::WaitForLoads()
+    {
+        unique_lock<mutex> lock(m_finishedMutex);
+        m_loadsDone.wait(lock, [this] { return m_inFlight.load() == 0; });
+    }
+
+    void WorldStreamer::Update(const Vector3 &eyePosition, const Vector3 &viewDirection)
+    {
+        if (!m_jobSystem)
+            return;
+
+        m_stats.frames++;
+        m_stats.uploadBytesThisFrame = 0;
+        CollectFinishedLoads();
+
+        Vector3 direction(viewDirection.x, 0.0f, viewDirection.z);
+        if (direction.LengthSquared() > 1e-8f)
+            direction.Normalize();
+        else
+            direction = Vector3::Zero; // 위/아래를 보면 방향은 무시
+
+        float distance;
+        m_eyePosition = eyePosition;
+        m_viewDirection = direction;
+
+#pragma region 멀어진 셀 내리기 (unloadRadius 밖)
+        for (size_t i = m_resident.size(); i-- > 0;) {
+            const uint32_t cell = m_resident[i];
+            GetPriority(cell, eyePosition, direction, distance);
+            if (distance > m_settings.unloadRadius)
+                UnloadCell(cell);
+        }
+        for (size_t i = m_waiting.size(); i-- > 0;) {
+            const uint32_t cell = m_waiting[i];
+            GetPriority(cell, eyePosition, direction, distance);
+            if (distance > m_settings.unloadRadius)
+                UnloadCell(cell);
+        }
+        // 읽는 중인 셀은 끝난 뒤에 버림. 다시 가까워지면 취소를 되돌림
+        for (uint32_t cell : m_loading) {
+            GetPriority(cell, eyePosition, direction, distance);
+            m_cells[cell].cancelled = distance > m_settings.unloadRadius;
+        }
+#pragma endregion
+
+#pragma region 업로드 (우선순위 순, 프레임당 개수/바이트 제한)
+        m_candidates.clear();
+        for (uint32_t cell : m_waiting)
+            m_candidates.push_back({GetPriority(cell, eyePosition, direction, distance), cell});
+        sort(m_candidates.begin(), m_candidates.end(),
+             [](const Candidate &a, const Candidate &b) { return a.priority < b.priority; });
+
+        uint32_t uploads = 0;
+        for (const Candidate &candidate : m_candidates) {
+            if (uploads >= m_settings.maxUploadsPerFrame ||
+                (uploads > 0 && m_stats.uploadBytesThisFrame >= m_settings.uploadBytesPerFrame))
+                break;
+
+            const uint32_t cell = candidate.cell;
+            Cell &state = m_cells[cell];
+            const uint64_t gpuBytes = m_upload ? m_upload(cell) : state.bytes;
+            if (gpuBytes == 0) {
+                m_stats.failedLoads++;
+                UnloadCell(cell);
+                continue;
+            }
+
+            RemoveCell(m_waiting, cell);
+            m_stats.residentBytes = m_stats.residentBytes - min(m_stats.residentBytes, state.bytes) + gpuBytes;
+            state.bytes = gpuBytes;
+            state.state = CellState::Resident;
+            m_resident.push_back(cell);
+            m_stats.uploadBytesThisFrame += gpuBytes;
+            m_stats.uploads++;
+            uploads++;
+        }
+#pragma endregion
+
+#pragma region 새 셀 읽기 (loadRadius 안, 우선순위 순, 메모리 예산)
+        // loadRadius를 감싸는 셀 범위만 훑음
+        auto toCell = [&](float value, uint32_t count) {
+            return int(floor(value / m_settings.cellSize + 0.5f * count));
+        };
+        const int minX = max(toCell(eyePosition.x - m_settings.loadRadius, m_settings.gridWidth), 0);
+        const int maxX = min(toCell(eyePosition.x + m_settings.loadRadius, m_settings.gridWidth),
+                             int(m_settings.gridWidth) - 1);
+        const int minZ = max(toCell(eyePosition.z - m_settings.loadRadius, m_settings.gridDepth), 0);
+        const int maxZ = min(toCell(eyePosition.z + m_settings.loadRadius, m_settings.gridDepth),
+                             int(m_settings.gridDepth) - 1);
+
+        m_candidates.clear();
+        m_stats.missingRequiredCells = 0;
+        for (int z = minZ; z <= maxZ; z++) {
+            for (int x = minX; x <= maxX; x++) {
+                const uint32_t cell = uint32_t(z) * m_settings.gridWidth + uint32_t(x);
+                const float priority = GetPriority(cell, eyePosition, direction, distance);
+                if (distance > m_settings.loadRadius)
+                    continue;
+                const CellState state = m_cells[cell].state;
+                if (distance <= m_settings.requiredRadius && state != CellState::Resident)
+                    m_stats.missingRequiredCells++;
+                if (state == CellState::Unloaded)
+                    m_candidates.push_back({priority, cell});
+            }
+        }
+        if (m_stats.missingRequiredCells > 0)
+            m_stats.stallFrames++;
+        sort(m_candidates.begin(), m_candidates.end(),
+             [](const Candidate &a, const Candidate &b) { return a.priority < b.priority; });
+
+        // 예산이 모자라면 우선순위가 가장 나쁜 셀부터 내림 (새 셀보다 나쁜 것만)
+        bool evictableReady = false;
+        size_t evictIndex = 0;
+        bool budgetLimited = false;
+        for (const Candidate &candidate : m_candidates) {
+            if (m_inFlight.load() >= m_settings.maxPendingLoads)
+                break;
+
+            const uint32_t cell = candidate.cell;
+            const uint64_t estimate = EstimateBytes(cell);
+            while (m_stats.residentBytes + m_loadingBytes + estimate > m_settings.memoryBudget) {
+                if (!evictableReady) {
+                    m_evictable.clear();
+                    for (uint32_t resident : m_resident)
+                        m_evictable.push_back({GetPriority(resident, eyePosition, direction, distance), resident});
+                    sort(m_evictable.begin(), m_evictable.end(),
+                         [](const Candidate &a, const Candidate &b) { return a.priority > b.priority; });
+                    evictableReady = true;
+                }
+                if (evictIndex >= m_evictable.size() || m_evictable[evictIndex].priority <= candidate.priority)
+                    break;
+                UnloadCell(m_evictable[evictIndex++].cell);
+                m_stats.evictions++;
+            }
+            if (m_stats.residentBytes + m_loadingBytes + estimate > m_settings.memoryBudget) {
+                budgetLimited = true;
+                break;
+            }
+
+            Cell &state = m_cells[cell];
+            state.state = CellState::Loading;
+            state.cancelled = false;
+            state.estimate = estimate;
+            m_loadingBytes += estimate;
+            m_loading.push_back(cell);
+            m_stats.loads++;
+
+            m_inFlight.fetch_add(1);
+            m_jobSystem->Submit([this, cell] {
+                const uint64_t bytes = m_load ? m_load(cell) : 0;
+                lock_guard<mutex> lock(m_finishedMutex);
+                m_finished.push_back({cell, bytes});
+                if (m_inFlight.fetch_sub(1) == 1)
+                    m_loadsDone.notify_all();
+            });
+        }
+        if (budgetLimited)
+            m_stats.budgetLimitedFrames++;
+#pragma endregion
+
+        m_stats.residentCells = uint32_t(m_resident.size());
+        m_stats.waitingCells = uint32_t(m_waiting.size());
+        m_stats.loadingCells = uint32_t(m_loading.size());
+        m_stats.peakResidentBytes = max(m_stats.peakResidentBytes, m_stats.residentBytes);
+    }
+
+    uint64_t WorldStreamer::Evict(uint64_t bytes)
+    {
+        // Update()의 예산 퇴출과 같은 순서 (Update() 중에 불려도 되도록 m_evictable은 쓰지 않음)
+        float distance;
+        vector<Candidate> evictable;
+        evictable.reserve(m_resident.size());
+        for (uint32_t cell : m_resident) {
+            const float priority = GetPriority(cell, m_eyePosition, m_viewDirection, distance);
+            if (distance > m_settings.requiredRadius)
+                evictable.push_back({priority, cell});
+        }
+        sort(evictable.begin(), evictable.end(),
+             [](const Candidate &a, const Candidate &b) { return a.priority > b.priority; });
+
+        uint64_t evicted = 0;
+        for (const Candidate &candidate : evictable) {
+            if (evicted >= bytes)
+                break;
+            evicted += m_cells[candidate.cell].bytes;
+            UnloadCell(candidate.cell);
+            m_stats.evictions++;
+        }
+        m_stats.residentCells = uint32_t(m_resident.size());
+        return evicted;
+    }
+}
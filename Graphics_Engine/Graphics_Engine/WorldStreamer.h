@@ -0,0 +1,155 @@
+#pragma once
+
+#include <directxtk/SimpleMath.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "JobSystem.h"
+
+namespace luke {
+
+    using DirectX::SimpleMath::Vector3;
+
+    struct WorldStreamingSettings {
+        // 월드는 XZ 평면에서 원점을 중심으로 gridWidth x gridDepth개의 정사각형 셀로 나눔
+        float cellSize = 16.0f;
+        uint32_t gridWidth = 32;
+        uint32_t gridDepth = 32;
+
+        // 셀 중심까지의 거리가 loadRadius 안이면 읽고, unloadRadius 밖으로 나가면 내림
+        // 둘 사이(히스테리시스)에서는 상태를 바꾸지 않으므로 경계에서 왔다 갔다 해도 다시 읽지 않음
+        float loadRadius = 48.0f;
+        float unloadRadius = 64.0f;
+        // 이 거리 안의 셀이 올라와 있지 않으면 스톨 (화면에 구멍이 보이는 상황)
+        float requiredRadius = 16.0f;
+
+        // 우선순위 = 거리 * (1 - directionWeight * cos(시선과 셀 방향)). 작을수록 먼저
+        float directionWeight = 0.5f;
+
+        uint64_t memoryBudget = 64ull << 20; // 올라와 있는 셀의 바이트 (읽는 중인 셀의 예상치 포함)
+        uint32_t maxPendingLoads = 4;        // 동시에 읽는 셀 수
+        uint32_t maxUploadsPerFrame = 2;     // 프레임당 Upload() 수
+        uint64_t uploadBytesPerFrame = 4ull << 20; // 넘으면 그 프레임에는 더 올리지 않음 (첫 셀은 항상 허용)
+    };
+
+    struct WorldStreamingStats {
+        uint32_t residentCells = 0;
+        uint32_t loadingCells = 0;   // 작업 스레드에서 읽는 중
+        uint32_t waitingCells = 0;   // 읽었고 업로드를 기다리는 중
+        uint64_t residentBytes = 0;  // 업로드된 셀 + 업로드를 기다리는 셀
+        uint64_t peakResidentBytes = 0;
+
+        uint64_t loads = 0;
+        uint64_t uploads = 0;
+        uint64_t unloads = 0;
+        uint64_t evictions = 0;      // 예산 때문에 unloadRadius 안에서 내린 셀
+        uint64_t cancelledLoads = 0; // 읽는 동안 멀어져서 버린 셀
+        uint64_t failedLoads = 0;
+        uint64_t budgetLimitedFrames = 0; // 예산이 모자라서 읽지 못한 셀이 있었던 프레임
+
+        uint32_t missingRequiredCells = 0; // 이번 프레임
+        uint64_t stallFrames = 0;          // missingRequiredCells > 0인 프레임
+        uint64_t frames = 0;
+        uint64_t uploadBytesThisFrame = 0;
+    };
+
+    // 카메라 주변의 셀을 비동기로 읽고 내리는 월드 스트리머
+    // 셀의 내용은 모르고 인덱스(z * gridWidth + x)로만 다루며, 실제 작업은 Initialize()에 넘긴 함수가 합니다.
+    //   Load   : 작업 스레드. 파일 읽기, 압축 해제, 메쉬 생성처럼 CPU 데이터를 만들고 바이트 수를 반환 (실패하면 0)
+    //   Upload : Update()를 부른 스레드. GPU 버퍼를 만들고 올라간 바이트 수를 반환 (실패하면 0)
+    //   Unload : Update()를 부른 스레드. CPU/GPU 데이터를 모두 해제
+    // 같은 셀에 대해서는 한 번에 하나만 호출되므로 셀별 저장소는 잠그지 않아도 됩니다.
+    class WorldStreamer {
+    public:
+        using LoadFunction = std::function<uint64_t(uint32_t cell)>;
+        using UploadFunction = std::function<uint64_t(uint32_t cell)>;
+        using UnloadFunction = std::function<void(uint32_t cell)>;
+
+        WorldStreamer() = default;
+        ~WorldStreamer() { Shutdown(); }
+
+        WorldStreamer(const WorldStreamer &) = delete;
+        WorldStreamer &operator=(const WorldStreamer &) = delete;
+
+        void Initialize(const WorldStreamingSettings &settings, JobSystem &jobSystem, LoadFunction load,
+                        UploadFunction upload, UnloadFunction unload);
+        // 읽는 중인 작업을 기다리고 모든 셀을 내림
+        void Shutdown();
+
+        // 프레임마다 한 번. 끝난 읽기를 업로드하고, 멀어진 셀을 내리고, 새 셀의 읽기를 시작
+        void Update(const Vector3 &eyePosition, const Vector3 &viewDirection);
+
+        // 마지막 Update()의 카메라 기준으로 우선순위가 가장 나쁜 셀부터 bytes 이상이 될 때까지 내리고 내린 바이트를 반환
+        // requiredRadius 안의 셀은 내리지 않습니다. GPU 메모리 예산의 퇴출 콜백(GpuMemoryTracker)에서 부르며,
+        // Unload()를 부르므로 Update()를 부르는 스레드에서만 불러야 합니다. (Upload() 안에서 불려도 됨)
+        uint64_t Evict(uint64_t bytes);
+
+        // 예산/반경 같은 값만 바꿈 (셀 크기와 격자 크기는 Initialize()에서만)
+        void SetSettings(const WorldStreamingSettings &settings);
+        const WorldStreamingSettings &GetSettings() const { return m_settings; }
+        const WorldStreamingStats &GetStats() const { return m_stats; }
+
+        uint32_t GetCellCount() const { return uint32_t(m_cells.size()); }
+        // Initialize() 이후 바뀌지 않으므로 Load()에서 불러도 됨
+        Vector3 GetCellCenter(uint32_t cell) const;
+        float GetCellSize() const { return m_cellSize; }
+        // Upload()가 끝나서 그릴 수 있는 셀
+        bool IsResident(uint32_t cell) const { return m_cells[cell].state == CellState::Resident; }
+        const std::vector<uint32_t> &GetResidentCells() const { return m_resident; }
+
+    private:
+        enum class CellState : uint8_t { Unloaded, Loading, Loaded, Resident };
+
+        struct Cell {
+            CellState state = CellState::Unloaded;
+            bool cancelled = false;    // 읽는 동안 멀어짐. 끝나면 바로 내림
+            uint64_t bytes = 0;        // 올라와 있는 크기. 내린 뒤에는 다시 읽을 때의 예상치
+            uint64_t estimate = 0;     // 읽기를 시작할 때 예산에 잡아둔 크기
+        };
+
+        struct Candidate {
+            float priority;
+            uint32_t cell;
+        };
+
+        float GetPriority(uint32_t cell, const Vector3 &eye, const Vector3 &direction, float &distance) const;
+        uint64_t EstimateBytes(uint32_t cell) const;
+        void UnloadCell(uint32_t cell);
+        void CollectFinishedLoads();
+        void WaitForLoads();
+
+        WorldStreamingSettings m_settings;
+        // 셀 배치 (작업 스레드에서도 읽으므로 m_settings와 따로 둠)
+        float m_cellSize = 0.0f;
+        uint32_t m_gridWidth = 0;
+        uint32_t m_gridDepth = 0;
+        JobSystem *m_jobSystem = nullptr;
+        LoadFunction m_load;
+        UploadFunction m_upload;
+        UnloadFunction m_unload;
+
+        std::vector<Cell> m_cells;
+        std::vector<uint32_t> m_resident;   // Resident 셀 (순서 없음)
+        std::vector<uint32_t> m_waiting;    // Loaded 셀 (업로드 대기)
+        std::vector<uint32_t> m_loading;    // Loading 셀
+        uint64_t m_loadingBytes = 0;        // 읽는 중인 셀의 예상치 합
+        std::vector<Candidate> m_candidates; // 프레임마다 재사용
+        std::vector<Candidate> m_evictable;
+        uint64_t m_averageCellBytes = 0;     // 한 번도 읽지 않은 셀의 예상치
+        Vector3 m_eyePosition;               // 마지막 Update() (Evict()의 우선순위)
+        Vector3 m_viewDirection;
+
+        // 작업 스레드가 끝낸 읽기 (셀, 바이트). 0바이트면 실패
+        std::mutex m_finishedMutex;
+        std::vector<std::pair<uint32_t, uint64_t>> m_finished;
+        std::vector<std::pair<uint32_t, uint64_t>> m_finishedSwap;
+        std::atomic<uint32_t> m_inFlight{0};
+        std::condition_variable m_loadsDone;
+
+        WorldStreamingStats m_stats;
+    };
+}
@@ -0,0 +1,352 @@
+// Graphics_Tests.cpp : graphics_core의 결정적인(D3D11 없이 결과가 항상 같은) 부분을 검사하는 테스트
+//
+// 사용 예:
+//   Graphics_Tests                              모든 테스트
+//   Graphics_Tests handle_pool shader_reload    이름을 준 테스트만 (ctest는 테스트마다 따로 실행)
+// 실패한 검사가 있으면 위치를 출력하고 종료 코드 1을 반환합니다.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "HandlePool.h"
+#include "HeadlessBackend.h"
+#include "HeadlessPipelineCache.h"
+#include "Memory.h"
+#include "RenderTargetPool.h"
+#include "ShaderHotReloader.h"
+#include "StaticBatcher.h"
+
+using namespace luke;
+using namespace std;
+
+namespace {
+    int g_failures = 0;
+
+#define CHECK(condition)                                                                           \
+    do {                                                                                           \
+        if (!(condition)) {                                                                        \
+            cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << endl;       \
+            g_failures++;                                                                          \
+        }                                                                                          \
+    } while (0)
+
+    struct TestTag;
+
+    void TestHandlePool()
+    {
+        HandlePool<int, TestTag> pool;
+        const auto a = pool.Create(1);
+        const auto b = pool.Create(2);
+        const auto c = pool.Create(3);
+        CHECK(!a.IsNull() && a.Generation() == 1);
+        CHECK(*pool.Get(a) == 1 && *pool.Get(b) == 2 && *pool.Get(c) == 3);
+        CHECK(pool.Get(Handle<TestTag>()) == nullptr);
+
+        // 지우면 마지막 원소가 빈자리로 옮겨지지만 핸들은 그대로 유효
+        CHECK(pool.Destroy(a));
+        CHECK(!pool.IsValid(a) && pool.Get(a) == nullptr);
+        CHECK(!pool.Destroy(a));
+        CHECK(pool.GetCount() == 2 && *pool.Get(c) == 3);
+
+        // 슬롯을 다시 쓰면 세대가 올라가서 이전 핸들은 계속 무효
+        const auto d = pool.Create(4);
+        CHECK(d.Index() == a.Index() && d.Generation() == a.Generation() + 1);
+        CHECK(pool.Get(a) == nullptr && *pool.Get(d) == 4);
+
+        // Release()는 kFramesInFlight 프레임 뒤에 지움
+        pool.Release(b, 10);
+        pool.BeginFrame(10 + HandlePool<int, TestTag>::kFramesInFlight - 1);
+        CHECK(pool.IsValid(b));
+        pool.BeginFrame(10 + HandlePool<int, TestTag>::kFramesInFlight);
+        CHECK(!pool.IsValid(b) && pool.GetPendingReleaseCount() == 0);
+    }
+
+    void TestRangeAllocator()
+    {
+        RangeAllocator allocator(100);
+        const uint32_t a = allocator.Allocate(10);
+        const uint32_t b = allocator.Allocate(20);
+        const uint32_t c = allocator.Allocate(30);
+        CHECK(a == 0 && b == 10 && c == 30);
+        CHECK(allocator.GetUsed() == 60 && allocator.GetFreeRangeCount() == 1);
+        CHECK(allocator.Allocate(41) == RangeAllocator::kInvalidOffset);
+        CHECK(allocator.Allocate(0) == RangeAllocator::kInvalidOffset);
+
+        // 가운데를 지우면 빈 구간이 둘
+        allocator.Free(b, 20);
+        CHECK(allocator.GetFreeRangeCount() == 2 && allocator.GetLargestFree() == 40);
+        // 뒤 구간과 합침
+        allocator.Free(a, 10);
+        CHECK(allocator.GetFreeRangeCount() == 2 && allocator.GetLargestFree() == 40);
+        CHECK(allocator.Allocate(30) == 0);
+        allocator.Free(0, 30);
+        // 앞/뒤 구간과 모두 합쳐서 처음 상태로
+        allocator.Free(c, 30);
+        CHECK(allocator.GetFreeRangeCount() == 1 && allocator.GetLargestFree() == 100);
+        CHECK(allocator.GetUsed() == 0);
+        CHECK(allocator.Allocate(100) == 0);
+    }
+
+    void TestLinearArena()
+    {
+        LinearArena arena(256);
+        void *first = arena.allocate(100, 16);
+        CHECK(reinterpret_cast<uintptr_t>(first) % 16 == 0);
+        CHECK(arena.GetUsedBytes() == 100 && arena.GetCapacity() == 256);
+
+        // 모자라면 블록을 추가
+        void *second = arena.allocate(300, 64);
+        CHECK(reinterpret_cast<uintptr_t>(second) % 64 == 0);
+        CHECK(arena.GetCapacity() > 256 && arena.GetUsedBytes() == 400);
+        const size_t capacity = arena.GetCapacity();
+
+        // Reset()은 블록을 하나로 합쳐서 다음 프레임에는 추가 할당이 없음
+        arena.Reset();
+        CHECK(arena.GetUsedBytes() == 0 && arena.GetPeakBytes() == 400);
+        CHECK(arena.GetCapacity() == capacity);
+        first = arena.allocate(100, 16);
+        second = arena.allocate(300, 64);
+        CHECK(first != nullptr && second != nullptr);
+        CHECK(arena.GetCapacity() == capacity);
+    }
+
+    void TestBoundedQueue()
+    {
+        BoundedQueue<int> queue(5);
+        CHECK(queue.GetCapacity() == 8);
+        for (int i = 0; i < 8; i++)
+            CHECK(queue.TryPush(int(i)));
+        CHECK(!queue.TryPush(8));
+
+        int value = -1;
+        for (int i = 0; i < 8; i++)
+            CHECK(queue.TryPop(value) && value == i);
+        CHECK(!queue.TryPop(value));
+
+        // 생산자/소비자 여럿이 동시에 써도 빠지거나 겹치는 값이 없음
+        constexpr int kProducers = 4, kConsumers = 2, kPerProducer = 20000;
+        BoundedQueue<int> shared(64);
+        atomic<int64_t> sum{0};
+        atomic<int> popped{0};
+        vector<thread> threads;
+        for (int p = 0; p < kProducers; p++) {
+            threads.emplace_back([&, p] {
+                for (int i = 1; i <= kPerProducer; i++) {
+                    while (!shared.TryPush(p * kPerProducer + i))
+                        this_thread::yield();
+                }
+            });
+        }
+        for (int c = 0; c < kConsumers; c++) {
+            threads.emplace_back([&] {
+                int item;
+                while (popped.load() < kProducers * kPerProducer) {
+                    if (shared.TryPop(item)) {
+                        sum += item;
+                        popped++;
+                    }
+                    else {
+                        this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (thread &t : threads)
+            t.join();
+
+        const int64_t count = int64_t(kProducers) * kPerProducer;
+        CHECK(popped.load() == count);
+        CHECK(sum.load() == count * (count + 1) / 2);
+    }
+
+    void TestRenderTargetPool()
+    {
+        int nextTarget = 1;
+        vector<int> destroyed;
+        RenderTargetPoolSettings settings;
+        settings.granularity = 64;
+        settings.maxIdleFrames = 2;
+        settings.maxPooledTargets = 2;
+
+        RenderTargetPool<int> pool;
+        pool.Initialize(
+            [&](const RenderTargetDesc &, int &target) {
+                target = nextTarget++;
+                return true;
+            },
+            [&](int &target) { destroyed.push_back(target); }, settings);
+
+        RenderTargetDesc desc;
+        desc.width = 100;
+        desc.height = 50;
+        const RenderTargetDesc bucket = pool.GetBucket(desc);
+        CHECK(bucket.width == 128 && bucket.height == 64);
+
+        // 같은 버킷이면 크기가 조금 달라도 같은 타겟을 돌려 씀
+        int first = 0;
+        CHECK(pool.Acquire(desc, first) && first == 1);
+        pool.Release(desc, first);
+        RenderTargetDesc resized = desc;
+        resized.width = 120;
+        resized.height = 60;
+        int second = 0;
+        CHECK(pool.Acquire(resized, second) && second == 1);
+        CHECK(pool.GetStats().created == 1 && pool.GetStats().reused == 1);
+
+        // 다른 버킷이나 다른 포맷이면 새로 만듦
+        RenderTargetDesc wide = desc;
+        wide.width = 200;
+        int third = 0;
+        CHECK(pool.Acquire(wide, third) && third == 2);
+        RenderTargetDesc other = resized;
+        other.format = 1;
+        int fourth = 0;
+        CHECK(pool.Acquire(other, fourth) && fourth == 3);
+        CHECK(pool.GetStats().live == 3);
+
+        // maxPooledTargets를 넘으면 가장 오래 쉰 것부터 지움
+        pool.Release(resized, second);
+        pool.Release(wide, third);
+        pool.Release(other, fourth);
+        CHECK(destroyed == vector<int>{1});
+        CHECK(pool.GetStats().pooled == 2);
+
+        // maxIdleFrames 동안 쓰이지 않으면 BeginFrame()에서 지움
+        pool.BeginFrame(2);
+        CHECK(pool.GetStats().pooled == 2);
+        pool.BeginFrame(3);
+        CHECK(pool.GetStats().pooled == 0 && destroyed.size() == 3);
+    }
+
+    void WriteFile(const filesystem::path &path, const string &text)
+    {
+        ofstream file(path, ios::binary | ios::trunc);
+        file << text;
+    }
+
+    string ToString(const vector<uint8_t> &bytes) { return string(bytes.begin(), bytes.end()); }
+
+    // condition이 참이 될 때까지 최대 timeout 동안 기다림
+    bool WaitFor(const function<bool()> &condition, chrono::milliseconds timeout = chrono::seconds(5))
+    {
+        const auto deadline = chrono::steady_clock::now() + timeout;
+        while (!condition()) {
+            if (chrono::steady_clock::now() > deadline)
+                return false;
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+        return true;
+    }
+
+    // 쉐이더 핫 리로드의 교체: 대체 컴파일러는 파일 내용을 그대로 바이트코드로 쓰고 "error"로 시작하면 실패
+    void TestShaderReload()
+    {
+        const filesystem::path directory =
+            filesystem::temp_directory_path() /
+            ("graphics_tests_reload_" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+        filesystem::create_directories(directory);
+        const filesystem::path vertexShaderFile = directory / "Test.vs.hlsl";
+        const filesystem::path pixelShaderFile = directory / "Test.ps.hlsl";
+        WriteFile(vertexShaderFile, "vs 1");
+        WriteFile(pixelShaderFile, "ps 1");
+
+        ShaderCompiler compiler = [](const filesystem::path &path, const string &, const ShaderDefines &,
+                                     vector<uint8_t> &bytecode, string &errors) {
+            ifstream file(path, ios::binary);
+            const string text((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+            if (text.rfind("error", 0) == 0) {
+                errors = text;
+                return false;
+            }
+            bytecode.assign(text.begin(), text.end());
+            return true;
+        };
+
+        {
+            HeadlessBackend backend;
+            ShaderHotReloader reloader(compiler);
+            HeadlessPipelineCache cache;
+            cache.Initialize(&backend, compiler, &reloader);
+            auto apply = [&](const CompiledShader &shader) { return cache.ApplyReloadedShader(shader); };
+
+            const HeadlessPipelineHandle handle = cache.GetOrCreate(vertexShaderFile, pixelShaderFile);
+            CHECK(!handle.IsNull());
+            CHECK(cache.GetOrCreate(vertexShaderFile, pixelShaderFile) == handle);
+            CHECK(ToString(backend.GetPipeline(handle)->vertexShader) == "vs 1");
+
+            // 컴파일이 끝나도 프레임 경계(ApplyPending()) 전에는 바뀌지 않음
+            WriteFile(vertexShaderFile, "vs 2");
+            CHECK(WaitFor([&] { return reloader.GetPendingCount() > 0; }));
+            CHECK(ToString(backend.GetPipeline(handle)->vertexShader) == "vs 1");
+            CHECK(backend.GetPipeline(handle)->version == 0);
+
+            // ApplyPending()에서 같은 핸들의 내용이 바뀜
+            CHECK(reloader.ApplyPending(apply) == 1);
+            CHECK(ToString(backend.GetPipeline(handle)->vertexShader) == "vs 2");
+            CHECK(ToString(backend.GetPipeline(handle)->pixelShader) == "ps 1");
+            CHECK(backend.GetPipeline(handle)->version == 1);
+            CHECK(reloader.GetReloadCount() == 1);
+
+            // 컴파일에 실패하면 넘기는 것이 없으므로 이전 쉐이더를 그대로 씀
+            WriteFile(vertexShaderFile, "error: syntax");
+            CHECK(WaitFor([&] { return reloader.GetFailureCount() > 0; }));
+            CHECK(reloader.ApplyPending(apply) == 0);
+            CHECK(ToString(backend.GetPipeline(handle)->vertexShader) == "vs 2");
+            CHECK(backend.GetPipeline(handle)->version == 1);
+            CHECK(backend.GetErrorCount() == 0);
+        }
+
+        error_code error;
+        filesystem::remove_all(directory, error);
+    }
+
+    struct Test {
+        const char *name;
+        void (*function)();
+    };
+
+    const Test kTests[] = {
+        {"handle_pool", TestHandlePool},
+        {"range_allocator", TestRangeAllocator},
+        {"linear_arena", TestLinearArena},
+        {"bounded_queue", TestBoundedQueue},
+        {"render_target_pool", TestRenderTargetPool},
+        {"shader_reload", TestShaderReload},
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    int failedTests = 0;
+    int ranTests = 0;
+    for (const Test &test : kTests) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++)
+            selected |= strcmp(argv[i], test.name) == 0;
+        if (!selected)
+            continue;
+
+        const int failures = g_failures;
+        test.function();
+        ranTests++;
+        if (g_failures != failures)
+            failedTests++;
+        cout << test.name << ": " << (g_failures == failures ? "ok" : "FAILED") << endl;
+    }
+
+    if (ranTests == 0) {
+        cerr << "No test matches the given names." << endl;
+        return 1;
+    }
+    return failedTests > 0 ? 1 : 0;
+}
@@ -1,10 +1,92 @@
+#ifndef GRAYSCALE
+#define GRAYSCALE 0
+#endif
+
+#ifndef CLUSTERED_LIGHTING
+#define CLUSTERED_LIGHTING 0
+#endif
+
 struct PixelShaderInput {
     float4 pos : SV_POSITION;
     float3 color : COLOR;
+    float3 worldPos : POSITION;
+    float3 normal : NORMAL;
+    float viewZ : TEXCOORD0;
+};
+
+#if CLUSTERED_LIGHTING
+// ClusteredLighting.h의 ClusterConstants, Light와 같은 배치
+cbuffer ClusterConstantBuffer : register(b1)
+{
+    uint tileCountX;
+    uint tileCountY;
+    uint sliceCount;
+    uint lightCount;
+    float2 tileScale;  // 픽셀 좌표 -> 타일
+    float sliceScale;  // 슬라이스 = log2(viewZ) * sliceScale + sliceBias
+    float sliceBias;
+    float3 ambient;
+};
+
+struct Light {
+    float3 position;
+    float radius;
+    float3 color;
+    float spotCosOuter;
+    float3 direction;
+    float spotCosInner;
+};
+
+// ShaderConstants.h의 PassConstants. 여러 뷰로 나눠 그리면 SV_POSITION에서 뷰포트 시작을 빼야 타일이 맞음
+cbuffer PassConstants : register(b3)
+{
+    float2 viewportOrigin;
+    float2 viewportSize;
+    uint passIndex;
 };
 
+StructuredBuffer<Light> lights : register(t0);
+StructuredBuffer<uint2> clusters : register(t1); // (offset, count) [slice][y][x]
+StructuredBuffer<uint> lightIndices : register(t2);
+
+// ShadeClustered()와 같은 계산
+float3 ShadeClustered(float2 pixel, float viewZ, float3 albedo, float3 worldPos, float3 normal)
+{
+    uint2 tile = min(uint2(pixel * tileScale), uint2(tileCountX, tileCountY) - 1);
+    uint slice = uint(clamp(int(log2(max(viewZ, 1e-6)) * sliceScale + sliceBias), 0, int(sliceCount) - 1));
+    uint2 range = clusters[(slice * tileCountY + tile.y) * tileCountX + tile.x];
+
+    float3 lighting = ambient;
+    for (uint k = 0; k < range.y; k++) {
+        Light light = lights[lightIndices[range.x + k]];
+        float3 toLight = light.position - worldPos;
+        float distanceSq = dot(toLight, toLight);
+        float radiusSq = light.radius * light.radius;
+        if (distanceSq >= radiusSq)
+            continue;
+        toLight *= rsqrt(distanceSq);
+
+        float window = 1.0 - distanceSq / radiusSq;
+        float spot = smoothstep(light.spotCosOuter, light.spotCosInner, dot(-toLight, light.direction));
+        lighting += light.color * (saturate(dot(normal, toLight)) * window * window * spot);
+    }
+    return albedo * lighting;
+}
+#endif
+
 float4 main(PixelShaderInput input) : SV_TARGET {
 
+    float3 color = input.color;
+#if CLUSTERED_LIGHTING
+    color = ShadeClustered(input.pos.xy - viewportOrigin, input.viewZ, color, input.worldPos, normalize(input.normal));
+#endif
+
+#if GRAYSCALE
+    // Rec. 709 luminance
+    float luminance = dot(color, float3(0.2126, 0.7152, 0.0722));
+    return float4(luminance.xxx, 1.0);
+#else
     // Use the interpolated vertex color
-    return float4(input.color, 1.0);
+    return float4(color, 1.0);
+#endif
 }
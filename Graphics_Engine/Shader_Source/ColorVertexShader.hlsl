@@ -1,18 +1,32 @@
-cbuffer ModelViewProjectionConstantBuffer : register(b0)
+// ShaderConstants.h의 FrameConstants, ObjectConstants와 같은 배치
+// b0은 프레임에 한 번, b2는 물체마다 한 버퍼 안의 범위를 바꿔 가며 바인딩 (b1은 ClusterConstantBuffer)
+cbuffer FrameConstants : register(b0)
 {
-    matrix model;
     matrix view;
     matrix projection;
+    matrix viewProjection;
+    float time;
+    float deltaTime;
+};
+
+cbuffer ObjectConstants : register(b2)
+{
+    matrix model;
+    matrix normalMatrix; // model의 역전치
 };
 
 struct VertexShaderInput {
     float3 pos : POSITION;
     float3 color : COLOR0;
+    float3 normal : NORMAL;
 };
 
 struct PixelShaderInput {
     float4 pos : SV_POSITION;
     float3 color : COLOR;
+    float3 worldPos : POSITION;
+    float3 normal : NORMAL;
+    float viewZ : TEXCOORD0;
 };
 
 PixelShaderInput main(VertexShaderInput input) {
@@ -21,11 +35,13 @@ PixelShaderInput main(VertexShaderInput input) {
     float4 pos = float4(input.pos, 1.0f);
     
     pos = mul(pos, model);
-    pos = mul(pos, view);
-    pos = mul(pos, projection);
+    output.worldPos = pos.xyz;
+    output.viewZ = mul(pos, view).z;
+    pos = mul(pos, viewProjection);
 
     output.pos = pos;
     output.color = input.color;
+    output.normal = mul(input.normal, (float3x3)normalMatrix);
 
     return output;
 }
@@ -0,0 +1,13 @@
+struct PixelShaderInput {
+    float4 pos : SV_POSITION;
+    float4 color : COLOR;
+    float2 corner : TEXCOORD;
+};
+
+float4 main(PixelShaderInput input) : SV_TARGET {
+
+    // 가장자리로 갈수록 부드럽게 사라지는 원
+    float falloff = saturate(1.0 - dot(input.corner, input.corner));
+    clip(falloff - 1.0 / 255.0);
+    return float4(input.color.rgb, input.color.a * falloff);
+}
@@ -0,0 +1,37 @@
+// 파티클 빌보드: 슬롯 0의 사각형(MakeSquare, -0.5 ~ 0.5)을 인스턴스 위치에서 뷰 공간으로 펼침
+// ShaderConstants.h의 FrameConstants (파티클 위치는 월드 공간이므로 물체 상수는 없음)
+cbuffer FrameConstants : register(b0)
+{
+    matrix view;
+    matrix projection;
+    matrix viewProjection;
+    float time;
+    float deltaTime;
+};
+
+struct VertexShaderInput {
+    float3 pos : POSITION;
+    float3 color : COLOR0;
+    float3 instancePos : INSTANCEPOS;
+    float instanceSize : INSTANCESIZE;
+    float4 instanceColor : INSTANCECOLOR; // R8G8B8A8_UNORM
+};
+
+struct PixelShaderInput {
+    float4 pos : SV_POSITION;
+    float4 color : COLOR;
+    float2 corner : TEXCOORD; // 사각형 안의 위치 (-1 ~ 1)
+};
+
+PixelShaderInput main(VertexShaderInput input) {
+
+    PixelShaderInput output;
+    float4 viewPos = mul(float4(input.instancePos, 1.0f), view);
+    viewPos.xy += input.pos.xy * input.instanceSize;
+
+    output.pos = mul(viewPos, projection);
+    output.color = input.instanceColor;
+    output.corner = input.pos.xy * 2.0f;
+
+    return output;
+}
@@ -0,0 +1,25 @@
+// GLYPH_ATLAS: GlyphAtlas처럼 R8 텍스처의 값을 알파로만 씀 (글자 색은 인스턴스 색)
+#ifndef GLYPH_ATLAS
+#define GLYPH_ATLAS 0
+#endif
+
+Texture2D spriteTexture : register(t0);
+SamplerState spriteSampler : register(s0);
+
+struct PixelShaderInput {
+    float4 pos : SV_POSITION;
+    float4 color : COLOR;
+    float2 uv : TEXCOORD;
+};
+
+float4 main(PixelShaderInput input) : SV_TARGET {
+
+    float4 texel = spriteTexture.Sample(spriteSampler, input.uv);
+#if GLYPH_ATLAS
+    float4 color = float4(input.color.rgb, input.color.a * texel.r);
+#else
+    float4 color = input.color * texel;
+#endif
+    clip(color.a - 1.0 / 255.0);
+    return color;
+}
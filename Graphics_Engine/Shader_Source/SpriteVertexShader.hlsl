@@ -0,0 +1,42 @@
+// 스프라이트: 슬롯 0의 사각형(MakeSquare, -0.5 ~ 0.5, 위가 +y)을 SpriteInstance(SpriteBatcher.h)마다 펼침
+// 인스턴스 좌표는 뷰포트 픽셀(왼쪽 위가 원점, 아래가 +y)이므로 카메라 행렬 없이 뷰포트 크기만 씀
+// ShaderConstants.h의 PassConstants
+cbuffer PassConstants : register(b3)
+{
+    float2 viewportOrigin;
+    float2 viewportSize;
+    uint passIndex;
+};
+
+struct VertexShaderInput {
+    float3 pos : POSITION;
+    float3 color : COLOR0;
+    float2 spritePos : SPRITEPOS;
+    float2 spriteSize : SPRITESIZE;
+    float4 uvRect : SPRITEUV;
+    float rotation : SPRITEROTATION;
+    float4 spriteColor : SPRITECOLOR; // R8G8B8A8_UNORM
+};
+
+struct PixelShaderInput {
+    float4 pos : SV_POSITION;
+    float4 color : COLOR;
+    float2 uv : TEXCOORD;
+};
+
+PixelShaderInput main(VertexShaderInput input) {
+
+    PixelShaderInput output;
+
+    // 픽셀 좌표계(아래가 +y)로 뒤집고 크기 -> 회전 -> 이동
+    float2 corner = float2(input.pos.x, -input.pos.y) * input.spriteSize;
+    float s, c;
+    sincos(input.rotation, s, c);
+    float2 pixel = input.spritePos + float2(corner.x * c - corner.y * s, corner.x * s + corner.y * c);
+
+    output.pos = float4(pixel.x / viewportSize.x * 2.0f - 1.0f, 1.0f - pixel.y / viewportSize.y * 2.0f, 0.0f, 1.0f);
+    output.color = input.spriteColor;
+    output.uv = lerp(input.uvRect.xy, input.uvRect.zw, float2(input.pos.x + 0.5f, 0.5f - input.pos.y));
+
+    return output;
+}
@@ -0,0 +1,20 @@
+// 동적 해상도: 장면 텍스처의 왼쪽 위 (배율 x 크기) 영역을 백 버퍼 전체로 늘림
+Texture2D sceneTexture : register(t0);
+SamplerState linearClamp : register(s0);
+
+cbuffer UpscaleConstantBuffer : register(b0)
+{
+    float2 uvScale; // 그린 영역 크기 / 장면 텍스처 크기
+    float2 uvClamp; // 그린 영역 밖의 텍셀이 섞이지 않도록 마지막 텍셀 중심에서 멈춤
+};
+
+struct PixelShaderInput {
+    float4 pos : SV_POSITION;
+    float2 texcoord : TEXCOORD;
+};
+
+float4 main(PixelShaderInput input) : SV_TARGET {
+
+    float2 uv = min(input.texcoord * uvScale, uvClamp);
+    return float4(sceneTexture.SampleLevel(linearClamp, uv, 0).rgb, 1.0);
+}
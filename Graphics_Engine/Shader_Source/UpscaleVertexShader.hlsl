@@ -0,0 +1,16 @@
+// 동적 해상도: 버텍스 버퍼 없이 SV_VertexID로 화면을 덮는 삼각형 하나를 만듦
+struct PixelShaderInput {
+    float4 pos : SV_POSITION;
+    float2 texcoord : TEXCOORD;
+};
+
+PixelShaderInput main(uint vertexID : SV_VertexID) {
+
+    PixelShaderInput output;
+    float2 texcoord = float2((vertexID << 1) & 2, vertexID & 2);
+
+    output.pos = float4(texcoord * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+    output.texcoord = texcoord;
+
+    return output;
+}